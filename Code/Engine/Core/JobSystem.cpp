@@ -4,14 +4,16 @@
 #include <atomic>
 
 JobSystem* JobSystem::instance = nullptr;
-std::atomic<int> gThreadNumber = 0;
+static thread_local int s_workerIndex = -1;
 
 //-----------------------------------------------------------------------------------
-void GenericJobThread()
+void GenericJobThread(int workerIndex)
 {
+    s_workerIndex = workerIndex;
+
     //The order we construct these in is the order we prioritize them.
     std::vector<JobType> types;
-    if (++gThreadNumber % 2 == 0)
+    if (workerIndex % 2 == 1)
     {
         types.push_back(GENERIC_SLOW);
         types.push_back(GENERIC);
@@ -74,7 +76,7 @@ void JobSystem::Initialize()
     m_isRunning = true;
     for (unsigned int i = 0; i < m_numberOfThreads; ++i)
     {
-        std::thread* thread = new std::thread(GenericJobThread);
+        std::thread* thread = new std::thread(GenericJobThread, (int)i);
         m_threadPool.push_back(thread);
     }
 }
@@ -104,6 +106,13 @@ void JobSystem::Shutdown()
     jobCleanup.ConsumeAll();
 }
 
+//-----------------------------------------------------------------------------------
+//Which pool thread we're on, numbered in the order Initialize started them, so it's the same every run.
+int JobSystem::GetCurrentWorkerIndex()
+{
+    return s_workerIndex;
+}
+
 //-----------------------------------------------------------------------------------
 Job* JobSystem::CreateJob(JobWorkFunction* jobWorkFunction, void* data, JobCallbackFunction* finishedCallback)
 {
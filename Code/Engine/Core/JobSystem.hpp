@@ -51,6 +51,7 @@ public:
     void DispatchJob(JobType jobType, Job* jobToDispatch);
     void CreateAndDispatchJob(JobType jobType, JobWorkFunction* jobWorkFunction, void* data, JobCallbackFunction* finishedCallback = nullptr);
     void ReleaseJob(Job* finishedJob);
+    static int GetCurrentWorkerIndex(); //-1 on any thread outside the pool
 
     //STATIC VARIABLES/////////////////////////////////////////////////////////////////////
     static JobSystem* instance;
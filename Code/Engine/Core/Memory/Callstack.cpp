@@ -6,15 +6,30 @@
 /*                                                                      */
 /************************************************************************/
 #include "Engine/Core/Memory/Callstack.hpp"
+#include "Engine/Core/Memory/MemoryTracking.hpp"
+#include "Engine/Core/Memory/UntrackedAllocator.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
-
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Time/Time.hpp"
+#include <unordered_map>
+#include <deque>
+#include <thread>
+
+#if defined(_WIN32)
 #define WIN32_LEAN_AND_MEAN
 #define _WINSOCKAPI_
 #include <Windows.h>
 //DbgHelp.h has an annoying warning that's not my problem.
 #pragma warning(disable: 4091)
 #include <DbgHelp.h>
-
+#else
+#include <execinfo.h>
+#include <dlfcn.h>
+#include <cxxabi.h>
+#include <pthread.h>
+#endif
 
 /************************************************************************/
 /*                                                                      */
@@ -43,6 +58,7 @@
 /*                                                                      */
 /************************************************************************/
 
+#if defined(_WIN32)
 // SymInitialize()
 typedef BOOL (__stdcall *sym_initialize_t)( IN HANDLE hProcess, IN PSTR UserSearchPath, IN BOOL fInvadeProcess );
 typedef BOOL (__stdcall *sym_cleanup_t)( IN HANDLE hProcess );
@@ -50,6 +66,22 @@ typedef BOOL (__stdcall *sym_from_addr_t)( IN HANDLE hProcess, IN DWORD64 Addres
 
 typedef BOOL (__stdcall *sym_get_line_t)( IN HANDLE hProcess, IN DWORD64 dwAddr, OUT PDWORD pdwDisplacement, OUT PIMAGEHLP_LINE64 Symbol );
 
+//Slim locks, because they need to work before anything has been initialized: operator new captures stacks from the very first allocation
+typedef SRWLOCK CallstackMutex;
+typedef CONDITION_VARIABLE CallstackCondition;
+#define CALLSTACK_MUTEX_INIT SRWLOCK_INIT
+#define CALLSTACK_CONDITION_INIT CONDITION_VARIABLE_INIT
+#else
+typedef pthread_mutex_t CallstackMutex;
+typedef pthread_cond_t CallstackCondition;
+#define CALLSTACK_MUTEX_INIT PTHREAD_MUTEX_INITIALIZER
+#define CALLSTACK_CONDITION_INIT PTHREAD_COND_INITIALIZER
+#endif
+
+typedef std::unordered_multimap<uint32_t, Callstack*, std::hash<uint32_t>, std::equal_to<uint32_t>, UntrackedAllocator<std::pair<const uint32_t, Callstack*>>> CallstackInternTable;
+typedef std::unordered_map<uintptr_t, CallstackLine, std::hash<uintptr_t>, std::equal_to<uintptr_t>, UntrackedAllocator<std::pair<const uintptr_t, CallstackLine>>> CallstackSymbolCache;
+typedef std::unordered_multimap<uint32_t, const char*, std::hash<uint32_t>, std::equal_to<uint32_t>, UntrackedAllocator<std::pair<const uint32_t, const char*>>> CallstackStringPool;
+
 /************************************************************************/
 /*                                                                      */
 /* STRUCTS                                                              */
@@ -67,18 +99,34 @@ typedef BOOL (__stdcall *sym_get_line_t)( IN HANDLE hProcess, IN DWORD64 dwAddr,
 /* LOCAL VARIABLES                                                      */
 /*                                                                      */
 /************************************************************************/
+#if defined(_WIN32)
 static HMODULE gDebugHelp;
 static HANDLE gProcess;
 static SYMBOL_INFO* gSymbol;
 
-// only called from single thread - so can use a shared buffer
-static char gFileName[MAX_FILENAME_LENGTH];
-static CallstackLine gCallstackBuffer[MAX_DEPTH];
-
 static sym_initialize_t LSymInitialize;
 static sym_cleanup_t LSymCleanup;
 static sym_from_addr_t LSymFromAddr;
 static sym_get_line_t LSymGetLineFromAddr64;
+#endif
+
+//Interned stacks. Made on first use, since allocations start capturing before static constructors have run.
+static CallstackMutex gInternLock = CALLSTACK_MUTEX_INIT;
+static CallstackInternTable* gInternedStacks = nullptr;
+static uint gCallstackCount = 0;
+
+//Address -> symbol. Also guards the symbol backend, dbghelp isn't thread safe.
+static CallstackMutex gSymbolLock = CALLSTACK_MUTEX_INIT;
+static CallstackSymbolCache* gSymbolCache = nullptr;
+static CallstackStringPool* gSymbolStrings = nullptr;
+static thread_local CallstackLine tCallstackBuffer[MAX_DEPTH];
+
+//Background symbolization
+static CallstackMutex gSymbolRequestLock = CALLSTACK_MUTEX_INIT;
+static CallstackCondition gSymbolRequestAdded = CALLSTACK_CONDITION_INIT;
+static std::deque<Callstack*, UntrackedAllocator<Callstack*>> gSymbolRequests;
+static std::thread gSymbolWorker;
+static bool gIsSymbolWorkerRunning = false;
 
 /************************************************************************/
 /*                                                                      */
@@ -86,6 +134,146 @@ static sym_get_line_t LSymGetLineFromAddr64;
 /*                                                                      */
 /************************************************************************/
 
+#if defined(_WIN32)
+//------------------------------------------------------------------------
+static inline void LockCallstackMutex(CallstackMutex* mutex) { AcquireSRWLockExclusive(mutex); }
+static inline void UnlockCallstackMutex(CallstackMutex* mutex) { ReleaseSRWLockExclusive(mutex); }
+static inline void WaitCallstackCondition(CallstackCondition* condition, CallstackMutex* mutex) { SleepConditionVariableSRW(condition, mutex, INFINITE, 0); }
+static inline void WakeCallstackCondition(CallstackCondition* condition) { WakeConditionVariable(condition); }
+#else
+//------------------------------------------------------------------------
+static inline void LockCallstackMutex(CallstackMutex* mutex) { pthread_mutex_lock(mutex); }
+static inline void UnlockCallstackMutex(CallstackMutex* mutex) { pthread_mutex_unlock(mutex); }
+static inline void WaitCallstackCondition(CallstackCondition* condition, CallstackMutex* mutex) { pthread_cond_wait(condition, mutex); }
+static inline void WakeCallstackCondition(CallstackCondition* condition) { pthread_cond_signal(condition); }
+#endif
+
+//------------------------------------------------------------------------
+static uint32_t HashBytes(const void* data, size_t numBytes)
+{
+    //FNV-1a
+    const byte* bytes = (const byte*)data;
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < numBytes; ++i)
+    {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+//------------------------------------------------------------------------
+// Call with gSymbolLock held. Filenames especially repeat endlessly, so every string is stored once.
+static const char* InternSymbolString(const char* text)
+{
+    size_t length = strlen(text);
+    uint32_t hash = HashBytes(text, length);
+    auto range = gSymbolStrings->equal_range(hash);
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+        if (strcmp(iter->second, text) == 0)
+        {
+            return iter->second;
+        }
+    }
+    char* copy = (char*)malloc(length + 1);
+    memcpy(copy, text, length + 1);
+    gSymbolStrings->emplace(hash, copy);
+    return copy;
+}
+
+//------------------------------------------------------------------------
+// Call with gSymbolLock held.
+static void ResolveSymbol(void* address, CallstackLine& outLine)
+{
+    outLine.functionName = nullptr;
+    outLine.filename = nullptr;
+    outLine.line = 0;
+    outLine.offset = 0;
+
+#if defined(_WIN32)
+    if (gDebugHelp)
+    {
+        DWORD64 ptr = (DWORD64)address;
+        if (LSymFromAddr(gProcess, ptr, 0, gSymbol))
+        {
+            outLine.functionName = InternSymbolString(gSymbol->Name);
+        }
+
+        IMAGEHLP_LINE64 LineInfo; 
+        DWORD LineDisplacement = 0; // Displacement from the beginning of the line 
+        LineInfo.SizeOfStruct = sizeof(IMAGEHLP_LINE64);
+        BOOL bRet = LSymGetLineFromAddr64( 
+            gProcess, // Process handle of the current process 
+            ptr, // Address 
+            &LineDisplacement, // Displacement will be stored here by the function 
+            &LineInfo );         // File name / line information will be stored here 
+
+        if (bRet) 
+        {
+            outLine.line = LineInfo.LineNumber;
+            outLine.filename = InternSymbolString(LineInfo.FileName);
+            outLine.offset = LineDisplacement;
+        }
+    }
+#else
+    //No line tables here, just the nearest exported symbol and the module it's in
+    Dl_info info;
+    if (dladdr(address, &info))
+    {
+        if (info.dli_sname)
+        {
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            outLine.functionName = InternSymbolString(status == 0 ? demangled : info.dli_sname);
+            outLine.offset = (uint32_t)((byte*)address - (byte*)info.dli_saddr);
+            free(demangled);
+        }
+        if (info.dli_fname)
+        {
+            outLine.filename = InternSymbolString(info.dli_fname);
+        }
+    }
+#endif
+
+    if (!outLine.functionName)
+    {
+        outLine.functionName = InternSymbolString("N/A");
+    }
+    if (!outLine.filename)
+    {
+        outLine.filename = InternSymbolString("N/A");
+    }
+}
+
+//------------------------------------------------------------------------
+static void SymbolWorkerMain()
+{
+    LockCallstackMutex(&gSymbolRequestLock);
+    while (true)
+    {
+        while (gIsSymbolWorkerRunning && gSymbolRequests.empty())
+        {
+            WaitCallstackCondition(&gSymbolRequestAdded, &gSymbolRequestLock);
+        }
+        if (!gIsSymbolWorkerRunning)
+        {
+            break;
+        }
+        Callstack* callstack = gSymbolRequests.front();
+        gSymbolRequests.pop_front();
+        UnlockCallstackMutex(&gSymbolRequestLock);
+        {
+            for (uint i = 0; i < callstack->frameCount; ++i)
+            {
+                CallstackGetLine(callstack->frames[i]);
+            }
+            FreeCallstack(callstack);
+        }
+        LockCallstackMutex(&gSymbolRequestLock);
+    }
+    UnlockCallstackMutex(&gSymbolRequestLock);
+}
+
 /************************************************************************/
 /*                                                                      */
 /* EXTERNAL FUNCTIONS                                                   */
@@ -95,6 +283,7 @@ static sym_get_line_t LSymGetLineFromAddr64;
 //------------------------------------------------------------------------
 bool CallstackSystemInit()
 {
+#if defined(_WIN32)
     gDebugHelp = LoadLibraryA("dbghelp.dll");
     ASSERT_OR_DIE(gDebugHelp != nullptr, "Unable to load dbghelp.dll");
     LSymInitialize = (sym_initialize_t)GetProcAddress(gDebugHelp, "SymInitialize");
@@ -108,25 +297,57 @@ bool CallstackSystemInit()
     gSymbol = (SYMBOL_INFO*)malloc(sizeof(SYMBOL_INFO) + (MAX_FILENAME_LENGTH * sizeof(char)));
     gSymbol->MaxNameLen = MAX_FILENAME_LENGTH;
     gSymbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+#endif
 
+    gIsSymbolWorkerRunning = true;
+    gSymbolWorker = std::thread(SymbolWorkerMain);
    return true;
 }
 
 //------------------------------------------------------------------------
-static int gCallstackCount = 0;
 void CallstackSystemDeinit()
 {
-    LSymCleanup(gProcess);
-
-    FreeLibrary(gDebugHelp);
-    gDebugHelp = NULL;
-
-    if (gCallstackCount != 0)
+    LockCallstackMutex(&gSymbolRequestLock);
+    {
+        gIsSymbolWorkerRunning = false;
+        WakeCallstackCondition(&gSymbolRequestAdded);
+    }
+    UnlockCallstackMutex(&gSymbolRequestLock);
+    if (gSymbolWorker.joinable())
+    {
+        gSymbolWorker.join();
+    }
+    for (Callstack* callstack : gSymbolRequests)
     {
-        gCallstackCount = 0;
+        FreeCallstack(callstack);
     }
+    gSymbolRequests.clear();
 
-    free(gSymbol);
+    LockCallstackMutex(&gSymbolLock);
+    {
+#if defined(_WIN32)
+        LSymCleanup(gProcess);
+
+        FreeLibrary(gDebugHelp);
+        gDebugHelp = NULL;
+
+        free(gSymbol);
+        gSymbol = nullptr;
+#endif
+        if (gSymbolStrings)
+        {
+            for (auto& pooledString : *gSymbolStrings)
+            {
+                free((void*)pooledString.second);
+            }
+            UntrackedDelete<CallstackStringPool>(gSymbolStrings);
+            UntrackedDelete<CallstackSymbolCache>(gSymbolCache);
+            gSymbolStrings = nullptr;
+            gSymbolCache = nullptr;
+        }
+    }
+    UnlockCallstackMutex(&gSymbolLock);
+    //Interned stacks stay put, whatever still holds one (leaked allocations) keeps a valid pointer
 }
 
 //------------------------------------------------------------------------
@@ -134,9 +355,33 @@ Callstack* AllocateCallstack(uint skipFrames)
 {
     void* stack[MAX_DEPTH];
     //Getting from the calling function (0 is this function) to the number you want to capture
+#if defined(_WIN32)
     uint32_t frames = CaptureStackBackTrace(1 + skipFrames, MAX_DEPTH, stack, NULL);
-        
-    ++gCallstackCount;
+#else
+    void* rawStack[MAX_DEPTH];
+    uint32_t rawFrames = (uint32_t)backtrace(rawStack, MAX_DEPTH);
+    uint32_t skipped = Min<uint32_t>(1 + skipFrames, rawFrames);
+    uint32_t frames = rawFrames - skipped;
+    memcpy(stack, rawStack + skipped, sizeof(void*) * frames);
+#endif
+    uint32_t hash = HashBytes(stack, sizeof(void*) * frames);
+
+    LockCallstackMutex(&gInternLock);
+    if (!gInternedStacks)
+    {
+        gInternedStacks = UntrackedNew<CallstackInternTable>();
+    }
+    auto range = gInternedStacks->equal_range(hash);
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+        Callstack* internedStack = iter->second;
+        if (internedStack->frameCount == frames && memcmp(internedStack->frames, stack, sizeof(void*) * frames) == 0)
+        {
+            ++internedStack->refCount;
+            UnlockCallstackMutex(&gInternLock);
+            return internedStack;
+        }
+    }
 
     size_t size = sizeof(Callstack) + sizeof(void*) * frames;
     void* bufferDataBegin = malloc(size);
@@ -145,56 +390,162 @@ Callstack* AllocateCallstack(uint skipFrames)
 
     callstack->frames = (void**)frameDataFront;
     callstack->frameCount = frames;
+    callstack->hash = hash;
+    callstack->refCount = 1;
     memcpy(callstack->frames, stack, sizeof(void*) * frames);
 
+    gInternedStacks->emplace(hash, callstack);
+    ++gCallstackCount;
+    UnlockCallstackMutex(&gInternLock);
     return callstack;
 }
 
 //-----------------------------------------------------------------------------------
 void FreeCallstack(Callstack* stackToFree)
 {
+    if (!stackToFree)
+    {
+        return;
+    }
+    LockCallstackMutex(&gInternLock);
+    if (--stackToFree->refCount > 0)
+    {
+        UnlockCallstackMutex(&gInternLock);
+        return;
+    }
+    auto range = gInternedStacks->equal_range(stackToFree->hash);
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+        if (iter->second == stackToFree)
+        {
+            gInternedStacks->erase(iter);
+            break;
+        }
+    }
+    --gCallstackCount;
+    UnlockCallstackMutex(&gInternLock);
+
     //This frees everything allocated by malloc in one, big chunk
     //Since malloc inherently knows how big that is since we created it with malloc
     free(stackToFree);
 }
 
 //------------------------------------------------------------------------
-// Should only be called from the debug trace thread.  
-CallstackLine* CallstackGetLines(Callstack* cs) 
+const CallstackLine* CallstackGetLine(void* address)
 {
-    IMAGEHLP_LINE64 LineInfo; 
-    DWORD LineDisplacement = 0; // Displacement from the beginning of the line 
-    LineInfo.SizeOfStruct = sizeof(IMAGEHLP_LINE64);
+    LockCallstackMutex(&gSymbolLock);
+    if (!gSymbolCache)
+    {
+        gSymbolCache = UntrackedNew<CallstackSymbolCache>();
+        gSymbolStrings = UntrackedNew<CallstackStringPool>();
+    }
+    auto found = gSymbolCache->find((uintptr_t)address);
+    if (found == gSymbolCache->end())
+    {
+        CallstackLine line;
+        ResolveSymbol(address, line);
+        found = gSymbolCache->emplace((uintptr_t)address, line).first;
+    }
+    //Entries are never erased before deinit, so this stays good after unlocking
+    const CallstackLine* line = &found->second;
+    UnlockCallstackMutex(&gSymbolLock);
+    return line;
+}
 
-    uint count = cs->frameCount;
+//------------------------------------------------------------------------
+CallstackLine* CallstackGetLines(Callstack* cs) 
+{
+    uint count = Min<uint>(cs->frameCount, MAX_DEPTH);
     for (uint i = 0; i < count; ++i) 
     {
-        CallstackLine* line = &(gCallstackBuffer[i]);
-        DWORD64 ptr = (DWORD64)(cs->frames[i]);
-        LSymFromAddr(gProcess, ptr, 0, gSymbol);
+        tCallstackBuffer[i] = *CallstackGetLine(cs->frames[i]);
+    }
+    return tCallstackBuffer;
+}
+
+//------------------------------------------------------------------------
+void CallstackPrefetchSymbols(Callstack* cs)
+{
+    if (!cs)
+    {
+        return;
+    }
+    LockCallstackMutex(&gSymbolRequestLock);
+    if (gIsSymbolWorkerRunning)
+    {
+        LockCallstackMutex(&gInternLock);
+        {
+            ++cs->refCount;
+        }
+        UnlockCallstackMutex(&gInternLock);
+        gSymbolRequests.push_back(cs);
+        WakeCallstackCondition(&gSymbolRequestAdded);
+    }
+    UnlockCallstackMutex(&gSymbolRequestLock);
+}
 
-        strcpy_s(line->functionName, CALLSTACK_BUFFER_SIZE, gSymbol->Name);
+//------------------------------------------------------------------------
+uint CallstackGetNumUniqueStacks()
+{
+    return gCallstackCount;
+}
 
-        BOOL bRet = LSymGetLineFromAddr64( 
-            GetCurrentProcess(), // Process handle of the current process 
-            ptr, // Address 
-            &LineDisplacement, // Displacement will be stored here by the function 
-            &LineInfo );         // File name / line information will be stored here 
+//------------------------------------------------------------------------
+uint CallstackGetNumCachedSymbols()
+{
+    LockCallstackMutex(&gSymbolLock);
+    uint numSymbols = gSymbolCache ? (uint)gSymbolCache->size() : 0;
+    UnlockCallstackMutex(&gSymbolLock);
+    return numSymbols;
+}
 
-        if (bRet) 
+//------------------------------------------------------------------------
+CONSOLE_COMMAND(callstackbench)
+{
+    if (!(args.HasArgs(0) || args.HasArgs(1)))
+    {
+        Console::instance->PrintLine("callstackbench [numFrames]", RGBA::RED);
+        return;
+    }
+    int numFrames = args.HasArgs(1) ? Max<int>(args.GetIntArgument(0), 1) : 100000;
+    const int NUM_CAPTURES = 10000;
+
+    //Same call site every time, so everything after the first capture is a walk, a hash and a table hit
+    Callstack* firstCapture = nullptr;
+    double startSeconds = GetCurrentTimeSeconds();
+    for (int i = 0; i < NUM_CAPTURES; ++i)
+    {
+        Callstack* callstack = AllocateCallstack(0);
+        if (firstCapture)
         {
-            line->line = LineInfo.LineNumber;
-            const char* filename = LineInfo.FileName;
-            strcpy_s(line->filename, CALLSTACK_BUFFER_SIZE, filename);
-            line->offset = LineDisplacement;
-        } 
-        else 
+            FreeCallstack(callstack);
+        }
+        else
         {
-            line->line = 0;
-            line->offset = 0;
-            strcpy_s(line->filename, CALLSTACK_BUFFER_SIZE, "N/A");
+            firstCapture = callstack;
         }
     }
+    double captureSeconds = GetCurrentTimeSeconds() - startSeconds;
+    FreeCallstack(firstCapture);
+    Console::instance->PrintLine(Stringf("Capture: %.1fns per stack, %u unique stacks interned", (captureSeconds * 1e9) / NUM_CAPTURES, CallstackGetNumUniqueStacks()), RGBA::CORNFLOWER_BLUE);
+
+    //Every byte of code from here on is its own address to the cache. Most share a function, but the backend still has to look each one up.
+    byte* baseAddress = (byte*)(void*)&CallstackSystemInit;
+    uint numCachedBefore = CallstackGetNumCachedSymbols();
+    startSeconds = GetCurrentTimeSeconds();
+    for (int i = 0; i < numFrames; ++i)
+    {
+        CallstackGetLine(baseAddress + i);
+    }
+    double coldSeconds = GetCurrentTimeSeconds() - startSeconds;
+    uint numNewSymbols = CallstackGetNumCachedSymbols() - numCachedBefore;
 
-    return gCallstackBuffer;
-}
+    startSeconds = GetCurrentTimeSeconds();
+    for (int i = 0; i < numFrames; ++i)
+    {
+        CallstackGetLine(baseAddress + i);
+    }
+    double warmSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+    Console::instance->PrintLine(Stringf("Symbolize %i frames (%u new): %.0f frames/s first pass, %.0f frames/s cached", numFrames, numNewSymbols, numFrames / Max<double>(coldSeconds, 1e-9), numFrames / Max<double>(warmSeconds, 1e-9)), RGBA::CORNFLOWER_BLUE);
+}
\ No newline at end of file
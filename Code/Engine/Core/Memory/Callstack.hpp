@@ -47,17 +47,22 @@ typedef unsigned char byte;
 /*                                                                      */
 /************************************************************************/
 
+//Callstacks are interned: every capture of the same frames hands back the same Callstack,
+//reference counted, so an allocation site hit a million times costs one copy of its frames.
 struct Callstack
 {
-    Callstack() : frames(nullptr), frameCount(0) {};
+    Callstack() : frames(nullptr), frameCount(0), hash(0), refCount(0) {};
     void** frames;
     uint frameCount;
+    uint32_t hash;
+    uint refCount; //Only touched under the intern table's lock
 };
 
+//Strings point into the symbol cache and stay valid until CallstackSystemDeinit()
 struct CallstackLine 
 {
-    char filename[CALLSTACK_BUFFER_SIZE];
-    char functionName[CALLSTACK_BUFFER_SIZE];
+    const char* filename;
+    const char* functionName;
     uint32_t line;
     uint32_t offset;
 };
@@ -79,8 +84,15 @@ void CallstackSystemDeinit();
 Callstack* AllocateCallstack(uint skipFrames = 1);
 void FreeCallstack(Callstack* stackToFree);
 
-// Single Threaded - only from debug output thread (if I need the string names elsewhere
-// then I need to make a "debug" job consumer)
+// Thread safe. Each address is only ever symbolized once, after that it's a cache lookup.
+// The returned buffer belongs to the calling thread and is reused by its next call.
 CallstackLine* CallstackGetLines(Callstack* cs);
+const CallstackLine* CallstackGetLine(void* address);
+
+// Hands the stack to the symbolization worker so its frames are already cached by the time
+// someone asks for the lines. Holds its own reference, the caller can free theirs right away.
+void CallstackPrefetchSymbols(Callstack* cs);
+uint CallstackGetNumUniqueStacks();
+uint CallstackGetNumCachedSymbols();
 
 #endif 
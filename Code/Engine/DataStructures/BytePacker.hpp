@@ -16,7 +16,7 @@ public:
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
     virtual void* ReadBytes(const size_t numBytes);
     const char* ReadString();
-    void ReadBytes(void* dest, const size_t numBytes);
+    virtual void ReadBytes(void* dest, const size_t numBytes) override; //Copies straight out of m_buffer
     size_t WriteBytes(const void* src, const size_t numBytes) override;
     void WriteString(const char* str);
     void Advance(size_t offset);
@@ -1,6 +1,7 @@
 #include "Engine/Fonts/BitmapFont.hpp"
 #include "Engine/Renderer/AABB2.hpp"
 #include "Engine/Renderer/Texture.hpp"
+#include "Engine/Renderer/TextureAtlas.hpp"
 #include "Engine/Input/InputOutputUtils.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
@@ -10,7 +11,8 @@ std::map<size_t, BitmapFont*, std::less<size_t>, UntrackedAllocator<std::pair<si
 //-----------------------------------------------------------------------------------
 AABB2 BitmapFont::GetTexCoordsForGlyph(int glyphAscii) const
 {
-    return m_spriteSheet.GetTexCoordsForSpriteIndex(glyphAscii);
+    AABB2 texCoords = m_spriteSheet.GetTexCoordsForSpriteIndex(glyphAscii);
+    return m_atlasTexture ? TextureAtlas::RemapUVs(texCoords, m_atlasUVBounds) : texCoords;
 }
 
 //-----------------------------------------------------------------------------------
@@ -27,7 +29,7 @@ AABB2 BitmapFont::GetTexCoordsForGlyph(const Glyph& glyph) const
     texCoords.maxs.y = bottomLeft.y;
     texCoords.mins.x = bottomLeft.x;
     texCoords.mins.y = topRight.y;
-    return texCoords;
+    return m_atlasTexture ? TextureAtlas::RemapUVs(texCoords, m_atlasUVBounds) : texCoords;
 }
 
 //-----------------------------------------------------------------------------------
@@ -89,27 +91,44 @@ void BitmapFont::CleanUpBitmapFontRegistry()
 }
 
 //-----------------------------------------------------------------------------------
-Texture* BitmapFont::GetTexture() const
+unsigned int BitmapFont::PackAllIntoAtlas(TextureAtlas& atlas)
 {
-    return m_spriteSheet.GetTexture();
+    unsigned int numPacked = 0;
+    for (auto fontPair : s_fontRegistry)
+    {
+        numPacked += fontPair.second->PackIntoAtlas(atlas) ? 1 : 0;
+    }
+    return numPacked;
 }
 
 //-----------------------------------------------------------------------------------
-Material* BitmapFont::GetMaterial() const
+bool BitmapFont::PackIntoAtlas(TextureAtlas& atlas)
 {
-    return m_material;
+    if (m_atlasTexture)
+    {
+        return false;
+    }
+    if (!atlas.InsertTexture(m_spriteSheet.GetTexture(), m_atlasTexture, m_atlasUVBounds))
+    {
+        return false;
+    }
+    m_material->SetDiffuseTexture(m_atlasTexture);
+
+    //Cached layouts still hold texture coordinates on the old sheet.
+    m_layoutCache.Clear();
+    return true;
 }
 
 //-----------------------------------------------------------------------------------
-const Glyph* BitmapFont::GetGlyph(char glyphAscii) const
+Texture* BitmapFont::GetTexture() const
 {
-    auto characterIterator = m_glyphMap.find(glyphAscii);
-    if (characterIterator == BitmapFont::m_glyphMap.end())
-    {
-        //DebuggerPrintf("Font doesn't have a value for character '%c'. Using space instead. \n", glyphAscii);
-        return &m_glyphMap.find(' ')->second;
-    }
-    return &characterIterator->second;
+    return m_atlasTexture ? m_atlasTexture : m_spriteSheet.GetTexture();
+}
+
+//-----------------------------------------------------------------------------------
+Material* BitmapFont::GetMaterial() const
+{
+    return m_material;
 }
 
 //-----------------------------------------------------------------------------------
@@ -158,9 +177,11 @@ BitmapFont::BitmapFont(const std::string& bitmapFontName)
     , m_maxHeight(CHARACTER_WIDTH)
     , m_material(new Material(new ShaderProgram("Data/Shaders/fixedVertexFormat.vert", "Data/Shaders/fixedVertexFormat.frag"),
         RenderState(RenderState::DepthTestingMode::OFF, RenderState::FaceCullingMode::CULL_BACK_FACES, RenderState::BlendMode::ALPHA_BLEND)))
+    , m_atlasTexture(nullptr)
 {
     m_imageDimensions = m_spriteSheet.GetTexture()->m_texelSize;
     m_material->SetDiffuseTexture(m_spriteSheet.GetTexture());
+    BuildGlyphTable();
 }
 
 //-----------------------------------------------------------------------------------
@@ -169,6 +190,29 @@ void BitmapFont::LoadBMFontMetadata(const std::string& glyphFileName)
     std::vector<std::string> glyphSheet;
     ReadTextFileIntoVector(glyphSheet, "Data/Fonts/" + glyphFileName + ".fnt");
     ParseGlyphInfo(glyphSheet);
+    BuildGlyphTable();
+}
+
+//-----------------------------------------------------------------------------------
+void BitmapFont::BuildGlyphTable()
+{
+    auto spaceIterator = m_glyphMap.find(' ');
+    const Glyph* missingGlyph = spaceIterator != m_glyphMap.end() ? &spaceIterator->second : nullptr;
+    for (int i = 0; i < 256; ++i)
+    {
+        m_glyphTable[i] = missingGlyph;
+        m_hasKerningAfter[i] = false;
+    }
+    //The map never changes after loading, so pointing into it is safe.
+    for (const std::pair<const char, Glyph>& glyphPair : m_glyphMap)
+    {
+        m_glyphTable[(unsigned char)glyphPair.first] = &glyphPair.second;
+    }
+    for (const std::pair<const uint16_t, int>& kerningPair : m_kerningTable)
+    {
+        m_hasKerningAfter[kerningPair.first >> 8] = true;
+    }
+    m_layoutCache.Clear();
 }
 
 //-----------------------------------------------------------------------------------
@@ -234,8 +278,7 @@ void BitmapFont::ParseGlyphInfo(std::vector<std::string>& glyphMetaFile)
         char first = (char)std::stoi((*values)[FIRST_INDEX]);
         char second = (char)std::stoi((*values)[SECOND_INDEX]);
         int amount = std::stoi((*values)[AMOUNT_INDEX]);
-        Kerning info = Kerning(first, second, amount);
-        m_kerningMap.emplace(info.kerningPair, info.kerningOffsetAmount);
+        m_kerningTable.emplace(GetKerningKey(first, second), amount);
         delete values;
     }
 }
@@ -243,10 +286,22 @@ void BitmapFont::ParseGlyphInfo(std::vector<std::string>& glyphMetaFile)
 //-----------------------------------------------------------------------------------
 const Vector2 BitmapFont::GetKerning(const Glyph& prevGlyph, const Glyph& currentGlyph) const
 {
-    auto characterIterator = m_kerningMap.find(std::pair<char, char>(prevGlyph.id, currentGlyph.id));
-    if (characterIterator == BitmapFont::m_kerningMap.end())
+    return Vector2(static_cast<float>(GetKerningAmount(prevGlyph.id, currentGlyph.id)), 0.0f);
+}
+
+//-----------------------------------------------------------------------------------
+int BitmapFont::GetKerningAmount(char first, char second) const
+{
+    if (!m_hasKerningAfter[(unsigned char)first])
     {
-        return Vector2::ZERO;
+        return 0;
     }
-    return Vector2(static_cast<float>(characterIterator->second), 0.0f);
+    auto kerningIterator = m_kerningTable.find(GetKerningKey(first, second));
+    return kerningIterator != m_kerningTable.end() ? kerningIterator->second : 0;
+}
+
+//-----------------------------------------------------------------------------------
+const TextLayout& BitmapFont::GetLayout(const std::string& text, float scale, float wrapWidth) const
+{
+    return m_layoutCache.GetLayout(this, text, scale, wrapWidth);
 }
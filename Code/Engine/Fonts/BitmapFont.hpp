@@ -2,11 +2,16 @@
 #include "Engine/Renderer/SpriteSheet.hpp"
 #include "Engine/Renderer/Material.hpp"
 #include "Engine/Math/Vector2Int.hpp"
+#include "Engine/Fonts/TextLayoutCache.hpp"
 #include <map>
 #include <vector>
 #include <string>
+#include <unordered_map>
+#include <stdint.h>
 #include "../Core/Memory/UntrackedAllocator.hpp"
 
+class TextureAtlas;
+
 //---------------------------------------------------------------------------
 struct Glyph
 {
@@ -48,6 +53,8 @@ public:
     static BitmapFont* GetFontByName(const std::string& imageFilePath);
     static BitmapFont* CreateOrGetFont(const std::string& bitmapFontName);
     static void CleanUpBitmapFontRegistry();
+    static unsigned int PackAllIntoAtlas(TextureAtlas& atlas); //Returns how many fonts moved
+    bool PackIntoAtlas(TextureAtlas& atlas);
     float CalcTextWidth(const std::string& textToWrite, float scale) const;
     AABB2 CalcTextBounds(const std::string& textToWrite, float scale) const;
 
@@ -56,8 +63,12 @@ public:
     AABB2 GetTexCoordsForGlyph(const Glyph& glyph) const;
     Texture* GetTexture() const;
     Material* GetMaterial() const;
-    const Glyph* GetGlyph(char glyphAscii) const;
+    inline const Glyph* GetGlyph(char glyphAscii) const { return m_glyphTable[(unsigned char)glyphAscii]; };
     const Vector2 GetKerning(const Glyph& prevGlyph, const Glyph& currentGlyph) const;
+    int GetKerningAmount(char first, char second) const;
+    const TextLayout& GetLayout(const std::string& text, float scale, float wrapWidth = 0.0f) const;
+    inline const TextLayoutCache& GetLayoutCache() const { return m_layoutCache; };
+    inline bool IsInAtlas() const { return m_atlasTexture != nullptr; };
     int GetCharacterWidth();
 
     //MEMBER VARIABLES//////////////////////////////////////////////////////////////////////////
@@ -72,6 +83,8 @@ private:
     //HELPER FUNCTIONS//////////////////////////////////////////////////////////////////////////
     void ParseGlyphInfo(std::vector<std::string>& glyphSheet);
     void LoadBMFontMetadata(const std::string& glyphFileName);
+    void BuildGlyphTable();
+    static inline uint16_t GetKerningKey(char first, char second) { return (uint16_t)(((unsigned char)first << 8) | (unsigned char)second); };
 
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
     static std::map<size_t, BitmapFont*, std::less<size_t>, UntrackedAllocator<std::pair<size_t, BitmapFont*>>> s_fontRegistry;
@@ -81,5 +94,10 @@ private:
     Material* m_material;
     Vector2Int m_imageDimensions;
     std::map<char, Glyph> m_glyphMap;
-    std::map<std::pair<char, char>, int> m_kerningMap;
+    const Glyph* m_glyphTable[256]; //Every character, with anything the font doesn't have pointed at its space
+    std::unordered_map<uint16_t, int> m_kerningTable;
+    bool m_hasKerningAfter[256]; //Most characters never start a kerning pair, so they can skip the hash lookup
+    mutable TextLayoutCache m_layoutCache;
+    Texture* m_atlasTexture; //The atlas page the glyph sheet was copied onto, nullptr if it's still drawn from its own texture
+    AABB2 m_atlasUVBounds;
 };
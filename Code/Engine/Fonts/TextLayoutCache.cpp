@@ -0,0 +1,245 @@
+#include "Engine/Fonts/TextLayoutCache.hpp"
+#include "Engine/Fonts/BitmapFont.hpp"
+#include "Engine/Renderer/MeshBuilder.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Time/Time.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <string.h>
+
+//-----------------------------------------------------------------------------------
+void TextLayout::Shape(const BitmapFont* font, const std::string& textToShape, float textScale, float textWrapWidth)
+{
+    text = textToShape;
+    scale = textScale;
+    wrapWidth = textWrapWidth;
+    glyphs.clear();
+    glyphs.reserve(textToShape.size());
+    bounds = AABB2(Vector2::ZERO, Vector2::ZERO);
+    numLines = textToShape.empty() ? 0 : 1;
+    if (textToShape.empty())
+    {
+        return;
+    }
+
+    //Same placement MeshBuilder::AddText2D has always used, just relative to the origin.
+    float lineHeight = (float)font->m_maxHeight * scale;
+    Vector2 cursorPosition = Vector2::UNIT_Y * lineHeight;
+    const Glyph* previousGlyph = nullptr;
+    unsigned int wordStartIndex = 0;
+    float wordStartX = 0.0f;
+    bool lineHasBreak = false;
+
+    for (char character : textToShape)
+    {
+        const Glyph* glyph = font->GetGlyph(character);
+        float glyphWidth = static_cast<float>(glyph->width) * scale;
+        float glyphHeight = static_cast<float>(glyph->height) * scale;
+
+        if (previousGlyph)
+        {
+            cursorPosition.x += (float)font->GetKerningAmount(previousGlyph->id, glyph->id) * scale;
+        }
+        Vector2 offset = Vector2(glyph->xOffset * scale, -glyph->yOffset * scale);
+        ShapedGlyph shapedGlyph;
+        shapedGlyph.quadBounds = AABB2(cursorPosition + offset - Vector2(0.0f, glyphHeight), cursorPosition + offset + Vector2(glyphWidth, 0.0f));
+        shapedGlyph.texCoords = font->GetTexCoordsForGlyph(*glyph);
+
+        //Greedy wrapping at spaces: the word we're partway through drops to the start of a new line.
+        if (wrapWidth > 0.0f && lineHasBreak && character != ' ' && shapedGlyph.quadBounds.maxs.x > wrapWidth)
+        {
+            Vector2 shift = Vector2(-wordStartX, -lineHeight);
+            for (unsigned int i = wordStartIndex; i < glyphs.size(); ++i)
+            {
+                glyphs[i].quadBounds += shift;
+            }
+            shapedGlyph.quadBounds += shift;
+            cursorPosition += shift;
+            lineHasBreak = false;
+            ++numLines;
+        }
+        glyphs.push_back(shapedGlyph);
+        cursorPosition.x += glyph->xAdvance * scale;
+
+        if (character == ' ')
+        {
+            wordStartIndex = glyphs.size();
+            wordStartX = cursorPosition.x;
+            lineHasBreak = true;
+        }
+        previousGlyph = glyph;
+    }
+
+    bounds = glyphs[0].quadBounds;
+    for (const ShapedGlyph& shapedGlyph : glyphs)
+    {
+        bounds = AABB2::GetEncompassingAABB2(bounds, shapedGlyph.quadBounds);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+TextLayoutCache::TextLayoutCache()
+    : m_useCounter(0)
+    , m_numHits(0)
+    , m_numMisses(0)
+{
+
+}
+
+//-----------------------------------------------------------------------------------
+TextLayoutCache::~TextLayoutCache()
+{
+    Clear();
+}
+
+//-----------------------------------------------------------------------------------
+const TextLayout& TextLayoutCache::GetLayout(const BitmapFont* font, const std::string& text, float scale, float wrapWidth)
+{
+    ++m_useCounter;
+    uint64_t key = HashKey(text, scale, wrapWidth);
+    auto found = m_layouts.find(key);
+    if (found != m_layouts.end())
+    {
+        TextLayout* layout = found->second;
+        layout->lastUsed = m_useCounter;
+        if (layout->scale == scale && layout->wrapWidth == wrapWidth && layout->text == text)
+        {
+            ++m_numHits;
+            return *layout;
+        }
+        //Two keys hashed the same, the newer one just takes the slot over.
+        ++m_numMisses;
+        layout->Shape(font, text, scale, wrapWidth);
+        return *layout;
+    }
+
+    ++m_numMisses;
+    if (m_layouts.size() >= MAX_CACHED_LAYOUTS)
+    {
+        EvictOldLayouts();
+    }
+    TextLayout* layout = new TextLayout();
+    layout->Shape(font, text, scale, wrapWidth);
+    layout->lastUsed = m_useCounter;
+    m_layouts[key] = layout;
+    return *layout;
+}
+
+//-----------------------------------------------------------------------------------
+void TextLayoutCache::Clear()
+{
+    for (auto& layoutPair : m_layouts)
+    {
+        delete layoutPair.second;
+    }
+    m_layouts.clear();
+}
+
+//-----------------------------------------------------------------------------------
+uint64_t TextLayoutCache::HashKey(const std::string& text, float scale, float wrapWidth)
+{
+    //FNV-1a over the string, then the exact bits of the scale and wrap width.
+    uint64_t hash = 14695981039346656037ULL;
+    for (char character : text)
+    {
+        hash = (hash ^ (unsigned char)character) * 1099511628211ULL;
+    }
+    uint32_t scaleBits;
+    uint32_t wrapBits;
+    memcpy(&scaleBits, &scale, sizeof(scaleBits));
+    memcpy(&wrapBits, &wrapWidth, sizeof(wrapBits));
+    hash = (hash ^ scaleBits) * 1099511628211ULL;
+    hash = (hash ^ wrapBits) * 1099511628211ULL;
+    return hash;
+}
+
+//-----------------------------------------------------------------------------------
+void TextLayoutCache::EvictOldLayouts()
+{
+    //Anything not drawn in the last half a cache's worth of lookups goes, which always frees at least half.
+    for (auto iter = m_layouts.begin(); iter != m_layouts.end();)
+    {
+        if (m_useCounter - iter->second->lastUsed > MAX_CACHED_LAYOUTS / 2)
+        {
+            delete iter->second;
+            iter = m_layouts.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(textbench)
+{
+    int numLabels = args.HasArgs(2) ? Max<int>(args.GetIntArgument(0), 1) : 10000;
+    int numUniqueStrings = args.HasArgs(2) ? Max<int>(args.GetIntArgument(1), 1) : 1000;
+    const int NUM_FRAMES = 10;
+    BitmapFont* font = BitmapFont::CreateOrGetFont("Runescape");
+
+    std::vector<std::string> strings;
+    std::vector<Vector2> positions;
+    for (int i = 0; i < numLabels; ++i)
+    {
+        strings.push_back(Stringf("Label number %i: %i/%i", i % numUniqueStrings, (i * 7) % 100, 100));
+        positions.push_back(Vector2(MathUtils::GetRandomFloatFromZeroTo(1600.0f), MathUtils::GetRandomFloatFromZeroTo(900.0f)));
+    }
+    MeshBuilder* builder = new MeshBuilder();
+    unsigned int numVertices = 0;
+
+    //Shaping every label from scratch every frame, like drawing text always used to.
+    TextLayout scratchLayout;
+    double startSeconds = GetCurrentTimeSeconds();
+    for (int frame = 0; frame < NUM_FRAMES; ++frame)
+    {
+        for (int i = 0; i < numLabels; ++i)
+        {
+            scratchLayout.Shape(font, strings[i], 1.0f, 0.0f);
+            builder->AddTextLayout(positions[i], scratchLayout, RGBA::WHITE, true);
+        }
+        numVertices = builder->m_vertices.size();
+        builder->ClearVertsAndIndices();
+    }
+    double shapedSeconds = (GetCurrentTimeSeconds() - startSeconds) / (double)NUM_FRAMES;
+
+    //Going through the font's layout cache, which is what AddText2D does now.
+    uint64_t hitsBefore = font->GetLayoutCache().GetNumHits();
+    uint64_t missesBefore = font->GetLayoutCache().GetNumMisses();
+    startSeconds = GetCurrentTimeSeconds();
+    for (int frame = 0; frame < NUM_FRAMES; ++frame)
+    {
+        for (int i = 0; i < numLabels; ++i)
+        {
+            builder->AddText2D(positions[i], strings[i], 1.0f, RGBA::WHITE, true, font);
+        }
+        builder->ClearVertsAndIndices();
+    }
+    double cachedSeconds = (GetCurrentTimeSeconds() - startSeconds) / (double)NUM_FRAMES;
+    uint64_t numHits = font->GetLayoutCache().GetNumHits() - hitsBefore;
+    uint64_t numMisses = font->GetLayoutCache().GetNumMisses() - missesBefore;
+
+    //Labels holding on to their own layout, only reshaped when their string changes.
+    std::vector<TextLayout> retainedLayouts(numLabels);
+    for (int i = 0; i < numLabels; ++i)
+    {
+        retainedLayouts[i].Shape(font, strings[i], 1.0f, 0.0f);
+    }
+    startSeconds = GetCurrentTimeSeconds();
+    for (int frame = 0; frame < NUM_FRAMES; ++frame)
+    {
+        for (int i = 0; i < numLabels; ++i)
+        {
+            builder->AddTextLayout(positions[i], retainedLayouts[i], RGBA::WHITE, true);
+        }
+        builder->ClearVertsAndIndices();
+    }
+    double retainedSeconds = (GetCurrentTimeSeconds() - startSeconds) / (double)NUM_FRAMES;
+    delete builder;
+
+    Console::instance->PrintLine(Stringf("Text for %i labels (%i unique strings, %u vertices) per frame:", numLabels, numUniqueStrings, numVertices), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("Shaped every frame: %.3fms", shapedSeconds * 1000.0), RGBA::GBWHITE);
+    Console::instance->PrintLine(Stringf("Layout cache: %.3fms, %i hits, %i misses, %u layouts cached", cachedSeconds * 1000.0, (int)numHits, (int)numMisses, font->GetLayoutCache().GetNumLayouts()), RGBA::GBWHITE);
+    Console::instance->PrintLine(Stringf("Retained per label: %.3fms", retainedSeconds * 1000.0), RGBA::GBWHITE);
+}
\ No newline at end of file
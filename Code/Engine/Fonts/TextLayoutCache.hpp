@@ -0,0 +1,65 @@
+#pragma once
+#include "Engine/Renderer/AABB2.hpp"
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <stdint.h>
+
+class BitmapFont;
+
+//-----------------------------------------------------------------------------------
+struct ShapedGlyph
+{
+    AABB2 quadBounds; //Relative to the position the text is drawn at
+    AABB2 texCoords;
+};
+
+//-----------------------------------------------------------------------------------
+// A string run through a font once: every glyph placed with kerning and wrapping already applied.
+// Drawing it somewhere is just offsetting the quads, so any number of labels can share one.
+struct TextLayout
+{
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void Shape(const BitmapFont* font, const std::string& text, float scale, float wrapWidth);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<ShapedGlyph> glyphs;
+    AABB2 bounds;
+    std::string text;
+    float scale = 1.0f;
+    float wrapWidth = 0.0f; //0 never wraps
+    int numLines = 0;
+    uint32_t lastUsed = 0;
+};
+
+//-----------------------------------------------------------------------------------
+// Each BitmapFont keeps one of these, keyed on (string, scale, wrap width). Strings that stop being
+// drawn age out once the cache fills up. Like the rest of text drawing, it's main thread only.
+class TextLayoutCache
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    TextLayoutCache();
+    ~TextLayoutCache();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    const TextLayout& GetLayout(const BitmapFont* font, const std::string& text, float scale, float wrapWidth);
+    void Clear();
+    inline unsigned int GetNumLayouts() const { return m_layouts.size(); };
+    inline uint64_t GetNumHits() const { return m_numHits; };
+    inline uint64_t GetNumMisses() const { return m_numMisses; };
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const unsigned int MAX_CACHED_LAYOUTS = 8192;
+
+private:
+    //PRIVATE FUNCTIONS/////////////////////////////////////////////////////////////////////
+    static uint64_t HashKey(const std::string& text, float scale, float wrapWidth);
+    void EvictOldLayouts();
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::unordered_map<uint64_t, TextLayout*> m_layouts;
+    uint32_t m_useCounter;
+    uint64_t m_numHits;
+    uint64_t m_numMisses;
+};
\ No newline at end of file
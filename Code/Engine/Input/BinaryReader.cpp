@@ -29,6 +29,11 @@ void* BinaryFileReader::ReadBytes(const size_t numBytes)
     return buffer;
 }
 
+void BinaryFileReader::ReadBytes(void* dest, const size_t numBytes)
+{
+    fread(dest, sizeof(byte), numBytes, fileHandle);
+}
+
 IBinaryReader::Endianness IBinaryReader::GetLocalEndianess()
 {
     union {
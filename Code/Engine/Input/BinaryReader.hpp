@@ -29,6 +29,8 @@ public:
     //Returns the number of bytes written. This is the core implementation that subclasses
     //need to support. Writes to the appropriate buffer the bytes.
     virtual void* ReadBytes(const size_t numBytes) = 0;
+    //Same, but into memory the caller owns, so fixed size reads never touch the heap.
+    virtual void ReadBytes(void* dest, const size_t numBytes) = 0;
 
     //-----------------------------------------------------------------------------------
     template<typename T>
@@ -54,9 +56,7 @@ public:
     template<typename T>
     bool Read(T& data)
     {
-        void* readData = ReadBytes(sizeof(T));
-        memcpy(&data, readData, sizeof(T));
-        delete readData;
+        ReadBytes(&data, sizeof(T));
         if (GetLocalEndianess() != m_endianMode)
         {
             ByteSwap(&data, sizeof(T));
@@ -75,6 +75,7 @@ public:
     bool Open(const char* filePath);
     void Close();
     virtual void* ReadBytes(const size_t numBytes) override;
+    virtual void ReadBytes(void* dest, const size_t numBytes) override;
 
     //MEMBER VARIABLES//////////////////////////////////////////////////////////////////////////
     FILE* fileHandle;
@@ -15,8 +15,7 @@
 #include "../Audio/Audio.hpp"
 
 Console* Console::instance = nullptr;
-std::map<size_t, ConsoleCommandFunctionPointer, std::less<size_t>, UntrackedAllocator<std::pair<size_t, ConsoleCommandFunctionPointer>>>* g_consoleCommands = nullptr;
-std::map<const char*, const char*, std::less<const char*>, UntrackedAllocator<std::pair<const char*, const char*>>>* g_helpStringLookup = nullptr;
+ConsoleCommandRegistry* g_consoleCommands = nullptr;
 
 const float Console::CHARACTER_HEIGHT = 20.0f;
 const float Console::CHARACTER_WIDTH = 15.0f;
@@ -24,7 +23,9 @@ const float Console::CURSOR_BLINK_RATE_SECONDS = 0.5f;
 
 //-----------------------------------------------------------------------------------
 Console::Console()
-    : m_currentLine(new char[MAX_LINE_LENGTH]())
+    : m_scrollback(MAX_SCROLLBACK_LINES, SCROLLBACK_ARENA_BYTES)
+    , m_scrollLine(ConsoleScrollback::INVALID_LINE)
+    , m_currentLine(new char[MAX_LINE_LENGTH]())
     , m_cursorPointer(m_currentLine)
     , m_isActive(false)
     , m_isCursorShowing(false)
@@ -60,9 +61,11 @@ void Console::Update(float deltaSeconds)
         }
 
         int mousewheelDelta = InputSystem::instance->GetScrollDeltaThisFrame();
-        if(mousewheelDelta != 0)
+        if(mousewheelDelta != 0 && m_scrollback.GetNumLines() > 0)
         {
-            m_consoleHistoryIndex = Clamp<int>(m_consoleHistoryIndex - mousewheelDelta, 0, m_consoleHistory.size() - 1);
+            int64_t oldestLine = (int64_t)m_scrollback.GetOldestLine();
+            int64_t scrollLine = m_scrollback.IsValid(m_scrollLine) ? (int64_t)m_scrollLine : oldestLine;
+            m_scrollLine = (ConsoleLineHandle)Clamp<int64_t>(scrollLine - mousewheelDelta, oldestLine, (int64_t)m_scrollback.GetNewestLine());
         }
     }
 }
@@ -75,15 +78,7 @@ void Console::ParseKey(char currentChar)
 
     if (InputSystem::instance->WasKeyJustPressed(InputSystem::ExtraKeys::TAB))
     {
-        //TODO: Make this work later.
-//         std::string commandLine(m_currentLine);
-//         std::vector<std::string>* tokenizedString = SplitString(commandLine, " ");
-//         if (tokenizedString->size() == 1)
-//         {
-//             std::string partialCommandName = tokenizedString->at(0);
-//         }
-// 
-//         delete tokenizedString;
+        CompleteCurrentLine();
     }
 
     if (InputSystem::instance->WasKeyJustPressed(InputSystem::ExtraKeys::TILDE))
@@ -147,13 +142,14 @@ void Console::ParseKey(char currentChar)
             return;
         }
         std::string currentLine = std::string(m_currentLine);
-        m_consoleHistory.push_back(new ColoredText(currentLine, RGBA::GRAY));
+        m_scrollback.AddLine(currentLine.c_str(), (uint32_t)currentLine.size(), RGBA::GRAY);
+        //Snap to the bottom before running it, so a command is free to scroll somewhere else
+        m_scrollLine = m_scrollback.GetNewestLine();
         if (!RunCommand(currentLine, true))
         {
-            m_consoleHistory.push_back(new ColoredText("Invalid Command.", RGBA::MAROON));
+            m_scrollLine = m_scrollback.AddLine("Invalid Command.", 16, RGBA::MAROON);
         }
         m_cursorPointer = m_currentLine;
-        m_consoleHistoryIndex = m_consoleHistory.size() - 1;
         memset(m_currentLine, 0x00, MAX_LINE_LENGTH);
         BlinkCursor();
     }
@@ -309,23 +305,7 @@ void Console::Render() const
                 BufferedMeshRenderer bufferedMeshRenderer;
                 bufferedMeshRenderer.SetMaterial(m_font->GetMaterial());
                 bufferedMeshRenderer.m_builder.AddText2D(currentBaseline, currentLine, 1.0f, RGBA::WHITE, true, m_font);
-
-                int index = m_consoleHistoryIndex;
-                unsigned int numberOfLinesPrinted = 0;
-                for (auto reverseIterator = m_consoleHistory.rbegin(); reverseIterator != m_consoleHistory.rend(); ++reverseIterator, --index)
-                {
-                    if (index < 0)
-                    {
-                        break;
-                    }
-                    currentBaseline += Vector2(0.0f, (float)m_font->m_maxHeight);
-                    bufferedMeshRenderer.m_builder.AddText2D(currentBaseline, m_consoleHistory[index]->text, 1.0f, m_consoleHistory[index]->color, true, m_font);
-                    numberOfLinesPrinted++;
-                    if (numberOfLinesPrinted > MAX_CONSOLE_LINES)
-                    {
-                        break;
-                    }
-                }
+                BuildScrollbackGeometry(m_scrollback, m_scrollLine, currentBaseline, bufferedMeshRenderer.m_builder);
                 bufferedMeshRenderer.FlushAndRender();
             }
             Renderer::instance->m_defaultMaterial->m_renderState.depthTestingMode = RenderState::DepthTestingMode::ON;
@@ -375,201 +355,329 @@ void Console::DeactivateConsole()
 //-----------------------------------------------------------------------------------
 void Console::ClearConsoleHistory()
 {
-    for (ColoredText* text : m_consoleHistory)
+    m_scrollback.Clear();
+    m_scrollLine = ConsoleScrollback::INVALID_LINE;
+    m_consoleClear.Trigger();
+}
+
+//-----------------------------------------------------------------------------------
+//Only the lines that fit on screen above the baseline get any geometry, however much scrollback there is.
+void Console::BuildScrollbackGeometry(const ConsoleScrollback& scrollback, ConsoleLineHandle bottomLine, const Vector2& baseline, MeshBuilder& builder) const
+{
+    if (!scrollback.IsValid(bottomLine))
     {
-        delete text;
+        bottomLine = scrollback.GetNewestLine();
+        if (bottomLine == ConsoleScrollback::INVALID_LINE)
+        {
+            return;
+        }
     }
-    m_consoleHistory.clear();
-    m_consoleHistoryIndex = 0;
-    m_consoleClear.Trigger();
+
+    Vector2 currentBaseline = baseline;
+    std::string fragment;
+    ConsoleLineHandle oldestLine = scrollback.GetOldestLine();
+    ConsoleLineHandle line = bottomLine;
+    for (unsigned int numberOfLinesPrinted = 0; numberOfLinesPrinted <= MAX_CONSOLE_LINES; ++numberOfLinesPrinted)
+    {
+        ConsoleLineView lineView;
+        scrollback.GetLine(line, lineView);
+        currentBaseline += Vector2(0.0f, (float)m_font->m_maxHeight);
+
+        float runOffset = 0.0f;
+        for (uint32_t runIndex = 0; runIndex < lineView.numRuns; ++runIndex)
+        {
+            uint32_t runStart = lineView.runs[runIndex].start;
+            uint32_t runEnd = (runIndex + 1 < lineView.numRuns) ? lineView.runs[runIndex + 1].start : lineView.length;
+            if (runEnd <= runStart)
+            {
+                continue;
+            }
+            fragment.assign(lineView.text + runStart, runEnd - runStart);
+            builder.AddText2D(currentBaseline + Vector2(runOffset, 0.0f), fragment, 1.0f, lineView.runs[runIndex].color, true, m_font);
+            if (runIndex + 1 < lineView.numRuns)
+            {
+                runOffset += m_font->CalcTextWidth(fragment, 1.0f);
+            }
+        }
+
+        if (line == oldestLine)
+        {
+            break;
+        }
+        --line;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void Console::RegisterCommand(const char* commandName, ConsoleCommandFunctionPointer consoleFunction, const char* helpText)
+{
+    g_consoleCommands->Register(commandName, consoleFunction, helpText);
+}
+
+//-----------------------------------------------------------------------------------
+void Console::UnregisterCommand(const char* commandName)
+{
+    g_consoleCommands->Unregister(commandName);
+}
+
+//-----------------------------------------------------------------------------------
+//Completes the command name under the cursor as far as it's unambiguous, and lists the candidates if there's more than one.
+void Console::CompleteCurrentLine()
+{
+    char* nameStart = m_currentLine;
+    while (*nameStart == ' ')
+    {
+        ++nameStart;
+    }
+    char* nameEnd = nameStart;
+    while (*nameEnd != '\0' && *nameEnd != ' ')
+    {
+        ++nameEnd;
+    }
+    if (*nameEnd != '\0' || m_cursorPointer != nameEnd)
+    {
+        return;
+    }
+
+    const ConsoleCompletionTrie& completions = g_consoleCommands->GetCompletionTrie();
+    size_t prefixLength = nameEnd - nameStart;
+    ConsoleCompletionTrie::NameList matches;
+    completions.GetCompletions(nameStart, prefixLength, matches, MAX_COMPLETIONS_LISTED + 1);
+    if (matches.empty())
+    {
+        return;
+    }
+
+    size_t completedLength = completions.GetCompletedLength(nameStart, prefixLength);
+    const char* lineEnd = m_currentLine + MAX_LINE_LENGTH - 2;
+    for (size_t i = prefixLength; i < completedLength && nameEnd < lineEnd; ++i)
+    {
+        *nameEnd++ = matches[0][i];
+    }
+    if (matches.size() == 1 && nameEnd < lineEnd)
+    {
+        *nameEnd++ = ' ';
+    }
+    else if (matches.size() > 1)
+    {
+        for (size_t i = 0; i < matches.size() && i < (size_t)MAX_COMPLETIONS_LISTED; ++i)
+        {
+            PrintLine(matches[i], RGBA::GRAY);
+        }
+        if (matches.size() > (size_t)MAX_COMPLETIONS_LISTED)
+        {
+            PrintLine("...", RGBA::GRAY);
+        }
+    }
+    *nameEnd = '\0';
+    m_cursorPointer = nameEnd;
+    BlinkCursor();
 }
 
 //-----------------------------------------------------------------------------------
-void Console::RegisterCommand(const char* commandName, ConsoleCommandFunctionPointer consoleFunction)
+void Console::PrintLine(const std::string& consoleLine, RGBA color)
 {
-    size_t commandNameHash = std::hash<std::string>{}(std::string(commandName));
-    g_consoleCommands->emplace(commandNameHash, consoleFunction);
-    g_helpStringLookup->emplace(commandName, "Write help text for this command! <3");
+    m_scrollLine = m_scrollback.AddLine(consoleLine.c_str(), (uint32_t)consoleLine.size(), color);
+    m_onPrintLine.Trigger(consoleLine.c_str());
 }
 
 //-----------------------------------------------------------------------------------
-void Console::PrintLine(std::string consoleLine, RGBA color)
+void Console::PrintLine(const std::string& consoleLine, const ConsoleColorRun* colorRuns, uint32_t numColorRuns)
 {
-    m_consoleHistory.push_back(new ColoredText(consoleLine, color));
-    m_consoleHistoryIndex = m_consoleHistory.size() - 1;
+    m_scrollLine = m_scrollback.AddLine(consoleLine.c_str(), (uint32_t)consoleLine.size(), colorRuns, numColorRuns);
+    m_onPrintLine.Trigger(consoleLine.c_str());
 }
 
 //-----------------------------------------------------------------------------------
-ColoredText* Console::PrintDynamicLine(std::string consoleLine, RGBA color /*= RGBA::WHITE*/)
+ConsoleLineHandle Console::PrintDynamicLine(const std::string& consoleLine, RGBA color /*= RGBA::WHITE*/)
 {
-    m_consoleHistory.push_back(new ColoredText(consoleLine, color));
-    m_consoleHistoryIndex = m_consoleHistory.size() - 1;
-    return *(--m_consoleHistory.end());
+    m_scrollLine = m_scrollback.AddLine(consoleLine.c_str(), (uint32_t)consoleLine.size(), color, DYNAMIC_LINE_LENGTH);
+    m_onPrintLine.Trigger(consoleLine.c_str());
+    return m_scrollLine;
 }
 
 //-----------------------------------------------------------------------------------
-//Returns true if command was found and run, false if invalid.
-bool Console::RunCommand(const std::string& commandLine, bool addToHistory /*= false*/)
+//False once the line has scrolled out of the scrollback, at which point the handle can be dropped.
+bool Console::UpdateDynamicLine(ConsoleLineHandle line, const std::string& consoleLine)
 {
-    return RunCommand(std::wstring(commandLine.begin(), commandLine.end()), addToHistory);
+    return m_scrollback.SetLineText(line, consoleLine.c_str(), (uint32_t)consoleLine.size());
 }
 
 //-----------------------------------------------------------------------------------
-bool Console::RunCommand(const std::wstring& commandLine, bool addToHistory /*= false*/)
+//Scrolls up to the next line above the current view containing the text, wrapping back around to the bottom.
+bool Console::FindInScrollback(const std::string& searchText)
+{
+    ConsoleLineHandle before = m_scrollback.IsValid(m_scrollLine) ? m_scrollLine : ConsoleScrollback::INVALID_LINE;
+    ConsoleLineHandle match = m_scrollback.FindPrevious(searchText.c_str(), (uint32_t)searchText.size(), before);
+    if (match == ConsoleScrollback::INVALID_LINE)
+    {
+        match = m_scrollback.FindPrevious(searchText.c_str(), (uint32_t)searchText.size(), ConsoleScrollback::INVALID_LINE);
+    }
+    if (match == ConsoleScrollback::INVALID_LINE)
+    {
+        return false;
+    }
+    m_scrollLine = match;
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+//Returns true if command was found and run, false if invalid.
+bool Console::RunCommand(const char* commandLine, size_t commandLineLength, bool addToHistory /*= false*/)
 {
     if (addToHistory)
     {
-        m_commandHistory.push_back(commandLine);
+        m_commandHistory.push_back(std::wstring(commandLine, commandLine + commandLineLength));
         m_commandHistoryIndex = m_commandHistory.size();
     }
-    Command command(commandLine);
+    Command command(commandLine, commandLineLength);
 
-    size_t commandNameHash = std::hash<std::string>{}(command.GetCommandName());
-    auto iterator = g_consoleCommands->find(commandNameHash);
-    if (iterator != g_consoleCommands->end())
+    const CommandArgument& commandName = command.GetCommandNameToken();
+    const ConsoleCommandRegistry::Entry* entry = g_consoleCommands->Find(commandName.text, commandName.length);
+    if (entry)
     {
-        ConsoleCommandFunctionPointer outCommand = (*iterator).second;
-        outCommand(command);
+        entry->function(command);
         return true;
     };
     return false;
 }
 
 //-----------------------------------------------------------------------------------
-Command::Command(std::string fullCommandStr)
-    : m_fullCommandStr(std::wstring(fullCommandStr.begin(), fullCommandStr.end()))
-    , m_fullArgsString(L"")
+bool Console::RunCommand(const std::wstring& commandLine, bool addToHistory /*= false*/)
 {
-    char* charLine = (char*)fullCommandStr.c_str();
-    char* token = nullptr;
-    char* context = nullptr;
-    char delimiters[] = " ";
+    return RunCommand(std::string(commandLine.begin(), commandLine.end()), addToHistory);
+}
 
-    token = strtok_s(charLine, delimiters, &context);
-    //First "arg" is the name
-    if (token == nullptr)
+//-----------------------------------------------------------------------------------
+bool CommandArgument::ParseInt(int& outValue) const
+{
+    const char* current = text;
+    const char* end = text + length;
+    bool isNegative = (current != end && *current == '-');
+    if (current != end && (*current == '-' || *current == '+'))
     {
-        m_commandName = std::wstring(L"INVALID_COMMAND");
+        ++current;
     }
-    else
+    if (current == end || *current < '0' || *current > '9')
     {
-        std::string name = std::string(token);
-        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
-        m_commandName = std::wstring(name.begin(), name.end());
-        token = strtok_s(NULL, delimiters, &context);
-
-        //Save off the full list of arguments in case we forward this command.
-        if (token)
-        {
-            m_fullArgsString = m_fullCommandStr.substr(m_fullCommandStr.find(L" ") + 1);
-        }
-
-        bool isInQuotes = false;
-        std::string argument = "";
-        while (token != nullptr)
-        {
-            int tokenLength = strlen(token);
-            std::string tokenString(token);
-
-            if (token[0] == '"')
-            {
-                isInQuotes = true;
-                tokenString = tokenString.substr(1);
-            }
+        return false;
+    }
+    int value = 0;
+    while (current != end && *current >= '0' && *current <= '9')
+    {
+        value = (value * 10) + (*current - '0');
+        ++current;
+    }
+    outValue = isNegative ? -value : value;
+    return true;
+}
 
-            if (token[tokenLength - 1] == '"')
-            {
-                isInQuotes = false;
-                tokenString = tokenString.substr(0, strlen(tokenString.c_str()) - 1);
-                argument += tokenString;
-                m_argsList.push_back(std::wstring(argument.begin(), argument.end()));
-                token = strtok_s(NULL, delimiters, &context);
-                continue;
-            }
-            else
-            {
-                if (isInQuotes)
-                {
-                    argument += tokenString + " ";
-                }
-                else
-                {
-                    argument += tokenString;
-                    m_argsList.push_back(std::wstring(argument.begin(), argument.end()));
-                }
-                token = strtok_s(NULL, delimiters, &context);
-            }
-        }
+//-----------------------------------------------------------------------------------
+bool CommandArgument::ParseFloat(float& outValue) const
+{
+    //strtof wants a terminated string, arguments longer than this aren't numbers anyway
+    char buffer[64];
+    if (length == 0 || length >= sizeof(buffer))
+    {
+        return false;
+    }
+    memcpy(buffer, text, length);
+    buffer[length] = '\0';
+    char* parseEnd = nullptr;
+    float value = strtof(buffer, &parseEnd);
+    if (parseEnd == buffer)
+    {
+        return false;
     }
+    outValue = value;
+    return true;
 }
 
 //-----------------------------------------------------------------------------------
-Command::Command(std::wstring fullCommandStr)
-    : m_fullCommandStr(fullCommandStr)
-    , m_fullArgsString(L"")
+Command::Command(const char* commandLine, size_t commandLineLength)
+    : m_numArgs(0)
 {
-    wchar_t* charLine = (wchar_t*)fullCommandStr.c_str();
-    wchar_t* token = nullptr;
-    wchar_t* context = nullptr;
-    wchar_t delimiters[] = L" ";
+    const char* current = commandLine;
+    const char* end = commandLine + commandLineLength;
+    while (current != end && *current == ' ')
+    {
+        ++current;
+    }
 
-    token = wcstok_s(charLine, delimiters, &context);
     //First "arg" is the name
-    if (token == nullptr)
+    const char* nameStart = current;
+    while (current != end && *current != ' ')
     {
-        m_commandName = std::wstring(L"INVALID_COMMAND");
+        ++current;
     }
-    else
-    {
-        m_commandName = std::wstring(token);
-        std::transform(m_commandName.begin(), m_commandName.end(), m_commandName.begin(), ::tolower);
-        token = wcstok_s(NULL, delimiters, &context);
+    m_commandName = CommandArgument(nameStart, current - nameStart);
 
-        //Save off the full list of arguments in case we forward this command.
-        if (token)
-        {
-            m_fullArgsString = m_fullCommandStr.substr(m_fullCommandStr.find(L" ") + 1);
-        }
+    while (current != end && *current == ' ')
+    {
+        ++current;
+    }
+    m_allArguments = CommandArgument(current, end - current);
 
-        bool isInQuotes = false;
-        std::wstring argument = L"";
-        while (token != nullptr)
+    while (current != end && m_numArgs < MAX_ARGUMENTS)
+    {
+        const char* argumentStart = current;
+        const char* argumentEnd = nullptr;
+        if (*current == '"')
         {
-            int tokenLength = wcslen(token);
-            std::wstring tokenString(token);
-
-            if (token[0] == L'"')
+            //Quoted arguments run to a closing quote at the end of a word, spaces and all
+            ++argumentStart;
+            ++current;
+            while (current != end && !(*current == '"' && (current + 1 == end || current[1] == ' ')))
             {
-                isInQuotes = true;
-                tokenString = tokenString.substr(1);
+                ++current;
             }
-
-            if (token[tokenLength - 1] == L'"')
+            argumentEnd = current;
+            if (current != end)
             {
-                isInQuotes = false;
-                tokenString = tokenString.substr(0, wcslen(tokenString.c_str()) - 1);
-                argument += tokenString;
-                m_argsList.push_back(argument);
-                token = wcstok_s(NULL, delimiters, &context);
-                continue;
+                ++current;
             }
-            else
+        }
+        else
+        {
+            while (current != end && *current != ' ')
             {
-                if (isInQuotes)
-                {
-                    argument += tokenString + L" ";
-                }
-                else
-                {
-                    argument = tokenString;
-                    m_argsList.push_back(argument);
-                }
-                token = wcstok_s(NULL, delimiters, &context);
+                ++current;
             }
+            argumentEnd = current;
+        }
+        m_args[m_numArgs++] = CommandArgument(argumentStart, argumentEnd - argumentStart);
+
+        while (current != end && *current == ' ')
+        {
+            ++current;
         }
     }
 }
 
+//-----------------------------------------------------------------------------------
+std::string Command::GetCommandName() const
+{
+    std::string name = m_commandName.ToString();
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    return name;
+}
+
+//-----------------------------------------------------------------------------------
+int Command::GetIntArgument(int argNumber) const
+{
+    int value = 0;
+    m_args[argNumber].ParseInt(value);
+    return value;
+}
+
+//-----------------------------------------------------------------------------------
+float Command::GetFloatArgument(int argNumber) const
+{
+    float value = 0.0f;
+    m_args[argNumber].ParseFloat(value);
+    return value;
+}
+
 //-----------------------------------------------------------------------------------
 CONSOLE_COMMAND(help)
 {
@@ -578,16 +686,18 @@ CONSOLE_COMMAND(help)
         Console::instance->PrintLine("Console Controls:", RGBA::WHITE);
         Console::instance->PrintLine("Enter ~ Run command / Close console (if line empty)", RGBA::GRAY);
         Console::instance->PrintLine("All registered commands:", RGBA::WHITE);
+        ConsoleCompletionTrie::NameList commandNames;
+        g_consoleCommands->GetCompletionTrie().GetCompletions("", 0, commandNames, g_consoleCommands->GetNumCommands());
         float i = 0.0f;
-        for (auto helpStringPair : *g_helpStringLookup)
+        for (const char* commandName : commandNames)
         {
-            float frequency = 3.14f * 2.0f / (float)g_helpStringLookup->size();
+            float frequency = 3.14f * 2.0f / (float)commandNames.size();
             float center = 0.5f;
             float width = 0.49f;
             float red = sin(frequency * i + 2.0f) * width + center;
             float green = sin(frequency * i + 0.0f) * width + center;
             float blue = sin(frequency * i + 4.0f) * width + center;
-            Console::instance->PrintLine(std::string(helpStringPair.first), RGBA(red, green, blue));
+            Console::instance->PrintLine(std::string(commandName), RGBA(red, green, blue));
             i += 1.0f;
         }
         return;
@@ -598,12 +708,7 @@ CONSOLE_COMMAND(help)
         return;
     }
     std::string arg0 = args.GetStringArgument(0);
-#pragma todo("Make this actually work, we're trying to look up the help text but this is doing a pointer comparison not strcmp")
-    auto iter = g_helpStringLookup->find(arg0.c_str());
-    if (iter != g_helpStringLookup->end())
-    {
-        Console::instance->PrintLine(iter->first, RGBA::GRAY);
-    }
+    const ConsoleCommandRegistry::Entry* entry = g_consoleCommands->Find(arg0.c_str(), arg0.size());
     if (arg0 == "help")
     {
         Console::instance->PrintLine("help: A command (that you just used) to find more info on other commands! Success! :D", RGBA::GRAY);
@@ -628,6 +733,10 @@ CONSOLE_COMMAND(help)
     {
         Console::instance->PrintLine("changefont: Changes the console's default font to a named font from the font folder.", RGBA::GRAY);
     }
+    else if (entry)
+    {
+        Console::instance->PrintLine(Stringf("%s: %s", entry->name, entry->helpText), RGBA::GRAY);
+    }
     else
     {
         Console::instance->PrintLine("Undocumented or Unknown command", RGBA::GRAY);
@@ -649,6 +758,21 @@ CONSOLE_COMMAND(quit)
     g_isQuitting = true;
 }
 
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(find)
+{
+    if (args.HasArgs(0))
+    {
+        Console::instance->PrintLine("find <text>", RGBA::GRAY);
+        return;
+    }
+    //Doesn't print anything on success, that would scroll right back to the bottom
+    if (!Console::instance->FindInScrollback(args.GetAllArguments()))
+    {
+        Console::instance->PrintLine("No matches in the scrollback.", RGBA::MAROON);
+    }
+}
+
 //-----------------------------------------------------------------------------------
 CONSOLE_COMMAND(runfor)
 {
@@ -730,4 +854,118 @@ CONSOLE_COMMAND(cd)
     wideNewCWD = RelativeToFullPath(wideNewCWD); //Lazily remove any /.. we append to the path.
     Console::instance->SetCurrentWorkingDirectory(wideNewCWD);
     Console::instance->PrintLine(Stringf("Changed directories to %s", std::string(wideNewCWD.begin(), wideNewCWD.end()).c_str()), RGBA::KHAKI);
+}
+
+//-----------------------------------------------------------------------------------
+static volatile int g_consoleBenchSink = 0;
+static void ConsoleBenchNoOp(Command& args)
+{
+    //Reads its arguments the way a real command would, so the benchmark pays for parsing them
+    g_consoleBenchSink += args.GetIntArgument(0) + (int)args.GetFloatArgument(1) + (int)args.GetArgument(2).length + args.GetNumArgs();
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(consolebench)
+{
+    if (!(args.HasArgs(0) || args.HasArgs(1) || args.HasArgs(2)))
+    {
+        Console::instance->PrintLine("consolebench [numDispatches] [numCompletionNames]", RGBA::RED);
+        return;
+    }
+    int numDispatches = args.HasArgs(0) ? 100000 : Max<int>(args.GetIntArgument(0), 1);
+    int numNames = args.HasArgs(2) ? Max<int>(args.GetIntArgument(1), 1) : 10000;
+
+    //Dispatch, the same path a remote command takes, to a command that only exists while we're measuring
+    Console::RegisterCommand("consolebenchnoop", ConsoleBenchNoOp, "Does nothing, consolebench dispatches to it");
+    int numCommands = (int)g_consoleCommands->GetNumCommands();
+    const char* commandLine = "consolebenchnoop 42 2.5 \"a quoted argument\" tail";
+    double startSeconds = GetCurrentTimeSeconds();
+    for (int i = 0; i < numDispatches; ++i)
+    {
+        Console::instance->RunCommand(commandLine);
+    }
+    double dispatchSeconds = GetCurrentTimeSeconds() - startSeconds;
+    Console::UnregisterCommand("consolebenchnoop");
+    Console::instance->PrintLine(Stringf("Dispatch: %.0f commands/s (%.1fns each), %i commands registered", numDispatches / Max<double>(dispatchSeconds, 1e-9), (dispatchSeconds * 1e9) / numDispatches, numCommands), RGBA::CORNFLOWER_BLUE);
+
+    //Completion over a trie of made up names, as many as asked for
+    static const char* const SYLLABLES[] = { "net", "ren", "phys", "aud", "ui", "mem", "log", "cam", "ai", "dbg", "gfx", "snd", "anim", "path", "job", "res" };
+    const int NUM_SYLLABLES = sizeof(SYLLABLES) / sizeof(SYLLABLES[0]);
+    std::vector<std::string> names;
+    names.reserve(numNames);
+    for (int i = 0; i < numNames; ++i)
+    {
+        names.push_back(Stringf("%s%s%s%i", SYLLABLES[i % NUM_SYLLABLES], SYLLABLES[(i / NUM_SYLLABLES) % NUM_SYLLABLES], SYLLABLES[(i / (NUM_SYLLABLES * NUM_SYLLABLES)) % NUM_SYLLABLES], i));
+    }
+    ConsoleCompletionTrie trie;
+    startSeconds = GetCurrentTimeSeconds();
+    for (const std::string& name : names)
+    {
+        trie.Insert(name.c_str());
+    }
+    double buildSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+    ConsoleCompletionTrie::NameList matches;
+    size_t totalMatches = 0;
+    startSeconds = GetCurrentTimeSeconds();
+    for (int i = 0; i < numNames; ++i)
+    {
+        //Prefixes as long as someone would type before hitting tab, listing as many as the console would
+        const std::string& name = names[i];
+        size_t prefixLength = Min<size_t>(name.size(), 3 + (i % 4));
+        matches.clear();
+        trie.GetCompletions(name.c_str(), prefixLength, matches, 21);
+        totalMatches += matches.size();
+        trie.GetCompletedLength(name.c_str(), prefixLength);
+    }
+    double completionSeconds = GetCurrentTimeSeconds() - startSeconds;
+    Console::instance->PrintLine(Stringf("Completion over %i names (%i nodes, built in %.2fms): %.0f queries/s, %.1f matches per query", numNames, (int)trie.GetNumNodes(), buildSeconds * 1000.0, numNames / Max<double>(completionSeconds, 1e-9), (float)totalMatches / numNames), RGBA::CORNFLOWER_BLUE);
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(consolescrollbench)
+{
+    if (!(args.HasArgs(0) || args.HasArgs(1)))
+    {
+        Console::instance->PrintLine("consolescrollbench [numLines]", RGBA::RED);
+        return;
+    }
+    int numLines = args.HasArgs(1) ? Max<int>(args.GetIntArgument(0), 1) : 1000000;
+
+    //Its own scrollback, sized like the console's, so the real history survives the run
+    ConsoleScrollback scrollback(Console::MAX_SCROLLBACK_LINES, Console::SCROLLBACK_ARENA_BYTES);
+    ConsoleColorRun runs[2];
+    runs[0].start = 0;
+    runs[0].color = RGBA::GBLIGHTGREEN;
+    runs[1].color = RGBA::GBWHITE;
+    char line[128];
+    double startSeconds = GetCurrentTimeSeconds();
+    for (int i = 0; i < numLines; ++i)
+    {
+        int length = sprintf_s(line, "[net] conn %i rtt %.1fms seq %i ack %i", i % 16, (i % 100) * 0.5f, i, i - 3);
+        runs[1].start = 5;
+        scrollback.AddLine(line, (uint32_t)length, runs, 2);
+    }
+    double printSeconds = GetCurrentTimeSeconds() - startSeconds;
+    Console::instance->PrintLine(Stringf("Printed %i lines: %.1fns per line, %u kept in %.2fMB (fixed)", numLines, (printSeconds * 1e9) / numLines, scrollback.GetNumLines(), scrollback.GetFootprintBytes() / (1024.0 * 1024.0)), RGBA::CORNFLOWER_BLUE);
+
+    //A frame's worth of scrollback geometry, scrolled to the bottom and to the oldest line
+    const int NUM_FRAMES = 100;
+    MeshBuilder builder;
+    startSeconds = GetCurrentTimeSeconds();
+    for (int frame = 0; frame < NUM_FRAMES; ++frame)
+    {
+        builder.ClearVertsAndIndices();
+        ConsoleLineHandle bottomLine = (frame % 2 == 0) ? scrollback.GetNewestLine() : scrollback.GetOldestLine() + 30;
+        Console::instance->BuildScrollbackGeometry(scrollback, bottomLine, Vector2::ONE * 10.0f, builder);
+    }
+    double frameSeconds = (GetCurrentTimeSeconds() - startSeconds) / NUM_FRAMES;
+    Console::instance->PrintLine(Stringf("Per frame: %.3fms building %i vertices", frameSeconds * 1000.0, (int)builder.m_vertices.size()), RGBA::CORNFLOWER_BLUE);
+
+    //Search from the bottom for something only the oldest line contains, the worst case
+    std::string needle = Stringf("seq %i ack", numLines - (int)scrollback.GetNumLines());
+    startSeconds = GetCurrentTimeSeconds();
+    ConsoleLineHandle match = scrollback.FindPrevious(needle.c_str(), (uint32_t)needle.size(), ConsoleScrollback::INVALID_LINE);
+    double searchSeconds = GetCurrentTimeSeconds() - startSeconds;
+    Console::instance->PrintLine(Stringf("Search for \"%s\" across %u lines: %.3fms, %s", needle.c_str(), scrollback.GetNumLines(), searchSeconds * 1000.0, match != ConsoleScrollback::INVALID_LINE ? "found" : "not found"), RGBA::CORNFLOWER_BLUE);
 }
\ No newline at end of file
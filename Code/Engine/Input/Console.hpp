@@ -6,6 +6,8 @@
 #include "Engine\Core\Memory\UntrackedAllocator.hpp"
 #include "Engine\Core\Memory\MemoryTracking.hpp"
 #include "Engine\Core\Events\Event.hpp"
+#include "Engine\Input\ConsoleCommandRegistry.hpp"
+#include "Engine\Input\ConsoleScrollback.hpp"
 
 //-----------------------------------------------------------------------------------------------
 #define UNUSED(x) (void)(x);
@@ -13,20 +15,12 @@
 class Command;
 class BitmapFont;
 class Texture;
-typedef void(*ConsoleCommandFunctionPointer)(Command&); 
+class MeshBuilder;
+class Vector2;
 
 //Used for quitting the application, bound to our Main_Win32.cpp; remove this if we aren't using it anymore.
 extern bool g_isQuitting;
-extern std::map<size_t, ConsoleCommandFunctionPointer, std::less<size_t>, UntrackedAllocator<std::pair<size_t, ConsoleCommandFunctionPointer>>>* g_consoleCommands;
-extern std::map<const char*, const char*, std::less<const char*>, UntrackedAllocator<std::pair<const char*, const char*>>>* g_helpStringLookup;
-
-//----------------------------------------------------------------------------------------------
-struct ColoredText
-{
-    ColoredText(std::string line, RGBA tint) : text(line), color(tint) {};
-    std::string text;
-    RGBA color;
-};
+extern ConsoleCommandRegistry* g_consoleCommands;
 
 //----------------------------------------------------------------------------------------------
 class Console
@@ -44,13 +38,21 @@ public:
     void ActivateConsole();
     void DeactivateConsole(); 
     void ClearConsoleHistory();
-    void PrintLine(std::string consoleLine, RGBA color = RGBA::WHITE);
-    ColoredText* PrintDynamicLine(std::string consoleLine, RGBA color = RGBA::WHITE);
-    bool RunCommand(const std::string& commandLine, bool addToHistory = false);
+    void PrintLine(const std::string& consoleLine, RGBA color = RGBA::WHITE);
+    void PrintLine(const std::string& consoleLine, const ConsoleColorRun* colorRuns, uint32_t numColorRuns);
+    ConsoleLineHandle PrintDynamicLine(const std::string& consoleLine, RGBA color = RGBA::WHITE);
+    bool UpdateDynamicLine(ConsoleLineHandle line, const std::string& consoleLine);
+    bool FindInScrollback(const std::string& searchText);
+    void BuildScrollbackGeometry(const ConsoleScrollback& scrollback, ConsoleLineHandle bottomLine, const Vector2& baseline, MeshBuilder& builder) const;
+    bool RunCommand(const char* commandLine, size_t commandLineLength, bool addToHistory = false);
+    inline bool RunCommand(const char* commandLine, bool addToHistory = false) { return RunCommand(commandLine, strlen(commandLine), addToHistory); };
+    inline bool RunCommand(const std::string& commandLine, bool addToHistory = false) { return RunCommand(commandLine.c_str(), commandLine.size(), addToHistory); };
     bool RunCommand(const std::wstring& commandLine, bool addToHistory = false);
+    void CompleteCurrentLine();
     inline bool IsActive() { return m_isActive; };
     inline bool IsEmpty() { return (m_cursorPointer == m_currentLine && *m_cursorPointer == '\0'); };
-    static void RegisterCommand(const char* commandName, ConsoleCommandFunctionPointer consoleFunction);
+    static void RegisterCommand(const char* commandName, ConsoleCommandFunctionPointer consoleFunction, const char* helpText = "Write help text for this command! <3");
+    static void UnregisterCommand(const char* commandName);
     inline void BlinkCursor()
     {
         m_timeSinceCursorBlink = 0;
@@ -59,24 +61,32 @@ public:
     inline std::wstring GetCurrentWorkingDirectory() { return m_currentWorkingDirectory; };
     inline void SetCurrentWorkingDirectory(const std::wstring& newDirectory) { m_currentWorkingDirectory = newDirectory; };
 
+    //CONSTANTS//////////////////////////////////////////////////////////////////////////
+    static const uint32_t MAX_SCROLLBACK_LINES = 65536;
+    static const uint32_t SCROLLBACK_ARENA_BYTES = 8 * 1024 * 1024;
+    static const uint32_t DYNAMIC_LINE_LENGTH = 256; //Room reserved for lines that get rewritten in place
+
     //VARIABLES//////////////////////////////////////////////////////////////////////////
     static Console* instance;
     BitmapFont* m_font = nullptr;
     Texture* m_backgroundTexture = nullptr;
     Event<> m_consoleUpdate;
     Event<> m_consoleClear;
+    Event<const char*> m_onPrintLine; //Every line printed, e.g. to echo a remote command's output back
 
 private:
     //CONSTANTS//////////////////////////////////////////////////////////////////////////
     static const int MAX_LINE_LENGTH = 1024;
     static const int MAX_CONSOLE_LINES = 30;
+    static const int MAX_COMPLETIONS_LISTED = 20;
     static const char CURSOR_CHARACTER;
     static const float CHARACTER_HEIGHT;
     static const float CHARACTER_WIDTH;
     static const float CURSOR_BLINK_RATE_SECONDS;
 
     //MEMBER VARIABLES//////////////////////////////////////////////////////////////////////////
-    std::vector<ColoredText*> m_consoleHistory;
+    ConsoleScrollback m_scrollback;
+    ConsoleLineHandle m_scrollLine; //Bottom line on screen
     std::vector<std::wstring> m_commandHistory;
     std::wstring m_currentWorkingDirectory;
     char* m_currentLine;
@@ -87,33 +97,52 @@ private:
     float m_timeSinceRepeatHeld = 0.0f;
     double m_timeLastActivatedMS = 0.0;
     int m_commandHistoryIndex = 0;
-    int m_consoleHistoryIndex = 0;
     bool m_isActive;
     bool m_isCursorShowing;
     bool m_renderCursor = false;
 };
 
+//----------------------------------------------------------------------------------------------
+//One token of a command line, pointing back into the line. Nothing is copied until a string is asked for.
+struct CommandArgument
+{
+    CommandArgument() : text(nullptr), length(0) {};
+    CommandArgument(const char* start, size_t size) : text(start), length(size) {};
+    inline std::string ToString() const { return std::string(text, length); };
+    inline std::wstring ToWideString() const { return std::wstring(text, text + length); };
+    bool ParseInt(int& outValue) const;
+    bool ParseFloat(float& outValue) const;
+
+    const char* text;
+    size_t length;
+};
+
 //----------------------------------------------------------------------------------------------
 class Command
 {
 public:
-    Command(std::string fullCommandStr); //Split name and args into two buffers
-    Command(std::wstring fullCommandStr); //Split name and args into two buffers
-    inline std::string GetCommandName() const { return std::string(m_commandName.begin(), m_commandName.end()); };
-    inline std::wstring GetWideCommandName() const { return m_commandName; };
-    inline bool HasArgs(int argNumber) const { return m_argsList.size() == (unsigned int)argNumber; };
-    inline std::string GetStringArgument(int argNumber) const { std::wstring argument = m_argsList[argNumber]; return std::string(argument.begin(), argument.end()); };
-    inline std::wstring GetWStringArgument(int argNumber) const { return m_argsList[argNumber]; };
-    inline int GetIntArgument(int argNumber) const { return std::stoi(m_argsList[argNumber]); };
-    float GetFloatArgument(int argNumber) const { return std::stof(m_argsList[argNumber]); };
-    inline std::string GetAllArguments() const { return std::string(m_fullArgsString.begin(), m_fullArgsString.end()); };
-    inline std::wstring GetAllArgumentsWide() const { return m_fullArgsString; };
+    Command(const char* commandLine, size_t commandLineLength); //Tokenizes in place, the line has to outlive the command
+    std::string GetCommandName() const;
+    inline std::wstring GetWideCommandName() const { std::string name = GetCommandName(); return std::wstring(name.begin(), name.end()); };
+    inline const CommandArgument& GetCommandNameToken() const { return m_commandName; };
+    inline bool HasArgs(int argNumber) const { return m_numArgs == argNumber; };
+    inline int GetNumArgs() const { return m_numArgs; };
+    inline const CommandArgument& GetArgument(int argNumber) const { return m_args[argNumber]; };
+    inline std::string GetStringArgument(int argNumber) const { return m_args[argNumber].ToString(); };
+    inline std::wstring GetWStringArgument(int argNumber) const { return m_args[argNumber].ToWideString(); };
+    int GetIntArgument(int argNumber) const;
+    float GetFloatArgument(int argNumber) const;
+    inline std::string GetAllArguments() const { return m_allArguments.ToString(); };
+    inline std::wstring GetAllArgumentsWide() const { return m_allArguments.ToWideString(); };
+
+    //CONSTANTS//////////////////////////////////////////////////////////////////////////
+    static const int MAX_ARGUMENTS = 32;
 
 private:
-    const std::wstring m_fullCommandStr;
-    std::wstring m_commandName;
-    std::wstring m_fullArgsString;
-    std::vector<std::wstring> m_argsList;
+    CommandArgument m_commandName;
+    CommandArgument m_allArguments; //Everything after the name, in case we forward this command
+    CommandArgument m_args[MAX_ARGUMENTS];
+    int m_numArgs;
 };
 
 //----------------------------------------------------------------------------------------------
@@ -124,11 +153,7 @@ public:
     {
         if (!g_consoleCommands)
         {
-            g_consoleCommands = UntrackedNew<std::map<size_t, ConsoleCommandFunctionPointer, std::less<size_t>, UntrackedAllocator<std::pair<size_t, ConsoleCommandFunctionPointer>>>>();
-        }
-        if (!g_helpStringLookup)
-        {
-            g_helpStringLookup = UntrackedNew<std::map<const char*, const char*, std::less<const char*>, UntrackedAllocator<std::pair<const char*, const char*>>>>();
+            g_consoleCommands = UntrackedNew<ConsoleCommandRegistry>();
         }
         Console::RegisterCommand(name, command);
     }
@@ -0,0 +1,321 @@
+#include "Engine/Input/ConsoleCommandRegistry.hpp"
+#include <string.h>
+#include <stdlib.h>
+
+//-----------------------------------------------------------------------------------
+static inline char ToLowerAscii(char character)
+{
+    return (character >= 'A' && character <= 'Z') ? (char)(character + ('a' - 'A')) : character;
+}
+
+//-----------------------------------------------------------------------------------
+ConsoleCompletionTrie::ConsoleCompletionTrie()
+{
+    Node root;
+    root.character = '\0';
+    root.firstChild = INVALID_NODE;
+    root.nextSibling = INVALID_NODE;
+    root.name = nullptr;
+    m_nodes.push_back(root);
+}
+
+//-----------------------------------------------------------------------------------
+void ConsoleCompletionTrie::Insert(const char* name)
+{
+    int32_t nodeIndex = 0;
+    for (const char* current = name; *current != '\0'; ++current)
+    {
+        char character = ToLowerAscii(*current);
+        int32_t previousIndex = INVALID_NODE;
+        int32_t childIndex = m_nodes[nodeIndex].firstChild;
+        while (childIndex != INVALID_NODE && m_nodes[childIndex].character < character)
+        {
+            previousIndex = childIndex;
+            childIndex = m_nodes[childIndex].nextSibling;
+        }
+
+        if (childIndex == INVALID_NODE || m_nodes[childIndex].character != character)
+        {
+            Node newNode;
+            newNode.character = character;
+            newNode.firstChild = INVALID_NODE;
+            newNode.nextSibling = childIndex;
+            newNode.name = nullptr;
+            int32_t newIndex = (int32_t)m_nodes.size();
+            m_nodes.push_back(newNode);
+            if (previousIndex == INVALID_NODE)
+            {
+                m_nodes[nodeIndex].firstChild = newIndex;
+            }
+            else
+            {
+                m_nodes[previousIndex].nextSibling = newIndex;
+            }
+            childIndex = newIndex;
+        }
+        nodeIndex = childIndex;
+    }
+    m_nodes[nodeIndex].name = name;
+}
+
+//-----------------------------------------------------------------------------------
+void ConsoleCompletionTrie::Remove(const char* name)
+{
+    //Remember the path down so branches left with no names can be unlinked on the way back up
+    std::vector<int32_t, UntrackedAllocator<int32_t>> path;
+    path.push_back(0);
+    for (const char* current = name; *current != '\0'; ++current)
+    {
+        char character = ToLowerAscii(*current);
+        int32_t childIndex = m_nodes[path.back()].firstChild;
+        while (childIndex != INVALID_NODE && m_nodes[childIndex].character < character)
+        {
+            childIndex = m_nodes[childIndex].nextSibling;
+        }
+        if (childIndex == INVALID_NODE || m_nodes[childIndex].character != character)
+        {
+            return;
+        }
+        path.push_back(childIndex);
+    }
+    m_nodes[path.back()].name = nullptr;
+
+    for (size_t depth = path.size() - 1; depth > 0; --depth)
+    {
+        int32_t nodeIndex = path[depth];
+        if (m_nodes[nodeIndex].name != nullptr || m_nodes[nodeIndex].firstChild != INVALID_NODE)
+        {
+            break;
+        }
+        Node& parent = m_nodes[path[depth - 1]];
+        if (parent.firstChild == nodeIndex)
+        {
+            parent.firstChild = m_nodes[nodeIndex].nextSibling;
+        }
+        else
+        {
+            int32_t siblingIndex = parent.firstChild;
+            while (m_nodes[siblingIndex].nextSibling != nodeIndex)
+            {
+                siblingIndex = m_nodes[siblingIndex].nextSibling;
+            }
+            m_nodes[siblingIndex].nextSibling = m_nodes[nodeIndex].nextSibling;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+int32_t ConsoleCompletionTrie::FindNode(const char* prefix, size_t prefixLength) const
+{
+    int32_t nodeIndex = 0;
+    for (size_t i = 0; i < prefixLength; ++i)
+    {
+        char character = ToLowerAscii(prefix[i]);
+        int32_t childIndex = m_nodes[nodeIndex].firstChild;
+        while (childIndex != INVALID_NODE && m_nodes[childIndex].character < character)
+        {
+            childIndex = m_nodes[childIndex].nextSibling;
+        }
+        if (childIndex == INVALID_NODE || m_nodes[childIndex].character != character)
+        {
+            return INVALID_NODE;
+        }
+        nodeIndex = childIndex;
+    }
+    return nodeIndex;
+}
+
+//-----------------------------------------------------------------------------------
+void ConsoleCompletionTrie::CollectNames(int32_t nodeIndex, NameList& outNames, size_t maxNames) const
+{
+    const Node& node = m_nodes[nodeIndex];
+    if (node.name)
+    {
+        outNames.push_back(node.name);
+    }
+    for (int32_t childIndex = node.firstChild; childIndex != INVALID_NODE && outNames.size() < maxNames; childIndex = m_nodes[childIndex].nextSibling)
+    {
+        CollectNames(childIndex, outNames, maxNames);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void ConsoleCompletionTrie::GetCompletions(const char* prefix, size_t prefixLength, NameList& outNames, size_t maxNames) const
+{
+    int32_t nodeIndex = FindNode(prefix, prefixLength);
+    if (nodeIndex != INVALID_NODE && maxNames > 0)
+    {
+        CollectNames(nodeIndex, outNames, maxNames);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+size_t ConsoleCompletionTrie::GetCompletedLength(const char* prefix, size_t prefixLength) const
+{
+    int32_t nodeIndex = FindNode(prefix, prefixLength);
+    if (nodeIndex == INVALID_NODE)
+    {
+        return prefixLength;
+    }
+    size_t completedLength = prefixLength;
+    while (m_nodes[nodeIndex].name == nullptr)
+    {
+        int32_t onlyChild = m_nodes[nodeIndex].firstChild;
+        if (onlyChild == INVALID_NODE || m_nodes[onlyChild].nextSibling != INVALID_NODE)
+        {
+            break;
+        }
+        nodeIndex = onlyChild;
+        ++completedLength;
+    }
+    return completedLength;
+}
+
+//-----------------------------------------------------------------------------------
+ConsoleCommandRegistry::ConsoleCommandRegistry()
+    : m_numEntries(0)
+{
+}
+
+//-----------------------------------------------------------------------------------
+ConsoleCommandRegistry::~ConsoleCommandRegistry()
+{
+    for (Entry& entry : m_entries)
+    {
+        free((void*)entry.name);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+uint32_t ConsoleCommandRegistry::HashName(const char* name, size_t nameLength)
+{
+    //FNV-1a, lowercased as it goes so the caller never has to copy the name
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < nameLength; ++i)
+    {
+        hash = (hash ^ (unsigned char)ToLowerAscii(name[i])) * 16777619u;
+    }
+    return hash;
+}
+
+//-----------------------------------------------------------------------------------
+void ConsoleCommandRegistry::Register(const char* name, ConsoleCommandFunctionPointer function, const char* helpText)
+{
+    size_t nameLength = strlen(name);
+    if (Find(name, nameLength))
+    {
+        return; //First registration wins
+    }
+    if ((m_numEntries + 1) * 2 > m_entries.size())
+    {
+        Grow();
+    }
+
+    char* lowercaseName = (char*)malloc(nameLength + 1);
+    for (size_t i = 0; i <= nameLength; ++i)
+    {
+        lowercaseName[i] = ToLowerAscii(name[i]);
+    }
+
+    Entry entry;
+    entry.name = lowercaseName;
+    entry.hash = HashName(name, nameLength);
+    entry.function = function;
+    entry.helpText = helpText;
+    InsertEntry(entry);
+    ++m_numEntries;
+    m_completions.Insert(lowercaseName);
+}
+
+//-----------------------------------------------------------------------------------
+void ConsoleCommandRegistry::Unregister(const char* name)
+{
+    const Entry* entry = Find(name, strlen(name));
+    if (!entry)
+    {
+        return;
+    }
+    m_completions.Remove(entry->name);
+    free((void*)entry->name);
+    --m_numEntries;
+
+    //Shift the rest of the probe run back so nothing after the hole goes missing
+    size_t mask = m_entries.size() - 1;
+    size_t emptySlot = entry - m_entries.data();
+    for (size_t slot = (emptySlot + 1) & mask; m_entries[slot].name != nullptr; slot = (slot + 1) & mask)
+    {
+        size_t homeSlot = m_entries[slot].hash & mask;
+        bool isHomeInRun = (emptySlot <= slot) ? (emptySlot < homeSlot && homeSlot <= slot) : (emptySlot < homeSlot || homeSlot <= slot);
+        if (!isHomeInRun)
+        {
+            m_entries[emptySlot] = m_entries[slot];
+            emptySlot = slot;
+        }
+    }
+    m_entries[emptySlot].name = nullptr;
+    m_entries[emptySlot].hash = 0;
+    m_entries[emptySlot].function = nullptr;
+    m_entries[emptySlot].helpText = nullptr;
+}
+
+//-----------------------------------------------------------------------------------
+const ConsoleCommandRegistry::Entry* ConsoleCommandRegistry::Find(const char* name, size_t nameLength) const
+{
+    if (m_entries.empty())
+    {
+        return nullptr;
+    }
+    uint32_t hash = HashName(name, nameLength);
+    size_t mask = m_entries.size() - 1;
+    for (size_t slot = hash & mask; m_entries[slot].name != nullptr; slot = (slot + 1) & mask)
+    {
+        const Entry& entry = m_entries[slot];
+        if (entry.hash != hash || entry.name[nameLength] != '\0')
+        {
+            continue;
+        }
+        size_t i = 0;
+        while (i < nameLength && entry.name[i] == ToLowerAscii(name[i]))
+        {
+            ++i;
+        }
+        if (i == nameLength)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+//-----------------------------------------------------------------------------------
+void ConsoleCommandRegistry::Grow()
+{
+    Entry emptyEntry;
+    emptyEntry.name = nullptr;
+    emptyEntry.hash = 0;
+    emptyEntry.function = nullptr;
+    emptyEntry.helpText = nullptr;
+
+    std::vector<Entry, UntrackedAllocator<Entry>> oldEntries;
+    oldEntries.swap(m_entries);
+    m_entries.assign(oldEntries.empty() ? MIN_CAPACITY : oldEntries.size() * 2, emptyEntry);
+    for (const Entry& entry : oldEntries)
+    {
+        if (entry.name)
+        {
+            InsertEntry(entry);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void ConsoleCommandRegistry::InsertEntry(const Entry& entry)
+{
+    size_t mask = m_entries.size() - 1;
+    size_t slot = entry.hash & mask;
+    while (m_entries[slot].name != nullptr)
+    {
+        slot = (slot + 1) & mask;
+    }
+    m_entries[slot] = entry;
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+#include <vector>
+#include <stdint.h>
+#include "Engine/Core/Memory/UntrackedAllocator.hpp"
+
+class Command;
+typedef void(*ConsoleCommandFunctionPointer)(Command&);
+
+//-----------------------------------------------------------------------------------
+// Every name the console knows, as a character trie flattened into one array so tab completion
+// only walks as far as the typed prefix. Names are stored lowercase and come back out alphabetically.
+class ConsoleCompletionTrie
+{
+public:
+    //TYPEDEFS//////////////////////////////////////////////////////////////////////////
+    typedef std::vector<const char*, UntrackedAllocator<const char*>> NameList;
+
+    //CONSTRUCTORS//////////////////////////////////////////////////////////////////////////
+    ConsoleCompletionTrie();
+
+    //FUNCTIONS//////////////////////////////////////////////////////////////////////////
+    void Insert(const char* name); //Holds onto the pointer, the name has to outlive the trie
+    void Remove(const char* name); //Unlinked nodes stay in the array, they're only a few bytes each
+    void GetCompletions(const char* prefix, size_t prefixLength, NameList& outNames, size_t maxNames) const;
+    size_t GetCompletedLength(const char* prefix, size_t prefixLength) const; //How far the prefix extends before the names branch
+    inline size_t GetNumNodes() const { return m_nodes.size(); };
+
+    //CONSTANTS//////////////////////////////////////////////////////////////////////////
+    static const int32_t INVALID_NODE = -1;
+
+private:
+    //STRUCTS//////////////////////////////////////////////////////////////////////////
+    struct Node
+    {
+        char character;
+        int32_t firstChild;
+        int32_t nextSibling; //Siblings are sorted by character
+        const char* name; //Set if a name ends here
+    };
+
+    //PRIVATE FUNCTIONS//////////////////////////////////////////////////////////////////////////
+    int32_t FindNode(const char* prefix, size_t prefixLength) const;
+    void CollectNames(int32_t nodeIndex, NameList& outNames, size_t maxNames) const;
+
+    //MEMBER VARIABLES//////////////////////////////////////////////////////////////////////////
+    std::vector<Node, UntrackedAllocator<Node>> m_nodes;
+};
+
+//-----------------------------------------------------------------------------------
+// Console commands in an open addressed table, keyed by a case-insensitive hash of the name.
+// Lookups hash straight off the command line, so dispatching never builds a string.
+class ConsoleCommandRegistry
+{
+public:
+    //STRUCTS//////////////////////////////////////////////////////////////////////////
+    struct Entry
+    {
+        const char* name; //Lowercase, nullptr for an empty slot
+        uint32_t hash;
+        ConsoleCommandFunctionPointer function;
+        const char* helpText;
+    };
+
+    //CONSTRUCTORS//////////////////////////////////////////////////////////////////////////
+    ConsoleCommandRegistry();
+    ~ConsoleCommandRegistry();
+
+    //FUNCTIONS//////////////////////////////////////////////////////////////////////////
+    void Register(const char* name, ConsoleCommandFunctionPointer function, const char* helpText);
+    void Unregister(const char* name);
+    const Entry* Find(const char* name, size_t nameLength) const;
+    inline size_t GetNumCommands() const { return m_numEntries; };
+    inline const ConsoleCompletionTrie& GetCompletionTrie() const { return m_completions; };
+    static uint32_t HashName(const char* name, size_t nameLength);
+
+    //CONSTANTS//////////////////////////////////////////////////////////////////////////
+    static const size_t MIN_CAPACITY = 256;
+
+private:
+    //PRIVATE FUNCTIONS//////////////////////////////////////////////////////////////////////////
+    void Grow();
+    void InsertEntry(const Entry& entry);
+
+    //MEMBER VARIABLES//////////////////////////////////////////////////////////////////////////
+    std::vector<Entry, UntrackedAllocator<Entry>> m_entries; //Power of two, kept under half full
+    size_t m_numEntries;
+    ConsoleCompletionTrie m_completions;
+};
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include "Engine/Input/ConsoleScrollback.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <string.h>
+#include <stdlib.h>
+
+//-----------------------------------------------------------------------------------
+static inline char ToLowerAscii(char character)
+{
+    return (character >= 'A' && character <= 'Z') ? (char)(character + ('a' - 'A')) : character;
+}
+
+//-----------------------------------------------------------------------------------
+ConsoleScrollback::ConsoleScrollback(uint32_t maxLines, uint32_t arenaBytes)
+    : m_arena((byte*)malloc(arenaBytes))
+    , m_arenaSize(arenaBytes)
+    , m_arenaWritePosition(0)
+    , m_lines(maxLines)
+    , m_oldestLine(0)
+    , m_nextLine(0)
+{
+    ASSERT_OR_DIE(maxLines > 0 && arenaBytes >= MAX_LINE_LENGTH * 2, "Console scrollback is too small to hold a line");
+}
+
+//-----------------------------------------------------------------------------------
+ConsoleScrollback::~ConsoleScrollback()
+{
+    free(m_arena);
+}
+
+//-----------------------------------------------------------------------------------
+uint64_t ConsoleScrollback::CalculateBigramMask(const char* text, uint32_t length)
+{
+    uint64_t mask = 0;
+    for (uint32_t i = 1; i < length; ++i)
+    {
+        uint32_t bigram = ((uint32_t)(unsigned char)ToLowerAscii(text[i - 1]) * 31) + (unsigned char)ToLowerAscii(text[i]);
+        mask |= 1ULL << (bigram & 63);
+    }
+    return mask;
+}
+
+//-----------------------------------------------------------------------------------
+ConsoleLineHandle ConsoleScrollback::AddLine(const char* text, uint32_t length, const RGBA& color, uint32_t reserveLength)
+{
+    ConsoleColorRun run;
+    run.start = 0;
+    run.color = color;
+    return AddLine(text, length, &run, 1, reserveLength);
+}
+
+//-----------------------------------------------------------------------------------
+ConsoleLineHandle ConsoleScrollback::AddLine(const char* text, uint32_t length, const ConsoleColorRun* runs, uint32_t numRuns, uint32_t reserveLength)
+{
+    ASSERT_OR_DIE(numRuns > 0, "Console lines need at least one color");
+    length = Min<uint32_t>(length, (uint32_t)MAX_LINE_LENGTH);
+    numRuns = Min<uint32_t>(numRuns, (uint32_t)MAX_RUNS_PER_LINE);
+    uint32_t capacity = Min<uint32_t>(Max<uint32_t>(length, reserveLength), (uint32_t)MAX_LINE_LENGTH);
+    uint32_t blockSize = ((numRuns * sizeof(ConsoleColorRun)) + capacity + 7) & ~7U;
+
+    //Blocks never wrap, if this one won't fit before the end of the arena the end gets skipped
+    uint64_t position = m_arenaWritePosition;
+    uint32_t offset = (uint32_t)(position % m_arenaSize);
+    if (offset + blockSize > m_arenaSize)
+    {
+        position += m_arenaSize - offset;
+    }
+
+    //Make room, first in the line table and then in the arena
+    if (GetNumLines() == m_lines.size())
+    {
+        ++m_oldestLine;
+    }
+    while (GetNumLines() > 0 && (position + blockSize) - GetRecord(m_oldestLine).arenaPosition > m_arenaSize)
+    {
+        ++m_oldestLine;
+    }
+
+    ConsoleLineHandle handle = m_nextLine++;
+    Line& line = GetRecord(handle);
+    line.arenaPosition = position;
+    line.blockSize = blockSize;
+    line.length = length;
+    line.capacity = capacity;
+    line.numRuns = (uint16_t)numRuns;
+    line.runCapacity = (uint16_t)numRuns;
+    line.bigramMask = CalculateBigramMask(text, length);
+
+    ConsoleColorRun* blockRuns = (ConsoleColorRun*)GetBlock(line);
+    uint32_t previousStart = 0;
+    for (uint32_t i = 0; i < numRuns; ++i)
+    {
+        //Starts have to climb, and the first always covers the start of the line
+        blockRuns[i].start = (i == 0) ? 0 : Clamp<uint32_t>(runs[i].start, previousStart, length);
+        blockRuns[i].color = runs[i].color;
+        previousStart = blockRuns[i].start;
+    }
+    memcpy((byte*)(blockRuns + numRuns), text, length);
+    m_arenaWritePosition = position + blockSize;
+    return handle;
+}
+
+//-----------------------------------------------------------------------------------
+bool ConsoleScrollback::SetLineText(ConsoleLineHandle handle, const char* text, uint32_t length)
+{
+    if (!IsValid(handle))
+    {
+        return false;
+    }
+    Line& line = GetRecord(handle);
+    ConsoleColorRun* runs = (ConsoleColorRun*)GetBlock(line);
+    line.length = Min<uint32_t>(length, line.capacity);
+    line.numRuns = 1;
+    line.bigramMask = CalculateBigramMask(text, line.length);
+    memcpy((byte*)(runs + line.runCapacity), text, line.length);
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+bool ConsoleScrollback::GetLine(ConsoleLineHandle handle, ConsoleLineView& outLine) const
+{
+    if (!IsValid(handle))
+    {
+        return false;
+    }
+    const Line& line = GetRecord(handle);
+    const ConsoleColorRun* runs = (const ConsoleColorRun*)GetBlock(line);
+    outLine.runs = runs;
+    outLine.numRuns = line.numRuns;
+    outLine.text = (const char*)(runs + line.runCapacity);
+    outLine.length = line.length;
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+ConsoleLineHandle ConsoleScrollback::FindPrevious(const char* needle, uint32_t needleLength, ConsoleLineHandle before) const
+{
+    if (needleLength == 0 || GetNumLines() == 0)
+    {
+        return INVALID_LINE;
+    }
+    uint64_t needleMask = CalculateBigramMask(needle, needleLength);
+    ConsoleLineHandle handle = Min<ConsoleLineHandle>(before, m_nextLine);
+    while (handle > m_oldestLine)
+    {
+        --handle;
+        const Line& line = GetRecord(handle);
+        //Every pair in the needle has to show up somewhere in the line, which rules most of them out without looking at the text
+        if ((line.bigramMask & needleMask) != needleMask || line.length < needleLength)
+        {
+            continue;
+        }
+        const char* text = (const char*)((const ConsoleColorRun*)GetBlock(line) + line.runCapacity);
+        for (uint32_t start = 0; start + needleLength <= line.length; ++start)
+        {
+            uint32_t i = 0;
+            while (i < needleLength && ToLowerAscii(text[start + i]) == ToLowerAscii(needle[i]))
+            {
+                ++i;
+            }
+            if (i == needleLength)
+            {
+                return handle;
+            }
+        }
+    }
+    return INVALID_LINE;
+}
+
+//-----------------------------------------------------------------------------------
+void ConsoleScrollback::Clear()
+{
+    //Handles keep counting up, so nothing from before the clear can resolve to a new line
+    m_oldestLine = m_nextLine;
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include "Engine/Renderer/RGBA.hpp"
+
+typedef unsigned char byte;
+typedef uint64_t ConsoleLineHandle;
+
+//-----------------------------------------------------------------------------------
+struct ConsoleColorRun
+{
+    uint32_t start; //First character drawn in this color, runs go until the next one starts
+    RGBA color;
+};
+
+//-----------------------------------------------------------------------------------
+// A line as it sits in the arena. Only good until the next line gets added.
+struct ConsoleLineView
+{
+    const char* text;
+    uint32_t length;
+    const ConsoleColorRun* runs; //Always at least one, starting at 0
+    uint32_t numRuns;
+};
+
+//-----------------------------------------------------------------------------------
+// The console's scrollback. A fixed number of lines, with their text and colors packed into one
+// fixed-size arena, and the oldest lines falling off the back when either fills up. Handles count
+// up forever, so holding onto one is always safe: once its line is evicted it just stops resolving.
+class ConsoleScrollback
+{
+public:
+    //CONSTRUCTORS//////////////////////////////////////////////////////////////////////////
+    ConsoleScrollback(uint32_t maxLines, uint32_t arenaBytes);
+    ~ConsoleScrollback();
+
+    //FUNCTIONS//////////////////////////////////////////////////////////////////////////
+    ConsoleLineHandle AddLine(const char* text, uint32_t length, const RGBA& color, uint32_t reserveLength = 0);
+    ConsoleLineHandle AddLine(const char* text, uint32_t length, const ConsoleColorRun* runs, uint32_t numRuns, uint32_t reserveLength = 0);
+    bool SetLineText(ConsoleLineHandle handle, const char* text, uint32_t length); //Keeps the first color, truncates to the room the line was made with
+    bool GetLine(ConsoleLineHandle handle, ConsoleLineView& outLine) const;
+    ConsoleLineHandle FindPrevious(const char* needle, uint32_t needleLength, ConsoleLineHandle before) const; //Case-insensitive, newest first
+    void Clear();
+    inline bool IsValid(ConsoleLineHandle handle) const { return handle >= m_oldestLine && handle < m_nextLine; };
+    inline ConsoleLineHandle GetOldestLine() const { return m_oldestLine; };
+    inline ConsoleLineHandle GetNewestLine() const { return (m_nextLine == m_oldestLine) ? INVALID_LINE : m_nextLine - 1; };
+    inline uint32_t GetNumLines() const { return (uint32_t)(m_nextLine - m_oldestLine); };
+    inline size_t GetFootprintBytes() const { return m_arenaSize + (m_lines.size() * sizeof(Line)); };
+
+    //CONSTANTS//////////////////////////////////////////////////////////////////////////
+    static const ConsoleLineHandle INVALID_LINE = ~0ULL;
+    static const uint32_t MAX_RUNS_PER_LINE = 64;
+    static const uint32_t MAX_LINE_LENGTH = 4096;
+
+private:
+    //STRUCTS//////////////////////////////////////////////////////////////////////////
+    struct Line
+    {
+        uint64_t arenaPosition;
+        uint64_t bigramMask; //Search index, one bit per hashed pair of neighboring characters
+        uint32_t blockSize;
+        uint32_t length;
+        uint32_t capacity;
+        uint16_t numRuns;
+        uint16_t runCapacity;
+    };
+
+    //PRIVATE FUNCTIONS//////////////////////////////////////////////////////////////////////////
+    static uint64_t CalculateBigramMask(const char* text, uint32_t length);
+    inline Line& GetRecord(ConsoleLineHandle handle) { return m_lines[(size_t)(handle % m_lines.size())]; };
+    inline const Line& GetRecord(ConsoleLineHandle handle) const { return m_lines[(size_t)(handle % m_lines.size())]; };
+    inline byte* GetBlock(const Line& line) const { return m_arena + (line.arenaPosition % m_arenaSize); };
+
+    //MEMBER VARIABLES//////////////////////////////////////////////////////////////////////////
+    byte* m_arena;
+    uint32_t m_arenaSize;
+    uint64_t m_arenaWritePosition; //Only ever grows, wrapped into the arena on use
+    std::vector<Line> m_lines; //Ring, a handle's record lives at handle % size
+    ConsoleLineHandle m_oldestLine;
+    ConsoleLineHandle m_nextLine;
+};
\ No newline at end of file
@@ -1,12 +1,16 @@
 #include "Engine/Input/Logging.hpp"
 #include "Engine/Core/BuildConfig.hpp"
 #include "Engine/Core/Memory/Callstack.hpp"
+#include "Engine/Core/Memory/MemoryTracking.hpp"
 #include "Engine/Input/InputOutputUtils.hpp"
 #include "Engine/Input/Console.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Time/Time.hpp"
 #include <chrono>
 #include <ctime>
 #include <algorithm>
 #include <iomanip>
+#include <intrin.h>
 
 extern bool g_isQuitting;
 //Define an APP_NAME globally somewhere so that we know what to name the file for the logger.
@@ -14,43 +18,628 @@ extern bool g_isQuitting;
 extern const char* APP_NAME;
 Logger* Logger::instance = nullptr;
 const int LOGF_STACK_LOCAL_TEMP_LENGTH = 2048;
+const size_t MAX_LOG_ARGUMENT_BYTES = 2048;
+const size_t MAX_LOG_STRING_ARGUMENT_LENGTH = 1024;
 
 //-----------------------------------------------------------------------------------
-void LoggerThreadMain()
+// Which Logger a thread's ring buffer belongs to. Flags the buffer for the writer to clean up when the thread exits.
+struct LogThreadBufferHandle
+{
+    LogThreadBufferHandle() : owner(nullptr), buffer(nullptr) {};
+    ~LogThreadBufferHandle()
+    {
+        if (buffer && owner == Logger::instance)
+        {
+            buffer->m_isAbandoned = true;
+        }
+    };
+
+    Logger* owner;
+    LogRingBuffer* buffer;
+};
+
+static thread_local LogThreadBufferHandle t_logBuffer;
+
+//-----------------------------------------------------------------------------------
+// One printf conversion, pointing back into the format string. The producer and the writer
+// both walk the format with this, so they always agree on what was packed.
+struct LogFormatSpec
+{
+    enum Length
+    {
+        LENGTH_NONE,
+        LENGTH_CHAR, //hh
+        LENGTH_SHORT, //h
+        LENGTH_LONG, //l
+        LENGTH_LONG_LONG, //ll, j, I64
+        LENGTH_SIZE, //z, t, I
+        LENGTH_LONG_DOUBLE, //L
+        LENGTH_WIDE, //w
+        NUM_LENGTHS
+    };
+
+    const char* flagsStart;
+    size_t flagsLength;
+    const char* widthStart;
+    size_t widthLength;
+    const char* precisionStart;
+    size_t precisionLength;
+    bool isWidthFromArgument;
+    bool hasPrecision;
+    bool isPrecisionFromArgument;
+    Length length;
+    char conversion;
+};
+
+//-----------------------------------------------------------------------------------
+enum LogArgumentTag : byte
+{
+    ARG_SIGNED,
+    ARG_UNSIGNED,
+    ARG_DOUBLE,
+    ARG_POINTER,
+    ARG_STRING, //uint16 length, then the characters without a terminator
+    ARG_NULL_STRING,
+    NUM_ARG_TAGS
+};
+
+//-----------------------------------------------------------------------------------
+// Cursor just past the '%'. Returns just past the conversion, or nullptr for anything we don't know how to pack.
+static const char* ParseFormatSpec(const char* cursor, LogFormatSpec& outSpec)
+{
+    outSpec.flagsStart = cursor;
+    while (*cursor != '\0' && strchr("-+ #0", *cursor) != nullptr)
+    {
+        ++cursor;
+    }
+    outSpec.flagsLength = cursor - outSpec.flagsStart;
+
+    outSpec.widthStart = cursor;
+    outSpec.isWidthFromArgument = (*cursor == '*');
+    if (outSpec.isWidthFromArgument)
+    {
+        ++cursor;
+    }
+    else
+    {
+        while (*cursor >= '0' && *cursor <= '9')
+        {
+            ++cursor;
+        }
+    }
+    outSpec.widthLength = cursor - outSpec.widthStart;
+
+    outSpec.hasPrecision = (*cursor == '.');
+    outSpec.isPrecisionFromArgument = false;
+    outSpec.precisionStart = cursor;
+    outSpec.precisionLength = 0;
+    if (outSpec.hasPrecision)
+    {
+        ++cursor;
+        outSpec.precisionStart = cursor;
+        outSpec.isPrecisionFromArgument = (*cursor == '*');
+        if (outSpec.isPrecisionFromArgument)
+        {
+            ++cursor;
+        }
+        else
+        {
+            while (*cursor >= '0' && *cursor <= '9')
+            {
+                ++cursor;
+            }
+        }
+        outSpec.precisionLength = cursor - outSpec.precisionStart;
+    }
+
+    outSpec.length = LogFormatSpec::LENGTH_NONE;
+    switch (*cursor)
+    {
+    case 'h':
+        ++cursor;
+        outSpec.length = (*cursor == 'h') ? LogFormatSpec::LENGTH_CHAR : LogFormatSpec::LENGTH_SHORT;
+        cursor += (*cursor == 'h') ? 1 : 0;
+        break;
+    case 'l':
+        ++cursor;
+        outSpec.length = (*cursor == 'l') ? LogFormatSpec::LENGTH_LONG_LONG : LogFormatSpec::LENGTH_LONG;
+        cursor += (*cursor == 'l') ? 1 : 0;
+        break;
+    case 'j':
+        ++cursor;
+        outSpec.length = LogFormatSpec::LENGTH_LONG_LONG;
+        break;
+    case 'z':
+    case 't':
+        ++cursor;
+        outSpec.length = LogFormatSpec::LENGTH_SIZE;
+        break;
+    case 'L':
+        ++cursor;
+        outSpec.length = LogFormatSpec::LENGTH_LONG_DOUBLE;
+        break;
+    case 'w':
+        ++cursor;
+        outSpec.length = LogFormatSpec::LENGTH_WIDE;
+        break;
+    case 'I':
+        ++cursor;
+        if (cursor[0] == '6' && cursor[1] == '4')
+        {
+            cursor += 2;
+            outSpec.length = LogFormatSpec::LENGTH_LONG_LONG;
+        }
+        else if (cursor[0] == '3' && cursor[1] == '2')
+        {
+            cursor += 2;
+        }
+        else
+        {
+            outSpec.length = LogFormatSpec::LENGTH_SIZE;
+        }
+        break;
+    default:
+        break;
+    }
+
+    outSpec.conversion = *cursor;
+    if (*cursor == '\0' || strchr("diouxXcCeEfFgGaApsSn", *cursor) == nullptr)
+    {
+        return nullptr;
+    }
+    return cursor + 1;
+}
+
+//-----------------------------------------------------------------------------------
+class LogArgumentWriter
+{
+public:
+    LogArgumentWriter(byte* buffer, size_t capacity) : m_start(buffer), m_cursor(buffer), m_end(buffer + capacity), m_isFull(false) {};
+
+    //-----------------------------------------------------------------------------------
+    template<typename T>
+    void Put(LogArgumentTag tag, const T& value)
+    {
+        if (m_cursor + sizeof(tag) + sizeof(T) > m_end)
+        {
+            m_isFull = true;
+            return;
+        }
+        *m_cursor++ = tag;
+        memcpy(m_cursor, &value, sizeof(T));
+        m_cursor += sizeof(T);
+    }
+
+    //-----------------------------------------------------------------------------------
+    void PutString(const char* str)
+    {
+        if (str == nullptr)
+        {
+            Put<byte>(ARG_NULL_STRING, 0);
+            return;
+        }
+        uint16_t length = (uint16_t)strnlen(str, MAX_LOG_STRING_ARGUMENT_LENGTH);
+        Put<uint16_t>(ARG_STRING, length);
+        if (m_isFull || m_cursor + length > m_end)
+        {
+            m_isFull = true;
+            return;
+        }
+        memcpy(m_cursor, str, length);
+        m_cursor += length;
+    }
+
+    //-----------------------------------------------------------------------------------
+    void PutWideString(const wchar_t* str)
+    {
+        if (str == nullptr)
+        {
+            Put<byte>(ARG_NULL_STRING, 0);
+            return;
+        }
+        //Narrowed a character at a time, same as the console does with its wide strings
+        uint16_t length = (uint16_t)wcsnlen(str, MAX_LOG_STRING_ARGUMENT_LENGTH);
+        Put<uint16_t>(ARG_STRING, length);
+        if (m_isFull || m_cursor + length > m_end)
+        {
+            m_isFull = true;
+            return;
+        }
+        for (uint16_t i = 0; i < length; ++i)
+        {
+            *m_cursor++ = (byte)str[i];
+        }
+    }
+
+    inline size_t GetSize() const { return m_cursor - m_start; };
+    inline bool IsFull() const { return m_isFull; };
+
+private:
+    byte* m_start;
+    byte* m_cursor;
+    byte* m_end;
+    bool m_isFull;
+};
+
+//-----------------------------------------------------------------------------------
+// Pulls every argument the format will consume off the va_list into outArguments. False if the format
+// has something we don't handle or the arguments don't fit, in which case the caller formats it eagerly.
+static bool PackLogArguments(const char* format, va_list args, byte* outArguments, size_t capacity, size_t& outSize)
 {
-    while (!g_isQuitting)
+    LogArgumentWriter writer(outArguments, capacity);
+    const char* cursor = strchr(format, '%');
+    while (cursor != nullptr)
     {
-        SwitchToThread();
-        LogMessage* message = nullptr;
+        ++cursor;
+        if (*cursor == '%')
+        {
+            cursor = strchr(cursor + 1, '%');
+            continue;
+        }
 
-        if (Logger::instance->HasMessages())
+        LogFormatSpec spec;
+        const char* next = ParseFormatSpec(cursor, spec);
+        if (next == nullptr)
+        {
+            return false;
+        }
+        if (spec.isWidthFromArgument)
+        {
+            writer.Put<int64_t>(ARG_SIGNED, va_arg(args, int));
+        }
+        if (spec.isPrecisionFromArgument)
         {
-            message = Logger::instance->DequeueMessage();
+            writer.Put<int64_t>(ARG_SIGNED, va_arg(args, int));
         }
 
-        if (message)
+        switch (spec.conversion)
+        {
+        case 'd':
+        case 'i':
+        {
+            int64_t value;
+            switch (spec.length)
+            {
+            case LogFormatSpec::LENGTH_CHAR: value = (signed char)va_arg(args, int); break;
+            case LogFormatSpec::LENGTH_SHORT: value = (short)va_arg(args, int); break;
+            case LogFormatSpec::LENGTH_LONG: value = va_arg(args, long); break;
+            case LogFormatSpec::LENGTH_LONG_LONG: value = va_arg(args, long long); break;
+            case LogFormatSpec::LENGTH_SIZE: value = (int64_t)va_arg(args, ptrdiff_t); break;
+            default: value = va_arg(args, int); break;
+            }
+            writer.Put<int64_t>(ARG_SIGNED, value);
+            break;
+        }
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+        {
+            uint64_t value;
+            switch (spec.length)
+            {
+            case LogFormatSpec::LENGTH_CHAR: value = (unsigned char)va_arg(args, unsigned int); break;
+            case LogFormatSpec::LENGTH_SHORT: value = (unsigned short)va_arg(args, unsigned int); break;
+            case LogFormatSpec::LENGTH_LONG: value = va_arg(args, unsigned long); break;
+            case LogFormatSpec::LENGTH_LONG_LONG: value = va_arg(args, unsigned long long); break;
+            case LogFormatSpec::LENGTH_SIZE: value = (uint64_t)va_arg(args, size_t); break;
+            default: value = va_arg(args, unsigned int); break;
+            }
+            writer.Put<uint64_t>(ARG_UNSIGNED, value);
+            break;
+        }
+        case 'c':
+        case 'C':
+            writer.Put<int64_t>(ARG_SIGNED, va_arg(args, int));
+            break;
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
         {
-            Logger::instance->Log(message);
-            if (message->callstack)
+            double value = (spec.length == LogFormatSpec::LENGTH_LONG_DOUBLE) ? (double)va_arg(args, long double) : va_arg(args, double);
+            writer.Put<double>(ARG_DOUBLE, value);
+            break;
+        }
+        case 'p':
+            writer.Put<uint64_t>(ARG_POINTER, (uint64_t)(uintptr_t)va_arg(args, void*));
+            break;
+        case 's':
+            if (spec.length == LogFormatSpec::LENGTH_LONG || spec.length == LogFormatSpec::LENGTH_WIDE)
+            {
+                writer.PutWideString(va_arg(args, const wchar_t*));
+            }
+            else
             {
-                Callstack* callstack = message->callstack;
-                CallstackLine* callstackLines = CallstackGetLines(callstack);
-                Logger::instance->Log(">>>Callstack:\n//-----------------------------------------------------------------------------------\n");
-                for (unsigned int i = 0; i < callstack->frameCount; ++i)
+                writer.PutString(va_arg(args, const char*));
+            }
+            break;
+        case 'S':
+            writer.PutWideString(va_arg(args, const wchar_t*));
+            break;
+        case 'n':
+            va_arg(args, void*); //Never written through, the writer thread just skips it
+            break;
+        default:
+            return false;
+        }
+
+        if (writer.IsFull())
+        {
+            return false;
+        }
+        cursor = strchr(next, '%');
+    }
+    outSize = writer.GetSize();
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+// The writer thread's half of PackLogArguments. Rebuilds each conversion without its length
+// modifier (everything was widened when it was packed) and prints it with the unpacked value.
+static void FormatLogRecord(const char* format, const byte* arguments, size_t argumentBytes, char* outText, size_t outTextSize)
+{
+    const byte* argumentsEnd = arguments + argumentBytes;
+    char* out = outText;
+    char* outEnd = outText + outTextSize - 1;
+    const char* cursor = format;
+    while (*cursor != '\0' && out < outEnd)
+    {
+        if (*cursor != '%')
+        {
+            *out++ = *cursor++;
+            continue;
+        }
+        ++cursor;
+        if (*cursor == '%')
+        {
+            *out++ = '%';
+            ++cursor;
+            continue;
+        }
+
+        LogFormatSpec spec;
+        const char* next = ParseFormatSpec(cursor, spec);
+        if (next == nullptr)
+        {
+            break; //Can't happen for anything that was packed
+        }
+        cursor = next;
+        if (spec.conversion == 'n')
+        {
+            continue;
+        }
+
+        //Rebuild the conversion: flags, width, precision, then a length that matches how the value was stored
+        char conversion[64];
+        char* specOut = conversion;
+        *specOut++ = '%';
+        memcpy(specOut, spec.flagsStart, spec.flagsLength);
+        specOut += spec.flagsLength;
+        if (spec.isWidthFromArgument)
+        {
+            int64_t width = 0;
+            if (arguments + 1 + sizeof(width) <= argumentsEnd)
+            {
+                memcpy(&width, arguments + 1, sizeof(width));
+                arguments += 1 + sizeof(width);
+            }
+            specOut += sprintf_s(specOut, 16, "%i", (int)width);
+        }
+        else
+        {
+            size_t widthLength = Min<size_t>(spec.widthLength, 16);
+            memcpy(specOut, spec.widthStart, widthLength);
+            specOut += widthLength;
+        }
+        if (spec.hasPrecision)
+        {
+            *specOut++ = '.';
+            if (spec.isPrecisionFromArgument)
+            {
+                int64_t precision = 0;
+                if (arguments + 1 + sizeof(precision) <= argumentsEnd)
                 {
-                    Logger::instance->Log(Stringf("%s(%i): %s\n", callstackLines[i].filename, callstackLines[i].line, callstackLines[i].functionName).c_str());
+                    memcpy(&precision, arguments + 1, sizeof(precision));
+                    arguments += 1 + sizeof(precision);
                 }
-                Logger::instance->Log("//-----------------------------------------------------------------------------------\n\n");
+                specOut += sprintf_s(specOut, 16, "%i", (int)precision);
             }
-            delete message;
+            else
+            {
+                size_t precisionLength = Min<size_t>(spec.precisionLength, 16);
+                memcpy(specOut, spec.precisionStart, precisionLength);
+                specOut += precisionLength;
+            }
+        }
+
+        if (arguments >= argumentsEnd)
+        {
+            break;
+        }
+        LogArgumentTag tag = (LogArgumentTag)*arguments++;
+        size_t remaining = outEnd - out + 1;
+        int written = 0;
+        switch (tag)
+        {
+        case ARG_SIGNED:
+        {
+            int64_t value;
+            memcpy(&value, arguments, sizeof(value));
+            arguments += sizeof(value);
+            bool isCharacter = (spec.conversion == 'c' || spec.conversion == 'C');
+            if (!isCharacter)
+            {
+                *specOut++ = 'l';
+                *specOut++ = 'l';
+            }
+            *specOut++ = isCharacter ? 'c' : spec.conversion;
+            *specOut = '\0';
+            written = isCharacter ? snprintf(out, remaining, conversion, (int)value) : snprintf(out, remaining, conversion, (long long)value);
+            break;
+        }
+        case ARG_UNSIGNED:
+        {
+            uint64_t value;
+            memcpy(&value, arguments, sizeof(value));
+            arguments += sizeof(value);
+            *specOut++ = 'l';
+            *specOut++ = 'l';
+            *specOut++ = spec.conversion;
+            *specOut = '\0';
+            written = snprintf(out, remaining, conversion, (unsigned long long)value);
+            break;
+        }
+        case ARG_DOUBLE:
+        {
+            double value;
+            memcpy(&value, arguments, sizeof(value));
+            arguments += sizeof(value);
+            *specOut++ = spec.conversion;
+            *specOut = '\0';
+            written = snprintf(out, remaining, conversion, value);
+            break;
+        }
+        case ARG_POINTER:
+        {
+            uint64_t value;
+            memcpy(&value, arguments, sizeof(value));
+            arguments += sizeof(value);
+            *specOut++ = 'p';
+            *specOut = '\0';
+            written = snprintf(out, remaining, conversion, (void*)(uintptr_t)value);
+            break;
+        }
+        case ARG_STRING:
+        {
+            uint16_t length;
+            memcpy(&length, arguments, sizeof(length));
+            arguments += sizeof(length);
+            char text[MAX_LOG_STRING_ARGUMENT_LENGTH + 1];
+            memcpy(text, arguments, length);
+            text[length] = '\0';
+            arguments += length;
+            *specOut++ = 's';
+            *specOut = '\0';
+            written = snprintf(out, remaining, conversion, text);
+            break;
+        }
+        case ARG_NULL_STRING:
+        {
+            arguments += sizeof(byte);
+            *specOut++ = 's';
+            *specOut = '\0';
+            written = snprintf(out, remaining, conversion, "(null)");
+            break;
+        }
+        default:
+            break;
+        }
+        if (written > 0)
+        {
+            out += Min<size_t>((size_t)written, remaining - 1);
         }
     }
+    *out = '\0';
+}
+
+//-----------------------------------------------------------------------------------
+void LoggerThreadMain()
+{
+    Logger::instance->WriterThreadMain();
+}
+
+//-----------------------------------------------------------------------------------
+LogRingBuffer::LogRingBuffer(size_t capacity)
+    : m_droppedRecords(0)
+    , m_isAbandoned(false)
+    , m_data((byte*)malloc(capacity))
+    , m_capacity(capacity)
+    , m_writeIndex(0)
+    , m_readIndex(0)
+{
+    ASSERT_OR_DIE((capacity & (capacity - 1)) == 0, "Log ring buffers need a power of two capacity");
+}
+
+//-----------------------------------------------------------------------------------
+LogRingBuffer::~LogRingBuffer()
+{
+    free(m_data);
+}
+
+//-----------------------------------------------------------------------------------
+bool LogRingBuffer::Push(LogRecordHeader& header, const void* arguments)
+{
+    const size_t alignmentMask = LogRecordHeader::RECORD_ALIGNMENT - 1;
+    size_t size = (sizeof(LogRecordHeader) + header.argumentBytes + alignmentMask) & ~alignmentMask;
+    size_t writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+    size_t position = writeIndex & (m_capacity - 1);
+    size_t contiguous = m_capacity - position;
+
+    //Records never wrap. If this one won't fit before the end, the end gets skipped.
+    size_t padding = (size > contiguous) ? contiguous : 0;
+    if (writeIndex + padding + size - m_readIndex.load(std::memory_order_acquire) > m_capacity)
+    {
+        m_droppedRecords.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (padding >= sizeof(LogRecordHeader))
+    {
+        LogRecordHeader* paddingRecord = (LogRecordHeader*)(m_data + position);
+        paddingRecord->size = (uint32_t)padding;
+        paddingRecord->type = LogRecordHeader::PADDING;
+    }
+
+    header.size = (uint32_t)size;
+    byte* record = m_data + ((writeIndex + padding) & (m_capacity - 1));
+    memcpy(record, &header, sizeof(LogRecordHeader));
+    memcpy(record + sizeof(LogRecordHeader), arguments, header.argumentBytes);
+
+    //Sequentially consistent so the writer can't read an empty buffer and still miss the wakeup
+    m_writeIndex.store(writeIndex + padding + size);
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+const LogRecordHeader* LogRingBuffer::Peek()
+{
+    size_t readIndex = m_readIndex.load(std::memory_order_relaxed);
+    while (readIndex != m_writeIndex.load(std::memory_order_acquire))
+    {
+        size_t position = readIndex & (m_capacity - 1);
+        size_t contiguous = m_capacity - position;
+        const LogRecordHeader* record = (const LogRecordHeader*)(m_data + position);
+        if (contiguous < sizeof(LogRecordHeader) || record->type == LogRecordHeader::PADDING)
+        {
+            readIndex += (contiguous < sizeof(LogRecordHeader)) ? contiguous : record->size;
+            m_readIndex.store(readIndex, std::memory_order_release);
+            continue;
+        }
+        return record;
+    }
+    return nullptr;
+}
+
+//-----------------------------------------------------------------------------------
+void LogRingBuffer::Pop(const LogRecordHeader* record)
+{
+    m_readIndex.store(m_readIndex.load(std::memory_order_relaxed) + record->size, std::memory_order_release);
 }
 
 //-----------------------------------------------------------------------------------
 Logger::Logger()
     : m_file(nullptr)
+    , m_wakeEvent(CreateEvent(nullptr, FALSE, FALSE, nullptr))
+    , m_isWriterSleeping(false)
+    , m_isRunning(false)
+    , m_totalDroppedRecords(0)
 {
+    InitializeCriticalSection(&m_threadBuffersLock);
+    m_writeBatch.reserve(WRITE_BATCH_SIZE);
     CreateLogFile();
     CleanUpOldLogFiles();
 }
@@ -59,6 +648,8 @@ Logger::Logger()
 Logger::~Logger()
 {
     //Wait for the thread to finish shutting down, then continue.
+    m_isRunning = false;
+    SetEvent(m_wakeEvent);
     if (m_loggingThread.joinable())
     {
         m_loggingThread.join();
@@ -67,6 +658,14 @@ Logger::~Logger()
     Logger::instance->FlushLog();
     fclose(m_file);
     Logger::instance->CopyLogFileAsLatest();
+
+    for (LogRingBuffer* buffer : m_threadBuffers)
+    {
+        UntrackedDelete<LogRingBuffer>(buffer);
+    }
+    m_threadBuffers.clear();
+    DeleteCriticalSection(&m_threadBuffersLock);
+    CloseHandle(m_wakeEvent);
 }
 
 //-----------------------------------------------------------------------------------
@@ -110,79 +709,236 @@ void Logger::CreateLogFile()
 }
 
 //-----------------------------------------------------------------------------------
-void Logger::EnqueueMessage(LogMessage* msg)
+LogRingBuffer* Logger::GetThreadBuffer()
 {
-    m_loggingQueue.Enqueue(msg);
+    if (t_logBuffer.owner != this)
+    {
+        LogRingBuffer* buffer = UntrackedNew<LogRingBuffer>(THREAD_BUFFER_SIZE);
+        EnterCriticalSection(&m_threadBuffersLock);
+        {
+            m_threadBuffers.push_back(buffer);
+        }
+        LeaveCriticalSection(&m_threadBuffersLock);
+        t_logBuffer.owner = this;
+        t_logBuffer.buffer = buffer;
+    }
+    return t_logBuffer.buffer;
 }
 
 //-----------------------------------------------------------------------------------
-LogMessage* Logger::DequeueMessage()
+bool Logger::Write(LogLevel level, Callstack* callstack, const char* format, va_list args)
 {
-    LogMessage* front = m_loggingQueue.Dequeue();
-    return front;
-}
+    byte arguments[MAX_LOG_ARGUMENT_BYTES];
+    size_t argumentBytes = 0;
+    LogRecordHeader header;
+    header.level = (uint8_t)level;
+    header.timestamp = __rdtsc();
+    header.callstack = callstack;
 
-//-----------------------------------------------------------------------------------
-void Logger::FlushLog()
-{
-    LogMessage* message;
-    unsigned int numMessages = m_loggingQueue.Size();
-    for (unsigned int i = 0; i < numMessages; ++i)
+    va_list packedArgs;
+    va_copy(packedArgs, args);
+    bool wasPacked = PackLogArguments(format, packedArgs, arguments, sizeof(arguments), argumentBytes);
+    va_end(packedArgs);
+    if (wasPacked)
+    {
+        header.type = LogRecordHeader::FORMAT;
+        header.format = format;
+    }
+    else
     {
-        message = DequeueMessage();
-        Log(message);
-        delete message;
+        //Something the packer doesn't understand, so this one pays for formatting up front
+        header.type = LogRecordHeader::PREFORMATTED;
+        header.format = nullptr;
+        vsnprintf_s((char*)arguments, sizeof(arguments), _TRUNCATE, format, args);
+        arguments[sizeof(arguments) - 1] = '\0';
+        argumentBytes = strlen((char*)arguments) + 1;
     }
+    header.argumentBytes = (uint16_t)argumentBytes;
 
-    fflush(m_file);
-}
+    if (!GetThreadBuffer()->Push(header, arguments))
+    {
+        if (callstack)
+        {
+            FreeCallstack(callstack);
+        }
+        return false;
+    }
 
+    //Pairs with the writer's store-then-recheck: either it sees this record, or we see it going to sleep.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_isWriterSleeping.load() && m_isWriterSleeping.exchange(false))
+    {
+        SetEvent(m_wakeEvent);
+    }
+    return true;
+}
 
 //-----------------------------------------------------------------------------------
-bool Logger::HasMessages()
+void Logger::WriterThreadMain()
 {
-    return m_loggingQueue.Size() > 0;
+    while (m_isRunning)
+    {
+        if (DrainThreadBuffers())
+        {
+            continue;
+        }
+
+        //Nothing left. Say we're going to sleep, then look once more so a push that raced us isn't missed.
+        //The drain already let go of its copy of the list, so the recheck has to look at the live one.
+        m_isWriterSleeping.store(true);
+        bool hasRecords = false;
+        EnterCriticalSection(&m_threadBuffersLock);
+        {
+            for (LogRingBuffer* buffer : m_threadBuffers)
+            {
+                hasRecords = hasRecords || !buffer->IsEmpty();
+            }
+        }
+        LeaveCriticalSection(&m_threadBuffersLock);
+        if (!hasRecords)
+        {
+            WaitForSingleObject(m_wakeEvent, IDLE_WAIT_MS);
+        }
+        m_isWriterSleeping.store(false);
+    }
 }
 
 //-----------------------------------------------------------------------------------
-void Logger::StartLoggingThread()
+// Writes out everything every thread has pushed so far, oldest first across all of them.
+bool Logger::DrainThreadBuffers()
 {
-    m_loggingThread = std::thread(LoggerThreadMain);
+    EnterCriticalSection(&m_threadBuffersLock);
+    {
+        m_drainBuffers.assign(m_threadBuffers.begin(), m_threadBuffers.end());
+    }
+    LeaveCriticalSection(&m_threadBuffersLock);
+
+    bool didWork = false;
+    while (true)
+    {
+        LogRingBuffer* oldestBuffer = nullptr;
+        const LogRecordHeader* oldestRecord = nullptr;
+        for (LogRingBuffer* buffer : m_drainBuffers)
+        {
+            const LogRecordHeader* record = buffer->Peek();
+            if (record && (!oldestRecord || record->timestamp < oldestRecord->timestamp))
+            {
+                oldestBuffer = buffer;
+                oldestRecord = record;
+            }
+        }
+        if (!oldestRecord)
+        {
+            break;
+        }
+        WriteRecord(oldestRecord);
+        oldestBuffer->Pop(oldestRecord);
+        didWork = true;
+    }
+
+    for (LogRingBuffer* buffer : m_drainBuffers)
+    {
+        uint32_t numDropped = buffer->m_droppedRecords.exchange(0);
+        if (numDropped > 0)
+        {
+            m_totalDroppedRecords += numDropped;
+            Log(Stringf("[%u log messages dropped, a thread's log buffer was full]\n", numDropped).c_str());
+            didWork = true;
+        }
+        if (buffer->m_isAbandoned && buffer->IsEmpty())
+        {
+            EnterCriticalSection(&m_threadBuffersLock);
+            {
+                m_threadBuffers.erase(std::find(m_threadBuffers.begin(), m_threadBuffers.end(), buffer));
+            }
+            LeaveCriticalSection(&m_threadBuffersLock);
+            UntrackedDelete<LogRingBuffer>(buffer);
+        }
+    }
+    m_drainBuffers.clear();
+
+    FlushBatch();
+    return didWork;
 }
 
 //-----------------------------------------------------------------------------------
-void Logger::Log(const char* message)
+void Logger::WriteRecord(const LogRecordHeader* record)
 {
-    fwrite(message, sizeof(unsigned char), strlen(message), m_file);
-    #ifdef FORWARD_LOG_TO_OUTPUT_WINDOW
+    const byte* arguments = (const byte*)(record + 1);
+    if (record->type == LogRecordHeader::PREFORMATTED)
     {
-        DebuggerPrintf(message);
+        Log((const char*)arguments);
     }
-    #endif // FORWARD_LOG_TO_OUTPUT_WINDOW
-    #ifdef FORWARD_LOG_TO_CONSOLE
+    else
     {
-        if (Console::instance != nullptr)
+        char formattedMessage[LOGF_STACK_LOCAL_TEMP_LENGTH];
+        FormatLogRecord(record->format, arguments, record->argumentBytes, formattedMessage, LOGF_STACK_LOCAL_TEMP_LENGTH);
+        Log(formattedMessage);
+    }
+
+    if (record->callstack)
+    {
+        Callstack* callstack = record->callstack;
+        CallstackLine* callstackLines = CallstackGetLines(callstack);
+        Log(">>>Callstack:\n//-----------------------------------------------------------------------------------\n");
+        for (unsigned int i = 0; i < callstack->frameCount; ++i)
         {
-            Console::instance->PrintLine(message, RGBA::CERULEAN);
+            Log(Stringf("%s(%i): %s\n", callstackLines[i].filename, callstackLines[i].line, callstackLines[i].functionName).c_str());
         }
+        Log("//-----------------------------------------------------------------------------------\n\n");
+        FreeCallstack(callstack);
     }
-    #endif // FORWARD_LOG_TO_CONSOLE
 }
 
 //-----------------------------------------------------------------------------------
-void Logger::Log(LogMessage* message)
+void Logger::AppendToBatch(const char* text, size_t length)
+{
+    if (m_writeBatch.size() + length > WRITE_BATCH_SIZE)
+    {
+        FlushBatch();
+    }
+    m_writeBatch.insert(m_writeBatch.end(), text, text + length);
+}
+
+//-----------------------------------------------------------------------------------
+void Logger::FlushBatch()
+{
+    if (!m_writeBatch.empty())
+    {
+        fwrite(m_writeBatch.data(), sizeof(unsigned char), m_writeBatch.size(), m_file);
+        m_writeBatch.clear();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void Logger::FlushLog()
+{
+    DrainThreadBuffers();
+    FlushBatch();
+    fflush(m_file);
+}
+
+//-----------------------------------------------------------------------------------
+void Logger::StartLoggingThread()
+{
+    m_isRunning = true;
+    m_loggingThread = std::thread(LoggerThreadMain);
+}
+
+//-----------------------------------------------------------------------------------
+void Logger::Log(const char* message)
 {
-    fwrite(message->formattedMessage, sizeof(unsigned char), strlen(message->formattedMessage), m_file);
+    AppendToBatch(message, strlen(message));
     #ifdef FORWARD_LOG_TO_OUTPUT_WINDOW
     {
-        DebuggerPrintf(message->formattedMessage);
+        DebuggerPrintf(message);
     }
     #endif // FORWARD_LOG_TO_OUTPUT_WINDOW
     #ifdef FORWARD_LOG_TO_CONSOLE
     {
         if (Console::instance != nullptr)
         {
-            Console::instance->PrintLine(message->formattedMessage, RGBA::CERULEAN);
+            Console::instance->PrintLine(message, RGBA::CERULEAN);
         }
     }
     #endif // FORWARD_LOG_TO_CONSOLE
@@ -195,14 +951,7 @@ static void LogPrintf(LogLevel level, const char* format, va_list args)
     {
         return;
     }
-    LogMessage* msg = new LogMessage();
-    msg->formattedMessage = new char[LOGF_STACK_LOCAL_TEMP_LENGTH];
-    vsnprintf_s(msg->formattedMessage, LOGF_STACK_LOCAL_TEMP_LENGTH, _TRUNCATE, format, args);
-    msg->formattedMessage[LOGF_STACK_LOCAL_TEMP_LENGTH - 1] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
-
-    //Send message off to I/O thread
-    Logger::instance->EnqueueMessage(msg);
-
+    Logger::instance->Write(level, nullptr, format, args);
 }
 
 //-----------------------------------------------------------------------------------
@@ -232,14 +981,10 @@ void LogPrintfWithCallstack(LogLevel level, const char* format, ...)
     }
     va_list variableArgumentList;
     va_start(variableArgumentList, format); 
-    LogMessage* msg = new LogMessage();
-    msg->callstack = AllocateCallstack();
-    msg->formattedMessage = new char[LOGF_STACK_LOCAL_TEMP_LENGTH];
-    vsnprintf_s(msg->formattedMessage, LOGF_STACK_LOCAL_TEMP_LENGTH, _TRUNCATE, format, variableArgumentList);
-    msg->formattedMessage[LOGF_STACK_LOCAL_TEMP_LENGTH - 1] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
-
-    //Send message off to I/O thread
-    Logger::instance->EnqueueMessage(msg);
+    //Symbols get looked up in the background now, so the writer thread usually finds them cached
+    Callstack* callstack = AllocateCallstack();
+    CallstackPrefetchSymbols(callstack);
+    Logger::instance->Write(level, callstack, format, variableArgumentList);
     va_end(variableArgumentList);
 }
 
@@ -272,22 +1017,73 @@ void LoggerShutdown()
 }
 
 //-----------------------------------------------------------------------------------
-LogMessage::LogMessage()
-    : formattedMessage(nullptr)
-    , callstack(nullptr) 
+static bool BenchLogPrintf(const char* format, ...)
 {
-
-};
+    //Straight to the ring buffer, LOG_LEVEL_THRESHOLD would otherwise make this a no-op in most builds
+    va_list variableArgumentList;
+    va_start(variableArgumentList, format);
+    bool wasLogged = Logger::instance->Write(LogLevel::DEFAULT, nullptr, format, variableArgumentList);
+    va_end(variableArgumentList);
+    return wasLogged;
+}
 
 //-----------------------------------------------------------------------------------
-LogMessage::~LogMessage()
+CONSOLE_COMMAND(logbench)
 {
-    if (formattedMessage)
+    if (!(args.HasArgs(0) || args.HasArgs(1) || args.HasArgs(2)))
     {
-        delete[] formattedMessage;
+        Console::instance->PrintLine("logbench [maxThreads] [callsPerThread]", RGBA::RED);
+        return;
     }
-    if (callstack)
+    if (!Logger::instance)
     {
-        FreeCallstack(callstack);
+        Console::instance->PrintLine("The logger isn't running.", RGBA::RED);
+        return;
     }
-};
+    int maxThreads = args.HasArgs(0) ? 16 : Clamp<int>(args.GetIntArgument(0), 1, 64);
+    int callsPerThread = args.HasArgs(2) ? Max<int>(args.GetIntArgument(1), 1) : 10000;
+
+    Console::instance->PrintLine(Stringf("Log producer cost, %i calls per thread:", callsPerThread), RGBA::GBWHITE);
+    int numThreads = 1;
+    while (true)
+    {
+        std::vector<double> threadSeconds(numThreads, 0.0);
+        std::vector<int> threadDrops(numThreads, 0);
+        std::vector<std::thread> threads;
+        for (int threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+        {
+            threads.emplace_back([&, threadIndex]()
+            {
+                double startSeconds = GetCurrentTimeSeconds();
+                for (int call = 0; call < callsPerThread; ++call)
+                {
+                    if (!BenchLogPrintf("logbench thread %i call %i: %s %.3f\n", threadIndex, call, "value", call * 0.5))
+                    {
+                        ++threadDrops[threadIndex];
+                    }
+                }
+                threadSeconds[threadIndex] = GetCurrentTimeSeconds() - startSeconds;
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        double totalSeconds = 0.0;
+        int totalDrops = 0;
+        for (int threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+        {
+            totalSeconds += threadSeconds[threadIndex];
+            totalDrops += threadDrops[threadIndex];
+        }
+        double nanosecondsPerCall = (totalSeconds * 1e9) / ((double)numThreads * callsPerThread);
+        Console::instance->PrintLine(Stringf("  %2i threads: %.1fns per call, %i dropped", numThreads, nanosecondsPerCall, totalDrops), RGBA::CORNFLOWER_BLUE);
+
+        if (numThreads == maxThreads)
+        {
+            break;
+        }
+        numThreads = Min<int>(numThreads * 2, maxThreads);
+    }
+}
\ No newline at end of file
@@ -2,11 +2,12 @@
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 #include <thread>
-#include <deque>
+#include <atomic>
+#include <vector>
+#include <stdarg.h>
 #include "Engine/Core/Memory/UntrackedAllocator.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
-#include "Engine/DataStructures/ThreadSafeQueue.hpp"
 
 struct Callstack;
 
@@ -23,12 +24,54 @@ enum class LogLevel
 };
 
 //-----------------------------------------------------------------------------------
-struct LogMessage
+// A log call as it sits in a ring buffer: the format string pointer and its arguments packed
+// as binary, so only the writer thread ever pays for formatting.
+struct LogRecordHeader
 {
-    LogMessage();
-    ~LogMessage();
-    char* formattedMessage;
+    enum Type : uint8_t
+    {
+        FORMAT, //format points at a string literal, the arguments follow the header
+        PREFORMATTED, //A format we couldn't pack, already formatted text follows the header
+        PADDING, //Skip to the end of the ring
+        NUM_TYPES
+    };
+
+    uint32_t size; //Header and arguments, rounded up to RECORD_ALIGNMENT
+    uint16_t argumentBytes;
+    Type type;
+    uint8_t level;
+    uint64_t timestamp; //Orders records across threads when the writer merges them
+    const char* format;
     Callstack* callstack;
+
+    static const size_t RECORD_ALIGNMENT = 8;
+};
+
+//-----------------------------------------------------------------------------------
+// One per thread that logs. Single producer (its thread) and single consumer (the writer thread),
+// so pushing is a couple of atomics and a memcpy. When it's full the new record is dropped and counted.
+class LogRingBuffer
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    LogRingBuffer(size_t capacity); //Must be a power of two
+    ~LogRingBuffer();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    bool Push(LogRecordHeader& header, const void* arguments); //Producer only
+    const LogRecordHeader* Peek(); //Consumer only
+    void Pop(const LogRecordHeader* record); //Consumer only
+    inline bool IsEmpty() const { return m_readIndex.load() == m_writeIndex.load(); };
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::atomic<uint32_t> m_droppedRecords;
+    std::atomic<bool> m_isAbandoned; //Its thread has exited, the writer deletes it once it's drained
+
+private:
+    byte* m_data;
+    size_t m_capacity;
+    std::atomic<size_t> m_writeIndex; //Both indices only ever grow, masked into the buffer on use
+    std::atomic<size_t> m_readIndex;
 };
 
 //-----------------------------------------------------------------------------------
@@ -40,16 +83,20 @@ public:
     ~Logger();
 
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
-    void EnqueueMessage(LogMessage* msg);
-    LogMessage* DequeueMessage();
+    bool Write(LogLevel level, Callstack* callstack, const char* format, va_list args); //Producer side, no level filtering. False if dropped.
     void FlushLog();
-    bool HasMessages();
     void StartLoggingThread();
-    void Log(LogMessage* message);
+    void WriterThreadMain();
     void Log(const char* message);
     void CreateLogFile();
     void CleanUpOldLogFiles();
     void CopyLogFileAsLatest();
+    uint32_t GetDroppedRecordCount() const { return m_totalDroppedRecords.load(); };
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const size_t THREAD_BUFFER_SIZE = 256 * 1024;
+    static const size_t WRITE_BATCH_SIZE = 64 * 1024;
+    static const DWORD IDLE_WAIT_MS = 100; //Only a backstop, producers wake the writer as soon as they push
 
     //STATIC VARIABLES/////////////////////////////////////////////////////////////////////
     static Logger* instance;
@@ -60,10 +107,26 @@ public:
     std::string m_fileName;
 
 private:
-    ThreadSafeQueue<LogMessage> m_loggingQueue;
+    //PRIVATE FUNCTIONS/////////////////////////////////////////////////////////////////////
+    LogRingBuffer* GetThreadBuffer();
+    bool DrainThreadBuffers();
+    void WriteRecord(const LogRecordHeader* record);
+    void AppendToBatch(const char* text, size_t length);
+    void FlushBatch();
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<LogRingBuffer*, UntrackedAllocator<LogRingBuffer*>> m_threadBuffers;
+    std::vector<LogRingBuffer*, UntrackedAllocator<LogRingBuffer*>> m_drainBuffers; //Writer thread's copy of m_threadBuffers
+    CRITICAL_SECTION m_threadBuffersLock; //Only taken when a thread logs for the first time, and by the writer
+    HANDLE m_wakeEvent;
+    std::atomic<bool> m_isWriterSleeping;
+    std::atomic<bool> m_isRunning;
+    std::vector<char, UntrackedAllocator<char>> m_writeBatch;
+    std::atomic<uint32_t> m_totalDroppedRecords;
 };
 
 //GLOBAL FUNCTIONS/////////////////////////////////////////////////////////////////////
+//Formatting happens later on the writer thread, so format has to outlive the call (use a literal, or "%s" for anything built at runtime)
 void LogPrintf(const char* format, ...);
 void LogPrintf(LogLevel level, const char* format, ...);
 void LogPrintfWithCallstack(LogLevel level, const char* format, ...);
@@ -5,6 +5,7 @@
 #ifndef include_MathUtilities
 #define include_MathUtilities
 #include <cmath>
+#include "Engine/Math/RandomStream.hpp"
 
 //-----------------------------------------------------------------------------------------------
 // Constants
@@ -380,34 +381,27 @@ inline float SmoothStop( float inputZeroToOne )
 //-----------------------------------------------------------------------------------------------
 inline int GetRandomIntInRange( int minValueInclusive, int maxValueInclusive )
 {
-	// #TODO: use a faster, better random number generator
-	// #TODO: use more bits for higher-range numbers
-	return minValueInclusive + rand() % ( 1 + maxValueInclusive - minValueInclusive );
+	return RandomStream::GetThreadStream().GetIntInRange( minValueInclusive, maxValueInclusive );
 }
 
 
 //-----------------------------------------------------------------------------------------------
 inline int GetRandomIntLessThan( int maxValueNotInclusive )
 {
-	// #TODO: use a faster, better random number generator
-	// #TODO: use more bits for higher-range numbers
-	return rand() % maxValueNotInclusive;
+	return RandomStream::GetThreadStream().GetIntLessThan( maxValueNotInclusive );
 }
 
 
 //-----------------------------------------------------------------------------------------------
 inline float GetRandomFloatZeroToOne()
 {
-	// #TODO: use a faster, better random number generator
-	const float oneOverRandMax = 1.f / static_cast< float >( RAND_MAX );
-	return static_cast< float >( rand() ) * oneOverRandMax;
+	return RandomStream::GetThreadStream().GetFloatZeroToOne();
 }
 
 
 //-----------------------------------------------------------------------------------------------
 inline float GetRandomFloatInRange( float minimumInclusive, float maximumInclusive )
 {
-	// #TODO: use a faster, better random number generator
 	const float randomZeroToOne = GetRandomFloatZeroToOne();
 	return minimumInclusive + ( randomZeroToOne * (maximumInclusive - minimumInclusive) );
 }
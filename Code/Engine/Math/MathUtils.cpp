@@ -56,9 +56,7 @@ Vector2 MathUtils::MakePolar(const Vector2& xyVector)
 //-----------------------------------------------------------------------------------
 Vector2 MathUtils::GetRandomVectorInCircle(float radius)
 {
-    float t = TWO_PI * GetRandomFloatFromZeroTo(1.0f);
-    float r = sqrt(GetRandomFloatFromZeroTo(1.0f)) * radius;
-    return Vector2(r * cos(t), r * sin(t));
+    return RandomStream::GetThreadStream().GetPointInCircle(radius);
 }
 
 //-----------------------------------------------------------------------------------
@@ -188,44 +186,45 @@ float MathUtils::CalcShortestAngularDisplacement(float fromDegrees, float toDegr
 //Inclusive random
 int MathUtils::GetRandomInt(int minimum, int maximum)
 {
-    if (minimum == 0 && maximum == 0)
-    {
-        return 0;
-    }
-    return static_cast<int>(Clamp(rand() % maximum + minimum, minimum, maximum));
+    return RandomStream::GetThreadStream().GetIntInRange(minimum, maximum);
+}
+
+//-----------------------------------------------------------------------------------
+//Reseeds every thread's stream, so the same seed replays the same sequence on each thread.
+void MathUtils::SeedRandom(unsigned int seed)
+{
+    RandomStream::SeedThreadStreams(seed);
 }
 
 //-----------------------------------------------------------------------------------
 float MathUtils::GetRandom()
 {
-    return static_cast <float> (rand()) / static_cast<float>(RAND_MAX);
+    return RandomStream::GetThreadStream().GetFloatZeroToOne();
 }
 
 //-----------------------------------------------------------------------------------
-//This function is NOT inclusive, as truncation occurs on the int.
-//AVOID USING, THIS CAN SOMETIMES BE INCLUSIVE, WTF?
+//This function is NOT inclusive.
 int MathUtils::GetRandomIntFromZeroTo(int maximum)
 {
-    return rand() % maximum;
+    return RandomStream::GetThreadStream().GetIntLessThan(maximum);
 }
 
 //-----------------------------------------------------------------------------------
 float MathUtils::GetRandomFloatFromZeroTo(float maximum)
 {
-    return static_cast<float>(rand()) / (static_cast<float>(RAND_MAX / maximum));
+    return RandomStream::GetThreadStream().GetFloatZeroToOne() * maximum;
 }
 
 //-----------------------------------------------------------------------------------
 float MathUtils::GetRandomFloat(float minimum, float maximum)
 {
-    return minimum + static_cast<float>(rand()) / (static_cast<float>(RAND_MAX / (maximum - minimum)));
+    return RandomStream::GetThreadStream().GetFloatInRange(minimum, maximum);
 }
 
 //-----------------------------------------------------------------------------------
 float MathUtils::GetRandomFloatInRange(float minimumInclusive, float maximumInclusive)
 {
-    const float randomZeroToOne = GetRandomFloatFromZeroTo(1.0f);
-    return minimumInclusive + (randomZeroToOne * (maximumInclusive - minimumInclusive));
+    return RandomStream::GetThreadStream().GetFloatInRange(minimumInclusive, maximumInclusive);
 }
 
 //-----------------------------------------------------------------------------------
@@ -353,5 +352,7 @@ void InitializeRand()
     //Supressed because localtime_s isn't actually accessible because I don't know why try for yourself. >:I
 #pragma warning(suppress: 4996)
     std::tm time = *std::localtime(&timeNow);
-    srand((unsigned int)time.tm_sec + time.tm_min + time.tm_hour + time.tm_year);
+    unsigned int seed = (unsigned int)time.tm_sec + time.tm_min + time.tm_hour + time.tm_year;
+    srand(seed);
+    MathUtils::SeedRandom(seed);
 }
@@ -1,4 +1,5 @@
 #pragma once
+#include "Engine/Math/RandomStream.hpp"
 
 class Vector2;
 class Vector2Int;
@@ -32,7 +33,9 @@ public:
     static float CalcShortestAngularDisplacement(float fromDegrees, float toDegrees);
 
     //RANDOM//////////////////////////////////////////////////////////////////////////
+    //All of these draw from the calling thread's RandomStream, so they're safe to use from jobs.
     static int GetRandomInt(int minimum, int maximum);
+    static void SeedRandom(unsigned int seed);
     static float GetRandom();
     static float GetRandomFloat(float minimum, float maximum);
     static float GetRandomFloatInRange(float minimumInclusive, float maximumInclusive);
@@ -205,6 +208,12 @@ public:
         return Get(MathUtils::GetRandomFloatFromZeroTo(1.0f));
     }
 
+    //-----------------------------------------------------------------------------------
+    T GetRandom(RandomStream& stream) const
+    {
+        return Get(stream.GetFloatZeroToOne());
+    }
+
     //-----------------------------------------------------------------------------------
     //This is used for assigning a value from a random one in a range. Kind of spooky, but now you know what it's doing!
     operator T()
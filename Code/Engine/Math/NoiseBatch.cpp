@@ -0,0 +1,735 @@
+#include "Engine/Math/NoiseBatch.hpp"
+#include "Engine/Math/Noise.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Time/Time.hpp"
+#include <emmintrin.h>
+#include <atomic>
+#include <vector>
+#include <string.h>
+
+//-----------------------------------------------------------------------------------
+enum NoiseBatchType
+{
+    FRACTAL_2D,
+    FRACTAL_3D,
+    PERLIN_2D,
+    PERLIN_3D
+};
+
+//-----------------------------------------------------------------------------------
+struct NoiseBatchParameters
+{
+    NoiseBatchType type;
+    float* output;
+    int width;
+    int height;
+    Vector3 origin;
+    Vector3 sampleSpacing;
+    float scale;
+    unsigned int numOctaves;
+    float octavePersistence;
+    float octaveScale;
+    bool renormalize;
+    unsigned int seed;
+};
+
+//-----------------------------------------------------------------------------------
+struct NoiseBatchRows
+{
+    const NoiseBatchParameters* parameters;
+    int firstRow;
+    int numRows;
+    std::atomic<int>* numRemainingJobs;
+};
+
+//Same constants Noise.cpp uses, they have to match exactly for the results to.
+static const float OCTAVE_OFFSET = 0.636764989593174f;
+static const int PRIME1 = 198491317;
+static const int PRIME2 = 6542989;
+static const double ONE_OVER_MAX_UINT = (1.0 / (double)0xFFFFFFFF);
+static const int MIN_ROWS_PER_JOB = 16;
+
+//-----------------------------------------------------------------------------------
+//SSE2 has no 32 bit multiply that keeps the low halves, so do the even and odd lanes separately.
+static inline __m128i MultiplyLow32(__m128i a, __m128i b)
+{
+    __m128i evenProducts = _mm_mul_epu32(a, b);
+    __m128i oddProducts = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(evenProducts, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(oddProducts, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+//-----------------------------------------------------------------------------------
+static inline __m128i Get1dNoiseUint4(__m128i positions, unsigned int seed)
+{
+    __m128i mangledBits = MultiplyLow32(positions, _mm_set1_epi32((int)0xB5297A4D));
+    mangledBits = _mm_add_epi32(mangledBits, _mm_set1_epi32((int)seed));
+    mangledBits = _mm_xor_si128(mangledBits, _mm_srli_epi32(mangledBits, 8));
+    mangledBits = _mm_add_epi32(mangledBits, _mm_set1_epi32((int)0x68E31DA4));
+    mangledBits = _mm_xor_si128(mangledBits, _mm_slli_epi32(mangledBits, 8));
+    mangledBits = MultiplyLow32(mangledBits, _mm_set1_epi32((int)0x1B56C4E9));
+    mangledBits = _mm_xor_si128(mangledBits, _mm_srli_epi32(mangledBits, 8));
+    return mangledBits;
+}
+
+//-----------------------------------------------------------------------------------
+static inline __m128i Get2dNoiseUint4(__m128i indexX, __m128i indexY, unsigned int seed)
+{
+    return Get1dNoiseUint4(_mm_add_epi32(indexX, MultiplyLow32(_mm_set1_epi32(PRIME1), indexY)), seed);
+}
+
+//-----------------------------------------------------------------------------------
+static inline __m128i Get3dNoiseUint4(__m128i indexX, __m128i indexY, __m128i indexZ, unsigned int seed)
+{
+    __m128i position = _mm_add_epi32(indexX, MultiplyLow32(_mm_set1_epi32(PRIME1), indexY));
+    position = _mm_add_epi32(position, MultiplyLow32(_mm_set1_epi32(PRIME2), indexZ));
+    return Get1dNoiseUint4(position, seed);
+}
+
+//-----------------------------------------------------------------------------------
+//Get*dNoiseZeroToOne goes through a double, so this does too: two lanes at a time.
+static inline __m128 NoiseUintToZeroToOne4(__m128i noise)
+{
+    const __m128d twoToThe32 = _mm_set1_pd(4294967296.0);
+    const __m128d oneOverMaxUint = _mm_set1_pd(ONE_OVER_MAX_UINT);
+    __m128d low = _mm_cvtepi32_pd(noise);
+    __m128d high = _mm_cvtepi32_pd(_mm_shuffle_epi32(noise, _MM_SHUFFLE(3, 2, 3, 2)));
+    low = _mm_add_pd(low, _mm_and_pd(_mm_cmplt_pd(low, _mm_setzero_pd()), twoToThe32));
+    high = _mm_add_pd(high, _mm_and_pd(_mm_cmplt_pd(high, _mm_setzero_pd()), twoToThe32));
+    return _mm_movelh_ps(_mm_cvtpd_ps(_mm_mul_pd(oneOverMaxUint, low)), _mm_cvtpd_ps(_mm_mul_pd(oneOverMaxUint, high)));
+}
+
+//-----------------------------------------------------------------------------------
+//Truncate, then step down one for negatives that weren't already whole, just like FastFloor.
+static inline __m128 FastFloor4(__m128 values)
+{
+    __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(values));
+    return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, values), _mm_set1_ps(1.f)));
+}
+
+//-----------------------------------------------------------------------------------
+static inline __m128 SmoothStep4(__m128 t)
+{
+    return _mm_mul_ps(_mm_mul_ps(t, t), _mm_sub_ps(_mm_set1_ps(3.f), _mm_mul_ps(_mm_set1_ps(2.f), t)));
+}
+
+//-----------------------------------------------------------------------------------
+static inline __m128 SmoothStep5_4(__m128 t)
+{
+    __m128 inner = _mm_add_ps(_mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.f)), _mm_set1_ps(15.f))), _mm_set1_ps(10.f));
+    return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), inner);
+}
+
+//-----------------------------------------------------------------------------------
+static inline __m128 Lerp4(__m128 weightHigh, __m128 weightLow, __m128 valueHigh, __m128 valueLow)
+{
+    return _mm_add_ps(_mm_mul_ps(weightHigh, valueHigh), _mm_mul_ps(weightLow, valueLow));
+}
+
+//-----------------------------------------------------------------------------------
+static inline __m128 SetSignBits4(__m128 magnitude, __m128i signBits)
+{
+    return _mm_xor_ps(magnitude, _mm_castsi128_ps(signBits));
+}
+
+//-----------------------------------------------------------------------------------
+//The 8 quarter-cardinal gradients from Compute2dPerlinNoise, picked without a table lookup:
+//indices 0, 3, 4 and 7 have the long component on x, 2 through 5 point west, 4 through 7 point south.
+static inline void Get2dGradients4(__m128i noise, __m128& out_gradientX, __m128& out_gradientY)
+{
+    const __m128 longComponent = _mm_set1_ps(0.923879533f);
+    const __m128 shortComponent = _mm_set1_ps(0.382683432f);
+    __m128i index = _mm_and_si128(noise, _mm_set1_epi32(7));
+    __m128 isLongOnX = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(_mm_add_epi32(index, _mm_set1_epi32(1)), _mm_set1_epi32(2)), _mm_setzero_si128()));
+    __m128 magnitudeX = _mm_or_ps(_mm_and_ps(isLongOnX, longComponent), _mm_andnot_ps(isLongOnX, shortComponent));
+    __m128 magnitudeY = _mm_or_ps(_mm_and_ps(isLongOnX, shortComponent), _mm_andnot_ps(isLongOnX, longComponent));
+    __m128i signX = _mm_slli_epi32(_mm_and_si128(_mm_add_epi32(index, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29);
+    __m128i signY = _mm_slli_epi32(_mm_and_si128(index, _mm_set1_epi32(4)), 29);
+    out_gradientX = SetSignBits4(magnitudeX, signX);
+    out_gradientY = SetSignBits4(magnitudeY, signY);
+}
+
+//-----------------------------------------------------------------------------------
+//The 8 cube corner gradients from Compute3dPerlinNoise: bit 0 flips x, bit 1 flips y, bit 2 flips z.
+static inline __m128 Dot3dGradient4(__m128i noise, __m128 displacementX, __m128 displacementY, __m128 displacementZ)
+{
+    const __m128 component = _mm_set1_ps(fSQRT_3_OVER_3);
+    __m128 gradientX = SetSignBits4(component, _mm_slli_epi32(_mm_and_si128(noise, _mm_set1_epi32(1)), 31));
+    __m128 gradientY = SetSignBits4(component, _mm_slli_epi32(_mm_and_si128(noise, _mm_set1_epi32(2)), 30));
+    __m128 gradientZ = SetSignBits4(component, _mm_slli_epi32(_mm_and_si128(noise, _mm_set1_epi32(4)), 29));
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(gradientX, displacementX), _mm_mul_ps(gradientY, displacementY)), _mm_mul_ps(gradientZ, displacementZ));
+}
+
+//-----------------------------------------------------------------------------------
+static inline __m128 Dot2dGradient4(__m128i noise, __m128 displacementX, __m128 displacementY)
+{
+    __m128 gradientX;
+    __m128 gradientY;
+    Get2dGradients4(noise, gradientX, gradientY);
+    return _mm_add_ps(_mm_mul_ps(gradientX, displacementX), _mm_mul_ps(gradientY, displacementY));
+}
+
+//-----------------------------------------------------------------------------------
+static inline __m128 Renormalize4(__m128 totalNoise, float totalAmplitude)
+{
+    totalNoise = _mm_div_ps(totalNoise, _mm_set1_ps(totalAmplitude));
+    totalNoise = _mm_add_ps(_mm_mul_ps(totalNoise, _mm_set1_ps(0.5f)), _mm_set1_ps(0.5f));
+    totalNoise = SmoothStep4(totalNoise);
+    return _mm_sub_ps(_mm_mul_ps(totalNoise, _mm_set1_ps(2.0f)), _mm_set1_ps(1.f));
+}
+
+//-----------------------------------------------------------------------------------
+static __m128 Compute2dFractalNoise4(__m128 posX, __m128 posY, const NoiseBatchParameters& parameters)
+{
+    float totalAmplitude = 0.f;
+    float currentAmplitude = 1.f;
+    unsigned int seed = parameters.seed;
+    __m128 totalNoise = _mm_setzero_ps();
+    __m128 invScale = _mm_set1_ps(1.f / parameters.scale);
+    __m128 currentX = _mm_mul_ps(posX, invScale);
+    __m128 currentY = _mm_mul_ps(posY, invScale);
+
+    for (unsigned int octaveNum = 0; octaveNum < parameters.numOctaves; ++octaveNum)
+    {
+        __m128 cellMinsX = FastFloor4(currentX);
+        __m128 cellMinsY = FastFloor4(currentY);
+        __m128i indexWestX = _mm_cvttps_epi32(cellMinsX);
+        __m128i indexSouthY = _mm_cvttps_epi32(cellMinsY);
+        __m128i indexEastX = _mm_add_epi32(indexWestX, _mm_set1_epi32(1));
+        __m128i indexNorthY = _mm_add_epi32(indexSouthY, _mm_set1_epi32(1));
+        __m128 valueSouthWest = NoiseUintToZeroToOne4(Get2dNoiseUint4(indexWestX, indexSouthY, seed));
+        __m128 valueSouthEast = NoiseUintToZeroToOne4(Get2dNoiseUint4(indexEastX, indexSouthY, seed));
+        __m128 valueNorthWest = NoiseUintToZeroToOne4(Get2dNoiseUint4(indexWestX, indexNorthY, seed));
+        __m128 valueNorthEast = NoiseUintToZeroToOne4(Get2dNoiseUint4(indexEastX, indexNorthY, seed));
+
+        __m128 weightEast = SmoothStep4(_mm_sub_ps(currentX, cellMinsX));
+        __m128 weightNorth = SmoothStep4(_mm_sub_ps(currentY, cellMinsY));
+        __m128 weightWest = _mm_sub_ps(_mm_set1_ps(1.f), weightEast);
+        __m128 weightSouth = _mm_sub_ps(_mm_set1_ps(1.f), weightNorth);
+
+        __m128 blendSouth = Lerp4(weightEast, weightWest, valueSouthEast, valueSouthWest);
+        __m128 blendNorth = Lerp4(weightEast, weightWest, valueNorthEast, valueNorthWest);
+        __m128 blendTotal = Lerp4(weightSouth, weightNorth, blendSouth, blendNorth);
+        __m128 noiseThisOctave = _mm_mul_ps(_mm_set1_ps(2.f), _mm_sub_ps(blendTotal, _mm_set1_ps(0.5f)));
+
+        totalNoise = _mm_add_ps(totalNoise, _mm_mul_ps(noiseThisOctave, _mm_set1_ps(currentAmplitude)));
+        totalAmplitude += currentAmplitude;
+        currentAmplitude *= parameters.octavePersistence;
+        currentX = _mm_add_ps(_mm_mul_ps(currentX, _mm_set1_ps(parameters.octaveScale)), _mm_set1_ps(OCTAVE_OFFSET));
+        currentY = _mm_add_ps(_mm_mul_ps(currentY, _mm_set1_ps(parameters.octaveScale)), _mm_set1_ps(OCTAVE_OFFSET));
+        ++seed;
+    }
+
+    if (parameters.renormalize && totalAmplitude > 0.f)
+    {
+        totalNoise = Renormalize4(totalNoise, totalAmplitude);
+    }
+    return totalNoise;
+}
+
+//-----------------------------------------------------------------------------------
+static __m128 Compute3dFractalNoise4(__m128 posX, __m128 posY, __m128 posZ, const NoiseBatchParameters& parameters)
+{
+    float totalAmplitude = 0.f;
+    float currentAmplitude = 1.f;
+    unsigned int seed = parameters.seed;
+    __m128 totalNoise = _mm_setzero_ps();
+    __m128 invScale = _mm_set1_ps(1.f / parameters.scale);
+    __m128 currentX = _mm_mul_ps(posX, invScale);
+    __m128 currentY = _mm_mul_ps(posY, invScale);
+    __m128 currentZ = _mm_mul_ps(posZ, invScale);
+
+    for (unsigned int octaveNum = 0; octaveNum < parameters.numOctaves; ++octaveNum)
+    {
+        __m128 cellMinsX = FastFloor4(currentX);
+        __m128 cellMinsY = FastFloor4(currentY);
+        __m128 cellMinsZ = FastFloor4(currentZ);
+        __m128i indexWestX = _mm_cvttps_epi32(cellMinsX);
+        __m128i indexSouthY = _mm_cvttps_epi32(cellMinsY);
+        __m128i indexBelowZ = _mm_cvttps_epi32(cellMinsZ);
+        __m128i indexEastX = _mm_add_epi32(indexWestX, _mm_set1_epi32(1));
+        __m128i indexNorthY = _mm_add_epi32(indexSouthY, _mm_set1_epi32(1));
+        __m128i indexAboveZ = _mm_add_epi32(indexBelowZ, _mm_set1_epi32(1));
+
+        __m128 aboveSouthWest = NoiseUintToZeroToOne4(Get3dNoiseUint4(indexWestX, indexSouthY, indexAboveZ, seed));
+        __m128 aboveSouthEast = NoiseUintToZeroToOne4(Get3dNoiseUint4(indexEastX, indexSouthY, indexAboveZ, seed));
+        __m128 aboveNorthWest = NoiseUintToZeroToOne4(Get3dNoiseUint4(indexWestX, indexNorthY, indexAboveZ, seed));
+        __m128 aboveNorthEast = NoiseUintToZeroToOne4(Get3dNoiseUint4(indexEastX, indexNorthY, indexAboveZ, seed));
+        __m128 belowSouthWest = NoiseUintToZeroToOne4(Get3dNoiseUint4(indexWestX, indexSouthY, indexBelowZ, seed));
+        __m128 belowSouthEast = NoiseUintToZeroToOne4(Get3dNoiseUint4(indexEastX, indexSouthY, indexBelowZ, seed));
+        __m128 belowNorthWest = NoiseUintToZeroToOne4(Get3dNoiseUint4(indexWestX, indexNorthY, indexBelowZ, seed));
+        __m128 belowNorthEast = NoiseUintToZeroToOne4(Get3dNoiseUint4(indexEastX, indexNorthY, indexBelowZ, seed));
+
+        __m128 weightEast = SmoothStep4(_mm_sub_ps(currentX, cellMinsX));
+        __m128 weightNorth = SmoothStep4(_mm_sub_ps(currentY, cellMinsY));
+        __m128 weightAbove = SmoothStep4(_mm_sub_ps(currentZ, cellMinsZ));
+        __m128 weightWest = _mm_sub_ps(_mm_set1_ps(1.f), weightEast);
+        __m128 weightSouth = _mm_sub_ps(_mm_set1_ps(1.f), weightNorth);
+        __m128 weightBelow = _mm_sub_ps(_mm_set1_ps(1.f), weightAbove);
+
+        __m128 blendBelowSouth = Lerp4(weightEast, weightWest, belowSouthEast, belowSouthWest);
+        __m128 blendBelowNorth = Lerp4(weightEast, weightWest, belowNorthEast, belowNorthWest);
+        __m128 blendAboveSouth = Lerp4(weightEast, weightWest, aboveSouthEast, aboveSouthWest);
+        __m128 blendAboveNorth = Lerp4(weightEast, weightWest, aboveNorthEast, aboveNorthWest);
+        __m128 blendBelow = Lerp4(weightSouth, weightNorth, blendBelowSouth, blendBelowNorth);
+        __m128 blendAbove = Lerp4(weightSouth, weightNorth, blendAboveSouth, blendAboveNorth);
+        __m128 blendTotal = Lerp4(weightBelow, weightAbove, blendBelow, blendAbove);
+        __m128 noiseThisOctave = _mm_mul_ps(_mm_set1_ps(2.f), _mm_sub_ps(blendTotal, _mm_set1_ps(0.5f)));
+
+        totalNoise = _mm_add_ps(totalNoise, _mm_mul_ps(noiseThisOctave, _mm_set1_ps(currentAmplitude)));
+        totalAmplitude += currentAmplitude;
+        currentAmplitude *= parameters.octavePersistence;
+        currentX = _mm_add_ps(_mm_mul_ps(currentX, _mm_set1_ps(parameters.octaveScale)), _mm_set1_ps(OCTAVE_OFFSET));
+        currentY = _mm_add_ps(_mm_mul_ps(currentY, _mm_set1_ps(parameters.octaveScale)), _mm_set1_ps(OCTAVE_OFFSET));
+        currentZ = _mm_add_ps(_mm_mul_ps(currentZ, _mm_set1_ps(parameters.octaveScale)), _mm_set1_ps(OCTAVE_OFFSET));
+        ++seed;
+    }
+
+    if (parameters.renormalize && totalAmplitude > 0.f)
+    {
+        totalNoise = Renormalize4(totalNoise, totalAmplitude);
+    }
+    return totalNoise;
+}
+
+//-----------------------------------------------------------------------------------
+static __m128 Compute2dPerlinNoise4(__m128 posX, __m128 posY, const NoiseBatchParameters& parameters)
+{
+    float totalAmplitude = 0.f;
+    float currentAmplitude = 1.f;
+    unsigned int seed = parameters.seed;
+    __m128 totalNoise = _mm_setzero_ps();
+    __m128 invScale = _mm_set1_ps(1.f / parameters.scale);
+    __m128 currentX = _mm_mul_ps(posX, invScale);
+    __m128 currentY = _mm_mul_ps(posY, invScale);
+
+    for (unsigned int octaveNum = 0; octaveNum < parameters.numOctaves; ++octaveNum)
+    {
+        __m128 cellMinsX = FastFloor4(currentX);
+        __m128 cellMinsY = FastFloor4(currentY);
+        __m128 cellMaxsX = _mm_add_ps(cellMinsX, _mm_set1_ps(1.f));
+        __m128 cellMaxsY = _mm_add_ps(cellMinsY, _mm_set1_ps(1.f));
+        __m128i indexWestX = _mm_cvttps_epi32(cellMinsX);
+        __m128i indexSouthY = _mm_cvttps_epi32(cellMinsY);
+        __m128i indexEastX = _mm_add_epi32(indexWestX, _mm_set1_epi32(1));
+        __m128i indexNorthY = _mm_add_epi32(indexSouthY, _mm_set1_epi32(1));
+
+        __m128 displacementWest = _mm_sub_ps(currentX, cellMinsX);
+        __m128 displacementEast = _mm_sub_ps(currentX, cellMaxsX);
+        __m128 displacementSouth = _mm_sub_ps(currentY, cellMinsY);
+        __m128 displacementNorth = _mm_sub_ps(currentY, cellMaxsY);
+
+        __m128 dotSouthWest = Dot2dGradient4(Get2dNoiseUint4(indexWestX, indexSouthY, seed), displacementWest, displacementSouth);
+        __m128 dotSouthEast = Dot2dGradient4(Get2dNoiseUint4(indexEastX, indexSouthY, seed), displacementEast, displacementSouth);
+        __m128 dotNorthWest = Dot2dGradient4(Get2dNoiseUint4(indexWestX, indexNorthY, seed), displacementWest, displacementNorth);
+        __m128 dotNorthEast = Dot2dGradient4(Get2dNoiseUint4(indexEastX, indexNorthY, seed), displacementEast, displacementNorth);
+
+        __m128 weightEast = SmoothStep5_4(displacementWest);
+        __m128 weightNorth = SmoothStep5_4(displacementSouth);
+        __m128 weightWest = _mm_sub_ps(_mm_set1_ps(1.f), weightEast);
+        __m128 weightSouth = _mm_sub_ps(_mm_set1_ps(1.f), weightNorth);
+
+        __m128 blendSouth = Lerp4(weightEast, weightWest, dotSouthEast, dotSouthWest);
+        __m128 blendNorth = Lerp4(weightEast, weightWest, dotNorthEast, dotNorthWest);
+        __m128 blendTotal = Lerp4(weightSouth, weightNorth, blendSouth, blendNorth);
+        __m128 noiseThisOctave = _mm_mul_ps(_mm_set1_ps(1.5f), blendTotal);
+
+        totalNoise = _mm_add_ps(totalNoise, _mm_mul_ps(noiseThisOctave, _mm_set1_ps(currentAmplitude)));
+        totalAmplitude += currentAmplitude;
+        currentAmplitude *= parameters.octavePersistence;
+        currentX = _mm_add_ps(_mm_mul_ps(currentX, _mm_set1_ps(parameters.octaveScale)), _mm_set1_ps(OCTAVE_OFFSET));
+        currentY = _mm_add_ps(_mm_mul_ps(currentY, _mm_set1_ps(parameters.octaveScale)), _mm_set1_ps(OCTAVE_OFFSET));
+        ++seed;
+    }
+
+    if (parameters.renormalize && totalAmplitude > 0.f)
+    {
+        totalNoise = Renormalize4(totalNoise, totalAmplitude);
+    }
+    return totalNoise;
+}
+
+//-----------------------------------------------------------------------------------
+static __m128 Compute3dPerlinNoise4(__m128 posX, __m128 posY, __m128 posZ, const NoiseBatchParameters& parameters)
+{
+    float totalAmplitude = 0.f;
+    float currentAmplitude = 1.f;
+    unsigned int seed = parameters.seed;
+    __m128 totalNoise = _mm_setzero_ps();
+    __m128 invScale = _mm_set1_ps(1.f / parameters.scale);
+    __m128 currentX = _mm_mul_ps(posX, invScale);
+    __m128 currentY = _mm_mul_ps(posY, invScale);
+    __m128 currentZ = _mm_mul_ps(posZ, invScale);
+
+    for (unsigned int octaveNum = 0; octaveNum < parameters.numOctaves; ++octaveNum)
+    {
+        __m128 cellMinsX = FastFloor4(currentX);
+        __m128 cellMinsY = FastFloor4(currentY);
+        __m128 cellMinsZ = FastFloor4(currentZ);
+        __m128 cellMaxsX = _mm_add_ps(cellMinsX, _mm_set1_ps(1.f));
+        __m128 cellMaxsY = _mm_add_ps(cellMinsY, _mm_set1_ps(1.f));
+        __m128 cellMaxsZ = _mm_add_ps(cellMinsZ, _mm_set1_ps(1.f));
+        __m128i indexWestX = _mm_cvttps_epi32(cellMinsX);
+        __m128i indexSouthY = _mm_cvttps_epi32(cellMinsY);
+        __m128i indexBelowZ = _mm_cvttps_epi32(cellMinsZ);
+        __m128i indexEastX = _mm_add_epi32(indexWestX, _mm_set1_epi32(1));
+        __m128i indexNorthY = _mm_add_epi32(indexSouthY, _mm_set1_epi32(1));
+        __m128i indexAboveZ = _mm_add_epi32(indexBelowZ, _mm_set1_epi32(1));
+
+        __m128 displacementWest = _mm_sub_ps(currentX, cellMinsX);
+        __m128 displacementEast = _mm_sub_ps(currentX, cellMaxsX);
+        __m128 displacementSouth = _mm_sub_ps(currentY, cellMinsY);
+        __m128 displacementNorth = _mm_sub_ps(currentY, cellMaxsY);
+        __m128 displacementBelow = _mm_sub_ps(currentZ, cellMinsZ);
+        __m128 displacementAbove = _mm_sub_ps(currentZ, cellMaxsZ);
+
+        __m128 dotBelowSW = Dot3dGradient4(Get3dNoiseUint4(indexWestX, indexSouthY, indexBelowZ, seed), displacementWest, displacementSouth, displacementBelow);
+        __m128 dotBelowSE = Dot3dGradient4(Get3dNoiseUint4(indexEastX, indexSouthY, indexBelowZ, seed), displacementEast, displacementSouth, displacementBelow);
+        __m128 dotBelowNW = Dot3dGradient4(Get3dNoiseUint4(indexWestX, indexNorthY, indexBelowZ, seed), displacementWest, displacementNorth, displacementBelow);
+        __m128 dotBelowNE = Dot3dGradient4(Get3dNoiseUint4(indexEastX, indexNorthY, indexBelowZ, seed), displacementEast, displacementNorth, displacementBelow);
+        __m128 dotAboveSW = Dot3dGradient4(Get3dNoiseUint4(indexWestX, indexSouthY, indexAboveZ, seed), displacementWest, displacementSouth, displacementAbove);
+        __m128 dotAboveSE = Dot3dGradient4(Get3dNoiseUint4(indexEastX, indexSouthY, indexAboveZ, seed), displacementEast, displacementSouth, displacementAbove);
+        __m128 dotAboveNW = Dot3dGradient4(Get3dNoiseUint4(indexWestX, indexNorthY, indexAboveZ, seed), displacementWest, displacementNorth, displacementAbove);
+        __m128 dotAboveNE = Dot3dGradient4(Get3dNoiseUint4(indexEastX, indexNorthY, indexAboveZ, seed), displacementEast, displacementNorth, displacementAbove);
+
+        __m128 weightEast = SmoothStep5_4(displacementWest);
+        __m128 weightNorth = SmoothStep5_4(displacementSouth);
+        __m128 weightAbove = SmoothStep5_4(displacementBelow);
+        __m128 weightWest = _mm_sub_ps(_mm_set1_ps(1.f), weightEast);
+        __m128 weightSouth = _mm_sub_ps(_mm_set1_ps(1.f), weightNorth);
+        __m128 weightBelow = _mm_sub_ps(_mm_set1_ps(1.f), weightAbove);
+
+        __m128 blendBelowSouth = Lerp4(weightEast, weightWest, dotBelowSE, dotBelowSW);
+        __m128 blendBelowNorth = Lerp4(weightEast, weightWest, dotBelowNE, dotBelowNW);
+        __m128 blendAboveSouth = Lerp4(weightEast, weightWest, dotAboveSE, dotAboveSW);
+        __m128 blendAboveNorth = Lerp4(weightEast, weightWest, dotAboveNE, dotAboveNW);
+        __m128 blendBelow = Lerp4(weightSouth, weightNorth, blendBelowSouth, blendBelowNorth);
+        __m128 blendAbove = Lerp4(weightSouth, weightNorth, blendAboveSouth, blendAboveNorth);
+        __m128 blendTotal = Lerp4(weightBelow, weightAbove, blendBelow, blendAbove);
+        __m128 noiseThisOctave = _mm_mul_ps(_mm_set1_ps(1.66666666f), blendTotal);
+
+        totalNoise = _mm_add_ps(totalNoise, _mm_mul_ps(noiseThisOctave, _mm_set1_ps(currentAmplitude)));
+        totalAmplitude += currentAmplitude;
+        currentAmplitude *= parameters.octavePersistence;
+        currentX = _mm_add_ps(_mm_mul_ps(currentX, _mm_set1_ps(parameters.octaveScale)), _mm_set1_ps(OCTAVE_OFFSET));
+        currentY = _mm_add_ps(_mm_mul_ps(currentY, _mm_set1_ps(parameters.octaveScale)), _mm_set1_ps(OCTAVE_OFFSET));
+        currentZ = _mm_add_ps(_mm_mul_ps(currentZ, _mm_set1_ps(parameters.octaveScale)), _mm_set1_ps(OCTAVE_OFFSET));
+        ++seed;
+    }
+
+    if (parameters.renormalize && totalAmplitude > 0.f)
+    {
+        totalNoise = Renormalize4(totalNoise, totalAmplitude);
+    }
+    return totalNoise;
+}
+
+//-----------------------------------------------------------------------------------
+static float ComputeNoiseSample(const NoiseBatchParameters& parameters, float posX, float posY, float posZ)
+{
+    switch (parameters.type)
+    {
+    case FRACTAL_2D:
+        return Compute2dFractalNoise(posX, posY, parameters.scale, parameters.numOctaves, parameters.octavePersistence, parameters.octaveScale, parameters.renormalize, parameters.seed);
+    case FRACTAL_3D:
+        return Compute3dFractalNoise(posX, posY, posZ, parameters.scale, parameters.numOctaves, parameters.octavePersistence, parameters.octaveScale, parameters.renormalize, parameters.seed);
+    case PERLIN_2D:
+        return Compute2dPerlinNoise(posX, posY, parameters.scale, parameters.numOctaves, parameters.octavePersistence, parameters.octaveScale, parameters.renormalize, parameters.seed);
+    case PERLIN_3D:
+    default:
+        return Compute3dPerlinNoise(posX, posY, posZ, parameters.scale, parameters.numOctaves, parameters.octavePersistence, parameters.octaveScale, parameters.renormalize, parameters.seed);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+static void ComputeNoiseRows(const NoiseBatchParameters& parameters, int firstRow, int numRows)
+{
+    const __m128 laneOffsets = _mm_set_ps(3.f, 2.f, 1.f, 0.f);
+    for (int row = firstRow; row < firstRow + numRows; ++row)
+    {
+        int y = row % parameters.height;
+        int z = row / parameters.height;
+        float* rowOutput = parameters.output + (row * parameters.width);
+        float posY = parameters.origin.y + ((float)y * parameters.sampleSpacing.y);
+        float posZ = parameters.origin.z + ((float)z * parameters.sampleSpacing.z);
+        __m128 positionsY = _mm_set1_ps(posY);
+        __m128 positionsZ = _mm_set1_ps(posZ);
+
+        int x = 0;
+        for (; x + 4 <= parameters.width; x += 4)
+        {
+            __m128 indicesX = _mm_add_ps(_mm_set1_ps((float)x), laneOffsets);
+            __m128 positionsX = _mm_add_ps(_mm_set1_ps(parameters.origin.x), _mm_mul_ps(indicesX, _mm_set1_ps(parameters.sampleSpacing.x)));
+            __m128 noise;
+            switch (parameters.type)
+            {
+            case FRACTAL_2D:
+                noise = Compute2dFractalNoise4(positionsX, positionsY, parameters);
+                break;
+            case FRACTAL_3D:
+                noise = Compute3dFractalNoise4(positionsX, positionsY, positionsZ, parameters);
+                break;
+            case PERLIN_2D:
+                noise = Compute2dPerlinNoise4(positionsX, positionsY, parameters);
+                break;
+            case PERLIN_3D:
+            default:
+                noise = Compute3dPerlinNoise4(positionsX, positionsY, positionsZ, parameters);
+                break;
+            }
+            _mm_storeu_ps(rowOutput + x, noise);
+        }
+
+        //Whatever doesn't fill a full set of lanes just goes through the scalar version.
+        for (; x < parameters.width; ++x)
+        {
+            float posX = parameters.origin.x + ((float)x * parameters.sampleSpacing.x);
+            rowOutput[x] = ComputeNoiseSample(parameters, posX, posY, posZ);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+static void ComputeNoiseRowsJob(Job* job)
+{
+    NoiseBatchRows* rows = static_cast<NoiseBatchRows*>(job->data);
+    ComputeNoiseRows(*rows->parameters, rows->firstRow, rows->numRows);
+    --(*rows->numRemainingJobs);
+}
+
+//-----------------------------------------------------------------------------------
+static void ComputeNoiseBatch(const NoiseBatchParameters& parameters, int numRows, bool useJobs)
+{
+    if (parameters.width <= 0 || numRows <= 0)
+    {
+        return;
+    }
+    int numJobs = (useJobs && JobSystem::instance) ? Min<int>((int)GetCoreCount(), numRows / MIN_ROWS_PER_JOB) : 0;
+    if (numJobs < 2)
+    {
+        ComputeNoiseRows(parameters, 0, numRows);
+        return;
+    }
+
+    int rowsPerJob = (numRows + numJobs - 1) / numJobs;
+    std::atomic<int> numRemainingJobs(0);
+    std::vector<NoiseBatchRows> jobRows;
+    jobRows.reserve(numJobs);
+    for (int firstRow = 0; firstRow < numRows; firstRow += rowsPerJob)
+    {
+        NoiseBatchRows rows;
+        rows.parameters = &parameters;
+        rows.firstRow = firstRow;
+        rows.numRows = Min<int>(rowsPerJob, numRows - firstRow);
+        rows.numRemainingJobs = &numRemainingJobs;
+        jobRows.push_back(rows);
+    }
+    numRemainingJobs = (int)jobRows.size();
+    for (NoiseBatchRows& rows : jobRows)
+    {
+        JobSystem::instance->CreateAndDispatchJob(GENERIC, &ComputeNoiseRowsJob, &rows);
+    }
+
+    //Work through the queue ourselves while we wait on the rest.
+    std::vector<JobType> types;
+    types.push_back(GENERIC);
+    JobConsumer consumer(types);
+    while (numRemainingJobs > 0)
+    {
+        if (!consumer.Consume())
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void Get1dNoiseUints(unsigned int* out_noise, int firstIndex, unsigned int count, unsigned int seed)
+{
+    __m128i indices = _mm_add_epi32(_mm_set1_epi32(firstIndex), _mm_set_epi32(3, 2, 1, 0));
+    const __m128i four = _mm_set1_epi32(4);
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_si128((__m128i*)(out_noise + i), Get1dNoiseUint4(indices, seed));
+        indices = _mm_add_epi32(indices, four);
+    }
+    for (; i < count; ++i)
+    {
+        out_noise[i] = Get1dNoiseUint((int)((unsigned int)firstIndex + i), seed);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+static NoiseBatchParameters MakeNoiseBatchParameters(NoiseBatchType type, float* out_noise, int width, int height, const Vector3& origin, const Vector3& sampleSpacing, float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed)
+{
+    NoiseBatchParameters parameters;
+    parameters.type = type;
+    parameters.output = out_noise;
+    parameters.width = width;
+    parameters.height = height;
+    parameters.origin = origin;
+    parameters.sampleSpacing = sampleSpacing;
+    parameters.scale = scale;
+    parameters.numOctaves = numOctaves;
+    parameters.octavePersistence = octavePersistence;
+    parameters.octaveScale = octaveScale;
+    parameters.renormalize = renormalize;
+    parameters.seed = seed;
+    return parameters;
+}
+
+//-----------------------------------------------------------------------------------
+void Compute2dFractalNoiseGrid(float* out_noise, int width, int height, const Vector2& origin, const Vector2& sampleSpacing, float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed, bool useJobs)
+{
+    NoiseBatchParameters parameters = MakeNoiseBatchParameters(FRACTAL_2D, out_noise, width, height, Vector3(origin, 0.f), Vector3(sampleSpacing, 0.f), scale, numOctaves, octavePersistence, octaveScale, renormalize, seed);
+    ComputeNoiseBatch(parameters, height, useJobs);
+}
+
+//-----------------------------------------------------------------------------------
+void Compute3dFractalNoiseVolume(float* out_noise, int width, int height, int depth, const Vector3& origin, const Vector3& sampleSpacing, float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed, bool useJobs)
+{
+    NoiseBatchParameters parameters = MakeNoiseBatchParameters(FRACTAL_3D, out_noise, width, height, origin, sampleSpacing, scale, numOctaves, octavePersistence, octaveScale, renormalize, seed);
+    ComputeNoiseBatch(parameters, height * depth, useJobs);
+}
+
+//-----------------------------------------------------------------------------------
+void Compute2dPerlinNoiseGrid(float* out_noise, int width, int height, const Vector2& origin, const Vector2& sampleSpacing, float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed, bool useJobs)
+{
+    NoiseBatchParameters parameters = MakeNoiseBatchParameters(PERLIN_2D, out_noise, width, height, Vector3(origin, 0.f), Vector3(sampleSpacing, 0.f), scale, numOctaves, octavePersistence, octaveScale, renormalize, seed);
+    ComputeNoiseBatch(parameters, height, useJobs);
+}
+
+//-----------------------------------------------------------------------------------
+void Compute3dPerlinNoiseVolume(float* out_noise, int width, int height, int depth, const Vector3& origin, const Vector3& sampleSpacing, float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed, bool useJobs)
+{
+    NoiseBatchParameters parameters = MakeNoiseBatchParameters(PERLIN_3D, out_noise, width, height, origin, sampleSpacing, scale, numOctaves, octavePersistence, octaveScale, renormalize, seed);
+    ComputeNoiseBatch(parameters, height * depth, useJobs);
+}
+
+//-----------------------------------------------------------------------------------
+static const char* GetNoiseBatchTypeName(NoiseBatchType type)
+{
+    switch (type)
+    {
+    case FRACTAL_2D:
+        return "2D fractal";
+    case FRACTAL_3D:
+        return "3D fractal";
+    case PERLIN_2D:
+        return "2D Perlin";
+    case PERLIN_3D:
+    default:
+        return "3D Perlin";
+    }
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(noiseverify)
+{
+    //Odd sizes so the scalar tail gets checked too, positions straddling zero for the negative floor path.
+    const int WIDTH = 67;
+    const int HEIGHT = 13;
+    const int DEPTH = 5;
+    const int NUM_TRIALS = 20;
+    std::vector<float> batchNoise(WIDTH * HEIGHT * DEPTH);
+    int numMismatches = 0;
+    int numSamples = 0;
+
+    for (int typeIndex = 0; typeIndex < 4; ++typeIndex)
+    {
+        NoiseBatchType type = (NoiseBatchType)typeIndex;
+        bool is3d = (type == FRACTAL_3D || type == PERLIN_3D);
+        for (int trial = 0; trial < NUM_TRIALS; ++trial)
+        {
+            Vector3 origin(MathUtils::GetRandomFloatFromZeroTo(200.f) - 100.f, MathUtils::GetRandomFloatFromZeroTo(200.f) - 100.f, MathUtils::GetRandomFloatFromZeroTo(200.f) - 100.f);
+            Vector3 sampleSpacing(0.01f + MathUtils::GetRandomFloatFromZeroTo(3.f), 0.01f + MathUtils::GetRandomFloatFromZeroTo(3.f), 0.01f + MathUtils::GetRandomFloatFromZeroTo(3.f));
+            float scale = 0.5f + MathUtils::GetRandomFloatFromZeroTo(50.f);
+            unsigned int numOctaves = 1 + MathUtils::GetRandomIntFromZeroTo(8);
+            bool renormalize = (trial % 2) == 0;
+            unsigned int seed = (unsigned int)MathUtils::GetRandomIntFromZeroTo(100000);
+            int depth = is3d ? DEPTH : 1;
+
+            NoiseBatchParameters parameters = MakeNoiseBatchParameters(type, batchNoise.data(), WIDTH, HEIGHT, origin, sampleSpacing, scale, numOctaves, 0.5f, 2.f, renormalize, seed);
+            ComputeNoiseBatch(parameters, HEIGHT * depth, (trial % 4) == 1);
+            for (int z = 0; z < depth; ++z)
+            {
+                for (int y = 0; y < HEIGHT; ++y)
+                {
+                    for (int x = 0; x < WIDTH; ++x)
+                    {
+                        float posX = origin.x + ((float)x * sampleSpacing.x);
+                        float posY = origin.y + ((float)y * sampleSpacing.y);
+                        float posZ = origin.z + ((float)z * sampleSpacing.z);
+                        float expected = ComputeNoiseSample(parameters, posX, posY, posZ);
+                        float actual = batchNoise[((z * HEIGHT) + y) * WIDTH + x];
+                        ++numSamples;
+                        if (memcmp(&expected, &actual, sizeof(float)) != 0)
+                        {
+                            if (numMismatches < 10)
+                            {
+                                Console::instance->PrintLine(Stringf("%s mismatch at (%i, %i, %i): expected %.9g, got %.9g", GetNoiseBatchTypeName(type), x, y, z, expected, actual), RGBA::RED);
+                            }
+                            ++numMismatches;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    Console::instance->PrintLine(Stringf("Batch noise checked %i samples against the scalar functions: %i mismatches", numSamples, numMismatches), numMismatches == 0 ? RGBA::CORNFLOWER_BLUE : RGBA::RED);
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(noisebench)
+{
+    if (!(args.HasArgs(0) || args.HasArgs(1) || args.HasArgs(2)))
+    {
+        Console::instance->PrintLine("noisebench [gridSize] [numOctaves]", RGBA::RED);
+        return;
+    }
+    int size = args.HasArgs(0) ? 2048 : Max<int>(args.GetIntArgument(0), 1);
+    unsigned int numOctaves = args.HasArgs(2) ? (unsigned int)Max<int>(args.GetIntArgument(1), 1) : 4;
+    int volumeSize = Max<int>(size / 16, 4);
+    std::vector<float> noise(Max<int>(size * size, volumeSize * volumeSize * volumeSize));
+    const Vector3 origin(-37.5f, 12.25f, 3.f);
+    const Vector3 sampleSpacing(0.25f, 0.25f, 0.25f);
+    const float scale = 64.f;
+
+    Console::instance->PrintLine(Stringf("Noise throughput, %i octaves (%ix%i grids, %i^3 volumes), millions of samples/sec:", numOctaves, size, size, volumeSize), RGBA::CORNFLOWER_BLUE);
+    for (int typeIndex = 0; typeIndex < 4; ++typeIndex)
+    {
+        NoiseBatchType type = (NoiseBatchType)typeIndex;
+        bool is3d = (type == FRACTAL_3D || type == PERLIN_3D);
+        int width = is3d ? volumeSize : size;
+        int height = is3d ? volumeSize : size;
+        int numRows = is3d ? volumeSize * volumeSize : size;
+        double numSamples = (double)width * (double)numRows;
+        NoiseBatchParameters parameters = MakeNoiseBatchParameters(type, noise.data(), width, height, origin, sampleSpacing, scale, numOctaves, 0.5f, 2.f, true, 0);
+
+        //One point query per sample, the way callers had to do it before.
+        double startSeconds = GetCurrentTimeSeconds();
+        for (int row = 0; row < numRows; ++row)
+        {
+            float posY = origin.y + ((float)(row % height) * sampleSpacing.y);
+            float posZ = origin.z + ((float)(row / height) * sampleSpacing.z);
+            for (int x = 0; x < width; ++x)
+            {
+                noise[row * width + x] = ComputeNoiseSample(parameters, origin.x + ((float)x * sampleSpacing.x), posY, posZ);
+            }
+        }
+        double scalarSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+        startSeconds = GetCurrentTimeSeconds();
+        ComputeNoiseBatch(parameters, numRows, false);
+        double batchSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+        startSeconds = GetCurrentTimeSeconds();
+        ComputeNoiseBatch(parameters, numRows, true);
+        double jobSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+        Console::instance->PrintLine(Stringf("%s: scalar %.2f, SSE2 %.2f, SSE2 + jobs %.2f", GetNoiseBatchTypeName(type), numSamples / scalarSeconds / 1000000.0, numSamples / batchSeconds / 1000000.0, numSamples / jobSeconds / 1000000.0), RGBA::GBWHITE);
+    }
+}
\ No newline at end of file
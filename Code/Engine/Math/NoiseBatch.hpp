@@ -0,0 +1,18 @@
+#pragma once
+#include "Engine/Math/Vector2.hpp"
+#include "Engine/Math/Vector3.hpp"
+
+//-----------------------------------------------------------------------------------
+// Batch versions of the Noise.hpp point queries, for filling heightmaps and volume textures.
+// Sample (x, y, z) lands at origin + (x, y, z) * sampleSpacing, and the buffer is laid out
+// row-major (x fastest, then y, then z). Four samples are evaluated at once with SSE2, doing the
+// same float operations in the same order as the scalar functions, so every value is bit-for-bit
+// what calling Compute*Noise at that position would return (the noiseverify command checks this).
+// With useJobs, rows are split up across the JobSystem's GENERIC threads and the call waits for them.
+
+//FUNCTIONS/////////////////////////////////////////////////////////////////////
+void Get1dNoiseUints(unsigned int* out_noise, int firstIndex, unsigned int count, unsigned int seed = 0); //Get1dNoiseUint for firstIndex, firstIndex + 1, ...
+void Compute2dFractalNoiseGrid(float* out_noise, int width, int height, const Vector2& origin, const Vector2& sampleSpacing, float scale = 1.f, unsigned int numOctaves = 1, float octavePersistence = 0.5f, float octaveScale = 2.f, bool renormalize = true, unsigned int seed = 0, bool useJobs = false);
+void Compute3dFractalNoiseVolume(float* out_noise, int width, int height, int depth, const Vector3& origin, const Vector3& sampleSpacing, float scale = 1.f, unsigned int numOctaves = 1, float octavePersistence = 0.5f, float octaveScale = 2.f, bool renormalize = true, unsigned int seed = 0, bool useJobs = false);
+void Compute2dPerlinNoiseGrid(float* out_noise, int width, int height, const Vector2& origin, const Vector2& sampleSpacing, float scale = 1.f, unsigned int numOctaves = 1, float octavePersistence = 0.5f, float octaveScale = 2.f, bool renormalize = true, unsigned int seed = 0, bool useJobs = false);
+void Compute3dPerlinNoiseVolume(float* out_noise, int width, int height, int depth, const Vector3& origin, const Vector3& sampleSpacing, float scale = 1.f, unsigned int numOctaves = 1, float octavePersistence = 0.5f, float octaveScale = 2.f, bool renormalize = true, unsigned int seed = 0, bool useJobs = false);
\ No newline at end of file
@@ -0,0 +1,308 @@
+#include "Engine/Math/RandomStream.hpp"
+#include "Engine/Math/Noise.hpp"
+#include "Engine/Math/NoiseBatch.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/Vector2.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Time/Time.hpp"
+#include <emmintrin.h>
+#include <atomic>
+#include <vector>
+#include <cstdlib>
+#include <cmath>
+
+static std::atomic<unsigned int> s_threadStreamSeed(0);
+static std::atomic<unsigned int> s_threadStreamGeneration(0);
+static const float ONE_OVER_TWO_TO_THE_24 = 1.f / 16777216.f;
+static const unsigned int FILL_CHUNK_SIZE = 256;
+
+//-----------------------------------------------------------------------------------
+RandomStream::RandomStream(unsigned int seed, unsigned int position)
+    : m_seed(seed)
+    , m_position(position)
+{
+
+}
+
+//-----------------------------------------------------------------------------------
+void RandomStream::Seed(unsigned int seed, unsigned int position)
+{
+    m_seed = seed;
+    m_position = position;
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int RandomStream::GetUint()
+{
+    return Get1dNoiseUint((int)m_position++, m_seed);
+}
+
+//-----------------------------------------------------------------------------------
+//Top 24 bits, so every value is exactly representable and 1.0 can't come out of the rounding.
+float RandomStream::GetFloatZeroToOne()
+{
+    return (float)(GetUint() >> 8) * ONE_OVER_TWO_TO_THE_24;
+}
+
+//-----------------------------------------------------------------------------------
+float RandomStream::GetFloatInRange(float minimumInclusive, float maximumExclusive)
+{
+    return minimumInclusive + (GetFloatZeroToOne() * (maximumExclusive - minimumInclusive));
+}
+
+//-----------------------------------------------------------------------------------
+int RandomStream::GetIntLessThan(int maxValueNotInclusive)
+{
+    if (maxValueNotInclusive <= 0)
+    {
+        return 0;
+    }
+    return (int)GetUintLessThan((uint32_t)maxValueNotInclusive);
+}
+
+//-----------------------------------------------------------------------------------
+int RandomStream::GetIntInRange(int minValueInclusive, int maxValueInclusive)
+{
+    if (maxValueInclusive <= minValueInclusive)
+    {
+        return minValueInclusive;
+    }
+    uint32_t range = (uint32_t)maxValueInclusive - (uint32_t)minValueInclusive + 1;
+    uint32_t offset = (range == 0) ? GetUint() : GetUintLessThan(range); //range wraps to 0 for the whole int range
+    return (int)((uint32_t)minValueInclusive + offset);
+}
+
+//-----------------------------------------------------------------------------------
+bool RandomStream::GetChance(float probabilityOfReturningTrue)
+{
+    return GetFloatZeroToOne() < probabilityOfReturningTrue;
+}
+
+//-----------------------------------------------------------------------------------
+Vector2 RandomStream::GetPointInCircle(float radius)
+{
+    float theta = MathUtils::TWO_PI * GetFloatZeroToOne();
+    float r = sqrt(GetFloatZeroToOne()) * radius;
+    return Vector2(r * cos(theta), r * sin(theta));
+}
+
+//-----------------------------------------------------------------------------------
+void RandomStream::FillUints(unsigned int* out_values, unsigned int count)
+{
+    Get1dNoiseUints(out_values, (int)m_position, count, m_seed);
+    m_position += count;
+}
+
+//-----------------------------------------------------------------------------------
+void RandomStream::FillFloatsZeroToOne(float* out_values, unsigned int count)
+{
+    FillFloatsInRange(out_values, count, 0.f, 1.f);
+}
+
+//-----------------------------------------------------------------------------------
+//Same numbers, in the same order, as calling GetFloatInRange count times.
+void RandomStream::FillFloatsInRange(float* out_values, unsigned int count, float minimumInclusive, float maximumExclusive)
+{
+    unsigned int bits[FILL_CHUNK_SIZE];
+    const float extent = maximumExclusive - minimumInclusive;
+    const __m128 minimums = _mm_set1_ps(minimumInclusive);
+    const __m128 extents = _mm_set1_ps(extent);
+    const __m128 unitScale = _mm_set1_ps(ONE_OVER_TWO_TO_THE_24);
+
+    for (unsigned int chunkStart = 0; chunkStart < count; chunkStart += FILL_CHUNK_SIZE)
+    {
+        unsigned int chunkSize = Min<unsigned int>(FILL_CHUNK_SIZE, count - chunkStart);
+        FillUints(bits, chunkSize);
+        float* chunkOutput = out_values + chunkStart;
+        unsigned int i = 0;
+        for (; i + 4 <= chunkSize; i += 4)
+        {
+            __m128 zeroToOne = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(_mm_loadu_si128((const __m128i*)(bits + i)), 8)), unitScale);
+            _mm_storeu_ps(chunkOutput + i, _mm_add_ps(minimums, _mm_mul_ps(zeroToOne, extents)));
+        }
+        for (; i < chunkSize; ++i)
+        {
+            chunkOutput[i] = minimumInclusive + (((float)(bits[i] >> 8) * ONE_OVER_TWO_TO_THE_24) * extent);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Lemire's multiply and shift, rejecting the few low products that would make some results more likely than others.
+uint32_t RandomStream::GetUintLessThan(uint32_t range)
+{
+    uint64_t product = (uint64_t)GetUint() * (uint64_t)range;
+    uint32_t lowBits = (uint32_t)product;
+    if (lowBits < range)
+    {
+        uint32_t threshold = (0u - range) % range;
+        while (lowBits < threshold)
+        {
+            product = (uint64_t)GetUint() * (uint64_t)range;
+            lowBits = (uint32_t)product;
+        }
+    }
+    return (uint32_t)(product >> 32);
+}
+
+//-----------------------------------------------------------------------------------
+//Each thread gets its own stream, seeded off the shared seed and the job worker it is, so a seed replays the same
+//numbers on the same workers every run. Threads outside the job pool all start from the main thread's sequence.
+RandomStream& RandomStream::GetThreadStream()
+{
+    thread_local RandomStream s_stream;
+    thread_local unsigned int s_generation = (unsigned int)-1;
+    unsigned int generation = s_threadStreamGeneration;
+    if (s_generation != generation)
+    {
+        s_generation = generation;
+        s_stream.Seed(Get1dNoiseUint(JobSystem::GetCurrentWorkerIndex() + 1, s_threadStreamSeed));
+    }
+    return s_stream;
+}
+
+//-----------------------------------------------------------------------------------
+void RandomStream::SeedThreadStreams(unsigned int seed)
+{
+    s_threadStreamSeed = seed;
+    ++s_threadStreamGeneration;
+    GetThreadStream();
+}
+
+//-----------------------------------------------------------------------------------
+struct RandomTestResults
+{
+    double mean;
+    double variance;
+    double chiSquared;
+    double serialCorrelation;
+    double lowThirdFraction;
+};
+
+//-----------------------------------------------------------------------------------
+//Uniformity (chi squared over 100 buckets, 99 degrees of freedom), moments, lag-1 correlation, and how
+//often a range of 3/4 * 32768 lands in its lowest third, which a modulo-biased generator gets wrong.
+template <typename FloatGenerator, typename RangeGenerator>
+static RandomTestResults RunRandomTests(int numSamples, FloatGenerator getFloat, RangeGenerator getIntLessThan)
+{
+    const int NUM_BUCKETS = 100;
+    const int RANGE = 24576;
+    std::vector<int> buckets(NUM_BUCKETS, 0);
+    double sum = 0.0;
+    double sumSquares = 0.0;
+    double sumProducts = 0.0;
+    double first = 0.0;
+    double previous = 0.0;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        double value = (double)getFloat();
+        int bucket = Min<int>((int)(value * NUM_BUCKETS), NUM_BUCKETS - 1);
+        ++buckets[bucket];
+        sum += value;
+        sumSquares += value * value;
+        if (i == 0)
+        {
+            first = value;
+        }
+        else
+        {
+            sumProducts += previous * value;
+        }
+        previous = value;
+    }
+    sumProducts += previous * first;
+
+    RandomTestResults results;
+    double n = (double)numSamples;
+    results.mean = sum / n;
+    results.variance = (sumSquares / n) - (results.mean * results.mean);
+    results.serialCorrelation = ((n * sumProducts) - (sum * sum)) / ((n * sumSquares) - (sum * sum));
+    double expected = n / (double)NUM_BUCKETS;
+    results.chiSquared = 0.0;
+    for (int count : buckets)
+    {
+        results.chiSquared += ((double)count - expected) * ((double)count - expected) / expected;
+    }
+
+    int numInLowThird = 0;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        numInLowThird += (getIntLessThan(RANGE) < RANGE / 3) ? 1 : 0;
+    }
+    results.lowThirdFraction = (double)numInLowThird / n;
+    return results;
+}
+
+//-----------------------------------------------------------------------------------
+static void PrintRandomTestResults(const char* name, const RandomTestResults& results)
+{
+    Console::instance->PrintLine(Stringf("%s: mean %.5f, variance %.5f, chi squared %.1f, serial correlation %.5f, low third %.4f", name, results.mean, results.variance, results.chiSquared, results.serialCorrelation, results.lowThirdFraction), RGBA::GBWHITE);
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(randomtest)
+{
+    int numSamples = args.HasArgs(1) ? Max<int>(args.GetIntArgument(0), 1) : 1000000;
+    Console::instance->PrintLine(Stringf("%i samples. Ideal: mean 0.5, variance %.5f, chi squared ~99 (99%% of the time under 135), correlation ~0, low third 0.3333", numSamples, 1.0 / 12.0), RGBA::CORNFLOWER_BLUE);
+
+    RandomTestResults crtResults = RunRandomTests(numSamples, []() { return (float)rand() / (float)(RAND_MAX + 1); }, [](int range) { return rand() % range; });
+    PrintRandomTestResults("rand()", crtResults);
+
+    RandomStream stream(12345);
+    RandomTestResults streamResults = RunRandomTests(numSamples, [&stream]() { return stream.GetFloatZeroToOne(); }, [&stream](int range) { return stream.GetIntLessThan(range); });
+    PrintRandomTestResults("RandomStream", streamResults);
+
+    std::vector<float> bulk(numSamples);
+    RandomStream bulkStream(12345);
+    bulkStream.FillFloatsZeroToOne(bulk.data(), numSamples);
+    int bulkIndex = 0;
+    RandomTestResults bulkResults = RunRandomTests(numSamples, [&bulk, &bulkIndex]() { return bulk[bulkIndex++]; }, [&bulkStream](int range) { return bulkStream.GetIntLessThan(range); });
+    PrintRandomTestResults("RandomStream bulk fill", bulkResults);
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(randombench)
+{
+    int numSamples = args.HasArgs(1) ? Max<int>(args.GetIntArgument(0), 1) : 10000000;
+    std::vector<float> values(numSamples);
+    float checksum = 0.0f;
+
+    double startSeconds = GetCurrentTimeSeconds();
+    for (int i = 0; i < numSamples; ++i)
+    {
+        values[i] = (float)rand() / (float)RAND_MAX;
+    }
+    double crtSeconds = GetCurrentTimeSeconds() - startSeconds;
+    checksum += values[numSamples / 2];
+
+    startSeconds = GetCurrentTimeSeconds();
+    for (int i = 0; i < numSamples; ++i)
+    {
+        values[i] = MathUtils::GetRandomFloatFromZeroTo(1.0f);
+    }
+    double mathUtilsSeconds = GetCurrentTimeSeconds() - startSeconds;
+    checksum += values[numSamples / 2];
+
+    RandomStream stream(12345);
+    startSeconds = GetCurrentTimeSeconds();
+    for (int i = 0; i < numSamples; ++i)
+    {
+        values[i] = stream.GetFloatZeroToOne();
+    }
+    double streamSeconds = GetCurrentTimeSeconds() - startSeconds;
+    checksum += values[numSamples / 2];
+
+    startSeconds = GetCurrentTimeSeconds();
+    stream.FillFloatsZeroToOne(values.data(), numSamples);
+    double bulkSeconds = GetCurrentTimeSeconds() - startSeconds;
+    checksum += values[numSamples / 2];
+
+    double megaSamples = (double)numSamples / 1000000.0;
+    Console::instance->PrintLine(Stringf("%i random floats, millions per second (checksum %f):", numSamples, checksum), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("rand(): %.1f", megaSamples / crtSeconds), RGBA::GBWHITE);
+    Console::instance->PrintLine(Stringf("MathUtils::GetRandomFloatFromZeroTo (thread stream): %.1f", megaSamples / mathUtilsSeconds), RGBA::GBWHITE);
+    Console::instance->PrintLine(Stringf("RandomStream::GetFloatZeroToOne: %.1f", megaSamples / streamSeconds), RGBA::GBWHITE);
+    Console::instance->PrintLine(Stringf("RandomStream::FillFloatsZeroToOne: %.1f", megaSamples / bulkSeconds), RGBA::GBWHITE);
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+#include <stdint.h>
+
+class Vector2;
+
+//-----------------------------------------------------------------------------------
+// A counter-based random number generator: the nth number out of a stream is just
+// Get1dNoiseUint(n, seed), so there's no hidden state beyond a seed and a position.
+// Save those two and you can replay the exact same sequence, or jump anywhere in it.
+// Streams aren't shared between threads; use GetThreadStream() or give each owner its own.
+class RandomStream
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    RandomStream(unsigned int seed = 0, unsigned int position = 0);
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void Seed(unsigned int seed, unsigned int position = 0);
+    unsigned int GetUint();
+    float GetFloatZeroToOne(); //[0, 1)
+    float GetFloatInRange(float minimumInclusive, float maximumExclusive);
+    int GetIntLessThan(int maxValueNotInclusive);
+    int GetIntInRange(int minValueInclusive, int maxValueInclusive);
+    bool GetChance(float probabilityOfReturningTrue);
+    Vector2 GetPointInCircle(float radius);
+    void FillUints(unsigned int* out_values, unsigned int count);
+    void FillFloatsZeroToOne(float* out_values, unsigned int count);
+    void FillFloatsInRange(float* out_values, unsigned int count, float minimumInclusive, float maximumExclusive);
+    inline unsigned int GetSeed() const { return m_seed; };
+    inline unsigned int GetPosition() const { return m_position; };
+    inline void SetPosition(unsigned int position) { m_position = position; };
+
+    //STATIC FUNCTIONS/////////////////////////////////////////////////////////////////////
+    static RandomStream& GetThreadStream();
+    static void SeedThreadStreams(unsigned int seed); //Reseeds this thread now, and every other thread's stream the next time it's used
+
+private:
+    //PRIVATE FUNCTIONS/////////////////////////////////////////////////////////////////////
+    uint32_t GetUintLessThan(uint32_t range);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    unsigned int m_seed;
+    unsigned int m_position;
+};
\ No newline at end of file
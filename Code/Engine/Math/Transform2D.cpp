@@ -1,6 +1,8 @@
 #include "Engine/Math/Transform2D.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 
+unsigned int Transform2D::s_hierarchyVersion = 0;
+
 //-----------------------------------------------------------------------------------
 Transform2D::Transform2D(const Vector2& pos, float rotDegrees, const Vector2& scaleVal, Transform2D* parent)
     : m_position(pos)
@@ -34,6 +36,7 @@ Transform2D::~Transform2D()
     {
         child->RemoveParent();
     }
+    ++s_hierarchyVersion;
 }
 
 //-----------------------------------------------------------------------------------
@@ -41,6 +44,8 @@ void Transform2D::AddChild(Transform2D* child)
 {
     m_children.push_back(child);
     child->m_parent = this;
+    child->MarkWorldDirty();
+    ++s_hierarchyVersion;
 }
 
 //-----------------------------------------------------------------------------------
@@ -81,6 +86,8 @@ void Transform2D::DropChildrenInPlace()
 void Transform2D::RemoveParent()
 {
     m_parent = nullptr;
+    MarkWorldDirty();
+    ++s_hierarchyVersion;
 }
 
 //-----------------------------------------------------------------------------------
@@ -89,6 +96,7 @@ Transform2D& Transform2D::operator=(const Transform2D& other)
     m_position = other.GetWorldPosition();
     m_rotationDegrees = other.GetWorldRotationDegrees();
     m_scale = other.GetWorldScale();
+    MarkWorldDirty();
     return *this;
 }
 
@@ -101,40 +109,31 @@ void Transform2D::SetParent(Transform2D* parent)
 //-----------------------------------------------------------------------------------
 Vector2 Transform2D::GetWorldPosition() const
 {
-    if (m_parent && m_applyParentTranslation)
-    {
-        return m_position + m_parent->GetWorldPosition();
-    }
-    else
+    if (m_isWorldDirty)
     {
-        return m_position;
+        RecalculateWorld();
     }
+    return m_worldPosition;
 }
 
 //-----------------------------------------------------------------------------------
 float Transform2D::GetWorldRotationDegrees() const
 {
-    if (m_parent && m_applyParentRotation)
+    if (m_isWorldDirty)
     {
-        return m_rotationDegrees + m_parent->GetWorldRotationDegrees();
-    }
-    else
-    {
-        return m_rotationDegrees;
+        RecalculateWorld();
     }
+    return m_worldRotationDegrees;
 }
 
 //-----------------------------------------------------------------------------------
 Vector2 Transform2D::GetWorldScale() const
 {
-    if (m_parent && m_applyParentScale)
-    {
-        return m_scale * m_parent->GetWorldScale();
-    }
-    else
+    if (m_isWorldDirty)
     {
-        return m_scale;
+        RecalculateWorld();
     }
+    return m_worldScale;
 }
 
 //-----------------------------------------------------------------------------------
@@ -159,17 +158,58 @@ Vector2 Transform2D::GetLocalScale() const
 void Transform2D::SetPosition(const Vector2& position)
 {
     m_position = position;
+    MarkWorldDirty();
 }
 
 //-----------------------------------------------------------------------------------
 void Transform2D::SetRotationDegrees(float rotationDegrees)
 {
     m_rotationDegrees = rotationDegrees;
+    MarkWorldDirty();
 }
 
 //-----------------------------------------------------------------------------------
 void Transform2D::SetScale(const Vector2& scale)
 {
     m_scale = scale;
+    MarkWorldDirty();
+}
+
+//-----------------------------------------------------------------------------------
+void Transform2D::MarkWorldDirty()
+{
+    //A clean transform always has clean ancestors, so a dirty one already has a dirty subtree below it.
+    if (m_isWorldDirty)
+    {
+        return;
+    }
+    m_isWorldDirty = true;
+    for (Transform2D* child : m_children)
+    {
+        child->MarkWorldDirty();
+    }
 }
 
+//-----------------------------------------------------------------------------------
+void Transform2D::RecalculateWorld() const
+{
+    m_worldPosition = m_position;
+    m_worldRotationDegrees = m_rotationDegrees;
+    m_worldScale = m_scale;
+    if (m_parent)
+    {
+        if (m_applyParentTranslation)
+        {
+            m_worldPosition += m_parent->GetWorldPosition();
+        }
+        if (m_applyParentRotation)
+        {
+            m_worldRotationDegrees += m_parent->GetWorldRotationDegrees();
+        }
+        if (m_applyParentScale)
+        {
+            m_worldScale = m_worldScale * m_parent->GetWorldScale();
+        }
+    }
+    m_isWorldDirty = false;
+}
\ No newline at end of file
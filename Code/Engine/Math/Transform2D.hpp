@@ -3,7 +3,10 @@
 #include <vector>
 #include "Engine/Math/Vector2.hpp"
 
+class Transform2DHierarchy;
+
 //-----------------------------------------------------------------------------------
+//World values are cached, and only recomputed once something up the chain changes.
 class Transform2D
 {
 public:
@@ -37,14 +40,25 @@ public:
     void SetScale(const Vector2& scale);
 
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
-    inline void IgnoreParentTranslation() { m_applyParentTranslation = false; };
-    inline void IgnoreParentRotation() { m_applyParentRotation = false; };
-    inline void IgnoreParentScale() { m_applyParentScale = false; };
-    inline void ApplyParentTranslation() { m_applyParentTranslation = true; };
-    inline void ApplyParentRotation() { m_applyParentRotation = true; };
-    inline void ApplyParentScale() { m_applyParentScale = true; };
+    inline void IgnoreParentTranslation() { m_applyParentTranslation = false; MarkWorldDirty(); };
+    inline void IgnoreParentRotation() { m_applyParentRotation = false; MarkWorldDirty(); };
+    inline void IgnoreParentScale() { m_applyParentScale = false; MarkWorldDirty(); };
+    inline void ApplyParentTranslation() { m_applyParentTranslation = true; MarkWorldDirty(); };
+    inline void ApplyParentRotation() { m_applyParentRotation = true; MarkWorldDirty(); };
+    inline void ApplyParentScale() { m_applyParentScale = true; MarkWorldDirty(); };
+    inline bool IsWorldDirty() const { return m_isWorldDirty; };
+    static inline unsigned int GetHierarchyVersion() { return s_hierarchyVersion; };
 
 private:
+    friend class Transform2DHierarchy;
+
+    //PRIVATE FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void MarkWorldDirty();
+    void RecalculateWorld() const;
+
+    //STATIC VARIABLES/////////////////////////////////////////////////////////////////////
+    static unsigned int s_hierarchyVersion; //Bumped whenever any parent/child link changes
+
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
     std::vector<Transform2D*> m_children;
     Vector2 m_position;
@@ -54,4 +68,8 @@ private:
     bool m_applyParentTranslation = true;
     bool m_applyParentRotation = true;
     bool m_applyParentScale = true;
+    mutable bool m_isWorldDirty = true; //If set, every descendant is dirty as well
+    mutable Vector2 m_worldPosition;
+    mutable Vector2 m_worldScale;
+    mutable float m_worldRotationDegrees;
 };
\ No newline at end of file
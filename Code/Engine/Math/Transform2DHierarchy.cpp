@@ -0,0 +1,289 @@
+#include "Engine/Math/Transform2DHierarchy.hpp"
+#include "Engine/Math/Transform2D.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Time/Time.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <algorithm>
+
+//-----------------------------------------------------------------------------------
+Transform2DHierarchy::Transform2DHierarchy()
+    : m_builtVersion(0)
+    , m_isBuilt(false)
+{
+
+}
+
+//-----------------------------------------------------------------------------------
+Transform2DHierarchy::~Transform2DHierarchy()
+{
+
+}
+
+//-----------------------------------------------------------------------------------
+void Transform2DHierarchy::AddRoot(Transform2D* root)
+{
+    if (!root)
+    {
+        ERROR_RECOVERABLE("Attempted to add a null root transform");
+        return;
+    }
+    m_roots.push_back(root);
+    m_isBuilt = false;
+}
+
+//-----------------------------------------------------------------------------------
+void Transform2DHierarchy::RemoveRoot(Transform2D* root)
+{
+    auto found = std::find(m_roots.begin(), m_roots.end(), root);
+    if (found == m_roots.end())
+    {
+        ERROR_RECOVERABLE("Didn't find a root transform to remove");
+        return;
+    }
+    m_roots.erase(found);
+    m_isBuilt = false;
+}
+
+//-----------------------------------------------------------------------------------
+void Transform2DHierarchy::Clear()
+{
+    m_roots.clear();
+    m_transforms.clear();
+    m_levelStarts.clear();
+    m_isBuilt = false;
+}
+
+//-----------------------------------------------------------------------------------
+void Transform2DHierarchy::Rebuild()
+{
+    //Breadth first, so each depth ends up contiguous and always after the one above it.
+    m_transforms.clear();
+    m_levelStarts.clear();
+    m_transforms.insert(m_transforms.end(), m_roots.begin(), m_roots.end());
+    unsigned int levelStart = 0;
+    while (levelStart < m_transforms.size())
+    {
+        unsigned int levelEnd = m_transforms.size();
+        m_levelStarts.push_back(levelStart);
+        for (unsigned int i = levelStart; i < levelEnd; ++i)
+        {
+            const std::vector<Transform2D*>& children = m_transforms[i]->m_children;
+            m_transforms.insert(m_transforms.end(), children.begin(), children.end());
+        }
+        levelStart = levelEnd;
+    }
+    m_levelStarts.push_back(m_transforms.size());
+    m_builtVersion = Transform2D::GetHierarchyVersion();
+    m_isBuilt = true;
+}
+
+//-----------------------------------------------------------------------------------
+void Transform2DHierarchy::UpdateWorldTransforms(bool useJobs /*= false*/)
+{
+    if (!m_isBuilt || m_builtVersion != Transform2D::GetHierarchyVersion())
+    {
+        Rebuild();
+    }
+
+    unsigned int numLevels = GetNumLevels();
+    for (unsigned int level = 0; level < numLevels; ++level)
+    {
+        unsigned int levelStart = m_levelStarts[level];
+        unsigned int levelEnd = m_levelStarts[level + 1];
+        //Everything in a level only reads the level above it, so a wide level can be split up freely.
+        if (useJobs && JobSystem::instance && levelEnd - levelStart >= MIN_TRANSFORMS_PER_JOB * 2)
+        {
+            UpdateLevelWithJobs(levelStart, levelEnd);
+        }
+        else
+        {
+            UpdateTransforms(&m_transforms[levelStart], levelEnd - levelStart);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void Transform2DHierarchy::UpdateTransforms(Transform2D* const* transforms, unsigned int numTransforms)
+{
+    for (unsigned int i = 0; i < numTransforms; ++i)
+    {
+        const Transform2D* transform = transforms[i];
+        if (transform->m_isWorldDirty)
+        {
+            transform->RecalculateWorld();
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void Transform2DHierarchy::UpdateRangeJob(Job* job)
+{
+    UpdateRange* range = static_cast<UpdateRange*>(job->data);
+    UpdateTransforms(range->transforms, range->numTransforms);
+    --(*range->numRemainingJobs);
+}
+
+//-----------------------------------------------------------------------------------
+void Transform2DHierarchy::UpdateLevelWithJobs(unsigned int levelStart, unsigned int levelEnd)
+{
+    unsigned int numTransforms = levelEnd - levelStart;
+    unsigned int numJobs = numTransforms / MIN_TRANSFORMS_PER_JOB;
+    unsigned int transformsPerJob = (numTransforms + numJobs - 1) / numJobs;
+    std::atomic<int> numRemainingJobs(numJobs);
+
+    m_ranges.resize(numJobs);
+    for (unsigned int i = 0; i < numJobs; ++i)
+    {
+        unsigned int rangeStart = levelStart + i * transformsPerJob;
+        unsigned int rangeEnd = Min<unsigned int>(rangeStart + transformsPerJob, levelEnd);
+        UpdateRange& range = m_ranges[i];
+        range.transforms = &m_transforms[rangeStart];
+        range.numTransforms = rangeEnd - rangeStart;
+        range.numRemainingJobs = &numRemainingJobs;
+        JobSystem::instance->CreateAndDispatchJob(GENERIC, &UpdateRangeJob, &range);
+    }
+
+    //Pitch in rather than sit idle, the next level can't start until this one's done.
+    std::vector<JobType> types;
+    types.push_back(GENERIC);
+    JobConsumer consumer(types);
+    while (numRemainingJobs > 0)
+    {
+        if (!consumer.Consume())
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//What the world getters used to do: walk all the way up to the root on every call.
+static Vector2 GetUncachedWorldPosition(Transform2D* transform)
+{
+    Vector2 position = transform->GetLocalPosition();
+    for (Transform2D* parent = transform->GetParent(); parent; parent = parent->GetParent())
+    {
+        position += parent->GetLocalPosition();
+    }
+    return position;
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(transformbench)
+{
+    int numTransforms = args.HasArgs(2) ? args.GetIntArgument(0) : 100000;
+    int depth = args.HasArgs(2) ? args.GetIntArgument(1) : 8;
+    depth = Clamp<int>(depth, 1, 20);
+    numTransforms = numTransforms < depth ? depth : numTransforms;
+    const int NUM_FRAMES = 10;
+    const int numMovedPerFrame = numTransforms / 100 > 0 ? numTransforms / 100 : 1;
+
+    //Each depth twice as wide as the one above it, every transform parented to a random one a level up.
+    Transform2D* transforms = new Transform2D[numTransforms];
+    std::vector<int> levelStarts;
+    int totalWeight = (1 << depth) - 1;
+    int placed = 0;
+    for (int level = 0; level < depth; ++level)
+    {
+        levelStarts.push_back(placed);
+        int levelSize = level == depth - 1 ? numTransforms - placed : Clamp<int>((int)(((long long)numTransforms << level) / totalWeight), 1, numTransforms - placed - (depth - level - 1));
+        for (int i = placed; i < placed + levelSize; ++i)
+        {
+            transforms[i].SetPosition(Vector2(MathUtils::GetRandomFloatFromZeroTo(10.0f), MathUtils::GetRandomFloatFromZeroTo(10.0f)));
+            if (level > 0)
+            {
+                int parentLevelSize = placed - levelStarts[level - 1];
+                transforms[levelStarts[level - 1] + MathUtils::GetRandomIntFromZeroTo(parentLevelSize)].AddChild(&transforms[i]);
+            }
+        }
+        placed += levelSize;
+    }
+    int numRoots = depth > 1 ? levelStarts[1] : numTransforms;
+    Transform2DHierarchy hierarchy;
+    for (int i = 0; i < numRoots; ++i)
+    {
+        hierarchy.AddRoot(&transforms[i]);
+    }
+    std::vector<int> movedIndices;
+    for (int i = 0; i < numMovedPerFrame * NUM_FRAMES; ++i)
+    {
+        movedIndices.push_back(MathUtils::GetRandomIntFromZeroTo(numTransforms));
+    }
+    float checksum = 0.0f;
+
+    //Reading every world position the old way, walking up the tree each time.
+    double startSeconds = GetCurrentTimeSeconds();
+    for (int frame = 0; frame < NUM_FRAMES; ++frame)
+    {
+        for (int i = 0; i < numTransforms; ++i)
+        {
+            checksum += GetUncachedWorldPosition(&transforms[i]).x;
+        }
+    }
+    double uncachedSeconds = (GetCurrentTimeSeconds() - startSeconds) / (double)NUM_FRAMES;
+
+    //Cached getters only, resolving lazily after 1% of the transforms move each frame.
+    startSeconds = GetCurrentTimeSeconds();
+    for (int frame = 0; frame < NUM_FRAMES; ++frame)
+    {
+        for (int i = 0; i < numMovedPerFrame; ++i)
+        {
+            Transform2D& moved = transforms[movedIndices[frame * numMovedPerFrame + i]];
+            moved.SetPosition(moved.GetLocalPosition() + Vector2::ONE);
+        }
+        for (int i = 0; i < numTransforms; ++i)
+        {
+            checksum += transforms[i].GetWorldPosition().x;
+        }
+    }
+    double lazySeconds = (GetCurrentTimeSeconds() - startSeconds) / (double)NUM_FRAMES;
+
+    //Same again, with the hierarchy's linear pass bringing everything up to date first.
+    double updateSeconds[2];
+    for (int useJobs = 0; useJobs < 2; ++useJobs)
+    {
+        startSeconds = GetCurrentTimeSeconds();
+        for (int frame = 0; frame < NUM_FRAMES; ++frame)
+        {
+            for (int i = 0; i < numMovedPerFrame; ++i)
+            {
+                Transform2D& moved = transforms[movedIndices[frame * numMovedPerFrame + i]];
+                moved.SetPosition(moved.GetLocalPosition() - Vector2::ONE);
+            }
+            hierarchy.UpdateWorldTransforms(useJobs == 1);
+            for (int i = 0; i < numTransforms; ++i)
+            {
+                checksum += transforms[i].GetWorldPosition().x;
+            }
+        }
+        updateSeconds[useJobs] = (GetCurrentTimeSeconds() - startSeconds) / (double)NUM_FRAMES;
+    }
+
+    //Worst case, every root moving every frame so the whole tree is dirty.
+    startSeconds = GetCurrentTimeSeconds();
+    for (int frame = 0; frame < NUM_FRAMES; ++frame)
+    {
+        for (int i = 0; i < numRoots; ++i)
+        {
+            transforms[i].SetRotationDegrees((float)frame);
+        }
+        hierarchy.UpdateWorldTransforms(true);
+        for (int i = 0; i < numTransforms; ++i)
+        {
+            checksum += transforms[i].GetWorldPosition().x;
+        }
+    }
+    double fullSeconds = (GetCurrentTimeSeconds() - startSeconds) / (double)NUM_FRAMES;
+    unsigned int numLevels = hierarchy.GetNumLevels();
+    hierarchy.Clear();
+    delete[] transforms;
+
+    Console::instance->PrintLine(Stringf("World positions for %i transforms, %u levels deep, per frame (checksum %f):", numTransforms, numLevels, checksum), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("Walking to the root every read: %.3fms", uncachedSeconds * 1000.0), RGBA::GBWHITE);
+    Console::instance->PrintLine(Stringf("Cached, resolved on read, %i moved: %.3fms", numMovedPerFrame, lazySeconds * 1000.0), RGBA::GBWHITE);
+    Console::instance->PrintLine(Stringf("Hierarchy pass, %i moved: %.3fms, with jobs %.3fms", numMovedPerFrame, updateSeconds[0] * 1000.0, updateSeconds[1] * 1000.0), RGBA::GBWHITE);
+    Console::instance->PrintLine(Stringf("Hierarchy pass, everything dirty, with jobs: %.3fms", fullSeconds * 1000.0), RGBA::GBWHITE);
+}
\ No newline at end of file
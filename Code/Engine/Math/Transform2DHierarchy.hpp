@@ -0,0 +1,54 @@
+#pragma once
+#include <vector>
+#include <atomic>
+
+class Transform2D;
+struct Job;
+
+//-----------------------------------------------------------------------------------
+// Flattens one or more Transform2D trees into parent-before-child order, grouped by depth, so
+// the whole lot's world values can be brought up to date in one linear pass a frame instead of
+// every getter walking up to the root. Transforms live inside whatever owns them, so this only
+// holds pointers; it notices any parent/child change and re-flattens on the next update.
+// The roots need to outlive the hierarchy (or be removed from it first).
+class Transform2DHierarchy
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    Transform2DHierarchy();
+    ~Transform2DHierarchy();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void AddRoot(Transform2D* root);
+    void RemoveRoot(Transform2D* root);
+    void Clear();
+    void Rebuild();
+    void UpdateWorldTransforms(bool useJobs = false);
+    inline unsigned int GetNumTransforms() const { return m_transforms.size(); };
+    inline unsigned int GetNumLevels() const { return m_levelStarts.empty() ? 0 : m_levelStarts.size() - 1; };
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const unsigned int MIN_TRANSFORMS_PER_JOB = 4096;
+
+private:
+    //STRUCTS/////////////////////////////////////////////////////////////////////
+    struct UpdateRange
+    {
+        Transform2D* const* transforms;
+        unsigned int numTransforms;
+        std::atomic<int>* numRemainingJobs;
+    };
+
+    //PRIVATE FUNCTIONS/////////////////////////////////////////////////////////////////////
+    static void UpdateTransforms(Transform2D* const* transforms, unsigned int numTransforms);
+    static void UpdateRangeJob(Job* job);
+    void UpdateLevelWithJobs(unsigned int levelStart, unsigned int levelEnd);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<Transform2D*> m_roots;
+    std::vector<Transform2D*> m_transforms; //Every parent comes before its children
+    std::vector<unsigned int> m_levelStarts; //Index into m_transforms where each depth begins, plus one past the end
+    std::vector<UpdateRange> m_ranges;
+    unsigned int m_builtVersion;
+    bool m_isBuilt;
+};
\ No newline at end of file
@@ -120,7 +120,8 @@ bool NetSystem::SockaddrCompare(const sockaddr_in& first, const sockaddr_in& sec
 // Binding a TCP Socket for Listening Purposes
 SOCKET NetSystem::CreateListenSocket(const char* hostName, 
                                      const char* portNumber, // who we're trying to connect to
-                                     sockaddr_in* outAddress) // address we actually connected to.
+                                     sockaddr_in* outAddress, // address we actually connected to.
+                                     int backlog) // how many finished handshakes can wait on an accept
 {
     // First, try to get network addresses for this
     addrinfo *infoList = AllocAddressesForHost(hostName, // an address for this machine
@@ -159,7 +160,7 @@ SOCKET NetSystem::CreateListenSocket(const char* hostName,
                 ioctlsocket(mySocket, FIONBIO, &non_blocking);
 
                 // Set it to listen - this will allow people to connect to us
-                result = listen(mySocket, 2);
+                result = listen(mySocket, backlog);
                 ASSERT_OR_DIE(result != SOCKET_ERROR, "Error occurred while creating a listen socket."); // sanity check
 
                 // Save off the address if available.
@@ -288,7 +289,8 @@ size_t NetSystem::SendOnSocket(bool& outShouldDisconnect, SOCKET mySocket, const
     outShouldDisconnect = false;
     if (mySocket != INVALID_SOCKET) 
     {
-        //send will return the amount of data actually sent. It SHOULD match, or be an error.  
+        //send will return the amount of data actually sent. On a non-blocking socket that can
+        //come up short when the send buffer is full, so callers have to hold onto the rest.
         int size = ::send(mySocket, (char const*)data, (int)dataSize, 0);
         if (size < 0) 
         {
@@ -298,10 +300,7 @@ size_t NetSystem::SendOnSocket(bool& outShouldDisconnect, SOCKET mySocket, const
                 //If the error is critical - disconnect this socket
                 outShouldDisconnect = true;
             }
-        }
-        else 
-        {
-            ASSERT_OR_DIE((size_t)size == dataSize, "The size of the data sent wasn't the same as the size we attempted to send");
+            return 0U;
         }
 
         return (size_t)size;
@@ -335,6 +334,8 @@ size_t NetSystem::RecieveFromSocket(bool& outShouldDisconnect, SOCKET mySocket,
         }
         else 
         {
+            //A clean 0 means the other side closed the connection
+            outShouldDisconnect = (size == 0) && (bufferSize > 0);
             return (size_t)size;
         }
     }
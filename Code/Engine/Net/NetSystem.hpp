@@ -15,7 +15,7 @@ public:
     //STATIC FUNCTIONS/////////////////////////////////////////////////////////////////////
     static const char* GetLocalHostName();
     static addrinfo* AllocAddressesForHost(const char* hostName, const char* portNumber, int connectionFamily, int socketType, int flags = 0);
-    static SOCKET CreateListenSocket(const char* address, const char* service, sockaddr_in* outAddress);
+    static SOCKET CreateListenSocket(const char* address, const char* service, sockaddr_in* outAddress, int backlog = 2);
     static SOCKET AcceptConnection(SOCKET hostSocket, sockaddr_in* outTheirAddress);
     static SOCKET JoinSocket(const char* address, const char* service, sockaddr_in* outAddress);
     static void CloseSocket(SOCKET sock);
@@ -1,14 +1,29 @@
 #include "Engine/Net/RemoteCommandService.hpp"
 #include "Engine/Input/Console.hpp"
 #include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Time/Time.hpp"
 #include "NetSystem.hpp"
 #include <string.h>
+#include <algorithm>
 
 RemoteCommandService* RemoteCommandService::instance = nullptr;
 
+//-----------------------------------------------------------------------------------
+static void DisableNagle(SOCKET socket)
+{
+    //Commands and echoes are tiny, waiting to coalesce them only adds latency
+    BOOL noDelay = TRUE;
+    setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+}
+
 //-----------------------------------------------------------------------------------
 RemoteCommandService::RemoteCommandService()
     : m_listener(nullptr)
+    , m_printConnections(true)
+    , m_isIOThreadRunning(false)
+    , m_wakeSocket(INVALID_SOCKET)
+    , m_echoConnection(nullptr)
 {
 
 }
@@ -16,23 +31,27 @@ RemoteCommandService::RemoteCommandService()
 //-----------------------------------------------------------------------------------
 RemoteCommandService::~RemoteCommandService()
 {
+    StopIOThread();
+    CloseAllConnections();
     if (m_listener)
     {
+        m_listener->Stop();
         delete m_listener;
     }
-    for (RemoteCommandServiceConnection* connection : m_connections)
-    {
-#pragma todo("Close out any connections first")
-        delete connection;
-    }
-    m_connections.clear();
 }
 
 //-----------------------------------------------------------------------------------
-bool RemoteCommandService::Host(const char* hostName)
+bool RemoteCommandService::Host(const char* hostName, const char* port)
 {
     UNUSED(hostName)
-    m_listener = new TCPListener(REMOTE_COMMAND_SERVICE_PORT_STRING);
+    m_listener = new TCPListener(port, SOMAXCONN);
+    if (!m_listener->IsListening())
+    {
+        delete m_listener;
+        m_listener = nullptr;
+        return false;
+    }
+    StartIOThread();
     return true;
 }
 
@@ -40,7 +59,8 @@ bool RemoteCommandService::Host(const char* hostName)
 bool RemoteCommandService::StopHosting()
 {
     ASSERT_OR_DIE(m_listener != nullptr, "Tried to stop hosting without having an existing listener");
-#pragma todo("Close out connections here.")
+    StopIOThread();
+    CloseAllConnections();
     m_listener->Stop();
     delete m_listener;
     m_listener = nullptr;
@@ -51,19 +71,23 @@ bool RemoteCommandService::StopHosting()
 void RemoteCommandService::DisconnectFromHost()
 {
     ASSERT_OR_DIE(m_connections.size() == 1 && m_connections[0] != nullptr, "Tried to disconnect without a valid connection");
-    delete m_connections[0];
-    m_connections.clear();
+    StopIOThread();
+    CloseAllConnections();
 }
 
 //-----------------------------------------------------------------------------------
-bool RemoteCommandService::Join(const char* hostName)
+bool RemoteCommandService::Join(const char* hostName, const char* port)
 {
-    RemoteCommandServiceConnection* connection = new RemoteCommandServiceConnection(new TCPConnection(hostName, REMOTE_COMMAND_SERVICE_PORT_STRING));
-    connection->m_tcpConnection->m_socket = NetSystem::JoinSocket(hostName, REMOTE_COMMAND_SERVICE_PORT_STRING, &connection->m_tcpConnection->m_address);
+    RemoteCommandServiceConnection* connection = new RemoteCommandServiceConnection(new TCPConnection(hostName, port), this);
+    connection->m_tcpConnection->m_socket = NetSystem::JoinSocket(hostName, port, &connection->m_tcpConnection->m_address);
     bool isValid = connection->m_tcpConnection->m_socket != INVALID_SOCKET;
     if (isValid)
     {
+        DisableNagle(connection->m_tcpConnection->m_socket);
         AddConnection(connection);
+        StartIOThread();
+        m_newIOConnections.Enqueue(connection);
+        WakeIOThread();
     }
     else
     {
@@ -84,9 +108,7 @@ void RemoteCommandService::SendCommand(byte commandId, const char* command)
 //-----------------------------------------------------------------------------------
 void RemoteCommandService::Update()
 {
-    CheckForConnection(); //Accepts
-    CheckForMessages(); //Recieves
-    CheckForDisconnection(); //Disconeccts
+    ProcessEvents(false);
 }
 
 //-----------------------------------------------------------------------------------
@@ -97,85 +119,428 @@ void RemoteCommandService::AddConnection(RemoteCommandServiceConnection* connect
 }
 
 //-----------------------------------------------------------------------------------
-void RemoteCommandService::OnRecieveRemoteMessage(RemoteCommandServiceConnection* , const byte , const char* msg)
+void RemoteCommandService::OnRecieveRemoteMessage(RemoteCommandServiceConnection* connection, const byte id, const char* msg)
 {
-    Console::instance->PrintLine(Stringf("Running remote command: %s", msg), RGBA::FOREST_GREEN);
-    Console::instance->RunCommand(msg);
+    switch (id)
+    {
+    case MSG_COMMAND:
+        Console::instance->PrintLine(Stringf("Running remote command: %s", msg), RGBA::FOREST_GREEN);
+        m_echoConnection = connection;
+        Console::instance->m_onPrintLine.RegisterMethod(this, &RemoteCommandService::OnConsolePrintLine);
+        Console::instance->RunCommand(msg);
+        Console::instance->m_onPrintLine.UnregisterMethod(this, &RemoteCommandService::OnConsolePrintLine);
+        m_echoConnection = nullptr;
+        break;
+    case MSG_ECHO:
+        Console::instance->PrintLine(msg, RGBA::GBLIGHTGREEN);
+        break;
+    case MSG_RENAME:
+        connection->m_name = msg;
+        break;
+    case MSG_PING:
+        connection->Send(MSG_PONG, msg);
+        break;
+    default:
+        break;
+    }
 }
 
 //-----------------------------------------------------------------------------------
-void RemoteCommandService::CheckForConnection()
+void RemoteCommandService::OnConsolePrintLine(const char* line)
 {
-    if (m_listener)
+    if (m_echoConnection)
+    {
+        m_echoConnection->Send(MSG_ECHO, line);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RemoteCommandService::WakeIOThread()
+{
+    if (m_wakeSocket != INVALID_SOCKET)
+    {
+        char wake = 0;
+        ::sendto(m_wakeSocket, &wake, 1, 0, (sockaddr*)&m_wakeAddress, sizeof(m_wakeAddress));
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RemoteCommandService::StartIOThread()
+{
+    if (m_isIOThreadRunning)
+    {
+        return;
+    }
+
+    //Bound to an ephemeral loopback port, and sent to by itself whenever the main thread queues a write
+    m_wakeSocket = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    sockaddr_in loopback = NetSystem::StringToSockAddrIPv4("127.0.0.1", 0);
+    ::bind(m_wakeSocket, (sockaddr*)&loopback, sizeof(loopback));
+    int addressLength = sizeof(m_wakeAddress);
+    ::getsockname(m_wakeSocket, (sockaddr*)&m_wakeAddress, &addressLength);
+    u_long nonBlocking = 1;
+    ioctlsocket(m_wakeSocket, FIONBIO, &nonBlocking);
+
+    m_isIOThreadRunning = true;
+    m_ioThread = std::thread(&RemoteCommandService::IOThreadMain, this);
+}
+
+//-----------------------------------------------------------------------------------
+void RemoteCommandService::StopIOThread()
+{
+    if (!m_isIOThreadRunning)
+    {
+        return;
+    }
+    m_isIOThreadRunning = false;
+    WakeIOThread();
+    m_ioThread.join();
+    NetSystem::CloseSocket(m_wakeSocket);
+    m_wakeSocket = INVALID_SOCKET;
+
+    //The thread's gone, so everything it handed over (and everything it still had) belongs to us now
+    ProcessEvents(true);
+    while (m_newIOConnections.Dequeue() != nullptr)
+    {
+        //Already in m_connections from Join()
+    }
+    m_ioConnections.clear();
+}
+
+//-----------------------------------------------------------------------------------
+void RemoteCommandService::IOThreadMain()
+{
+    std::vector<WSAPOLLFD> pollFds;
+    std::vector<RemoteCommandMessage> received;
+    while (m_isIOThreadRunning)
     {
-        TCPConnection* connection = m_listener->ListenAndAcceptConnection();
-        if (connection)
+        RemoteCommandServiceConnection* newConnection = m_newIOConnections.Dequeue();
+        while (newConnection)
+        {
+            m_ioConnections.push_back(newConnection);
+            newConnection = m_newIOConnections.Dequeue();
+        }
+
+        pollFds.clear();
+        WSAPOLLFD wakeFd;
+        wakeFd.fd = m_wakeSocket;
+        wakeFd.events = POLLRDNORM;
+        wakeFd.revents = 0;
+        pollFds.push_back(wakeFd);
+        SOCKET listenSocket = m_listener ? m_listener->m_socket : INVALID_SOCKET;
+        if (listenSocket != INVALID_SOCKET)
+        {
+            WSAPOLLFD listenFd;
+            listenFd.fd = listenSocket;
+            listenFd.events = POLLRDNORM;
+            listenFd.revents = 0;
+            pollFds.push_back(listenFd);
+        }
+        size_t firstConnectionFd = pollFds.size();
+        for (RemoteCommandServiceConnection* connection : m_ioConnections)
+        {
+            WSAPOLLFD connectionFd;
+            connectionFd.fd = connection->m_tcpConnection->m_socket;
+            connectionFd.events = POLLRDNORM | (connection->HasPendingWrites() ? POLLWRNORM : 0);
+            connectionFd.revents = 0;
+            pollFds.push_back(connectionFd);
+        }
+
+        int numReady = WSAPoll(pollFds.data(), (ULONG)pollFds.size(), IO_POLL_TIMEOUT_MS);
+        if (numReady <= 0)
+        {
+            continue;
+        }
+
+        if (pollFds[0].revents & POLLRDNORM)
+        {
+            char drain[64];
+            while (::recv(m_wakeSocket, drain, sizeof(drain), 0) > 0)
+            {
+            }
+        }
+
+        if (listenSocket != INVALID_SOCKET && (pollFds[1].revents & POLLRDNORM))
+        {
+            TCPConnection* tcpConnection = m_listener->ListenAndAcceptConnection();
+            while (tcpConnection)
+            {
+                DisableNagle(tcpConnection->m_socket);
+                RemoteCommandServiceConnection* connection = new RemoteCommandServiceConnection(tcpConnection, this);
+                m_ioConnections.push_back(connection);
+                RemoteCommandServiceEvent* joined = new RemoteCommandServiceEvent();
+                joined->type = RemoteCommandServiceEvent::CONNECTION_JOINED;
+                joined->connection = connection;
+                m_events.Enqueue(joined);
+                tcpConnection = m_listener->ListenAndAcceptConnection();
+            }
+        }
+
+        //Anything accepted just now sits past the end of what was polled. Walk backwards so closing is an erase.
+        size_t numPolledConnections = pollFds.size() - firstConnectionFd;
+        for (size_t i = numPolledConnections; i-- > 0;)
         {
-            RemoteCommandServiceConnection* rcs = new RemoteCommandServiceConnection(connection);
-            AddConnection(rcs);
-            Console::instance->PrintLine(Stringf("Connected with %s", rcs->GetAddressString()), RGBA::GBLIGHTGREEN);
+            RemoteCommandServiceConnection* connection = m_ioConnections[i];
+            short revents = pollFds[firstConnectionFd + i].revents;
+            bool isOpen = true;
+            if (revents & (POLLRDNORM | POLLHUP))
+            {
+                received.clear();
+                isOpen = connection->ReceiveFrames(received);
+                for (RemoteCommandMessage& message : received)
+                {
+                    RemoteCommandServiceEvent* messageEvent = new RemoteCommandServiceEvent();
+                    messageEvent->type = RemoteCommandServiceEvent::MESSAGE_RECEIVED;
+                    messageEvent->connection = connection;
+                    messageEvent->message = message;
+                    m_events.Enqueue(messageEvent);
+                }
+            }
+            if (isOpen && (revents & POLLWRNORM))
+            {
+                isOpen = connection->FlushPendingWrites();
+            }
+            if (isOpen && (revents & (POLLERR | POLLNVAL)))
+            {
+                isOpen = false;
+            }
+            if (!isOpen)
+            {
+                connection->m_tcpConnection->Disconnect();
+                m_ioConnections.erase(m_ioConnections.begin() + i);
+                RemoteCommandServiceEvent* left = new RemoteCommandServiceEvent();
+                left->type = RemoteCommandServiceEvent::CONNECTION_LEFT;
+                left->connection = connection;
+                m_events.Enqueue(left);
+            }
         }
     }
 }
 
 //-----------------------------------------------------------------------------------
-void RemoteCommandService::CheckForMessages()
+void RemoteCommandService::ProcessEvents(bool isShuttingDown)
 {
-    for (RemoteCommandServiceConnection* connection : m_connections)
+    RemoteCommandServiceEvent* serviceEvent = m_events.Dequeue();
+    while (serviceEvent)
     {
-        connection->Receive();
+        RemoteCommandServiceConnection* connection = serviceEvent->connection;
+        switch (serviceEvent->type)
+        {
+        case RemoteCommandServiceEvent::CONNECTION_JOINED:
+            AddConnection(connection);
+            if (m_printConnections && !isShuttingDown)
+            {
+                Console::instance->PrintLine(Stringf("Connected with %s", connection->GetAddressString()), RGBA::GBLIGHTGREEN);
+            }
+            m_onConnectionJoin.Trigger(connection);
+            break;
+        case RemoteCommandServiceEvent::CONNECTION_LEFT:
+            m_connections.erase(std::remove(m_connections.begin(), m_connections.end(), connection), m_connections.end());
+            if (m_echoConnection == connection)
+            {
+                m_echoConnection = nullptr;
+            }
+            if (m_printConnections && !isShuttingDown)
+            {
+                Console::instance->PrintLine(Stringf("Lost connection with %s", connection->GetAddressString()), RGBA::CHOCOLATE);
+            }
+            m_onConnectionLeave.Trigger(connection);
+            delete connection;
+            break;
+        case RemoteCommandServiceEvent::MESSAGE_RECEIVED:
+            if (!isShuttingDown)
+            {
+                connection->m_onMessage.Trigger(connection, serviceEvent->message.id, serviceEvent->message.text.c_str());
+            }
+            break;
+        default:
+            break;
+        }
+        delete serviceEvent;
+        serviceEvent = m_events.Dequeue();
     }
 }
 
 //-----------------------------------------------------------------------------------
-void RemoteCommandService::CheckForDisconnection()
+void RemoteCommandService::CloseAllConnections()
 {
-
+    for (RemoteCommandServiceConnection* connection : m_connections)
+    {
+        m_onConnectionLeave.Trigger(connection);
+        delete connection;
+    }
+    m_connections.clear();
+    m_echoConnection = nullptr;
 }
 
 //-----------------------------------------------------------------------------------
-RemoteCommandServiceConnection::RemoteCommandServiceConnection(TCPConnection* tcpConn)
+RemoteCommandServiceConnection::RemoteCommandServiceConnection(TCPConnection* tcpConn, RemoteCommandService* service)
     : m_tcpConnection(tcpConn)
+    , m_service(service)
+    , m_writeOffset(0)
+    , m_droppedEchoes(0)
 {
-
+    InitializeCriticalSection(&m_writeLock);
 }
 
 //-----------------------------------------------------------------------------------
 RemoteCommandServiceConnection::~RemoteCommandServiceConnection()
 {
-    if (m_tcpConnection && m_tcpConnection->IsConnected())
+    if (m_tcpConnection)
     {
-        m_tcpConnection->Disconnect();
+        if (m_tcpConnection->IsConnected())
+        {
+            m_tcpConnection->Disconnect();
+        }
         delete m_tcpConnection;
     }
+    DeleteCriticalSection(&m_writeLock);
+}
+
+//-----------------------------------------------------------------------------------
+bool RemoteCommandServiceConnection::Send(byte commandId, const char* command)
+{
+    size_t length = Min<size_t>(strlen(command), MAX_FRAME_SIZE);
+    bool wasQueued = true;
+    EnterCriticalSection(&m_writeLock);
+    {
+        //Console output is the one thing that can pile up faster than a slow tool reads it. Drop it rather than grow forever.
+        size_t pendingBytes = m_writeBuffer.size() - m_writeOffset;
+        if (commandId == MSG_ECHO && pendingBytes + FRAME_HEADER_SIZE + length > MAX_PENDING_WRITE_BYTES)
+        {
+            ++m_droppedEchoes;
+            wasQueued = false;
+        }
+        else
+        {
+            AppendFrame(commandId, command, length);
+        }
+    }
+    LeaveCriticalSection(&m_writeLock);
+
+    if (wasQueued && m_service)
+    {
+        m_service->WakeIOThread();
+    }
+    return wasQueued;
+}
+
+//-----------------------------------------------------------------------------------
+void RemoteCommandServiceConnection::AppendFrame(byte commandId, const char* text, size_t textLength)
+{
+    uint32_t networkLength = htonl((uint32_t)textLength);
+    const byte* lengthBytes = (const byte*)&networkLength;
+    m_writeBuffer.insert(m_writeBuffer.end(), lengthBytes, lengthBytes + sizeof(networkLength));
+    m_writeBuffer.push_back(commandId);
+    m_writeBuffer.insert(m_writeBuffer.end(), (const byte*)text, (const byte*)text + textLength);
+}
+
+//-----------------------------------------------------------------------------------
+bool RemoteCommandServiceConnection::HasPendingWrites()
+{
+    return GetPendingWriteBytes() > 0;
+}
+
+//-----------------------------------------------------------------------------------
+size_t RemoteCommandServiceConnection::GetPendingWriteBytes()
+{
+    size_t pendingBytes;
+    EnterCriticalSection(&m_writeLock);
+    {
+        pendingBytes = m_writeBuffer.size() - m_writeOffset;
+    }
+    LeaveCriticalSection(&m_writeLock);
+    return pendingBytes;
 }
 
 //-----------------------------------------------------------------------------------
-void RemoteCommandServiceConnection::Send(byte commandId, const char* command)
+bool RemoteCommandServiceConnection::FlushPendingWrites()
 {
-    m_tcpConnection->Send(&commandId, 1);
-    m_tcpConnection->Send(command, strlen(command));
-    char nil = NULL;
-    m_tcpConnection->Send(&nil, 1);
+    if (!m_tcpConnection->IsConnected())
+    {
+        return false;
+    }
+
+    bool isOpen = true;
+    EnterCriticalSection(&m_writeLock);
+    {
+        while (m_writeOffset < m_writeBuffer.size())
+        {
+            bool shouldDisconnect = false;
+            size_t sent = NetSystem::SendOnSocket(shouldDisconnect, m_tcpConnection->m_socket, m_writeBuffer.data() + m_writeOffset, m_writeBuffer.size() - m_writeOffset);
+            if (shouldDisconnect)
+            {
+                isOpen = false;
+                break;
+            }
+            if (sent == 0)
+            {
+                break; //Send buffer's full, pick it back up once the socket polls writable
+            }
+            m_writeOffset += sent;
+        }
+
+        if (m_writeOffset == m_writeBuffer.size())
+        {
+            m_writeBuffer.clear();
+            m_writeOffset = 0;
+        }
+        else if (m_writeOffset > m_writeBuffer.size() / 2)
+        {
+            m_writeBuffer.erase(m_writeBuffer.begin(), m_writeBuffer.begin() + m_writeOffset);
+            m_writeOffset = 0;
+        }
+
+        if (m_droppedEchoes > 0 && (m_writeBuffer.size() - m_writeOffset) <= RESUME_ECHO_WRITE_BYTES)
+        {
+            std::string notice = Stringf("[%u lines of remote output dropped]", m_droppedEchoes);
+            m_droppedEchoes = 0;
+            AppendFrame(MSG_ECHO, notice.c_str(), notice.size());
+        }
+    }
+    LeaveCriticalSection(&m_writeLock);
+    return isOpen;
 }
 
 //-----------------------------------------------------------------------------------
-void RemoteCommandServiceConnection::Receive()
+bool RemoteCommandServiceConnection::ReceiveFrames(std::vector<RemoteCommandMessage>& outMessages)
 {
-    const size_t BUFFER_SIZE = 1024;
+    const size_t BUFFER_SIZE = 4096;
     byte buffer[BUFFER_SIZE];
-    size_t read = m_tcpConnection->Receive(buffer, BUFFER_SIZE);
-    for (size_t i = 0; i < read; ++i)
+    bool shouldDisconnect = false;
+    size_t read = NetSystem::RecieveFromSocket(shouldDisconnect, m_tcpConnection->m_socket, buffer, BUFFER_SIZE);
+    while (read > 0)
+    {
+        m_readBuffer.insert(m_readBuffer.end(), buffer, buffer + read);
+        if (read < BUFFER_SIZE)
+        {
+            break;
+        }
+        read = NetSystem::RecieveFromSocket(shouldDisconnect, m_tcpConnection->m_socket, buffer, BUFFER_SIZE);
+    }
+
+    size_t offset = 0;
+    while (m_readBuffer.size() - offset >= FRAME_HEADER_SIZE)
     {
-        char c = buffer[i];
-        m_nextMessage.push_back(c);
-        if (c == NULL)
+        uint32_t length;
+        memcpy(&length, m_readBuffer.data() + offset, sizeof(length));
+        length = ntohl(length);
+        if (length > MAX_FRAME_SIZE)
         {
-            m_onMessage.Trigger(this, m_nextMessage[0], &m_nextMessage[1]);
-            m_nextMessage.clear();
+            return false; //Not speaking our protocol
         }
+        if (m_readBuffer.size() - offset < FRAME_HEADER_SIZE + length)
+        {
+            break;
+        }
+        RemoteCommandMessage message;
+        message.id = m_readBuffer[offset + sizeof(length)];
+        message.text.assign((const char*)m_readBuffer.data() + offset + FRAME_HEADER_SIZE, length);
+        outMessages.push_back(message);
+        offset += FRAME_HEADER_SIZE + length;
     }
-    read = m_tcpConnection->Receive(buffer, BUFFER_SIZE);
+    m_readBuffer.erase(m_readBuffer.begin(), m_readBuffer.begin() + offset);
+    return !shouldDisconnect;
 }
 
 //-----------------------------------------------------------------------------------
@@ -354,4 +719,112 @@ CONSOLE_COMMAND(commandserverleave)
     {
         Console::instance->PrintLine("Failed to disconnect because you're not connected to a host.", RGBA::RED);
     }
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(rcsbench)
+{
+    if (!(args.HasArgs(0) || args.HasArgs(1) || args.HasArgs(2)))
+    {
+        Console::instance->PrintLine("rcsbench [numClients] [numRounds]", RGBA::RED);
+        return;
+    }
+    //A second service hosted on its own port, with every client a raw connection this thread drives by hand.
+    //Each round every client pings at once; a round trip is send -> IO thread -> Update() -> IO thread -> client.
+    int numClients = args.HasArgs(0) ? 100 : Clamp<int>(args.GetIntArgument(0), 1, 1000);
+    int numRounds = args.HasArgs(2) ? Max<int>(args.GetIntArgument(1), 1) : 50;
+    const char* BENCH_PORT = "4326";
+    const double TIMEOUT_SECONDS = 5.0;
+
+    RemoteCommandService* server = new RemoteCommandService();
+    server->m_printConnections = false;
+    if (!server->Host(NetSystem::GetLocalHostName(), BENCH_PORT))
+    {
+        Console::instance->PrintLine(Stringf("Failed to host on port %s", BENCH_PORT), RGBA::RED);
+        delete server;
+        return;
+    }
+
+    std::vector<RemoteCommandServiceConnection*> clients;
+    double startSeconds = GetCurrentTimeSeconds();
+    for (int i = 0; i < numClients; ++i)
+    {
+        TCPConnection* tcpConnection = new TCPConnection(NetSystem::GetLocalHostName(), BENCH_PORT);
+        tcpConnection->m_socket = NetSystem::JoinSocket(NetSystem::GetLocalHostName(), BENCH_PORT, &tcpConnection->m_address);
+        if (tcpConnection->m_socket == INVALID_SOCKET)
+        {
+            delete tcpConnection;
+            break;
+        }
+        DisableNagle(tcpConnection->m_socket);
+        clients.push_back(new RemoteCommandServiceConnection(tcpConnection));
+    }
+    while (server->m_connections.size() < clients.size() && GetCurrentTimeSeconds() - startSeconds < TIMEOUT_SECONDS)
+    {
+        server->Update();
+        SwitchToThread();
+    }
+    double connectSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+    std::vector<double> roundTripMs;
+    roundTripMs.reserve(clients.size() * numRounds);
+    std::vector<double> sendTimesSeconds(clients.size());
+    std::vector<bool> hasReply(clients.size());
+    std::vector<RemoteCommandMessage> received;
+    size_t numTimedOut = 0;
+    double benchStartSeconds = GetCurrentTimeSeconds();
+    for (int round = 0; round < numRounds; ++round)
+    {
+        std::string token = Stringf("%i", round);
+        for (size_t i = 0; i < clients.size(); ++i)
+        {
+            sendTimesSeconds[i] = GetCurrentTimeSeconds();
+            hasReply[i] = false;
+            clients[i]->Send(MSG_PING, token.c_str());
+            clients[i]->FlushPendingWrites();
+        }
+
+        size_t numReplies = 0;
+        double roundStartSeconds = GetCurrentTimeSeconds();
+        while (numReplies < clients.size() && GetCurrentTimeSeconds() - roundStartSeconds < TIMEOUT_SECONDS)
+        {
+            server->Update();
+            for (size_t i = 0; i < clients.size(); ++i)
+            {
+                if (hasReply[i])
+                {
+                    continue;
+                }
+                received.clear();
+                clients[i]->ReceiveFrames(received);
+                for (RemoteCommandMessage& message : received)
+                {
+                    if (message.id == MSG_PONG && message.text == token)
+                    {
+                        roundTripMs.push_back((GetCurrentTimeSeconds() - sendTimesSeconds[i]) * 1000.0);
+                        hasReply[i] = true;
+                        ++numReplies;
+                    }
+                }
+            }
+        }
+        numTimedOut += clients.size() - numReplies;
+    }
+    double benchSeconds = GetCurrentTimeSeconds() - benchStartSeconds;
+
+    std::sort(roundTripMs.begin(), roundTripMs.end());
+    double p50Ms = roundTripMs.empty() ? 0.0 : roundTripMs[roundTripMs.size() / 2];
+    double p99Ms = roundTripMs.empty() ? 0.0 : roundTripMs[Min<size_t>((size_t)(roundTripMs.size() * 0.99), roundTripMs.size() - 1)];
+    double maxMs = roundTripMs.empty() ? 0.0 : roundTripMs.back();
+
+    Console::instance->PrintLine(Stringf("Remote command service: %i/%i clients connected in %.1fms, %i rounds", (int)server->m_connections.size(), numClients, connectSeconds * 1000.0, numRounds), RGBA::GBWHITE);
+    Console::instance->PrintLine(Stringf("  Round trip: p50 %.3fms, p99 %.3fms, max %.3fms", p50Ms, p99Ms, maxMs), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("  Throughput: %.0f commands/sec", roundTripMs.size() / Max<double>(benchSeconds, 1e-9)), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("  Timed out: %i", (int)numTimedOut), numTimedOut == 0 ? RGBA::FOREST_GREEN : RGBA::RED);
+
+    for (RemoteCommandServiceConnection* client : clients)
+    {
+        delete client;
+    }
+    delete server;
 }
\ No newline at end of file
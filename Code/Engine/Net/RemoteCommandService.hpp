@@ -2,52 +2,115 @@
 #include "Engine/Net/TCPIP/TCPConnection.hpp"
 #include "Engine/Net/TCPIP/TCPListener.hpp"
 #include "Engine/Core/Events/Event.hpp"
+#include "Engine/DataStructures/ThreadSafeQueue.hpp"
 #include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
 
 //TYPEDEFS/////////////////////////////////////////////////////////////////////
 typedef unsigned char byte;
 
+class RemoteCommandService;
+
 //CONSTANTS/////////////////////////////////////////////////////////////////////
 #define REMOTE_COMMAND_SERVICE_PORT 4325
 #define REMOTE_COMMAND_SERVICE_PORT_STRING "4325"
 const byte MSG_COMMAND = 1; //Run a console command
 const byte MSG_ECHO = 2; //Print on the remote console
 const byte MSG_RENAME = 3; //Give the remote connection a name
+const byte MSG_PING = 4; //Answered straight away with a MSG_PONG carrying the same text
+const byte MSG_PONG = 5;
+
+//-----------------------------------------------------------------------------------
+struct RemoteCommandMessage
+{
+    byte id;
+    std::string text;
+};
 
 //-----------------------------------------------------------------------------------
+// Everything on the wire is framed as [uint32 length, network order][byte id][length bytes of text].
+// Sends only append to a buffer under a lock; whoever owns the socket (the service's IO thread,
+// or the caller for a connection with no service) drains it with FlushPendingWrites().
 class RemoteCommandServiceConnection
 {
 public:
-    RemoteCommandServiceConnection(TCPConnection* tcpConnection);
+    RemoteCommandServiceConnection(TCPConnection* tcpConnection, RemoteCommandService* service = nullptr);
     ~RemoteCommandServiceConnection();
-    void Send(byte commandId, const char* command);
-    void Receive();
+    bool Send(byte commandId, const char* command); //False if an echo was dropped for backpressure
+    bool ReceiveFrames(std::vector<RemoteCommandMessage>& outMessages); //False once the connection should be closed
+    bool FlushPendingWrites(); //False once the connection should be closed
+    bool HasPendingWrites();
+    size_t GetPendingWriteBytes();
     const char* GetAddressString();
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const size_t FRAME_HEADER_SIZE = sizeof(uint32_t) + sizeof(byte);
+    static const uint32_t MAX_FRAME_SIZE = 1024 * 1024;
+    static const size_t MAX_PENDING_WRITE_BYTES = 256 * 1024; //Echoes past this are dropped instead of queued
+    static const size_t RESUME_ECHO_WRITE_BYTES = 64 * 1024; //Once drained below this, the other side hears how many it missed
+
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
     TCPConnection* m_tcpConnection;
-    std::vector<char> m_nextMessage;
+    RemoteCommandService* m_service;
+    std::string m_name;
+    std::vector<byte> m_readBuffer;
     Event<RemoteCommandServiceConnection*, byte, const char*> m_onMessage;
+
+private:
+    //PRIVATE FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void AppendFrame(byte commandId, const char* text, size_t textLength);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    CRITICAL_SECTION m_writeLock;
+    std::vector<byte> m_writeBuffer;
+    size_t m_writeOffset;
+    uint32_t m_droppedEchoes;
 };
 
 //-----------------------------------------------------------------------------------
+// Handed from the IO thread to the main thread, which is the only one that touches m_connections
+// or runs anything on the console.
+struct RemoteCommandServiceEvent
+{
+    enum Type
+    {
+        CONNECTION_JOINED,
+        CONNECTION_LEFT,
+        MESSAGE_RECEIVED,
+        NUM_TYPES
+    };
+
+    Type type;
+    RemoteCommandServiceConnection* connection;
+    RemoteCommandMessage message;
+};
+
+//-----------------------------------------------------------------------------------
+// Accepts, reads and writes on a background thread blocked in WSAPoll, so Update() only has to
+// drain whatever events came in since last frame.
 class RemoteCommandService
 {
 public:
     RemoteCommandService();
     ~RemoteCommandService();
-    bool Host(const char* hostName); //Create a socket
+    bool Host(const char* hostName, const char* port = REMOTE_COMMAND_SERVICE_PORT_STRING); //Create a socket
     bool StopHosting();
-    bool Join(const char* hostName); //Create a TCPConnection and add it to the connection list
+    bool Join(const char* hostName, const char* port = REMOTE_COMMAND_SERVICE_PORT_STRING); //Create a TCPConnection and add it to the connection list
     void SendCommand(byte commandId, const char* command);
     void Update();
     void AddConnection(RemoteCommandServiceConnection* connection);
     void OnRecieveRemoteMessage(RemoteCommandServiceConnection* connectionPointer, const byte id, const char* msg);
-    void CheckForConnection();
-    void CheckForMessages();
-    void CheckForDisconnection();
+    void OnConsolePrintLine(const char* line);
     inline bool IsHosting() { return m_listener != nullptr; };
     inline bool IsJoined() { return !IsHosting() && (m_connections.size() > 0); };
     void DisconnectFromHost();
+    void WakeIOThread();
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const int IO_POLL_TIMEOUT_MS = 100; //Only matters for noticing shutdown, sends wake the thread up directly
+
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
     static RemoteCommandService* instance;
 
@@ -56,4 +119,23 @@ public:
     Event<RemoteCommandServiceConnection*> m_onConnectionJoin;
     Event<RemoteCommandServiceConnection*> m_onConnectionLeave;
     Event<RemoteCommandServiceConnection*, const byte, const char*> m_onMessage;
+    bool m_printConnections;
+
+private:
+    //PRIVATE FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void StartIOThread();
+    void StopIOThread();
+    void IOThreadMain();
+    void ProcessEvents(bool isShuttingDown);
+    void CloseAllConnections();
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::thread m_ioThread;
+    std::atomic<bool> m_isIOThreadRunning;
+    SOCKET m_wakeSocket; //Loopback UDP socket the IO thread also polls, so a send doesn't wait out the timeout
+    sockaddr_in m_wakeAddress;
+    std::vector<RemoteCommandServiceConnection*> m_ioConnections; //Only touched on the IO thread
+    ThreadSafeQueue<RemoteCommandServiceConnection> m_newIOConnections; //Joined on the main thread, not yet polled
+    ThreadSafeQueue<RemoteCommandServiceEvent> m_events;
+    RemoteCommandServiceConnection* m_echoConnection; //Where console output goes while a remote command runs
 };
\ No newline at end of file
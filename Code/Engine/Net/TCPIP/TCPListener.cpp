@@ -3,8 +3,8 @@
 #include <string>
 
 //-----------------------------------------------------------------------------------
-TCPListener::TCPListener(const char* host, const char* port, int /*= 1*/)
-    : m_socket(NetSystem::CreateListenSocket(host, port, &m_address))
+TCPListener::TCPListener(const char* host, const char* port, int queueCount /*= 2*/)
+    : m_socket(NetSystem::CreateListenSocket(host, port, &m_address, queueCount))
     , m_host(host)
     , m_port(port)
 {
@@ -12,7 +12,7 @@ TCPListener::TCPListener(const char* host, const char* port, int /*= 1*/)
 }
 
 //-----------------------------------------------------------------------------------
-TCPListener::TCPListener(const char* port) : TCPListener(NetSystem::instance->GetLocalHostName(), port)
+TCPListener::TCPListener(const char* port, int queueCount /*= 2*/) : TCPListener(NetSystem::instance->GetLocalHostName(), port, queueCount)
 {
 
 }
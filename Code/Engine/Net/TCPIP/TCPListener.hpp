@@ -9,8 +9,8 @@ class TCPListener
 {
 public:
     //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
-    TCPListener(const char* host, const char* port, int queueCount = 1); //Bind & Listen
-    TCPListener(const char* port); //default to localhost (host name ip) 
+    TCPListener(const char* host, const char* port, int queueCount = 2); //Bind & Listen
+    TCPListener(const char* port, int queueCount = 2); //default to localhost (host name ip) 
 
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
     TCPConnection* ListenAndAcceptConnection(); //::accept and creates socket
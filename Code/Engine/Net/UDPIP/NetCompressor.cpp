@@ -0,0 +1,480 @@
+#include "Engine/Net/UDPIP/NetCompressor.hpp"
+#include "Engine/Net/UDPIP/NetSession.hpp"
+#include "Engine/Net/UDPIP/NetPacket.hpp"
+#include "Engine/DataStructures/BytePacker.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Time/Time.hpp"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+//-----------------------------------------------------------------------------------
+static inline uint32_t ReadSequence(const byte* data)
+{
+    uint32_t sequence;
+    memcpy(&sequence, data, sizeof(sequence));
+    return sequence;
+}
+
+//-----------------------------------------------------------------------------------
+static size_t GetLengthExtensionSize(size_t length)
+{
+    return (length >= 15) ? ((length - 15) / 255) + 1 : 0;
+}
+
+//-----------------------------------------------------------------------------------
+static byte* WriteLengthExtension(byte* out, size_t length)
+{
+    if (length < 15)
+    {
+        return out;
+    }
+    length -= 15;
+    while (length >= 255)
+    {
+        *out++ = 255;
+        length -= 255;
+    }
+    *out++ = (byte)length;
+    return out;
+}
+
+//-----------------------------------------------------------------------------------
+// Returns nullptr if the sequence doesn't fit. A matchLength of 0 writes the final, literal-only sequence.
+static byte* WriteSequence(byte* out, const byte* outEnd, const byte* literals, size_t numLiterals, uint16_t offset, size_t matchLength)
+{
+    size_t matchCode = (matchLength > 0) ? matchLength - NetCompressor::MIN_MATCH : 0;
+    size_t sequenceSize = 1 + GetLengthExtensionSize(numLiterals) + numLiterals;
+    if (matchLength > 0)
+    {
+        sequenceSize += sizeof(uint16_t) + GetLengthExtensionSize(matchCode);
+    }
+    if (out + sequenceSize > outEnd)
+    {
+        return nullptr;
+    }
+
+    byte literalNibble = (byte)((numLiterals < 15) ? numLiterals : 15);
+    byte matchNibble = (byte)((matchCode < 15) ? matchCode : 15);
+    *out++ = (byte)((literalNibble << 4) | matchNibble);
+    out = WriteLengthExtension(out, numLiterals);
+    memcpy(out, literals, numLiterals);
+    out += numLiterals;
+
+    if (matchLength > 0)
+    {
+        *out++ = (byte)(offset & 0xFF);
+        *out++ = (byte)(offset >> 8);
+        out = WriteLengthExtension(out, matchCode);
+    }
+    return out;
+}
+
+//-----------------------------------------------------------------------------------
+static bool ReadLengthExtension(const byte*& in, const byte* inEnd, size_t& length)
+{
+    byte extension = 255;
+    while (extension == 255)
+    {
+        if (in >= inEnd)
+        {
+            return false;
+        }
+        extension = *in++;
+        length += extension;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+NetCompressor::NetCompressor()
+    : m_dictionarySize(0)
+    , m_packetsCompressed(0)
+    , m_packetsUncompressible(0)
+    , m_bytesIn(0)
+    , m_bytesOut(0)
+{
+    for (size_t i = 0; i < HASH_TABLE_SIZE; ++i)
+    {
+        m_dictionaryHashTable[i] = EMPTY_SLOT;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void NetCompressor::SetDictionary(const byte* dictionary, size_t size)
+{
+    ASSERT_OR_DIE(size <= MAX_DICTIONARY_SIZE, "Packet compression dictionary is too large");
+    memcpy(m_window, dictionary, size);
+    m_dictionarySize = size;
+
+    for (size_t i = 0; i < HASH_TABLE_SIZE; ++i)
+    {
+        m_dictionaryHashTable[i] = EMPTY_SLOT;
+    }
+    for (size_t position = 0; position + MIN_MATCH <= size; ++position)
+    {
+        m_dictionaryHashTable[Hash(ReadSequence(m_window + position))] = (uint16_t)position;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+size_t NetCompressor::Compress(const byte* src, size_t srcSize, byte* dest, size_t destCapacity)
+{
+    ASSERT_OR_DIE(srcSize <= MAX_INPUT_SIZE, "Attempted to compress more than a packet's worth of data");
+    m_bytesIn += srcSize;
+
+    //Lay the input down right after the dictionary so dictionary matches are just longer offsets.
+    memcpy(m_window + m_dictionarySize, src, srcSize);
+    memcpy(m_hashTable, m_dictionaryHashTable, sizeof(m_hashTable));
+
+    const byte* window = m_window;
+    const size_t end = m_dictionarySize + srcSize;
+    byte* out = dest;
+    const byte* outEnd = dest + destCapacity;
+    size_t anchor = m_dictionarySize;
+    size_t position = m_dictionarySize;
+
+    while (position + MIN_MATCH <= end)
+    {
+        uint32_t sequence = ReadSequence(window + position);
+        uint32_t hash = Hash(sequence);
+        uint16_t candidate = m_hashTable[hash];
+        m_hashTable[hash] = (uint16_t)position;
+
+        if (candidate == EMPTY_SLOT || ReadSequence(window + candidate) != sequence)
+        {
+            ++position;
+            continue;
+        }
+
+        size_t matchLength = MIN_MATCH;
+        while (position + matchLength < end && window[candidate + matchLength] == window[position + matchLength])
+        {
+            ++matchLength;
+        }
+
+        out = WriteSequence(out, outEnd, window + anchor, position - anchor, (uint16_t)(position - candidate), matchLength);
+        if (out == nullptr)
+        {
+            ++m_packetsUncompressible;
+            return 0;
+        }
+
+        //Packets are tiny, so it's worth remembering every position the match covered.
+        for (size_t covered = position + 1; covered < position + matchLength && covered + MIN_MATCH <= end; ++covered)
+        {
+            m_hashTable[Hash(ReadSequence(window + covered))] = (uint16_t)covered;
+        }
+        position += matchLength;
+        anchor = position;
+    }
+
+    out = WriteSequence(out, outEnd, window + anchor, end - anchor, 0, 0);
+    if (out == nullptr)
+    {
+        ++m_packetsUncompressible;
+        return 0;
+    }
+
+    size_t compressedSize = out - dest;
+    ++m_packetsCompressed;
+    m_bytesOut += compressedSize;
+    return compressedSize;
+}
+
+//-----------------------------------------------------------------------------------
+size_t NetCompressor::Decompress(const byte* src, size_t srcSize, byte* dest, size_t destCapacity) const
+{
+    const byte* in = src;
+    const byte* inEnd = src + srcSize;
+    size_t outSize = 0;
+
+    while (in < inEnd)
+    {
+        byte token = *in++;
+        size_t numLiterals = token >> 4;
+        if (numLiterals == 15 && !ReadLengthExtension(in, inEnd, numLiterals))
+        {
+            return 0;
+        }
+        if (numLiterals > (size_t)(inEnd - in) || outSize + numLiterals > destCapacity)
+        {
+            return 0;
+        }
+        memcpy(dest + outSize, in, numLiterals);
+        in += numLiterals;
+        outSize += numLiterals;
+
+        if (in == inEnd)
+        {
+            break; //Final sequence is literals only
+        }
+        if (inEnd - in < 2)
+        {
+            return 0;
+        }
+        size_t offset = in[0] | (in[1] << 8);
+        in += 2;
+        size_t matchLength = token & 0x0F;
+        if (matchLength == 15 && !ReadLengthExtension(in, inEnd, matchLength))
+        {
+            return 0;
+        }
+        matchLength += MIN_MATCH;
+        if (offset == 0 || offset > outSize + m_dictionarySize || outSize + matchLength > destCapacity)
+        {
+            return 0;
+        }
+
+        //Byte at a time, matches can overlap their own output and straddle the dictionary boundary.
+        for (size_t i = 0; i < matchLength; ++i)
+        {
+            dest[outSize] = (offset <= outSize) ? dest[outSize - offset] : m_window[m_dictionarySize - (offset - outSize)];
+            ++outSize;
+        }
+    }
+    return outSize;
+}
+
+//-----------------------------------------------------------------------------------
+// Picks the most common 8 byte runs out of the samples and stores each with a little
+// trailing context, until the dictionary is full.
+std::vector<byte> NetCompressor::TrainDictionary(const std::vector<std::vector<byte>>& samples, size_t maxDictionarySize)
+{
+    const size_t GRAM_SIZE = 8;
+    const size_t SEGMENT_SIZE = 16;
+
+    struct GramInfo
+    {
+        uint32_t count;
+        uint32_t sampleIndex;
+        uint32_t position;
+    };
+
+    maxDictionarySize = std::min(maxDictionarySize, MAX_DICTIONARY_SIZE);
+    std::unordered_map<uint64_t, GramInfo> grams;
+    for (uint32_t sampleIndex = 0; sampleIndex < samples.size(); ++sampleIndex)
+    {
+        const std::vector<byte>& sample = samples[sampleIndex];
+        for (uint32_t position = 0; position + GRAM_SIZE <= sample.size(); ++position)
+        {
+            uint64_t gram;
+            memcpy(&gram, sample.data() + position, GRAM_SIZE);
+            auto found = grams.find(gram);
+            if (found == grams.end())
+            {
+                GramInfo info;
+                info.count = 1;
+                info.sampleIndex = sampleIndex;
+                info.position = position;
+                grams[gram] = info;
+            }
+            else
+            {
+                ++found->second.count;
+            }
+        }
+    }
+
+    std::vector<std::pair<uint64_t, GramInfo>> candidates;
+    for (auto& gram : grams)
+    {
+        if (gram.second.count > 1)
+        {
+            candidates.push_back(gram);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const std::pair<uint64_t, GramInfo>& a, const std::pair<uint64_t, GramInfo>& b)
+    {
+        return (a.second.count != b.second.count) ? a.second.count > b.second.count : a.first < b.first;
+    });
+
+    std::vector<byte> dictionary;
+    std::unordered_set<uint64_t> coveredGrams;
+    for (auto& candidate : candidates)
+    {
+        if (coveredGrams.find(candidate.first) != coveredGrams.end())
+        {
+            continue;
+        }
+        const std::vector<byte>& sample = samples[candidate.second.sampleIndex];
+        size_t segmentStart = candidate.second.position;
+        size_t segmentSize = std::min(SEGMENT_SIZE, sample.size() - segmentStart);
+        if (dictionary.size() + segmentSize > maxDictionarySize)
+        {
+            break;
+        }
+        dictionary.insert(dictionary.end(), sample.begin() + segmentStart, sample.begin() + segmentStart + segmentSize);
+        for (size_t position = segmentStart; position + GRAM_SIZE <= segmentStart + segmentSize; ++position)
+        {
+            uint64_t gram;
+            memcpy(&gram, sample.data() + position, GRAM_SIZE);
+            coveredGrams.insert(gram);
+        }
+    }
+    return dictionary;
+}
+
+//-----------------------------------------------------------------------------------
+// Both ends build this from the same seeded synthetic traffic, so nothing needs to be shipped or exchanged.
+std::vector<byte> NetCompressor::BuildDefaultDictionary()
+{
+    return TrainDictionary(GenerateSyntheticTrace(256), 2048);
+}
+
+//-----------------------------------------------------------------------------------
+// Deterministic stand-in for real traffic: acks, heartbeats, and snapshot deltas of slowly moving objects,
+// written in the same layout NetPacket uses.
+std::vector<std::vector<byte>> NetCompressor::GenerateSyntheticTrace(size_t numPackets)
+{
+    uint32_t seed = 0x5EED1234;
+    auto nextRandom = [&seed]() -> uint32_t
+    {
+        seed = (seed * 1664525u) + 1013904223u;
+        return seed >> 8;
+    };
+
+    const int NUM_OBJECTS = 64;
+    float positions[NUM_OBJECTS][2];
+    for (int i = 0; i < NUM_OBJECTS; ++i)
+    {
+        positions[i][0] = (float)(nextRandom() % 1000);
+        positions[i][1] = (float)(nextRandom() % 1000);
+    }
+
+    std::vector<std::vector<byte>> trace;
+    for (size_t packetIndex = 0; packetIndex < numPackets; ++packetIndex)
+    {
+        byte buffer[PACKET_MTU];
+        BytePacker packer(buffer, PACKET_MTU, 0, IBinaryReader::BIG_ENDIAN);
+        uint16_t ack = (uint16_t)packetIndex;
+        bool hasHeartbeat = (packetIndex % 4) == 0;
+
+        packer.Write<uint8_t>((uint8_t)(packetIndex % 2));
+        packer.Write<uint8_t>(hasHeartbeat ? 2 : 1);
+        packer.Write<uint16_t>(ack);
+        packer.Write<uint16_t>((uint16_t)(ack - 1 - (nextRandom() % 2)));
+        packer.Write<uint16_t>((nextRandom() % 8 == 0) ? 0xFFF7 : 0xFFFF);
+
+        if (hasHeartbeat)
+        {
+            packer.Write<uint16_t>(5);
+            packer.Write<uint8_t>(NetMessage::HEARTBEAT);
+            packer.Write<uint16_t>((uint16_t)(packetIndex / 4));
+            packer.Write<uint16_t>(0);
+        }
+
+        //Snapshot of whichever objects moved this tick
+        int numEntries = 8 + (nextRandom() % 24);
+        size_t entrySize = sizeof(uint16_t) + sizeof(uint8_t) + sizeof(uint8_t) + sizeof(uint8_t) + (2 * sizeof(float));
+        packer.Write<uint16_t>((uint16_t)(5 + 4 + (numEntries * entrySize)));
+        packer.Write<uint8_t>(NetMessage::SNAPSHOT);
+        packer.Write<uint16_t>(0);
+        packer.Write<uint16_t>(0);
+        packer.Write<uint16_t>(ack);
+        packer.Write<uint16_t>((uint16_t)numEntries);
+        int firstObject = nextRandom() % NUM_OBJECTS;
+        for (int entry = 0; entry < numEntries; ++entry)
+        {
+            int objectIndex = (firstObject + entry) % NUM_OBJECTS;
+            positions[objectIndex][0] += (float)((int)(nextRandom() % 5) - 2) * 0.25f;
+            positions[objectIndex][1] += (float)((int)(nextRandom() % 5) - 2) * 0.25f;
+            packer.Write<uint16_t>((uint16_t)objectIndex);
+            packer.Write<uint8_t>(1);
+            packer.Write<uint8_t>((uint8_t)(1 + (nextRandom() % 3)));
+            packer.Write<uint8_t>(0x03);
+            packer.Write<float>(positions[objectIndex][0]);
+            packer.Write<float>(positions[objectIndex][1]);
+        }
+
+        trace.push_back(std::vector<byte>(buffer, buffer + packer.GetTotalReadableBytes()));
+    }
+    return trace;
+}
+
+//-----------------------------------------------------------------------------------
+static void RunCompressionBenchmark(const char* label, NetCompressor& compressor, const std::vector<std::vector<byte>>& packets)
+{
+    const int NUM_PASSES = 20;
+    byte compressed[PACKET_MTU];
+    byte decompressed[PACKET_MTU];
+    size_t bytesIn = 0;
+    size_t bytesOut = 0;
+    size_t numRawFallbacks = 0;
+    size_t numMismatches = 0;
+    double compressSeconds = 0.0;
+    double decompressSeconds = 0.0;
+
+    for (int pass = 0; pass < NUM_PASSES; ++pass)
+    {
+        for (const std::vector<byte>& packet : packets)
+        {
+            //Same rule NetSession::SendPacket uses: only worth it if it beats raw including the marker byte.
+            double startSeconds = GetCurrentTimeSeconds();
+            size_t compressedSize = compressor.Compress(packet.data(), packet.size(), compressed, packet.size() - 2);
+            compressSeconds += GetCurrentTimeSeconds() - startSeconds;
+            if (pass != 0)
+            {
+                continue;
+            }
+
+            bytesIn += packet.size();
+            if (compressedSize == 0)
+            {
+                ++numRawFallbacks;
+                bytesOut += packet.size();
+                continue;
+            }
+            bytesOut += compressedSize + 1;
+
+            startSeconds = GetCurrentTimeSeconds();
+            size_t decompressedSize = compressor.Decompress(compressed, compressedSize, decompressed, PACKET_MTU);
+            decompressSeconds += GetCurrentTimeSeconds() - startSeconds;
+            if (decompressedSize != packet.size() || memcmp(decompressed, packet.data(), decompressedSize) != 0)
+            {
+                ++numMismatches;
+            }
+        }
+    }
+
+    size_t numCompressed = packets.size() - numRawFallbacks;
+    Console::instance->PrintLine(Stringf("%s (%i byte dictionary): %.1f%% of original size, %i/%i sent raw, %.2fus compress, %.2fus decompress per packet, %i mismatches",
+        label, (int)compressor.GetDictionarySize(), ((float)bytesOut * 100.0f) / (float)bytesIn, (int)numRawFallbacks, (int)packets.size(),
+        (compressSeconds * 1000000.0) / (double)(packets.size() * NUM_PASSES), numCompressed > 0 ? (decompressSeconds * 1000000.0) / (double)numCompressed : 0.0, (int)numMismatches),
+        numMismatches == 0 ? RGBA::GBWHITE : RGBA::RED);
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(netcompressbench)
+{
+    //Uses the trace recorded with nstrace if there is one, otherwise synthetic traffic.
+    std::vector<std::vector<byte>> trace;
+    const char* source = "synthetic";
+    if (NetSession::instance && NetSession::instance->m_packetTrace.size() >= 2)
+    {
+        trace = NetSession::instance->m_packetTrace;
+        source = "recorded";
+    }
+    else
+    {
+        int numPackets = args.HasArgs(1) ? args.GetIntArgument(0) : 1000;
+        std::vector<std::vector<byte>> allPackets = NetCompressor::GenerateSyntheticTrace(numPackets + 256);
+        trace.assign(allPackets.begin() + 256, allPackets.end()); //Skip the packets the default dictionary was trained on
+    }
+
+    //Train on the first half, measure on the second, so the trained dictionary isn't just memorizing.
+    size_t half = trace.size() / 2;
+    std::vector<std::vector<byte>> trainingSet(trace.begin(), trace.begin() + half);
+    std::vector<std::vector<byte>> testSet(trace.begin() + half, trace.end());
+    Console::instance->PrintLine(Stringf("Packet compression on %i %s packets:", (int)testSet.size(), source), RGBA::CORNFLOWER_BLUE);
+
+    NetCompressor* compressor = new NetCompressor();
+    RunCompressionBenchmark("No dictionary", *compressor, testSet);
+    compressor->SetDictionary(NetCompressor::BuildDefaultDictionary());
+    RunCompressionBenchmark("Default dictionary", *compressor, testSet);
+    compressor->SetDictionary(NetCompressor::TrainDictionary(trainingSet, NetCompressor::MAX_DICTIONARY_SIZE));
+    RunCompressionBenchmark("Trained dictionary", *compressor, testSet);
+    delete compressor;
+}
\ No newline at end of file
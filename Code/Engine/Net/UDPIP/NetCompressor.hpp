@@ -0,0 +1,57 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+typedef unsigned char byte;
+
+//-----------------------------------------------------------------------------------
+// Small LZ77 codec for whole packets, using an LZ4-style token stream:
+//   token (high nibble literal count, low nibble match length - MIN_MATCH), literal count
+//   extension bytes, literals, then uint16 little endian offset and match length extension
+//   bytes. The final sequence is literals only.
+// Both ends preload the same dictionary in front of the data, so matches can reach back
+// into it and even the first packet of a session compresses well.
+class NetCompressor
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    NetCompressor();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void SetDictionary(const byte* dictionary, size_t size);
+    inline void SetDictionary(const std::vector<byte>& dictionary) { SetDictionary(dictionary.data(), dictionary.size()); };
+    inline size_t GetDictionarySize() const { return m_dictionarySize; };
+    // Returns 0 if the data can't be made smaller than destCapacity, in which case send it raw.
+    size_t Compress(const byte* src, size_t srcSize, byte* dest, size_t destCapacity);
+    // Returns 0 on a malformed stream.
+    size_t Decompress(const byte* src, size_t srcSize, byte* dest, size_t destCapacity) const;
+
+    //STATIC FUNCTIONS/////////////////////////////////////////////////////////////////////
+    static std::vector<byte> TrainDictionary(const std::vector<std::vector<byte>>& samples, size_t maxDictionarySize);
+    static std::vector<byte> BuildDefaultDictionary();
+    static std::vector<std::vector<byte>> GenerateSyntheticTrace(size_t numPackets);
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const size_t MAX_DICTIONARY_SIZE = 4096;
+    static const size_t MAX_INPUT_SIZE = 2048;
+    static const size_t MIN_MATCH = 4;
+    static const size_t HASH_BITS = 12;
+    static const size_t HASH_TABLE_SIZE = 1 << HASH_BITS;
+    static const uint16_t EMPTY_SLOT = 0xFFFF;
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    size_t m_packetsCompressed;
+    size_t m_packetsUncompressible;
+    size_t m_bytesIn;
+    size_t m_bytesOut;
+
+private:
+    //PRIVATE FUNCTIONS/////////////////////////////////////////////////////////////////////
+    static inline uint32_t Hash(uint32_t sequence) { return (sequence * 2654435761u) >> (32 - HASH_BITS); };
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    byte m_window[MAX_DICTIONARY_SIZE + MAX_INPUT_SIZE]; //Dictionary first, then whatever we're compressing
+    uint16_t m_dictionaryHashTable[HASH_TABLE_SIZE];
+    uint16_t m_hashTable[HASH_TABLE_SIZE];
+    size_t m_dictionarySize;
+};
\ No newline at end of file
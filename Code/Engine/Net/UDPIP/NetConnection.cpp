@@ -1,17 +1,52 @@
 #include "Engine/Net/UDPIP/NetConnection.hpp"
 #include "Engine/Net/UDPIP/NetSession.hpp"
 #include "Engine/Net/UDPIP/NetMessage.hpp"
+#include "Engine/Net/UDPIP/NetReplicator.hpp"
 #include "Engine/Net/NetSystem.hpp"
 #include "Engine/Time/Time.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+const double NetConnection::INITIAL_RTO_MS = 200.0;
+const double NetConnection::MIN_RTO_MS = 50.0;
+const double NetConnection::MAX_RTO_MS = 2000.0;
+const double NetConnection::MIN_RTO_VARIANCE_MS = 10.0;
+const double NetConnection::INITIAL_SEND_RATE_BYTES_PER_SECOND = 64.0 * 1024.0;
+const double NetConnection::MIN_SEND_RATE_BYTES_PER_SECOND = 4.0 * 1024.0;
+const double NetConnection::MAX_SEND_RATE_BYTES_PER_SECOND = 512.0 * 1024.0;
+const double NetConnection::ADDITIVE_INCREASE_BYTES_PER_ACK = 128.0;
+const double NetConnection::MULTIPLICATIVE_DECREASE = 0.5;
+const double NetConnection::SEND_BURST_SECONDS = 0.05;
+const double NetConnection::DELIVERY_RATE_WINDOW_MS = 500.0;
 
 //-----------------------------------------------------------------------------------
-NetConnection::NetConnection(uint8_t index, const char* guid, const sockaddr_in& address, NetSession* session)
+NetConnection::NetConnection(uint16_t index, const char* guid, const sockaddr_in& address, NetSession* session)
     : m_index(index)
     , m_address(address)
     , m_session(session)
     , m_state(State::UNCONFIRMED)
-    , m_lastSentTimeMs(GetCurrentTimeMilliseconds())
-    , m_lastRecievedTimeMs(GetCurrentTimeMilliseconds())
+    , m_lastSentTimeMs(m_session->GetNetTimeMilliseconds())
+    , m_lastRecievedTimeMs(m_session->GetNetTimeMilliseconds())
+    , m_hasUnsentAcks(false)
+    , m_replicationState(nullptr)
+    , m_rttMs(0.0)
+    , m_rttVarianceMs(0.0)
+    , m_jitterMs(0.0)
+    , m_rtoMs(INITIAL_RTO_MS)
+    , m_sendRateBytesPerSecond(INITIAL_SEND_RATE_BYTES_PER_SECOND)
+    , m_sendBudgetBytes(PACKET_MTU)
+    , m_deliveryRateBytesPerSecond(0.0)
+    , m_packetsSent(0)
+    , m_packetsAcked(0)
+    , m_packetsLost(0)
+    , m_bytesSent(0)
+    , m_nextLossCheckAck(0)
+    , m_hasRoundTripSample(false)
+    , m_lastRoundTripSampleMs(0.0)
+    , m_lastBudgetRefillTimeMs(m_session->GetNetTimeMilliseconds())
+    , m_lastRateDecreaseTimeMs(0.0)
+    , m_lastRtoBackoffTimeMs(0.0)
+    , m_deliveryWindowStartMs(m_session->GetNetTimeMilliseconds())
+    , m_deliveryWindowBytes(0)
     , m_previousHighestReceivedAcksBitfield(0)
     , m_highestReceivedAck(INVALID_PACKET_ACK)
     , m_nextSentAck(0)
@@ -48,18 +83,33 @@ NetConnection::~NetConnection()
     {
         delete msg;
     }
+    for (NetMessage* msg : m_freeReceivedMessages)
+    {
+        delete msg;
+    }
+    if (m_replicationState)
+    {
+        if (m_session->m_replicator)
+        {
+            m_session->m_replicator->DestroyConnectionState(m_replicationState);
+        }
+        else
+        {
+            delete m_replicationState;
+        }
+    }
 }
 
 //-----------------------------------------------------------------------------------
 void NetConnection::SendMessage(NetMessage& msg)
 {
     NetMessage* nextMsg = new NetMessage(msg);
-    if (nextMsg->IsInOrder())
+    if (nextMsg->IsInOrder(m_session))
     {
         nextMsg->m_sequenceId = m_nextSentSequenceId;
         m_nextSentSequenceId++;
     }
-    if (nextMsg->IsReliable()) 
+    if (nextMsg->IsReliable(m_session)) 
     {
         m_unsentReliables.push(nextMsg);
     }
@@ -72,6 +122,8 @@ void NetConnection::SendMessage(NetMessage& msg)
 //-----------------------------------------------------------------------------------
 void NetConnection::ConstructAndSendPacket()
 {
+    RefillSendBudget();
+
     //Initialize the packet
     NetPacket packet(m_session->GetMyConnectionIndex());
     packet.m_header.ack = m_nextSentAck++;
@@ -83,6 +135,10 @@ void NetConnection::ConstructAndSendPacket()
     // Reserve space
     uint8_t* msgsWritten = packet.GetMessageCountBookmark();
 
+    //The header always goes out so acks keep flowing, the send budget only limits what rides along with it.
+    size_t payloadBudget = (m_sendBudgetBytes > 0.0) ? (size_t)m_sendBudgetBytes : 0;
+    packet.m_writeSizeMax = Min<size_t>(PACKET_MTU, packet.GetTotalReadableBytes() + payloadBudget);
+
     AckBundle* bundle = CreateBundle(packet.m_header.ack);
 
     uint8_t sent = 0;
@@ -97,10 +153,40 @@ void NetConnection::ConstructAndSendPacket()
     }
     m_unreliables.clear();
 
+    sent += AttachSnapshot(packet, bundle);
+
     *msgsWritten = sent;
-    m_lastSentTimeMs = GetCurrentTimeMilliseconds();
+    m_lastSentTimeMs = m_session->GetNetTimeMilliseconds();
+    m_hasUnsentAcks = false;
+
+    size_t packetSize = packet.GetTotalReadableBytes();
+    bundle->sentTimeMs = m_lastSentTimeMs;
+    bundle->packetSize = (uint16_t)packetSize;
+    bundle->isConfirmed = false;
+    m_sendBudgetBytes -= (double)packetSize;
+    m_bytesSent += (uint32_t)packetSize;
+    ++m_packetsSent;
+
+    m_session->SendPacket(m_address, packet);
+}
 
-    m_session->m_packetChannel.SendTo(m_address, packet.m_buffer, packet.GetTotalReadableBytes());
+//-----------------------------------------------------------------------------------
+bool NetConnection::HasPendingData()
+{
+    if (!m_unreliables.empty() || !m_unsentReliables.empty() || m_hasUnsentAcks)
+    {
+        return true;
+    }
+    if (!m_sentReliables.empty() && IsOld(m_sentReliables.front()))
+    {
+        return true;
+    }
+    NetReplicator* replicator = m_session->m_replicator;
+    if (replicator && !IsMyConnection() && IsConnected() && (!m_replicationState || replicator->HasDataFor(*m_replicationState)))
+    {
+        return true;
+    }
+    return m_session->GetNetTimeMilliseconds() - m_lastSentTimeMs >= KEEPALIVE_INTERVAL_MS;
 }
 
 //-----------------------------------------------------------------------------------
@@ -119,7 +205,7 @@ uint8_t NetConnection::AttachOldReliables(NetPacket& p, AckBundle* ackBundle)
         if (IsOld(msg) && p.CanWrite(msg))
         {
             m_sentReliables.pop();
-            msg->m_lastSentTimestampMs = (uint32_t)GetCurrentTimeMilliseconds();
+            msg->m_lastSentTimestampMs = (uint32_t)m_session->GetNetTimeMilliseconds();
             p.WriteMessage(msg);
             ++numMessagesAdded;
             ackBundle->AddReliable(msg->m_reliableId);
@@ -143,7 +229,7 @@ uint8_t NetConnection::AttachUnsentReliables(NetPacket& packet, AckBundle* ackBu
         if (packet.CanWrite(msg))
         {
             msg->m_reliableId = GetNextReliableID();
-            msg->m_lastSentTimestampMs = (uint32_t)GetCurrentTimeMilliseconds();
+            msg->m_lastSentTimestampMs = (uint32_t)m_session->GetNetTimeMilliseconds();
             packet.WriteMessage(msg);
             ++numMessagesAdded;
             ackBundle->AddReliable(msg->m_reliableId);
@@ -164,20 +250,65 @@ uint8_t NetConnection::AttachUnreliables(NetPacket& p)
     return (uint8_t)p.WriteMessages(m_unreliables.data(), m_unreliables.size());
 }
 
+//-----------------------------------------------------------------------------------
+uint8_t NetConnection::AttachSnapshot(NetPacket& p, AckBundle* ab)
+{
+    //Snapshots get whatever room is left after everything else, up to the connection's replication budget.
+    NetReplicator* replicator = m_session->m_replicator;
+    if (!replicator || IsMyConnection() || !IsConnected())
+    {
+        return 0;
+    }
+    if (!m_replicationState)
+    {
+        m_replicationState = replicator->CreateConnectionState(this);
+    }
+    if (!replicator->HasDataFor(*m_replicationState))
+    {
+        return 0;
+    }
+
+    NetMessage snapshot(NetMessage::SNAPSHOT);
+    size_t messageOverhead = snapshot.GetHeaderSize() + sizeof(uint16_t);
+    if (p.GetWritableBytes() <= messageOverhead)
+    {
+        return 0;
+    }
+    uint16_t snapshotId = replicator->WriteSnapshot(*m_replicationState, snapshot, p.GetWritableBytes() - messageOverhead);
+    if (snapshotId == NetReplicator::INVALID_SNAPSHOT_ID || p.WriteMessage(&snapshot) == 0)
+    {
+        return 0;
+    }
+    ab->snapshotId = snapshotId;
+    return 1;
+}
+
 //-----------------------------------------------------------------------------------
 void NetConnection::UpdateHighestValue(uint16_t newValue)
 {
-    if (CycleGreaterThanEqual(newValue, m_highestReceivedAck))
+    //Bit n of the bitfield means we've received (highest - (n + 1)).
+    if (m_highestReceivedAck == INVALID_PACKET_ACK)
+    {
+        m_highestReceivedAck = newValue;
+        m_previousHighestReceivedAcksBitfield = 0;
+    }
+    else if (newValue == m_highestReceivedAck)
+    {
+        return; //A duplicate of the newest packet, already marked
+    }
+    else if (CycleGreaterThanEqual(newValue, m_highestReceivedAck))
     {
         uint16_t shift = newValue - m_highestReceivedAck;
-        m_previousHighestReceivedAcksBitfield = m_previousHighestReceivedAcksBitfield << shift;
+        m_previousHighestReceivedAcksBitfield = (shift < ACK_BITFIELD_SIZE) ? (uint16_t)((m_previousHighestReceivedAcksBitfield << shift) | (1 << (shift - 1))) : 0;
         m_highestReceivedAck = newValue;
-        m_previousHighestReceivedAcksBitfield |= shift - 1;
     }
     else
     {
         uint16_t offset = m_highestReceivedAck - newValue;
-        m_previousHighestReceivedAcksBitfield |= offset - 1;
+        if (offset > 0 && offset <= ACK_BITFIELD_SIZE)
+        {
+            m_previousHighestReceivedAcksBitfield |= (uint16_t)(1 << (offset - 1));
+        }
     }
 }
 
@@ -188,14 +319,16 @@ void NetConnection::MarkPacketReceived(const NetPacket& packet)
     //-- > See Class 7's MarkPacketReceived, which puts the below in a subfunction called ProcessConfirmedAcks.
     UpdateHighestValue(packet.m_header.ack);
     ConfirmAck(packet.m_header.highestReceivedAck);
-    for (size_t bitIndex = 0; bitIndex < sizeof(packet.m_header.previousReceivedAcksBitfield); ++bitIndex)
+    for (uint16_t bitIndex = 0; bitIndex < ACK_BITFIELD_SIZE; ++bitIndex)
     {
         if (((1 << bitIndex) & packet.m_header.previousReceivedAcksBitfield) != 0) //IsBitSetAtIndex( size_t idx, size_t bitfield ) { return ( ( 1<<idx ) & bitfield ) != 0 ; }
         {
-            ConfirmAck(packet.m_header.highestReceivedAck - (m_previousHighestReceivedAcksBitfield + 1)); //You're sending in "confirm me as true" for one index of the field?
+            ConfirmAck(packet.m_header.highestReceivedAck - (bitIndex + 1));
         }
     }
-    m_lastRecievedTimeMs = GetCurrentTimeMilliseconds();
+    DetectLostPackets(packet.m_header.highestReceivedAck);
+    m_lastRecievedTimeMs = m_session->GetNetTimeMilliseconds();
+    m_hasUnsentAcks = true;
     if (!IsMyConnection())
     {
         m_state = NetConnection::State::CONFIRMED;
@@ -207,21 +340,130 @@ void NetConnection::ConfirmAck(uint16_t ack)
 {
     //Find the ack bundle.
     AckBundle* correspondingBundle = FindBundle(ack); //Using the bundles[] on NetConnection.
-    if (correspondingBundle != nullptr)
+    if (correspondingBundle != nullptr && correspondingBundle->ack == ack && !correspondingBundle->isConfirmed)
     {
+        correspondingBundle->isConfirmed = true;
         for each (uint16_t id in correspondingBundle->sentReliableIds)
         {
             MarkReliableConfirmed(id); //confirmedIds.push_back() but more logic.
         }
+        if (correspondingBundle->ack == ack && correspondingBundle->snapshotId != NetReplicator::INVALID_SNAPSHOT_ID && m_replicationState && m_session->m_replicator)
+        {
+            m_session->m_replicator->ConfirmSnapshot(*m_replicationState, correspondingBundle->snapshotId);
+            correspondingBundle->snapshotId = NetReplicator::INVALID_SNAPSHOT_ID;
+        }
+        OnPacketAcked(*correspondingBundle);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+float NetConnection::GetPacketLossRate() const
+{
+    uint32_t packetsResolved = m_packetsAcked + m_packetsLost;
+    return (packetsResolved > 0) ? (float)m_packetsLost / (float)packetsResolved : 0.0f;
+}
+
+//-----------------------------------------------------------------------------------
+void NetConnection::RefillSendBudget()
+{
+    double currentTimeMs = m_session->GetNetTimeMilliseconds();
+    double elapsedSeconds = (currentTimeMs - m_lastBudgetRefillTimeMs) / 1000.0;
+    m_lastBudgetRefillTimeMs = currentTimeMs;
+
+    //Don't let an idle connection bank up a huge burst, but always allow at least one full packet.
+    double maxBudget = Max<double>(m_sendRateBytesPerSecond * SEND_BURST_SECONDS, (double)PACKET_MTU);
+    m_sendBudgetBytes = Min<double>(m_sendBudgetBytes + (m_sendRateBytesPerSecond * elapsedSeconds), maxBudget);
+}
+
+//-----------------------------------------------------------------------------------
+void NetConnection::OnPacketAcked(const AckBundle& bundle)
+{
+    double currentTimeMs = m_session->GetNetTimeMilliseconds();
+    ++m_packetsAcked;
+    AddRoundTripSample(currentTimeMs - bundle.sentTimeMs);
+
+    m_deliveryWindowBytes += bundle.packetSize;
+    double windowMs = currentTimeMs - m_deliveryWindowStartMs;
+    if (windowMs >= DELIVERY_RATE_WINDOW_MS)
+    {
+        m_deliveryRateBytesPerSecond = ((double)m_deliveryWindowBytes * 1000.0) / windowMs;
+        m_deliveryWindowBytes = 0;
+        m_deliveryWindowStartMs = currentTimeMs;
+    }
+
+    //Additive increase
+    m_sendRateBytesPerSecond = Min<double>(m_sendRateBytesPerSecond + ADDITIVE_INCREASE_BYTES_PER_ACK, MAX_SEND_RATE_BYTES_PER_SECOND);
+}
+
+//-----------------------------------------------------------------------------------
+void NetConnection::OnPacketLost(const AckBundle& bundle)
+{
+    UNUSED(bundle);
+    double currentTimeMs = m_session->GetNetTimeMilliseconds();
+    ++m_packetsLost;
+
+    //Multiplicative decrease, at most once per round trip so one burst of loss only counts once.
+    if (currentTimeMs - m_lastRateDecreaseTimeMs >= m_rttMs)
+    {
+        m_sendRateBytesPerSecond = Max<double>(m_sendRateBytesPerSecond * MULTIPLICATIVE_DECREASE, MIN_SEND_RATE_BYTES_PER_SECOND);
+        m_lastRateDecreaseTimeMs = currentTimeMs;
+    }
+
+    //Back off resends until a fresh round trip sample says otherwise, once per timeout so a burst doesn't stack up
+    if (currentTimeMs - m_lastRtoBackoffTimeMs >= m_rtoMs)
+    {
+        m_rtoMs = Min<double>(m_rtoMs * 2.0, MAX_RTO_MS);
+        m_lastRtoBackoffTimeMs = currentTimeMs;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void NetConnection::AddRoundTripSample(double sampleMs)
+{
+    if (!m_hasRoundTripSample)
+    {
+        m_rttMs = sampleMs;
+        m_rttVarianceMs = sampleMs * 0.5;
+        m_jitterMs = 0.0;
+        m_hasRoundTripSample = true;
+    }
+    else
+    {
+        m_rttVarianceMs = (0.75 * m_rttVarianceMs) + (0.25 * fabs(m_rttMs - sampleMs));
+        m_rttMs = (0.875 * m_rttMs) + (0.125 * sampleMs);
+        m_jitterMs += (fabs(sampleMs - m_lastRoundTripSampleMs) - m_jitterMs) / 16.0;
+    }
+    m_lastRoundTripSampleMs = sampleMs;
+    m_rtoMs = Clamp<double>(m_rttMs + Max<double>(MIN_RTO_VARIANCE_MS, 4.0 * m_rttVarianceMs), MIN_RTO_MS, MAX_RTO_MS);
+}
+
+//-----------------------------------------------------------------------------------
+void NetConnection::DetectLostPackets(uint16_t remoteHighestReceivedAck)
+{
+    if (remoteHighestReceivedAck == INVALID_PACKET_ACK)
+    {
+        return;
+    }
+    //Anything older than the remote's ack bitfield can't be confirmed anymore, so if it wasn't, it's gone.
+    uint16_t oldestConfirmableAck = remoteHighestReceivedAck - ACK_BITFIELD_SIZE;
+    while ((int16_t)(oldestConfirmableAck - m_nextLossCheckAck) > 0 && m_nextLossCheckAck != m_nextSentAck)
+    {
+        AckBundle* bundle = FindBundle(m_nextLossCheckAck);
+        if (bundle->ack == m_nextLossCheckAck && !bundle->isConfirmed)
+        {
+            bundle->isConfirmed = true;
+            OnPacketLost(*bundle);
+        }
+        ++m_nextLossCheckAck;
     }
 }
 
 //-----------------------------------------------------------------------------------
 bool NetConnection::IsHostConnection()
 {
-    if (NetSession::instance->m_hostConnection)
+    if (m_session->m_hostConnection)
     {
-        return NetSystem::SockaddrCompare(this->m_address, NetSession::instance->m_hostConnection->m_address);
+        return NetSystem::SockaddrCompare(this->m_address, m_session->m_hostConnection->m_address);
     }
     else
     {
@@ -232,7 +474,7 @@ bool NetConnection::IsHostConnection()
 //-----------------------------------------------------------------------------------
 bool NetConnection::IsMyConnection()
 {
-    return NetSystem::SockaddrCompare(this->m_address, NetSession::instance->m_packetChannel.m_socket.m_address);
+    return NetSystem::SockaddrCompare(this->m_address, m_session->GetAddress());
 }
 
 //-----------------------------------------------------------------------------------
@@ -254,18 +496,18 @@ const char* NetConnection::GetStateCstr()
 }
 
 //-----------------------------------------------------------------------------------
-void NetConnection::MarkMessageReceived(const NetMessage& msg)
+void NetConnection::MarkMessageReceived(const NetMessageView& msg)
 {
-    if (msg.IsReliable())
+    if (msg.IsReliable(m_session))
     {
         MarkReliableReceived(msg.m_reliableId);
     }
 }
 
 //-----------------------------------------------------------------------------------
-void NetConnection::ProcessMessage(const NetSender& from, NetMessage& msg)
+void NetConnection::ProcessMessage(const NetSender& from, NetMessageView& msg)
 {
-    if (msg.IsInOrder())
+    if (msg.IsInOrder(m_session))
     {
         ProcessInOrder(from, msg);
     }
@@ -277,7 +519,7 @@ void NetConnection::ProcessMessage(const NetSender& from, NetMessage& msg)
 }
 
 //-----------------------------------------------------------------------------------
-void NetConnection::ProcessInOrder(const NetSender& from, NetMessage& msg)
+void NetConnection::ProcessInOrder(const NetSender& from, NetMessageView& msg)
 {
     if (msg.m_sequenceId == m_nextExpectedReceivedSequenceId)
     {
@@ -285,19 +527,47 @@ void NetConnection::ProcessInOrder(const NetSender& from, NetMessage& msg)
         ++m_nextExpectedReceivedSequenceId;
         while (!m_outOfOrderReceivedSequencedMessages.empty() && m_outOfOrderReceivedSequencedMessages[0]->m_sequenceId == m_nextExpectedReceivedSequenceId)
         {
-            m_outOfOrderReceivedSequencedMessages[0]->Process(from);
-            ++m_nextExpectedReceivedSequenceId;
-            delete m_outOfOrderReceivedSequencedMessages[0];
+            NetMessage* buffered = m_outOfOrderReceivedSequencedMessages[0];
             m_outOfOrderReceivedSequencedMessages.erase(m_outOfOrderReceivedSequencedMessages.begin());
+            buffered->Process(from);
+            ++m_nextExpectedReceivedSequenceId;
+            FreeReceivedMessage(buffered);
         }
     }
     else
     {
-        NetMessage* copy = new NetMessage(msg);
+        //The view dies with its packet, so this is the only received message that gets copied
+        NetMessage* copy = AllocReceivedMessage();
+        copy->CopyFrom(msg);
         AddInOrderOfSequenceId(copy);
     }
 }
 
+//-----------------------------------------------------------------------------------
+NetMessage* NetConnection::AllocReceivedMessage()
+{
+    if (m_freeReceivedMessages.empty())
+    {
+        return new NetMessage();
+    }
+    NetMessage* msg = m_freeReceivedMessages.back();
+    m_freeReceivedMessages.pop_back();
+    return msg;
+}
+
+//-----------------------------------------------------------------------------------
+void NetConnection::FreeReceivedMessage(NetMessage* msg)
+{
+    if (m_freeReceivedMessages.size() < MAX_FREE_RECEIVED_MESSAGES)
+    {
+        m_freeReceivedMessages.push_back(msg);
+    }
+    else
+    {
+        delete msg;
+    }
+}
+
 //-----------------------------------------------------------------------------------
 void NetConnection::AddInOrderOfSequenceId(NetMessage* newMessage)
 {
@@ -315,10 +585,8 @@ void NetConnection::AddInOrderOfSequenceId(NetMessage* newMessage)
 //-----------------------------------------------------------------------------------
 bool NetConnection::IsOld(NetMessage* msg)
 {
-    const float ROUND_TRIP_TIME_MS = 150.0f;
-    const uint32_t OLD_AGE_MS = (uint32_t)((ROUND_TRIP_TIME_MS + (ROUND_TRIP_TIME_MS * 0.1f)) / (ROUND_TRIP_TIME_MS * 0.2f));
-    uint32_t age = (uint32_t)GetCurrentTimeMilliseconds() - msg->m_lastSentTimestampMs;
-    return age > OLD_AGE_MS;
+    uint32_t age = (uint32_t)m_session->GetNetTimeMilliseconds() - msg->m_lastSentTimestampMs;
+    return age > (uint32_t)m_rtoMs;
 }
 
 //-----------------------------------------------------------------------------------
@@ -426,9 +694,9 @@ bool NetConnection::HasReceivedReliable(const uint16_t reliableId)
 }
 
 //-----------------------------------------------------------------------------------
-bool NetConnection::CanProcessMessage(const NetMessage& msg)
+bool NetConnection::CanProcessMessage(const NetMessageView& msg)
 {
-    if (msg.IsReliable())
+    if (msg.IsReliable(m_session))
     {
         return !HasReceivedReliable(msg.m_reliableId);
     }
@@ -495,5 +763,7 @@ NetConnection::AckBundle* NetConnection::CreateBundle(uint16_t ack)
     AckBundle* bundle = &(m_ackBundles[idx]);
     bundle->ack = ack;
     bundle->reliableCount = 0;
+    bundle->sentReliableIds.clear();
+    bundle->snapshotId = NetReplicator::INVALID_SNAPSHOT_ID;
     return bundle;
 }
\ No newline at end of file
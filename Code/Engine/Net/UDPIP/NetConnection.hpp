@@ -10,8 +10,10 @@
 
 class NetSession;
 class NetMessage;
+class NetMessageView;
 class NetPacket;
 struct NetSender;
+struct ReplicationConnectionState;
 
 class NetConnection
 {
@@ -22,9 +24,27 @@ public:
     static const int MAX_ACK_BUNDLES = 64;
     static const int TIMEOUT_TIME_MS = 15000;
     static const int BAD_CONNECTION_TIME_MS = 5000;
+    static const int KEEPALIVE_INTERVAL_MS = 250; //Idle connections still send an empty packet this often so acks and timeouts keep working
     static const int MAX_RELIABLES_PER_PACKET = 32;
     static const uint16_t MAX_RELIABLE_RANGE = 1000;
     static const uint16_t INVALID_PACKET_ACK = 0xFFFF;
+    static const size_t MAX_FREE_RECEIVED_MESSAGES = 32; //Storage kept around for out of order messages instead of going back to the heap
+    static const uint16_t ACK_BITFIELD_SIZE = 16; //Bits in previousReceivedAcksBitfield; an ack older than this can never be confirmed
+
+    //Round trip and resend timing (RFC 6298 style)
+    static const double INITIAL_RTO_MS;
+    static const double MIN_RTO_MS;
+    static const double MAX_RTO_MS;
+    static const double MIN_RTO_VARIANCE_MS;
+
+    //Send rate (token bucket with additive increase, multiplicative decrease)
+    static const double INITIAL_SEND_RATE_BYTES_PER_SECOND;
+    static const double MIN_SEND_RATE_BYTES_PER_SECOND;
+    static const double MAX_SEND_RATE_BYTES_PER_SECOND;
+    static const double ADDITIVE_INCREASE_BYTES_PER_ACK;
+    static const double MULTIPLICATIVE_DECREASE;
+    static const double SEND_BURST_SECONDS;
+    static const double DELIVERY_RATE_WINDOW_MS;
 
     //ENUMS/////////////////////////////////////////////////////////////////////
     enum State
@@ -41,31 +61,40 @@ public:
     // so upon that ack being confirmed, we can do some cleanup
     struct AckBundle
     {
+        AckBundle() : ack(INVALID_PACKET_ACK), reliableCount(0), snapshotId(0xFFFF), sentTimeMs(0.0), packetSize(0), isConfirmed(true) {};
         void AddReliable(uint16_t reliableId);
 
         uint16_t ack;
         uint32_t reliableCount;
         // What reliables were sent with this ack?
         std::vector<uint16_t> sentReliableIds;
+        // Which replication snapshot rode along with this ack, if any
+        uint16_t snapshotId;
+        // For round trip and bandwidth estimates
+        double sentTimeMs;
+        uint16_t packetSize;
+        bool isConfirmed;
     };
 
     struct Info
     {
         sockaddr_in address;
         char m_guid[MAX_GUID_LENGTH];
-        uint8_t index;
+        uint16_t index;
     };
 
     //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
-    NetConnection(uint8_t index, const char* guid, const sockaddr_in& address, NetSession* session);
+    NetConnection(uint16_t index, const char* guid, const sockaddr_in& address, NetSession* session);
     ~NetConnection();
 
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
     void SendMessage(NetMessage& msg);
     void ConstructAndSendPacket();
+    bool HasPendingData(); //Anything worth a packet this tick: messages, resends, acks we owe, a snapshot, or a keepalive
     uint8_t AttachOldReliables(NetPacket& p, AckBundle* ackBundle);
     uint8_t AttachUnsentReliables(NetPacket& p, AckBundle* ab);
     uint8_t AttachUnreliables(NetPacket& p);
+    uint8_t AttachSnapshot(NetPacket& p, AckBundle* ab);
     void UpdateHighestValue(uint16_t newValue);
     void MarkPacketReceived(const NetPacket& packet);
     void ConfirmAck(uint16_t ack);
@@ -73,19 +102,22 @@ public:
     bool IsMyConnection();
     inline bool IsConnected() { return m_state == CONFIRMED || m_state == LOCAL || m_state == BAD; };
     const char* GetStateCstr();
-    void MarkMessageReceived(const NetMessage& msg);
-    void ProcessMessage(const NetSender& from, NetMessage& msg); //Called if we can process a message and will mark the message as recieved
-    void ProcessInOrder(const NetSender& from, NetMessage& msg);
+    void MarkMessageReceived(const NetMessageView& msg);
+    void ProcessMessage(const NetSender& from, NetMessageView& msg); //Called if we can process a message and will mark the message as recieved
+    void ProcessInOrder(const NetSender& from, NetMessageView& msg);
     void AddInOrderOfSequenceId(NetMessage* msg);
+    NetMessage* AllocReceivedMessage();
+    void FreeReceivedMessage(NetMessage* msg);
     bool IsOld(NetMessage* msg);
     AckBundle* CreateBundle(uint16_t ack);
-    bool CanProcessMessage(const NetMessage& msg); // should we process this message (checks controls and records) such as it already being received
+    bool CanProcessMessage(const NetMessageView& msg); // should we process this message (checks controls and records) such as it already being received
     uint16_t GetLastSentAck() { return m_nextSentAck - 1; };
     uint16_t GetMostRecentConfirmedAck() { return m_highestReceivedAck; };
+    float GetPacketLossRate() const;
 
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
     //Identifying info
-    uint8_t m_index;
+    uint16_t m_index;
     sockaddr_in m_address;
     char m_guid[MAX_GUID_LENGTH];
     NetSession* m_session;
@@ -94,6 +126,23 @@ public:
     State m_state;
     double m_lastSentTimeMs;
     double m_lastRecievedTimeMs;
+    bool m_hasUnsentAcks; //Received a packet since we last sent one, so the other end is waiting on our ack
+
+    //Replication info, only valid while the session has a replicator
+    ReplicationConnectionState* m_replicationState;
+
+    //Link statistics, estimated from the ack stream
+    double m_rttMs; //Smoothed round trip
+    double m_rttVarianceMs; //Mean deviation of the round trip
+    double m_jitterMs; //Smoothed difference between consecutive round trip samples
+    double m_rtoMs; //How long a reliable waits for an ack before it's resent
+    double m_sendRateBytesPerSecond; //Congestion-controlled rate the send budget refills at
+    double m_sendBudgetBytes;
+    double m_deliveryRateBytesPerSecond; //Bytes the remote end has confirmed, per second
+    uint32_t m_packetsSent;
+    uint32_t m_packetsAcked;
+    uint32_t m_packetsLost;
+    uint32_t m_bytesSent;
 
 private:
     //PRIVATE FUNCTIONS/////////////////////////////////////////////////////////////////////
@@ -108,6 +157,13 @@ private:
     bool CycleGreaterThanEqual(uint16_t a, uint16_t b);
     AckBundle* FindBundle(uint16_t ack);
 
+    //Link estimation and congestion control
+    void RefillSendBudget();
+    void OnPacketAcked(const AckBundle& bundle);
+    void OnPacketLost(const AckBundle& bundle);
+    void AddRoundTripSample(double sampleMs);
+    void DetectLostPackets(uint16_t remoteHighestReceivedAck);
+
     // recv_side: reliable traffic
     bool HasReceivedReliable(const uint16_t reliableId);	// check if a reliable_id is marked as received
     void MarkReliableReceived(const uint16_t reliableId); 	// after processing a message, mark it as received
@@ -122,6 +178,15 @@ private:
     uint16_t m_nextExpectedAck; // should always be highest_received_ack + 1.
     uint16_t m_highestReceivedAck; // so there's no real need for both
     uint16_t m_previousHighestReceivedAcksBitfield; // bitfield of previous received acks
+    //congestion control
+    uint16_t m_nextLossCheckAck; // oldest sent ack we haven't decided was delivered or lost
+    bool m_hasRoundTripSample;
+    double m_lastRoundTripSampleMs;
+    double m_lastBudgetRefillTimeMs;
+    double m_lastRateDecreaseTimeMs;
+    double m_lastRtoBackoffTimeMs;
+    double m_deliveryWindowStartMs;
+    uint32_t m_deliveryWindowBytes;
 
     //Messages
     std::vector<NetMessage*> m_unreliables;
@@ -144,4 +209,5 @@ private:
     //Receiving InOrder
     uint16_t m_nextExpectedReceivedSequenceId;
     std::vector<NetMessage*> m_outOfOrderReceivedSequencedMessages;
+    std::vector<NetMessage*> m_freeReceivedMessages;
 };
\ No newline at end of file
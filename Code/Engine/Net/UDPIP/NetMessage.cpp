@@ -4,7 +4,8 @@
 //-----------------------------------------------------------------------------------
 size_t NetMessage::GetHeaderSize() const
 {
-    return sizeof(uint8_t) + sizeof(uint16_t);
+    //type, reliableId, sequenceId
+    return sizeof(uint8_t) + sizeof(uint16_t) + sizeof(uint16_t);
 }
 
 //-----------------------------------------------------------------------------------
@@ -16,33 +17,103 @@ size_t NetMessage::GetPayloadSize() const
 //-----------------------------------------------------------------------------------
 void NetMessage::Process(const NetSender& from)
 {
-    const NetMessageDefinition* messageDef = NetSession::instance->FindDefinition(m_type);
+    const NetMessageDefinition* messageDef = from.session->FindDefinition(m_type);
     if (messageDef != nullptr)
     {
-        messageDef->callbackFunction(from, *this);
+        NetMessageView view(*this);
+        messageDef->callbackFunction(from, view);
     }
 }
 
 //-----------------------------------------------------------------------------------
-bool NetMessage::IsReliable() const
+bool NetMessage::IsReliable(const NetSession* session) const
+{
+    return GetDefinition(session)->HasOptionFlag(Option::RELIABLE);
+}
+
+//-----------------------------------------------------------------------------------
+const NetMessageDefinition* NetMessage::GetDefinition(const NetSession* session) const
+{
+    return session->FindDefinition(m_type);
+}
+
+//-----------------------------------------------------------------------------------
+bool NetMessage::RequiresConnection(const NetSession* session) const
+{
+    return !GetDefinition(session)->HasControlFlag(NetMessage::Control::PROCESS_CONNECTIONLESS);
+}
+
+//-----------------------------------------------------------------------------------
+bool NetMessage::IsInOrder(const NetSession* session)
+{
+    return GetDefinition(session)->HasOptionFlag(Option::INORDER);
+}
+
+
+//-----------------------------------------------------------------------------------
+void NetMessage::CopyFrom(const NetMessageView& view)
+{
+    size_t payloadSize = view.GetPayloadSize();
+    m_type = view.m_type;
+    m_reliableId = view.m_reliableId;
+    m_sequenceId = view.m_sequenceId;
+    m_lastSentTimestampMs = 0;
+    m_writeSizeMax = MESSAGE_MTU;
+    SetReadableBytes(payloadSize);
+    memcpy(m_msgBuffer, view.m_buffer, payloadSize);
+}
+
+//-----------------------------------------------------------------------------------
+void NetMessageView::SetPayload(const void* payload, size_t payloadSize)
 {
-    return GetDefinition()->HasOptionFlag(Option::RELIABLE);
+    m_buffer = (void*)payload;
+    m_writeSizeMax = 0;
+    SetReadableBytes(payloadSize);
 }
 
 //-----------------------------------------------------------------------------------
-const NetMessageDefinition* NetMessage::GetDefinition() const
+size_t NetMessageView::GetHeaderSize() const
 {
-    return NetSession::instance->FindDefinition(m_type);
+    //type, reliableId, sequenceId
+    return sizeof(uint8_t) + sizeof(uint16_t) + sizeof(uint16_t);
 }
 
 //-----------------------------------------------------------------------------------
-bool NetMessage::RequiresConnection() const
+size_t NetMessageView::GetPayloadSize() const
 {
-    return !GetDefinition()->HasControlFlag(NetMessage::Control::PROCESS_CONNECTIONLESS);
+    return GetReadableBytes();
 }
 
 //-----------------------------------------------------------------------------------
-bool NetMessage::IsInOrder()
+void NetMessageView::Process(const NetSender& from)
 {
-    return GetDefinition()->HasOptionFlag(Option::INORDER);
+    const NetMessageDefinition* messageDef = from.session->FindDefinition(m_type);
+    if (messageDef != nullptr)
+    {
+        messageDef->callbackFunction(from, *this);
+    }
 }
+
+//-----------------------------------------------------------------------------------
+bool NetMessageView::IsReliable(const NetSession* session) const
+{
+    return GetDefinition(session)->HasOptionFlag(NetMessage::Option::RELIABLE);
+}
+
+//-----------------------------------------------------------------------------------
+const NetMessageDefinition* NetMessageView::GetDefinition(const NetSession* session) const
+{
+    return session->FindDefinition(m_type);
+}
+
+//-----------------------------------------------------------------------------------
+bool NetMessageView::RequiresConnection(const NetSession* session) const
+{
+    return !GetDefinition(session)->HasControlFlag(NetMessage::Control::PROCESS_CONNECTIONLESS);
+}
+
+//-----------------------------------------------------------------------------------
+bool NetMessageView::IsInOrder(const NetSession* session) const
+{
+    return GetDefinition(session)->HasOptionFlag(NetMessage::Option::INORDER);
+}
\ No newline at end of file
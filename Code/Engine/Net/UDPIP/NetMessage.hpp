@@ -4,7 +4,9 @@
 
 typedef unsigned char byte;
 struct NetSender; 
+class NetSession;
 struct NetMessageDefinition;
+class NetMessageView;
 
 #define MESSAGE_MTU 1024
 #define BIT_FLAG(f) (1 << (f))
@@ -26,6 +28,7 @@ public:
         CONNECTION_LEAVE,
         KICK,
         QUIT,
+        SNAPSHOT,
         NUM_MESSAGES
 
     };
@@ -83,13 +86,14 @@ public:
     }
 
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void CopyFrom(const NetMessageView& view); //Only used to hold onto a received message past its packet
     size_t GetHeaderSize() const;
     size_t GetPayloadSize() const;
     void Process(const NetSender& from);
-    bool IsReliable() const;
-    const NetMessageDefinition* GetDefinition() const;
-    bool RequiresConnection() const;
-    bool IsInOrder();
+    bool IsReliable(const NetSession* session) const;
+    const NetMessageDefinition* GetDefinition(const NetSession* session) const;
+    bool RequiresConnection(const NetSession* session) const;
+    bool IsInOrder(const NetSession* session);
 
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
     byte m_type;
@@ -99,4 +103,44 @@ public:
     // If reliable, time since this was last attempted to be sent
     uint32_t m_lastSentTimestampMs;
     byte m_msgBuffer[MESSAGE_MTU];
+};
+
+//-----------------------------------------------------------------------------------
+// A received message read straight out of the packet it arrived in. Nothing is copied,
+// so a view is only good until its packet is reused; anything that has to outlive that
+// (out of order messages waiting on their sequence) gets copied into a NetMessage.
+class NetMessageView : public BytePacker
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    NetMessageView()
+        : BytePacker(nullptr, 0, 0, IBinaryReader::BIG_ENDIAN)
+        , m_type(0)
+        , m_reliableId(0)
+        , m_sequenceId(0)
+    {
+    };
+
+    NetMessageView(const NetMessage& msg)
+        : BytePacker((void*)msg.m_msgBuffer, 0, msg.GetReadableBytes(), IBinaryReader::BIG_ENDIAN)
+        , m_type(msg.m_type)
+        , m_reliableId(msg.m_reliableId)
+        , m_sequenceId(msg.m_sequenceId)
+    {
+    };
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void SetPayload(const void* payload, size_t payloadSize);
+    size_t GetHeaderSize() const;
+    size_t GetPayloadSize() const;
+    void Process(const NetSender& from);
+    bool IsReliable(const NetSession* session) const;
+    const NetMessageDefinition* GetDefinition(const NetSession* session) const;
+    bool RequiresConnection(const NetSession* session) const;
+    bool IsInOrder(const NetSession* session) const;
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    byte m_type;
+    uint16_t m_reliableId;
+    uint16_t m_sequenceId;
 };
\ No newline at end of file
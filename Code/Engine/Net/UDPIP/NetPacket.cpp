@@ -5,7 +5,7 @@
 //-----------------------------------------------------------------------------------
 void NetPacket::WriteHeader()
 {
-    Write<uint8_t>(m_header.fromConnectionIndex);
+    Write<uint16_t>(m_header.fromConnectionIndex);
     m_msgCountBookmark = Reserve<uint8_t>(m_header.messageCount);
     Write<uint16_t>(m_header.ack);
     Write<uint16_t>(m_header.highestReceivedAck);
@@ -15,7 +15,7 @@ void NetPacket::WriteHeader()
 //-----------------------------------------------------------------------------------
 void NetPacket::ReadHeader()
 {
-    Read<uint8_t>(m_header.fromConnectionIndex);
+    Read<uint16_t>(m_header.fromConnectionIndex);
     Read<uint8_t>(m_header.messageCount);
     Read<uint16_t>(m_header.ack);
     Read<uint16_t>(m_header.highestReceivedAck);
@@ -39,15 +39,13 @@ size_t NetPacket::WriteMessage(NetMessage* msg)
 {
 #pragma todo("Replace the other redundant functions once you're not on fire")
 
-    const NetMessageDefinition* definition = NetSession::instance->FindDefinition(msg->m_type);
-
     size_t messageSize = msg->GetHeaderSize() + msg->GetPayloadSize();
     size_t total = messageSize + sizeof(uint16_t);
     if (GetWritableBytes() >= total)
     {
         //Can write!
         Write<uint16_t>((const uint16_t)messageSize);
-        Write<uint8_t>((const uint8_t)definition->id);
+        Write<uint8_t>(msg->m_type);
         Write<uint16_t>(msg->m_reliableId);
         Write<uint16_t>(msg->m_sequenceId);
         WriteBytes(msg->m_buffer, msg->GetPayloadSize());
@@ -77,9 +75,8 @@ size_t NetPacket::WriteMessages(NetMessage** messages, size_t count)
     for (size_t i = 0; i < numMessagesCanFit; ++i)
     {
         NetMessage* message = messages[i];
-        const NetMessageDefinition* definition = NetSession::instance->FindDefinition(message->m_type);
         Write<uint16_t>((const uint16_t)(message->GetHeaderSize() + message->GetPayloadSize()));
-        Write<uint8_t>(definition->id);
+        Write<uint8_t>(message->m_type);
         Write<uint16_t>(message->m_reliableId);
         Write<uint16_t>(message->m_sequenceId);
         WriteBytes(message->m_buffer, message->GetPayloadSize());
@@ -94,15 +91,13 @@ void NetPacket::WriteMessageAndFinalize(const NetMessage& message)
     m_header.messageCount = 1;
     WriteHeader();
 
-    const NetMessageDefinition* definition = NetSession::instance->FindDefinition(message.m_type);
-
     size_t messageSize = message.GetHeaderSize() + message.GetPayloadSize();
     size_t total = messageSize + sizeof(uint16_t);
     if (GetWritableBytes() >= total)
     {
         //Can write!
         Write<uint16_t>((const uint16_t)messageSize);
-        Write<uint8_t>((const uint8_t)definition->id);
+        Write<uint8_t>(message.m_type);
         Write<uint16_t>(message.m_reliableId);
         Write<uint16_t>(message.m_sequenceId);
         WriteBytes(message.m_buffer, message.GetPayloadSize());
@@ -128,9 +123,8 @@ size_t NetPacket::WriteMessagesAndFinalize(NetMessage** messages, size_t count)
     for (size_t i = 0; i < numMessagesCanFit; ++i)
     {
         NetMessage* message = messages[i];
-        const NetMessageDefinition* definition = NetSession::instance->FindDefinition(message->m_type);
         Write<uint16_t>((const uint16_t)(message->GetHeaderSize() + message->GetPayloadSize()));
-        Write<uint8_t>(definition->id);
+        Write<uint8_t>(message->m_type);
         Write<uint16_t>(message->m_reliableId);
         Write<uint16_t>(message->m_sequenceId);
         WriteBytes(message->m_buffer, message->GetPayloadSize());
@@ -166,4 +160,24 @@ void NetPacket::ReadMessage(NetMessage& outMessage)
     ReadBytes(outMessage.m_msgBuffer, msgSize - outMessage.GetHeaderSize());
 }
 
+//-----------------------------------------------------------------------------------
+bool NetPacket::ReadMessageView(NetMessageView& outView)
+{
+    //Read message size and verify, the view is going to point straight into our buffer
+    uint16_t msgSize;
+    Read<uint16_t>(msgSize);
+    if (msgSize > MESSAGE_MTU || msgSize < outView.GetHeaderSize() || msgSize > m_readSizeMax)
+    {
+        LogPrintf(LogLevel::WARNING, "Invalid Packet thrown out.");
+        return false;
+    }
 
+    size_t payloadSize = msgSize - outView.GetHeaderSize();
+    Read<uint8_t>(outView.m_type);
+    Read<uint16_t>(outView.m_reliableId);
+    Read<uint16_t>(outView.m_sequenceId);
+    outView.SetPayload(GetHead(), payloadSize);
+    Advance(payloadSize);
+    m_readSizeMax -= payloadSize;
+    return true;
+}
\ No newline at end of file
@@ -16,10 +16,10 @@ public:
     {
         //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
         Header() : fromConnectionIndex(INVALID_CONNECTION_INDEX), messageCount(0) {};
-        Header(uint8_t connectionIndex = INVALID_CONNECTION_INDEX) : fromConnectionIndex(connectionIndex), messageCount(0) {};
+        Header(uint16_t connectionIndex = INVALID_CONNECTION_INDEX) : fromConnectionIndex(connectionIndex), messageCount(0) {};
 
         //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
-        uint8_t fromConnectionIndex;
+        uint16_t fromConnectionIndex;
         uint16_t ack;
         uint16_t highestReceivedAck;
         uint16_t previousReceivedAcksBitfield;
@@ -27,7 +27,7 @@ public:
     };
 
     //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
-    NetPacket(uint8_t connectionIndex = 0)
+    NetPacket(uint16_t connectionIndex = 0)
         : BytePacker(m_buffer, PACKET_MTU, 0, IBinaryReader::BIG_ENDIAN)
         , m_header(connectionIndex)
     {
@@ -43,11 +43,15 @@ public:
     size_t WriteMessagesAndFinalize(NetMessage** messages, size_t count);
     void ReadMessage(NetMessage& outMessage);
     NetMessage ReadMessage();
+    bool ReadMessageView(NetMessageView& outView); //Points the view into m_buffer, no payload copy
     bool CanWrite(NetMessage* msg);
     uint8_t* GetMessageCountBookmark();
 
     //CONSTANTS/////////////////////////////////////////////////////////////////////
-    static const uint8_t INVALID_CONNECTION_INDEX = 255;
+    static const uint16_t INVALID_CONNECTION_INDEX = 0xFFFF;
+    // Leading byte of a compressed packet, in place of the high byte of the sender's connection index.
+    // Safe as long as connection indices stay below 0xFE00 (see NetSession::MAX_SUPPORTED_CONNECTIONS).
+    static const uint8_t COMPRESSED_PACKET_MARKER = 254;
 
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
     byte m_buffer[PACKET_MTU];
@@ -0,0 +1,963 @@
+#include "Engine/Net/UDPIP/NetReplicator.hpp"
+#include "Engine/Net/UDPIP/NetMessage.hpp"
+#include "Engine/Net/UDPIP/NetConnection.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Input/Logging.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Time/Time.hpp"
+#include <algorithm>
+
+//-----------------------------------------------------------------------------------
+uint8_t ReplicationSchema::AddField(const char* name, uint16_t size)
+{
+    ASSERT_OR_DIE(m_fields.size() < MAX_FIELDS, "Replication schemas are limited to 32 fields, the changed-field mask is a uint32_t");
+    ReplicationField field;
+    field.name = name;
+    field.offset = m_stateSize;
+    field.size = size;
+    m_fields.push_back(field);
+    m_stateSize += size;
+    return (uint8_t)(m_fields.size() - 1);
+}
+
+//-----------------------------------------------------------------------------------
+ReplicatedObject::ReplicatedObject(uint16_t id, const ReplicationSchema* objectSchema)
+    : netId(id)
+    , schema(objectSchema)
+    , state(new byte[objectSchema->m_stateSize]())
+    , basePriority(1.0f)
+    , userData(nullptr)
+{
+}
+
+//-----------------------------------------------------------------------------------
+ReplicatedObject::~ReplicatedObject()
+{
+    delete[] state;
+}
+
+//-----------------------------------------------------------------------------------
+ReplicationConnectionState::ReplicationConnectionState(NetConnection* owner)
+    : m_connection(owner)
+    , m_userData(nullptr)
+    , m_byteBudget(DEFAULT_BYTE_BUDGET)
+    , m_nextSnapshotId(0)
+    , m_records(NetReplicator::MAX_REPLICATED_OBJECTS)
+    , m_totalBytesSent(0)
+    , m_snapshotsSent(0)
+    , m_snapshotsConfirmed(0)
+    , m_fullObjectsSent(0)
+    , m_deltaObjectsSent(0)
+    , m_objectsDeferred(0)
+{
+}
+
+//-----------------------------------------------------------------------------------
+NetReplicator::NetReplicator()
+    : m_interestFunction(nullptr)
+    , m_numObjects(0)
+    , m_numRemoteObjects(0)
+    , m_snapshotsReceived(0)
+    , m_missingBaselines(0)
+{
+    for (uint16_t i = 0; i < MAX_REPLICATED_OBJECTS; ++i)
+    {
+        m_objects[i] = nullptr;
+        m_remoteObjects[i] = nullptr;
+        m_freeNetIds.push_back(i);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+NetReplicator::~NetReplicator()
+{
+    for (uint16_t i = 0; i < MAX_REPLICATED_OBJECTS; ++i)
+    {
+        delete m_objects[i];
+        delete m_remoteObjects[i];
+    }
+    for (ReplicationConnectionState* connectionState : m_connectionStates)
+    {
+        if (connectionState->m_connection)
+        {
+            connectionState->m_connection->m_replicationState = nullptr;
+        }
+        delete connectionState;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+ReplicationSchema* NetReplicator::RegisterSchema(uint8_t schemaId, const char* name)
+{
+    ReplicationSchema* schema = &m_schemas[schemaId];
+    ASSERT_OR_DIE(schema->m_name == nullptr, "Attempted to overwrite an existing replication schema");
+    schema->m_id = schemaId;
+    schema->m_name = name;
+    return schema;
+}
+
+//-----------------------------------------------------------------------------------
+const ReplicationSchema* NetReplicator::FindSchema(uint8_t schemaId) const
+{
+    const ReplicationSchema* schema = &m_schemas[schemaId];
+    return (schema->m_name != nullptr) ? schema : nullptr;
+}
+
+//-----------------------------------------------------------------------------------
+ReplicatedObject* NetReplicator::CreateObject(uint8_t schemaId, float basePriority, void* userData)
+{
+    const ReplicationSchema* schema = FindSchema(schemaId);
+    ASSERT_OR_DIE(schema != nullptr, "Attempted to create a replicated object from an unregistered schema");
+    if (m_freeNetIds.empty())
+    {
+        ERROR_RECOVERABLE("Ran out of replicated object ids");
+        return nullptr;
+    }
+
+    uint16_t netId = m_freeNetIds.front();
+    m_freeNetIds.pop_front();
+
+    ReplicatedObject* object = new ReplicatedObject(netId, schema);
+    object->basePriority = basePriority;
+    object->userData = userData;
+    m_objects[netId] = object;
+    ++m_numObjects;
+    return object;
+}
+
+//-----------------------------------------------------------------------------------
+void NetReplicator::DestroyObject(uint16_t netId)
+{
+    if (netId >= MAX_REPLICATED_OBJECTS || m_objects[netId] == nullptr)
+    {
+        return;
+    }
+
+    //Anyone who has heard of this object needs to be told it's gone before the id can mean something else to them.
+    for (ReplicationConnectionState* connectionState : m_connectionStates)
+    {
+        ReplicationConnectionState::ObjectRecord& record = connectionState->m_records[netId];
+        bool wasSent = record.hasBeenSent;
+        record = ReplicationConnectionState::ObjectRecord();
+        if (wasSent)
+        {
+            record.isPendingDestroy = true;
+            connectionState->m_pendingDestroys.push_back(netId);
+        }
+    }
+
+    delete m_objects[netId];
+    m_objects[netId] = nullptr;
+    m_freeNetIds.push_back(netId);
+    --m_numObjects;
+}
+
+//-----------------------------------------------------------------------------------
+ReplicatedObject* NetReplicator::GetObject(uint16_t netId)
+{
+    return (netId < MAX_REPLICATED_OBJECTS) ? m_objects[netId] : nullptr;
+}
+
+//-----------------------------------------------------------------------------------
+ReplicatedObject* NetReplicator::GetRemoteObject(uint16_t netId)
+{
+    return (netId < MAX_REPLICATED_OBJECTS) ? m_remoteObjects[netId] : nullptr;
+}
+
+//-----------------------------------------------------------------------------------
+ReplicationConnectionState* NetReplicator::CreateConnectionState(NetConnection* connection)
+{
+    ReplicationConnectionState* connectionState = new ReplicationConnectionState(connection);
+    m_connectionStates.push_back(connectionState);
+    return connectionState;
+}
+
+//-----------------------------------------------------------------------------------
+void NetReplicator::DestroyConnectionState(ReplicationConnectionState* connectionState)
+{
+    auto iter = std::find(m_connectionStates.begin(), m_connectionStates.end(), connectionState);
+    if (iter != m_connectionStates.end())
+    {
+        m_connectionStates.erase(iter);
+    }
+    delete connectionState;
+}
+
+//-----------------------------------------------------------------------------------
+bool NetReplicator::HasDataFor(const ReplicationConnectionState& connectionState) const
+{
+    if (!connectionState.m_pendingDestroys.empty())
+    {
+        return true;
+    }
+
+    //Only worth a snapshot if some relevant object isn't settled on this connection yet.
+    for (uint16_t netId = 0; netId < MAX_REPLICATED_OBJECTS; ++netId)
+    {
+        const ReplicatedObject* object = m_objects[netId];
+        if (object == nullptr)
+        {
+            continue;
+        }
+        if (IsAcknowledged(*object, connectionState.m_records[netId]))
+        {
+            continue;
+        }
+        float relevance = m_interestFunction ? m_interestFunction(connectionState, *object) : object->basePriority;
+        if (relevance > 0.0f)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//-----------------------------------------------------------------------------------
+// True once the remote end is known to hold the object's current state and nothing different is still in flight
+// to overwrite it: the current state matches the acknowledged baseline, and every send since that baseline carried it too.
+bool NetReplicator::IsAcknowledged(const ReplicatedObject& object, const ReplicationConnectionState::ObjectRecord& record) const
+{
+    if (!record.hasBaseline)
+    {
+        return false;
+    }
+    size_t stateSize = object.schema->m_stateSize;
+    if (memcmp(object.state, record.baselineState.data(), stateSize) != 0 || memcmp(object.state, record.lastSentState.data(), stateSize) != 0)
+    {
+        return false;
+    }
+    return !IsSnapshotNewer(record.sentStateSinceSnapshotId, record.baselineSnapshotId);
+}
+
+//-----------------------------------------------------------------------------------
+// Snapshot layout:
+//   uint16 snapshotId, uint16 entryCount, then per entry: uint16 netId, uint8 entryType and
+//   FULL:    uint8 schemaId, every field
+//   DELTA:   uint8 baselineAge (snapshots back from this one), changed-field mask bytes, changed fields
+//   DESTROY: nothing else
+uint16_t NetReplicator::WriteSnapshot(ReplicationConnectionState& connectionState, NetMessage& msg, size_t byteBudget)
+{
+    const size_t SNAPSHOT_HEADER_SIZE = sizeof(uint16_t) + sizeof(uint16_t);
+    const size_t ENTRY_HEADER_SIZE = sizeof(uint16_t) + sizeof(uint8_t);
+    const size_t SMALLEST_ENTRY_SIZE = ENTRY_HEADER_SIZE + sizeof(uint8_t) + 1;
+
+    byteBudget = Min(Min(byteBudget, connectionState.m_byteBudget), msg.GetWritableBytes());
+    if (byteBudget < SNAPSHOT_HEADER_SIZE)
+    {
+        return INVALID_SNAPSHOT_ID;
+    }
+
+    uint16_t snapshotId = connectionState.m_nextSnapshotId++;
+    if (snapshotId == INVALID_SNAPSHOT_ID)
+    {
+        snapshotId = connectionState.m_nextSnapshotId++;
+    }
+
+    ReplicationConnectionState::SentSnapshot& sentSnapshot = connectionState.m_sentSnapshots[snapshotId % ReplicationConnectionState::SNAPSHOT_HISTORY_SIZE];
+    sentSnapshot.snapshotId = snapshotId;
+    sentSnapshot.isValid = true;
+    sentSnapshot.netIds.clear();
+    sentSnapshot.stateOffsets.clear();
+    sentSnapshot.states.clear();
+    sentSnapshot.destroyedNetIds.clear();
+
+    msg.Write<uint16_t>(snapshotId);
+    byte* entryCountBookmark = (byte*)msg.Reserve<uint16_t>(0);
+    size_t bytesUsed = SNAPSHOT_HEADER_SIZE;
+    uint16_t numEntries = 0;
+
+    //Destroys go first, they're tiny and the remote end is holding onto stale objects until they land.
+    for (uint16_t netId : connectionState.m_pendingDestroys)
+    {
+        if (bytesUsed + ENTRY_HEADER_SIZE > byteBudget)
+        {
+            break;
+        }
+        msg.Write<uint16_t>(netId);
+        msg.Write<uint8_t>(ENTRY_DESTROY);
+        sentSnapshot.destroyedNetIds.push_back(netId);
+        bytesUsed += ENTRY_HEADER_SIZE;
+        ++numEntries;
+    }
+
+    //Gather everything relevant to this connection, highest accumulated priority first.
+    m_candidates.clear();
+    for (uint16_t netId = 0; netId < MAX_REPLICATED_OBJECTS; ++netId)
+    {
+        ReplicatedObject* object = m_objects[netId];
+        if (object == nullptr)
+        {
+            continue;
+        }
+        ReplicationConnectionState::ObjectRecord& record = connectionState.m_records[netId];
+        if (record.isPendingDestroy)
+        {
+            continue;
+        }
+        float relevance = m_interestFunction ? m_interestFunction(connectionState, *object) : object->basePriority;
+        if (relevance <= 0.0f)
+        {
+            continue;
+        }
+        record.priorityAccumulator += relevance;
+        PriorityCandidate candidate;
+        candidate.priority = record.priorityAccumulator;
+        candidate.netId = netId;
+        m_candidates.push_back(candidate);
+    }
+    std::sort(m_candidates.begin(), m_candidates.end());
+
+    for (const PriorityCandidate& candidate : m_candidates)
+    {
+        ReplicatedObject* object = m_objects[candidate.netId];
+        ReplicationConnectionState::ObjectRecord& record = connectionState.m_records[candidate.netId];
+        if (IsAcknowledged(*object, record))
+        {
+            //The client already has exactly this, however old the baseline is, so it never costs bytes.
+            record.priorityAccumulator = 0.0f;
+            continue;
+        }
+        if (bytesUsed + SMALLEST_ENTRY_SIZE > byteBudget)
+        {
+            connectionState.m_objectsDeferred += 1;
+            continue;
+        }
+
+        const ReplicationSchema& schema = *object->schema;
+        uint16_t baselineAge = snapshotId - record.baselineSnapshotId;
+        bool canDelta = record.hasBaseline && baselineAge < BASELINE_WINDOW;
+
+        size_t entrySize = 0;
+        if (canDelta)
+        {
+            uint32_t changedFields = CalculateChangedFields(schema, object->state, record.baselineState.data());
+            entrySize = ENTRY_HEADER_SIZE + sizeof(uint8_t) + schema.GetMaskSize() + CalculateDeltaSize(schema, changedFields);
+            if (bytesUsed + entrySize > byteBudget)
+            {
+                ++connectionState.m_objectsDeferred;
+                continue;
+            }
+
+            msg.Write<uint16_t>(candidate.netId);
+            msg.Write<uint8_t>(ENTRY_DELTA);
+            msg.Write<uint8_t>((uint8_t)baselineAge);
+            for (size_t maskByte = 0; maskByte < schema.GetMaskSize(); ++maskByte)
+            {
+                msg.Write<uint8_t>((uint8_t)(changedFields >> (maskByte * 8)));
+            }
+            for (uint8_t fieldIndex = 0; fieldIndex < schema.GetNumFields(); ++fieldIndex)
+            {
+                if ((changedFields & (1u << fieldIndex)) != 0)
+                {
+                    WriteField(msg, schema.m_fields[fieldIndex], object->state);
+                }
+            }
+            ++connectionState.m_deltaObjectsSent;
+        }
+        else
+        {
+            entrySize = ENTRY_HEADER_SIZE + sizeof(uint8_t) + schema.m_stateSize;
+            if (bytesUsed + entrySize > byteBudget)
+            {
+                ++connectionState.m_objectsDeferred;
+                continue;
+            }
+
+            msg.Write<uint16_t>(candidate.netId);
+            msg.Write<uint8_t>(ENTRY_FULL);
+            msg.Write<uint8_t>(schema.m_id);
+            for (const ReplicationField& field : schema.m_fields)
+            {
+                WriteField(msg, field, object->state);
+            }
+            ++connectionState.m_fullObjectsSent;
+        }
+
+        bytesUsed += entrySize;
+        ++numEntries;
+        record.priorityAccumulator = 0.0f;
+        record.lastSentSnapshotId = snapshotId;
+        if (!record.hasBeenSent || memcmp(object->state, record.lastSentState.data(), schema.m_stateSize) != 0)
+        {
+            record.lastSentState.assign(object->state, object->state + schema.m_stateSize);
+            record.sentStateSinceSnapshotId = snapshotId;
+        }
+        record.hasBeenSent = true;
+        RecordSentObject(sentSnapshot, *object);
+    }
+
+    //Reserve wrote through the endian swap, so patch the count in the message's (big endian) byte order by hand.
+    entryCountBookmark[0] = (byte)(numEntries >> 8);
+    entryCountBookmark[1] = (byte)(numEntries & 0xFF);
+
+    connectionState.m_totalBytesSent += bytesUsed;
+    ++connectionState.m_snapshotsSent;
+    return snapshotId;
+}
+
+//-----------------------------------------------------------------------------------
+void NetReplicator::ConfirmSnapshot(ReplicationConnectionState& connectionState, uint16_t snapshotId)
+{
+    if (snapshotId == INVALID_SNAPSHOT_ID)
+    {
+        return;
+    }
+    ReplicationConnectionState::SentSnapshot& sentSnapshot = connectionState.m_sentSnapshots[snapshotId % ReplicationConnectionState::SNAPSHOT_HISTORY_SIZE];
+    if (!sentSnapshot.isValid || sentSnapshot.snapshotId != snapshotId)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < sentSnapshot.netIds.size(); ++i)
+    {
+        uint16_t netId = sentSnapshot.netIds[i];
+        ReplicatedObject* object = m_objects[netId];
+        ReplicationConnectionState::ObjectRecord& record = connectionState.m_records[netId];
+        if (object == nullptr || record.isPendingDestroy)
+        {
+            continue;
+        }
+        size_t stateSize = object->schema->m_stateSize;
+        size_t sentSize = ((i + 1 < sentSnapshot.stateOffsets.size()) ? sentSnapshot.stateOffsets[i + 1] : sentSnapshot.states.size()) - sentSnapshot.stateOffsets[i];
+        if (sentSize != stateSize)
+        {
+            continue; //The id was recycled into a different kind of object since this went out.
+        }
+        if (!record.hasBaseline || IsSnapshotNewer(snapshotId, record.baselineSnapshotId))
+        {
+            const byte* sentState = sentSnapshot.states.data() + sentSnapshot.stateOffsets[i];
+            record.baselineState.assign(sentState, sentState + stateSize);
+            record.baselineSnapshotId = snapshotId;
+            record.hasBaseline = true;
+        }
+    }
+
+    for (uint16_t netId : sentSnapshot.destroyedNetIds)
+    {
+        connectionState.m_records[netId].isPendingDestroy = false;
+        auto iter = std::find(connectionState.m_pendingDestroys.begin(), connectionState.m_pendingDestroys.end(), netId);
+        if (iter != connectionState.m_pendingDestroys.end())
+        {
+            connectionState.m_pendingDestroys.erase(iter);
+        }
+    }
+
+    sentSnapshot.isValid = false;
+    ++connectionState.m_snapshotsConfirmed;
+}
+
+//-----------------------------------------------------------------------------------
+void NetReplicator::ReadSnapshot(NetMessageView& msg)
+{
+    uint16_t snapshotId = INVALID_SNAPSHOT_ID;
+    uint16_t numEntries = 0;
+    msg.Read<uint16_t>(snapshotId);
+    msg.Read<uint16_t>(numEntries);
+    ++m_snapshotsReceived;
+
+    std::vector<byte> scratchState;
+    for (uint16_t entryIndex = 0; entryIndex < numEntries; ++entryIndex)
+    {
+        uint16_t netId = 0;
+        uint8_t entryType = NUM_ENTRY_TYPES;
+        msg.Read<uint16_t>(netId);
+        msg.Read<uint8_t>(entryType);
+        if (netId >= MAX_REPLICATED_OBJECTS)
+        {
+            LogPrintf(LogLevel::WARNING, "Snapshot %i referenced an out of range object id %i, dropping the rest of it.", snapshotId, netId);
+            return;
+        }
+
+        if (entryType == ENTRY_DESTROY)
+        {
+            DestroyRemoteObject(snapshotId, netId);
+        }
+        else if (entryType == ENTRY_FULL)
+        {
+            uint8_t schemaId = 0;
+            msg.Read<uint8_t>(schemaId);
+            const ReplicationSchema* schema = FindSchema(schemaId);
+            if (schema == nullptr)
+            {
+                LogPrintf(LogLevel::WARNING, "Snapshot %i referenced unknown schema %i, dropping the rest of it.", snapshotId, schemaId);
+                return;
+            }
+            scratchState.resize(schema->m_stateSize);
+            for (const ReplicationField& field : schema->m_fields)
+            {
+                ReadField(msg, field, scratchState.data());
+            }
+            ApplyRemoteState(snapshotId, netId, *schema, scratchState.data());
+        }
+        else if (entryType == ENTRY_DELTA)
+        {
+            uint8_t baselineAge = 0;
+            msg.Read<uint8_t>(baselineAge);
+            ReplicatedObject* object = m_remoteObjects[netId];
+            if (object == nullptr)
+            {
+                //Without the object we don't know its schema, so there's no way to find where this entry ends.
+                LogPrintf(LogLevel::WARNING, "Snapshot %i has a delta for unknown object %i, dropping the rest of it.", snapshotId, netId);
+                return;
+            }
+            const ReplicationSchema& schema = *object->schema;
+            uint32_t changedFields = 0;
+            for (size_t maskByte = 0; maskByte < schema.GetMaskSize(); ++maskByte)
+            {
+                uint8_t maskBits = 0;
+                msg.Read<uint8_t>(maskBits);
+                changedFields |= ((uint32_t)maskBits << (maskByte * 8));
+            }
+
+            RemoteObjectHistory& history = m_remoteHistory[netId];
+            uint16_t baselineId = snapshotId - baselineAge;
+            uint16_t baselineSlot = baselineId % BASELINE_WINDOW;
+            bool hasBaseline = history.snapshotIds[baselineSlot] == baselineId;
+
+            scratchState.resize(schema.m_stateSize);
+            if (hasBaseline)
+            {
+                memcpy(scratchState.data(), history.states.data() + (baselineSlot * schema.m_stateSize), schema.m_stateSize);
+            }
+            for (uint8_t fieldIndex = 0; fieldIndex < schema.GetNumFields(); ++fieldIndex)
+            {
+                if ((changedFields & (1u << fieldIndex)) != 0)
+                {
+                    ReadField(msg, schema.m_fields[fieldIndex], scratchState.data());
+                }
+            }
+
+            if (hasBaseline)
+            {
+                ApplyRemoteState(snapshotId, netId, schema, scratchState.data());
+            }
+            else
+            {
+                ++m_missingBaselines;
+            }
+        }
+        else
+        {
+            LogPrintf(LogLevel::WARNING, "Snapshot %i had a corrupt entry, dropping the rest of it.", snapshotId);
+            return;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+bool NetReplicator::IsSnapshotNewer(uint16_t a, uint16_t b)
+{
+    int16_t diff = (int16_t)(a - b);
+    return diff > 0;
+}
+
+//-----------------------------------------------------------------------------------
+void NetReplicator::WriteField(NetMessage& msg, const ReplicationField& field, const byte* state) const
+{
+    const byte* data = state + field.offset;
+    switch (field.size)
+    {
+    case sizeof(uint8_t):
+    {
+        msg.Write<uint8_t>(*data);
+        break;
+    }
+    case sizeof(uint16_t):
+    {
+        uint16_t value;
+        memcpy(&value, data, sizeof(value));
+        msg.Write<uint16_t>(value);
+        break;
+    }
+    case sizeof(uint32_t):
+    {
+        uint32_t value;
+        memcpy(&value, data, sizeof(value));
+        msg.Write<uint32_t>(value);
+        break;
+    }
+    case sizeof(uint64_t):
+    {
+        uint64_t value;
+        memcpy(&value, data, sizeof(value));
+        msg.Write<uint64_t>(value);
+        break;
+    }
+    default:
+        msg.WriteBytes(data, field.size);
+        break;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void NetReplicator::ReadField(NetMessageView& msg, const ReplicationField& field, byte* state) const
+{
+    byte* data = state + field.offset;
+    switch (field.size)
+    {
+    case sizeof(uint8_t):
+    {
+        msg.Read<uint8_t>(*data);
+        break;
+    }
+    case sizeof(uint16_t):
+    {
+        uint16_t value;
+        msg.Read<uint16_t>(value);
+        memcpy(data, &value, sizeof(value));
+        break;
+    }
+    case sizeof(uint32_t):
+    {
+        uint32_t value;
+        msg.Read<uint32_t>(value);
+        memcpy(data, &value, sizeof(value));
+        break;
+    }
+    case sizeof(uint64_t):
+    {
+        uint64_t value;
+        msg.Read<uint64_t>(value);
+        memcpy(data, &value, sizeof(value));
+        break;
+    }
+    default:
+        msg.ReadBytes(data, field.size);
+        break;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+uint32_t NetReplicator::CalculateChangedFields(const ReplicationSchema& schema, const byte* current, const byte* baseline) const
+{
+    uint32_t changedFields = 0;
+    for (uint8_t fieldIndex = 0; fieldIndex < schema.GetNumFields(); ++fieldIndex)
+    {
+        const ReplicationField& field = schema.m_fields[fieldIndex];
+        if (memcmp(current + field.offset, baseline + field.offset, field.size) != 0)
+        {
+            changedFields |= (1u << fieldIndex);
+        }
+    }
+    return changedFields;
+}
+
+//-----------------------------------------------------------------------------------
+size_t NetReplicator::CalculateDeltaSize(const ReplicationSchema& schema, uint32_t changedFields) const
+{
+    size_t size = 0;
+    for (uint8_t fieldIndex = 0; fieldIndex < schema.GetNumFields(); ++fieldIndex)
+    {
+        if ((changedFields & (1u << fieldIndex)) != 0)
+        {
+            size += schema.m_fields[fieldIndex].size;
+        }
+    }
+    return size;
+}
+
+//-----------------------------------------------------------------------------------
+void NetReplicator::RecordSentObject(ReplicationConnectionState::SentSnapshot& snapshot, const ReplicatedObject& object)
+{
+    snapshot.netIds.push_back(object.netId);
+    snapshot.stateOffsets.push_back((uint32_t)snapshot.states.size());
+    snapshot.states.insert(snapshot.states.end(), object.state, object.state + object.schema->m_stateSize);
+}
+
+//-----------------------------------------------------------------------------------
+void NetReplicator::ApplyRemoteState(uint16_t snapshotId, uint16_t netId, const ReplicationSchema& schema, const byte* state)
+{
+    ReplicatedObject*& object = m_remoteObjects[netId];
+    RemoteObjectHistory& history = m_remoteHistory[netId];
+
+    if (object == nullptr && history.hasApplied && !IsSnapshotNewer(snapshotId, history.lastAppliedSnapshotId))
+    {
+        return; //A late arrival about an object we've already been told is gone.
+    }
+
+    bool wasCreated = false;
+    if (object == nullptr || object->schema != &schema)
+    {
+        if (object != nullptr)
+        {
+            m_OnRemoteObjectDestroyed.Trigger(object);
+            delete object;
+            --m_numRemoteObjects;
+        }
+        object = new ReplicatedObject(netId, &schema);
+        ++m_numRemoteObjects;
+        history.states.assign(BASELINE_WINDOW * schema.m_stateSize, 0);
+        for (uint16_t i = 0; i < BASELINE_WINDOW; ++i)
+        {
+            history.snapshotIds[i] = INVALID_SNAPSHOT_ID;
+        }
+        wasCreated = true;
+    }
+
+    uint16_t slot = snapshotId % BASELINE_WINDOW;
+    history.snapshotIds[slot] = snapshotId;
+    memcpy(history.states.data() + (slot * schema.m_stateSize), state, schema.m_stateSize);
+
+    if (wasCreated || !history.hasApplied || IsSnapshotNewer(snapshotId, history.lastAppliedSnapshotId))
+    {
+        memcpy(object->state, state, schema.m_stateSize);
+        history.lastAppliedSnapshotId = snapshotId;
+        history.hasApplied = true;
+        if (wasCreated)
+        {
+            m_OnRemoteObjectCreated.Trigger(object);
+        }
+        else
+        {
+            m_OnRemoteObjectUpdated.Trigger(object);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void NetReplicator::DestroyRemoteObject(uint16_t snapshotId, uint16_t netId)
+{
+    RemoteObjectHistory& history = m_remoteHistory[netId];
+    if (history.hasApplied && !IsSnapshotNewer(snapshotId, history.lastAppliedSnapshotId))
+    {
+        return; //Stale, the id has already moved on.
+    }
+
+    ReplicatedObject*& object = m_remoteObjects[netId];
+    if (object != nullptr)
+    {
+        m_OnRemoteObjectDestroyed.Trigger(object);
+        delete object;
+        object = nullptr;
+        --m_numRemoteObjects;
+    }
+    for (uint16_t i = 0; i < BASELINE_WINDOW; ++i)
+    {
+        history.snapshotIds[i] = INVALID_SNAPSHOT_ID;
+    }
+    history.lastAppliedSnapshotId = snapshotId;
+    history.hasApplied = true;
+}
+
+//LOOPBACK TEST/////////////////////////////////////////////////////////////////////
+struct LoopbackEntity
+{
+    float x;
+    float y;
+    float velocityX;
+    float velocityY;
+};
+
+struct LoopbackViewer
+{
+    float x;
+    float y;
+    float radius;
+};
+
+struct LoopbackAck
+{
+    int deliveryTick;
+    uint16_t snapshotId;
+};
+
+enum LoopbackFields : uint8_t
+{
+    LOOPBACK_POSITION_X = 0,
+    LOOPBACK_POSITION_Y,
+    LOOPBACK_ROTATION,
+    LOOPBACK_HEALTH,
+    LOOPBACK_TEAM,
+    NUM_LOOPBACK_FIELDS
+};
+
+//-----------------------------------------------------------------------------------
+static void RegisterLoopbackSchema(NetReplicator& replicator)
+{
+    ReplicationSchema* schema = replicator.RegisterSchema(0, "LoopbackEntity");
+    schema->AddField<float>("x");
+    schema->AddField<float>("y");
+    schema->AddField<float>("rotation");
+    schema->AddField<uint16_t>("health");
+    schema->AddField<uint8_t>("team");
+}
+
+//-----------------------------------------------------------------------------------
+static float LoopbackInterest(const ReplicationConnectionState& connectionState, const ReplicatedObject& object)
+{
+    const LoopbackViewer* viewer = (const LoopbackViewer*)connectionState.m_userData;
+    float deltaX = object.Get<float>(LOOPBACK_POSITION_X) - viewer->x;
+    float deltaY = object.Get<float>(LOOPBACK_POSITION_Y) - viewer->y;
+    float distanceSquared = (deltaX * deltaX) + (deltaY * deltaY);
+    if (distanceSquared > viewer->radius * viewer->radius)
+    {
+        return 0.0f;
+    }
+    //Closer objects accumulate priority faster, but everything in range eventually gets a turn.
+    return object.basePriority * (2.0f - (distanceSquared / (viewer->radius * viewer->radius)));
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(replicationtest)
+{
+    //Headless: the server writes snapshots straight into messages which are handed to client replicators,
+    //with acks coming back a few ticks later. No sockets or NetSession involved.
+    int numObjects = args.HasArgs(0) ? 2000 : Clamp<int>(args.GetIntArgument(0), 1, NetReplicator::MAX_REPLICATED_OBJECTS);
+    int numTicks = 300;
+    int numClients = 4;
+    int latencyTicks = 6;
+    float lossRate = 0.05f;
+    size_t byteBudget = ReplicationConnectionState::DEFAULT_BYTE_BUDGET;
+    const float WORLD_SIZE = 1000.0f;
+    const float TICK_RATE_HZ = 60.0f;
+
+    NetReplicator* server = new NetReplicator();
+    RegisterLoopbackSchema(*server);
+    server->SetInterestFunction(&LoopbackInterest);
+
+    std::vector<LoopbackEntity> entities(numObjects);
+    std::vector<ReplicatedObject*> serverObjects;
+    for (int i = 0; i < numObjects; ++i)
+    {
+        LoopbackEntity& entity = entities[i];
+        entity.x = MathUtils::GetRandomFloatFromZeroTo(WORLD_SIZE);
+        entity.y = MathUtils::GetRandomFloatFromZeroTo(WORLD_SIZE);
+        bool isMoving = MathUtils::GetRandomFloatFromZeroTo(1.0f) < 0.25f;
+        entity.velocityX = isMoving ? MathUtils::GetRandomFloat(-2.0f, 2.0f) : 0.0f;
+        entity.velocityY = isMoving ? MathUtils::GetRandomFloat(-2.0f, 2.0f) : 0.0f;
+
+        ReplicatedObject* object = server->CreateObject(0, 1.0f, &entity);
+        object->Set<float>(LOOPBACK_POSITION_X, entity.x);
+        object->Set<float>(LOOPBACK_POSITION_Y, entity.y);
+        object->Set<float>(LOOPBACK_ROTATION, 0.0f);
+        object->Set<uint16_t>(LOOPBACK_HEALTH, (uint16_t)100);
+        object->Set<uint8_t>(LOOPBACK_TEAM, (uint8_t)(i % 4));
+        serverObjects.push_back(object);
+    }
+
+    std::vector<NetReplicator*> clients;
+    std::vector<ReplicationConnectionState*> connectionStates;
+    std::vector<LoopbackViewer> viewers(numClients);
+    std::vector<std::vector<LoopbackAck>> pendingAcks(numClients);
+    for (int i = 0; i < numClients; ++i)
+    {
+        NetReplicator* client = new NetReplicator();
+        RegisterLoopbackSchema(*client);
+        clients.push_back(client);
+
+        viewers[i].x = MathUtils::GetRandomFloatFromZeroTo(WORLD_SIZE);
+        viewers[i].y = MathUtils::GetRandomFloatFromZeroTo(WORLD_SIZE);
+        viewers[i].radius = WORLD_SIZE * 0.35f;
+        ReplicationConnectionState* connectionState = server->CreateConnectionState(nullptr);
+        connectionState->m_userData = &viewers[i];
+        connectionState->m_byteBudget = byteBudget;
+        connectionStates.push_back(connectionState);
+    }
+
+    double writeSeconds = 0.0;
+    double readSeconds = 0.0;
+    for (int tick = 0; tick < numTicks; ++tick)
+    {
+        //Simulate
+        for (int i = 0; i < numObjects; ++i)
+        {
+            LoopbackEntity& entity = entities[i];
+            if (entity.velocityX == 0.0f && entity.velocityY == 0.0f)
+            {
+                continue;
+            }
+            entity.x = Clamp<float>(entity.x + entity.velocityX, 0.0f, WORLD_SIZE);
+            entity.y = Clamp<float>(entity.y + entity.velocityY, 0.0f, WORLD_SIZE);
+            serverObjects[i]->Set<float>(LOOPBACK_POSITION_X, entity.x);
+            serverObjects[i]->Set<float>(LOOPBACK_POSITION_Y, entity.y);
+            serverObjects[i]->Set<float>(LOOPBACK_ROTATION, (float)tick);
+        }
+        if (tick % 30 == 0)
+        {
+            ReplicatedObject* wounded = serverObjects[MathUtils::GetRandomIntFromZeroTo(numObjects)];
+            wounded->Set<uint16_t>(LOOPBACK_HEALTH, (uint16_t)(wounded->Get<uint16_t>(LOOPBACK_HEALTH) - 1));
+        }
+
+        //Send, deliver, and ack
+        for (int clientIndex = 0; clientIndex < numClients; ++clientIndex)
+        {
+            NetMessage snapshot(NetMessage::SNAPSHOT);
+            double startSeconds = GetCurrentTimeSeconds();
+            uint16_t snapshotId = server->WriteSnapshot(*connectionStates[clientIndex], snapshot, byteBudget);
+            writeSeconds += GetCurrentTimeSeconds() - startSeconds;
+
+            if (MathUtils::GetRandomFloatFromZeroTo(1.0f) >= lossRate)
+            {
+                NetMessageView received(snapshot);
+                startSeconds = GetCurrentTimeSeconds();
+                clients[clientIndex]->ReadSnapshot(received);
+                readSeconds += GetCurrentTimeSeconds() - startSeconds;
+
+                if (MathUtils::GetRandomFloatFromZeroTo(1.0f) >= lossRate)
+                {
+                    LoopbackAck ack;
+                    ack.deliveryTick = tick + latencyTicks;
+                    ack.snapshotId = snapshotId;
+                    pendingAcks[clientIndex].push_back(ack);
+                }
+            }
+
+            std::vector<LoopbackAck>& acks = pendingAcks[clientIndex];
+            for (auto iter = acks.begin(); iter != acks.end();)
+            {
+                if (iter->deliveryTick <= tick)
+                {
+                    server->ConfirmSnapshot(*connectionStates[clientIndex], iter->snapshotId);
+                    iter = acks.erase(iter);
+                }
+                else
+                {
+                    ++iter;
+                }
+            }
+        }
+    }
+
+    //Report
+    const ReplicationSchema* schema = server->FindSchema(0);
+    size_t naiveBytesPerTick = numObjects * (sizeof(uint16_t) + sizeof(uint8_t) + schema->m_stateSize);
+    Console::instance->PrintLine(Stringf("Replication loopback: %i objects, %i clients, %i ticks, %i tick latency, %.0f%% loss, %i byte budget", numObjects, numClients, numTicks, latencyTicks, lossRate * 100.0f, (int)byteBudget), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("Naive full state: %i bytes/tick/client (%.1f kbps at %.0fHz)", (int)naiveBytesPerTick, (naiveBytesPerTick * 8.0f * TICK_RATE_HZ) / 1000.0f, TICK_RATE_HZ), RGBA::GRAY);
+    for (int clientIndex = 0; clientIndex < numClients; ++clientIndex)
+    {
+        ReplicationConnectionState* connectionState = connectionStates[clientIndex];
+        NetReplicator* client = clients[clientIndex];
+        const LoopbackViewer& viewer = viewers[clientIndex];
+
+        int numRelevant = 0;
+        int numInSync = 0;
+        for (ReplicatedObject* object : serverObjects)
+        {
+            if (LoopbackInterest(*connectionState, *object) <= 0.0f)
+            {
+                continue;
+            }
+            ++numRelevant;
+            ReplicatedObject* mirror = client->GetRemoteObject(object->netId);
+            if (mirror && memcmp(mirror->state, object->state, schema->m_stateSize) == 0)
+            {
+                ++numInSync;
+            }
+        }
+
+        float bytesPerSnapshot = (float)connectionState->m_totalBytesSent / (float)connectionState->m_snapshotsSent;
+        Console::instance->PrintLine(Stringf("Client %i @(%.0f, %.0f): %.1f bytes/snapshot (%.1f kbps), %i full, %i delta, %i deferred, %i missing baselines, %i/%i relevant objects in sync",
+            clientIndex, viewer.x, viewer.y, bytesPerSnapshot, (bytesPerSnapshot * 8.0f * TICK_RATE_HZ) / 1000.0f,
+            (int)connectionState->m_fullObjectsSent, (int)connectionState->m_deltaObjectsSent, (int)connectionState->m_objectsDeferred,
+            (int)client->m_missingBaselines, numInSync, numRelevant), RGBA::GBWHITE);
+    }
+    Console::instance->PrintLine(Stringf("CPU: %.3fms write / %.3fms read per snapshot", (writeSeconds * 1000.0) / (numTicks * numClients), (readSeconds * 1000.0) / (numTicks * numClients)), RGBA::GBWHITE);
+
+    for (NetReplicator* client : clients)
+    {
+        delete client;
+    }
+    delete server;
+}
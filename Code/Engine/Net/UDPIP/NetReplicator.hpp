@@ -0,0 +1,248 @@
+#pragma once
+#include "Engine/Core/Events/Event.hpp"
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include <deque>
+
+class NetMessage;
+class NetMessageView;
+class NetConnection;
+class NetReplicator;
+struct ReplicatedObject;
+struct ReplicationConnectionState;
+
+typedef unsigned char byte;
+
+//Returns how relevant an object is to a connection this tick. Anything <= 0 is culled for that connection.
+typedef float(ReplicationInterestFunction)(const ReplicationConnectionState& connectionState, const ReplicatedObject& object);
+
+//-----------------------------------------------------------------------------------
+struct ReplicationField
+{
+    const char* name;
+    uint16_t offset;
+    uint16_t size;
+};
+
+//-----------------------------------------------------------------------------------
+// Describes the layout of a replicated object's state blob. Both ends of a session
+// must register identical schemas (same ids, same fields in the same order).
+class ReplicationSchema
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    ReplicationSchema() : m_id(0), m_name(nullptr), m_stateSize(0) {};
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    uint8_t AddField(const char* name, uint16_t size);
+    inline uint8_t GetNumFields() const { return (uint8_t)m_fields.size(); };
+    inline size_t GetMaskSize() const { return (m_fields.size() + 7) / 8; };
+
+    //-----------------------------------------------------------------------------------
+    template<typename T>
+    uint8_t AddField(const char* name)
+    {
+        return AddField(name, (uint16_t)sizeof(T));
+    }
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const int MAX_FIELDS = 32;
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    uint8_t m_id;
+    const char* m_name;
+    uint16_t m_stateSize;
+    std::vector<ReplicationField> m_fields;
+};
+
+//-----------------------------------------------------------------------------------
+struct ReplicatedObject
+{
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    ReplicatedObject(uint16_t id, const ReplicationSchema* objectSchema);
+    ~ReplicatedObject();
+
+    //-----------------------------------------------------------------------------------
+    template<typename T>
+    void Set(uint8_t fieldIndex, const T& value)
+    {
+        const ReplicationField& field = schema->m_fields[fieldIndex];
+        memcpy(state + field.offset, &value, field.size < sizeof(T) ? field.size : sizeof(T));
+    }
+
+    //-----------------------------------------------------------------------------------
+    template<typename T>
+    T Get(uint8_t fieldIndex) const
+    {
+        T value;
+        const ReplicationField& field = schema->m_fields[fieldIndex];
+        memcpy(&value, state + field.offset, field.size < sizeof(T) ? field.size : sizeof(T));
+        return value;
+    }
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    uint16_t netId;
+    const ReplicationSchema* schema;
+    byte* state;
+    float basePriority;
+    void* userData;
+};
+
+//-----------------------------------------------------------------------------------
+// Everything the authority needs to know about what one remote end has acknowledged.
+// Owned by the NetConnection it describes, created by the replicator on first send.
+struct ReplicationConnectionState
+{
+    //STRUCTS/////////////////////////////////////////////////////////////////////
+    struct ObjectRecord
+    {
+        ObjectRecord() : priorityAccumulator(0.0f), baselineSnapshotId(0), lastSentSnapshotId(0), sentStateSinceSnapshotId(0), hasBaseline(false), hasBeenSent(false), isPendingDestroy(false) {};
+        float priorityAccumulator;
+        uint16_t baselineSnapshotId;
+        uint16_t lastSentSnapshotId;
+        uint16_t sentStateSinceSnapshotId; //Every send from here to lastSentSnapshotId carried lastSentState
+        bool hasBaseline;
+        bool hasBeenSent;
+        bool isPendingDestroy;
+        std::vector<byte> baselineState;
+        std::vector<byte> lastSentState;
+    };
+
+    struct SentSnapshot
+    {
+        SentSnapshot() : snapshotId(0), isValid(false) {};
+        uint16_t snapshotId;
+        bool isValid;
+        std::vector<uint16_t> netIds;
+        std::vector<uint32_t> stateOffsets;
+        std::vector<byte> states;
+        std::vector<uint16_t> destroyedNetIds;
+    };
+
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    ReplicationConnectionState(NetConnection* owner);
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    // Matches NetConnection::MAX_ACK_BUNDLES; a snapshot can't be confirmed once its bundle is recycled anyway.
+    static const int SNAPSHOT_HISTORY_SIZE = 64;
+    static const size_t DEFAULT_BYTE_BUDGET = 1024;
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    NetConnection* m_connection;
+    void* m_userData;
+    size_t m_byteBudget;
+    uint16_t m_nextSnapshotId;
+    std::vector<ObjectRecord> m_records; //Indexed by netId
+    std::vector<uint16_t> m_pendingDestroys;
+    SentSnapshot m_sentSnapshots[SNAPSHOT_HISTORY_SIZE];
+
+    //Stats
+    size_t m_totalBytesSent;
+    size_t m_snapshotsSent;
+    size_t m_snapshotsConfirmed;
+    size_t m_fullObjectsSent;
+    size_t m_deltaObjectsSent;
+    size_t m_objectsDeferred;
+};
+
+//-----------------------------------------------------------------------------------
+// Snapshot replication on top of NetSession. The authority side keeps a table of
+// replicated objects and, per connection, writes one snapshot per net tick that
+// delta-encodes each object against the last state that connection acknowledged.
+// The receiving side mirrors the objects and keeps a short per-object history so
+// it can reconstruct whichever baseline the sender chose.
+class NetReplicator
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    NetReplicator();
+    ~NetReplicator();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    ReplicationSchema* RegisterSchema(uint8_t schemaId, const char* name);
+    const ReplicationSchema* FindSchema(uint8_t schemaId) const;
+    ReplicatedObject* CreateObject(uint8_t schemaId, float basePriority = 1.0f, void* userData = nullptr);
+    void DestroyObject(uint16_t netId);
+    ReplicatedObject* GetObject(uint16_t netId);
+    ReplicatedObject* GetRemoteObject(uint16_t netId);
+    inline size_t GetNumObjects() const { return m_numObjects; };
+    inline size_t GetNumRemoteObjects() const { return m_numRemoteObjects; };
+    inline void SetInterestFunction(ReplicationInterestFunction* interestFunction) { m_interestFunction = interestFunction; };
+
+    //Send side
+    ReplicationConnectionState* CreateConnectionState(NetConnection* connection);
+    void DestroyConnectionState(ReplicationConnectionState* connectionState);
+    bool HasDataFor(const ReplicationConnectionState& connectionState) const;
+    uint16_t WriteSnapshot(ReplicationConnectionState& connectionState, NetMessage& msg, size_t byteBudget);
+    void ConfirmSnapshot(ReplicationConnectionState& connectionState, uint16_t snapshotId);
+
+    //Receive side
+    void ReadSnapshot(NetMessageView& msg);
+
+    //STATIC FUNCTIONS/////////////////////////////////////////////////////////////////////
+    static bool IsSnapshotNewer(uint16_t a, uint16_t b);
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const uint16_t MAX_REPLICATED_OBJECTS = 4096;
+    static const uint16_t INVALID_SNAPSHOT_ID = 0xFFFF;
+    // How far back (in snapshots) a delta may reference. The receiver keeps this much history per object.
+    static const uint16_t BASELINE_WINDOW = 32;
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    Event<ReplicatedObject*> m_OnRemoteObjectCreated;
+    Event<ReplicatedObject*> m_OnRemoteObjectUpdated;
+    Event<ReplicatedObject*> m_OnRemoteObjectDestroyed;
+
+    //Receive stats
+    size_t m_snapshotsReceived;
+    size_t m_missingBaselines;
+
+private:
+    //STRUCTS/////////////////////////////////////////////////////////////////////
+    enum EntryType : uint8_t
+    {
+        ENTRY_FULL = 0,
+        ENTRY_DELTA,
+        ENTRY_DESTROY,
+        NUM_ENTRY_TYPES
+    };
+
+    struct RemoteObjectHistory
+    {
+        RemoteObjectHistory() : lastAppliedSnapshotId(0), hasApplied(false) {};
+        uint16_t lastAppliedSnapshotId;
+        bool hasApplied;
+        uint16_t snapshotIds[BASELINE_WINDOW];
+        std::vector<byte> states;
+    };
+
+    struct PriorityCandidate
+    {
+        float priority;
+        uint16_t netId;
+        inline bool operator<(const PriorityCandidate& other) const { return priority > other.priority; }; //Highest first
+    };
+
+    //PRIVATE FUNCTIONS/////////////////////////////////////////////////////////////////////
+    bool IsAcknowledged(const ReplicatedObject& object, const ReplicationConnectionState::ObjectRecord& record) const;
+    void WriteField(NetMessage& msg, const ReplicationField& field, const byte* state) const;
+    void ReadField(NetMessageView& msg, const ReplicationField& field, byte* state) const;
+    uint32_t CalculateChangedFields(const ReplicationSchema& schema, const byte* current, const byte* baseline) const;
+    size_t CalculateDeltaSize(const ReplicationSchema& schema, uint32_t changedFields) const;
+    void RecordSentObject(ReplicationConnectionState::SentSnapshot& snapshot, const ReplicatedObject& object);
+    void ApplyRemoteState(uint16_t snapshotId, uint16_t netId, const ReplicationSchema& schema, const byte* state);
+    void DestroyRemoteObject(uint16_t snapshotId, uint16_t netId);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    ReplicationSchema m_schemas[256];
+    ReplicatedObject* m_objects[MAX_REPLICATED_OBJECTS];
+    ReplicatedObject* m_remoteObjects[MAX_REPLICATED_OBJECTS];
+    RemoteObjectHistory m_remoteHistory[MAX_REPLICATED_OBJECTS];
+    std::deque<uint16_t> m_freeNetIds; //FIFO so a freed id sits out as long as possible before reuse
+    std::vector<ReplicationConnectionState*> m_connectionStates;
+    std::vector<PriorityCandidate> m_candidates;
+    ReplicationInterestFunction* m_interestFunction;
+    size_t m_numObjects;
+    size_t m_numRemoteObjects;
+};
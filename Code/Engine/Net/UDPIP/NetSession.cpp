@@ -4,46 +4,54 @@
 #include "Engine/Net/NetSystem.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Net/UDPIP/NetPacket.hpp"
+#include "Engine/Net/UDPIP/NetReplicator.hpp"
 #include "Engine/Core/Events/Event.hpp"
 #include "Engine/Input/Logging.hpp"
 #include "Engine/Time/Time.hpp"
+#include <algorithm>
 
 NetSession* NetSession::instance = nullptr;
 extern Event<float> NetworkUpdate;
 extern Event<> NetworkCleanup;
 
 //-----------------------------------------------------------------------------------
-NetSession::NetSession(float tickRatePerSecond) 
+NetSession::NetSession(float tickRatePerSecond, uint16_t maxConnections) 
     : m_myConnection(nullptr)
     , m_hostConnection(nullptr)
     , m_tickRate(tickRatePerSecond)
     , m_timeLastJoinRequestSent(0.0f)
     , m_timeSinceLastUpdate(0.0f)
     , m_numConnections(0)
+    , m_maxConnections(Clamp<uint16_t>(maxConnections, 1, MAX_SUPPORTED_CONNECTIONS))
     , m_sessionState(State::INVALID)
     , m_lastError(ErrorCode::NONE)
     , m_timeoutEnabled(false)
-    , m_sessionInfoText(nullptr)
-    , m_netLagText(nullptr)
-    , m_netLossText(nullptr)
-    , m_connectionCountText(nullptr)
+    , m_sessionInfoText(ConsoleScrollback::INVALID_LINE)
+    , m_netLagText(ConsoleScrollback::INVALID_LINE)
+    , m_netLossText(ConsoleScrollback::INVALID_LINE)
+    , m_connectionCountText(ConsoleScrollback::INVALID_LINE)
     , m_isListening(true)
+    , m_replicator(nullptr)
+    , m_compressionEnabled(false)
+    , m_maxTracePackets(0)
 {
     m_packetChannel.m_additionalLagMilliseconds = 0;//Range<double>(50, 150);
     m_packetChannel.m_dropRate = 0.0f;//0.1f;
-    for (int i = 0; i < MAX_CONNECTIONS; ++i)
-    {
-        m_allConnections[i] = nullptr;
-    }
+    m_compressor.SetDictionary(NetCompressor::BuildDefaultDictionary());
+    m_allConnections.resize(m_maxConnections, nullptr);
+    m_liveConnectionIndices.reserve(m_maxConnections);
+    m_tickConnectionIndices.reserve(m_maxConnections);
+    m_connectionIndexLookup.reserve(m_maxConnections);
 }
 
 //-----------------------------------------------------------------------------------
 NetSession::~NetSession()
 {
-    for (uint8_t i = 0; i < MAX_CONNECTIONS; ++i)
+    for (uint16_t i = 0; i < m_maxConnections; ++i)
     {
         Disconnect(m_allConnections[i]);
     }
+    delete m_replicator;
 }
 
 //-----------------------------------------------------------------------------------
@@ -57,7 +65,7 @@ bool NetSession::Start(const char* portNumber)
     }
     SetSessionState(State::DISCONNECTED);
     OnEnterDisconnectedState();
-    NetworkUpdate.RegisterMethod(NetSession::instance, &NetSession::Update);
+    NetworkUpdate.RegisterMethod(this, &NetSession::Update);
     return m_packetChannel.IsBound();
 }
 
@@ -116,12 +124,18 @@ void NetSession::Update(float deltaSeconds)
     m_timeSinceLastUpdate += deltaSeconds;
     if (m_timeSinceLastUpdate >= m_tickRate)
     {
-        for (NetConnection* conn : m_allConnections)
+        //Only walk connections that exist, and only build a packet for the ones with something to say.
+        m_tickConnectionIndices = m_liveConnectionIndices;
+        for (uint16_t index : m_tickConnectionIndices)
         {
+            NetConnection* conn = m_allConnections[index];
             if (conn)
             {
                 m_OnNetTick.Trigger(conn);
-                conn->ConstructAndSendPacket();
+                if (conn->HasPendingData())
+                {
+                    conn->ConstructAndSendPacket();
+                }
             }
         }
         m_timeSinceLastUpdate = 0.0f;
@@ -140,12 +154,56 @@ void NetSession::ProcessIncomingPackets(const size_t maxPacketsToProcess)
     size_t read = m_packetChannel.RecieveFrom(from.address, packet.m_buffer);
     while (read > 0)
     {
-        packet.SetReadableBytes(read);
-        ProcessIncomingPacket(from, packet);
+        if (DecompressIncomingPacket(packet, read))
+        {
+            packet.SetReadableBytes(read);
+            ProcessIncomingPacket(from, packet);
+        }
         read = m_packetChannel.RecieveFrom(from.address, packet.m_buffer);
     }
 }
 
+//-----------------------------------------------------------------------------------
+bool NetSession::DecompressIncomingPacket(NetPacket& packet, size_t& packetSize)
+{
+    if (packet.m_buffer[0] != NetPacket::COMPRESSED_PACKET_MARKER)
+    {
+        return true;
+    }
+    byte decompressed[PACKET_MTU];
+    size_t decompressedSize = m_compressor.Decompress(packet.m_buffer + 1, packetSize - 1, decompressed, PACKET_MTU);
+    if (decompressedSize == 0)
+    {
+        LogPrintf(LogLevel::WARNING, "Compressed packet failed to decompress, thrown out.");
+        return false;
+    }
+    memcpy(packet.m_buffer, decompressed, decompressedSize);
+    packetSize = decompressedSize;
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+size_t NetSession::SendPacket(const sockaddr_in& to, NetPacket& packet)
+{
+    size_t packetSize = packet.GetTotalReadableBytes();
+    if (m_packetTrace.size() < m_maxTracePackets)
+    {
+        m_packetTrace.push_back(std::vector<byte>(packet.m_buffer, packet.m_buffer + packetSize));
+    }
+    if (m_compressionEnabled)
+    {
+        //Only send it compressed if that's smaller than raw, marker byte included.
+        byte compressed[PACKET_MTU];
+        compressed[0] = NetPacket::COMPRESSED_PACKET_MARKER;
+        size_t compressedSize = m_compressor.Compress(packet.m_buffer, packetSize, compressed + 1, packetSize - 2);
+        if (compressedSize > 0)
+        {
+            return m_packetChannel.SendTo(to, compressed, compressedSize + 1);
+        }
+    }
+    return m_packetChannel.SendTo(to, packet.m_buffer, packetSize);
+}
+
 //-----------------------------------------------------------------------------------
 void NetSession::ProcessIncomingPacket(NetSender& from, NetPacket& packet)
 {
@@ -156,11 +214,14 @@ void NetSession::ProcessIncomingPacket(NetSender& from, NetPacket& packet)
 
     //Process the messages in the packet.
     uint8_t numMessages = packet.m_header.messageCount;
-    NetMessage msg;
+    NetMessageView msg;
     //Console::instance->PrintLine(Stringf("Received Packet with %i messages", numMessages), RGBA::VAPORWAVE);
     for (uint8_t i = 0; i < numMessages; ++i)
     {
-        packet.ReadMessage(msg);
+        if (!packet.ReadMessageView(msg))
+        {
+            break; //Can't trust where anything after a bad size starts
+        }
 
         // Make sure we can process it
         // - Does it require a connection?
@@ -175,7 +236,7 @@ void NetSession::ProcessIncomingPacket(NetSender& from, NetPacket& packet)
             else
             {
                 msg.Process(from);
-                if (msg.IsReliable())
+                if (msg.IsReliable(this))
                 {
                     from.connection = GetConnection(GetConnectionIndexFromAddress(from.address));
                 }
@@ -211,7 +272,7 @@ void NetSession::SendMessageDirect(const sockaddr_in& to, const NetMessage& msg)
     }
     NetPacket packet(GetMyConnectionIndex());
     packet.WriteMessageAndFinalize(msg);
-    m_packetChannel.SendTo(to, packet.m_buffer, packet.GetTotalReadableBytes());
+    SendPacket(to, packet);
 }
 
 //-----------------------------------------------------------------------------------
@@ -224,7 +285,7 @@ size_t NetSession::SendMessagesDirect(sockaddr_in& to, NetMessage** messages, si
     }
     NetPacket packet(GetMyConnectionIndex());
     size_t successfullyPacked = packet.WriteMessagesAndFinalize(messages, numMessages);
-    m_packetChannel.SendTo(to, packet.m_buffer, packet.GetTotalReadableBytes());
+    SendPacket(to, packet);
     return successfullyPacked;
 }
 
@@ -241,9 +302,9 @@ bool NetSession::IsHost()
 }
 
 //-----------------------------------------------------------------------------------
-const NetMessageDefinition* NetSession::FindDefinition(byte messageType)
+const NetMessageDefinition* NetSession::FindDefinition(byte messageType) const
 {
-    NetMessageDefinition* def = &m_netMessageDefinitions[messageType];
+    const NetMessageDefinition* def = &m_netMessageDefinitions[messageType];
     if (def->callbackFunction != nullptr)
     {
         return def;
@@ -255,7 +316,7 @@ const NetMessageDefinition* NetSession::FindDefinition(byte messageType)
 }
 
 //-----------------------------------------------------------------------------------
-NetConnection* NetSession::CreateConnection(uint8_t index, const char* guid, sockaddr_in address)
+NetConnection* NetSession::CreateConnection(uint16_t index, const char* guid, sockaddr_in address)
 {
     if (GetConnection(index) != nullptr)
     {
@@ -282,9 +343,9 @@ NetConnection* NetSession::CreateConnection(uint8_t index, const char* guid, soc
 }
 
 //-----------------------------------------------------------------------------------
-NetConnection* NetSession::GetConnection(uint8_t index)
+NetConnection* NetSession::GetConnection(uint16_t index)
 {
-    if (index < MAX_CONNECTIONS)
+    if (index < m_maxConnections)
     {
         return m_allConnections[index];
     }
@@ -295,7 +356,7 @@ NetConnection* NetSession::GetConnection(uint8_t index)
 }
 
 //-----------------------------------------------------------------------------------
-void NetSession::DestroyConnection(uint8_t index)
+void NetSession::DestroyConnection(uint16_t index)
 {
     NetConnection* conn = GetConnection(index);
     if (conn == nullptr)
@@ -312,13 +373,29 @@ void NetSession::DestroyConnection(uint8_t index)
     }
 
     m_OnConnectionLeave.Trigger(conn);
+
+    auto lookup = m_connectionIndexLookup.find(GetAddressKey(conn->m_address));
+    if (lookup != m_connectionIndexLookup.end() && lookup->second == index)
+    {
+        m_connectionIndexLookup.erase(lookup);
+    }
+    for (size_t i = 0; i < m_liveConnectionIndices.size(); ++i)
+    {
+        if (m_liveConnectionIndices[i] == index)
+        {
+            m_liveConnectionIndices[i] = m_liveConnectionIndices.back();
+            m_liveConnectionIndices.pop_back();
+            break;
+        }
+    }
+
     delete conn;
     --m_numConnections;
     m_allConnections[index] = nullptr;
 }
 
 //-----------------------------------------------------------------------------------
-uint8_t NetSession::GetMyConnectionIndex()
+uint16_t NetSession::GetMyConnectionIndex()
 {
     if (m_myConnection)
     {
@@ -331,43 +408,41 @@ uint8_t NetSession::GetMyConnectionIndex()
 }
 
 //-----------------------------------------------------------------------------------
-uint8_t NetSession::GetConnectionIndexFromAddress(const sockaddr_in& address)
+uint16_t NetSession::GetConnectionIndexFromAddress(const sockaddr_in& address)
 {
-    for (uint8_t i = 0; i < MAX_CONNECTIONS; ++i)
+    auto lookup = m_connectionIndexLookup.find(GetAddressKey(address));
+    if (lookup != m_connectionIndexLookup.end())
     {
-        if (m_allConnections[i] && NetSystem::SockaddrCompare(m_allConnections[i]->m_address, address))
-        {
-            return i;
-        }
+        return lookup->second;
     }
     return INVALID_CONNECTION_INDEX;
 }
 
 //-----------------------------------------------------------------------------------
-void OnPingReceived(const NetSender& sender, NetMessage& msg)
+void OnPingReceived(const NetSender& sender, NetMessageView& msg)
 {
     const char* str = msg.ReadString();
 
     Console::instance->PrintLine(Stringf("Ping Receieved from %s. [%s]", NetSystem::SockAddrToString((sockaddr*)&sender.address), ((nullptr != str) ? str : "null")), RGBA::FOREST_GREEN);
 
     NetMessage pong(NetMessage::PONG);
-    NetSession::instance->SendMessageDirect(sender.address, pong);
+    sender.session->SendMessageDirect(sender.address, pong);
 }
 
 //-----------------------------------------------------------------------------------
-void OnPongReceived(const NetSender& sender, NetMessage&)
+void OnPongReceived(const NetSender& sender, NetMessageView&)
 {
     Console::instance->PrintLine(Stringf("Pong received from %s.", NetSystem::SockAddrToString((sockaddr*)&sender.address)), RGBA::GBWHITE);
 }
 
 //-----------------------------------------------------------------------------------
-void OnHeartbeatReceived(const NetSender& sender, NetMessage& msg)
+void OnHeartbeatReceived(const NetSender& sender, NetMessageView& msg)
 {
     Console::instance->PrintLine(Stringf("[%i] Heartbeat received from %s. <3", msg.m_reliableId, NetSystem::SockAddrToString((sockaddr*)&sender.address)), RGBA::VAPORWAVE);
 }
 
 //-----------------------------------------------------------------------------------
-void OnJoinAcceptReceived(const NetSender& sender, NetMessage& msg)
+void OnJoinAcceptReceived(const NetSender& sender, NetMessageView& msg)
 {
     if (sender.session->GetSessionState() != NetSession::State::JOINING)
     {
@@ -384,24 +459,42 @@ void OnJoinAcceptReceived(const NetSender& sender, NetMessage& msg)
     NetConnection* host = sender.session->GetHostConnection();
     const char* hostGuid = msg.ReadString();
     memcpy(host->m_guid, hostGuid, strlen(hostGuid));
-    msg.Read<uint8_t>(host->m_index);
+    msg.Read<uint16_t>(host->m_index);
 
     NetConnection* me = sender.session->GetMyConnection();
     ASSERT_OR_DIE(strcmp(me->m_guid, msg.ReadString()) == 0, "Got back a different guid, potentially corrputed packet detected");
-    msg.Read<uint8_t>(me->m_index);
+    uint16_t myIndex = NetSession::INVALID_CONNECTION_INDEX;
+    msg.Read<uint16_t>(myIndex);
 
-    sender.session->Connect(me, me->m_index);
+    //The index comes off the wire, so a slot we don't have (or one already taken) drops the join instead of connecting.
+    if (!sender.session->Connect(me, myIndex))
+    {
+        Console::instance->PrintLine(Stringf("Host at %s gave us an invalid connection index %i.", NetSystem::SockAddrToString((sockaddr*)&sender.address), myIndex), RGBA::RED);
+        sender.session->m_lastError = NetSession::ErrorCode::JOIN_ERROR_INVALID_INDEX;
+        sender.session->SetSessionState(NetSession::DISCONNECTED);
+        sender.session->OnEnterDisconnectedState();
+        return;
+    }
     sender.session->SetSessionState(NetSession::State::CONNECTED);
 }
 
 //-----------------------------------------------------------------------------------
-void OnConnectionLeaveReceived(const NetSender& sender, NetMessage&)
+void OnConnectionLeaveReceived(const NetSender& sender, NetMessageView&)
 {
     sender.session->Disconnect(sender.connection);
 }
 
 //-----------------------------------------------------------------------------------
-void OnJoinDenyReceived(const NetSender& sender, NetMessage& msg)
+void OnSnapshotReceived(const NetSender& sender, NetMessageView& msg)
+{
+    if (sender.session->m_replicator)
+    {
+        sender.session->m_replicator->ReadSnapshot(msg);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void OnJoinDenyReceived(const NetSender& sender, NetMessageView& msg)
 {
     if (sender.session->GetSessionState() != NetSession::JOINING)
     {
@@ -425,7 +518,7 @@ void OnJoinDenyReceived(const NetSender& sender, NetMessage& msg)
 
 
 //-----------------------------------------------------------------------------------
-void OnJoinRequestReceived(const NetSender& sender, NetMessage& msg)
+void OnJoinRequestReceived(const NetSender& sender, NetMessageView& msg)
 {
     NetSession* sp = sender.session;
     const char* guid = msg.ReadString();
@@ -458,9 +551,9 @@ void OnJoinRequestReceived(const NetSender& sender, NetMessage& msg)
     NetMessage accept(NetMessage::CoreMessageTypes::JOIN_ACCEPT);
 #pragma todo("Make this a 'writeConnInfo' function")
     accept.WriteString(sp->GetHostConnection()->m_guid);
-    accept.Write<uint8_t>(sp->GetHostConnection()->m_index);
+    accept.Write<uint16_t>(sp->GetHostConnection()->m_index);
     accept.WriteString(cp->m_guid);
-    accept.Write<uint8_t>(cp->m_index);
+    accept.Write<uint16_t>(cp->m_index);
     cp->SendMessage(accept);
 }
 
@@ -481,35 +574,50 @@ void NetSession::UpdateNetDebug()
         ShutdownNetDebug();
         return;
     }
-    if (m_sessionInfoText)
+    //Lines that have scrolled out of the console's scrollback stop resolving, and get dropped here
+    Console* console = Console::instance;
+    if (m_sessionInfoText != ConsoleScrollback::INVALID_LINE)
     {
         sockaddr_in addr = m_packetChannel.GetAddress();
         const sockaddr* address = m_packetChannel.IsBound() ? (const sockaddr*)&addr : nullptr;
-        m_sessionInfoText->text = Stringf("Session bound to [%s] - State: %s", NetSystem::SockAddrToString(address), GetStateCstr(m_sessionState));
+        if (!console->UpdateDynamicLine(m_sessionInfoText, Stringf("Session bound to [%s] - State: %s", NetSystem::SockAddrToString(address), GetStateCstr(m_sessionState))))
+        {
+            m_sessionInfoText = ConsoleScrollback::INVALID_LINE;
+        }
     }
-    if (m_netLagText)
+    if (m_netLagText != ConsoleScrollback::INVALID_LINE)
     {
-        m_netLagText->text = Stringf("Simulated Net Lag: %.0fms ~ %.0fms", m_packetChannel.m_additionalLagMilliseconds.minValue, m_packetChannel.m_additionalLagMilliseconds.maxValue);
+        if (!console->UpdateDynamicLine(m_netLagText, Stringf("Simulated Net Lag: %.0fms ~ %.0fms", m_packetChannel.m_additionalLagMilliseconds.minValue, m_packetChannel.m_additionalLagMilliseconds.maxValue)))
+        {
+            m_netLagText = ConsoleScrollback::INVALID_LINE;
+        }
     }
-    if (m_netLossText)
+    if (m_netLossText != ConsoleScrollback::INVALID_LINE)
     {
-        m_netLossText->text = Stringf("Simulated Net Loss: %.2f%%", m_packetChannel.m_dropRate * 100.0f);
+        if (!console->UpdateDynamicLine(m_netLossText, Stringf("Simulated Net Loss: %.2f%%", m_packetChannel.m_dropRate * 100.0f)))
+        {
+            m_netLossText = ConsoleScrollback::INVALID_LINE;
+        }
     }
-    if (m_connectionCountText)
+    if (m_connectionCountText != ConsoleScrollback::INVALID_LINE)
     {
-        m_connectionCountText->text = Stringf("Connection Count: %i/%i", m_numConnections, MAX_CONNECTIONS);
+        if (!console->UpdateDynamicLine(m_connectionCountText, Stringf("Connection Count: %i/%i", m_numConnections, m_maxConnections)))
+        {
+            m_connectionCountText = ConsoleScrollback::INVALID_LINE;
+        }
     }
     if (m_connectionsText.size() > 0)
     {
-        for (unsigned int i = 0; i < NetSession::MAX_CONNECTIONS; ++i)
+        for (unsigned int i = 0; i < m_connectionsText.size(); ++i)
         {
-            ColoredText* textLine = m_connectionsText[i];
-            NetConnection* conn = GetConnection((uint8_t)i);
-            if (textLine)
+            ConsoleLineHandle textLine = m_connectionsText[i];
+            NetConnection* conn = GetConnection((uint16_t)i);
+            if (textLine != ConsoleScrollback::INVALID_LINE)
             {
+                std::string lineText;
                 if (conn)
                 {
-                    textLine->text = Stringf("%s%s[%i %s] %s <%s> lRcv[%.0fms] lSnd[%.0fms] sAck[%i] cAck[%i]",
+                    lineText = Stringf("%s%s[%i %s] %s <%s> lRcv[%.0fms] lSnd[%.0fms] sAck[%i] cAck[%i] rtt[%.0f~%.0fms] rto[%.0fms] loss[%.1f%%] rate[%.1fKB/s]",
                         conn->IsMyConnection() ? "*" : " ",
                         conn->IsHostConnection() ? "H" : " ",
                         i,
@@ -519,11 +627,20 @@ void NetSession::UpdateNetDebug()
                         conn->m_lastRecievedTimeMs,
                         conn->m_lastSentTimeMs,
                         conn->GetLastSentAck(),
-                        conn->GetMostRecentConfirmedAck());
+                        conn->GetMostRecentConfirmedAck(),
+                        conn->m_rttMs,
+                        conn->m_jitterMs,
+                        conn->m_rtoMs,
+                        conn->GetPacketLossRate() * 100.0f,
+                        conn->m_sendRateBytesPerSecond / 1024.0);
                 }
                 else
                 {
-                    textLine->text = Stringf("  [%i] No Connection", i);
+                    lineText = Stringf("  [%i] No Connection", i);
+                }
+                if (!console->UpdateDynamicLine(textLine, lineText))
+                {
+                    m_connectionsText[i] = ConsoleScrollback::INVALID_LINE;
                 }
             }
         }
@@ -533,26 +650,23 @@ void NetSession::UpdateNetDebug()
 //-----------------------------------------------------------------------------------
 void NetSession::ShutdownNetDebug()
 {
-    m_sessionInfoText = nullptr;
-    m_netLagText = nullptr;
-    m_netLossText = nullptr;
-    m_connectionCountText = nullptr;
+    m_sessionInfoText = ConsoleScrollback::INVALID_LINE;
+    m_netLagText = ConsoleScrollback::INVALID_LINE;
+    m_netLossText = ConsoleScrollback::INVALID_LINE;
+    m_connectionCountText = ConsoleScrollback::INVALID_LINE;
     for (unsigned int i = 0; i < m_connectionsText.size(); ++i)
     {
-        m_connectionsText[i] = nullptr;
+        m_connectionsText[i] = ConsoleScrollback::INVALID_LINE;
     }
 }
 
 //-----------------------------------------------------------------------------------
 void NetSession::Host(const char* username)
 {
-    const int MAX_CHARACTERS = 32;
-    char portString[MAX_CHARACTERS];
     ASSERT_OR_DIE(m_sessionState == DISCONNECTED, "Wasn't in a valid state before hosting");
     SetSessionState(HOSTING);
-    _itoa_s(htons(m_packetChannel.GetAddress().sin_port), portString, 10);
-    sockaddr_in localAddress = *(sockaddr_in*)NetSystem::GetLocalHostAddressUDP(portString);
-    m_hostConnection = CreateConnection(0, username, localAddress);
+    //Whatever address the transport actually bound, so IsMyConnection() holds for simulated transports too.
+    m_hostConnection = CreateConnection(0, username, GetAddress());
     m_myConnection = m_hostConnection;
     SetSessionState(CONNECTED);
 }
@@ -563,7 +677,7 @@ void NetSession::Join(const char* username, sockaddr_in& hostAddress)
     SetSessionState(JOINING);
     m_hostConnection = CreateConnection(0, "hostDefault", hostAddress);
     m_myConnection = new NetConnection(INVALID_CONNECTION_INDEX, username, GetAddress(), this);
-    m_timeLastJoinRequestSent = GetCurrentTimeMilliseconds();
+    m_timeLastJoinRequestSent = GetNetTimeMilliseconds();
     NetMessage request(NetMessage::CoreMessageTypes::JOIN_REQUEST);
     request.WriteString(username);
     m_hostConnection->SendMessage(request);
@@ -575,9 +689,10 @@ void NetSession::Leave()
 {
     ASSERT_OR_DIE(m_sessionState == CONNECTED, "Wasn't connected before leaving");
     NetMessage leaveMessage(NetMessage::CoreMessageTypes::CONNECTION_LEAVE);
-    for (NetConnection* conn : m_allConnections)
+    for (uint16_t index : m_liveConnectionIndices)
     {
-        if (conn && conn != m_myConnection)
+        NetConnection* conn = m_allConnections[index];
+        if (conn != m_myConnection)
         {
             SendMessageDirect(conn->m_address, leaveMessage);
         }
@@ -591,17 +706,19 @@ void NetSession::Leave()
 }
 
 //------------------------------------------------------------------------
-bool NetSession::Connect(NetConnection* cp, const uint8_t idx)
+bool NetSession::Connect(NetConnection* cp, const uint16_t idx)
 {
     //This guy better not be connected, and this slot needs to be free
     ASSERT_OR_DIE(!cp->IsConnected(), "Attempted to reconnect a connected connection");
-    if (GetConnection(idx) != nullptr)
+    if (idx >= m_maxConnections || GetConnection(idx) != nullptr)
     {
         return false;
     }
 
     cp->m_index = idx;
     m_allConnections[idx] = cp;
+    m_liveConnectionIndices.push_back(idx);
+    m_connectionIndexLookup[GetAddressKey(cp->m_address)] = idx;
 
     // If you're the host, and in a P2P environment
     // you would tell everyone else about this connection
@@ -624,10 +741,10 @@ bool NetSession::Connect(NetConnection* cp, const uint8_t idx)
         // Finally, if this is me, trigger everyone else
         if (cp->IsMyConnection()) 
         {
-            for (size_t i = 0; i < MAX_CONNECTIONS; ++i) 
+            for (uint16_t index : m_liveConnectionIndices) 
             {
-                NetConnection* otherConnection = m_allConnections[i];
-                if ((nullptr != otherConnection) && (cp != otherConnection) && !otherConnection->IsHostConnection()) 
+                NetConnection* otherConnection = m_allConnections[index];
+                if ((cp != otherConnection) && !otherConnection->IsHostConnection()) 
                 {
                     m_OnConnectionJoin.Trigger(otherConnection);
                 }
@@ -639,9 +756,9 @@ bool NetSession::Connect(NetConnection* cp, const uint8_t idx)
 }
 
 //-----------------------------------------------------------------------------------
-void NetSession::Disconnect(uint8_t index)
+void NetSession::Disconnect(uint16_t index)
 {
-    Disconnect(m_allConnections[index]);
+    Disconnect(GetConnection(index));
 }
 
 //------------------------------------------------------------------------
@@ -654,8 +771,10 @@ void NetSession::Disconnect(NetConnection* cp)
         return;
     }
 
-    uint8_t const idx = cp->m_index;
-    ASSERT_OR_DIE(m_allConnections[idx] == cp, "Passed a nonexistant connection to disconnect");
+    uint16_t const idx = cp->m_index;
+    ASSERT_OR_DIE(GetConnection(idx) == cp, "Passed a nonexistant connection to disconnect");
+    bool const isMyConnection = cp->IsMyConnection();
+    bool const isHostConnection = cp->IsHostConnection();
 
     // Not connected - just remove it silently.
     if (!AmIConnected()) 
@@ -683,7 +802,7 @@ void NetSession::Disconnect(NetConnection* cp)
     {
         // Disconnect everyone else in the session that is NOT the host
         // and NOT me.
-        for (size_t i = 0; i < MAX_CONNECTIONS; ++i) 
+        for (size_t i = 0; i < m_maxConnections; ++i) 
         {
             NetConnection* other_cp = m_allConnections[i];
             if ((nullptr != other_cp) && !other_cp->IsMyConnection() && !other_cp->IsHostConnection()) 
@@ -698,7 +817,7 @@ void NetSession::Disconnect(NetConnection* cp)
     DestroyConnection(idx);
 
     // I'm disconnecting myself, and I'm not the host, finally disconnect the host last
-    if (cp->IsMyConnection() && (m_hostConnection != nullptr) && !cp->IsHostConnection()) 
+    if (isMyConnection && (m_hostConnection != nullptr) && !isHostConnection) 
     {
         DestroyConnection(m_hostConnection->m_index);
         ASSERT_OR_DIE(m_hostConnection == nullptr, "Failed to set the host connection ptr back to nullptr");
@@ -712,11 +831,13 @@ void NetSession::CheckForTimeouts()
     {
         return;
     }
-    for (NetConnection* conn : m_allConnections)
+    m_tickConnectionIndices = m_liveConnectionIndices;
+    for (uint16_t index : m_tickConnectionIndices)
     {
+        NetConnection* conn = m_allConnections[index];
         if (conn && !conn->IsMyConnection())
         {
-            double msSinceLastContact = GetCurrentTimeMilliseconds() - conn->m_lastRecievedTimeMs;
+            double msSinceLastContact = GetNetTimeMilliseconds() - conn->m_lastRecievedTimeMs;
             if (msSinceLastContact >= NetConnection::BAD_CONNECTION_TIME_MS)
             {
                 conn->m_state = NetConnection::State::BAD;
@@ -752,7 +873,7 @@ const char* NetSession::GetStateCstr(const NetSession::State& state)
 //-----------------------------------------------------------------------------------
 void NetSession::OnEnterDisconnectedState()
 {
-    for (uint8_t i = 0; i < MAX_CONNECTIONS; ++i)
+    for (uint16_t i = 0; i < m_maxConnections; ++i)
     {
         Disconnect(m_allConnections[i]);
     }
@@ -768,30 +889,22 @@ void NetSession::OnEnterDisconnectedState()
 //-----------------------------------------------------------------------------------
 bool NetSession::HasConnectionFor(const sockaddr_in& address)
 {
-    for (uint8_t i = 0; i < MAX_CONNECTIONS; ++i)
-    {
-        NetConnection* conn = m_allConnections[i];
-        if (conn && NetSystem::SockaddrCompare(address, conn->m_address) == 0)
-        {
-            return true;
-        }
-    }
-    return false;
+    return m_connectionIndexLookup.find(GetAddressKey(address)) != m_connectionIndexLookup.end();
 }
 
 //-----------------------------------------------------------------------------------
 bool NetSession::IsPartyFull()
 {
-    return m_numConnections >= MAX_CONNECTIONS;
+    return m_numConnections >= m_maxConnections;
 }
 
 //-----------------------------------------------------------------------------------
 bool NetSession::IsGuidInUse(const char* guid)
 {
-    for (uint8_t i = 0; i < MAX_CONNECTIONS; ++i)
+    for (uint16_t index : m_liveConnectionIndices)
     {
-        NetConnection* conn = m_allConnections[i];
-        if (conn && strcmp(guid, conn->m_guid) == 0)
+        NetConnection* conn = m_allConnections[index];
+        if (strcmp(guid, conn->m_guid) == 0)
         {
             return true;
         }
@@ -800,9 +913,9 @@ bool NetSession::IsGuidInUse(const char* guid)
 }
 
 //-----------------------------------------------------------------------------------
-uint8_t NetSession::GetNextAvailableIndex()
+uint16_t NetSession::GetNextAvailableIndex()
 {
-    for (uint8_t i = 0; i < MAX_CONNECTIONS; ++i)
+    for (uint16_t i = 0; i < m_maxConnections; ++i)
     {
         NetConnection* conn = m_allConnections[i];
         if (!conn)
@@ -820,7 +933,7 @@ void NetSession::CheckForJoinResponse()
     {
         return;
     }
-    if (GetCurrentTimeMilliseconds() - m_timeLastJoinRequestSent >= NetConnection::TIMEOUT_TIME_MS)
+    if (GetNetTimeMilliseconds() - m_timeLastJoinRequestSent >= NetConnection::TIMEOUT_TIME_MS)
     {
         m_lastError = JOIN_ERROR_HOST_TIMEOUT;
         Console::instance->PrintLine(Stringf("Failed to join the host. Reason: %s", NetSession::GetErrorCodeCstr(m_lastError)), RGBA::RED);
@@ -862,17 +975,19 @@ const char* NetSession::GetErrorCodeCstr(const NetSession::ErrorCode& code)
         return "Join Error: Your guid is already in use in that session";
     case ERROR_HOST_DISCONNECTED:
         return "Host Disconnected";
+    case JOIN_ERROR_INVALID_INDEX:
+        return "Join Error: Host sent an invalid connection index";
     default:
         ERROR_AND_DIE("Invalid code passed into GetErrorCodeCstr");
     }
 }
 
 //-----------------------------------------------------------------------------------
-bool NetSession::CanProcessMessage(const NetSender& from, const NetMessage& msg) const
+bool NetSession::CanProcessMessage(const NetSender& from, const NetMessageView& msg) const
 {
     if (from.connection == nullptr)
     {
-        return !msg.RequiresConnection();
+        return !msg.RequiresConnection(this);
     }
     else
     {
@@ -916,28 +1031,44 @@ void NetMessageDefinition::ClearControlFlag(NetMessage::Control flag)
     m_controlFlags &= ~(uint8_t)flag;
 }
 
+//-----------------------------------------------------------------------------------
+void NetSession::RegisterCoreMessages()
+{
+    RegisterMessage((uint8_t)NetMessage::PING, "ping", &OnPingReceived, (uint32_t)NetMessage::Option::UNRELIABLE, (uint32_t)NetMessage::Control::PROCESS_CONNECTIONLESS);
+    RegisterMessage((uint8_t)NetMessage::PONG, "pong", &OnPongReceived, (uint32_t)NetMessage::Option::UNRELIABLE, (uint32_t)NetMessage::Control::PROCESS_CONNECTIONLESS);
+    RegisterMessage((uint8_t)NetMessage::HEARTBEAT, "<3", &OnHeartbeatReceived, (uint32_t)NetMessage::Option::RELIABLE, (uint32_t)NetMessage::Control::NONE);
+    RegisterMessage((uint8_t)NetMessage::INORDER_HEARTBEAT, "Inorder<3", &OnHeartbeatReceived, (uint32_t)NetMessage::Option::RELIABLE | (uint32_t)NetMessage::Option::INORDER, (uint32_t)NetMessage::Control::NONE);
+    RegisterMessage((uint8_t)NetMessage::JOIN_REQUEST, "joinRequest", &OnJoinRequestReceived, (uint32_t)NetMessage::Option::RELIABLE, (uint32_t)NetMessage::Control::PROCESS_CONNECTIONLESS);
+    RegisterMessage((uint8_t)NetMessage::JOIN_ACCEPT, "joinAccept", &OnJoinAcceptReceived, (uint32_t)NetMessage::Option::RELIABLE | (uint32_t)NetMessage::Option::INORDER, (uint32_t)NetMessage::Control::NONE);
+    RegisterMessage((uint8_t)NetMessage::JOIN_DENY, "joinDeny", &OnJoinDenyReceived, (uint32_t)NetMessage::Option::UNRELIABLE, (uint32_t)NetMessage::Control::NONE);
+    RegisterMessage((uint8_t)NetMessage::CONNECTION_LEAVE, "connectionLeave", &OnConnectionLeaveReceived, (uint32_t)NetMessage::Option::UNRELIABLE, (uint32_t)NetMessage::Control::PROCESS_CONNECTIONLESS);
+    RegisterMessage((uint8_t)NetMessage::SNAPSHOT, "snapshot", &OnSnapshotReceived, (uint32_t)NetMessage::Option::UNRELIABLE, (uint32_t)NetMessage::Control::NONE);
+}
+
 //-----------------------------------------------------------------------------------
 CONSOLE_COMMAND(nsinit)
 {
-    UNUSED(args)
+    if (!(args.HasArgs(0) || args.HasArgs(1)))
+    {
+        Console::instance->PrintLine("nsinit [maxConnections]", RGBA::RED);
+        return;
+    }
     if (nullptr != NetSession::instance)
     {
         Console::instance->PrintLine("Net session already initialized.", RGBA::ORANGE);
         return;
     }
 
-    NetSession::instance = new NetSession(1.0f/60.0f);
+    uint16_t maxConnections = NetSession::DEFAULT_MAX_CONNECTIONS;
+    if (args.HasArgs(1))
+    {
+        maxConnections = (uint16_t)Clamp<int>(args.GetIntArgument(0), 1, NetSession::MAX_SUPPORTED_CONNECTIONS);
+    }
+    NetSession::instance = new NetSession(1.0f/60.0f, maxConnections);
     NetworkCleanup.RegisterMethod(NetSession::instance, &NetSession::Cleanup);
 
     // Setup
-    NetSession::instance->RegisterMessage((uint8_t)NetMessage::PING, "ping", &OnPingReceived, (uint32_t)NetMessage::Option::UNRELIABLE, (uint32_t)NetMessage::Control::PROCESS_CONNECTIONLESS);
-    NetSession::instance->RegisterMessage((uint8_t)NetMessage::PONG, "pong", &OnPongReceived, (uint32_t)NetMessage::Option::UNRELIABLE, (uint32_t)NetMessage::Control::PROCESS_CONNECTIONLESS);
-    NetSession::instance->RegisterMessage((uint8_t)NetMessage::HEARTBEAT, "<3", &OnHeartbeatReceived, (uint32_t)NetMessage::Option::RELIABLE, (uint32_t)NetMessage::Control::NONE);
-    NetSession::instance->RegisterMessage((uint8_t)NetMessage::INORDER_HEARTBEAT, "Inorder<3", &OnHeartbeatReceived, (uint32_t)NetMessage::Option::RELIABLE | (uint32_t)NetMessage::Option::INORDER, (uint32_t)NetMessage::Control::NONE);
-    NetSession::instance->RegisterMessage((uint8_t)NetMessage::JOIN_REQUEST, "joinRequest", &OnJoinRequestReceived, (uint32_t)NetMessage::Option::RELIABLE, (uint32_t)NetMessage::Control::PROCESS_CONNECTIONLESS);
-    NetSession::instance->RegisterMessage((uint8_t)NetMessage::JOIN_ACCEPT, "joinAccept", &OnJoinAcceptReceived, (uint32_t)NetMessage::Option::RELIABLE | (uint32_t)NetMessage::Option::INORDER, (uint32_t)NetMessage::Control::NONE);
-    NetSession::instance->RegisterMessage((uint8_t)NetMessage::JOIN_DENY, "joinDeny", &OnJoinDenyReceived, (uint32_t)NetMessage::Option::UNRELIABLE, (uint32_t)NetMessage::Control::NONE);
-    NetSession::instance->RegisterMessage((uint8_t)NetMessage::CONNECTION_LEAVE, "connectionLeave", &OnConnectionLeaveReceived, (uint32_t)NetMessage::Option::UNRELIABLE, (uint32_t)NetMessage::Control::PROCESS_CONNECTIONLESS);
+    NetSession::instance->RegisterCoreMessages();
 }
 
 //-----------------------------------------------------------------------------------
@@ -947,7 +1078,8 @@ CONSOLE_COMMAND(nsstart)
     if (NetSession::instance && NetSession::instance->Start(GAME_PORT_STR))
     {
         // Log Success and Connection Address
-        Console::instance->PrintLine(Stringf("Successfully created session at [%s]", NetSystem::SockAddrToString((sockaddr*)&NetSession::instance->m_packetChannel.m_socket.m_address)), RGBA::BADDAD);
+        sockaddr_in address = NetSession::instance->GetAddress();
+        Console::instance->PrintLine(Stringf("Successfully created session at [%s]", NetSystem::SockAddrToString((sockaddr*)&address)), RGBA::BADDAD);
     }
     else 
     {
@@ -1083,6 +1215,50 @@ CONSOLE_COMMAND(setpacketloss)
     }
 }
 
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(nscompress)
+{
+    if (!(args.HasArgs(1)))
+    {
+        Console::instance->PrintLine("nscompress <0 or 1>", RGBA::RED);
+        return;
+    }
+    if (NetSession::instance != nullptr)
+    {
+        NetSession* session = NetSession::instance;
+        session->m_compressionEnabled = args.GetIntArgument(0) != 0;
+        Console::instance->PrintLine(Stringf("Packet compression %s.", session->m_compressionEnabled ? "enabled" : "disabled"), RGBA::GREEN);
+        if (session->m_compressor.m_bytesIn > 0)
+        {
+            Console::instance->PrintLine(Stringf("So far: %i packets compressed, %i sent raw, %.1f%% of original size", (int)session->m_compressor.m_packetsCompressed, (int)session->m_compressor.m_packetsUncompressible, ((float)session->m_compressor.m_bytesOut * 100.0f) / (float)session->m_compressor.m_bytesIn), RGBA::GBWHITE);
+        }
+    }
+    else
+    {
+        Console::instance->PrintLine("NetSession isn't running. Please run NetSessionStart first.", RGBA::RED);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(nstrace)
+{
+    if (!(args.HasArgs(1)))
+    {
+        Console::instance->PrintLine("nstrace <int numPacketsToRecord>", RGBA::RED);
+        return;
+    }
+    if (NetSession::instance != nullptr)
+    {
+        NetSession::instance->m_packetTrace.clear();
+        NetSession::instance->m_maxTracePackets = args.GetIntArgument(0);
+        Console::instance->PrintLine(Stringf("Recording the next %i outgoing packets for netcompressbench.", args.GetIntArgument(0)), RGBA::GREEN);
+    }
+    else
+    {
+        Console::instance->PrintLine("NetSession isn't running. Please run NetSessionStart first.", RGBA::RED);
+    }
+}
+
 //-----------------------------------------------------------------------------------
 CONSOLE_COMMAND(nscreateconn)
 {
@@ -1109,7 +1285,7 @@ CONSOLE_COMMAND(nscreateconn)
             address = NetSystem::StringToSockAddrIPv4(ipPart.c_str(), (uint16_t)std::stoi(portPart));
         }
 
-        NetSession::instance->CreateConnection((uint8_t)args.GetIntArgument(0), guid.c_str(), address);
+        NetSession::instance->CreateConnection((uint16_t)args.GetIntArgument(0), guid.c_str(), address);
         Console::instance->PrintLine(Stringf("Created connection at index %i", args.GetIntArgument(0)), RGBA::ORANGE);
     }
     else
@@ -1128,7 +1304,7 @@ CONSOLE_COMMAND(nsdestroyconn)
     }
     if (nullptr != NetSession::instance)
     {
-        NetSession::instance->Disconnect((uint8_t)args.GetIntArgument(0));
+        NetSession::instance->Disconnect((uint16_t)args.GetIntArgument(0));
         Console::instance->PrintLine(Stringf("Destroyed connection at index %i", args.GetIntArgument(0)), RGBA::ORANGE);        
     }
     else
@@ -1151,7 +1327,8 @@ CONSOLE_COMMAND(nsdebug)
     NetSession::instance->m_netLossText = Console::instance->PrintDynamicLine("Simulated Net Loss: null", RGBA::CHOCOLATE);
     NetSession::instance->m_connectionCountText = Console::instance->PrintDynamicLine("Connection Count: null", RGBA::CHOCOLATE);
     NetSession::instance->m_connectionsText.clear();
-    for (unsigned int i = 0; i < NetSession::MAX_CONNECTIONS; ++i)
+    unsigned int numLines = Min<unsigned int>(NetSession::instance->m_maxConnections, NetSession::MAX_DEBUG_CONNECTION_LINES);
+    for (unsigned int i = 0; i < numLines; ++i)
     {
         NetSession::instance->m_connectionsText.push_back(Console::instance->PrintDynamicLine(Stringf("  [%i] No Connection", i), RGBA::CHOCOLATE));
     }
@@ -1368,4 +1545,267 @@ CONSOLE_COMMAND(go)
     Console::instance->RunCommand("bcmd nscreateconn 1 left 10.8.151.65:4335");
     Console::instance->RunCommand("nsdebug");
     Console::instance->RunCommand("rcmd nsdebug");
+}
+
+//-----------------------------------------------------------------------------------
+static void OnSoakMessageReceived(const NetSender& sender, NetMessageView& msg)
+{
+    UNUSED(sender);
+    uint32_t tick = 0;
+    msg.Read<uint32_t>(tick);
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(nssoak)
+{
+    if (!(args.HasArgs(0) || args.HasArgs(1) || args.HasArgs(2)))
+    {
+        Console::instance->PrintLine("nssoak [numClients] [numTicks]", RGBA::RED);
+        return;
+    }
+    //An in-process server that's never bound. Every client is a synthetic address whose packets get written straight
+    //into ProcessIncomingPacket, and the server's own sends go out an invalid socket, so what's timed is the session.
+    int numClients = args.HasArgs(0) ? 256 : Clamp<int>(args.GetIntArgument(0), 1, NetSession::MAX_SUPPORTED_CONNECTIONS - 1);
+    int numTicks = args.HasArgs(2) ? args.GetIntArgument(1) : 600;
+    const float TICK_SECONDS = 1.0f / 60.0f;
+    const uint8_t SOAK_MESSAGE = NetMessage::NUM_MESSAGES;
+    const int INPUT_INTERVAL_TICKS = 2; //Each client sends input every other tick
+    const int STATE_INTERVAL_TICKS = 4; //and the server pushes state to each client every fourth
+    const int NUM_LOOKUPS_PER_CLIENT = 64;
+
+    NetSession* server = new NetSession(TICK_SECONDS, (uint16_t)(numClients + 1));
+    server->RegisterCoreMessages();
+    server->RegisterMessage(SOAK_MESSAGE, "soak", &OnSoakMessageReceived, (uint32_t)NetMessage::Option::UNRELIABLE, (uint32_t)NetMessage::Control::NONE);
+
+    server->m_packetChannel.m_socket.m_address = NetSystem::StringToSockAddrIPv4("127.0.0.1", GAME_PORT);
+    server->m_hostConnection = server->CreateConnection(0, "soakHost", server->GetAddress());
+    server->m_myConnection = server->m_hostConnection;
+
+    std::vector<sockaddr_in> clientAddresses(numClients);
+    std::vector<uint16_t> clientAcks(numClients, 0);
+    for (int i = 0; i < numClients; ++i)
+    {
+        sockaddr_in& address = clientAddresses[i];
+        address = server->GetAddress();
+        address.sin_addr.s_addr = htonl(0x0A000001 + i);
+        address.sin_port = htons((uint16_t)(GAME_PORT + 1 + (i % 8)));
+
+        std::string guid = Stringf("soak%i", i);
+        guid.resize(NetConnection::MAX_GUID_LENGTH, '\0');
+        NetConnection* conn = server->CreateConnection((uint16_t)(i + 1), guid.c_str(), address);
+        conn->m_state = NetConnection::State::CONFIRMED;
+    }
+
+    std::vector<double> tickMs;
+    tickMs.reserve(numTicks);
+    double receiveSeconds = 0.0;
+    NetSender from;
+    from.session = server;
+    for (int tick = 0; tick < numTicks; ++tick)
+    {
+        //Client -> server
+        double startSeconds = GetCurrentTimeSeconds();
+        for (int i = 0; i < numClients; ++i)
+        {
+            if ((i + tick) % INPUT_INTERVAL_TICKS != 0)
+            {
+                continue;
+            }
+            NetConnection* conn = server->GetConnection((uint16_t)(i + 1));
+            NetPacket packet((uint16_t)(i + 1));
+            packet.m_header.ack = clientAcks[i]++;
+            packet.m_header.highestReceivedAck = conn->GetLastSentAck();
+            packet.m_header.previousReceivedAcksBitfield = 0xFFFF;
+            packet.WriteHeader();
+            uint8_t* msgsWritten = packet.GetMessageCountBookmark();
+            NetMessage input(SOAK_MESSAGE);
+            input.Write<uint32_t>((uint32_t)tick);
+            *msgsWritten = (packet.WriteMessage(&input) > 0) ? 1 : 0;
+            packet.SetReadableBytes(packet.GetTotalReadableBytes());
+
+            from.address = clientAddresses[i];
+            server->ProcessIncomingPacket(from, packet);
+        }
+        receiveSeconds += GetCurrentTimeSeconds() - startSeconds;
+
+        //Server -> client
+        for (int i = 0; i < numClients; ++i)
+        {
+            if ((i + tick) % STATE_INTERVAL_TICKS == 0)
+            {
+                NetMessage state(SOAK_MESSAGE);
+                state.Write<uint32_t>((uint32_t)tick);
+                server->GetConnection((uint16_t)(i + 1))->SendMessage(state);
+            }
+        }
+
+        startSeconds = GetCurrentTimeSeconds();
+        server->Update(TICK_SECONDS);
+        tickMs.push_back((GetCurrentTimeSeconds() - startSeconds) * 1000.0);
+    }
+
+    //Address lookups, hashed against the linear scan they replaced
+    double startSeconds = GetCurrentTimeSeconds();
+    unsigned int hashedHits = 0;
+    for (int lookup = 0; lookup < NUM_LOOKUPS_PER_CLIENT; ++lookup)
+    {
+        for (int i = 0; i < numClients; ++i)
+        {
+            hashedHits += (server->GetConnectionIndexFromAddress(clientAddresses[i]) != NetSession::INVALID_CONNECTION_INDEX) ? 1 : 0;
+        }
+    }
+    double hashedSeconds = GetCurrentTimeSeconds() - startSeconds;
+    startSeconds = GetCurrentTimeSeconds();
+    unsigned int linearHits = 0;
+    for (int lookup = 0; lookup < NUM_LOOKUPS_PER_CLIENT; ++lookup)
+    {
+        for (int i = 0; i < numClients; ++i)
+        {
+            for (uint16_t index = 0; index < server->m_maxConnections; ++index)
+            {
+                NetConnection* conn = server->m_allConnections[index];
+                if (conn && NetSystem::SockaddrCompare(conn->m_address, clientAddresses[i]))
+                {
+                    ++linearHits;
+                    break;
+                }
+            }
+        }
+    }
+    double linearSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+    //Report
+    uint32_t packetsSent = 0;
+    for (uint16_t index : server->m_liveConnectionIndices)
+    {
+        packetsSent += server->m_allConnections[index]->m_packetsSent;
+    }
+    std::vector<double> sortedTickMs = tickMs;
+    std::sort(sortedTickMs.begin(), sortedTickMs.end());
+    double totalTickMs = 0.0;
+    for (double ms : tickMs)
+    {
+        totalTickMs += ms;
+    }
+    int numSamples = Max<int>((int)tickMs.size(), 1);
+    double p99TickMs = sortedTickMs.empty() ? 0.0 : sortedTickMs[Min<size_t>((size_t)(sortedTickMs.size() * 0.99), sortedTickMs.size() - 1)];
+    double maxTickMs = sortedTickMs.empty() ? 0.0 : sortedTickMs.back();
+    int numLookups = Max<int>(numClients * NUM_LOOKUPS_PER_CLIENT, 1);
+
+    Console::instance->PrintLine(Stringf("Net soak: %i clients, %i ticks", numClients, numTicks), RGBA::GBWHITE);
+    Console::instance->PrintLine(Stringf("  Server Update: avg %.3fms, p99 %.3fms, max %.3fms per tick", totalTickMs / numSamples, p99TickMs, maxTickMs), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("  Packet receive: avg %.3fms per tick", (receiveSeconds * 1000.0) / numSamples), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("  Packets sent: %i of %i possible (%.1f%%)", (int)packetsSent, (numClients + 1) * numTicks, (packetsSent * 100.0f) / Max<float>((float)((numClients + 1) * numTicks), 1.0f)), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("  Address lookup: hashed %.1fns, linear %.1fns (%i/%i hits)", (hashedSeconds * 1e9) / numLookups, (linearSeconds * 1e9) / numLookups, hashedHits, linearHits), RGBA::CORNFLOWER_BLUE);
+
+    delete server;
+}
+
+//-----------------------------------------------------------------------------------
+static uint64_t s_dispatchBenchChecksum = 0;
+
+//-----------------------------------------------------------------------------------
+static void OnDispatchBenchMessageReceived(const NetSender& sender, NetMessageView& msg)
+{
+    UNUSED(sender);
+    uint32_t value = 0;
+    msg.Read<uint32_t>(value);
+    s_dispatchBenchChecksum += value;
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(netdispatchbench)
+{
+    if (!(args.HasArgs(0) || args.HasArgs(1)))
+    {
+        Console::instance->PrintLine("netdispatchbench [numPackets]", RGBA::RED);
+        return;
+    }
+    //One full packet of small connectionless messages, dispatched over and over on this thread.
+    //The copy path is the old receive side: every payload copied into a stack NetMessage first.
+    int numPackets = args.HasArgs(0) ? 20000 : Max<int>(args.GetIntArgument(0), 1);
+    const uint8_t DISPATCH_MESSAGE = NetMessage::NUM_MESSAGES;
+    const int PAYLOAD_WORDS = 4;
+
+    NetSession* session = new NetSession(0.0f, 1);
+    session->RegisterCoreMessages();
+    session->RegisterMessage(DISPATCH_MESSAGE, "dispatchBench", &OnDispatchBenchMessageReceived, (uint32_t)NetMessage::Option::UNRELIABLE, (uint32_t)NetMessage::Control::PROCESS_CONNECTIONLESS);
+
+    NetPacket packet(NetPacket::INVALID_CONNECTION_INDEX);
+    packet.m_header.ack = 0;
+    packet.m_header.highestReceivedAck = NetConnection::INVALID_PACKET_ACK;
+    packet.m_header.previousReceivedAcksBitfield = 0;
+    packet.WriteHeader();
+    uint8_t* msgsWritten = packet.GetMessageCountBookmark();
+    int numMessages = 0;
+    while (numMessages < 0xFF)
+    {
+        NetMessage msg(DISPATCH_MESSAGE);
+        for (int word = 0; word < PAYLOAD_WORDS; ++word)
+        {
+            msg.Write<uint32_t>((uint32_t)(numMessages + word));
+        }
+        if (packet.WriteMessage(&msg) == 0)
+        {
+            break;
+        }
+        ++numMessages;
+    }
+    *msgsWritten = (uint8_t)numMessages;
+    size_t packetSize = packet.GetTotalReadableBytes();
+
+    NetSender from;
+    from.session = session;
+    from.connection = nullptr;
+    from.address = session->GetAddress();
+
+    s_dispatchBenchChecksum = 0;
+    double startSeconds = GetCurrentTimeSeconds();
+    for (int packetIndex = 0; packetIndex < numPackets; ++packetIndex)
+    {
+        packet.SetReadableBytes(packetSize);
+        packet.ReadHeader();
+        NetMessage msg;
+        for (uint8_t i = 0; i < packet.m_header.messageCount; ++i)
+        {
+            packet.ReadMessage(msg);
+            msg.Process(from);
+        }
+    }
+    double copySeconds = GetCurrentTimeSeconds() - startSeconds;
+    uint64_t copyChecksum = s_dispatchBenchChecksum;
+
+    s_dispatchBenchChecksum = 0;
+    startSeconds = GetCurrentTimeSeconds();
+    for (int packetIndex = 0; packetIndex < numPackets; ++packetIndex)
+    {
+        packet.SetReadableBytes(packetSize);
+        packet.ReadHeader();
+        NetMessageView view;
+        for (uint8_t i = 0; i < packet.m_header.messageCount; ++i)
+        {
+            packet.ReadMessageView(view);
+            view.Process(from);
+        }
+    }
+    double viewSeconds = GetCurrentTimeSeconds() - startSeconds;
+    uint64_t viewChecksum = s_dispatchBenchChecksum;
+
+    s_dispatchBenchChecksum = 0;
+    startSeconds = GetCurrentTimeSeconds();
+    for (int packetIndex = 0; packetIndex < numPackets; ++packetIndex)
+    {
+        packet.SetReadableBytes(packetSize);
+        session->ProcessIncomingPacket(from, packet);
+    }
+    double sessionSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+    double totalMessages = (double)numPackets * numMessages;
+    Console::instance->PrintLine(Stringf("Net dispatch: %i packets of %i messages (%i byte payloads)", numPackets, numMessages, PAYLOAD_WORDS * (int)sizeof(uint32_t)), RGBA::GBWHITE);
+    Console::instance->PrintLine(Stringf("  Copy: %.2fM msgs/sec", totalMessages / Max<double>(copySeconds, 1e-9) / 1e6), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("  View: %.2fM msgs/sec (%.2fx)", totalMessages / Max<double>(viewSeconds, 1e-9) / 1e6, copySeconds / Max<double>(viewSeconds, 1e-9)), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("  ProcessIncomingPacket: %.2fM msgs/sec", totalMessages / Max<double>(sessionSeconds, 1e-9) / 1e6), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("  Checksums %s", (copyChecksum == viewChecksum) ? "match" : "DIFFER"), (copyChecksum == viewChecksum) ? RGBA::FOREST_GREEN : RGBA::RED);
+
+    delete session;
 }
\ No newline at end of file
@@ -1,7 +1,10 @@
 #pragma once
 #include "Engine/Net/UDPIP/PacketChannel.hpp"
 #include "Engine/Net/UDPIP/NetMessage.hpp"
+#include "Engine/Net/UDPIP/NetCompressor.hpp"
 #include "Engine/Core/Events/Event.hpp"
+#include "Engine/Input/ConsoleScrollback.hpp"
+#include <unordered_map>
 
 #define GAME_PORT_STR "4334"
 #define GAME_PORT 4334
@@ -10,7 +13,7 @@
 
 class NetSession;
 class NetConnection;
-struct ColoredText;
+class NetReplicator;
 
 //-----------------------------------------------------------------------------------
 struct NetSender
@@ -27,7 +30,7 @@ struct NetSender
     NetConnection* connection;
 };
 
-typedef void(NetMessageCallback)(const NetSender&, NetMessage&);
+typedef void(NetMessageCallback)(const NetSender&, NetMessageView&);
 
 //-----------------------------------------------------------------------------------
 struct NetMessageDefinition
@@ -82,11 +85,12 @@ public:
         JOIN_DENIED_FULL,
         JOIN_DENIED_GUID_IN_USE,
         ERROR_HOST_DISCONNECTED,
+        JOIN_ERROR_INVALID_INDEX,
         NUM_CODES
     };
 
     //CONSTRUCTOS/////////////////////////////////////////////////////////////////////
-    NetSession(float tickRatePerSecond);
+    NetSession(float tickRatePerSecond, uint16_t maxConnections = DEFAULT_MAX_CONNECTIONS);
     ~NetSession();
 
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
@@ -96,6 +100,7 @@ public:
     void Update(float deltaSeconds);
     void UpdateNetDebug();
     void ShutdownNetDebug();
+    void RegisterCoreMessages();
 
     void Host(const char* username);
     void Join(const char* username, sockaddr_in& hostAddress);
@@ -103,26 +108,28 @@ public:
 
     void ProcessIncomingPackets(const size_t maxPacketsToProcess = INFINITY);
     void ProcessIncomingPacket(NetSender& from, NetPacket& packet);
+    bool DecompressIncomingPacket(NetPacket& packet, size_t& packetSize);
+    size_t SendPacket(const sockaddr_in& to, NetPacket& packet);
     void RegisterMessage(uint8_t type, const char* messageName, NetMessageCallback* functionPointer, uint32_t optionFlags, uint32_t controlFlags);
     void SendMessageDirect(const sockaddr_in& to, const NetMessage& msg);
     size_t SendMessagesDirect(sockaddr_in& to, NetMessage** messages, size_t numMessages);
-    bool Connect(NetConnection* cp, const uint8_t idx);
+    bool Connect(NetConnection* cp, const uint16_t idx);
     void Disconnect(NetConnection* cp);
-    void Disconnect(uint8_t index);
+    void Disconnect(uint16_t index);
     void CheckForTimeouts();
     void CheckForJoinResponse();
-    NetConnection* CreateConnection(uint8_t index, const char* guid, sockaddr_in address);
-    void DestroyConnection(uint8_t index);
+    NetConnection* CreateConnection(uint16_t index, const char* guid, sockaddr_in address);
+    void DestroyConnection(uint16_t index);
 
     //QUERIES/////////////////////////////////////////////////////////////////////
-    NetConnection* GetConnection(uint8_t index);
+    NetConnection* GetConnection(uint16_t index);
     inline NetConnection* GetMyConnection() { return m_myConnection; };
     inline NetConnection* GetHostConnection() { return m_hostConnection; };
-    uint8_t GetMyConnectionIndex();
-    uint8_t GetConnectionIndexFromAddress(const sockaddr_in& address);
+    uint16_t GetMyConnectionIndex();
+    uint16_t GetConnectionIndexFromAddress(const sockaddr_in& address);
     void SendDeny(ErrorCode reason, const sockaddr_in& address);
-    const NetMessageDefinition* FindDefinition(byte messageType);
-    bool CanProcessMessage(const NetSender& from, const NetMessage& msg) const;
+    const NetMessageDefinition* FindDefinition(byte messageType) const;
+    bool CanProcessMessage(const NetSender& from, const NetMessageView& msg) const;
     bool IsRunning();
     bool IsHost();
     bool AmIConnected();
@@ -130,8 +137,9 @@ public:
     static const char* GetErrorCodeCstr(const ErrorCode& code);
     bool IsPartyFull();
     bool IsGuidInUse(const char* guid);
-    uint8_t GetNextAvailableIndex();
+    uint16_t GetNextAvailableIndex();
     sockaddr_in GetAddress() { return m_packetChannel.GetAddress(); };
+    inline double GetNetTimeMilliseconds() { return m_packetChannel.GetCurrentTimeMilliseconds(); }; //Virtual time if the transport is simulated
 
     //STATE MANAGEMENT/////////////////////////////////////////////////////////////////////
     bool SetSessionState(State newState, void(NetSession::*onStateSwitchCallback)() = nullptr);
@@ -139,10 +147,16 @@ public:
     const char* GetStateCstr(const State& state);
     void OnEnterDisconnectedState();
     bool HasConnectionFor(const sockaddr_in& address);
+
+    //STATIC FUNCTIONS/////////////////////////////////////////////////////////////////////
+    static inline uint64_t GetAddressKey(const sockaddr_in& address) { return ((uint64_t)address.sin_addr.s_addr << 16) | (uint64_t)address.sin_port; };
+
     //CONSTANTS/////////////////////////////////////////////////////////////////////
-    static const uint8_t MAX_CONNECTIONS = 8;
-    static const uint8_t INVALID_CONNECTION_INDEX = 255;
+    static const uint16_t DEFAULT_MAX_CONNECTIONS = 8;
+    static const uint16_t MAX_SUPPORTED_CONNECTIONS = 1024; //Must stay below 0xFE00, see NetPacket::COMPRESSED_PACKET_MARKER
+    static const uint16_t INVALID_CONNECTION_INDEX = 0xFFFF;
     static const int MAX_DEFINITIONS = 256;
+    static const unsigned int MAX_DEBUG_CONNECTION_LINES = 16;
 
     //STATIC VARIABLES/////////////////////////////////////////////////////////////////////
     static NetSession* instance;
@@ -150,7 +164,10 @@ public:
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
     PacketChannel m_packetChannel;
     NetMessageDefinition m_netMessageDefinitions[MAX_DEFINITIONS]; //container of definitions
-    NetConnection* m_allConnections[MAX_CONNECTIONS];
+    std::vector<NetConnection*> m_allConnections; //Indexed by connection index, m_maxConnections long
+    std::vector<uint16_t> m_liveConnectionIndices; //Dense list of the occupied slots above, in no particular order
+    std::vector<uint16_t> m_tickConnectionIndices; //Scratch copy of the live list, safe to walk while connections come and go
+    std::unordered_map<uint64_t, uint16_t> m_connectionIndexLookup; //GetAddressKey() -> connection index
     NetConnection* m_myConnection;
     NetConnection* m_hostConnection;
     Event<NetConnection*> m_OnConnectionJoin;
@@ -161,15 +178,23 @@ public:
     double m_timeLastJoinRequestSent;
     float m_tickRate;
     unsigned int m_numConnections;
+    uint16_t m_maxConnections;
     State m_sessionState;
     ErrorCode m_lastError;
     bool m_timeoutEnabled;
     bool m_isListening;
+    NetReplicator* m_replicator; //Optional. Once set, the session owns it and snapshots ride along with every net tick.
+
+    //Packet compression. Incoming compressed packets are always understood, this only controls what we send.
+    NetCompressor m_compressor;
+    bool m_compressionEnabled;
+    std::vector<std::vector<byte>> m_packetTrace; //Outgoing packets, pre-compression, recorded for tuning the dictionary
+    size_t m_maxTracePackets;
 
     //NetDebug console line references, used for making a dynamic updates in my god-awful console.
-    ColoredText* m_sessionInfoText;
-    ColoredText* m_netLagText;
-    ColoredText* m_netLossText;
-    ColoredText* m_connectionCountText;
-    std::vector<ColoredText*> m_connectionsText;
+    ConsoleLineHandle m_sessionInfoText;
+    ConsoleLineHandle m_netLagText;
+    ConsoleLineHandle m_netLossText;
+    ConsoleLineHandle m_connectionCountText;
+    std::vector<ConsoleLineHandle> m_connectionsText;
 };
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+#pragma comment(lib, "ws2_32")
+#include <stdint.h>
+#include <WinSock2.h>
+#include <WS2tcpip.h>
+
+//-----------------------------------------------------------------------------------
+// What a PacketChannel sends and receives datagrams through. UDPSocket is the real one,
+// SimulatedTransport plugs a session into an in-process SimulatedNetwork instead.
+// The transport also owns the clock, so everything timed off a session (acks, resends,
+// timeouts, simulated lag) runs on virtual time when the network is simulated.
+class NetTransport
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    virtual ~NetTransport() {};
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    virtual void Bind(const char* address, const char* portNumber) = 0;
+    virtual void Unbind() = 0;
+    virtual bool IsBound() = 0;
+    virtual size_t SendTo(const sockaddr_in& toAddress, void const* data, const size_t dataSize) = 0;
+    virtual size_t RecieveFrom(sockaddr_in& fromAddress, void* buffer) = 0; //Returns 0 when nothing is waiting
+    virtual sockaddr_in GetAddress() = 0;
+    virtual double GetCurrentTimeMilliseconds() = 0;
+};
\ No newline at end of file
@@ -1,11 +1,12 @@
 #include "Engine/Net/UDPIP/PacketChannel.hpp"
-#include "Engine/Time/Time.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
 
 //-----------------------------------------------------------------------------------
 PacketChannel::PacketChannel()
     : m_additionalLagMilliseconds(0.0f, 0.0f)
     , m_dropRate(0.0f)
     , m_pool(2048)
+    , m_transport(&m_socket)
 {
 
 }
@@ -16,10 +17,17 @@ PacketChannel::~PacketChannel()
 
 }
 
+//-----------------------------------------------------------------------------------
+void PacketChannel::SetTransport(NetTransport* transport)
+{
+    ASSERT_OR_DIE(!IsBound(), "Swapped the transport out from under a bound packet channel");
+    m_transport = (transport != nullptr) ? transport : &m_socket;
+}
+
 //-----------------------------------------------------------------------------------
 size_t PacketChannel::SendTo(const sockaddr_in& toAddress, void const* data, const size_t dataSize)
 {
-    return m_socket.SendTo(toAddress, data, dataSize);
+    return m_transport->SendTo(toAddress, data, dataSize);
 }
 
 //-----------------------------------------------------------------------------------
@@ -29,7 +37,7 @@ void PacketChannel::ReceiveOffSocket(sockaddr_in& fromAddress)
     do 
     {
         TimeStampedPacket* timeStamped = m_pool.Alloc<TimeStampedPacket>();
-        read = m_socket.RecieveFrom(fromAddress, timeStamped->packet.m_buffer);
+        read = m_transport->RecieveFrom(fromAddress, timeStamped->packet.m_buffer);
         timeStamped->packet.m_fromAddress = fromAddress;
         if (read > 0)
         {
@@ -41,7 +49,7 @@ void PacketChannel::ReceiveOffSocket(sockaddr_in& fromAddress)
             {
                 double delay = m_additionalLagMilliseconds.GetRandom();
                 timeStamped->packet.SetReadableBytes(read);
-                timeStamped->timeToProcess = GetCurrentTimeMilliseconds() + delay;
+                timeStamped->timeToProcess = m_transport->GetCurrentTimeMilliseconds() + delay;
                 m_inboundPackets.Enqueue(timeStamped);
             }
         }
@@ -58,7 +66,7 @@ size_t PacketChannel::RecieveFrom(sockaddr_in& fromAddress, void* buffer)
     ReceiveOffSocket(fromAddress);
     if (m_inboundPackets.Size() > 0)
     {
-        double curentTimeMilliseconds = GetCurrentTimeMilliseconds();
+        double curentTimeMilliseconds = m_transport->GetCurrentTimeMilliseconds();
         if (curentTimeMilliseconds >= m_inboundPackets.Peek()->timeToProcess)
         {
             TimeStampedPacket* tsp = m_inboundPackets.Dequeue();
@@ -76,6 +84,6 @@ size_t PacketChannel::RecieveFrom(sockaddr_in& fromAddress, void* buffer)
 //-----------------------------------------------------------------------------------
 sockaddr_in PacketChannel::GetAddress()
 {
-    return m_socket.m_address;
+    return m_transport->GetAddress();
 }
 
@@ -43,15 +43,19 @@ public:
     ~PacketChannel();
 
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
-    inline void Bind(const char* address, const char* portNumber) { m_socket.Bind(address, portNumber); };
-    inline void Unbind() { m_socket.Unbind(); };
-    inline bool IsBound() { return m_socket.IsBound(); };
+    inline void Bind(const char* address, const char* portNumber) { m_transport->Bind(address, portNumber); };
+    inline void Unbind() { m_transport->Unbind(); };
+    inline bool IsBound() { return m_transport->IsBound(); };
+    inline double GetCurrentTimeMilliseconds() { return m_transport->GetCurrentTimeMilliseconds(); };
+    inline NetTransport* GetTransport() { return m_transport; };
+    void SetTransport(NetTransport* transport); //Not owned. nullptr goes back to the socket.
     size_t SendTo(const sockaddr_in& toAddress, void const* data, const size_t dataSize);
     size_t RecieveFrom(sockaddr_in& fromAddress, void* buffer);
     sockaddr_in GetAddress();
     void ReceiveOffSocket(sockaddr_in& fromAddress);
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
     UDPSocket m_socket;
+    NetTransport* m_transport; //What we actually send through, m_socket unless something else was plugged in
     float m_dropRate;
     ThreadSafePriorityQueue<TimeStampedPacket*, TimeStampedPacketComparison> m_inboundPackets;
     Range<double> m_additionalLagMilliseconds;
@@ -0,0 +1,506 @@
+#include "Engine/Net/UDPIP/SimulatedNetwork.hpp"
+#include "Engine/Net/UDPIP/NetSession.hpp"
+#include "Engine/Net/UDPIP/NetConnection.hpp"
+#include "Engine/Net/NetSystem.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Time/Time.hpp"
+#include <algorithm>
+#include <math.h>
+
+//-----------------------------------------------------------------------------------
+SimulatedTransport::SimulatedTransport(SimulatedNetwork* network)
+    : m_network(network)
+    , m_isBound(false)
+    , m_uplinkFreeTimeMs(0.0)
+{
+    memset(&m_address, 0, sizeof(m_address));
+}
+
+//-----------------------------------------------------------------------------------
+SimulatedTransport::~SimulatedTransport()
+{
+    Unbind();
+}
+
+//-----------------------------------------------------------------------------------
+void SimulatedTransport::Bind(const char* address, const char* portNumber)
+{
+    //The network hands out its own addresses, only the port is kept.
+    UNUSED(address);
+    if (!m_isBound)
+    {
+        m_address = m_network->AttachTransport(this, (uint16_t)atoi(portNumber));
+        m_isBound = true;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void SimulatedTransport::Unbind()
+{
+    if (m_isBound)
+    {
+        m_network->DetachTransport(this);
+        m_inbox.clear();
+        m_isBound = false;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+size_t SimulatedTransport::SendTo(const sockaddr_in& toAddress, void const* data, const size_t dataSize)
+{
+    if (!m_isBound)
+    {
+        return 0;
+    }
+    m_network->Send(this, toAddress, data, dataSize);
+    return dataSize;
+}
+
+//-----------------------------------------------------------------------------------
+size_t SimulatedTransport::RecieveFrom(sockaddr_in& fromAddress, void* buffer)
+{
+    if (m_inbox.empty())
+    {
+        return 0;
+    }
+    Datagram& datagram = m_inbox.front();
+    size_t size = datagram.data.size();
+    fromAddress = datagram.fromAddress;
+    memcpy(buffer, datagram.data.data(), size);
+    m_inbox.pop_front();
+    return size;
+}
+
+//-----------------------------------------------------------------------------------
+double SimulatedTransport::GetCurrentTimeMilliseconds()
+{
+    return m_network->GetCurrentTimeMilliseconds();
+}
+
+//-----------------------------------------------------------------------------------
+SimulatedNetwork::SimulatedNetwork(uint64_t seed, const SimulatedLinkSettings& settings)
+    : m_settings(settings)
+    , m_packetsSent(0)
+    , m_packetsDelivered(0)
+    , m_packetsLost(0)
+    , m_packetsDroppedByQueue(0)
+    , m_packetsDuplicated(0)
+    , m_packetsReordered(0)
+    , m_packetsUnroutable(0)
+    , m_bytesDelivered(0)
+    , m_currentTimeMs(0.0)
+    , m_randomState(seed)
+    , m_nextSequence(0)
+    , m_nextHostAddress(BASE_ADDRESS)
+{
+}
+
+//-----------------------------------------------------------------------------------
+SimulatedNetwork::~SimulatedNetwork()
+{
+    while (!m_inFlight.empty())
+    {
+        delete m_inFlight.top();
+        m_inFlight.pop();
+    }
+    for (auto& pair : m_transports)
+    {
+        pair.second->m_network = nullptr;
+        pair.second->m_isBound = false;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void SimulatedNetwork::AdvanceTime(double deltaMs)
+{
+    m_currentTimeMs += deltaMs;
+    while (!m_inFlight.empty() && m_inFlight.top()->arrivalTimeMs <= m_currentTimeMs)
+    {
+        InFlightPacket* packet = m_inFlight.top();
+        m_inFlight.pop();
+        auto found = m_transports.find(packet->toAddressKey);
+        if (found != m_transports.end())
+        {
+            ++m_packetsDelivered;
+            m_bytesDelivered += packet->datagram.data.size();
+            found->second->m_inbox.push_back(std::move(packet->datagram));
+        }
+        else
+        {
+            ++m_packetsUnroutable; //Receiver went away while this was in the air
+        }
+        delete packet;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+sockaddr_in SimulatedNetwork::AttachTransport(SimulatedTransport* transport, uint16_t port)
+{
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(m_nextHostAddress++);
+    address.sin_port = htons(port);
+    m_transports[NetSession::GetAddressKey(address)] = transport;
+    return address;
+}
+
+//-----------------------------------------------------------------------------------
+void SimulatedNetwork::DetachTransport(SimulatedTransport* transport)
+{
+    auto found = m_transports.find(NetSession::GetAddressKey(transport->m_address));
+    if (found != m_transports.end() && found->second == transport)
+    {
+        m_transports.erase(found);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void SimulatedNetwork::Send(SimulatedTransport* from, const sockaddr_in& toAddress, const void* data, size_t dataSize)
+{
+    ++m_packetsSent;
+    uint64_t toAddressKey = NetSession::GetAddressKey(toAddress);
+    if (m_transports.find(toAddressKey) == m_transports.end())
+    {
+        ++m_packetsUnroutable;
+        return;
+    }
+
+    //Serialize onto the sender's uplink first, a full queue drops the packet before it ever leaves.
+    double departureTimeMs = m_currentTimeMs;
+    if (m_settings.bandwidthBytesPerSecond > 0.0)
+    {
+        double startTimeMs = Max<double>(m_currentTimeMs, from->m_uplinkFreeTimeMs);
+        if (startTimeMs - m_currentTimeMs > m_settings.maxQueueDelayMs)
+        {
+            ++m_packetsDroppedByQueue;
+            return;
+        }
+        departureTimeMs = startTimeMs + (((double)dataSize * 1000.0) / m_settings.bandwidthBytesPerSecond);
+        from->m_uplinkFreeTimeMs = departureTimeMs;
+    }
+
+    if (GetRandomDouble() < m_settings.lossRate)
+    {
+        ++m_packetsLost;
+        return;
+    }
+
+    double arrivalTimeMs = departureTimeMs + SampleLatencyMs();
+    if (GetRandomDouble() < m_settings.reorderRate)
+    {
+        ++m_packetsReordered;
+        arrivalTimeMs += m_settings.reorderDelayMs;
+    }
+    Enqueue(arrivalTimeMs, toAddressKey, from->m_address, data, dataSize);
+
+    if (GetRandomDouble() < m_settings.duplicateRate)
+    {
+        ++m_packetsDuplicated;
+        Enqueue(departureTimeMs + SampleLatencyMs(), toAddressKey, from->m_address, data, dataSize);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+uint64_t SimulatedNetwork::GetRandomBits()
+{
+    uint64_t z = (m_randomState += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+//-----------------------------------------------------------------------------------
+double SimulatedNetwork::GetRandomDouble()
+{
+    return (double)(GetRandomBits() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+//-----------------------------------------------------------------------------------
+double SimulatedNetwork::SampleLatencyMs()
+{
+    switch (m_settings.latencyDistribution)
+    {
+    case SimulatedLinkSettings::UNIFORM:
+        return m_settings.baseLatencyMs + (GetRandomDouble() * m_settings.jitterMs);
+    case SimulatedLinkSettings::NORMAL:
+    {
+        //Box-Muller, folded so nothing arrives before the base latency
+        double u1 = Max<double>(GetRandomDouble(), 1e-12);
+        double u2 = GetRandomDouble();
+        double gaussian = sqrt(-2.0 * log(u1)) * cos(2.0 * MathUtils::PI * u2);
+        return m_settings.baseLatencyMs + (fabs(gaussian) * m_settings.jitterMs);
+    }
+    case SimulatedLinkSettings::EXPONENTIAL:
+        return m_settings.baseLatencyMs - (log(Max<double>(1.0 - GetRandomDouble(), 1e-12)) * m_settings.jitterMs);
+    case SimulatedLinkSettings::CONSTANT:
+    default:
+        return m_settings.baseLatencyMs;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void SimulatedNetwork::Enqueue(double arrivalTimeMs, uint64_t toAddressKey, const sockaddr_in& fromAddress, const void* data, size_t dataSize)
+{
+    InFlightPacket* packet = new InFlightPacket();
+    packet->arrivalTimeMs = arrivalTimeMs;
+    packet->sequence = m_nextSequence++;
+    packet->toAddressKey = toAddressKey;
+    packet->datagram.fromAddress = fromAddress;
+    packet->datagram.data.assign((const byte*)data, (const byte*)data + dataSize);
+    m_inFlight.push(packet);
+}
+
+//-----------------------------------------------------------------------------------
+struct SimulationBenchState
+{
+    SimulatedNetwork* network;
+    std::vector<std::vector<double>> sendTimesMs; //[client][sequence]
+    std::vector<uint32_t> nextExpectedSequence; //[client]
+    std::vector<double> latenciesMs;
+    uint32_t outOfOrder;
+    uint64_t payloadBytes;
+    uint64_t digest;
+};
+
+//-----------------------------------------------------------------------------------
+struct SimulationBenchResults
+{
+    double wallSeconds;
+    double virtualSeconds;
+    int clientsConnected;
+    uint32_t messagesSent;
+    uint32_t outOfOrder;
+    uint64_t payloadBytes;
+    uint64_t digest;
+    std::vector<double> latenciesMs;
+    SimulatedNetwork* network;
+};
+
+static SimulationBenchState* s_benchState = nullptr;
+static const uint8_t SIM_BENCH_MESSAGE = NetMessage::NUM_MESSAGES;
+static const size_t SIM_BENCH_PAYLOAD_SIZE = 32;
+
+//-----------------------------------------------------------------------------------
+static void MixIntoDigest(uint64_t& digest, uint64_t value)
+{
+    //FNV-1a, a byte at a time
+    for (int i = 0; i < 8; ++i)
+    {
+        digest ^= (value >> (i * 8)) & 0xFF;
+        digest *= 0x100000001B3ull;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+static void OnSimBenchMessageReceived(const NetSender& sender, NetMessageView& msg)
+{
+    if (!s_benchState)
+    {
+        return;
+    }
+    uint16_t clientIndex = 0;
+    uint32_t sequence = 0;
+    msg.Read<uint16_t>(clientIndex);
+    msg.Read<uint32_t>(sequence);
+    if (clientIndex >= s_benchState->sendTimesMs.size() || sequence >= s_benchState->sendTimesMs[clientIndex].size())
+    {
+        return;
+    }
+
+    double latencyMs = sender.session->GetNetTimeMilliseconds() - s_benchState->sendTimesMs[clientIndex][sequence];
+    s_benchState->latenciesMs.push_back(latencyMs);
+    s_benchState->payloadBytes += msg.GetPayloadSize();
+    if (sequence != s_benchState->nextExpectedSequence[clientIndex])
+    {
+        ++s_benchState->outOfOrder;
+    }
+    s_benchState->nextExpectedSequence[clientIndex] = sequence + 1;
+
+    uint64_t latencyBits = 0;
+    memcpy(&latencyBits, &latencyMs, sizeof(latencyMs));
+    MixIntoDigest(s_benchState->digest, ((uint64_t)clientIndex << 32) | sequence);
+    MixIntoDigest(s_benchState->digest, latencyBits);
+}
+
+//-----------------------------------------------------------------------------------
+static std::string PadGuid(const std::string& guid)
+{
+    //NetConnection copies a full MAX_GUID_LENGTH out of whatever it's handed
+    std::string padded = guid;
+    padded.resize(NetConnection::MAX_GUID_LENGTH, '\0');
+    return padded;
+}
+
+//-----------------------------------------------------------------------------------
+// One host and numClients clients on a simulated network: everyone joins, then every connected
+// client streams reliable in-order messages at the host for durationSeconds of virtual time,
+// followed by a drain so anything still being resent gets a chance to land.
+static SimulationBenchResults RunSimulatedSessions(int numClients, double durationSeconds, uint64_t seed, const SimulatedLinkSettings& settings)
+{
+    const float TICK_SECONDS = 1.0f / 60.0f;
+    const double TICK_MS = TICK_SECONDS * 1000.0;
+    const int MESSAGES_PER_TICK = 4;
+    const double DRAIN_SECONDS = 5.0;
+
+    SimulationBenchResults results;
+    results.network = new SimulatedNetwork(seed, settings);
+    results.clientsConnected = 0;
+    results.messagesSent = 0;
+
+    SimulationBenchState state;
+    state.network = results.network;
+    state.sendTimesMs.resize(numClients);
+    state.nextExpectedSequence.resize(numClients, 0);
+    state.outOfOrder = 0;
+    state.payloadBytes = 0;
+    state.digest = 0xCBF29CE484222325ull;
+    s_benchState = &state;
+
+    std::vector<NetSession*> sessions;
+    std::vector<SimulatedTransport*> transports;
+    for (int i = 0; i <= numClients; ++i)
+    {
+        SimulatedTransport* transport = new SimulatedTransport(results.network);
+        NetSession* session = new NetSession(TICK_SECONDS, (uint16_t)(numClients + 1));
+        session->m_packetChannel.SetTransport(transport);
+        session->RegisterCoreMessages();
+        session->RegisterMessage(SIM_BENCH_MESSAGE, "simBench", &OnSimBenchMessageReceived, (uint32_t)NetMessage::Option::RELIABLE | (uint32_t)NetMessage::Option::INORDER, (uint32_t)NetMessage::Control::NONE);
+        session->Start(GAME_PORT_STR);
+        sessions.push_back(session);
+        transports.push_back(transport);
+    }
+
+    double wallStartSeconds = GetCurrentTimeSeconds();
+    NetSession* host = sessions[0];
+    host->Host(PadGuid("simHost").c_str());
+    sockaddr_in hostAddress = host->GetAddress();
+    for (int i = 1; i <= numClients; ++i)
+    {
+        sessions[i]->Join(PadGuid(Stringf("simClient%i", i - 1)).c_str(), hostAddress);
+    }
+
+    int numTicks = (int)(durationSeconds / TICK_SECONDS);
+    int numDrainTicks = (int)(DRAIN_SECONDS / TICK_SECONDS);
+    for (int tick = 0; tick < numTicks + numDrainTicks; ++tick)
+    {
+        results.network->AdvanceTime(TICK_MS);
+        if (tick < numTicks)
+        {
+            for (int i = 1; i <= numClients; ++i)
+            {
+                NetSession* client = sessions[i];
+                if (client->GetSessionState() != NetSession::CONNECTED || !client->GetHostConnection())
+                {
+                    continue;
+                }
+                std::vector<double>& sendTimesMs = state.sendTimesMs[i - 1];
+                for (int messageIndex = 0; messageIndex < MESSAGES_PER_TICK; ++messageIndex)
+                {
+                    NetMessage msg(SIM_BENCH_MESSAGE);
+                    msg.Write<uint16_t>((uint16_t)(i - 1));
+                    msg.Write<uint32_t>((uint32_t)sendTimesMs.size());
+                    byte filler[SIM_BENCH_PAYLOAD_SIZE - sizeof(uint16_t) - sizeof(uint32_t)] = { 0 };
+                    msg.WriteBytes(filler, sizeof(filler));
+                    sendTimesMs.push_back(client->GetNetTimeMilliseconds());
+                    client->GetHostConnection()->SendMessage(msg);
+                    ++results.messagesSent;
+                }
+            }
+        }
+        else if (state.latenciesMs.size() == results.messagesSent)
+        {
+            break; //Drained
+        }
+
+        for (NetSession* session : sessions)
+        {
+            session->Update(TICK_SECONDS);
+        }
+    }
+    results.virtualSeconds = results.network->GetCurrentTimeMilliseconds() / 1000.0;
+    results.wallSeconds = GetCurrentTimeSeconds() - wallStartSeconds;
+
+    for (int i = 1; i <= numClients; ++i)
+    {
+        results.clientsConnected += (sessions[i]->GetSessionState() == NetSession::CONNECTED) ? 1 : 0;
+    }
+    results.outOfOrder = state.outOfOrder;
+    results.payloadBytes = state.payloadBytes;
+    results.latenciesMs = state.latenciesMs;
+    results.digest = state.digest;
+    MixIntoDigest(results.digest, results.network->m_packetsSent);
+    MixIntoDigest(results.digest, results.network->m_packetsDelivered);
+
+    //Clients leave first so the host is still around to be told
+    for (int i = numClients; i >= 0; --i)
+    {
+        sessions[i]->Stop();
+        delete sessions[i];
+        delete transports[i];
+    }
+    s_benchState = nullptr;
+    return results;
+}
+
+//-----------------------------------------------------------------------------------
+static double GetPercentile(const std::vector<double>& sortedValues, double percentile)
+{
+    if (sortedValues.empty())
+    {
+        return 0.0;
+    }
+    size_t index = Min<size_t>((size_t)(percentile * (double)sortedValues.size()), sortedValues.size() - 1);
+    return sortedValues[index];
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(netsimbench)
+{
+    if (!(args.HasArgs(0) || args.HasArgs(1) || args.HasArgs(2) || args.HasArgs(3)))
+    {
+        Console::instance->PrintLine("netsimbench [numClients] [virtualSeconds] [seed]", RGBA::RED);
+        return;
+    }
+    //Every session carries its own PacketChannel pool, so keep this to what fits comfortably in memory twice over.
+    const int MAX_BENCH_CLIENTS = 64;
+    int numClients = args.HasArgs(0) ? 8 : Clamp<int>(args.GetIntArgument(0), 1, MAX_BENCH_CLIENTS);
+    double durationSeconds = (args.HasArgs(2) || args.HasArgs(3)) ? (double)args.GetIntArgument(1) : 30.0;
+    uint64_t seed = args.HasArgs(3) ? (uint64_t)args.GetIntArgument(2) : 1337;
+
+    //A bad-but-playable internet: lossy, jittery with a long tail, some reordering and duplication, capped uplinks.
+    SimulatedLinkSettings settings;
+    settings.lossRate = 0.05f;
+    settings.duplicateRate = 0.01f;
+    settings.reorderRate = 0.02f;
+    settings.latencyDistribution = SimulatedLinkSettings::EXPONENTIAL;
+    settings.baseLatencyMs = 40.0;
+    settings.jitterMs = 15.0;
+    settings.reorderDelayMs = 30.0;
+    settings.bandwidthBytesPerSecond = 256.0 * 1024.0;
+    settings.maxQueueDelayMs = 250.0;
+
+    //Run it twice on the same seed; identical digests mean the whole run replayed bit for bit.
+    SimulationBenchResults results = RunSimulatedSessions(numClients, durationSeconds, seed, settings);
+    SimulationBenchResults replay = RunSimulatedSessions(numClients, durationSeconds, seed, settings);
+    SimulatedNetwork* network = results.network;
+
+    std::vector<double> sortedLatencies = results.latenciesMs;
+    std::sort(sortedLatencies.begin(), sortedLatencies.end());
+    double virtualSeconds = Max<double>(results.virtualSeconds, 0.001);
+
+    Console::instance->PrintLine(Stringf("Net sim: %i clients, %.0fs virtual, seed %i", numClients, durationSeconds, (int)seed), RGBA::GBWHITE);
+    Console::instance->PrintLine(Stringf("  Ran %.1fs of virtual time in %.2fs (%.1fx real time)", results.virtualSeconds, results.wallSeconds, results.virtualSeconds / Max<double>(results.wallSeconds, 0.0001)), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("  Clients connected: %i/%i", results.clientsConnected, numClients), (results.clientsConnected == numClients) ? RGBA::CORNFLOWER_BLUE : RGBA::RED);
+    Console::instance->PrintLine(Stringf("  Reliable in-order: %i/%i delivered, %i out of order", (int)results.latenciesMs.size(), (int)results.messagesSent, (int)results.outOfOrder), (results.outOfOrder == 0 && results.latenciesMs.size() == results.messagesSent) ? RGBA::CORNFLOWER_BLUE : RGBA::RED);
+    Console::instance->PrintLine(Stringf("  Throughput: %.0f msgs/s, %.1f KB/s payload, %.1f KB/s on the wire", (double)results.latenciesMs.size() / virtualSeconds, ((double)results.payloadBytes / 1024.0) / virtualSeconds, ((double)network->m_bytesDelivered / 1024.0) / virtualSeconds), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("  Reliable latency: p50 %.1fms, p90 %.1fms, p99 %.1fms, max %.1fms", GetPercentile(sortedLatencies, 0.5), GetPercentile(sortedLatencies, 0.9), GetPercentile(sortedLatencies, 0.99), sortedLatencies.empty() ? 0.0 : sortedLatencies.back()), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("  Network: %i sent, %i delivered, %i lost, %i queue drops, %i duplicated, %i reordered, %i unroutable", network->m_packetsSent, network->m_packetsDelivered, network->m_packetsLost, network->m_packetsDroppedByQueue, network->m_packetsDuplicated, network->m_packetsReordered, network->m_packetsUnroutable), RGBA::GRAY);
+    Console::instance->PrintLine(Stringf("  Deterministic replay: %s", (results.digest == replay.digest) ? "match" : "MISMATCH"), (results.digest == replay.digest) ? RGBA::GREEN : RGBA::RED);
+
+    delete results.network;
+    delete replay.network;
+}
\ No newline at end of file
@@ -0,0 +1,152 @@
+#pragma once
+#include "Engine/Net/UDPIP/NetTransport.hpp"
+#include <vector>
+#include <deque>
+#include <queue>
+#include <unordered_map>
+
+class SimulatedNetwork;
+
+typedef unsigned char byte;
+
+//-----------------------------------------------------------------------------------
+// How every datagram crossing a SimulatedNetwork gets mistreated. All of it is driven
+// by the network's seeded generator, so the same seed replays the same run exactly.
+struct SimulatedLinkSettings
+{
+    //ENUMS/////////////////////////////////////////////////////////////////////
+    enum LatencyDistribution
+    {
+        CONSTANT,
+        UNIFORM, //base + [0, jitter)
+        NORMAL, //base + |N(0, jitter)|
+        EXPONENTIAL, //base + exponential with mean jitter, a long tail of late packets
+        NUM_DISTRIBUTIONS
+    };
+
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    SimulatedLinkSettings()
+        : lossRate(0.0f)
+        , duplicateRate(0.0f)
+        , reorderRate(0.0f)
+        , latencyDistribution(CONSTANT)
+        , baseLatencyMs(0.0)
+        , jitterMs(0.0)
+        , reorderDelayMs(0.0)
+        , bandwidthBytesPerSecond(0.0)
+        , maxQueueDelayMs(250.0)
+    {};
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    float lossRate;
+    float duplicateRate;
+    float reorderRate; //Chance a packet is held back an extra reorderDelayMs, letting later ones overtake it
+    LatencyDistribution latencyDistribution;
+    double baseLatencyMs;
+    double jitterMs;
+    double reorderDelayMs;
+    double bandwidthBytesPerSecond; //Per sender uplink, 0 for unlimited
+    double maxQueueDelayMs; //A sender's uplink drops anything that would wait longer than this to go out
+};
+
+//-----------------------------------------------------------------------------------
+// One endpoint on a SimulatedNetwork. Plug it into a PacketChannel in place of the UDP socket.
+class SimulatedTransport : public NetTransport
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    SimulatedTransport(SimulatedNetwork* network);
+    virtual ~SimulatedTransport();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    virtual void Bind(const char* address, const char* portNumber) override;
+    virtual void Unbind() override;
+    virtual bool IsBound() override { return m_isBound; };
+    virtual size_t SendTo(const sockaddr_in& toAddress, void const* data, const size_t dataSize) override;
+    virtual size_t RecieveFrom(sockaddr_in& fromAddress, void* buffer) override;
+    virtual sockaddr_in GetAddress() override { return m_address; };
+    virtual double GetCurrentTimeMilliseconds() override;
+
+    //STRUCTS/////////////////////////////////////////////////////////////////////
+    struct Datagram
+    {
+        sockaddr_in fromAddress;
+        std::vector<byte> data;
+    };
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    SimulatedNetwork* m_network;
+    sockaddr_in m_address;
+    bool m_isBound;
+    double m_uplinkFreeTimeMs; //When this endpoint's last queued packet finishes going out, for the bandwidth cap
+    std::deque<Datagram> m_inbox;
+};
+
+//-----------------------------------------------------------------------------------
+// An in-process network on a virtual clock. Nothing moves until AdvanceTime() is called,
+// which delivers every datagram whose arrival time has come up, in arrival order.
+class SimulatedNetwork
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    SimulatedNetwork(uint64_t seed, const SimulatedLinkSettings& settings = SimulatedLinkSettings());
+    ~SimulatedNetwork();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void AdvanceTime(double deltaMs);
+    inline double GetCurrentTimeMilliseconds() const { return m_currentTimeMs; };
+    sockaddr_in AttachTransport(SimulatedTransport* transport, uint16_t port);
+    void DetachTransport(SimulatedTransport* transport);
+    void Send(SimulatedTransport* from, const sockaddr_in& toAddress, const void* data, size_t dataSize);
+
+    //Deterministic generator (splitmix64), kept separate from MathUtils so nothing else can disturb the sequence
+    uint64_t GetRandomBits();
+    double GetRandomDouble(); //[0, 1)
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const uint32_t BASE_ADDRESS = 0x0A000001; //10.0.0.1, each attached transport gets the next one
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    SimulatedLinkSettings m_settings;
+
+    //Stats
+    uint32_t m_packetsSent;
+    uint32_t m_packetsDelivered;
+    uint32_t m_packetsLost;
+    uint32_t m_packetsDroppedByQueue;
+    uint32_t m_packetsDuplicated;
+    uint32_t m_packetsReordered;
+    uint32_t m_packetsUnroutable;
+    uint64_t m_bytesDelivered;
+
+private:
+    //STRUCTS/////////////////////////////////////////////////////////////////////
+    struct InFlightPacket
+    {
+        double arrivalTimeMs;
+        uint64_t sequence; //Breaks arrival ties in send order, so the heap never decides anything on its own
+        uint64_t toAddressKey;
+        SimulatedTransport::Datagram datagram;
+    };
+
+    struct InFlightPacketComparison
+    {
+        bool operator() (const InFlightPacket* lhs, const InFlightPacket* rhs) const
+        {
+            if (lhs->arrivalTimeMs != rhs->arrivalTimeMs) return lhs->arrivalTimeMs > rhs->arrivalTimeMs;
+            return lhs->sequence > rhs->sequence;
+        }
+    };
+
+    //PRIVATE FUNCTIONS/////////////////////////////////////////////////////////////////////
+    double SampleLatencyMs();
+    void Enqueue(double arrivalTimeMs, uint64_t toAddressKey, const sockaddr_in& fromAddress, const void* data, size_t dataSize);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    double m_currentTimeMs;
+    uint64_t m_randomState;
+    uint64_t m_nextSequence;
+    uint32_t m_nextHostAddress;
+    std::priority_queue<InFlightPacket*, std::vector<InFlightPacket*>, InFlightPacketComparison> m_inFlight;
+    std::unordered_map<uint64_t, SimulatedTransport*> m_transports; //NetSession::GetAddressKey() -> endpoint
+};
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "Engine/Net/NetSystem.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
+#include "Engine/Time/Time.hpp"
 #include "../../Input/Logging.hpp"
 
 //-----------------------------------------------------------------------------------
@@ -124,6 +125,12 @@ void UDPSocket::Bind(const char* address, const char* portNumber)
     m_socket = CreateUDPSocket(address, portNumber, &m_address);
 }
 
+//-----------------------------------------------------------------------------------
+double UDPSocket::GetCurrentTimeMilliseconds()
+{
+    return ::GetCurrentTimeMilliseconds();
+}
+
 //-----------------------------------------------------------------------------------
 void UDPSocket::Unbind()
 {
@@ -3,19 +3,22 @@
 #include <stdint.h>
 #include <WinSock2.h>
 #include <WS2tcpip.h>
+#include "Engine/Net/UDPIP/NetTransport.hpp"
 
 #define PACKET_MTU 1232
 
-class UDPSocket
+class UDPSocket : public NetTransport
 {
 public:
     UDPSocket() : m_socket(INVALID_SOCKET) {};
     ~UDPSocket() {};
-    void Bind(const char* address, const char* portNumber);
-    void Unbind();
-    bool IsBound() { return m_socket != INVALID_SOCKET; };
-    size_t SendTo(const sockaddr_in& toAddress, void const* data, const size_t dataSize);
-    size_t RecieveFrom(sockaddr_in& fromAddress, void* buffer);
+    virtual void Bind(const char* address, const char* portNumber) override;
+    virtual void Unbind() override;
+    virtual bool IsBound() override { return m_socket != INVALID_SOCKET; };
+    virtual size_t SendTo(const sockaddr_in& toAddress, void const* data, const size_t dataSize) override;
+    virtual size_t RecieveFrom(sockaddr_in& fromAddress, void* buffer) override;
+    virtual sockaddr_in GetAddress() override { return m_address; };
+    virtual double GetCurrentTimeMilliseconds() override;
     //You get back an address of who sent the data. 
     //You ask for max length, and if you get more than you asked for, you get the error
     //Regardless of how much you ask for, you simply get one packet.
@@ -49,7 +49,7 @@ AABB2 BarGraphRenderable2D::GetBounds()
 void BarGraphRenderable2D::Render(BufferedMeshRenderer& renderer)
 {
     ProfilingSystem::instance->PushSample("BarGraphRenderable2D");
-    static size_t gPercentageFilledUniform = std::hash<std::string>{}("gPercentageFilled");
+    static const UniformName gPercentageFilledUniform("gPercentageFilled");
     m_material->SetFloatUniform(gPercentageFilledUniform, m_animatedPercentageFilled);
     renderer.SetMaterial(m_material);
 
@@ -1,6 +1,7 @@
 #include "Engine/Renderer/2D/ParticleSystem.hpp"
 #include "Engine/Renderer/2D/Sprite.hpp"
 #include "Engine/Renderer/2D/SpriteGameRenderer.hpp"
+#include "Engine/Renderer/2D/SpriteDrawList.hpp"
 #include "Engine/Renderer/2D/ParticleSystemDefinition.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Renderer/MeshBuilder.hpp"
@@ -9,7 +10,7 @@
 #include "Engine/Renderer/2D/ResourceDatabase.hpp"
 #include "../../Core/ProfilingUtils.h"
 //-----------------------------------------------------------------------------------
-Particle::Particle(const Vector2& spawnPosition, const ParticleEmitterDefinition* definition, float rotationDegrees /*= 0.0f*/, const Vector2& initalVelocity /*= Vector2::ZERO*/, const Vector2& initialAcceleration /*= Vector2::ZERO*/, const RGBA& color /*= RGBA::WHITE*/) 
+Particle::Particle(const Vector2& spawnPosition, const ParticleEmitterDefinition* definition, RandomStream& random, float rotationDegrees /*= 0.0f*/, const Vector2& initalVelocity /*= Vector2::ZERO*/, const Vector2& initialAcceleration /*= Vector2::ZERO*/, const RGBA& color /*= RGBA::WHITE*/) 
     : m_position(spawnPosition)
     , m_velocity(initalVelocity)
     , m_acceleration(initialAcceleration)
@@ -17,13 +18,13 @@ Particle::Particle(const Vector2& spawnPosition, const ParticleEmitterDefinition
     , m_age(0.0f)
     , m_color(color)
 {
-    m_scale = definition->m_properties.Get<Range<Vector2>>(PROPERTY_INITIAL_SCALE).GetRandom();
-    m_maxAge = definition->m_properties.Get<Range<float>>(PROPERTY_PARTICLE_LIFETIME).GetRandom();
-    m_angularVelocityDegrees = definition->m_properties.Get<Range<float>>(PROPERTY_INITIAL_ANGULAR_VELOCITY_DEGREES).GetRandom();
+    m_scale = definition->m_properties.Get<Range<Vector2>>(PROPERTY_INITIAL_SCALE).GetRandom(random);
+    m_maxAge = definition->m_properties.Get<Range<float>>(PROPERTY_PARTICLE_LIFETIME).GetRandom(random);
+    m_angularVelocityDegrees = definition->m_properties.Get<Range<float>>(PROPERTY_INITIAL_ANGULAR_VELOCITY_DEGREES).GetRandom(random);
 
     Range<float> explosiveVelocityForce = 0.0f;
     definition->m_properties.Get<Range<float>>(PROPERTY_EXPLOSIVE_VELOCITY_MAGNITUDE, explosiveVelocityForce);
-    m_velocity += Vector2::CreateFromPolar(explosiveVelocityForce.GetRandom(), m_rotationDegrees);
+    m_velocity += Vector2::CreateFromPolar(explosiveVelocityForce.GetRandom(random), m_rotationDegrees);
 }
 //-----------------------------------------------------------------------------------
 ParticleEmitter::ParticleEmitter(ParticleSystem* parent, const ParticleEmitterDefinition* definition, const Transform2D& startingTransform, Transform2D* parentTransform)
@@ -33,9 +34,10 @@ ParticleEmitter::ParticleEmitter(ParticleSystem* parent, const ParticleEmitterDe
     , m_timeSinceLastEmission(0.0f)
     , m_isDead(false)
     , m_transform(startingTransform)
-    , m_maxEmitterAge(definition->m_properties.Get<Range<float>>(PROPERTY_MAX_EMITTER_LIFETIME).GetRandom())
+    , m_random(RandomStream::GetThreadStream().GetUint())
+    , m_maxEmitterAge(definition->m_properties.Get<Range<float>>(PROPERTY_MAX_EMITTER_LIFETIME).GetRandom(m_random))
     , m_particlesPerSecond(definition->m_properties.Get<float>(PROPERTY_PARTICLES_PER_SECOND))
-    , m_initialNumParticlesSpawn(definition->m_properties.Get<Range<unsigned int>>(PROPERTY_INITIAL_NUM_PARTICLES).GetRandom())
+    , m_initialNumParticlesSpawn(definition->m_properties.Get<Range<unsigned int>>(PROPERTY_INITIAL_NUM_PARTICLES).GetRandom(m_random))
     , m_materialOverride(nullptr)
 {
     if (parentTransform)
@@ -85,7 +87,7 @@ void ParticleEmitter::UpdateParticles(float deltaSeconds)
 {
     const bool fadeoutEnabled = m_definition->m_properties.Get<bool>(PROPERTY_FADEOUT_ENABLED);
     const bool lockParticlesToEmitter = m_definition->m_properties.Get<bool>(PROPERTY_LOCK_PARTICLES_TO_EMITTER);
-    const Vector2 scaleRateOfChangePerSecond = m_definition->m_properties.Get<Range<Vector2>>(PROPERTY_DELTA_SCALE_PER_SECOND).GetRandom();
+    const Vector2 scaleRateOfChangePerSecond = m_definition->m_properties.Get<Range<Vector2>>(PROPERTY_DELTA_SCALE_PER_SECOND).GetRandom(m_random);
     std::string debugName = m_definition->m_properties.Get<std::string>(PROPERTY_NAME);
     const SpriteResource* resource = GetSpriteResource();
     m_boundingBox = AABB2::INVALID;
@@ -179,14 +181,14 @@ void ParticleEmitter::BuildParticles(BufferedMeshRenderer& renderer)
 void ParticleEmitter::SpawnParticle()
 {
     Vector2 spawnPosition = m_transform.GetWorldPosition();
-    Vector2 randomVectorOffset = MathUtils::GetRandomVectorInCircle(m_definition->m_properties.Get<Range<float>>(PROPERTY_SPAWN_RADIUS).GetRandom());
-    float initialRotation = m_transform.GetWorldRotationDegrees() + m_definition->m_properties.Get<Range<float>>(PROPERTY_INITIAL_ROTATION_DEGREES).GetRandom();
-    Vector2 initialVelocity = m_definition->m_properties.Get<Range<Vector2>>(PROPERTY_INITIAL_VELOCITY).GetRandom();
+    Vector2 randomVectorOffset = m_random.GetPointInCircle(m_definition->m_properties.Get<Range<float>>(PROPERTY_SPAWN_RADIUS).GetRandom(m_random));
+    float initialRotation = m_transform.GetWorldRotationDegrees() + m_definition->m_properties.Get<Range<float>>(PROPERTY_INITIAL_ROTATION_DEGREES).GetRandom(m_random);
+    Vector2 initialVelocity = m_definition->m_properties.Get<Range<Vector2>>(PROPERTY_INITIAL_VELOCITY).GetRandom(m_random);
     
     spawnPosition += randomVectorOffset;
     
     RGBA color = m_parentSystem->m_colorOverride == RGBA::WHITE ? m_definition->m_properties.Get<RGBA>(PROPERTY_INITIAL_COLOR) : m_parentSystem->m_colorOverride;
-    m_particles.emplace_back(spawnPosition, m_definition, initialRotation, initialVelocity, Vector2::ZERO, color);
+    m_particles.emplace_back(spawnPosition, m_definition, m_random, initialRotation, initialVelocity, Vector2::ZERO, color);
 }
 
 //-----------------------------------------------------------------------------------
@@ -281,6 +283,21 @@ void ParticleSystem::Render(BufferedMeshRenderer& renderer)
     ProfilingSystem::instance->PopSample("ParticleRender");
 }
 
+//-----------------------------------------------------------------------------------
+void ParticleSystem::SubmitDrawPackets(SpriteDrawList& drawList)
+{
+    //Every particle is its own sprite packet, so emitters sharing a sheet end up in one batch.
+    for (ParticleEmitter* emitter : m_emitters)
+    {
+        Material* material = emitter->m_materialOverride == nullptr ? emitter->m_definition->m_material : emitter->m_materialOverride;
+        const SpriteResource* spriteResource = emitter->GetSpriteResource();
+        for (const Particle& particle : emitter->m_particles)
+        {
+            drawList.SubmitSprite(m_orderingLayer, material, spriteResource, particle.m_position, particle.m_scale, particle.m_rotationDegrees, particle.m_color);
+        }
+    }
+}
+
 //-----------------------------------------------------------------------------------
 void ParticleSystem::DestroyImmediately(ParticleSystem* systemToDestroy)
 {
@@ -347,6 +364,13 @@ void RibbonParticleSystem::Render(BufferedMeshRenderer& renderer)
     ProfilingSystem::instance->PopSample("RibbonParticleRender");
 }
 
+//-----------------------------------------------------------------------------------
+void RibbonParticleSystem::SubmitDrawPackets(SpriteDrawList& drawList)
+{
+    //Ribbons stitch their particles together into one strip, so they still build it themselves.
+    Renderable2D::SubmitDrawPackets(drawList);
+}
+
 //-----------------------------------------------------------------------------------
 void ParticleEmitter::BuildRibbonParticles(BufferedMeshRenderer& renderer)
 {
@@ -12,11 +12,12 @@ class ParticleEmitterDefinition;
 class ParticleSystemDefinition;
 class SpriteResource;
 class ParticleSystem;
+class SpriteDrawList;
 
 //-----------------------------------------------------------------------------------
 struct Particle
 {
-    Particle(const Vector2& spawnPosition, const ParticleEmitterDefinition* definition, float rotationDegrees = 0.0f, const Vector2& initalVelocity = Vector2::ZERO, const Vector2& initialAcceleration = Vector2::ZERO, const RGBA& color = RGBA::WHITE);
+    Particle(const Vector2& spawnPosition, const ParticleEmitterDefinition* definition, RandomStream& random, float rotationDegrees = 0.0f, const Vector2& initalVelocity = Vector2::ZERO, const Vector2& initialAcceleration = Vector2::ZERO, const RGBA& color = RGBA::WHITE);
 
     inline bool IsDead() { return m_age > m_maxAge; };
 
@@ -59,6 +60,7 @@ public:
     const SpriteResource* m_spriteOverride = nullptr;
     Material* m_materialOverride = nullptr;
     ParticleSystem* m_parentSystem = nullptr;
+    RandomStream m_random; //Seeded off the spawning thread's stream, so replays with the same seed spawn the same particles
     unsigned int m_initialNumParticlesSpawn;
     float m_emitterAge;
     float m_particlesPerSecond;
@@ -76,6 +78,7 @@ public:
     virtual ~ParticleSystem();
     virtual void Update(float deltaSeconds) override;
     virtual void Render(BufferedMeshRenderer& renderer) override; 
+    virtual void SubmitDrawPackets(SpriteDrawList& drawList) override;
     virtual bool IsCullable() override { return true; };
     virtual AABB2 GetBounds() override { return m_boundingBox; };
     inline void Pause() { m_isPaused = true; };
@@ -107,6 +110,7 @@ public:
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
     virtual void Update(float deltaSeconds) override;
     virtual void Render(BufferedMeshRenderer& renderer) override;
+    virtual void SubmitDrawPackets(SpriteDrawList& drawList) override;
 };
 
 //-----------------------------------------------------------------------------------
@@ -1,5 +1,6 @@
 #include "Engine/Renderer/2D/Renderable2D.hpp"
 #include "SpriteGameRenderer.hpp"
+#include "SpriteDrawList.hpp"
 
 //-----------------------------------------------------------------------------------
 Renderable2D::Renderable2D(int orderingLayer, bool isEnabled)
@@ -55,6 +56,12 @@ void Renderable2D::Render(BufferedMeshRenderer& )
 
 }
 
+//-----------------------------------------------------------------------------------
+void Renderable2D::SubmitDrawPackets(SpriteDrawList& drawList)
+{
+    drawList.SubmitRenderable(m_orderingLayer, this);
+}
+
 //-----------------------------------------------------------------------------------
 AABB2 Renderable2D::GetBounds()
 {
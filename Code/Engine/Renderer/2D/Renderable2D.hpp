@@ -1,6 +1,7 @@
 #pragma once
 
 class BufferedMeshRenderer;
+class SpriteDrawList;
 class AABB2;
 
 typedef unsigned char uchar;
@@ -18,6 +19,7 @@ public:
     void Disable();
     virtual void Update(float deltaSeconds) = 0;
     virtual void Render(BufferedMeshRenderer& renderer);
+    virtual void SubmitDrawPackets(SpriteDrawList& drawList); //Defaults to a packet that calls Render(), override this alongside Render()
     virtual AABB2 GetBounds();
     virtual bool IsCullable() { return true; };
 
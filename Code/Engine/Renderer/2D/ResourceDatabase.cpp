@@ -3,12 +3,18 @@
 #include "Engine/Renderer/Texture.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Fonts/BitmapFont.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Time/Time.hpp"
 #include <string>
+#include <set>
 
 ResourceDatabase* ResourceDatabase::instance = nullptr;
 
 //-----------------------------------------------------------------------------------
 ResourceDatabase::ResourceDatabase()
+    : m_spriteAtlas(nullptr)
 {
 
 }
@@ -32,6 +38,7 @@ ResourceDatabase::~ResourceDatabase()
         ParticleSystemDefinition* resource = resourcePair.second;
         delete resource;
     }
+    delete m_spriteAtlas;
 }
 
 //-----------------------------------------------------------------------------------
@@ -45,6 +52,20 @@ void ResourceDatabase::RegisterSprite(std::string spriteName, std::string filePa
     resource->m_pivotPoint = resource->m_virtualSize / 2.0f;
     resource->m_defaultMaterial = new Material(SpriteGameRenderer::instance->m_defaultShader, SpriteGameRenderer::instance->m_defaultRenderState);
     m_spriteDatabase[std::hash<std::string>{}(spriteName)] = resource;
+
+    if (m_spriteAtlas)
+    {
+        auto placementIter = m_atlasPlacements.find(resource->m_texture);
+        if (placementIter == m_atlasPlacements.end())
+        {
+            const Texture* texture = resource->m_texture;
+            AtlasImage image(texture->m_imageData, texture->m_numColorComponents, texture->m_texelSize);
+            m_spriteAtlas->InsertTexture(texture, image.texture, image.uvBounds);
+            image.wasPacked = image.texture != nullptr;
+            placementIter = m_atlasPlacements.insert(std::make_pair(resource->m_texture, image)).first;
+        }
+        MoveSpriteToAtlas(resource, placementIter->second);
+    }
 }
 
 //-----------------------------------------------------------------------------------
@@ -131,3 +152,109 @@ ParticleSystemDefinition* ResourceDatabase::EditParticleSystemResource(const std
     }
     return (*resourceIter).second;
 }
+
+
+//-----------------------------------------------------------------------------------
+unsigned int ResourceDatabase::PackSpritesIntoAtlas(TextureAtlas* atlas)
+{
+    if (m_spriteAtlas && m_spriteAtlas != atlas)
+    {
+        ERROR_RECOVERABLE("The sprites are already packed into a different atlas; they can only live in one.");
+        return 0;
+    }
+    m_spriteAtlas = atlas;
+
+    //Sheets are shared by lots of sprites, so each source texture goes in once and everything using it follows along.
+    std::vector<Texture*> sourceTextures;
+    std::vector<AtlasImage> images;
+    for (auto resourcePair : m_spriteDatabase)
+    {
+        Texture* texture = resourcePair.second->m_texture;
+        int numComponents = texture->m_numColorComponents;
+        bool hasPixels = texture->m_imageData && (numComponents == 1 || numComponents == 3 || numComponents == 4);
+        if (!hasPixels || atlas->OwnsTexture(texture) || m_atlasPlacements.find(texture) != m_atlasPlacements.end())
+        {
+            continue;
+        }
+        m_atlasPlacements[texture] = AtlasImage();
+        sourceTextures.push_back(texture);
+        images.push_back(AtlasImage(texture->m_imageData, numComponents, texture->m_texelSize));
+    }
+    atlas->InsertBatch(images);
+
+    unsigned int numPacked = 0;
+    for (unsigned int i = 0; i < images.size(); ++i)
+    {
+        m_atlasPlacements[sourceTextures[i]] = images[i];
+        numPacked += images[i].wasPacked ? 1 : 0;
+    }
+    for (auto resourcePair : m_spriteDatabase)
+    {
+        SpriteResource* resource = resourcePair.second;
+        auto placementIter = m_atlasPlacements.find(resource->m_texture);
+        if (placementIter != m_atlasPlacements.end())
+        {
+            MoveSpriteToAtlas(resource, placementIter->second);
+        }
+    }
+    return numPacked;
+}
+
+//-----------------------------------------------------------------------------------
+void ResourceDatabase::MoveSpriteToAtlas(SpriteResource* resource, const AtlasImage& placement)
+{
+    //Anything too big for a page keeps drawing from its own texture.
+    if (!placement.wasPacked)
+    {
+        return;
+    }
+    resource->m_texture = placement.texture;
+    resource->m_uvBounds = TextureAtlas::RemapUVs(resource->m_uvBounds, placement.uvBounds);
+}
+
+//-----------------------------------------------------------------------------------
+static unsigned int CountSpriteTextures(const std::map<size_t, SpriteResource*>& spriteDatabase)
+{
+    std::set<const Texture*> textures;
+    for (auto resourcePair : spriteDatabase)
+    {
+        textures.insert(resourcePair.second->m_texture);
+    }
+    return textures.size();
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(packspriteatlas)
+{
+    if (ResourceDatabase::instance->GetSpriteAtlas())
+    {
+        Console::instance->PrintLine("The sprites are already in an atlas, new ones get added as they're registered.", RGBA::RED);
+        return;
+    }
+    if (!(args.HasArgs(0) || args.HasArgs(1)))
+    {
+        Console::instance->PrintLine("packspriteatlas [pageSize]", RGBA::RED);
+        return;
+    }
+    //Pages are square RGBA textures, so keep them a power of two GPUs are happy with.
+    const int MIN_PAGE_SIZE = 64;
+    const int MAX_PAGE_SIZE = 8192;
+    int requestedPageSize = args.HasArgs(1) ? Clamp<int>(args.GetIntArgument(0), MIN_PAGE_SIZE, MAX_PAGE_SIZE) : 2048;
+    int pageSize = MIN_PAGE_SIZE;
+    while (pageSize < requestedPageSize)
+    {
+        pageSize *= 2;
+    }
+
+    unsigned int texturesBefore = CountSpriteTextures(ResourceDatabase::instance->m_spriteDatabase);
+    TextureAtlas* atlas = new TextureAtlas("SpriteAtlas", pageSize);
+    double startSeconds = GetCurrentTimeSeconds();
+    unsigned int numSpriteTextures = ResourceDatabase::instance->PackSpritesIntoAtlas(atlas);
+    unsigned int numFonts = BitmapFont::PackAllIntoAtlas(*atlas);
+    double packSeconds = GetCurrentTimeSeconds() - startSeconds;
+    unsigned int texturesAfter = CountSpriteTextures(ResourceDatabase::instance->m_spriteDatabase);
+
+    Console::instance->PrintLine(Stringf("Packed %u sprite textures and %u font pages into %u %ix%i pages in %.3fms", numSpriteTextures, numFonts, atlas->GetNumPages(), pageSize, pageSize, packSeconds * 1000.0), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("Packing efficiency: %.1f%%", atlas->GetPackingEfficiency() * 100.0f), RGBA::GBWHITE);
+    Console::instance->PrintLine(Stringf("Textures sprites and particles draw from: %u -> %u", texturesBefore, texturesAfter), RGBA::GBWHITE);
+}
\ No newline at end of file
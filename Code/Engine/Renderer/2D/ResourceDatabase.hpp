@@ -4,6 +4,7 @@
 #include "Engine/Renderer/AABB2.hpp"
 #include "Engine/Renderer/2D/Sprite.hpp"
 #include "Engine/Renderer/2D/ParticleSystemDefinition.hpp"
+#include "Engine/Renderer/TextureAtlas.hpp"
 
 class Texture;
 class Material;
@@ -28,6 +29,9 @@ public:
     const ParticleSystemDefinition* GetParticleSystemResource(const std::string& resourceName);
     ParticleSystemDefinition* EditParticleSystemResource(const std::string& resourceName);
 
+    unsigned int PackSpritesIntoAtlas(TextureAtlas* atlas); //Sprites registered afterwards go straight into the same atlas. Returns how many source textures moved
+    inline TextureAtlas* GetSpriteAtlas() const { return m_spriteAtlas; };
+
     //STATIC VARIABLES/////////////////////////////////////////////////////////////////////
     static ResourceDatabase* instance;
 
@@ -35,4 +39,10 @@ public:
     std::map<size_t, SpriteResource*> m_spriteDatabase;
     std::map<size_t, SpriteAnimationResource*> m_spriteAnimationDatabase;
     std::map<size_t, ParticleSystemDefinition*> m_particleSystemDatabase;
+    TextureAtlas* m_spriteAtlas; //Owned, nullptr until sprites get packed
+    std::map<Texture*, AtlasImage> m_atlasPlacements; //Where each source texture ended up, so sprites sharing a sheet share its spot
+
+private:
+    //PRIVATE FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void MoveSpriteToAtlas(SpriteResource* resource, const AtlasImage& placement);
 };
\ No newline at end of file
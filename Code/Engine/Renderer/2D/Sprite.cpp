@@ -1,6 +1,7 @@
 #include "Engine/Renderer/2D/Sprite.hpp"
 #include "Engine/Renderer/2D/SpriteGameRenderer.hpp"
 #include "Engine/Renderer/2D/ResourceDatabase.hpp"
+#include "Engine/Renderer/2D/SpriteDrawList.hpp"
 #include "../../Core/ProfilingUtils.h"
 
 //-----------------------------------------------------------------------------------
@@ -56,6 +57,12 @@ void Sprite::Render(BufferedMeshRenderer& renderer)
     ProfilingSystem::instance->PopSample("SpriteRenderable");
 }
 
+//-----------------------------------------------------------------------------------
+void Sprite::SubmitDrawPackets(SpriteDrawList& drawList)
+{
+    drawList.SubmitSprite(m_orderingLayer, m_material, m_spriteResource, m_transform.GetWorldPosition(), m_transform.GetWorldScale(), m_transform.GetWorldRotationDegrees(), m_tintColor);
+}
+
 //-----------------------------------------------------------------------------------
 void Sprite::PushSpriteToMesh(BufferedMeshRenderer& renderer)
 {
@@ -11,6 +11,7 @@ class Texture;
 class Material;
 class SpriteResource;
 class BufferedMeshRender;
+class SpriteDrawList;
 
 //-----------------------------------------------------------------------------------
 enum class SpriteAnimationLoopMode
@@ -101,6 +102,7 @@ public:
     virtual void Update(float) {};
     virtual AABB2 GetBounds();
     virtual void Render(BufferedMeshRenderer& renderer);
+    virtual void SubmitDrawPackets(SpriteDrawList& drawList);
 
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
     const SpriteResource* m_spriteResource;
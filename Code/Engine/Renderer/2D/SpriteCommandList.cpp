@@ -0,0 +1,361 @@
+#include "Engine/Renderer/2D/SpriteCommandList.hpp"
+#include "Engine/Renderer/2D/SpriteGameRenderer.hpp"
+#include "Engine/Renderer/2D/Renderable2D.hpp"
+#include "Engine/Renderer/2D/Sprite.hpp"
+#include "Engine/Renderer/BufferedMeshRenderer.hpp"
+#include "Engine/Renderer/Material.hpp"
+#include "Engine/Renderer/Texture.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Time/Time.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "../../Core/ProfilingUtils.h"
+
+//-----------------------------------------------------------------------------------
+SpriteCommandList::SpriteCommandList()
+    : m_asyncLayer(nullptr)
+    , m_asyncViewer(0)
+    , m_isRecording(false)
+    , m_hasRecording(false)
+{
+
+}
+
+//-----------------------------------------------------------------------------------
+SpriteCommandList::~SpriteCommandList()
+{
+    WaitForRecording();
+}
+
+//-----------------------------------------------------------------------------------
+void SpriteCommandList::Clear()
+{
+    //Only the sizes reset, the arena keeps its capacity for next frame.
+    m_commands.clear();
+    m_vertices.clear();
+    m_indices.clear();
+    m_hasRecording = false;
+}
+
+//-----------------------------------------------------------------------------------
+void SpriteCommandList::Record(SpriteLayer* layer, const AABB2& cullBounds, uchar viewer)
+{
+    Clear();
+    m_drawList.Clear();
+    m_drawList.SetStateSortingEnabled(layer->m_isStateSortingEnabled);
+
+    bool isCullingEnabled = layer->IsCullingEnabled();
+    unsigned int numRenderables = layer->m_gatheredRenderables.size();
+    for (unsigned int i = 0; i < numRenderables; ++i)
+    {
+        Renderable2D* renderable = layer->m_gatheredRenderables[i];
+        bool canBeRendered = (viewer & renderable->m_viewableBy) > 0;
+        if (canBeRendered)
+        {
+            if (!isCullingEnabled || !renderable->IsCullable() || cullBounds.IsIntersecting(layer->m_gatheredBounds[i]))
+            {
+                renderable->SubmitDrawPackets(m_drawList);
+            }
+        }
+    }
+    m_drawList.BuildBatches();
+
+    for (const DrawBatch& batch : m_drawList.GetBatches())
+    {
+        SpriteCommand command;
+        command.m_batch = batch;
+        command.m_firstVertex = m_vertices.size();
+        command.m_firstIndex = m_indices.size();
+        if (batch.m_material)
+        {
+            m_drawList.AddBatchToMesh(batch, m_builder);
+            unsigned int numVertices = m_builder.m_vertices.size();
+            m_vertices.resize(command.m_firstVertex + numVertices);
+            Vertex_Sprite* destination = &m_vertices[command.m_firstVertex];
+            for (unsigned int i = 0; i < numVertices; ++i)
+            {
+                Vertex_Sprite::Copy(m_builder.m_vertices[i], (byte*)(destination + i));
+            }
+            m_indices.insert(m_indices.end(), m_builder.m_indices.begin(), m_builder.m_indices.end());
+            m_builder.ClearVertsAndIndices();
+        }
+        command.m_numVertices = m_vertices.size() - command.m_firstVertex;
+        command.m_numIndices = m_indices.size() - command.m_firstIndex;
+        m_commands.push_back(command);
+    }
+    m_hasRecording = true;
+}
+
+//-----------------------------------------------------------------------------------
+void SpriteCommandList::RecordAsync(SpriteLayer* layer, const AABB2& cullBounds, uchar viewer)
+{
+    WaitForRecording();
+    if (!JobSystem::instance)
+    {
+        Record(layer, cullBounds, viewer);
+        return;
+    }
+    m_asyncLayer = layer;
+    m_asyncCullBounds = cullBounds;
+    m_asyncViewer = viewer;
+    m_isRecording = true;
+    JobSystem::instance->CreateAndDispatchJob(GENERIC, &RecordJob, this);
+}
+
+//-----------------------------------------------------------------------------------
+void SpriteCommandList::RecordJob(Job* job)
+{
+    SpriteCommandList* commandList = static_cast<SpriteCommandList*>(job->data);
+    commandList->Record(commandList->m_asyncLayer, commandList->m_asyncCullBounds, commandList->m_asyncViewer);
+    commandList->m_isRecording = false;
+}
+
+//-----------------------------------------------------------------------------------
+void SpriteCommandList::WaitForRecording()
+{
+    if (!m_isRecording)
+    {
+        return;
+    }
+
+    //Help with the queue rather than sit idle, the job we want may well be in it.
+    std::vector<JobType> types;
+    types.push_back(GENERIC);
+    JobConsumer consumer(types);
+    while (m_isRecording)
+    {
+        if (!consumer.Consume())
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void SpriteCommandList::Replay(BufferedMeshRenderer& renderer) const
+{
+    ProfilingSystem::instance->PushSample("SpriteCommandListReplay");
+    for (const SpriteCommand& command : m_commands)
+    {
+        if (command.m_batch.m_material)
+        {
+            renderer.SetMaterial(command.m_batch.m_material);
+            renderer.SetDiffuseTexture(command.m_batch.m_texture);
+            renderer.RenderVertices(&m_vertices[command.m_firstVertex], command.m_numVertices, &m_indices[command.m_firstIndex], command.m_numIndices);
+        }
+        else
+        {
+            m_drawList.DrawRenderables(command.m_batch, renderer);
+        }
+    }
+    ProfilingSystem::instance->PopSample("SpriteCommandListReplay");
+}
+
+//-----------------------------------------------------------------------------------
+//A single sprite with fixed bounds, so the benchmark doesn't need a sprite database.
+class BenchmarkSpriteRenderable : public Renderable2D
+{
+public:
+    BenchmarkSpriteRenderable(int layer, Material* material, const SpriteResource* spriteResource, const Vector2& position, float rotationDegrees)
+        : Renderable2D(layer, false)
+        , m_material(material)
+        , m_spriteResource(spriteResource)
+        , m_position(position)
+        , m_rotationDegrees(rotationDegrees)
+    {
+
+    };
+
+    virtual void Update(float) override {};
+    virtual AABB2 GetBounds() override { return AABB2(m_position - Vector2(0.5f), m_position + Vector2(0.5f)); };
+    virtual void SubmitDrawPackets(SpriteDrawList& drawList) override { drawList.SubmitSprite(m_orderingLayer, m_material, m_spriteResource, m_position, Vector2::ONE, m_rotationDegrees, RGBA::WHITE); };
+
+    Material* m_material;
+    const SpriteResource* m_spriteResource;
+    Vector2 m_position;
+    float m_rotationDegrees;
+};
+
+//-----------------------------------------------------------------------------------
+struct CommandListSlice
+{
+    SpriteCommandList** commandLists;
+    SpriteLayer** layers;
+    const AABB2* cullBounds;
+    unsigned int numCommandLists;
+    std::atomic<int>* numRemainingJobs;
+};
+
+//-----------------------------------------------------------------------------------
+static void RecordCommandListSlice(CommandListSlice* slice)
+{
+    for (unsigned int i = 0; i < slice->numCommandLists; ++i)
+    {
+        slice->commandLists[i]->Record(slice->layers[i], slice->cullBounds[i], (uchar)SpriteGameRenderer::PlayerVisibility::ALL);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+static void RecordCommandListSliceJob(Job* job)
+{
+    CommandListSlice* slice = static_cast<CommandListSlice*>(job->data);
+    RecordCommandListSlice(slice);
+    --(*slice->numRemainingJobs);
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(spriterecordbench)
+{
+    int numSprites = args.HasArgs(1) ? args.GetIntArgument(0) : 40000;
+    const int NUM_SHEETS = 8;
+    const int NUM_LAYERS = 4;
+    const int MAX_VIEWS = 4;
+    const int NUM_FRAMES = 10;
+    const float WORLD_SIZE = 200.0f;
+    const Vector2 VIEW_HALF_SIZE(40.0f, 25.0f);
+
+    if (!JobSystem::instance)
+    {
+        Console::instance->PrintLine("spriterecordbench needs the JobSystem running.", RGBA::RED);
+        return;
+    }
+
+    //Recording is CPU only, so none of this is ever drawn; the textures just give the sheets genuine pointers.
+    Material* material = new Material(SpriteGameRenderer::instance->m_defaultShader, SpriteGameRenderer::instance->m_defaultRenderState);
+    Texture* textures[NUM_SHEETS];
+    SpriteResource sheets[NUM_SHEETS];
+    for (int i = 0; i < NUM_SHEETS; ++i)
+    {
+        textures[i] = new Texture(16, 16, Texture::TextureFormat::RGBA8);
+        sheets[i].m_texture = textures[i];
+        sheets[i].m_uvBounds = AABB2(Vector2::ZERO, Vector2(0.25f, 0.25f));
+        sheets[i].m_pixelSize = Vector2(16.0f, 16.0f);
+        sheets[i].m_virtualSize = Vector2(1.0f, 1.0f);
+        sheets[i].m_pivotPoint = Vector2(0.5f, 0.5f);
+        sheets[i].m_defaultMaterial = material;
+    }
+
+    SpriteLayer* layers[NUM_LAYERS];
+    for (int layerIndex = 0; layerIndex < NUM_LAYERS; ++layerIndex)
+    {
+        layers[layerIndex] = new SpriteLayer(layerIndex);
+    }
+    for (int i = 0; i < numSprites; ++i)
+    {
+        int layerIndex = i % NUM_LAYERS;
+        Vector2 position(MathUtils::GetRandomFloatFromZeroTo(WORLD_SIZE), MathUtils::GetRandomFloatFromZeroTo(WORLD_SIZE));
+        const SpriteResource* sheet = &sheets[MathUtils::GetRandomIntFromZeroTo(NUM_SHEETS)];
+        layers[layerIndex]->AddRenderable2D(new BenchmarkSpriteRenderable(layerIndex, material, sheet, position, MathUtils::GetRandomFloatFromZeroTo(360.0f)));
+    }
+    for (int layerIndex = 0; layerIndex < NUM_LAYERS; ++layerIndex)
+    {
+        layers[layerIndex]->GatherRenderables();
+    }
+
+    //Each view looks at a different corner of the world, like split screen players spread out.
+    SpriteCommandList* commandLists[MAX_VIEWS * NUM_LAYERS];
+    SpriteLayer* commandListLayers[MAX_VIEWS * NUM_LAYERS];
+    AABB2 cullBounds[MAX_VIEWS * NUM_LAYERS];
+    for (int view = 0; view < MAX_VIEWS; ++view)
+    {
+        Vector2 cameraPosition(WORLD_SIZE * (0.3f + 0.4f * (float)(view % 2)), WORLD_SIZE * (0.3f + 0.4f * (float)(view / 2)));
+        for (int layerIndex = 0; layerIndex < NUM_LAYERS; ++layerIndex)
+        {
+            int index = view * NUM_LAYERS + layerIndex;
+            commandLists[index] = new SpriteCommandList();
+            commandListLayers[index] = layers[layerIndex];
+            cullBounds[index] = AABB2(cameraPosition - VIEW_HALF_SIZE, cameraPosition + VIEW_HALF_SIZE);
+        }
+    }
+
+    std::vector<int> workerCounts;
+    int numCores = (int)GetCoreCount();
+    for (int numWorkers = 1; numWorkers < numCores && numWorkers < MAX_VIEWS * NUM_LAYERS; numWorkers *= 2)
+    {
+        workerCounts.push_back(numWorkers);
+    }
+    workerCounts.push_back(Min<int>(numCores, MAX_VIEWS * NUM_LAYERS));
+
+    Console::instance->PrintLine(Stringf("%i sprites on %i layers, recording every (view, layer) pair, ms per frame (speedup):", numSprites, NUM_LAYERS), RGBA::CORNFLOWER_BLUE);
+    std::vector<JobType> types;
+    types.push_back(GENERIC);
+    JobConsumer consumer(types);
+    std::vector<CommandListSlice> slices;
+    for (int numViews = 1; numViews <= MAX_VIEWS; ++numViews)
+    {
+        unsigned int numCommandLists = numViews * NUM_LAYERS;
+        unsigned int numVertices = 0;
+        double serialSeconds = 0.0;
+        std::string line = Stringf("%i view%s:", numViews, numViews == 1 ? " " : "s");
+        for (int numWorkers : workerCounts)
+        {
+            //Split the lists into one contiguous slice per worker; the main thread takes its share through the consumer.
+            unsigned int numJobs = Min<unsigned int>((unsigned int)numWorkers, numCommandLists);
+            unsigned int listsPerJob = (numCommandLists + numJobs - 1) / numJobs;
+            std::atomic<int> numRemainingJobs(0);
+            slices.clear();
+            for (unsigned int first = 0; first < numCommandLists; first += listsPerJob)
+            {
+                CommandListSlice slice;
+                slice.commandLists = &commandLists[first];
+                slice.layers = &commandListLayers[first];
+                slice.cullBounds = &cullBounds[first];
+                slice.numCommandLists = Min<unsigned int>(listsPerJob, numCommandLists - first);
+                slice.numRemainingJobs = &numRemainingJobs;
+                slices.push_back(slice);
+            }
+
+            double startSeconds = GetCurrentTimeSeconds();
+            for (int frame = 0; frame < NUM_FRAMES; ++frame)
+            {
+                if (slices.size() == 1)
+                {
+                    RecordCommandListSlice(&slices[0]);
+                    continue;
+                }
+                numRemainingJobs = (int)slices.size();
+                for (CommandListSlice& slice : slices)
+                {
+                    JobSystem::instance->CreateAndDispatchJob(GENERIC, &RecordCommandListSliceJob, &slice);
+                }
+                while (numRemainingJobs > 0)
+                {
+                    if (!consumer.Consume())
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+            double seconds = (GetCurrentTimeSeconds() - startSeconds) / (double)NUM_FRAMES;
+            if (numWorkers == 1)
+            {
+                serialSeconds = seconds;
+            }
+            line += Stringf(" %i worker%s %.3fms (%.2fx)", numWorkers, numWorkers == 1 ? "" : "s", seconds * 1000.0, serialSeconds / seconds);
+
+            numVertices = 0;
+            for (unsigned int i = 0; i < numCommandLists; ++i)
+            {
+                numVertices += commandLists[i]->GetNumVertices();
+            }
+        }
+        Console::instance->PrintLine(line, RGBA::GBWHITE);
+        Console::instance->PrintLine(Stringf("    %u vertices recorded per frame", numVertices), RGBA::GRAY);
+    }
+    Console::instance->PrintLine("Worker counts past the JobSystem's thread count (plus the main thread) stop scaling.", RGBA::GRAY);
+
+    for (int i = 0; i < MAX_VIEWS * NUM_LAYERS; ++i)
+    {
+        delete commandLists[i];
+    }
+    for (int layerIndex = 0; layerIndex < NUM_LAYERS; ++layerIndex)
+    {
+        delete layers[layerIndex];
+    }
+    for (int i = 0; i < NUM_SHEETS; ++i)
+    {
+        delete textures[i];
+    }
+    delete material;
+}
\ No newline at end of file
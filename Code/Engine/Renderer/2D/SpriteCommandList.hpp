@@ -0,0 +1,67 @@
+#pragma once
+#include "Engine/Renderer/2D/SpriteDrawList.hpp"
+#include "Engine/Renderer/AABB2.hpp"
+#include "Engine/Renderer/MeshBuilder.hpp"
+#include "Engine/Renderer/Vertex.hpp"
+#include <atomic>
+#include <vector>
+
+class SpriteLayer;
+class Material;
+class Texture;
+class BufferedMeshRenderer;
+struct Job;
+
+typedef unsigned char uchar;
+
+//-----------------------------------------------------------------------------------
+struct SpriteCommand
+{
+    DrawBatch m_batch; //Material is nullptr for renderables that draw themselves at replay
+    unsigned int m_firstVertex;
+    unsigned int m_numVertices;
+    unsigned int m_firstIndex;
+    unsigned int m_numIndices;
+};
+
+//-----------------------------------------------------------------------------------
+// Everything one view needs to draw one layer, built entirely on the CPU: culling, the sorted draw
+// list and every batch's finished Vertex_Sprite data in an arena that's kept between frames.
+// Recording never touches the graphics API, so every (view, layer) pair can be recorded on its own
+// job; Replay() is the only part that has to run on the main thread.
+// Recording only reads the layer's gathered renderables, so gather on the main thread first, and
+// keep anything parented to the screen anchors on a screen space layer, which are gathered per view.
+class SpriteCommandList
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    SpriteCommandList();
+    ~SpriteCommandList();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void Clear();
+    void Record(SpriteLayer* layer, const AABB2& cullBounds, uchar viewer);
+    void RecordAsync(SpriteLayer* layer, const AABB2& cullBounds, uchar viewer); //On the JobSystem, WaitForRecording() before replaying
+    void WaitForRecording(); //Works through other jobs while it waits
+    void Replay(BufferedMeshRenderer& renderer) const;
+    inline bool HasRecording() const { return m_hasRecording; };
+    inline bool IsRecording() const { return m_isRecording; };
+    inline unsigned int GetNumCommands() const { return m_commands.size(); };
+    inline unsigned int GetNumVertices() const { return m_vertices.size(); };
+
+private:
+    //PRIVATE FUNCTIONS/////////////////////////////////////////////////////////////////////
+    static void RecordJob(Job* job);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    SpriteDrawList m_drawList;
+    MeshBuilder m_builder; //Scratch for one batch at a time
+    std::vector<SpriteCommand> m_commands;
+    std::vector<Vertex_Sprite> m_vertices;
+    std::vector<unsigned int> m_indices; //Relative to each command's first vertex
+    SpriteLayer* m_asyncLayer;
+    AABB2 m_asyncCullBounds;
+    uchar m_asyncViewer;
+    std::atomic<bool> m_isRecording;
+    bool m_hasRecording;
+};
\ No newline at end of file
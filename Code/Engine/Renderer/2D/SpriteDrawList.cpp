@@ -0,0 +1,408 @@
+#include "Engine/Renderer/2D/SpriteDrawList.hpp"
+#include "Engine/Renderer/2D/SpriteGameRenderer.hpp"
+#include "Engine/Renderer/2D/Renderable2D.hpp"
+#include "Engine/Renderer/2D/Sprite.hpp"
+#include "Engine/Renderer/BufferedMeshRenderer.hpp"
+#include "Engine/Renderer/MeshBuilder.hpp"
+#include "Engine/Renderer/Material.hpp"
+#include "Engine/Renderer/Texture.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/Matrix4x4.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Time/Time.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "../../Core/ProfilingUtils.h"
+#include <algorithm>
+#include <string.h>
+
+//-----------------------------------------------------------------------------------
+SpriteDrawList::SpriteDrawList()
+    : m_isStateSortingEnabled(false)
+    , m_isSorted(true)
+    , m_areBatchesBuilt(true)
+{
+
+}
+
+//-----------------------------------------------------------------------------------
+SpriteDrawList::~SpriteDrawList()
+{
+
+}
+
+//-----------------------------------------------------------------------------------
+void SpriteDrawList::Clear()
+{
+    m_packets.clear();
+    m_sprites.clear();
+    m_renderables.clear();
+    m_batches.clear();
+    m_isSorted = true;
+    m_areBatchesBuilt = true;
+
+    //Once every id is taken, everything new shares the last one; start over so stale pointers don't hog them.
+    if (m_materialIds.size() >= MAX_STATE_ID)
+    {
+        m_materialIds.clear();
+    }
+    if (m_textureIds.size() >= MAX_STATE_ID)
+    {
+        m_textureIds.clear();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void SpriteDrawList::SubmitSprite(int layer, Material* material, const SpriteResource* spriteResource, const Vector2& position, const Vector2& scale, float rotationDegrees, const RGBA& tint, unsigned int depth)
+{
+    DrawPacket packet;
+    packet.m_index = m_sprites.size();
+    if (m_isStateSortingEnabled)
+    {
+        unsigned int materialId = GetStateId(m_materialIds, material);
+        unsigned int textureId = GetStateId(m_textureIds, spriteResource->m_texture);
+        packet.m_sortKey = MakeSortKey(layer, (unsigned int)material->m_renderState.blendMode, materialId, textureId, depth);
+    }
+    else
+    {
+        packet.m_sortKey = MakeSortKey(layer, 0, 0, 0, depth);
+    }
+    m_packets.push_back(packet);
+
+    SpriteDrawData sprite;
+    sprite.m_spriteResource = spriteResource;
+    sprite.m_material = material;
+    sprite.m_position = position;
+    sprite.m_scale = scale;
+    sprite.m_rotationDegrees = rotationDegrees;
+    sprite.m_tint = tint;
+    m_sprites.push_back(sprite);
+
+    m_isSorted = false;
+    m_areBatchesBuilt = false;
+}
+
+//-----------------------------------------------------------------------------------
+void SpriteDrawList::SubmitRenderable(int layer, Renderable2D* renderable, unsigned int depth)
+{
+    DrawPacket packet;
+    packet.m_index = m_renderables.size() | CUSTOM_DRAW_BIT;
+    if (m_isStateSortingEnabled)
+    {
+        packet.m_sortKey = MakeSortKey(layer, 3, MAX_STATE_ID, MAX_STATE_ID, depth);
+    }
+    else
+    {
+        packet.m_sortKey = MakeSortKey(layer, 0, 0, 0, depth);
+    }
+    m_packets.push_back(packet);
+    m_renderables.push_back(renderable);
+
+    m_isSorted = false;
+    m_areBatchesBuilt = false;
+}
+
+//-----------------------------------------------------------------------------------
+void SpriteDrawList::Sort()
+{
+    m_isSorted = true;
+    m_areBatchesBuilt = false;
+    unsigned int numPackets = m_packets.size();
+    if (numPackets < 2)
+    {
+        return;
+    }
+
+    //LSD radix sort, a byte at a time. All eight histograms come out of one pass over the keys, and any
+    //byte every key agrees on (the layer inside one layer's list, depth when nobody sets it) is skipped.
+    unsigned int counts[8][256];
+    memset(counts, 0, sizeof(counts));
+    for (const DrawPacket& packet : m_packets)
+    {
+        uint64_t key = packet.m_sortKey;
+        for (int byteIndex = 0; byteIndex < 8; ++byteIndex)
+        {
+            ++counts[byteIndex][(key >> (byteIndex * 8)) & 0xFF];
+        }
+    }
+
+    m_sortScratch.resize(numPackets);
+    DrawPacket* source = m_packets.data();
+    DrawPacket* destination = m_sortScratch.data();
+    for (int byteIndex = 0; byteIndex < 8; ++byteIndex)
+    {
+        int shift = byteIndex * 8;
+        unsigned int* byteCounts = counts[byteIndex];
+        if (byteCounts[(source[0].m_sortKey >> shift) & 0xFF] == numPackets)
+        {
+            continue;
+        }
+
+        unsigned int offset = 0;
+        for (int i = 0; i < 256; ++i)
+        {
+            unsigned int count = byteCounts[i];
+            byteCounts[i] = offset;
+            offset += count;
+        }
+        for (unsigned int i = 0; i < numPackets; ++i)
+        {
+            destination[byteCounts[(source[i].m_sortKey >> shift) & 0xFF]++] = source[i];
+        }
+        std::swap(source, destination);
+    }
+
+    if (source != m_packets.data())
+    {
+        m_packets.swap(m_sortScratch);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void SpriteDrawList::BuildBatches()
+{
+    if (!m_isSorted)
+    {
+        Sort();
+    }
+    m_batches.clear();
+    m_areBatchesBuilt = true;
+
+    uint64_t previousLayer = 0;
+    unsigned int numPackets = m_packets.size();
+    for (unsigned int i = 0; i < numPackets; ++i)
+    {
+        const DrawPacket& packet = m_packets[i];
+        uint64_t layer = packet.m_sortKey >> LAYER_SHIFT;
+        Material* material = nullptr;
+        Texture* texture = nullptr;
+        if ((packet.m_index & CUSTOM_DRAW_BIT) == 0)
+        {
+            const SpriteDrawData& sprite = m_sprites[packet.m_index];
+            material = sprite.m_material;
+            texture = sprite.m_spriteResource->m_texture;
+        }
+
+        //Neighbours after the sort share a batch as long as they'd set the same state.
+        if (!m_batches.empty() && layer == previousLayer)
+        {
+            DrawBatch& currentBatch = m_batches.back();
+            if (currentBatch.m_material == material && currentBatch.m_texture == texture)
+            {
+                ++currentBatch.m_numPackets;
+                continue;
+            }
+        }
+        DrawBatch batch;
+        batch.m_material = material;
+        batch.m_texture = texture;
+        batch.m_firstPacket = i;
+        batch.m_numPackets = 1;
+        m_batches.push_back(batch);
+        previousLayer = layer;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void SpriteDrawList::AddBatchToMesh(const DrawBatch& batch, MeshBuilder& builder) const
+{
+    unsigned int endPacket = batch.m_firstPacket + batch.m_numPackets;
+    for (unsigned int i = batch.m_firstPacket; i < endPacket; ++i)
+    {
+        unsigned int index = m_packets[i].m_index;
+        if ((index & CUSTOM_DRAW_BIT) == 0)
+        {
+            const SpriteDrawData& sprite = m_sprites[index];
+            builder.AddSprite(sprite.m_spriteResource, sprite.m_tint, sprite.m_position, sprite.m_scale, sprite.m_rotationDegrees);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void SpriteDrawList::Draw(BufferedMeshRenderer& renderer)
+{
+    ProfilingSystem::instance->PushSample("SpriteDrawList");
+    if (!m_areBatchesBuilt)
+    {
+        BuildBatches();
+    }
+
+    for (const DrawBatch& batch : m_batches)
+    {
+        if (batch.m_material)
+        {
+            //Only changes of material or texture flush, and the sort means each one happens once per batch.
+            renderer.SetMaterial(batch.m_material);
+            renderer.SetDiffuseTexture(batch.m_texture);
+            AddBatchToMesh(batch, renderer.m_builder);
+        }
+        else
+        {
+            DrawRenderables(batch, renderer);
+        }
+    }
+    ProfilingSystem::instance->PopSample("SpriteDrawList");
+}
+
+//-----------------------------------------------------------------------------------
+void SpriteDrawList::DrawRenderables(const DrawBatch& batch, BufferedMeshRenderer& renderer) const
+{
+    //Renderables that draw themselves set state however they like, so they get an empty buffer to start
+    //from, and whatever model matrix they leave behind is put back for the sprites' world space vertices.
+    renderer.FlushAndRender();
+    unsigned int endPacket = batch.m_firstPacket + batch.m_numPackets;
+    for (unsigned int i = batch.m_firstPacket; i < endPacket; ++i)
+    {
+        m_renderables[m_packets[i].m_index & ~CUSTOM_DRAW_BIT]->Render(renderer);
+    }
+    renderer.SetModelMatrix(Matrix4x4::IDENTITY);
+}
+
+//-----------------------------------------------------------------------------------
+uint64_t SpriteDrawList::MakeSortKey(int layer, unsigned int blendMode, unsigned int materialId, unsigned int textureId, unsigned int depth) const
+{
+    //Layers are biased so negative ones still sort first.
+    uint64_t key = (uint64_t)((layer + 0x8000) & 0xFFFF) << LAYER_SHIFT;
+    key |= (uint64_t)(blendMode & 0x3) << BLEND_MODE_SHIFT;
+    key |= (uint64_t)(materialId & MAX_STATE_ID) << MATERIAL_SHIFT;
+    key |= (uint64_t)(textureId & MAX_STATE_ID) << TEXTURE_SHIFT;
+    key |= (uint64_t)(depth > MAX_DEPTH ? MAX_DEPTH : depth);
+    return key;
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int SpriteDrawList::GetStateId(std::vector<const void*>& ids, const void* state)
+{
+    //A scene only has a handful of materials and sheets, so a linear search beats hashing here.
+    unsigned int numIds = ids.size();
+    for (unsigned int i = 0; i < numIds; ++i)
+    {
+        if (ids[i] == state)
+        {
+            return i;
+        }
+    }
+    //MAX_STATE_ID itself is saved for renderables that draw themselves.
+    if (numIds >= MAX_STATE_ID)
+    {
+        return MAX_STATE_ID - 1;
+    }
+    ids.push_back(state);
+    return numIds;
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(spritebatchbench)
+{
+    int numSprites = args.HasArgs(1) ? Max<int>(args.GetIntArgument(0), 1) : 50000;
+    const int NUM_SHEETS = 8;
+    const int NUM_MATERIALS = 3;
+    const int NUM_LAYERS = 4;
+    const int NUM_FRAMES = 10;
+
+    //Real materials and textures so the pointers are genuine, but nothing is ever drawn; both paths only build vertices.
+    Material* materials[NUM_MATERIALS];
+    materials[0] = new Material(SpriteGameRenderer::instance->m_defaultShader, SpriteGameRenderer::instance->m_defaultRenderState);
+    materials[1] = new Material(SpriteGameRenderer::instance->m_defaultShader, SpriteGameRenderer::instance->m_defaultRenderState);
+    materials[2] = new Material(SpriteGameRenderer::instance->m_defaultShader, SpriteGameRenderer::instance->m_additiveBlendRenderState);
+    Texture* textures[NUM_SHEETS];
+    SpriteResource sheets[NUM_SHEETS];
+    for (int i = 0; i < NUM_SHEETS; ++i)
+    {
+        textures[i] = new Texture(16, 16, Texture::TextureFormat::RGBA8);
+        sheets[i].m_texture = textures[i];
+        sheets[i].m_uvBounds = AABB2(Vector2::ZERO, Vector2(0.25f, 0.25f));
+        sheets[i].m_pixelSize = Vector2(16.0f, 16.0f);
+        sheets[i].m_virtualSize = Vector2(1.0f, 1.0f);
+        sheets[i].m_pivotPoint = Vector2(0.5f, 0.5f);
+        sheets[i].m_defaultMaterial = materials[0];
+    }
+
+    //Sprites from every sheet interleaved, grouped by layer the way RenderLayer walks them.
+    std::vector<SpriteDrawData> sprites(numSprites);
+    std::vector<int> layers(numSprites);
+    for (int i = 0; i < numSprites; ++i)
+    {
+        SpriteDrawData& sprite = sprites[i];
+        sprite.m_spriteResource = &sheets[MathUtils::GetRandomIntFromZeroTo(NUM_SHEETS)];
+        sprite.m_material = MathUtils::GetRandomIntFromZeroTo(10) < 8 ? materials[0] : materials[1 + MathUtils::GetRandomIntFromZeroTo(NUM_MATERIALS - 1)];
+        sprite.m_position = Vector2(MathUtils::GetRandomFloatFromZeroTo(100.0f), MathUtils::GetRandomFloatFromZeroTo(100.0f));
+        sprite.m_scale = Vector2::ONE;
+        sprite.m_rotationDegrees = MathUtils::GetRandomFloatFromZeroTo(360.0f);
+        sprite.m_tint = RGBA::WHITE;
+        layers[i] = (i * NUM_LAYERS) / numSprites;
+    }
+    MeshBuilder* builder = new MeshBuilder();
+
+    //Immediate: what RenderLayer used to do, a flush whenever the material or texture changes from the last sprite.
+    unsigned int numImmediateDrawCalls = 0;
+    double startSeconds = GetCurrentTimeSeconds();
+    for (int frame = 0; frame < NUM_FRAMES; ++frame)
+    {
+        numImmediateDrawCalls = 0;
+        const Material* currentMaterial = nullptr;
+        const Texture* currentTexture = nullptr;
+        int currentLayer = -1;
+        for (int i = 0; i < numSprites; ++i)
+        {
+            const SpriteDrawData& sprite = sprites[i];
+            if (sprite.m_material != currentMaterial || sprite.m_spriteResource->m_texture != currentTexture || layers[i] != currentLayer)
+            {
+                ++numImmediateDrawCalls;
+                builder->ClearVertsAndIndices();
+                currentMaterial = sprite.m_material;
+                currentTexture = sprite.m_spriteResource->m_texture;
+                currentLayer = layers[i];
+            }
+            Matrix4x4 scale = Matrix4x4::IDENTITY;
+            Matrix4x4 rotation = Matrix4x4::IDENTITY;
+            Matrix4x4 translation = Matrix4x4::IDENTITY;
+            Matrix4x4::MatrixMakeScale(&scale, Vector3(sprite.m_scale, 0.0f));
+            Matrix4x4::MatrixMakeRotationAroundZ(&rotation, DegreesToRadians(sprite.m_rotationDegrees));
+            Matrix4x4::MatrixMakeTranslation(&translation, Vector3(sprite.m_position, 0.0f));
+            Matrix4x4 model = scale * rotation * translation;
+            builder->AddSprite(sprite.m_spriteResource, sprite.m_tint, &model);
+        }
+        builder->ClearVertsAndIndices();
+    }
+    double immediateSeconds = (GetCurrentTimeSeconds() - startSeconds) / (double)NUM_FRAMES;
+
+    //Draw list: submit, sort, merge, then build each batch's vertices.
+    SpriteDrawList drawList;
+    drawList.SetStateSortingEnabled(true);
+    double sortSeconds = 0.0;
+    startSeconds = GetCurrentTimeSeconds();
+    for (int frame = 0; frame < NUM_FRAMES; ++frame)
+    {
+        drawList.Clear();
+        for (int i = 0; i < numSprites; ++i)
+        {
+            const SpriteDrawData& sprite = sprites[i];
+            drawList.SubmitSprite(layers[i], sprite.m_material, sprite.m_spriteResource, sprite.m_position, sprite.m_scale, sprite.m_rotationDegrees, sprite.m_tint);
+        }
+        double sortStartSeconds = GetCurrentTimeSeconds();
+        drawList.Sort();
+        drawList.BuildBatches();
+        sortSeconds += GetCurrentTimeSeconds() - sortStartSeconds;
+        for (const DrawBatch& batch : drawList.GetBatches())
+        {
+            drawList.AddBatchToMesh(batch, *builder);
+            builder->ClearVertsAndIndices();
+        }
+    }
+    double drawListSeconds = (GetCurrentTimeSeconds() - startSeconds) / (double)NUM_FRAMES;
+    sortSeconds /= (double)NUM_FRAMES;
+
+    delete builder;
+    for (int i = 0; i < NUM_SHEETS; ++i)
+    {
+        delete textures[i];
+    }
+    for (int i = 0; i < NUM_MATERIALS; ++i)
+    {
+        delete materials[i];
+    }
+
+    Console::instance->PrintLine(Stringf("%i sprites from %i sheets, %i materials, %i layers, per frame:", numSprites, NUM_SHEETS, NUM_MATERIALS, NUM_LAYERS), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("Immediate: %.3fms, %u draw calls", immediateSeconds * 1000.0, numImmediateDrawCalls), RGBA::GBWHITE);
+    Console::instance->PrintLine(Stringf("Draw list: %.3fms (%.3fms sorting and batching), %u batches", drawListSeconds * 1000.0, sortSeconds * 1000.0, drawList.GetNumBatches()), RGBA::GBWHITE);
+}
\ No newline at end of file
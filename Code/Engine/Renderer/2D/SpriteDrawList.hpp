@@ -0,0 +1,98 @@
+#pragma once
+#include "Engine/Math/Vector2.hpp"
+#include "Engine/Renderer/RGBA.hpp"
+#include <stdint.h>
+#include <vector>
+
+class Renderable2D;
+class SpriteResource;
+class Material;
+class Texture;
+class MeshBuilder;
+class BufferedMeshRenderer;
+
+//-----------------------------------------------------------------------------------
+// Everything a sprite quad needs, copied out of the renderable at submission time so sorting
+// and vertex building never have to go back into the scene.
+struct SpriteDrawData
+{
+    const SpriteResource* m_spriteResource;
+    Material* m_material;
+    Vector2 m_position;
+    Vector2 m_scale;
+    float m_rotationDegrees;
+    RGBA m_tint;
+};
+
+//-----------------------------------------------------------------------------------
+struct DrawPacket
+{
+    uint64_t m_sortKey;
+    unsigned int m_index; //Into the sprite list, or the renderable list if CUSTOM_DRAW_BIT is set
+};
+
+//-----------------------------------------------------------------------------------
+struct DrawBatch
+{
+    Material* m_material; //nullptr for a run of renderables that draw themselves
+    Texture* m_texture;
+    unsigned int m_firstPacket;
+    unsigned int m_numPackets;
+};
+
+//-----------------------------------------------------------------------------------
+// Collects a view's draws as packets with a 64-bit sort key, radix sorts them and merges runs that
+// share a material and texture, so the BufferedMeshRenderer only flushes once per batch instead of
+// every time two neighbouring renderables happen to use different sheets.
+// Key, most significant first: layer (16) | blend mode (2) | material (12) | texture (12) | depth (22).
+// State sorting is opt-in. With it off, only depth (then submission order, the sort is stable) decides,
+// so sprites and renderables that draw themselves interleave as submitted and only neighbours batch.
+// With it on, sprites in a layer are grouped by render state before depth, so two overlapping sprites
+// on different sheets can swap places and renderables that draw themselves go after all the sprites.
+class SpriteDrawList
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    SpriteDrawList();
+    ~SpriteDrawList();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void Clear();
+    void SubmitSprite(int layer, Material* material, const SpriteResource* spriteResource, const Vector2& position, const Vector2& scale, float rotationDegrees, const RGBA& tint, unsigned int depth = 0);
+    void SubmitRenderable(int layer, Renderable2D* renderable, unsigned int depth = 0); //Drawn by calling its Render(), in submission order unless state sorting is on
+    void Sort();
+    void BuildBatches();
+    void AddBatchToMesh(const DrawBatch& batch, MeshBuilder& builder) const;
+    void DrawRenderables(const DrawBatch& batch, BufferedMeshRenderer& renderer) const; //For a batch without a material
+    void Draw(BufferedMeshRenderer& renderer); //Sorts and batches if that hasn't been done yet
+    inline void SetStateSortingEnabled(bool isEnabled) { m_isStateSortingEnabled = isEnabled; };
+    inline unsigned int GetNumPackets() const { return m_packets.size(); };
+    inline unsigned int GetNumBatches() const { return m_batches.size(); };
+    inline const std::vector<DrawBatch>& GetBatches() const { return m_batches; };
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const unsigned int CUSTOM_DRAW_BIT = 0x80000000;
+    static const unsigned int MAX_STATE_ID = 0xFFF;
+    static const unsigned int MAX_DEPTH = 0x3FFFFF;
+    static const int LAYER_SHIFT = 48;
+    static const int BLEND_MODE_SHIFT = 46;
+    static const int MATERIAL_SHIFT = 34;
+    static const int TEXTURE_SHIFT = 22;
+
+private:
+    //PRIVATE FUNCTIONS/////////////////////////////////////////////////////////////////////
+    uint64_t MakeSortKey(int layer, unsigned int blendMode, unsigned int materialId, unsigned int textureId, unsigned int depth) const;
+    static unsigned int GetStateId(std::vector<const void*>& ids, const void* state);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<DrawPacket> m_packets;
+    std::vector<DrawPacket> m_sortScratch;
+    std::vector<SpriteDrawData> m_sprites;
+    std::vector<Renderable2D*> m_renderables;
+    std::vector<DrawBatch> m_batches;
+    std::vector<const void*> m_materialIds; //Ids are handed out first come first served and kept between frames, so batches draw in a steady order
+    std::vector<const void*> m_textureIds;
+    bool m_isStateSortingEnabled;
+    bool m_isSorted;
+    bool m_areBatchesBuilt;
+};
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "Engine/Renderer/2D/SpriteGameRenderer.hpp"
+#include "Engine/Renderer/2D/SpriteCommandList.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/ShaderProgram.hpp"
 #include "Engine/Renderer/2D/Sprite.hpp"
@@ -6,6 +7,7 @@
 #include "Engine/Renderer/Mesh.hpp"
 #include "Engine/Renderer/Material.hpp"
 #include "Engine/Renderer/Texture.hpp"
+#include "Engine/Renderer/TextureLoader.hpp"
 #include "Engine/Renderer/2D/ResourceDatabase.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Input/Console.hpp"
@@ -124,6 +126,10 @@ SpriteLayer::SpriteLayer(int layerIndex)
 SpriteLayer::~SpriteLayer()
 {
     delete m_layerName;
+    for (SpriteCommandList* commandList : m_commandLists)
+    {
+        delete commandList;
+    }
     Renderable2D* currentRenderable = m_renderablesList;
     if (currentRenderable)
     {
@@ -172,6 +178,34 @@ void SpriteLayer::CleanUpDeadRenderables(bool cleanUpLiveRenderables)
     }
 }
 
+//-----------------------------------------------------------------------------------
+void SpriteLayer::GatherRenderables()
+{
+    m_gatheredRenderables.clear();
+    m_gatheredBounds.clear();
+    Renderable2D* currentRenderable = m_renderablesList;
+    if (currentRenderable)
+    {
+        do
+        {
+            //Getting the bounds also brings any dirty world transform up to date, before several jobs can race to.
+            m_gatheredRenderables.push_back(currentRenderable);
+            m_gatheredBounds.push_back(currentRenderable->GetBounds());
+            currentRenderable = currentRenderable->next;
+        } while (currentRenderable != m_renderablesList);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+SpriteCommandList* SpriteLayer::GetCommandList(unsigned int viewIndex)
+{
+    while (m_commandLists.size() <= viewIndex)
+    {
+        m_commandLists.push_back(new SpriteCommandList());
+    }
+    return m_commandLists[viewIndex];
+}
+
 //-----------------------------------------------------------------------------------
 SpriteGameRenderer::SpriteGameRenderer(const RGBA& clearColor, unsigned int widthInPixels, unsigned int heightInPixels, unsigned int importSize, float virtualSize) : m_clearColor(clearColor)
     , m_importSize(importSize) //Artist's asset size. How big do you make the assets? 240p, 1080p, etc... (144p for gameboy zelda)
@@ -251,6 +285,11 @@ void SpriteGameRenderer::Update(float deltaSeconds)
 {
     #pragma todo("Get changes in screen resolution for the SpriteGameRenderer")
 
+    if (TextureLoader::instance)
+    {
+        TextureLoader::instance->Update();
+    }
+
     for (auto layerPair : m_layers)
     {
         SpriteLayer* layer = layerPair.second;
@@ -274,6 +313,11 @@ void SpriteGameRenderer::Render()
     m_fullscreenCompositeFBO->ClearColorBuffer(0, RGBA::VAPORWAVE);
     m_fullscreenCompositeFBO->Unbind();
 
+    if (m_isParallelRecordingEnabled)
+    {
+        RecordWorldSpaceLayers();
+    }
+
     for (unsigned int i = 0; i < m_numSplitscreenViews; ++i)
     {
         ProfilingSystem::instance->PushSample("SplitscreenViewRender");
@@ -286,6 +330,7 @@ void SpriteGameRenderer::Render()
             m_currentTexturePool = &m_fullscreenTexturePool;
         }
         m_currentViewer = m_playerViewerForViewport[i];
+        m_currentViewIndex = i;
         RenderView(m_viewportDefinitions[i]); 
         DampScreenshake(i);
         ProfilingSystem::instance->PopSample("SplitscreenViewRender");
@@ -295,6 +340,39 @@ void SpriteGameRenderer::Render()
     m_fullscreenCompositeFBO->Unbind();
 }
 
+//-----------------------------------------------------------------------------------
+void SpriteGameRenderer::RecordWorldSpaceLayers()
+{
+    ProfilingSystem::instance->PushSample("RecordWorldSpaceLayers");
+    //Every transform has to be clean before the first job starts, or two of them could both try to update a shared parent.
+    for (auto layerPair : m_layers)
+    {
+        SpriteLayer* layer = layerPair.second;
+        if (layer->m_isEnabled && layer->m_isWorldSpaceLayer)
+        {
+            layer->GatherRenderables();
+        }
+    }
+
+    //Screen space layers are left for RenderLayer, the anchors they hang off move with each view's size.
+    for (auto layerPair : m_layers)
+    {
+        SpriteLayer* layer = layerPair.second;
+        if (!layer->m_isEnabled || !layer->m_isWorldSpaceLayer)
+        {
+            continue;
+        }
+        for (unsigned int i = 0; i < m_numSplitscreenViews; ++i)
+        {
+            const ViewportDefinition& renderArea = m_viewportDefinitions[i];
+            RecalculateVirtualWidthAndHeight(renderArea, layer->m_virtualScaleMultiplier);
+            UpdateCameraPositionInWorldBounds(renderArea.m_cameraPosition, layer->m_virtualScaleMultiplier);
+            layer->GetCommandList(i)->RecordAsync(layer, GetVirtualBoundsAroundCameraCenter(), (uchar)m_playerViewerForViewport[i]);
+        }
+    }
+    ProfilingSystem::instance->PopSample("RecordWorldSpaceLayers");
+}
+
 //-----------------------------------------------------------------------------------
 void SpriteGameRenderer::DampScreenshake(unsigned int i)
 {
@@ -377,9 +455,9 @@ void SpriteGameRenderer::CalculateScreenshakeForViewport(const ViewportDefinitio
 //-----------------------------------------------------------------------------------
 void SpriteGameRenderer::RenderLayer(SpriteLayer* layer, const ViewportDefinition& renderArea)
 {
-    static const size_t horizontalUniform = std::hash<std::string>{}("horizontal");
-    static const size_t gTimeUniform = std::hash<std::string>{}("gTime");
-    static const size_t gWindowResolutionUniform = std::hash<std::string>{}("gWindowResolution");
+    static const UniformName horizontalUniform("horizontal");
+    static const UniformName gTimeUniform("gTime");
+    static const UniformName gWindowResolutionUniform("gWindowResolution");
 
     RecalculateVirtualWidthAndHeight(renderArea, layer->m_virtualScaleMultiplier);
     UpdateCameraPositionInWorldBounds(renderArea.m_cameraPosition, layer->m_virtualScaleMultiplier);
@@ -402,22 +480,15 @@ void SpriteGameRenderer::RenderLayer(SpriteLayer* layer, const ViewportDefinitio
         Renderer::instance->BeginOrtho(m_virtualWidth, m_virtualHeight, cameraPos);
         {
             m_bufferedMeshRenderer.SetModelMatrix(Matrix4x4::IDENTITY);
-            Renderable2D* currentRenderable = layer->m_renderablesList;
-            if (currentRenderable)
+            SpriteCommandList* commandList = layer->GetCommandList(m_currentViewIndex);
+            commandList->WaitForRecording();
+            if (!commandList->HasRecording())
             {
-                do
-                {
-                    bool canBeRendered = ((uchar)m_currentViewer & currentRenderable->m_viewableBy) > 0;
-                    if (canBeRendered)
-                    {
-                        if (!layer->IsCullingEnabled() || !currentRenderable->IsCullable() || renderBounds.IsIntersecting(currentRenderable->GetBounds()))
-                        {
-                            currentRenderable->Render(m_bufferedMeshRenderer);
-                        }
-                    }
-                    currentRenderable = currentRenderable->next;
-                } while (currentRenderable != layer->m_renderablesList);
+                layer->GatherRenderables();
+                commandList->Record(layer, renderBounds, (uchar)m_currentViewer);
             }
+            commandList->Replay(m_bufferedMeshRenderer);
+            commandList->Clear();
             m_bufferedMeshRenderer.FlushAndRender();
         }
         Renderer::instance->EndOrtho();
@@ -540,11 +611,10 @@ SpriteLayer* SpriteGameRenderer::CreateOrGetLayer(int layerNumber)
 //-----------------------------------------------------------------------------------
 void SpriteGameRenderer::AddEffectToLayer(Material* effectMaterial, int layerNumber, PlayerVisibility visibility /*= PlayerVisibility::ALL*/)
 {
-    static size_t gStartTimeUniform = std::hash<std::string>{}("gStartTime");
+    static const UniformName gStartTimeUniform("gStartTime");
     FullScreenEffect fullscreenEffect(effectMaterial);
     fullscreenEffect.m_visibilityFilter = (uchar)visibility;
     CreateOrGetLayer(layerNumber)->m_fullScreenEffects.push_back(fullscreenEffect);
-#pragma todo("This is going to cause a bug if we have multiple copies of the same material.")
     effectMaterial->SetFloatUniform(gStartTimeUniform, (float)GetCurrentTimeSeconds());
 }
 
@@ -867,4 +937,12 @@ CONSOLE_COMMAND(togglelayer)
     }
     int layerNumber = args.GetIntArgument(0);
     SpriteGameRenderer::instance->ToggleLayer(layerNumber);
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(parallelsprites)
+{
+    UNUSED(args)
+    SpriteGameRenderer::instance->m_isParallelRecordingEnabled = !SpriteGameRenderer::instance->m_isParallelRecordingEnabled;
+    Console::instance->PrintLine(Stringf("Parallel sprite recording %s", SpriteGameRenderer::instance->m_isParallelRecordingEnabled ? "enabled" : "disabled"), RGBA::GBWHITE);
 }
\ No newline at end of file
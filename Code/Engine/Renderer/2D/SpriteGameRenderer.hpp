@@ -10,6 +10,7 @@
 #include "Engine/Renderer/2D/ParticleSystem.hpp"
 #include "Engine/Renderer/2D/Renderable2D.hpp"
 #include "Engine/Renderer/BufferedMeshRenderer.hpp"
+#include "Engine/Renderer/2D/SpriteDrawList.hpp"
 #include "Engine/Renderer/Texture.hpp"
 #include "Engine/Renderer/FullScreenEffect.hpp"
 
@@ -19,6 +20,7 @@ class ShaderProgram;
 class Mesh;
 class MeshRenderer;
 class Framebuffer;
+class SpriteCommandList;
 
 //-----------------------------------------------------------------------------------
 struct ViewportDefinition
@@ -51,9 +53,14 @@ public:
     inline void Toggle() { m_isEnabled = !m_isEnabled; }
     inline bool IsCullingEnabled() { return m_isCullingEnabled && m_isWorldSpaceLayer; };
     void CleanUpDeadRenderables(bool cleanUpLiveRenderables = false);
+    void GatherRenderables();
+    SpriteCommandList* GetCommandList(unsigned int viewIndex);
 
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
     std::vector<FullScreenEffect> m_fullScreenEffects;
+    std::vector<Renderable2D*> m_gatheredRenderables; //Flattened from the list with their bounds resolved, so recording jobs only ever read
+    std::vector<AABB2> m_gatheredBounds;
+    std::vector<SpriteCommandList*> m_commandLists; //One per splitscreen view
     AABB2 m_boundingVolume;
     Renderable2D* m_renderablesList;
     const char* m_layerName;
@@ -64,6 +71,7 @@ public:
     bool m_isCullingEnabled = true;
     bool m_isWorldSpaceLayer = true;
     bool m_isBloomEnabled = false;
+    bool m_isStateSortingEnabled = false; //Batch by material and texture. Only for layers where draw order doesn't matter: sprites on different sheets can swap, and text and other custom renderables go last
 };
 
 //-----------------------------------------------------------------------------------
@@ -102,6 +110,7 @@ public:
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
     void Update(float deltaSeconds);
     void Render();
+    void RecordWorldSpaceLayers();
     void RenderView(const ViewportDefinition& renderArea);
     void CalculateScreenshakeForViewport(const ViewportDefinition &renderArea);
     void DampScreenshake(unsigned int i);
@@ -185,6 +194,7 @@ public:
     float m_windowVirtualHeight;
     float m_windowVirtualWidth;
     PlayerVisibility m_playerViewerForViewport[4] = { PlayerVisibility::FIRST, PlayerVisibility::SECOND, PlayerVisibility::THIRD, PlayerVisibility::FOURTH };
+    bool m_isParallelRecordingEnabled = true; //World space layers record on the JobSystem for every view up front
 
 private:
     Transform2D m_bottomRight;
@@ -208,6 +218,7 @@ private:
     TexturePool m_fullscreenTexturePool;
     TexturePool m_viewTexturePool;
     PlayerVisibility m_currentViewer = PlayerVisibility::FIRST;
+    unsigned int m_currentViewIndex = 0;
     RGBA m_clearColor;
 };
 
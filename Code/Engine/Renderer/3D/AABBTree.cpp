@@ -0,0 +1,416 @@
+#include "Engine/Renderer/3D/AABBTree.hpp"
+#include "Engine/Renderer/3D/Frustum.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <math.h>
+
+//-----------------------------------------------------------------------------------
+AABBTree::AABBTree(float fatMargin)
+    : m_root(NULL_NODE)
+    , m_freeList(NULL_NODE)
+    , m_numProxies(0)
+    , m_fatMargin(fatMargin)
+{
+
+}
+
+//-----------------------------------------------------------------------------------
+AABBTree::~AABBTree()
+{
+
+}
+
+//-----------------------------------------------------------------------------------
+int AABBTree::CreateProxy(const AABB3& bounds, void* userData)
+{
+    int proxyId = AllocateNode();
+    Node& leaf = m_nodes[proxyId];
+    leaf.m_bounds = GetFattened(bounds);
+    leaf.m_userData = userData;
+    leaf.m_height = 0;
+    InsertLeaf(proxyId);
+    ++m_numProxies;
+    return proxyId;
+}
+
+//-----------------------------------------------------------------------------------
+void AABBTree::DestroyProxy(int proxyId)
+{
+    ASSERT_OR_DIE(proxyId >= 0 && proxyId < (int)m_nodes.size() && m_nodes[proxyId].IsLeaf() && m_nodes[proxyId].m_height == 0, "Tried to destroy an AABBTree proxy that doesn't exist");
+    RemoveLeaf(proxyId);
+    FreeNode(proxyId);
+    --m_numProxies;
+}
+
+//-----------------------------------------------------------------------------------
+bool AABBTree::MoveProxy(int proxyId, const AABB3& bounds)
+{
+    if (m_nodes[proxyId].m_bounds.IsEncompassing(bounds))
+    {
+        return false;
+    }
+    RemoveLeaf(proxyId);
+    m_nodes[proxyId].m_bounds = GetFattened(bounds);
+    InsertLeaf(proxyId);
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+void AABBTree::RefitProxy(int proxyId, const AABB3& bounds)
+{
+    m_nodes[proxyId].m_bounds = GetFattened(bounds);
+    RefitAncestors(m_nodes[proxyId].m_parent, false);
+}
+
+//-----------------------------------------------------------------------------------
+void AABBTree::Clear()
+{
+    m_nodes.clear();
+    m_root = NULL_NODE;
+    m_freeList = NULL_NODE;
+    m_numProxies = 0;
+}
+
+//-----------------------------------------------------------------------------------
+void AABBTree::QueryFrustum(const Frustum& frustum, std::vector<void*>& out_results) const
+{
+    if (m_root == NULL_NODE)
+    {
+        return;
+    }
+    //Each entry carries the planes its parent wasn't already fully inside of; once that's none, the whole subtree is in.
+    std::vector<std::pair<int, unsigned int>> stack;
+    stack.reserve(64);
+    stack.push_back(std::pair<int, unsigned int>(m_root, Frustum::ALL_PLANES));
+    while (!stack.empty())
+    {
+        int nodeIndex = stack.back().first;
+        unsigned int planeMask = stack.back().second;
+        stack.pop_back();
+        const Node& node = m_nodes[nodeIndex];
+        if (planeMask != 0 && frustum.Classify(node.m_bounds, planeMask) == Frustum::Containment::OUTSIDE)
+        {
+            continue;
+        }
+        if (node.IsLeaf())
+        {
+            out_results.push_back(node.m_userData);
+        }
+        else
+        {
+            stack.push_back(std::pair<int, unsigned int>(node.m_child1, planeMask));
+            stack.push_back(std::pair<int, unsigned int>(node.m_child2, planeMask));
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void AABBTree::QueryAABB3(const AABB3& bounds, std::vector<void*>& out_results) const
+{
+    if (m_root == NULL_NODE)
+    {
+        return;
+    }
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.push_back(m_root);
+    while (!stack.empty())
+    {
+        const Node& node = m_nodes[stack.back()];
+        stack.pop_back();
+        if (!node.m_bounds.IsIntersecting(bounds))
+        {
+            continue;
+        }
+        if (node.IsLeaf())
+        {
+            out_results.push_back(node.m_userData);
+        }
+        else
+        {
+            stack.push_back(node.m_child1);
+            stack.push_back(node.m_child2);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void AABBTree::QueryRay(const Vector3& start, const Vector3& direction, float maxDistance, std::vector<void*>& out_results) const
+{
+    if (m_root == NULL_NODE)
+    {
+        return;
+    }
+    const float PARALLEL_EPSILON = 0.000001f;
+    const float rayStart[3] = { start.x, start.y, start.z };
+    const float rayDirection[3] = { direction.x, direction.y, direction.z };
+    float inverseDirection[3];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        inverseDirection[axis] = fabs(rayDirection[axis]) > PARALLEL_EPSILON ? 1.0f / rayDirection[axis] : 0.0f;
+    }
+
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.push_back(m_root);
+    while (!stack.empty())
+    {
+        const Node& node = m_nodes[stack.back()];
+        stack.pop_back();
+
+        //Slab test: clip [0, maxDistance] against each axis in turn.
+        const float boxMins[3] = { node.m_bounds.mins.x, node.m_bounds.mins.y, node.m_bounds.mins.z };
+        const float boxMaxs[3] = { node.m_bounds.maxs.x, node.m_bounds.maxs.y, node.m_bounds.maxs.z };
+        float entry = 0.0f;
+        float exit = maxDistance;
+        bool isHit = true;
+        for (int axis = 0; axis < 3 && isHit; ++axis)
+        {
+            if (inverseDirection[axis] == 0.0f)
+            {
+                isHit = rayStart[axis] >= boxMins[axis] && rayStart[axis] <= boxMaxs[axis];
+                continue;
+            }
+            float near = (boxMins[axis] - rayStart[axis]) * inverseDirection[axis];
+            float far = (boxMaxs[axis] - rayStart[axis]) * inverseDirection[axis];
+            entry = Max(entry, Min(near, far));
+            exit = Min(exit, Max(near, far));
+            isHit = entry <= exit;
+        }
+        if (!isHit)
+        {
+            continue;
+        }
+        if (node.IsLeaf())
+        {
+            out_results.push_back(node.m_userData);
+        }
+        else
+        {
+            stack.push_back(node.m_child1);
+            stack.push_back(node.m_child2);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+int AABBTree::GetHeight() const
+{
+    return m_root == NULL_NODE ? 0 : m_nodes[m_root].m_height;
+}
+
+//-----------------------------------------------------------------------------------
+int AABBTree::AllocateNode()
+{
+    int nodeIndex = m_freeList;
+    if (nodeIndex == NULL_NODE)
+    {
+        nodeIndex = m_nodes.size();
+        m_nodes.push_back(Node());
+    }
+    else
+    {
+        m_freeList = m_nodes[nodeIndex].m_parent;
+    }
+    Node& node = m_nodes[nodeIndex];
+    node.m_userData = nullptr;
+    node.m_parent = NULL_NODE;
+    node.m_child1 = NULL_NODE;
+    node.m_child2 = NULL_NODE;
+    node.m_height = 0;
+    return nodeIndex;
+}
+
+//-----------------------------------------------------------------------------------
+void AABBTree::FreeNode(int nodeIndex)
+{
+    Node& node = m_nodes[nodeIndex];
+    node.m_parent = m_freeList;
+    node.m_child1 = NULL_NODE;
+    node.m_child2 = NULL_NODE;
+    node.m_height = -1;
+    m_freeList = nodeIndex;
+}
+
+//-----------------------------------------------------------------------------------
+void AABBTree::InsertLeaf(int leaf)
+{
+    if (m_root == NULL_NODE)
+    {
+        m_root = leaf;
+        m_nodes[leaf].m_parent = NULL_NODE;
+        return;
+    }
+
+    //Walk down towards whichever child would cost less to put the leaf under, stopping when pairing up here is cheaper still.
+    AABB3 leafBounds = m_nodes[leaf].m_bounds;
+    int nodeIndex = m_root;
+    while (!m_nodes[nodeIndex].IsLeaf())
+    {
+        const Node& node = m_nodes[nodeIndex];
+        float area = node.m_bounds.GetSurfaceArea();
+        float combinedArea = AABB3::GetEncompassingAABB3(node.m_bounds, leafBounds).GetSurfaceArea();
+        float siblingCost = 2.0f * combinedArea;
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        float childCosts[2];
+        int children[2] = { node.m_child1, node.m_child2 };
+        for (int i = 0; i < 2; ++i)
+        {
+            const Node& child = m_nodes[children[i]];
+            float grownArea = AABB3::GetEncompassingAABB3(child.m_bounds, leafBounds).GetSurfaceArea();
+            childCosts[i] = (child.IsLeaf() ? grownArea : grownArea - child.m_bounds.GetSurfaceArea()) + inheritanceCost;
+        }
+        if (siblingCost < childCosts[0] && siblingCost < childCosts[1])
+        {
+            break;
+        }
+        nodeIndex = childCosts[0] < childCosts[1] ? children[0] : children[1];
+    }
+
+    int sibling = nodeIndex;
+    int oldParent = m_nodes[sibling].m_parent;
+    int newParent = AllocateNode();
+    m_nodes[newParent].m_parent = oldParent;
+    m_nodes[newParent].m_bounds = AABB3::GetEncompassingAABB3(leafBounds, m_nodes[sibling].m_bounds);
+    m_nodes[newParent].m_height = m_nodes[sibling].m_height + 1;
+    m_nodes[newParent].m_child1 = sibling;
+    m_nodes[newParent].m_child2 = leaf;
+    m_nodes[sibling].m_parent = newParent;
+    m_nodes[leaf].m_parent = newParent;
+    if (oldParent == NULL_NODE)
+    {
+        m_root = newParent;
+    }
+    else if (m_nodes[oldParent].m_child1 == sibling)
+    {
+        m_nodes[oldParent].m_child1 = newParent;
+    }
+    else
+    {
+        m_nodes[oldParent].m_child2 = newParent;
+    }
+
+    RefitAncestors(newParent, true);
+}
+
+//-----------------------------------------------------------------------------------
+void AABBTree::RemoveLeaf(int leaf)
+{
+    if (leaf == m_root)
+    {
+        m_root = NULL_NODE;
+        return;
+    }
+
+    int parent = m_nodes[leaf].m_parent;
+    int grandParent = m_nodes[parent].m_parent;
+    int sibling = m_nodes[parent].m_child1 == leaf ? m_nodes[parent].m_child2 : m_nodes[parent].m_child1;
+    m_nodes[sibling].m_parent = grandParent;
+    FreeNode(parent);
+    if (grandParent == NULL_NODE)
+    {
+        m_root = sibling;
+        return;
+    }
+    if (m_nodes[grandParent].m_child1 == parent)
+    {
+        m_nodes[grandParent].m_child1 = sibling;
+    }
+    else
+    {
+        m_nodes[grandParent].m_child2 = sibling;
+    }
+    RefitAncestors(grandParent, true);
+}
+
+//-----------------------------------------------------------------------------------
+void AABBTree::RefitAncestors(int nodeIndex, bool shouldBalance)
+{
+    while (nodeIndex != NULL_NODE)
+    {
+        if (shouldBalance)
+        {
+            nodeIndex = Balance(nodeIndex);
+        }
+        Node& node = m_nodes[nodeIndex];
+        const Node& child1 = m_nodes[node.m_child1];
+        const Node& child2 = m_nodes[node.m_child2];
+        node.m_height = 1 + Max(child1.m_height, child2.m_height);
+        node.m_bounds = AABB3::GetEncompassingAABB3(child1.m_bounds, child2.m_bounds);
+        nodeIndex = node.m_parent;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+int AABBTree::Balance(int nodeIndex)
+{
+    //If one side is more than a level taller, its taller child gets rotated up into this node's place.
+    Node& a = m_nodes[nodeIndex];
+    if (a.IsLeaf() || a.m_height < 2)
+    {
+        return nodeIndex;
+    }
+    int bIndex = a.m_child1;
+    int cIndex = a.m_child2;
+    Node& b = m_nodes[bIndex];
+    Node& c = m_nodes[cIndex];
+    int balance = c.m_height - b.m_height;
+    if (balance >= -1 && balance <= 1)
+    {
+        return nodeIndex;
+    }
+
+    int risingIndex = balance > 1 ? cIndex : bIndex;
+    Node& rising = m_nodes[risingIndex];
+    Node& staying = balance > 1 ? b : c;
+    int fIndex = rising.m_child1;
+    int gIndex = rising.m_child2;
+    Node& f = m_nodes[fIndex];
+    Node& g = m_nodes[gIndex];
+
+    //The rising node takes A's place under A's parent, and A becomes its child.
+    rising.m_child1 = nodeIndex;
+    rising.m_parent = a.m_parent;
+    a.m_parent = risingIndex;
+    if (rising.m_parent == NULL_NODE)
+    {
+        m_root = risingIndex;
+    }
+    else if (m_nodes[rising.m_parent].m_child1 == nodeIndex)
+    {
+        m_nodes[rising.m_parent].m_child1 = risingIndex;
+    }
+    else
+    {
+        m_nodes[rising.m_parent].m_child2 = risingIndex;
+    }
+
+    //The rising node keeps its taller child, and hands the shorter one down to A in the slot it came from.
+    int keptIndex = f.m_height > g.m_height ? fIndex : gIndex;
+    int givenIndex = f.m_height > g.m_height ? gIndex : fIndex;
+    Node& kept = m_nodes[keptIndex];
+    Node& given = m_nodes[givenIndex];
+    rising.m_child2 = keptIndex;
+    if (balance > 1)
+    {
+        a.m_child2 = givenIndex;
+    }
+    else
+    {
+        a.m_child1 = givenIndex;
+    }
+    given.m_parent = nodeIndex;
+    a.m_bounds = AABB3::GetEncompassingAABB3(staying.m_bounds, given.m_bounds);
+    a.m_height = 1 + Max(staying.m_height, given.m_height);
+    rising.m_bounds = AABB3::GetEncompassingAABB3(a.m_bounds, kept.m_bounds);
+    rising.m_height = 1 + Max(a.m_height, kept.m_height);
+    return risingIndex;
+}
+
+//-----------------------------------------------------------------------------------
+AABB3 AABBTree::GetFattened(const AABB3& bounds) const
+{
+    Vector3 margin(m_fatMargin, m_fatMargin, m_fatMargin);
+    return AABB3(bounds.mins - margin, bounds.maxs + margin);
+}
\ No newline at end of file
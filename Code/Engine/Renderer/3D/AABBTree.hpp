@@ -0,0 +1,65 @@
+#pragma once
+#include "Engine/Renderer/AABB3.hpp"
+#include <vector>
+
+class Frustum;
+
+//-----------------------------------------------------------------------------------
+// A dynamic bounding volume hierarchy over AABB3s. Leaves are proxies the caller gets an id for;
+// each one stores a box fattened by a margin, so objects that only move a little never touch the
+// tree. Insertion picks the sibling that grows the total surface area least, and the path back up
+// is rebalanced with rotations, so it stays shallow without ever doing a full rebuild.
+class AABBTree
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    AABBTree(float fatMargin = 0.1f);
+    ~AABBTree();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    int CreateProxy(const AABB3& bounds, void* userData);
+    void DestroyProxy(int proxyId);
+    bool MoveProxy(int proxyId, const AABB3& bounds); //Reinserts only if it left its fat box, returns true if it did
+    void RefitProxy(int proxyId, const AABB3& bounds); //Resizes in place and refits the ancestors, for when reinserting isn't worth it
+    void Clear();
+    void QueryFrustum(const Frustum& frustum, std::vector<void*>& out_results) const;
+    void QueryAABB3(const AABB3& bounds, std::vector<void*>& out_results) const;
+    void QueryRay(const Vector3& start, const Vector3& direction, float maxDistance, std::vector<void*>& out_results) const; //maxDistance is in lengths of direction
+    int GetHeight() const;
+    inline void* GetUserData(int proxyId) const { return m_nodes[proxyId].m_userData; };
+    inline const AABB3& GetFatBounds(int proxyId) const { return m_nodes[proxyId].m_bounds; };
+    inline unsigned int GetNumProxies() const { return m_numProxies; };
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const int NULL_NODE = -1;
+
+private:
+    //STRUCTS/////////////////////////////////////////////////////////////////////
+    struct Node
+    {
+        inline bool IsLeaf() const { return m_child1 == NULL_NODE; };
+
+        AABB3 m_bounds;
+        void* m_userData;
+        int m_parent; //Next free node while on the free list
+        int m_child1;
+        int m_child2;
+        int m_height; //0 for leaves, -1 while free
+    };
+
+    //PRIVATE FUNCTIONS/////////////////////////////////////////////////////////////////////
+    int AllocateNode();
+    void FreeNode(int nodeIndex);
+    void InsertLeaf(int leaf);
+    void RemoveLeaf(int leaf);
+    void RefitAncestors(int nodeIndex, bool shouldBalance);
+    int Balance(int nodeIndex);
+    AABB3 GetFattened(const AABB3& bounds) const;
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<Node> m_nodes;
+    int m_root;
+    int m_freeList;
+    unsigned int m_numProxies;
+    float m_fatMargin;
+};
\ No newline at end of file
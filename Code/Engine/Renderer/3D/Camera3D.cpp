@@ -38,7 +38,7 @@ Vector3 Camera3D::GetLeft() const
 }
 
 //-----------------------------------------------------------------------------------
-Matrix4x4 Camera3D::GetViewMatrix()
+Matrix4x4 Camera3D::GetViewMatrix() const
 {
     //Set up view from camera
     Matrix4x4 view;
@@ -49,6 +49,36 @@ Matrix4x4 Camera3D::GetViewMatrix()
     return view;
 }
 
+//-----------------------------------------------------------------------------------
+Matrix4x4 Camera3D::GetProjectionMatrix() const
+{
+    Matrix4x4 proj = Matrix4x4::IDENTITY;
+    Matrix4x4::MatrixMakePerspective(&proj, m_fovDegreesY, m_aspect, m_nearPlane, m_farPlane);
+    return proj;
+}
+
+//-----------------------------------------------------------------------------------
+Matrix4x4 Camera3D::GetViewProjectionMatrix() const
+{
+    //Row vectors, so the view is applied first.
+    return GetViewMatrix() * GetProjectionMatrix();
+}
+
+//-----------------------------------------------------------------------------------
+Frustum Camera3D::GetFrustum() const
+{
+    return Frustum(GetViewProjectionMatrix());
+}
+
+//-----------------------------------------------------------------------------------
+void Camera3D::SetPerspective(float fovDegreesY, float aspect, float nearPlane, float farPlane)
+{
+    m_fovDegreesY = fovDegreesY;
+    m_aspect = aspect;
+    m_nearPlane = nearPlane;
+    m_farPlane = farPlane;
+}
+
 //-----------------------------------------------------------------------------------
 void Camera3D::LookAt(const Vector3& position)
 {
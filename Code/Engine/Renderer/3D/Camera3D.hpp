@@ -2,6 +2,7 @@
 #include "Engine/Math/Vector3.hpp"
 #include "Engine/Math/EulerAngles.hpp"
 #include "Engine/Math/Matrix4x4.hpp"
+#include "Engine/Renderer/3D/Frustum.hpp"
 
 class Camera3D
 {
@@ -16,7 +17,11 @@ public:
     Vector3 GetForward() const;
     Vector3 GetForwardTwoComponent() const;
     Vector3 GetLeft() const;
-    Matrix4x4 GetViewMatrix();
+    Matrix4x4 GetViewMatrix() const;
+    Matrix4x4 GetProjectionMatrix() const;
+    Matrix4x4 GetViewProjectionMatrix() const;
+    Frustum GetFrustum() const;
+    void SetPerspective(float fovDegreesY, float aspect, float nearPlane, float farPlane);
     void LookAt(const Vector3& position);
 
     //CONSTANTS/////////////////////////////////////////////////////////////////////
@@ -28,4 +33,8 @@ public:
     Vector3 m_position;
     EulerAngles m_orientation;
     bool m_updateFromInput = false;
+    float m_fovDegreesY = 60.0f;
+    float m_aspect = 16.0f / 9.0f;
+    float m_nearPlane = 0.1f;
+    float m_farPlane = 1000.0f;
 };
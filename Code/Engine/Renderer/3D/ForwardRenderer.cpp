@@ -1,6 +1,8 @@
 #include "ForwardRenderer.hpp"
 #include "Scene3D.hpp"
 #include "Camera3D.hpp"
+#include "Frustum.hpp"
+#include "Engine/Renderer/Renderer.hpp"
 
 ForwardRenderer* ForwardRenderer::instance = nullptr;
 
@@ -42,9 +44,11 @@ void ForwardRenderer::Update(float deltaSeconds)
 //-----------------------------------------------------------------------------------
 void ForwardRenderer::Render()
 {
+    //Cull against whatever the renderer is about to draw with, rather than assuming a camera set it up.
+    Frustum frustum(Renderer::instance->GetView() * Renderer::instance->GetProjection());
     for (Scene3D* scene : m_scenes)
     {
-        scene->Render();
+        scene->Render(frustum);
     }
     for (Camera3D* camera : m_cameras)
     {
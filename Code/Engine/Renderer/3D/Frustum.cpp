@@ -0,0 +1,86 @@
+#include "Engine/Renderer/3D/Frustum.hpp"
+#include "Engine/Renderer/AABB3.hpp"
+#include "Engine/Math/Matrix4x4.hpp"
+
+//-----------------------------------------------------------------------------------
+Frustum::Frustum()
+{
+    //Everything is inside until we're given a matrix.
+    for (int i = 0; i < NUM_PLANES; ++i)
+    {
+        m_planes[i] = Vector4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+Frustum::Frustum(const Matrix4x4& viewProjection)
+{
+    //Points go through as Vector4(point, 1) * viewProjection, so clip space component j is a dot with column j,
+    //and -w <= x, y, z <= w turns into a plane per side.
+    const Vector4& x = viewProjection.column[0];
+    const Vector4& y = viewProjection.column[1];
+    const Vector4& z = viewProjection.column[2];
+    const Vector4& w = viewProjection.column[3];
+    m_planes[LEFT_PLANE] = w + x;
+    m_planes[RIGHT_PLANE] = w - x;
+    m_planes[BOTTOM_PLANE] = w + y;
+    m_planes[TOP_PLANE] = w - y;
+    m_planes[NEAR_PLANE] = w + z;
+    m_planes[FAR_PLANE] = w - z;
+    for (int i = 0; i < NUM_PLANES; ++i)
+    {
+        Vector4& plane = m_planes[i];
+        float normalLength = Vector3(plane.x, plane.y, plane.z).CalculateMagnitude();
+        if (normalLength > 0.0f)
+        {
+            plane *= 1.0f / normalLength;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+bool Frustum::IsPointInside(const Vector3& point) const
+{
+    for (int i = 0; i < NUM_PLANES; ++i)
+    {
+        const Vector4& plane = m_planes[i];
+        if ((plane.x * point.x) + (plane.y * point.y) + (plane.z * point.z) + plane.w < 0.0f)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+bool Frustum::IsIntersecting(const AABB3& bounds) const
+{
+    unsigned int planeMask = ALL_PLANES;
+    return Classify(bounds, planeMask) != Containment::OUTSIDE;
+}
+
+//-----------------------------------------------------------------------------------
+Frustum::Containment Frustum::Classify(const AABB3& bounds, unsigned int& inout_planeMask) const
+{
+    //Only the corner furthest along the normal can keep the box in, and only the nearest one can take it fully inside.
+    for (int i = 0; i < NUM_PLANES; ++i)
+    {
+        unsigned int planeBit = 1 << i;
+        if ((inout_planeMask & planeBit) == 0)
+        {
+            continue;
+        }
+        const Vector4& plane = m_planes[i];
+        float furthest = (plane.x * (plane.x >= 0.0f ? bounds.maxs.x : bounds.mins.x)) + (plane.y * (plane.y >= 0.0f ? bounds.maxs.y : bounds.mins.y)) + (plane.z * (plane.z >= 0.0f ? bounds.maxs.z : bounds.mins.z)) + plane.w;
+        if (furthest < 0.0f)
+        {
+            return Containment::OUTSIDE;
+        }
+        float nearest = (plane.x * (plane.x >= 0.0f ? bounds.mins.x : bounds.maxs.x)) + (plane.y * (plane.y >= 0.0f ? bounds.mins.y : bounds.maxs.y)) + (plane.z * (plane.z >= 0.0f ? bounds.mins.z : bounds.maxs.z)) + plane.w;
+        if (nearest >= 0.0f)
+        {
+            inout_planeMask &= ~planeBit;
+        }
+    }
+    return inout_planeMask == 0 ? Containment::INSIDE : Containment::INTERSECTING;
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+#include "Engine/Math/Vector3.hpp"
+#include "Engine/Math/Vector4.hpp"
+
+class Matrix4x4;
+class AABB3;
+
+//-----------------------------------------------------------------------------------
+// The six planes of a view * projection matrix, pulled straight out of its columns (Gribb/Hartmann).
+// Each plane is (normal, distance) with the normal pointing into the volume, so a point is inside
+// when Dot(normal, point) + distance >= 0 for all of them.
+class Frustum
+{
+public:
+    //ENUMS/////////////////////////////////////////////////////////////////////
+    enum PlaneIndex
+    {
+        LEFT_PLANE,
+        RIGHT_PLANE,
+        BOTTOM_PLANE,
+        TOP_PLANE,
+        NEAR_PLANE,
+        FAR_PLANE,
+        NUM_PLANES
+    };
+
+    enum class Containment
+    {
+        OUTSIDE,
+        INTERSECTING,
+        INSIDE
+    };
+
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    Frustum();
+    explicit Frustum(const Matrix4x4& viewProjection);
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    bool IsPointInside(const Vector3& point) const;
+    bool IsIntersecting(const AABB3& bounds) const;
+    Containment Classify(const AABB3& bounds, unsigned int& inout_planeMask) const; //Clears the planes the box is entirely inside of, so its children can skip them
+    inline const Vector4& GetPlane(PlaneIndex plane) const { return m_planes[plane]; };
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const unsigned int ALL_PLANES = (1 << NUM_PLANES) - 1;
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    Vector4 m_planes[NUM_PLANES];
+};
\ No newline at end of file
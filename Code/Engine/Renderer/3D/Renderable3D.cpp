@@ -1,4 +1,5 @@
 #include "Renderable3D.hpp"
+#include <math.h>
 
 //-----------------------------------------------------------------------------------
 Renderable3D::Renderable3D()
@@ -34,3 +35,20 @@ void Renderable3D::Render()
     m_meshRenderer.SetModelMatrix(m_transform.GetModelMatrix());
     m_meshRenderer.Render();
 }
+
+//-----------------------------------------------------------------------------------
+AABB3 Renderable3D::GetWorldBounds()
+{
+    Matrix4x4 model = m_transform.GetModelMatrix();
+    Vector3 center = m_localBounds.GetCenter();
+    Vector3 extents = m_localBounds.GetExtents();
+    Vector4 worldCenter = Vector4(center, 1.0f) * model;
+
+    //Each world axis picks up the absolute contribution of every local axis, which is the tightest box around the rotated one.
+    Vector3 worldExtents;
+    worldExtents.x = (fabs(model.column[0].x) * extents.x) + (fabs(model.column[0].y) * extents.y) + (fabs(model.column[0].z) * extents.z);
+    worldExtents.y = (fabs(model.column[1].x) * extents.x) + (fabs(model.column[1].y) * extents.y) + (fabs(model.column[1].z) * extents.z);
+    worldExtents.z = (fabs(model.column[2].x) * extents.x) + (fabs(model.column[2].y) * extents.y) + (fabs(model.column[2].z) * extents.z);
+    Vector3 worldCenter3(worldCenter.x, worldCenter.y, worldCenter.z);
+    return AABB3(worldCenter3 - worldExtents, worldCenter3 + worldExtents);
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include "..\MeshRenderer.hpp"
 #include "..\..\Math\Transform3D.hpp"
+#include "..\AABB3.hpp"
 
 class Renderable3D
 {
@@ -15,9 +16,14 @@ public:
     void Render();
     void Hide() { m_isEnabled = false; }
     void Show() { m_isEnabled = true; }
+    void SetLocalBounds(const AABB3& localBounds) { m_localBounds = localBounds; m_hasBounds = true; };
+    AABB3 GetWorldBounds(); //The local bounds pushed through the model matrix, still axis aligned
 
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
     MeshRenderer m_meshRenderer;
     Transform3D m_transform;
     bool m_isEnabled = true;
+    AABB3 m_localBounds;
+    bool m_hasBounds = false; //Renderables without bounds are never culled
+    int m_cullingProxy = -1; //Owned by the Scene3D it's registered with
 };
\ No newline at end of file
@@ -1,4 +1,11 @@
 #include "Engine/Renderer/3D/Scene3D.hpp"
+#include "Engine/Renderer/3D/Frustum.hpp"
+#include "Engine/Renderer/3D/Camera3D.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Time/Time.hpp"
+#include <math.h>
 
 //-----------------------------------------------------------------------------------
 Scene3D::Scene3D()
@@ -18,6 +25,24 @@ void Scene3D::Update(float deltaSeconds)
     for (Renderable3D* renderable : m_renderables)
     {
         renderable->Update(deltaSeconds);
+        if (renderable->m_cullingProxy != AABBTree::NULL_NODE)
+        {
+            m_tree.MoveProxy(renderable->m_cullingProxy, renderable->GetWorldBounds());
+        }
+        else if (renderable->m_hasBounds)
+        {
+            //Bounds were set after it was registered, so it can start being culled now.
+            renderable->m_cullingProxy = m_tree.CreateProxy(renderable->GetWorldBounds(), renderable);
+            for (unsigned int i = 0; i < m_unboundedRenderables.size(); ++i)
+            {
+                if (m_unboundedRenderables[i] == renderable)
+                {
+                    m_unboundedRenderables[i] = m_unboundedRenderables[m_unboundedRenderables.size() - 1];
+                    m_unboundedRenderables.pop_back();
+                    break;
+                }
+            }
+        }
     }
 }
 
@@ -30,9 +55,55 @@ void Scene3D::Render() const
     }
 }
 
+//-----------------------------------------------------------------------------------
+void Scene3D::Render(const Frustum& frustum) const
+{
+    m_queryResults.clear();
+    m_tree.QueryFrustum(frustum, m_queryResults);
+    for (void* result : m_queryResults)
+    {
+        static_cast<Renderable3D*>(result)->Render();
+    }
+    for (Renderable3D* renderable : m_unboundedRenderables)
+    {
+        renderable->Render();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void Scene3D::RegisterRenderable(Renderable3D* renderable)
+{
+    m_renderables.push_back(renderable);
+    if (renderable->m_hasBounds)
+    {
+        renderable->m_cullingProxy = m_tree.CreateProxy(renderable->GetWorldBounds(), renderable);
+    }
+    else
+    {
+        m_unboundedRenderables.push_back(renderable);
+    }
+}
+
 //-----------------------------------------------------------------------------------
 void Scene3D::UnregisterRenderable(Renderable3D* renderable)
 {
+    if (renderable->m_cullingProxy != AABBTree::NULL_NODE)
+    {
+        m_tree.DestroyProxy(renderable->m_cullingProxy);
+        renderable->m_cullingProxy = AABBTree::NULL_NODE;
+    }
+    else
+    {
+        for (unsigned int i = 0; i < m_unboundedRenderables.size(); ++i)
+        {
+            if (m_unboundedRenderables[i] == renderable)
+            {
+                m_unboundedRenderables[i] = m_unboundedRenderables[m_unboundedRenderables.size() - 1];
+                m_unboundedRenderables.pop_back();
+                break;
+            }
+        }
+    }
     for (unsigned int i = 0; i < m_renderables.size(); ++i)
     {
         if (m_renderables[i] == renderable)
@@ -44,3 +115,142 @@ void Scene3D::UnregisterRenderable(Renderable3D* renderable)
     }
     ERROR_RECOVERABLE("Couldn't find renderable to unregister");
 }
+
+//-----------------------------------------------------------------------------------
+void Scene3D::QueryFrustum(const Frustum& frustum, std::vector<Renderable3D*>& out_renderables) const
+{
+    m_queryResults.clear();
+    m_tree.QueryFrustum(frustum, m_queryResults);
+    AppendQueryResults(out_renderables);
+}
+
+//-----------------------------------------------------------------------------------
+void Scene3D::QueryAABB3(const AABB3& bounds, std::vector<Renderable3D*>& out_renderables) const
+{
+    m_queryResults.clear();
+    m_tree.QueryAABB3(bounds, m_queryResults);
+    AppendQueryResults(out_renderables);
+}
+
+//-----------------------------------------------------------------------------------
+void Scene3D::QueryRay(const Vector3& start, const Vector3& direction, float maxDistance, std::vector<Renderable3D*>& out_renderables) const
+{
+    m_queryResults.clear();
+    m_tree.QueryRay(start, direction, maxDistance, m_queryResults);
+    AppendQueryResults(out_renderables);
+}
+
+//-----------------------------------------------------------------------------------
+void Scene3D::AppendQueryResults(std::vector<Renderable3D*>& out_renderables) const
+{
+    out_renderables.reserve(out_renderables.size() + m_queryResults.size());
+    for (void* result : m_queryResults)
+    {
+        out_renderables.push_back(static_cast<Renderable3D*>(result));
+    }
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(scenecullbench)
+{
+    int numRenderables = args.HasArgs(1) ? Max<int>(args.GetIntArgument(0), 1) : 100000;
+    const int NUM_VIEWS = 8;
+    const int NUM_QUERIES = 100;
+    const float WORLD_HALF_SIZE = 500.0f;
+
+    //No meshes, so nothing here touches the GPU; it's only the bookkeeping a frame would do before drawing.
+    Scene3D* scene = new Scene3D();
+    std::vector<Renderable3D*> renderables;
+    renderables.reserve(numRenderables);
+    for (int i = 0; i < numRenderables; ++i)
+    {
+        Renderable3D* renderable = new Renderable3D();
+        float halfSize = MathUtils::GetRandomFloatInRange(0.25f, 2.0f);
+        renderable->SetLocalBounds(AABB3(Vector3(-halfSize, -halfSize, -halfSize), Vector3(halfSize, halfSize, halfSize)));
+        renderable->m_transform.SetPosition(Vector3(MathUtils::GetRandomFloatInRange(-WORLD_HALF_SIZE, WORLD_HALF_SIZE), MathUtils::GetRandomFloatInRange(-WORLD_HALF_SIZE, WORLD_HALF_SIZE), MathUtils::GetRandomFloatInRange(-WORLD_HALF_SIZE, WORLD_HALF_SIZE)));
+        renderables.push_back(renderable);
+    }
+
+    double startSeconds = GetCurrentTimeSeconds();
+    for (Renderable3D* renderable : renderables)
+    {
+        scene->RegisterRenderable(renderable);
+    }
+    double buildSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+    //Before: test every renderable's world bounds against the frustum.
+    //After: walk the tree, dropping planes once a node is fully inside them.
+    Camera3D camera;
+    std::vector<AABB3> worldBounds;
+    worldBounds.reserve(numRenderables);
+    for (Renderable3D* renderable : renderables)
+    {
+        worldBounds.push_back(renderable->GetWorldBounds());
+    }
+    std::vector<Renderable3D*> visible;
+    double bruteForceSeconds = 0.0;
+    double treeSeconds = 0.0;
+    unsigned int bruteForceVisible = 0;
+    unsigned int treeVisible = 0;
+    for (int view = 0; view < NUM_VIEWS; ++view)
+    {
+        camera.m_orientation.yawDegreesAboutZ = (360.0f / NUM_VIEWS) * view;
+        Frustum frustum = camera.GetFrustum();
+
+        startSeconds = GetCurrentTimeSeconds();
+        for (const AABB3& bounds : worldBounds)
+        {
+            bruteForceVisible += frustum.IsIntersecting(bounds) ? 1 : 0;
+        }
+        bruteForceSeconds += GetCurrentTimeSeconds() - startSeconds;
+
+        visible.clear();
+        startSeconds = GetCurrentTimeSeconds();
+        scene->QueryFrustum(frustum, visible);
+        treeSeconds += GetCurrentTimeSeconds() - startSeconds;
+        treeVisible += visible.size();
+    }
+
+    visible.clear();
+    startSeconds = GetCurrentTimeSeconds();
+    for (int i = 0; i < NUM_QUERIES; ++i)
+    {
+        float angle = MathUtils::GetRandomFloatInRange(0.0f, MathUtils::TWO_PI);
+        scene->QueryRay(Vector3::ZERO, Vector3(cos(angle), sin(angle), 0.0f), WORLD_HALF_SIZE, visible);
+    }
+    double raySeconds = (GetCurrentTimeSeconds() - startSeconds) / NUM_QUERIES;
+    unsigned int rayHits = visible.size();
+
+    visible.clear();
+    startSeconds = GetCurrentTimeSeconds();
+    for (int i = 0; i < NUM_QUERIES; ++i)
+    {
+        Vector3 center(MathUtils::GetRandomFloatInRange(-WORLD_HALF_SIZE, WORLD_HALF_SIZE), MathUtils::GetRandomFloatInRange(-WORLD_HALF_SIZE, WORLD_HALF_SIZE), MathUtils::GetRandomFloatInRange(-WORLD_HALF_SIZE, WORLD_HALF_SIZE));
+        scene->QueryAABB3(AABB3(center - Vector3(25.0f, 25.0f, 25.0f), center + Vector3(25.0f, 25.0f, 25.0f)), visible);
+    }
+    double boxSeconds = (GetCurrentTimeSeconds() - startSeconds) / NUM_QUERIES;
+    unsigned int boxHits = visible.size();
+
+    //Nudge a tenth of them; most stay inside their fat boxes and never touch the tree.
+    for (int i = 0; i < numRenderables; i += 10)
+    {
+        Vector3 position = renderables[i]->m_transform.GetLocalPosition();
+        renderables[i]->m_transform.SetPosition(position + Vector3(MathUtils::GetRandomFloatInRange(-0.2f, 0.2f), 0.0f, MathUtils::GetRandomFloatInRange(-0.2f, 0.2f)));
+    }
+    startSeconds = GetCurrentTimeSeconds();
+    scene->Update(0.0f);
+    double updateSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+    Console::instance->PrintLine(Stringf("%i renderables, tree built in %.3fms, height %i", numRenderables, buildSeconds * 1000.0, scene->GetTree().GetHeight()), RGBA::GBWHITE);
+    Console::instance->PrintLine(Stringf("Brute force frustum test: %.3fms a view, %u visible", bruteForceSeconds * 1000.0 / NUM_VIEWS, bruteForceVisible / NUM_VIEWS), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("Tree frustum query: %.3fms a view, %u visible", treeSeconds * 1000.0 / NUM_VIEWS, treeVisible / NUM_VIEWS), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("Ray query: %.4fms, %.1f hits; box query: %.4fms, %.1f hits", raySeconds * 1000.0, rayHits / (double)NUM_QUERIES, boxSeconds * 1000.0, boxHits / (double)NUM_QUERIES), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("Update after moving 10%%: %.3fms", updateSeconds * 1000.0), RGBA::CORNFLOWER_BLUE);
+
+    //The scene doesn't own its renderables, so it can go first instead of unregistering them one by one.
+    delete scene;
+    for (Renderable3D* renderable : renderables)
+    {
+        delete renderable;
+    }
+}
@@ -1,9 +1,14 @@
 #pragma once
 #include "Renderable3D.hpp"
+#include "Engine/Renderer/3D/AABBTree.hpp"
 #include <vector>
 
 class Light;
+class Frustum;
 
+//-----------------------------------------------------------------------------------
+// Renderables with bounds live in an AABBTree as well as the flat list, so a camera only has to
+// touch the ones its frustum reaches. Renderables without bounds are always drawn.
 class Scene3D
 {
 public:
@@ -12,10 +17,15 @@ public:
     ~Scene3D();
 
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
-    void Update(float deltaSeconds);
+    void Update(float deltaSeconds); //Also moves each renderable's proxy if it left its fat box
     void Render() const;
-    void RegisterRenderable(Renderable3D* renderable) { m_renderables.push_back(renderable); };
+    void Render(const Frustum& frustum) const;
+    void RegisterRenderable(Renderable3D* renderable);
     void UnregisterRenderable(Renderable3D* renderable);
+    void QueryFrustum(const Frustum& frustum, std::vector<Renderable3D*>& out_renderables) const; //Bounded renderables only
+    void QueryAABB3(const AABB3& bounds, std::vector<Renderable3D*>& out_renderables) const;
+    void QueryRay(const Vector3& start, const Vector3& direction, float maxDistance, std::vector<Renderable3D*>& out_renderables) const;
+    inline const AABBTree& GetTree() const { return m_tree; };
 
     //CONSTANTS/////////////////////////////////////////////////////////////////////
     static constexpr int MAX_NUM_LIGHTS = 8;
@@ -23,4 +33,13 @@ public:
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
     std::vector<Renderable3D*> m_renderables;
     Light* lights[MAX_NUM_LIGHTS];
+
+private:
+    //PRIVATE FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void AppendQueryResults(std::vector<Renderable3D*>& out_renderables) const;
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    AABBTree m_tree;
+    std::vector<Renderable3D*> m_unboundedRenderables;
+    mutable std::vector<void*> m_queryResults;
 };
\ No newline at end of file
@@ -31,3 +31,36 @@ AABB3& AABB3::operator+=(const Vector3& rhs)
 	this->maxs += rhs;
 	return *this;
 }
+
+//-----------------------------------------------------------------------------------
+bool AABB3::IsPointInside(const Vector3& point) const
+{
+	return point.x >= mins.x && point.x <= maxs.x && point.y >= mins.y && point.y <= maxs.y && point.z >= mins.z && point.z <= maxs.z;
+}
+
+//-----------------------------------------------------------------------------------
+bool AABB3::IsIntersecting(const AABB3& other) const
+{
+	return mins.x <= other.maxs.x && maxs.x >= other.mins.x && mins.y <= other.maxs.y && maxs.y >= other.mins.y && mins.z <= other.maxs.z && maxs.z >= other.mins.z;
+}
+
+//-----------------------------------------------------------------------------------
+bool AABB3::IsEncompassing(const AABB3& other) const
+{
+	return mins.x <= other.mins.x && mins.y <= other.mins.y && mins.z <= other.mins.z && maxs.x >= other.maxs.x && maxs.y >= other.maxs.y && maxs.z >= other.maxs.z;
+}
+
+//-----------------------------------------------------------------------------------
+float AABB3::GetSurfaceArea() const
+{
+	Vector3 size = maxs - mins;
+	return 2.0f * ((size.x * size.y) + (size.y * size.z) + (size.z * size.x));
+}
+
+//-----------------------------------------------------------------------------------
+AABB3 AABB3::GetEncompassingAABB3(const AABB3& first, const AABB3& second)
+{
+	Vector3 encompassingMins(first.mins.x < second.mins.x ? first.mins.x : second.mins.x, first.mins.y < second.mins.y ? first.mins.y : second.mins.y, first.mins.z < second.mins.z ? first.mins.z : second.mins.z);
+	Vector3 encompassingMaxs(first.maxs.x > second.maxs.x ? first.maxs.x : second.maxs.x, first.maxs.y > second.maxs.y ? first.maxs.y : second.maxs.y, first.maxs.z > second.maxs.z ? first.maxs.z : second.maxs.z);
+	return AABB3(encompassingMins, encompassingMaxs);
+}
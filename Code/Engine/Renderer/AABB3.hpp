@@ -9,6 +9,17 @@ public:
 	AABB3(const Vector3& Mins, const Vector3& Maxs);
 	~AABB3();
 
+	//FUNCTIONS/////////////////////////////////////////////////////////////////////
+	bool IsPointInside(const Vector3& point) const;
+	bool IsIntersecting(const AABB3& other) const;
+	bool IsEncompassing(const AABB3& other) const;
+	inline Vector3 GetCenter() const { return (mins + maxs) * 0.5f; };
+	inline Vector3 GetExtents() const { return (maxs - mins) * 0.5f; };
+	float GetSurfaceArea() const;
+
+	//STATIC FUNCTIONS/////////////////////////////////////////////////////////////////////
+	static AABB3 GetEncompassingAABB3(const AABB3& first, const AABB3& second);
+
 	//OPERATORS//////////////////////////////////////////////////////////////////////////
 	AABB3& operator+=(const Vector3& rhs);
 	AABB3& operator-=(const Vector3& rhs);
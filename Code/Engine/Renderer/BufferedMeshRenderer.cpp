@@ -53,6 +53,25 @@ void BufferedMeshRenderer::FlushAndRender()
     ProfilingSystem::instance->PopSample("FlushAndRender");
 }
 
+//-----------------------------------------------------------------------------------
+void BufferedMeshRenderer::RenderVertices(const Vertex_Sprite* vertices, unsigned int numVertices, const unsigned int* indices, unsigned int numIndices)
+{
+    if (numIndices == 0)
+    {
+        return;
+    }
+    FlushAndRender();
+    ProfilingSystem::instance->PushSample("RenderVertices");
+    m_mesh.Update((void*)vertices, numVertices, sizeof(Vertex_Sprite), (void*)indices, numIndices, &Vertex_Sprite::BindMeshToVAO);
+    m_mesh.m_drawMode = Renderer::DrawMode::TRIANGLES;
+    m_renderer.Render();
+    m_mesh.MarkMeshEmpty();
+#ifdef PROFILING_ENABLED
+    ProfilingSystem::instance->m_activeSample->numDrawCalls += 1;
+#endif
+    ProfilingSystem::instance->PopSample("RenderVertices");
+}
+
 //-----------------------------------------------------------------------------------
 void BufferedMeshRenderer::SetModelMatrix(const Matrix4x4& model)
 {
@@ -12,6 +12,7 @@ public:
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
     void SetMaterial(Material* newMat);
     void FlushAndRender();
+    void RenderVertices(const Vertex_Sprite* vertices, unsigned int numVertices, const unsigned int* indices, unsigned int numIndices); //Already built elsewhere, skips the builder
     void SetModelMatrix(const Matrix4x4& model);
     void SetDiffuseTexture(Texture* diffuseTexture);
 
@@ -1,311 +1,473 @@
 #include "Engine/Renderer/DebugRenderer.hpp"
 #include "Engine/Renderer/Renderer.hpp"
-#include "Engine/Renderer/Vertex.hpp"
-#include "Engine/Math/Vector3Int.hpp"
-#include <vector>
+#include "Engine/Renderer/Mesh.hpp"
+#include "Engine/Renderer/MeshRenderer.hpp"
+#include "Engine/Renderer/Material.hpp"
+#include "Engine/Renderer/RenderBackend.hpp"
+#include "Engine/Renderer/RecordingRenderBackend.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Time/Time.hpp"
 
 DebugRenderer* DebugRenderer::instance = nullptr;
-std::set<DebugRenderer::Command*> DebugRenderer::s_renderCommands;
+
+//Corners are numbered by bits, x = 1, y = 2, z = 4, set for maxs.
+static const unsigned int BOX_EDGE_CORNERS[24] = { 0, 1, 2, 3, 4, 5, 6, 7, 0, 2, 1, 3, 4, 6, 5, 7, 0, 4, 1, 5, 2, 6, 3, 7 };
+static const unsigned int BOX_FACE_CORNERS[36] = { 0, 2, 1, 1, 2, 3, 4, 5, 6, 5, 7, 6, 0, 1, 4, 1, 5, 4, 2, 6, 3, 3, 6, 7, 0, 4, 2, 2, 4, 6, 1, 3, 5, 3, 7, 5 };
+
+//-----------------------------------------------------------------------------------
+template <typename T>
+static bool UpdateAndCompact(std::vector<T>& primitives, float deltaSeconds)
+{
+    unsigned int numKept = 0;
+    for (T& primitive : primitives)
+    {
+        primitive.m_duration -= deltaSeconds;
+        if (primitive.m_duration >= 0.0f)
+        {
+            primitives[numKept++] = primitive;
+        }
+    }
+    bool removedAny = numKept != primitives.size();
+    primitives.resize(numKept);
+    return removedAny;
+}
+
+//-----------------------------------------------------------------------------------
+DebugRenderer::DebugRenderer()
+    : m_isGeometryDirty(false)
+{
+
+}
+
+//-----------------------------------------------------------------------------------
+DebugRenderer::~DebugRenderer()
+{
+    DeleteRenderObjects();
+}
 
 //-----------------------------------------------------------------------------------
 void DebugRenderer::Update(float deltaSeconds)
 {
-    for (auto commandIter = s_renderCommands.begin(); commandIter != s_renderCommands.end(); ++commandIter)
+    for (PrimitiveLists& primitives : m_primitives)
+    {
+        //Every list gets its durations ticked, so no short-circuiting here.
+        bool removedAny = UpdateAndCompact(primitives.m_points, deltaSeconds);
+        removedAny = UpdateAndCompact(primitives.m_lines, deltaSeconds) || removedAny;
+        removedAny = UpdateAndCompact(primitives.m_arrows, deltaSeconds) || removedAny;
+        removedAny = UpdateAndCompact(primitives.m_boxes, deltaSeconds) || removedAny;
+        removedAny = UpdateAndCompact(primitives.m_spheres, deltaSeconds) || removedAny;
+        m_isGeometryDirty = m_isGeometryDirty || removedAny;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void DebugRenderer::Render()
+{
+    if (!m_streams[DEPTH_TESTED_STREAM].m_material)
+    {
+        CreateRenderObjects();
+    }
+    if (m_isGeometryDirty)
+    {
+        RebuildGeometry();
+    }
+    //Depth tested first, so the untested and x-ray passes land on top.
+    for (GeometryStream& stream : m_streams)
     {
-        DebugRenderer::Command* command = *commandIter;
-        command->m_duration -= deltaSeconds;
-        if (command->HasExpired())
+        if (stream.m_triangleMesh->m_numIndices > 0)
         {
-            commandIter = s_renderCommands.erase(commandIter);
-            if (commandIter == s_renderCommands.end())
-            {
-                break;
-            }
+            stream.m_triangleRenderer->Render();
+        }
+        if (stream.m_lineMesh->m_numIndices > 0)
+        {
+            stream.m_lineRenderer->Render();
         }
     }
 }
 
 //-----------------------------------------------------------------------------------
-void DebugRenderer::Render() const
+void DebugRenderer::Clear()
 {
-    for (Command* command : s_renderCommands)
+    for (PrimitiveLists& primitives : m_primitives)
     {
-        command->Render();
+        primitives.m_points.clear();
+        primitives.m_lines.clear();
+        primitives.m_arrows.clear();
+        primitives.m_boxes.clear();
+        primitives.m_spheres.clear();
     }
+    m_isGeometryDirty = true;
 }
 
 //-----------------------------------------------------------------------------------
 void DebugRenderer::DrawDebugPoint(const Vector3& position, const RGBA& color, float duration, DepthTestingMode mode)
 {
-    DebugRenderer::Command* command = new DebugRenderer::PointCommand(position, color, duration, mode);
-    s_renderCommands.emplace(command);
+    DebugPoint point;
+    point.m_position = position;
+    point.m_color = color;
+    point.m_duration = duration;
+    m_primitives[mode].m_points.push_back(point);
+    m_isGeometryDirty = true;
 }
 
 //-----------------------------------------------------------------------------------
 void DebugRenderer::DrawDebugLine(const Vector3& start, const Vector3& end, const RGBA& color, float duration, DepthTestingMode mode)
 {
-    DebugRenderer::Command* command = new DebugRenderer::LineCommand(start, end, color, duration, mode);
-    s_renderCommands.emplace(command);
+    DebugLine line;
+    line.m_start = start;
+    line.m_end = end;
+    line.m_color = color;
+    line.m_duration = duration;
+    m_primitives[mode].m_lines.push_back(line);
+    m_isGeometryDirty = true;
 }
 
 //-----------------------------------------------------------------------------------
-void DebugRenderer::DrawDebugArrow(const Vector3& start, const Vector3& forward, const RGBA& color, float duration, DepthTestingMode mode)
+void DebugRenderer::DrawDebugArrow(const Vector3& start, const Vector3& end, const RGBA& color, float duration, DepthTestingMode mode)
 {
-    DebugRenderer::Command* command = new DebugRenderer::ArrowCommand(start, forward, color, duration, mode);
-    s_renderCommands.emplace(command);
+    DebugLine arrow;
+    arrow.m_start = start;
+    arrow.m_end = end;
+    arrow.m_color = color;
+    arrow.m_duration = duration;
+    m_primitives[mode].m_arrows.push_back(arrow);
+    m_isGeometryDirty = true;
 }
 
 //-----------------------------------------------------------------------------------
 void DebugRenderer::DrawDebugAABB3(const AABB3& bounds, const RGBA& strokeColor, const RGBA& fillColor, float duration, DepthTestingMode mode)
 {
-    DebugRenderer::Command* command = new DebugRenderer::AABB3Command(bounds, strokeColor, fillColor, duration, mode);
-    s_renderCommands.emplace(command);
+    DebugAABB3 box;
+    box.m_bounds = bounds;
+    box.m_strokeColor = strokeColor;
+    box.m_fillColor = fillColor;
+    box.m_duration = duration;
+    m_primitives[mode].m_boxes.push_back(box);
+    m_isGeometryDirty = true;
 }
 
 //-----------------------------------------------------------------------------------
 void DebugRenderer::DrawDebugSphere(const Vector3& position, float radius, const RGBA& color, float duration, DepthTestingMode mode)
 {
-    DebugRenderer::Command* command = new DebugRenderer::SphereCommand(position, radius, color, duration, mode);
-    s_renderCommands.emplace(command);
+    DebugSphere sphere;
+    sphere.m_position = position;
+    sphere.m_radius = radius;
+    sphere.m_color = color;
+    sphere.m_duration = duration;
+    m_primitives[mode].m_spheres.push_back(sphere);
+    m_isGeometryDirty = true;
 }
 
 //-----------------------------------------------------------------------------------
-DebugRenderer::Command::Command()
+unsigned int DebugRenderer::GetNumPrimitives() const
 {
-
+    unsigned int numPrimitives = 0;
+    for (const PrimitiveLists& primitives : m_primitives)
+    {
+        numPrimitives += primitives.m_points.size() + primitives.m_lines.size() + primitives.m_arrows.size() + primitives.m_boxes.size() + primitives.m_spheres.size();
+    }
+    return numPrimitives;
 }
 
 //-----------------------------------------------------------------------------------
-void DebugRenderer::Command::Render() const
+unsigned int DebugRenderer::GetNumVertices() const
 {
-
+    unsigned int numVertices = 0;
+    for (const GeometryStream& stream : m_streams)
+    {
+        numVertices += stream.m_lineVertices.size() + stream.m_triangleVertices.size();
+    }
+    return numVertices;
 }
 
 //-----------------------------------------------------------------------------------
-DebugRenderer::PointCommand::PointCommand(const Vector3& position, const RGBA& color, float duration, DebugRenderer::DepthTestingMode mode)
-    : m_position(position)
+void DebugRenderer::RebuildGeometry()
 {
-    m_color = color;
-    m_duration = duration;
-    m_mode = mode;
+    for (GeometryStream& stream : m_streams)
+    {
+        stream.m_lineVertices.clear();
+        stream.m_triangleVertices.clear();
+        stream.m_triangleIndices.clear();
+    }
+    AddPrimitives(m_streams[DEPTH_TESTED_STREAM], m_primitives[ON], false);
+    AddPrimitives(m_streams[DEPTH_TESTED_STREAM], m_primitives[XRAY], false);
+    AddPrimitives(m_streams[UNTESTED_STREAM], m_primitives[OFF], false);
+    AddPrimitives(m_streams[UNTESTED_STREAM], m_primitives[XRAY], true);
+    for (GeometryStream& stream : m_streams)
+    {
+        UploadStream(stream);
+    }
+    m_isGeometryDirty = false;
 }
 
 //-----------------------------------------------------------------------------------
-void DebugRenderer::PointCommand::Render() const
+void DebugRenderer::UploadStream(GeometryStream& stream)
 {
-    bool depthTestOn = m_mode == DepthTestingMode::OFF ? false : true;
-    Renderer::instance->EnableDepthTest(depthTestOn);
-    Renderer::instance->DrawLine(m_position - Vector3::UNIT_X, m_position + Vector3::UNIT_X, m_color);
-    Renderer::instance->DrawLine(m_position - Vector3::UNIT_Y, m_position + Vector3::UNIT_Y, m_color);
-    Renderer::instance->DrawLine(m_position - Vector3::UNIT_Z, m_position + Vector3::UNIT_Z, m_color);
-    if (m_mode == DepthTestingMode::XRAY)
-    {
-        Renderer::instance->EnableDepthTest(false);
-        Renderer::instance->DrawLine(m_position - Vector3::UNIT_X, m_position + Vector3::UNIT_X, m_color);
-        Renderer::instance->DrawLine(m_position - Vector3::UNIT_Y, m_position + Vector3::UNIT_Y, m_color);
-        Renderer::instance->DrawLine(m_position - Vector3::UNIT_Z, m_position + Vector3::UNIT_Z, m_color);
+    unsigned int numLineVertices = stream.m_lineVertices.size();
+    if (numLineVertices > m_linearIndices.size())
+    {
+        unsigned int firstNewIndex = m_linearIndices.size();
+        m_linearIndices.resize(numLineVertices);
+        for (unsigned int i = firstNewIndex; i < numLineVertices; ++i)
+        {
+            m_linearIndices[i] = i;
+        }
+    }
+    //Meshes are dynamic, so as long as the buffers are big enough these just overwrite them in place.
+    if (numLineVertices > 0)
+    {
+        stream.m_lineMesh->Update(stream.m_lineVertices.data(), numLineVertices, sizeof(Vertex_PCT), m_linearIndices.data(), numLineVertices, &Vertex_PCT::BindMeshToVAO);
+    }
+    else
+    {
+        stream.m_lineMesh->m_numIndices = 0;
+    }
+    if (stream.m_triangleIndices.size() > 0)
+    {
+        stream.m_triangleMesh->Update(stream.m_triangleVertices.data(), stream.m_triangleVertices.size(), sizeof(Vertex_PCT), stream.m_triangleIndices.data(), stream.m_triangleIndices.size(), &Vertex_PCT::BindMeshToVAO);
+    }
+    else
+    {
+        stream.m_triangleMesh->m_numIndices = 0;
     }
 }
 
 //-----------------------------------------------------------------------------------
-DebugRenderer::LineCommand::LineCommand(const Vector3& start, const Vector3& end, const RGBA& color, float duration, DebugRenderer::DepthTestingMode mode)
-    : m_start(start)
-    , m_end(end)
+void DebugRenderer::CreateRenderObjects()
 {
-    m_color = color;
-    m_duration = duration;
-    m_mode = mode;
+    ShaderProgram* program = Renderer::instance->m_defaultMaterial->m_shaderProgram;
+    for (int i = 0; i < NUM_STREAMS; ++i)
+    {
+        GeometryStream& stream = m_streams[i];
+        RenderState::DepthTestingMode depthMode = i == DEPTH_TESTED_STREAM ? RenderState::DepthTestingMode::ON : RenderState::DepthTestingMode::OFF;
+        stream.m_material = new Material(program, RenderState(depthMode, RenderState::FaceCullingMode::RENDER_BACK_FACES, RenderState::BlendMode::ALPHA_BLEND));
+        stream.m_material->SetDiffuseTexture(Renderer::instance->m_defaultTexture);
+        stream.m_lineMesh = new Mesh();
+        stream.m_lineMesh->m_dynamicDraw = true;
+        stream.m_lineMesh->m_drawMode = Renderer::DrawMode::LINES;
+        stream.m_triangleMesh = new Mesh();
+        stream.m_triangleMesh->m_dynamicDraw = true;
+        stream.m_triangleMesh->m_drawMode = Renderer::DrawMode::TRIANGLES;
+        stream.m_lineRenderer = new MeshRenderer(stream.m_lineMesh, stream.m_material);
+        stream.m_triangleRenderer = new MeshRenderer(stream.m_triangleMesh, stream.m_material);
+    }
+    m_isGeometryDirty = true;
 }
 
 //-----------------------------------------------------------------------------------
-void DebugRenderer::LineCommand::Render() const
+void DebugRenderer::DeleteRenderObjects()
 {
-    bool depthTestOn = m_mode == DepthTestingMode::OFF ? false : true;
-    Renderer::instance->EnableDepthTest(depthTestOn);
-    Renderer::instance->DrawLine(m_start, m_end, m_color);
-    if (m_mode == DepthTestingMode::XRAY)
+    for (GeometryStream& stream : m_streams)
     {
-        Renderer::instance->EnableDepthTest(false);
-        Renderer::instance->DrawLine(m_start, m_end, m_color);
+        delete stream.m_lineRenderer;
+        delete stream.m_triangleRenderer;
+        delete stream.m_lineMesh;
+        delete stream.m_triangleMesh;
+        delete stream.m_material;
+        stream.m_lineRenderer = nullptr;
+        stream.m_triangleRenderer = nullptr;
+        stream.m_lineMesh = nullptr;
+        stream.m_triangleMesh = nullptr;
+        stream.m_material = nullptr;
     }
 }
 
 //-----------------------------------------------------------------------------------
-DebugRenderer::ArrowCommand::ArrowCommand(const Vector3& start, const Vector3& end, const RGBA& color, float duration, DebugRenderer::DepthTestingMode mode)
-    : m_start(start)
-    , m_end(end)
+void DebugRenderer::AddLine(GeometryStream& stream, const Vector3& start, const Vector3& end, const RGBA& color)
 {
-    m_color = color;
-    m_duration = duration;
-    m_mode = mode;
+    stream.m_lineVertices.push_back(Vertex_PCT(start, color, Vector2::ZERO));
+    stream.m_lineVertices.push_back(Vertex_PCT(end, color, Vector2::ZERO));
 }
 
 //-----------------------------------------------------------------------------------
-void DebugRenderer::ArrowCommand::Render() const
+void DebugRenderer::AddPoint(GeometryStream& stream, const DebugPoint& point)
 {
-    bool depthTestOn = m_mode == DepthTestingMode::OFF ? false : true;
-    Renderer::instance->EnableDepthTest(depthTestOn);
-    Renderer::instance->DrawLine(m_start, m_end, m_color);
-    Renderer::instance->DrawPoint(m_end - Vector3::GetNormalized(m_end), m_color, 20.0f);
-    if (m_mode == DepthTestingMode::XRAY)
+    AddLine(stream, point.m_position - Vector3::UNIT_X, point.m_position + Vector3::UNIT_X, point.m_color);
+    AddLine(stream, point.m_position - Vector3::UNIT_Y, point.m_position + Vector3::UNIT_Y, point.m_color);
+    AddLine(stream, point.m_position - Vector3::UNIT_Z, point.m_position + Vector3::UNIT_Z, point.m_color);
+}
+
+//-----------------------------------------------------------------------------------
+void DebugRenderer::AddArrow(GeometryStream& stream, const DebugLine& arrow)
+{
+    AddLine(stream, arrow.m_start, arrow.m_end, arrow.m_color);
+    Vector3 shaft = arrow.m_end - arrow.m_start;
+    float length = shaft.CalculateMagnitude();
+    if (length <= 0.0f)
     {
-        Renderer::instance->EnableDepthTest(false);
-        Renderer::instance->DrawLine(m_start, m_end, m_color);
-        Renderer::instance->DrawPoint(m_end - Vector3::GetNormalized(m_end), m_color, 10.0f);
+        return;
     }
+    //Four barbs swept back from the tip make the head.
+    Vector3 forward = shaft * (1.0f / length);
+    Vector3 reference = fabs(forward.z) < 0.9f ? Vector3::UNIT_Z : Vector3::UNIT_X;
+    Vector3 right = Vector3::GetNormalized(Vector3::Cross(forward, reference));
+    Vector3 up = Vector3::Cross(right, forward);
+    float headLength = Min(length * 0.25f, 1.0f);
+    Vector3 headBase = arrow.m_end - (forward * headLength);
+    float headRadius = headLength * 0.5f;
+    AddLine(stream, arrow.m_end, headBase + (right * headRadius), arrow.m_color);
+    AddLine(stream, arrow.m_end, headBase - (right * headRadius), arrow.m_color);
+    AddLine(stream, arrow.m_end, headBase + (up * headRadius), arrow.m_color);
+    AddLine(stream, arrow.m_end, headBase - (up * headRadius), arrow.m_color);
 }
 
 //-----------------------------------------------------------------------------------
-DebugRenderer::SphereCommand::SphereCommand(const Vector3& position, float radius, const RGBA& color, float duration, DepthTestingMode mode)
-    : m_position(position)
-    , m_radius(radius)
+void DebugRenderer::AddAABB3(GeometryStream& stream, const DebugAABB3& box, const RGBA& fillColor)
 {
-    m_color = color;
-    m_duration = duration;
-    m_mode = mode;
-    //Generate points to use for the sphere algorithm
-    //We need to start off with an octahedron to keep the faces even.
-    std::vector<Vertex_PCT> verts;
-    std::vector<Vector3Int> indices;
-    Vector3 initialPoints[6] = { { 0, 0, radius }, { 0, 0, -radius }, { -radius, -radius, 0 }, { radius, -radius, 0 }, { radius, radius, 0 }, { -radius,  radius, 0 } };
-    Vertex_PCT vert;
-    vert.color = color;
-
-    for (int i = 0; i < 6; i++)
-    {
-        vert.pos = Vector3::GetNormalized(initialPoints[i]) * radius;
-        verts.push_back(vert);
-    }
-
-    indices.push_back(Vector3Int(0, 3, 4));
-    indices.push_back(Vector3Int(0, 4, 5));
-    indices.push_back(Vector3Int(0, 5, 2));
-    indices.push_back(Vector3Int(0, 2, 3));
-    indices.push_back(Vector3Int(1, 4, 3));
-    indices.push_back(Vector3Int(1, 5, 4));
-    indices.push_back(Vector3Int(1, 2, 5));
-    indices.push_back(Vector3Int(1, 3, 2));
-
-    for (int i = 0; i < 3; i++)
-    {
-        int n = indices.size();
-        for (int j = 0; j < n; j++)
-        {
-            // Calculate the midpoints 
-            Vector3 point1 = Vector3::GetMidpoint(verts.at(indices.at(j).x).pos, verts.at(indices.at(j).y).pos);
-            Vector3 point2 = Vector3::GetMidpoint(verts.at(indices.at(j).y).pos, verts.at(indices.at(j).z).pos);
-            Vector3 point3 = Vector3::GetMidpoint(verts.at(indices.at(j).z).pos, verts.at(indices.at(j).x).pos);
-
-            //Move the points to the outside of our sphere.
-            point1.Normalize();
-            point2.Normalize();
-            point3.Normalize();
-
-            //Add these vertices to the list of verts, and store their array location.
-            //Naiive way to check for dupes is here. I'll find a better solution later.
-            int point1Location = -1;
-            int point2Location = -1;
-            int point3Location = -1;
-            for (unsigned int q = 0; q < verts.size(); q++)
-            {
-                Vector3 compare = verts.at(q).pos;
-                if (compare == point1)
-                    point1Location = q;
-                if (compare == point2)
-                    point2Location = q;
-                if (compare == point3)
-                    point3Location = q;
-            }
-            if (point1Location == -1)
-            {
-                point1Location = verts.size(); 
-                vert.pos = point1 * radius;
-                verts.push_back(vert);
-            }
-
-            if (point2Location == -1)
-            {
-                point2Location = verts.size();
-                vert.pos = point2 * radius;
-                verts.push_back(vert);
-            }
-
-            if (point3Location == -1)
-            {
-                point3Location = verts.size();
-                vert.pos = point3 * radius;
-                verts.push_back(vert);
-            }
-
-            //Create 3 new faces (the outer triangles, the pieces of the triforce)
-            indices.push_back(Vector3Int(indices.at(j).x, point1Location, point3Location));
-            indices.push_back(Vector3Int(point1Location, indices.at(j).y, point2Location));
-            indices.push_back(Vector3Int(point3Location, point2Location, indices.at(j).z));
-
-            //Replace the original face with the inner, upside-down triangle (not the triforce)
-            indices.at(j).x = point1Location;
-            indices.at(j).y = point2Location;
-            indices.at(j).z = point3Location;
-        }
+    const AABB3& bounds = box.m_bounds;
+    Vector3 corners[8];
+    for (int i = 0; i < 8; ++i)
+    {
+        corners[i] = Vector3((i & 1) ? bounds.maxs.x : bounds.mins.x, (i & 2) ? bounds.maxs.y : bounds.mins.y, (i & 4) ? bounds.maxs.z : bounds.mins.z);
+    }
+    for (int i = 0; i < 24; i += 2)
+    {
+        AddLine(stream, corners[BOX_EDGE_CORNERS[i]], corners[BOX_EDGE_CORNERS[i + 1]], box.m_strokeColor);
+    }
+    if (fillColor.alpha == 0)
+    {
+        return;
+    }
+    unsigned int firstVertex = stream.m_triangleVertices.size();
+    for (int i = 0; i < 8; ++i)
+    {
+        stream.m_triangleVertices.push_back(Vertex_PCT(corners[i], fillColor, Vector2::ZERO));
+    }
+    for (int i = 0; i < 36; ++i)
+    {
+        stream.m_triangleIndices.push_back(firstVertex + BOX_FACE_CORNERS[i]);
     }
-    //Send sphere to the graphics card
-    m_vboId = Renderer::instance->GenerateBufferID();
-    m_numVerts = verts.size();
-    Renderer::instance->BindAndBufferVBOData(m_vboId, verts.data(), m_numVerts);
 }
 
 //-----------------------------------------------------------------------------------
-DebugRenderer::SphereCommand::~SphereCommand()
+void DebugRenderer::AddSphere(GeometryStream& stream, const DebugSphere& sphere)
 {
-    Renderer::instance->DeleteBuffers(m_vboId);
+    //Every sphere is the same unit template, scaled and moved into place.
+    const std::vector<Vector3>& sphereTemplate = GetSphereTemplate();
+    for (const Vector3& templatePoint : sphereTemplate)
+    {
+        stream.m_lineVertices.push_back(Vertex_PCT(sphere.m_position + (templatePoint * sphere.m_radius), sphere.m_color, Vector2::ZERO));
+    }
 }
 
 //-----------------------------------------------------------------------------------
-void DebugRenderer::SphereCommand::Render() const
+void DebugRenderer::AddPrimitives(GeometryStream& stream, const PrimitiveLists& primitives, bool isXRayPass)
 {
-    Renderer::instance->PushMatrix();
+    stream.m_lineVertices.reserve(stream.m_lineVertices.size() + (primitives.m_points.size() * 6) + (primitives.m_lines.size() * 2) + (primitives.m_arrows.size() * 10)
+        + (primitives.m_boxes.size() * 24) + (primitives.m_spheres.size() * GetSphereTemplate().size()));
+    for (const DebugPoint& point : primitives.m_points)
     {
-        Renderer::instance->Translate(m_position);
-
-        bool depthTestOn = m_mode == DepthTestingMode::OFF ? false : true;
-        Renderer::instance->EnableDepthTest(depthTestOn);
-        Renderer::instance->SetPointSize(5.0f);
-        Renderer::instance->DrawVBO_PCT(m_vboId, m_numVerts, Renderer::DrawMode::POINTS);
-        if (m_mode == DepthTestingMode::XRAY)
+        AddPoint(stream, point);
+    }
+    for (const DebugLine& line : primitives.m_lines)
+    {
+        AddLine(stream, line.m_start, line.m_end, line.m_color);
+    }
+    for (const DebugLine& arrow : primitives.m_arrows)
+    {
+        AddArrow(stream, arrow);
+    }
+    for (const DebugAABB3& box : primitives.m_boxes)
+    {
+        //The part of an x-rayed box that's behind something gets a faded fill.
+        RGBA fillColor = box.m_fillColor;
+        if (isXRayPass)
         {
-            Renderer::instance->EnableDepthTest(false);
-            Renderer::instance->SetPointSize(2.0f);
-            Renderer::instance->DrawVBO_PCT(m_vboId, m_numVerts, Renderer::DrawMode::POINTS);
+            fillColor.alpha = Min<unsigned char>(fillColor.alpha, 0x80);
         }
+        AddAABB3(stream, box, fillColor);
+    }
+    for (const DebugSphere& sphere : primitives.m_spheres)
+    {
+        AddSphere(stream, sphere);
     }
-    Renderer::instance->PopMatrix();
 }
 
 //-----------------------------------------------------------------------------------
-DebugRenderer::AABB3Command::AABB3Command(const AABB3& bounds, const RGBA& strokeColor, const RGBA& fillColor, float duration, DepthTestingMode mode)
-    : m_bounds(bounds)
-    , m_fillColor(fillColor)
+const std::vector<Vector3>& DebugRenderer::GetSphereTemplate()
 {
-    m_color = strokeColor;
-    m_duration = duration;
-    m_mode = mode;
+    //A ring around each axis, as line segment pairs on the unit sphere.
+    static std::vector<Vector3> s_sphereTemplate;
+    if (s_sphereTemplate.empty())
+    {
+        s_sphereTemplate.reserve(3 * SPHERE_RING_SEGMENTS * 2);
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            for (int segment = 0; segment < SPHERE_RING_SEGMENTS; ++segment)
+            {
+                for (int end = 0; end < 2; ++end)
+                {
+                    float radians = MathUtils::TWO_PI * (float)(segment + end) / (float)SPHERE_RING_SEGMENTS;
+                    float a = cos(radians);
+                    float b = sin(radians);
+                    s_sphereTemplate.push_back(axis == 0 ? Vector3(0.0f, a, b) : (axis == 1 ? Vector3(a, 0.0f, b) : Vector3(a, b, 0.0f)));
+                }
+            }
+        }
+    }
+    return s_sphereTemplate;
 }
 
 //-----------------------------------------------------------------------------------
-void DebugRenderer::AABB3Command::Render() const
+CONSOLE_COMMAND(debugrenderbench)
 {
-    bool depthTestOn = m_mode == DepthTestingMode::OFF ? false : true;
-    Renderer::instance->EnableDepthTest(depthTestOn);
-    Renderer::instance->SetLineWidth(7.0f);
-    Renderer::instance->DrawTexturedAABB3(m_bounds, m_fillColor);
-    Renderer::instance->DrawAABBBoundingBox(m_bounds, m_color);
-    if (m_mode == DepthTestingMode::XRAY)
-    {
-        Renderer::instance->EnableDepthTest(false);
-        Renderer::instance->SetLineWidth(1.0f);
-        RGBA fadedColor = m_fillColor;
-        fadedColor.alpha = 0x80;
-        Renderer::instance->DrawTexturedAABB3(m_bounds, fadedColor);
-        Renderer::instance->DrawAABBBoundingBox(m_bounds, m_color);
+    int numLines = args.HasArgs(1) ? Max<int>(args.GetIntArgument(0), 1) : 100000;
+    const int NUM_FRAMES = 10;
+    const int NUM_IMMEDIATE_LINES = Min(numLines, 2000); //The old path is slow enough that a sample has to do
+
+    //Measured against a headless recorder, so only the engine's side of drawing is timed.
+    //The override puts the renderer's and the programs' caches back afterwards, since none of this reaches the driver.
+    RecordingRenderBackend* recorder = new RecordingRenderBackend();
+    RenderBackend* previousBackend = Renderer::instance->BeginBackendOverride(recorder);
+
+    std::vector<Vector3> points(numLines * 2);
+    for (Vector3& point : points)
+    {
+        point = Vector3(MathUtils::GetRandomFloatInRange(-100.0f, 100.0f), MathUtils::GetRandomFloatInRange(-100.0f, 100.0f), MathUtils::GetRandomFloatInRange(-100.0f, 100.0f));
     }
-}
+
+    //Before: every line is its own mesh and draw call, every frame.
+    recorder->ResetStatistics();
+    double startSeconds = GetCurrentTimeSeconds();
+    for (int i = 0; i < NUM_IMMEDIATE_LINES; ++i)
+    {
+        Renderer::instance->EnableDepthTest(true);
+        Renderer::instance->DrawLine(points[i * 2], points[i * 2 + 1], RGBA::GREEN);
+    }
+    double immediateSecondsPerLine = (GetCurrentTimeSeconds() - startSeconds) / Max(NUM_IMMEDIATE_LINES, 1);
+    double immediateDrawCallsPerLine = (double)recorder->GetStatistics().m_numDrawCalls / Max(NUM_IMMEDIATE_LINES, 1);
+
+    //After: one streaming buffer per depth state, rebuilt once when the lines change and then just drawn.
+    DebugRenderer* debugRenderer = new DebugRenderer();
+    for (int i = 0; i < numLines; ++i)
+    {
+        debugRenderer->DrawDebugLine(points[i * 2], points[i * 2 + 1], RGBA::GREEN, 10.0f, (DebugRenderer::DepthTestingMode)(i % DebugRenderer::NUM_MODES));
+    }
+    recorder->ResetStatistics();
+    startSeconds = GetCurrentTimeSeconds();
+    debugRenderer->Update(0.0f);
+    debugRenderer->Render();
+    double rebuildSeconds = GetCurrentTimeSeconds() - startSeconds;
+    RecordingRenderBackend::Statistics rebuildStatistics = recorder->GetStatistics();
+
+    recorder->ResetStatistics();
+    startSeconds = GetCurrentTimeSeconds();
+    for (int frame = 0; frame < NUM_FRAMES; ++frame)
+    {
+        debugRenderer->Update(0.001f);
+        debugRenderer->Render();
+    }
+    double steadySeconds = (GetCurrentTimeSeconds() - startSeconds) / NUM_FRAMES;
+    RecordingRenderBackend::Statistics steadyStatistics = recorder->GetStatistics();
+
+    Console::instance->PrintLine(Stringf("%i debug lines, %u vertices in the streams", numLines, debugRenderer->GetNumVertices()), RGBA::GBWHITE);
+    Console::instance->PrintLine(Stringf("Per line immediate (sampled %i): %.3fms a frame for all lines, %.0f draw calls", NUM_IMMEDIATE_LINES, immediateSecondsPerLine * numLines * 1000.0, immediateDrawCallsPerLine * numLines), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("Batched, rebuilding: %.3fms, %u draw calls, %.1fKB uploaded", rebuildSeconds * 1000.0, (unsigned int)rebuildStatistics.m_numDrawCalls, rebuildStatistics.m_numBytesUploaded / 1024.0), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("Batched, unchanged: %.3fms a frame, %.1f draw calls, %.1fKB uploaded", steadySeconds * 1000.0, steadyStatistics.m_numDrawCalls / (double)NUM_FRAMES, steadyStatistics.m_numBytesUploaded / 1024.0 / NUM_FRAMES), RGBA::CORNFLOWER_BLUE);
+
+    delete debugRenderer;
+    Renderer::instance->EndBackendOverride(previousBackend);
+    delete recorder;
+}
\ No newline at end of file
@@ -1,10 +1,19 @@
 #pragma once
 
-#include <set>
+#include <vector>
 #include "Engine\Math\Vector3.hpp"
 #include "Engine\Renderer\RGBA.hpp"
 #include "Engine\Renderer\AABB3.hpp"
+#include "Engine\Renderer\Vertex.hpp"
 
+class Mesh;
+class MeshRenderer;
+class Material;
+
+//-----------------------------------------------------------------------------------
+// Primitives are kept in flat arrays, grouped by depth mode and then by type, and expire in a single
+// compacting pass. Geometry is only regenerated when something was added or expired, into one streaming
+// line buffer and one triangle buffer for each depth state; XRAY primitives go into both.
 class DebugRenderer
 {
 public:
@@ -17,87 +26,106 @@ public:
 		NUM_MODES
 	};
 
+	//CONSTRUCTORS//////////////////////////////////////////////////////////////////////////
+	DebugRenderer();
+	~DebugRenderer();
+
 	//FUNCTIONS//////////////////////////////////////////////////////////////////////////
 	void Update(float deltaSeconds);
-	void Render() const;
+	void Render();
+	void Clear();
 	void DrawDebugPoint(const Vector3& position, const RGBA& color, float duration, DepthTestingMode mode);
 	void DrawDebugLine(const Vector3& start, const Vector3& end, const RGBA& color, float duration, DepthTestingMode mode);
-	void DrawDebugArrow(const Vector3& start, const Vector3& forward, const RGBA& color, float duration, DepthTestingMode mode);
+	void DrawDebugArrow(const Vector3& start, const Vector3& end, const RGBA& color, float duration, DepthTestingMode mode);
 	void DrawDebugAABB3(const AABB3& bounds, const RGBA& strokeColor, const RGBA& fillColor, float duration, DepthTestingMode mode);
 	void DrawDebugSphere(const Vector3& position, float radius, const RGBA& color, float duration, DepthTestingMode mode);
+	unsigned int GetNumPrimitives() const;
+	unsigned int GetNumVertices() const; //As of the last rebuild
 
+	//STATIC VARIABLES//////////////////////////////////////////////////////////////////////////
 	static DebugRenderer* instance;
 
 private:
-	//---------------------------------------------------------------------------
-	class Command
+	//STRUCTS//////////////////////////////////////////////////////////////////////////
+	struct DebugPoint
 	{
-	public:
-		Command();
-		virtual void Render() const;
-		inline bool HasExpired() { return m_duration < 0.0f; };
-
+		Vector3 m_position;
 		RGBA m_color;
 		float m_duration;
-		DebugRenderer::DepthTestingMode m_mode;
-	};
-
-	//---------------------------------------------------------------------------
-	class PointCommand : public Command
-	{
-	public:
-		PointCommand(const Vector3& position, const RGBA& color, float duration, DebugRenderer::DepthTestingMode mode);
-		virtual void Render() const;
-
-		Vector3 m_position;
 	};
 
-	//---------------------------------------------------------------------------
-	class LineCommand : public Command
+	struct DebugLine
 	{
-	public:
-		LineCommand(const Vector3& start, const Vector3& end, const RGBA& color, float duration, DebugRenderer::DepthTestingMode mode);
-		virtual void Render() const;
-
 		Vector3 m_start;
 		Vector3 m_end;
+		RGBA m_color;
+		float m_duration;
 	};
 
-	//---------------------------------------------------------------------------
-	class ArrowCommand : public Command
+	struct DebugAABB3
 	{
-	public:
-		ArrowCommand(const Vector3& start, const Vector3& forward, const RGBA& color, float duration, DebugRenderer::DepthTestingMode mode);
-		virtual void Render() const;
-
-		Vector3 m_start;
-		Vector3 m_end;
+		AABB3 m_bounds;
+		RGBA m_strokeColor;
+		RGBA m_fillColor;
+		float m_duration;
 	};
 
-	//---------------------------------------------------------------------------
-	class AABB3Command : public Command
+	struct DebugSphere
 	{
-	public:
-		AABB3Command(const AABB3& bounds, const RGBA& strokeColor, const RGBA& fillColor, float duration, DepthTestingMode mode);
-		virtual void Render() const;
+		Vector3 m_position;
+		float m_radius;
+		RGBA m_color;
+		float m_duration;
+	};
 
-		AABB3 m_bounds;
-		RGBA m_fillColor;
+	struct PrimitiveLists
+	{
+		std::vector<DebugPoint> m_points;
+		std::vector<DebugLine> m_lines;
+		std::vector<DebugLine> m_arrows;
+		std::vector<DebugAABB3> m_boxes;
+		std::vector<DebugSphere> m_spheres;
 	};
 
 	//---------------------------------------------------------------------------
-	class SphereCommand : public Command
+	struct GeometryStream
 	{
-	public:
-		SphereCommand(const Vector3& position, float radius, const RGBA& color, float duration, DepthTestingMode mode);
-		~SphereCommand();
-		virtual void Render() const;
+		std::vector<Vertex_PCT> m_lineVertices;
+		std::vector<Vertex_PCT> m_triangleVertices;
+		std::vector<unsigned int> m_triangleIndices;
+		Mesh* m_lineMesh = nullptr;
+		Mesh* m_triangleMesh = nullptr;
+		MeshRenderer* m_lineRenderer = nullptr;
+		MeshRenderer* m_triangleRenderer = nullptr;
+		Material* m_material = nullptr;
+	};
 
-		Vector3 m_position;
-		float m_radius;
-		int m_vboId;
-		int m_numVerts;
+	enum StreamType
+	{
+		DEPTH_TESTED_STREAM,
+		UNTESTED_STREAM,
+		NUM_STREAMS
 	};
 
-	static std::set<Command*> s_renderCommands;
+	//PRIVATE FUNCTIONS//////////////////////////////////////////////////////////////////////////
+	void RebuildGeometry();
+	void UploadStream(GeometryStream& stream);
+	void CreateRenderObjects();
+	void DeleteRenderObjects();
+	void AddLine(GeometryStream& stream, const Vector3& start, const Vector3& end, const RGBA& color);
+	void AddPoint(GeometryStream& stream, const DebugPoint& point);
+	void AddArrow(GeometryStream& stream, const DebugLine& arrow);
+	void AddAABB3(GeometryStream& stream, const DebugAABB3& box, const RGBA& fillColor);
+	void AddSphere(GeometryStream& stream, const DebugSphere& sphere);
+	void AddPrimitives(GeometryStream& stream, const PrimitiveLists& primitives, bool isXRayPass);
+	static const std::vector<Vector3>& GetSphereTemplate();
+
+	//MEMBER VARIABLES//////////////////////////////////////////////////////////////////////////
+	PrimitiveLists m_primitives[NUM_MODES];
+	GeometryStream m_streams[NUM_STREAMS];
+	std::vector<unsigned int> m_linearIndices; //0, 1, 2... shared by the line meshes
+	bool m_isGeometryDirty;
+
+	//CONSTANTS//////////////////////////////////////////////////////////////////////////
+	static const int SPHERE_RING_SEGMENTS = 32;
 };
\ No newline at end of file
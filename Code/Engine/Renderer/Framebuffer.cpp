@@ -5,6 +5,7 @@
 #include <gl/GL.h>
 #include <gl/GLU.h>
 #include "Engine/Renderer/OpenGLExtensions.hpp"
+#include "Engine/Renderer/RenderBackend.hpp"
 #include "Engine/Renderer/Texture.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/RGBA.hpp"
@@ -29,8 +30,7 @@ Framebuffer* Framebuffer::FramebufferCreate(size_t colorCount, Texture** inColor
         ASSERT_OR_DIE(((uint32_t)depthStencilTarget->m_texelSize.x == width) && ((uint32_t)depthStencilTarget->m_texelSize.y == height), "Depth Stencil Target didn't match the height and width of the first target");
     }
 
-    GLuint fboHandle;
-    glGenFramebuffers(1, &fboHandle);
+    GLuint fboHandle = RenderBackend::instance->CreateFramebuffer();
     ASSERT_OR_DIE(fboHandle != NULL, "Failed to grab fbo handle");
 
     Framebuffer* fbo = new Framebuffer();
@@ -48,41 +48,39 @@ Framebuffer* Framebuffer::FramebufferCreate(size_t colorCount, Texture** inColor
 
     //OpenGL initialization stuff
     //If you bound a framebuffer to your Renderer, be careful you didn't unbind just now...
-    glBindFramebuffer(GL_FRAMEBUFFER, fbo->m_fboHandle);
+    RenderBackend::instance->BindFramebuffer(GL_FRAMEBUFFER, fbo->m_fboHandle);
 
     //Bind our color targets to our FBO
     for (uint32_t i = 0; i < colorCount; ++i)
     {
         Texture* tex = inColorTargets[i];
-        glFramebufferTexture(GL_FRAMEBUFFER, //What we're attaching
+        RenderBackend::instance->FramebufferTexture(GL_FRAMEBUFFER, //What we're attaching
             GL_COLOR_ATTACHMENT0 + i, //Where we're attaching
-            tex->m_openglTextureID, //OpenGL id
-            0); //Level - probably mipmap level
+            tex->m_openglTextureID); //OpenGL id
         GL_CHECK_ERROR();
     }
     
     //Bind depth stencil if you have it.
     if (nullptr != depthStencilTarget)
     {
-        glFramebufferTexture(GL_FRAMEBUFFER,
+        RenderBackend::instance->FramebufferTexture(GL_FRAMEBUFFER,
             GL_DEPTH_STENCIL_ATTACHMENT,
-            depthStencilTarget->m_openglTextureID,
-            0);
+            depthStencilTarget->m_openglTextureID);
         GL_CHECK_ERROR();
     }
 
     //Make sure everything was bound correctly, no errors!
-    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    GLenum status = RenderBackend::instance->CheckFramebufferStatus(GL_FRAMEBUFFER);
     if (status != GL_FRAMEBUFFER_COMPLETE)
     {
-        glBindFramebuffer(GL_FRAMEBUFFER, NULL);
+        RenderBackend::instance->BindFramebuffer(GL_FRAMEBUFFER, NULL);
         FramebufferDelete(fbo);
         ERROR_RECOVERABLE("Error occured while binding framebuffer");
         return nullptr;
     }
 
     //Revert to old state
-    glBindFramebuffer(GL_FRAMEBUFFER, NULL);
+    RenderBackend::instance->BindFramebuffer(GL_FRAMEBUFFER, NULL);
     return fbo;
 }
 
@@ -93,7 +91,7 @@ void Framebuffer::FramebufferDelete(Framebuffer *fbo)
     {
         Renderer::instance->BindFramebuffer(nullptr);
     }
-    glDeleteFramebuffers(1, &fbo->m_fboHandle);
+    RenderBackend::instance->DeleteFramebuffer(fbo->m_fboHandle);
     delete fbo;
 }
 
@@ -112,22 +110,21 @@ void Framebuffer::AddColorTarget(Texture* colorTarget)
     m_colorTargets.push_back(colorTarget); 
     m_colorCount = m_colorTargets.size();
 
-    glBindFramebuffer(GL_FRAMEBUFFER, m_fboHandle);
-    glFramebufferTexture(GL_FRAMEBUFFER, //What we're attaching
+    RenderBackend::instance->BindFramebuffer(GL_FRAMEBUFFER, m_fboHandle);
+    RenderBackend::instance->FramebufferTexture(GL_FRAMEBUFFER, //What we're attaching
         GL_COLOR_ATTACHMENT0 + targetNumber, //Where we're attaching
-        colorTarget->m_openglTextureID, //OpenGL id
-        0); //Level - probably mipmap level
+        colorTarget->m_openglTextureID); //OpenGL id
     GL_CHECK_ERROR();
 
     //Make sure everything was bound correctly, no errors!
-    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    GLenum status = RenderBackend::instance->CheckFramebufferStatus(GL_FRAMEBUFFER);
     if (status != GL_FRAMEBUFFER_COMPLETE)
     {
         ERROR_RECOVERABLE("Error occured while binding framebuffer");
     }
 
     //Revert to old state
-    glBindFramebuffer(GL_FRAMEBUFFER, NULL);
+    RenderBackend::instance->BindFramebuffer(GL_FRAMEBUFFER, NULL);
 }
 
 //-----------------------------------------------------------------------------------
@@ -136,22 +133,21 @@ Texture* Framebuffer::SwapColorTarget(Texture* colorTarget, int index)
     Texture* swappedOutTexture = m_colorTargets[index];
     m_colorTargets[index] = colorTarget;
 
-    glBindFramebuffer(GL_FRAMEBUFFER, m_fboHandle);
-    glFramebufferTexture(GL_FRAMEBUFFER, //What we're attaching
+    RenderBackend::instance->BindFramebuffer(GL_FRAMEBUFFER, m_fboHandle);
+    RenderBackend::instance->FramebufferTexture(GL_FRAMEBUFFER, //What we're attaching
         GL_COLOR_ATTACHMENT0 + index, //Where we're attaching
-        colorTarget->m_openglTextureID, //OpenGL id
-        0); //Level - probably mipmap level
+        colorTarget->m_openglTextureID); //OpenGL id
     GL_CHECK_ERROR();
 
     //Make sure everything was bound correctly, no errors!
-    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    GLenum status = RenderBackend::instance->CheckFramebufferStatus(GL_FRAMEBUFFER);
     if (status != GL_FRAMEBUFFER_COMPLETE)
     {
         ERROR_RECOVERABLE("Error occured while binding framebuffer");
     }
 
     //Revert to old state
-    glBindFramebuffer(GL_FRAMEBUFFER, NULL);
+    RenderBackend::instance->BindFramebuffer(GL_FRAMEBUFFER, NULL);
     return swappedOutTexture;
 }
 
@@ -179,7 +175,7 @@ void Framebuffer::ClearColorBuffer(int bufferNumber, const RGBA& clearColor)
     colorData[1] = colorVector.y;
     colorData[2] = colorVector.z;
     colorData[3] = colorVector.w;
-    glClearBufferfv(GL_COLOR, bufferNumber, colorData);
+    RenderBackend::instance->ClearColorBuffer(bufferNumber, colorData);
     GL_CHECK_ERROR();
 }
 
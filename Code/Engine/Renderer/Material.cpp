@@ -7,6 +7,13 @@
 #include <gl/GL.h>
 #include <gl/GLU.h>
 #include "Engine/Renderer/OpenGLExtensions.hpp"
+#include "Engine/Renderer/RenderBackend.hpp"
+#include "Engine/Renderer/RecordingRenderBackend.hpp"
+#include "Engine/Math/Matrix4x4.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Time/Time.hpp"
 
 //-----------------------------------------------------------------------------------
 RenderState::RenderState(DepthTestingMode depthTesting, FaceCullingMode faceCulling, BlendMode blendMode)
@@ -94,60 +101,45 @@ Material::~Material()
 //-----------------------------------------------------------------------------------
 void Material::SetMatrices(const Matrix4x4& model, const Matrix4x4& view, const Matrix4x4& projection)
 {
-    static size_t gModelUniform = std::hash<std::string>{}("gModel");
-    static size_t gViewUniform = std::hash<std::string>{}("gView");
-    static size_t gProjUniform = std::hash<std::string>{}("gProj");
-    m_shaderProgram->SetMatrix4x4Uniform(m_shaderProgram->GetBindPoint(gModelUniform), model);
-    m_shaderProgram->SetMatrix4x4Uniform(m_shaderProgram->GetBindPoint(gViewUniform), view);
-    m_shaderProgram->SetMatrix4x4Uniform(m_shaderProgram->GetBindPoint(gProjUniform), projection);
+    static const UniformName gModelUniform("gModel");
+    static const UniformName gViewUniform("gView");
+    static const UniformName gProjUniform("gProj");
+    SetMatrix4x4Uniform(gModelUniform, model);
+    SetMatrix4x4Uniform(gViewUniform, view);
+    SetMatrix4x4Uniform(gProjUniform, projection);
 }
 
 //-----------------------------------------------------------------------------------
 void Material::BindAvailableTextures() const
 {
-    static size_t gDiffuseTextureUniform = std::hash<std::string>{}("gDiffuseTexture");
-    static size_t gNormalTextureUniform = std::hash<std::string>{}("gNormalTexture");
-    static size_t gEmissiveTextureUniform = std::hash<std::string>{}("gEmissiveTexture");
-    static size_t gNoiseTextureUniform = std::hash<std::string>{}("gNoiseTexture");
-    glActiveTexture(GL_TEXTURE0 + 0);
-    glBindTexture(GL_TEXTURE_2D, m_diffuseID);
-    glBindSampler(0, m_samplerID);
-    m_shaderProgram->SetIntUniform(m_shaderProgram->GetBindPoint(gDiffuseTextureUniform), 0);
+    //The sampler uniforms point at these units from the material's parameters, see EnsureParameterLayout.
+    RenderBackend::instance->BindTexture(0, m_diffuseID);
+    RenderBackend::instance->BindSampler(0, m_samplerID);
 
-    glActiveTexture(GL_TEXTURE0 + 1);
-    glBindTexture(GL_TEXTURE_2D, m_normalID);
-    glBindSampler(1, m_samplerID);
-    m_shaderProgram->SetIntUniform(m_shaderProgram->GetBindPoint(gNormalTextureUniform), 1);
+    RenderBackend::instance->BindTexture(1, m_normalID);
+    RenderBackend::instance->BindSampler(1, m_samplerID);
 
-    glActiveTexture(GL_TEXTURE0 + 2);
-    glBindTexture(GL_TEXTURE_2D, m_emissiveID);
-    glBindSampler(2, m_samplerID);
-    m_shaderProgram->SetIntUniform(m_shaderProgram->GetBindPoint(gEmissiveTextureUniform), 2);
+    RenderBackend::instance->BindTexture(2, m_emissiveID);
+    RenderBackend::instance->BindSampler(2, m_samplerID);
 
-    glActiveTexture(GL_TEXTURE0 + 3);
-    glBindTexture(GL_TEXTURE_2D, m_noiseID);
-    glBindSampler(3, m_samplerID);
-    m_shaderProgram->SetIntUniform(m_shaderProgram->GetBindPoint(gNoiseTextureUniform), 3);
+    RenderBackend::instance->BindTexture(3, m_noiseID);
+    RenderBackend::instance->BindSampler(3, m_samplerID);
 }
 
 //-----------------------------------------------------------------------------------
 void Material::UnbindAvailableTextures() const
 {
-    glActiveTexture(GL_TEXTURE0 + 0);
-    glBindTexture(GL_TEXTURE_2D, NULL);
-    glBindSampler(0, NULL);
+    RenderBackend::instance->BindTexture(0, NULL);
+    RenderBackend::instance->BindSampler(0, NULL);
 
-    glActiveTexture(GL_TEXTURE0 + 1);
-    glBindTexture(GL_TEXTURE_2D, NULL);
-    glBindSampler(0, NULL);
+    RenderBackend::instance->BindTexture(1, NULL);
+    RenderBackend::instance->BindSampler(0, NULL);
 
-    glActiveTexture(GL_TEXTURE0 + 2);
-    glBindTexture(GL_TEXTURE_2D, NULL);
-    glBindSampler(0, NULL);
+    RenderBackend::instance->BindTexture(2, NULL);
+    RenderBackend::instance->BindSampler(0, NULL);
 
-    glActiveTexture(GL_TEXTURE0 + 3);
-    glBindTexture(GL_TEXTURE_2D, NULL);
-    glBindSampler(0, NULL);
+    RenderBackend::instance->BindTexture(3, NULL);
+    RenderBackend::instance->BindSampler(0, NULL);
 
     //glActiveTexture(GL_TEXTURE0); Removed for redundant state changes. Might need this boy later.
 }
@@ -229,3 +221,295 @@ void Material::ReplaceSampler(unsigned int newSamplerID)
     Renderer::instance->DeleteSampler(m_samplerID);
     m_samplerID = newSamplerID;
 }
+
+
+//-----------------------------------------------------------------------------------
+void Material::BindParameters()
+{
+    if (!EnsureParameterLayout())
+    {
+        return;
+    }
+    //If nobody else touched the program since we last bound, it already holds everything we didn't change.
+    bool wasLastBound = m_shaderProgram->WasLastBoundBy(this);
+    const ShaderProgram::SlotMask& slotsToUpload = wasLastBound ? m_dirtySlots : m_setSlots;
+    if (slotsToUpload.any() || !wasLastBound)
+    {
+        m_shaderProgram->UploadParameters(this, m_parameterBlock.data(), slotsToUpload);
+    }
+    m_dirtySlots.reset();
+}
+
+//-----------------------------------------------------------------------------------
+bool Material::SetUniform(size_t hashedName, void* value)
+{
+    if (!EnsureParameterLayout())
+    {
+        return false;
+    }
+    int slot = m_shaderProgram->GetSlot(hashedName);
+    if (slot < 0)
+    {
+        return false;
+    }
+    const Uniform& uniform = m_shaderProgram->m_uniformLayout[slot];
+    if (uniform.type == Uniform::DataType::SAMPLER_2D || uniform.dataSize == 0)
+    {
+        return false;
+    }
+    SetParameter(slot, uniform.type, value, uniform.dataSize);
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+void Material::SetMatrix4x4Uniform(const UniformName& name, const Matrix4x4& value)
+{
+    if (EnsureParameterLayout())
+    {
+        SetParameter(m_shaderProgram->GetSlot(name), Uniform::DataType::MATRIX_4X4, &value, 16 * sizeof(float));
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void Material::SetVec4Uniform(const UniformName& name, const Vector4& value)
+{
+    if (EnsureParameterLayout())
+    {
+        SetParameter(m_shaderProgram->GetSlot(name), Uniform::DataType::VECTOR4, &value, 4 * sizeof(float));
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void Material::SetVec3Uniform(const UniformName& name, const Vector3& value)
+{
+    if (EnsureParameterLayout())
+    {
+        SetParameter(m_shaderProgram->GetSlot(name), Uniform::DataType::VECTOR3, &value, 3 * sizeof(float));
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void Material::SetVec2Uniform(const UniformName& name, const Vector2& value)
+{
+    if (EnsureParameterLayout())
+    {
+        SetParameter(m_shaderProgram->GetSlot(name), Uniform::DataType::VECTOR2, &value, 2 * sizeof(float));
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void Material::SetFloatUniform(const UniformName& name, float value)
+{
+    if (EnsureParameterLayout())
+    {
+        SetParameter(m_shaderProgram->GetSlot(name), Uniform::DataType::FLOAT, &value, sizeof(float));
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void Material::SetIntUniform(const UniformName& name, int value)
+{
+    if (EnsureParameterLayout())
+    {
+        SetParameter(m_shaderProgram->GetSlot(name), Uniform::DataType::INT, &value, sizeof(int));
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void Material::SetVec4Uniform(size_t hashedName, const Vector4& value)
+{
+    if (EnsureParameterLayout())
+    {
+        SetParameter(m_shaderProgram->GetSlot(hashedName), Uniform::DataType::VECTOR4, &value, 4 * sizeof(float));
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void Material::SetVec3Uniform(size_t hashedName, const Vector3& value)
+{
+    if (EnsureParameterLayout())
+    {
+        SetParameter(m_shaderProgram->GetSlot(hashedName), Uniform::DataType::VECTOR3, &value, 3 * sizeof(float));
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void Material::SetVec2Uniform(size_t hashedName, const Vector2& value)
+{
+    if (EnsureParameterLayout())
+    {
+        SetParameter(m_shaderProgram->GetSlot(hashedName), Uniform::DataType::VECTOR2, &value, 2 * sizeof(float));
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void Material::SetFloatUniform(size_t hashedName, float value)
+{
+    if (EnsureParameterLayout())
+    {
+        SetParameter(m_shaderProgram->GetSlot(hashedName), Uniform::DataType::FLOAT, &value, sizeof(float));
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void Material::SetIntUniform(size_t hashedName, int value)
+{
+    if (EnsureParameterLayout())
+    {
+        SetParameter(m_shaderProgram->GetSlot(hashedName), Uniform::DataType::INT, &value, sizeof(int));
+    }
+}
+
+//-----------------------------------------------------------------------------------
+bool Material::EnsureParameterLayout()
+{
+    static const UniformName gDiffuseTextureUniform("gDiffuseTexture");
+    static const UniformName gNormalTextureUniform("gNormalTexture");
+    static const UniformName gEmissiveTextureUniform("gEmissiveTexture");
+    static const UniformName gNoiseTextureUniform("gNoiseTexture");
+
+    if (!m_shaderProgram)
+    {
+        return false;
+    }
+    if (m_parameterLayout == m_shaderProgram)
+    {
+        return true;
+    }
+    m_parameterLayout = m_shaderProgram;
+    m_parameterBlock.assign(m_shaderProgram->m_parameterBlockSize, 0);
+    m_setSlots.reset();
+    m_dirtySlots.reset();
+    SetIntUniform(gDiffuseTextureUniform, 0);
+    SetIntUniform(gNormalTextureUniform, 1);
+    SetIntUniform(gEmissiveTextureUniform, 2);
+    SetIntUniform(gNoiseTextureUniform, 3);
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+void Material::SetParameter(int slot, Uniform::DataType type, const void* value, unsigned int size)
+{
+    if (slot < 0)
+    {
+        return;
+    }
+    const Uniform& uniform = m_shaderProgram->m_uniformLayout[slot];
+    bool isMatchingType = uniform.type == type || (uniform.type == Uniform::DataType::SAMPLER_2D && type == Uniform::DataType::INT);
+    if (!isMatchingType || uniform.dataSize != size)
+    {
+        return;
+    }
+    unsigned char* parameter = &m_parameterBlock[uniform.dataOffset];
+    if (m_setSlots.test(slot) && memcmp(parameter, value, size) == 0)
+    {
+        return;
+    }
+    memcpy(parameter, value, size);
+    m_setSlots.set(slot);
+    m_dirtySlots.set(slot);
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(materialbindbench)
+{
+    int numDraws = args.HasArgs(1) ? args.GetIntArgument(0) : 20000;
+    const int NUM_MATERIALS = 8;
+    const int DRAWS_PER_MATERIAL = 16; //Roughly what a sorted draw list hands us before the material changes
+    const char* VERTEX_SHADER = "#version 410 core\n"
+        "uniform mat4 gModel; uniform mat4 gView; uniform mat4 gProj; uniform float gTime; uniform float gWave; uniform vec2 gOffset;\n"
+        "in vec3 inPosition; void main() { gl_Position = vec4(inPosition + vec3(gOffset, gWave * gTime), 1) * (gModel * gView * gProj); }";
+    const char* FRAGMENT_SHADER = "#version 410 core\n"
+        "uniform sampler2D gDiffuseTexture; uniform sampler2D gNormalTexture; uniform sampler2D gEmissiveTexture; uniform sampler2D gNoiseTexture;\n"
+        "uniform vec4 gColor; uniform vec4 gTint; uniform vec3 gLightDirection; out vec4 outColor;\n"
+        "void main() { outColor = gColor * gTint; }";
+    const int NUM_UNIFORM_NAMES = 13;
+    const char* UNIFORM_NAMES[NUM_UNIFORM_NAMES] = { "gModel", "gView", "gProj", "gTime", "gWave", "gOffset", "gColor", "gTint", "gLightDirection", "gDiffuseTexture", "gNormalTexture", "gEmissiveTexture", "gNoiseTexture" };
+    static const UniformName gTimeUniform("gTime");
+    static const UniformName gWaveUniform("gWave");
+    static const UniformName gOffsetUniform("gOffset");
+    static const UniformName gColorUniform("gColor");
+    static const UniformName gTintUniform("gTint");
+    static const UniformName gLightDirectionUniform("gLightDirection");
+
+    //Measured against a headless recorder, so only the engine's side of binding is timed.
+    RecordingRenderBackend* recorder = new RecordingRenderBackend();
+    RenderBackend* previousBackend = Renderer::instance->BeginBackendOverride(recorder);
+
+    ShaderProgram* program = ShaderProgram::CreateFromShaderStrings(VERTEX_SHADER, FRAGMENT_SHADER);
+    std::vector<Material*> materials;
+    for (int i = 0; i < NUM_MATERIALS; ++i)
+    {
+        Material* material = new Material(program, RenderState());
+        material->SetFloatUniform(gWaveUniform, 0.5f * i);
+        material->SetVec2Uniform(gOffsetUniform, Vector2((float)i, 0.0f));
+        material->SetVec4Uniform(gColorUniform, Vector4(1.0f, 1.0f / (i + 1), 0.5f, 1.0f));
+        material->SetVec3Uniform(gLightDirectionUniform, Vector3(0.0f, -1.0f, 0.0f));
+        materials.push_back(material);
+    }
+    size_t uniformHashes[NUM_UNIFORM_NAMES];
+    for (int i = 0; i < NUM_UNIFORM_NAMES; ++i)
+    {
+        uniformHashes[i] = std::hash<std::string>{}(UNIFORM_NAMES[i]);
+    }
+    Matrix4x4 view = Matrix4x4::IDENTITY;
+    Matrix4x4 projection = Matrix4x4::IDENTITY;
+    Vector4 tint(1.0f, 1.0f, 1.0f, 1.0f);
+    float time = 1.0f;
+
+    //Before: every draw re-resolves and re-sends every uniform on the shared program.
+    recorder->ResetStatistics();
+    double startSeconds = GetCurrentTimeSeconds();
+    for (int draw = 0; draw < numDraws; ++draw)
+    {
+        int materialIndex = (draw / DRAWS_PER_MATERIAL) % NUM_MATERIALS;
+        Matrix4x4 model = Matrix4x4::IDENTITY;
+        model.SetTranslation(Vector3((float)draw, 0.0f, 0.0f));
+        program->SetMatrix4x4Uniform(program->GetBindPoint(uniformHashes[0]), model);
+        program->SetMatrix4x4Uniform(program->GetBindPoint(uniformHashes[1]), view);
+        program->SetMatrix4x4Uniform(program->GetBindPoint(uniformHashes[2]), projection);
+        program->SetFloatUniform(program->GetBindPoint(uniformHashes[3]), time);
+        program->SetFloatUniform(program->GetBindPoint(uniformHashes[4]), 0.5f * materialIndex);
+        program->SetVec2Uniform(program->GetBindPoint(uniformHashes[5]), Vector2((float)materialIndex, 0.0f));
+        program->SetVec4Uniform(program->GetBindPoint(uniformHashes[6]), Vector4(1.0f, 1.0f / (materialIndex + 1), 0.5f, 1.0f));
+        program->SetVec4Uniform(program->GetBindPoint(uniformHashes[7]), tint);
+        program->SetVec3Uniform(program->GetBindPoint(uniformHashes[8]), Vector3(0.0f, -1.0f, 0.0f));
+        for (int unit = 0; unit < 4; ++unit)
+        {
+            program->SetIntUniform(program->GetBindPoint(uniformHashes[9 + unit]), unit);
+        }
+        materials[materialIndex]->SetUpRenderState();
+    }
+    double hashedSeconds = GetCurrentTimeSeconds() - startSeconds;
+    RecordingRenderBackend::Statistics hashedStatistics = recorder->GetStatistics();
+
+    //After: values live in the materials and only the slots the program doesn't already hold are sent.
+    recorder->ResetStatistics();
+    startSeconds = GetCurrentTimeSeconds();
+    for (int draw = 0; draw < numDraws; ++draw)
+    {
+        Material* material = materials[(draw / DRAWS_PER_MATERIAL) % NUM_MATERIALS];
+        Matrix4x4 model = Matrix4x4::IDENTITY;
+        model.SetTranslation(Vector3((float)draw, 0.0f, 0.0f));
+        material->SetMatrices(model, view, projection);
+        material->SetFloatUniform(gTimeUniform, time);
+        material->SetVec4Uniform(gTintUniform, tint);
+        material->SetUpRenderState();
+        material->BindParameters();
+    }
+    double slottedSeconds = GetCurrentTimeSeconds() - startSeconds;
+    RecordingRenderBackend::Statistics slottedStatistics = recorder->GetStatistics();
+
+    double drawsDivisor = numDraws > 0 ? (double)numDraws : 1.0;
+    Console::instance->PrintLine(Stringf("%i binds across %i materials sharing one program with %u uniforms", numDraws, NUM_MATERIALS, program->m_uniformLayout.size()), RGBA::GBWHITE);
+    Console::instance->PrintLine(Stringf("Hashed, every uniform: %.0f binds/sec, %.2f uniform sets per bind (%.2f redundant)", numDraws / Max(hashedSeconds, 0.000001), hashedStatistics.m_numUniformSets / drawsDivisor, hashedStatistics.m_numRedundantUniformSets / drawsDivisor), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("Slotted, changed only: %.0f binds/sec, %.2f uniform sets per bind (%.2f redundant)", numDraws / Max(slottedSeconds, 0.000001), slottedStatistics.m_numUniformSets / drawsDivisor, slottedStatistics.m_numRedundantUniformSets / drawsDivisor), RGBA::CORNFLOWER_BLUE);
+
+    for (Material* material : materials)
+    {
+        delete material;
+    }
+    delete program;
+    Renderer::instance->EndBackendOverride(previousBackend);
+    delete recorder;
+}
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 #include <string>
+#include <vector>
+#include <stdint.h>
 #include "Engine/Renderer/ShaderProgram.hpp"
 
 class Matrix4x4;
@@ -73,19 +75,27 @@ public:
     void SetUpRenderState() const;
     void CleanUpRenderState() const;
     void ReplaceSampler(unsigned int newSamplerID);
-    //NOTE: for the array passings, you have to address the uniform like this "gArray[CurrentIndex]:"
-    inline bool SetUniform(size_t hashedName, void* value) { m_shaderProgram->SetUniform(hashedName, value); };
-    inline void SetVec4Uniform(size_t hashedName, const Vector4& value) { m_shaderProgram->SetVec4Uniform(m_shaderProgram->GetBindPoint(hashedName), value); };
-    inline void SetVec3Uniform(size_t hashedName, const Vector3& value) { m_shaderProgram->SetVec3Uniform(m_shaderProgram->GetBindPoint(hashedName), value); };
-    inline void SetVec2Uniform(size_t hashedName, const Vector2& value) { m_shaderProgram->SetVec2Uniform(m_shaderProgram->GetBindPoint(hashedName), value); };
-    inline void SetFloatUniform(size_t hashedName, float value) { m_shaderProgram->SetFloatUniform(m_shaderProgram->GetBindPoint(hashedName), value); };
-    inline void SetIntUniform(size_t hashedName, int value) { m_shaderProgram->SetIntUniform(m_shaderProgram->GetBindPoint(hashedName), value); };
-    //Slower variants of the above that constantly look up the indexes.
-    inline void SetVec4Uniform(const char* name, const Vector4& value) { m_shaderProgram->SetVec4Uniform(name, value); };
-    inline void SetVec3Uniform(const char* name, const Vector3& value) { m_shaderProgram->SetVec3Uniform(name, value); };
-    inline void SetVec2Uniform(const char* name, const Vector2& value) { m_shaderProgram->SetVec2Uniform(name, value); };
-    inline void SetFloatUniform(const char* name, float value) { m_shaderProgram->SetFloatUniform(name, value); };
-    inline void SetIntUniform(const char* name, int value) { m_shaderProgram->SetIntUniform(name, value); };
+    void BindParameters(); //Uploads whatever the program doesn't already have from this material
+    //Values are kept in the material and only reach the program in BindParameters, right before a draw.
+    bool SetUniform(size_t hashedName, void* value);
+    void SetMatrix4x4Uniform(const UniformName& name, const Matrix4x4& value);
+    void SetVec4Uniform(const UniformName& name, const Vector4& value);
+    void SetVec3Uniform(const UniformName& name, const Vector3& value);
+    void SetVec2Uniform(const UniformName& name, const Vector2& value);
+    void SetFloatUniform(const UniformName& name, float value);
+    void SetIntUniform(const UniformName& name, int value);
+    //Slower variants of the above that look the name up in a map.
+    void SetVec4Uniform(size_t hashedName, const Vector4& value);
+    void SetVec3Uniform(size_t hashedName, const Vector3& value);
+    void SetVec2Uniform(size_t hashedName, const Vector2& value);
+    void SetFloatUniform(size_t hashedName, float value);
+    void SetIntUniform(size_t hashedName, int value);
+    //Slowest variants, which hash the name first.
+    inline void SetVec4Uniform(const char* name, const Vector4& value) { SetVec4Uniform(std::hash<std::string>{}(name), value); };
+    inline void SetVec3Uniform(const char* name, const Vector3& value) { SetVec3Uniform(std::hash<std::string>{}(name), value); };
+    inline void SetVec2Uniform(const char* name, const Vector2& value) { SetVec2Uniform(std::hash<std::string>{}(name), value); };
+    inline void SetFloatUniform(const char* name, float value) { SetFloatUniform(std::hash<std::string>{}(name), value); };
+    inline void SetIntUniform(const char* name, int value) { SetIntUniform(std::hash<std::string>{}(name), value); };
 
     //DO NOT USE THESE. They're not actually working. The function for an array expects multiple passed in by reference, and I'm NOT passing any more than 1.
     inline void SetMatrix4x4Uniform(const char* name, Matrix4x4& value, unsigned int arrayIndex) { m_shaderProgram->SetMatrix4x4Uniform(name, value, arrayIndex); };
@@ -95,7 +105,7 @@ public:
     inline void SetIntUniform(const char* name, int value, unsigned int arrayIndex) { m_shaderProgram->SetIntUniform(name, value, arrayIndex); };
     
     //MEMBER VARIABLES//////////////////////////////////////////////////////////////////////////
-    ShaderProgram* m_shaderProgram;
+    ShaderProgram* m_shaderProgram = nullptr;
     RenderState m_renderState;
 
     unsigned int m_samplerID;
@@ -103,4 +113,15 @@ public:
     unsigned int m_normalID = 0;
     unsigned int m_emissiveID = 0;
     unsigned int m_noiseID = 0;
+
+private:
+    //PRIVATE FUNCTIONS//////////////////////////////////////////////////////////////////////////
+    bool EnsureParameterLayout();
+    void SetParameter(int slot, Uniform::DataType type, const void* value, unsigned int size);
+
+    //MEMBER VARIABLES//////////////////////////////////////////////////////////////////////////
+    std::vector<unsigned char> m_parameterBlock; //Laid out by the program's uniform slots
+    ShaderProgram::SlotMask m_setSlots;
+    ShaderProgram::SlotMask m_dirtySlots;
+    const ShaderProgram* m_parameterLayout = nullptr;
 };
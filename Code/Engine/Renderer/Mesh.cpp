@@ -13,6 +13,7 @@
 #include <gl/GL.h>
 #include <gl/GLU.h>
 #include "Engine/Renderer/OpenGLExtensions.hpp"
+#include "Engine/Renderer/RenderBackend.hpp"
 #include "../Core/ProfilingUtils.h"
 
 //-----------------------------------------------------------------------------------
@@ -63,15 +64,16 @@ Mesh::~Mesh()
 void Mesh::RenderFromIBO(GLuint vaoID, Material* material) const
 {
     ProfilingSystem::instance->PushSample("RenderFromIBO");
-    glBindVertexArray(vaoID);
+    RenderBackend::instance->BindVertexArray(vaoID);
     GL_CHECK_ERROR();
     material->SetUpRenderState();
+    material->BindParameters();
     GL_CHECK_ERROR();
     //Draw with IBO
-    glDrawElements(Renderer::instance->GetDrawMode(m_drawMode), m_numIndices, GL_UNSIGNED_INT, (GLvoid*)0);
+    RenderBackend::instance->DrawElements(Renderer::instance->GetDrawMode(m_drawMode), m_numIndices);
     GL_CHECK_ERROR();
     //material->CleanUpRenderState();
-    glBindVertexArray(NULL);
+    RenderBackend::instance->BindVertexArray(NULL);
     GL_CHECK_ERROR();
     ProfilingSystem::instance->PopSample("RenderFromIBO");
 }
@@ -98,20 +100,20 @@ void Mesh::Update(void* vertexData, unsigned int numVertices, unsigned int sizeo
     }
     if (m_dynamicDraw == false || m_vboBufferSize < requiredVBOBufferSize)
     {
-        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, m_vbo);
         GL_CHECK_ERROR();
-        glBufferData(GL_ARRAY_BUFFER, requiredVBOBufferSize, vertexData, m_dynamicDraw ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+        RenderBackend::instance->BufferData(GL_ARRAY_BUFFER, requiredVBOBufferSize, vertexData, m_dynamicDraw ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
         GL_CHECK_ERROR();
-        glBindBuffer(GL_ARRAY_BUFFER, NULL);
+        RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, NULL);
         m_vboBufferSize = requiredVBOBufferSize;
     }
     else
     {
-        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, m_vbo);
         GL_CHECK_ERROR();
-        glBufferSubData(GL_ARRAY_BUFFER, 0, requiredVBOBufferSize, vertexData);
+        RenderBackend::instance->BufferSubData(GL_ARRAY_BUFFER, 0, requiredVBOBufferSize, vertexData);
         GL_CHECK_ERROR();
-        glBindBuffer(GL_ARRAY_BUFFER, NULL);
+        RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, NULL);
     }
 
     if (m_ibo == NULL)
@@ -122,20 +124,20 @@ void Mesh::Update(void* vertexData, unsigned int numVertices, unsigned int sizeo
     }
     if (m_dynamicDraw == false || m_iboBufferSize < requiredIBOBufferSize)
     {
-        glBindBuffer(GL_ARRAY_BUFFER, m_ibo);
+        RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, m_ibo);
         GL_CHECK_ERROR();
-        glBufferData(GL_ARRAY_BUFFER, requiredIBOBufferSize, indexData, m_dynamicDraw ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+        RenderBackend::instance->BufferData(GL_ARRAY_BUFFER, requiredIBOBufferSize, indexData, m_dynamicDraw ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
         GL_CHECK_ERROR();
-        glBindBuffer(GL_ARRAY_BUFFER, NULL);
+        RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, NULL);
         m_iboBufferSize = requiredIBOBufferSize;
     }
     else
     {
-        glBindBuffer(GL_ARRAY_BUFFER, m_ibo);
+        RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, m_ibo);
         GL_CHECK_ERROR();
-        glBufferSubData(GL_ARRAY_BUFFER, 0, requiredIBOBufferSize, indexData);
+        RenderBackend::instance->BufferSubData(GL_ARRAY_BUFFER, 0, requiredIBOBufferSize, indexData);
         GL_CHECK_ERROR();
-        glBindBuffer(GL_ARRAY_BUFFER, NULL);
+        RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, NULL);
     }
     GL_CHECK_ERROR();
 }
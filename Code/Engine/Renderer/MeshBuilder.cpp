@@ -696,6 +696,35 @@ void MeshBuilder::AddSprite(const SpriteResource* resource, const RGBA& color, M
     }
 }
 
+//-----------------------------------------------------------------------------------
+void MeshBuilder::AddSprite(const SpriteResource* resource, const RGBA& color, const Vector2& position, const Vector2& scale, float rotationDegrees)
+{
+    //Same quad as the matrix version with scale * rotation * translation, without building three matrices per sprite.
+    Vector2 pivotPoint = resource->m_pivotPoint;
+    Vector2 uvMins = resource->m_uvBounds.mins;
+    Vector2 uvMaxs = resource->m_uvBounds.maxs;
+    Vector2 spriteBounds = resource->m_virtualSize;
+    float radians = DegreesToRadians(rotationDegrees);
+    float cosine = cos(radians);
+    float sine = sin(radians);
+    float left = -pivotPoint.x * scale.x;
+    float right = (spriteBounds.x - pivotPoint.x) * scale.x;
+    float bottom = -pivotPoint.y * scale.y;
+    float top = (spriteBounds.y - pivotPoint.y) * scale.y;
+
+    int startingVertex = m_vertices.size();
+    SetColor(color);
+    SetUV(Vector2(uvMins.x, uvMaxs.y));
+    AddVertex(Vector3(left * cosine - bottom * sine + position.x, left * sine + bottom * cosine + position.y, 0.0f));
+    SetUV(uvMaxs);
+    AddVertex(Vector3(right * cosine - bottom * sine + position.x, right * sine + bottom * cosine + position.y, 0.0f));
+    SetUV(uvMins);
+    AddVertex(Vector3(left * cosine - top * sine + position.x, left * sine + top * cosine + position.y, 0.0f));
+    SetUV(Vector2(uvMaxs.x, uvMins.y));
+    AddVertex(Vector3(right * cosine - top * sine + position.x, right * sine + top * cosine + position.y, 0.0f));
+    AddQuadIndices(startingVertex + 1, startingVertex + 0, startingVertex + 3, startingVertex + 2);
+}
+
 //-----------------------------------------------------------------------------------
 void MeshBuilder::AddTexturedAABB(const AABB2& bounds, const Vector2& uvMins, const Vector2& uvMaxs, const RGBA& color)
 {
@@ -723,37 +752,26 @@ void MeshBuilder::AddText2D(const Vector2& position, const std::string& asciiTex
     {
         font = Renderer::instance->m_defaultFont;
     }
-    int stringLength = asciiText.size();
-    Vector2 cursorPosition = position + (Vector2::UNIT_Y * (float)font->m_maxHeight * scale);
-    const Glyph* previousGlyph = nullptr;
-    for (int i = 0; i < stringLength; i++)
-    {
-        unsigned char currentCharacter = asciiText[i];
-        const Glyph* glyph = font->GetGlyph(currentCharacter);
-        float glyphWidth = static_cast<float>(glyph->width) * scale;
-        float glyphHeight = static_cast<float>(glyph->height) * scale;
+    AddTextLayout(position, font->GetLayout(asciiText, scale), tint, drawShadow);
+}
 
-        if (previousGlyph)
-        {
-            const Vector2 kerning = font->GetKerning(*previousGlyph, *glyph);
-            cursorPosition += (kerning * scale);
-        }
-        Vector2 offset = Vector2(glyph->xOffset * scale, -glyph->yOffset * scale);
-        Vector2 topRight = cursorPosition + offset + Vector2(glyphWidth, 0.0f);
-        Vector2 bottomLeft = cursorPosition + offset - Vector2(0.0f, glyphHeight);
-        AABB2 quadBounds = AABB2(bottomLeft, topRight);
-        AABB2 glyphBounds = font->GetTexCoordsForGlyph(*glyph);
+//-----------------------------------------------------------------------------------
+void MeshBuilder::AddTextLayout(const Vector2& position, const TextLayout& layout, const RGBA& tint /*= RGBA::WHITE*/, bool drawShadow /*= false*/)
+{
+    unsigned int numQuads = layout.glyphs.size() * (drawShadow ? 2 : 1);
+    m_vertices.reserve(m_vertices.size() + (numQuads * 4));
+    m_indices.reserve(m_indices.size() + (numQuads * 6));
+    for (const ShapedGlyph& glyph : layout.glyphs)
+    {
+        AABB2 quadBounds = glyph.quadBounds + position;
         if (drawShadow)
         {
-            float shadowWidthOffset = glyphWidth / 10.0f;
-            float shadowHeightOffset = glyphHeight / -10.0f;
-            Vector2 shadowOffset = Vector2(shadowWidthOffset, shadowHeightOffset);
-            AABB2 shadowBounds = AABB2(bottomLeft + shadowOffset, topRight + shadowOffset);
-            this->AddTexturedAABB(shadowBounds, glyphBounds.mins, glyphBounds.maxs, RGBA::BLACK);
+            float shadowWidthOffset = quadBounds.GetWidth() / 10.0f;
+            float shadowHeightOffset = quadBounds.GetHeight() / -10.0f;
+            AABB2 shadowBounds = quadBounds + Vector2(shadowWidthOffset, shadowHeightOffset);
+            this->AddTexturedAABB(shadowBounds, glyph.texCoords.mins, glyph.texCoords.maxs, RGBA::BLACK);
         }
-        this->AddTexturedAABB(quadBounds, glyphBounds.mins, glyphBounds.maxs, tint);
-        cursorPosition.x += glyph->xAdvance * scale;
-        previousGlyph = glyph;
+        this->AddTexturedAABB(quadBounds, glyph.texCoords.mins, glyph.texCoords.maxs, tint);
     }
 }
 
@@ -12,6 +12,7 @@ class AABB2;
 class Matrix4x4;
 class Sprite;
 class SpriteResource;
+struct TextLayout;
 
 class MeshBuilder
 {
@@ -69,6 +70,7 @@ public:
     void AddQuadIndices();
     void AddTexturedAABB(const AABB2& bounds, const Vector2& uvMins, const Vector2& uvMaxs, const RGBA& color);
     void AddText2D(const Vector2& position, const std::string& asciiText, float scale, const RGBA& tint = RGBA::WHITE, bool drawShadow = false, const BitmapFont* font = nullptr);
+    void AddTextLayout(const Vector2& position, const TextLayout& layout, const RGBA& tint = RGBA::WHITE, bool drawShadow = false);
     void AddGlyph(const Vector3& bottomLeft, const Vector3& up, const Vector3& right, float upExtents, float rightExtents, const Vector2& uvMins, const Vector2& uvMaxs, const RGBA& color,
         float stringCoordXMin, float stringCoordXMax, float fragCoordXMin, float fragCoordXMax);
     void AddStringEffectFragment(const std::string& asciiText, const BitmapFont* font, float scale, float totalStringWidth, float totalWidthUpToNow,
@@ -138,6 +140,7 @@ public:
     void RenormalizeSkinWeights();
     bool IsEmpty();
     void AddSprite(const SpriteResource* resource, const RGBA& color, Matrix4x4* transform = nullptr);
+    void AddSprite(const SpriteResource* resource, const RGBA& color, const Vector2& position, const Vector2& scale, float rotationDegrees);
 
     //MEMBER VARIABLES//////////////////////////////////////////////////////////////////////////
     std::vector<Vertex_Master> m_vertices;
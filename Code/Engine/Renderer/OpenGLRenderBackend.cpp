@@ -0,0 +1,492 @@
+#include "Engine/Renderer/OpenGLRenderBackend.hpp"
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <gl/GL.h>
+#include <gl/GLU.h>
+#include "Engine/Renderer/OpenGLExtensions.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+
+//-----------------------------------------------------------------------------------
+OpenGLRenderBackend::OpenGLRenderBackend()
+{
+    HookUpOpenGLPointers();
+}
+
+//-----------------------------------------------------------------------------------
+OpenGLRenderBackend::~OpenGLRenderBackend()
+{
+
+}
+
+//-----------------------------------------------------------------------------------
+RenderBackend::GLuint OpenGLRenderBackend::CreateBuffer()
+{
+    GLuint buffer = 0;
+    glGenBuffers(1, &buffer);
+    return buffer;
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::DeleteBuffer(GLuint buffer)
+{
+    glDeleteBuffers(1, &buffer);
+}
+
+//-----------------------------------------------------------------------------------
+RenderBackend::GLuint OpenGLRenderBackend::CreateVertexArray()
+{
+    GLuint vertexArray = 0;
+    glGenVertexArrays(1, &vertexArray);
+    return vertexArray;
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::DeleteVertexArray(GLuint vertexArray)
+{
+    glDeleteVertexArrays(1, &vertexArray);
+}
+
+//-----------------------------------------------------------------------------------
+RenderBackend::GLuint OpenGLRenderBackend::CreateSampler(GLenum minFilter, GLenum magFilter, GLenum uWrap, GLenum vWrap)
+{
+    GLuint sampler = 0;
+    glGenSamplers(1, &sampler);
+    glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, minFilter);
+    glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, magFilter);
+    glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, uWrap); //For some reason, OpenGL refers to UV's as ST's
+    glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, vWrap);
+    return sampler;
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::DeleteSampler(GLuint sampler)
+{
+    glDeleteSamplers(1, &sampler);
+}
+
+//-----------------------------------------------------------------------------------
+RenderBackend::GLuint OpenGLRenderBackend::CreateTexture2D(GLsizei width, GLsizei height, GLenum internalFormat, GLenum format, GLenum type, const void* data)
+{
+    GLuint texture = 0;
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); //Our pixel data is single-byte aligned
+    glGenTextures(1, &texture);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, data);
+    glBindTexture(GL_TEXTURE_2D, NULL);
+    return texture;
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::UpdateTexture2D(GLuint texture, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* data)
+{
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, format, type, data);
+    glBindTexture(GL_TEXTURE_2D, NULL);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::DeleteTexture(GLuint texture)
+{
+    glDeleteTextures(1, &texture);
+}
+
+//-----------------------------------------------------------------------------------
+RenderBackend::GLuint OpenGLRenderBackend::CreateFramebuffer()
+{
+    GLuint framebuffer = 0;
+    glGenFramebuffers(1, &framebuffer);
+    return framebuffer;
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::DeleteFramebuffer(GLuint framebuffer)
+{
+    glDeleteFramebuffers(1, &framebuffer);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::FramebufferTexture(GLenum target, GLenum attachment, GLuint texture)
+{
+    glFramebufferTexture(target, attachment, texture, 0);
+}
+
+//-----------------------------------------------------------------------------------
+RenderBackend::GLenum OpenGLRenderBackend::CheckFramebufferStatus(GLenum target)
+{
+    return glCheckFramebufferStatus(target);
+}
+
+//-----------------------------------------------------------------------------------
+RenderBackend::GLuint OpenGLRenderBackend::CreateShader(GLenum shaderType)
+{
+    return glCreateShader(shaderType);
+}
+
+//-----------------------------------------------------------------------------------
+bool OpenGLRenderBackend::CompileShader(GLuint shader, const char* source, std::string& out_errorLog)
+{
+    GLint sourceLength = strlen(source);
+    glShaderSource(shader, 1, &source, &sourceLength);
+    glCompileShader(shader);
+
+    GLint status;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if (GL_FALSE == status)
+    {
+        GLint logLength;
+        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLength);
+        char* buffer = new char[logLength + 1];
+        glGetShaderInfoLog(shader, logLength, &logLength, buffer);
+        buffer[logLength] = '\0';
+        out_errorLog = buffer;
+        delete[] buffer;
+        return false;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::DeleteShader(GLuint shader)
+{
+    glDeleteShader(shader);
+}
+
+//-----------------------------------------------------------------------------------
+RenderBackend::GLuint OpenGLRenderBackend::CreateProgram()
+{
+    return glCreateProgram();
+}
+
+//-----------------------------------------------------------------------------------
+bool OpenGLRenderBackend::LinkProgram(GLuint program, GLuint vertexShader, GLuint fragmentShader, std::string& out_errorLog)
+{
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    glLinkProgram(program);
+
+    GLint status;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (GL_FALSE == status)
+    {
+        GLint logLength;
+        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &logLength);
+        char* buffer = new char[logLength + 1];
+        glGetProgramInfoLog(program, logLength, &logLength, buffer);
+        buffer[logLength] = '\0';
+        out_errorLog = buffer;
+        delete[] buffer;
+        return false;
+    }
+
+    //Success! Let OpenGL clean up video memory for the shaders
+    glDetachShader(program, vertexShader);
+    glDetachShader(program, fragmentShader);
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::DeleteProgram(GLuint program)
+{
+    glDeleteProgram(program);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::GetActiveAttributes(GLuint program, std::vector<ShaderVariable>& out_attributes)
+{
+    GLint numberOfActiveAttributes;
+    glGetProgramiv(program, GL_ACTIVE_ATTRIBUTES, &numberOfActiveAttributes);
+    GLint maxNameLength;
+    glGetProgramiv(program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxNameLength);
+    char* nameBuffer = new char[maxNameLength + 1];
+    for (int index = 0; index < numberOfActiveAttributes; ++index)
+    {
+        GLint size;
+        GLenum type;
+        glGetActiveAttrib(program, index, maxNameLength, NULL, &size, &type, nameBuffer);
+
+        ShaderVariable attribute;
+        attribute.name = nameBuffer;
+        attribute.type = Uniform::DataType::NUM_TYPES; //Attribute types aren't needed, vertex formats describe themselves
+        attribute.size = size;
+        attribute.location = glGetAttribLocation(program, nameBuffer);
+        out_attributes.push_back(attribute);
+    }
+    delete[] nameBuffer;
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::GetActiveUniforms(GLuint program, std::vector<ShaderVariable>& out_uniforms)
+{
+    GLint numberOfActiveUniforms;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &numberOfActiveUniforms);
+    GLint maxNameLength;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+    char* nameBuffer = new char[maxNameLength + 1];
+    for (int index = 0; index < numberOfActiveUniforms; ++index)
+    {
+        GLint size;
+        GLenum type;
+        glGetActiveUniform(program, index, maxNameLength, NULL, &size, &type, nameBuffer);
+
+        ShaderVariable uniform;
+        uniform.name = nameBuffer;
+        uniform.size = size;
+        uniform.location = glGetUniformLocation(program, nameBuffer);
+        switch (type)
+        {
+        case GL_SAMPLER_2D:
+            uniform.type = Uniform::DataType::SAMPLER_2D;
+            break;
+        case GL_FLOAT_MAT4:
+            uniform.type = Uniform::DataType::MATRIX_4X4;
+            break;
+        case GL_FLOAT_VEC4:
+            uniform.type = Uniform::DataType::VECTOR4;
+            break;
+        case GL_FLOAT_VEC3:
+            uniform.type = Uniform::DataType::VECTOR3;
+            break;
+        case GL_FLOAT_VEC2:
+            uniform.type = Uniform::DataType::VECTOR2;
+            break;
+        case GL_FLOAT:
+            uniform.type = Uniform::DataType::FLOAT;
+            break;
+        case GL_INT:
+            uniform.type = Uniform::DataType::INT;
+            break;
+        default:
+            ERROR_RECOVERABLE(Stringf("0x%x was given as a uniform type, but it wasn't found (add support for it as a uniform data type!)", type));
+            uniform.type = Uniform::DataType::NUM_TYPES;
+            break;
+        }
+        out_uniforms.push_back(uniform);
+    }
+    delete[] nameBuffer;
+}
+
+//-----------------------------------------------------------------------------------
+RenderBackend::GLint OpenGLRenderBackend::GetUniformLocation(GLuint program, const char* name)
+{
+    return glGetUniformLocation(program, name);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::BindUniformBlock(GLuint program, const char* blockName, GLuint bindPoint)
+{
+    GLuint blockIndex = glGetUniformBlockIndex(program, blockName);
+    glUniformBlockBinding(program, blockIndex, bindPoint);
+}
+
+//-----------------------------------------------------------------------------------
+std::string OpenGLRenderBackend::GetVersionString()
+{
+    const char* glVersion = (const char*)glGetString(GL_VERSION);
+    const char* glslVersion = (const char*)glGetString(GL_SHADING_LANGUAGE_VERSION);
+    return Stringf("OpenGL version: %s\nGLSL version: %s", glVersion, glslVersion);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::SetCapability(GLenum capability, bool isEnabled)
+{
+    isEnabled ? glEnable(capability) : glDisable(capability);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::SetBlendFunction(GLenum sourceFactor, GLenum destinationFactor)
+{
+    glBlendFunc(sourceFactor, destinationFactor);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::SetDepthMask(bool isWriteEnabled)
+{
+    glDepthMask(isWriteEnabled);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::SetViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    glViewport(x, y, width, height);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::SetPointSize(float size)
+{
+    glPointSize(size);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::UseProgram(GLuint program)
+{
+    glUseProgram(program);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::BindVertexArray(GLuint vertexArray)
+{
+    glBindVertexArray(vertexArray);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::BindBuffer(GLenum target, GLuint buffer)
+{
+    glBindBuffer(target, buffer);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::BindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+    glBindBufferBase(target, index, buffer);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::BindTexture(GLuint textureUnit, GLuint texture)
+{
+    glActiveTexture(GL_TEXTURE0 + textureUnit);
+    glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::BindSampler(GLuint textureUnit, GLuint sampler)
+{
+    glBindSampler(textureUnit, sampler);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::BindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    glBindFramebuffer(target, framebuffer);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::SetDrawBuffers(GLsizei count, const GLenum* buffers)
+{
+    glDrawBuffers(count, buffers);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::SetVertexAttribute(GLuint location, GLint count, GLenum type, bool normalize, GLsizei stride, size_t offset)
+{
+    glEnableVertexAttribArray(location);
+    glVertexAttribPointer(location, count, type, normalize, stride, (GLvoid*)offset);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::SetIntegerVertexAttribute(GLuint location, GLint count, GLenum type, GLsizei stride, size_t offset)
+{
+    glEnableVertexAttribArray(location);
+    glVertexAttribIPointer(location, count, type, stride, (GLvoid*)offset);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::SetUniform(GLint location, Uniform::DataType type, GLsizei count, const void* data)
+{
+    switch (type)
+    {
+    case Uniform::DataType::MATRIX_4X4:
+        glUniformMatrix4fv(location, count, GL_FALSE, (const GLfloat*)data); //location, number of elements, do you want gl to transpose matrix?, matrix
+        break;
+    case Uniform::DataType::VECTOR4:
+        glUniform4fv(location, count, (const GLfloat*)data);
+        break;
+    case Uniform::DataType::VECTOR3:
+        glUniform3fv(location, count, (const GLfloat*)data);
+        break;
+    case Uniform::DataType::VECTOR2:
+        glUniform2fv(location, count, (const GLfloat*)data);
+        break;
+    case Uniform::DataType::FLOAT:
+        glUniform1fv(location, count, (const GLfloat*)data);
+        break;
+    case Uniform::DataType::SAMPLER_2D:
+    case Uniform::DataType::INT:
+        glUniform1iv(location, count, (const GLint*)data);
+        break;
+    default:
+        ERROR_RECOVERABLE("Tried to set a uniform of an unsupported type");
+        break;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+RenderBackend::GLint OpenGLRenderBackend::GetMaxUniformBufferBindings()
+{
+    GLint maxBindPoint;
+    glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &maxBindPoint);
+    return maxBindPoint;
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::BufferData(GLenum target, size_t size, const void* data, GLenum usage)
+{
+    glBufferData(target, size, data, usage);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::BufferSubData(GLenum target, size_t offset, size_t size, const void* data)
+{
+    glBufferSubData(target, offset, size, data);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::SetClearColor(float red, float green, float blue, float alpha)
+{
+    glClearColor(red, green, blue, alpha);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::SetClearDepth(float depth)
+{
+    glClearDepth(depth);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::Clear(GLbitfield mask)
+{
+    glClear(mask);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::ClearColorBuffer(GLint drawBuffer, const float* color)
+{
+    glClearBufferfv(GL_COLOR, drawBuffer, color);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::DrawElements(GLenum drawMode, GLsizei numIndices)
+{
+    glDrawElements(drawMode, numIndices, GL_UNSIGNED_INT, (GLvoid*)0);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::DrawArrays(GLenum drawMode, GLint firstVertex, GLsizei numVertices)
+{
+    glDrawArrays(drawMode, firstVertex, numVertices);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::BlitFramebuffer(GLint sourceX0, GLint sourceY0, GLint sourceX1, GLint sourceY1, GLint destinationX0, GLint destinationY0, GLint destinationX1, GLint destinationY1, GLbitfield mask, GLenum filter)
+{
+    glBlitFramebuffer(sourceX0, sourceY0, sourceX1, sourceY1, destinationX0, destinationY0, destinationX1, destinationY1, mask, filter);
+}
+
+//-----------------------------------------------------------------------------------
+void OpenGLRenderBackend::Finish()
+{
+    glFinish();
+}
+
+//-----------------------------------------------------------------------------------
+RenderBackend::GLenum OpenGLRenderBackend::GetError()
+{
+    return glGetError();
+}
\ No newline at end of file
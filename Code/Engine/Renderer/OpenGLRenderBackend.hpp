@@ -0,0 +1,71 @@
+#pragma once
+#include "Engine/Renderer/RenderBackend.hpp"
+
+//-----------------------------------------------------------------------------------
+class OpenGLRenderBackend : public RenderBackend
+{
+public:
+    //CONSTRUCTORS//////////////////////////////////////////////////////////////////////////
+    OpenGLRenderBackend();
+    virtual ~OpenGLRenderBackend();
+
+    //RESOURCES//////////////////////////////////////////////////////////////////////////
+    virtual GLuint CreateBuffer() override;
+    virtual void DeleteBuffer(GLuint buffer) override;
+    virtual GLuint CreateVertexArray() override;
+    virtual void DeleteVertexArray(GLuint vertexArray) override;
+    virtual GLuint CreateSampler(GLenum minFilter, GLenum magFilter, GLenum uWrap, GLenum vWrap) override;
+    virtual void DeleteSampler(GLuint sampler) override;
+    virtual GLuint CreateTexture2D(GLsizei width, GLsizei height, GLenum internalFormat, GLenum format, GLenum type, const void* data) override;
+    virtual void UpdateTexture2D(GLuint texture, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* data) override;
+    virtual void DeleteTexture(GLuint texture) override;
+    virtual GLuint CreateFramebuffer() override;
+    virtual void DeleteFramebuffer(GLuint framebuffer) override;
+    virtual void FramebufferTexture(GLenum target, GLenum attachment, GLuint texture) override;
+    virtual GLenum CheckFramebufferStatus(GLenum target) override;
+
+    //SHADERS//////////////////////////////////////////////////////////////////////////
+    virtual GLuint CreateShader(GLenum shaderType) override;
+    virtual bool CompileShader(GLuint shader, const char* source, std::string& out_errorLog) override;
+    virtual void DeleteShader(GLuint shader) override;
+    virtual GLuint CreateProgram() override;
+    virtual bool LinkProgram(GLuint program, GLuint vertexShader, GLuint fragmentShader, std::string& out_errorLog) override;
+    virtual void DeleteProgram(GLuint program) override;
+    virtual void GetActiveAttributes(GLuint program, std::vector<ShaderVariable>& out_attributes) override;
+    virtual void GetActiveUniforms(GLuint program, std::vector<ShaderVariable>& out_uniforms) override;
+    virtual GLint GetUniformLocation(GLuint program, const char* name) override;
+    virtual void BindUniformBlock(GLuint program, const char* blockName, GLuint bindPoint) override;
+    virtual std::string GetVersionString() override;
+
+    //STATE//////////////////////////////////////////////////////////////////////////
+    virtual void SetCapability(GLenum capability, bool isEnabled) override;
+    virtual void SetBlendFunction(GLenum sourceFactor, GLenum destinationFactor) override;
+    virtual void SetDepthMask(bool isWriteEnabled) override;
+    virtual void SetViewport(GLint x, GLint y, GLsizei width, GLsizei height) override;
+    virtual void SetPointSize(float size) override;
+    virtual void UseProgram(GLuint program) override;
+    virtual void BindVertexArray(GLuint vertexArray) override;
+    virtual void BindBuffer(GLenum target, GLuint buffer) override;
+    virtual void BindBufferBase(GLenum target, GLuint index, GLuint buffer) override;
+    virtual void BindTexture(GLuint textureUnit, GLuint texture) override;
+    virtual void BindSampler(GLuint textureUnit, GLuint sampler) override;
+    virtual void BindFramebuffer(GLenum target, GLuint framebuffer) override;
+    virtual void SetDrawBuffers(GLsizei count, const GLenum* buffers) override;
+    virtual void SetVertexAttribute(GLuint location, GLint count, GLenum type, bool normalize, GLsizei stride, size_t offset) override;
+    virtual void SetIntegerVertexAttribute(GLuint location, GLint count, GLenum type, GLsizei stride, size_t offset) override;
+    virtual void SetUniform(GLint location, Uniform::DataType type, GLsizei count, const void* data) override;
+    virtual GLint GetMaxUniformBufferBindings() override;
+
+    //COMMANDS//////////////////////////////////////////////////////////////////////////
+    virtual void BufferData(GLenum target, size_t size, const void* data, GLenum usage) override;
+    virtual void BufferSubData(GLenum target, size_t offset, size_t size, const void* data) override;
+    virtual void SetClearColor(float red, float green, float blue, float alpha) override;
+    virtual void SetClearDepth(float depth) override;
+    virtual void Clear(GLbitfield mask) override;
+    virtual void ClearColorBuffer(GLint drawBuffer, const float* color) override;
+    virtual void DrawElements(GLenum drawMode, GLsizei numIndices) override;
+    virtual void DrawArrays(GLenum drawMode, GLint firstVertex, GLsizei numVertices) override;
+    virtual void BlitFramebuffer(GLint sourceX0, GLint sourceY0, GLint sourceX1, GLint sourceY1, GLint destinationX0, GLint destinationY0, GLint destinationX1, GLint destinationY1, GLbitfield mask, GLenum filter) override;
+    virtual void Finish() override;
+    virtual GLenum GetError() override;
+};
\ No newline at end of file
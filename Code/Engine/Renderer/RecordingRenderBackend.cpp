@@ -0,0 +1,928 @@
+#include "Engine/Renderer/RecordingRenderBackend.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Input/InputSystem.hpp"
+#include "Engine/Time/Time.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <string.h>
+#include <stdlib.h>
+#include <algorithm>
+
+//The handful of OpenGL values the recorder has to understand rather than just pass along.
+static const RenderBackend::GLenum FRAMEBUFFER_TARGET = 0x8D40; //GL_FRAMEBUFFER, which binds both of the ones below
+static const RenderBackend::GLenum READ_FRAMEBUFFER_TARGET = 0x8CA8;
+static const RenderBackend::GLenum DRAW_FRAMEBUFFER_TARGET = 0x8CA9;
+static const RenderBackend::GLenum FRAMEBUFFER_COMPLETE = 0x8CD5;
+static const RenderBackend::GLenum RED_FORMAT = 0x1903;
+static const RenderBackend::GLenum RGB_FORMAT = 0x1907;
+static const RenderBackend::GLint HEADLESS_MAX_UNIFORM_BUFFER_BINDINGS = 36;
+
+//-----------------------------------------------------------------------------------
+RecordingRenderBackend::RecordingRenderBackend(RenderBackend* passthrough)
+    : m_passthrough(passthrough)
+    , m_currentProgram(0)
+    , m_nextHandle(1)
+{
+    ResetStatistics();
+}
+
+//-----------------------------------------------------------------------------------
+RecordingRenderBackend::~RecordingRenderBackend()
+{
+
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::ResetStatistics()
+{
+    memset(&m_statistics, 0, sizeof(m_statistics));
+    memset(m_numCommandsByType, 0, sizeof(m_numCommandsByType));
+    memset(m_numRedundantCommandsByType, 0, sizeof(m_numRedundantCommandsByType));
+    m_commands.clear();
+}
+
+//-----------------------------------------------------------------------------------
+const char* RecordingRenderBackend::GetCommandName(CommandType type)
+{
+    switch (type)
+    {
+    case CommandType::CREATE_RESOURCE:
+        return "CreateResource";
+    case CommandType::DELETE_RESOURCE:
+        return "DeleteResource";
+    case CommandType::SET_CAPABILITY:
+        return "SetCapability";
+    case CommandType::SET_BLEND_FUNCTION:
+        return "SetBlendFunction";
+    case CommandType::SET_DEPTH_MASK:
+        return "SetDepthMask";
+    case CommandType::SET_VIEWPORT:
+        return "SetViewport";
+    case CommandType::SET_POINT_SIZE:
+        return "SetPointSize";
+    case CommandType::USE_PROGRAM:
+        return "UseProgram";
+    case CommandType::BIND_VERTEX_ARRAY:
+        return "BindVertexArray";
+    case CommandType::BIND_BUFFER:
+        return "BindBuffer";
+    case CommandType::BIND_BUFFER_BASE:
+        return "BindBufferBase";
+    case CommandType::BIND_TEXTURE:
+        return "BindTexture";
+    case CommandType::BIND_SAMPLER:
+        return "BindSampler";
+    case CommandType::BIND_FRAMEBUFFER:
+        return "BindFramebuffer";
+    case CommandType::SET_DRAW_BUFFERS:
+        return "SetDrawBuffers";
+    case CommandType::SET_VERTEX_ATTRIBUTE:
+        return "SetVertexAttribute";
+    case CommandType::SET_UNIFORM:
+        return "SetUniform";
+    case CommandType::BUFFER_DATA:
+        return "BufferData";
+    case CommandType::CLEAR:
+        return "Clear";
+    case CommandType::DRAW:
+        return "Draw";
+    case CommandType::BLIT_FRAMEBUFFER:
+        return "BlitFramebuffer";
+    default:
+        return "Unknown";
+    }
+}
+
+//-----------------------------------------------------------------------------------
+uint64_t RecordingRenderBackend::MakeStateKey(TrackedState state, uint32_t slot)
+{
+    return ((uint64_t)state << 32) | slot;
+}
+
+//-----------------------------------------------------------------------------------
+bool RecordingRenderBackend::UpdateTrackedState(TrackedState state, uint32_t slot, uint64_t value)
+{
+    auto inserted = m_trackedState.insert(std::pair<uint64_t, uint64_t>(MakeStateKey(state, slot), value));
+    if (inserted.second)
+    {
+        return false;
+    }
+    bool isRedundant = inserted.first->second == value;
+    inserted.first->second = value;
+    return isRedundant;
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::ForgetTrackedHandle(TrackedState state, uint32_t handle)
+{
+    auto iter = m_trackedState.lower_bound(MakeStateKey(state, 0));
+    auto end = m_trackedState.lower_bound(MakeStateKey((TrackedState)((uint8_t)state + 1), 0));
+    for (; iter != end; ++iter)
+    {
+        if (iter->second == handle)
+        {
+            iter->second = 0;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::Record(CommandType type, bool isRedundant, uint32_t slot, uint32_t argument0, uint32_t argument1, uint32_t argument2)
+{
+    ++m_numCommandsByType[(int)type];
+    if (isRedundant)
+    {
+        ++m_numRedundantCommandsByType[(int)type];
+    }
+
+    if (m_commands.size() >= MAX_RECORDED_COMMANDS)
+    {
+        ++m_statistics.m_numDroppedCommands;
+        return;
+    }
+    RecordedCommand command;
+    command.m_type = type;
+    command.m_isRedundant = isRedundant;
+    command.m_slot = (uint16_t)slot;
+    command.m_arguments[0] = argument0;
+    command.m_arguments[1] = argument1;
+    command.m_arguments[2] = argument2;
+    m_commands.push_back(command);
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::RecordStateChange(CommandType type, bool isRedundant, uint32_t slot, uint32_t argument0, uint32_t argument1, uint32_t argument2)
+{
+    ++m_statistics.m_numStateChanges;
+    if (isRedundant)
+    {
+        ++m_statistics.m_numRedundantStateChanges;
+    }
+    Record(type, isRedundant, slot, argument0, argument1, argument2);
+}
+
+//-----------------------------------------------------------------------------------
+RenderBackend::GLuint RecordingRenderBackend::RecordResourceCreation(GLuint handle)
+{
+    ++m_statistics.m_numResourcesCreated;
+    Record(CommandType::CREATE_RESOURCE, false, 0, handle);
+    return handle;
+}
+
+//-----------------------------------------------------------------------------------
+RenderBackend::GLuint RecordingRenderBackend::CreateBuffer()
+{
+    return RecordResourceCreation(m_passthrough ? m_passthrough->CreateBuffer() : m_nextHandle++);
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::DeleteBuffer(GLuint buffer)
+{
+    Record(CommandType::DELETE_RESOURCE, false, 0, buffer);
+    ForgetTrackedHandle(TrackedState::BUFFER, buffer);
+    ForgetTrackedHandle(TrackedState::BUFFER_BASE, buffer);
+    if (m_passthrough)
+    {
+        m_passthrough->DeleteBuffer(buffer);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+RenderBackend::GLuint RecordingRenderBackend::CreateVertexArray()
+{
+    return RecordResourceCreation(m_passthrough ? m_passthrough->CreateVertexArray() : m_nextHandle++);
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::DeleteVertexArray(GLuint vertexArray)
+{
+    Record(CommandType::DELETE_RESOURCE, false, 0, vertexArray);
+    ForgetTrackedHandle(TrackedState::VERTEX_ARRAY, vertexArray);
+    if (m_passthrough)
+    {
+        m_passthrough->DeleteVertexArray(vertexArray);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+RenderBackend::GLuint RecordingRenderBackend::CreateSampler(GLenum minFilter, GLenum magFilter, GLenum uWrap, GLenum vWrap)
+{
+    return RecordResourceCreation(m_passthrough ? m_passthrough->CreateSampler(minFilter, magFilter, uWrap, vWrap) : m_nextHandle++);
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::DeleteSampler(GLuint sampler)
+{
+    Record(CommandType::DELETE_RESOURCE, false, 0, sampler);
+    ForgetTrackedHandle(TrackedState::SAMPLER, sampler);
+    if (m_passthrough)
+    {
+        m_passthrough->DeleteSampler(sampler);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+RenderBackend::GLuint RecordingRenderBackend::CreateTexture2D(GLsizei width, GLsizei height, GLenum internalFormat, GLenum format, GLenum type, const void* data)
+{
+    //Creation goes through unit 0 and leaves it empty.
+    UpdateTrackedState(TrackedState::TEXTURE, 0, 0);
+    if (data)
+    {
+        ++m_statistics.m_numBufferUploads;
+        uint64_t bytesPerTexel = format == RED_FORMAT ? 1 : (format == RGB_FORMAT ? 3 : 4); //Everything we upload from memory is unsigned bytes
+        m_statistics.m_numBytesUploaded += (uint64_t)width * (uint64_t)height * bytesPerTexel;
+    }
+    return RecordResourceCreation(m_passthrough ? m_passthrough->CreateTexture2D(width, height, internalFormat, format, type, data) : m_nextHandle++);
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::UpdateTexture2D(GLuint texture, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* data)
+{
+    //Like creation, this goes through unit 0 and leaves it empty.
+    UpdateTrackedState(TrackedState::TEXTURE, 0, 0);
+    uint64_t bytesPerTexel = format == RED_FORMAT ? 1 : (format == RGB_FORMAT ? 3 : 4);
+    uint64_t numBytes = (uint64_t)width * (uint64_t)height * bytesPerTexel;
+    ++m_statistics.m_numBufferUploads;
+    m_statistics.m_numBytesUploaded += numBytes;
+    Record(CommandType::BUFFER_DATA, false, 0, texture, ((uint32_t)x << 16) | ((uint32_t)y & 0xFFFF), (uint32_t)numBytes);
+    if (m_passthrough)
+    {
+        m_passthrough->UpdateTexture2D(texture, x, y, width, height, format, type, data);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::DeleteTexture(GLuint texture)
+{
+    Record(CommandType::DELETE_RESOURCE, false, 0, texture);
+    ForgetTrackedHandle(TrackedState::TEXTURE, texture);
+    if (m_passthrough)
+    {
+        m_passthrough->DeleteTexture(texture);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+RenderBackend::GLuint RecordingRenderBackend::CreateFramebuffer()
+{
+    return RecordResourceCreation(m_passthrough ? m_passthrough->CreateFramebuffer() : m_nextHandle++);
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::DeleteFramebuffer(GLuint framebuffer)
+{
+    Record(CommandType::DELETE_RESOURCE, false, 0, framebuffer);
+    ForgetTrackedHandle(TrackedState::FRAMEBUFFER, framebuffer);
+    if (m_passthrough)
+    {
+        m_passthrough->DeleteFramebuffer(framebuffer);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::FramebufferTexture(GLenum target, GLenum attachment, GLuint texture)
+{
+    RecordStateChange(CommandType::BIND_FRAMEBUFFER, false, 0, target, attachment, texture);
+    if (m_passthrough)
+    {
+        m_passthrough->FramebufferTexture(target, attachment, texture);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+RenderBackend::GLenum RecordingRenderBackend::CheckFramebufferStatus(GLenum target)
+{
+    return m_passthrough ? m_passthrough->CheckFramebufferStatus(target) : FRAMEBUFFER_COMPLETE;
+}
+
+//-----------------------------------------------------------------------------------
+RenderBackend::GLuint RecordingRenderBackend::CreateShader(GLenum shaderType)
+{
+    return RecordResourceCreation(m_passthrough ? m_passthrough->CreateShader(shaderType) : m_nextHandle++);
+}
+
+//-----------------------------------------------------------------------------------
+bool RecordingRenderBackend::CompileShader(GLuint shader, const char* source, std::string& out_errorLog)
+{
+    if (m_passthrough)
+    {
+        return m_passthrough->CompileShader(shader, source, out_errorLog);
+    }
+    m_shaderSources[shader] = source;
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::DeleteShader(GLuint shader)
+{
+    Record(CommandType::DELETE_RESOURCE, false, 0, shader);
+    if (m_passthrough)
+    {
+        m_passthrough->DeleteShader(shader);
+        return;
+    }
+    m_shaderSources.erase(shader);
+}
+
+//-----------------------------------------------------------------------------------
+RenderBackend::GLuint RecordingRenderBackend::CreateProgram()
+{
+    return RecordResourceCreation(m_passthrough ? m_passthrough->CreateProgram() : m_nextHandle++);
+}
+
+//-----------------------------------------------------------------------------------
+bool RecordingRenderBackend::LinkProgram(GLuint program, GLuint vertexShader, GLuint fragmentShader, std::string& out_errorLog)
+{
+    if (m_passthrough)
+    {
+        return m_passthrough->LinkProgram(program, vertexShader, fragmentShader, out_errorLog);
+    }
+
+    //Unlike a driver, this reports everything declared, used or not. Uniforms shared by both stages are only listed once.
+    ProgramVariables& variables = m_programVariables[program];
+    variables.m_attributes.clear();
+    variables.m_uniforms.clear();
+    ParseShaderVariables(m_shaderSources[vertexShader], "in", variables.m_attributes);
+    ParseShaderVariables(m_shaderSources[vertexShader], "uniform", variables.m_uniforms);
+    std::vector<ShaderVariable> fragmentUniforms;
+    ParseShaderVariables(m_shaderSources[fragmentShader], "uniform", fragmentUniforms);
+    for (const ShaderVariable& uniform : fragmentUniforms)
+    {
+        bool isDuplicate = false;
+        for (const ShaderVariable& existingUniform : variables.m_uniforms)
+        {
+            isDuplicate = isDuplicate || existingUniform.name == uniform.name;
+        }
+        if (!isDuplicate)
+        {
+            variables.m_uniforms.push_back(uniform);
+        }
+    }
+
+    for (unsigned int i = 0; i < variables.m_attributes.size(); ++i)
+    {
+        variables.m_attributes[i].location = i;
+    }
+    for (unsigned int i = 0; i < variables.m_uniforms.size(); ++i)
+    {
+        variables.m_uniforms[i].location = i;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::DeleteProgram(GLuint program)
+{
+    Record(CommandType::DELETE_RESOURCE, false, 0, program);
+    ForgetTrackedHandle(TrackedState::PROGRAM, program);
+    m_uniformValues.erase(m_uniformValues.lower_bound((uint64_t)program << 32), m_uniformValues.lower_bound((uint64_t)(program + 1) << 32));
+    if (m_currentProgram == program)
+    {
+        m_currentProgram = 0;
+    }
+    if (m_passthrough)
+    {
+        m_passthrough->DeleteProgram(program);
+        return;
+    }
+    m_programVariables.erase(program);
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::GetActiveAttributes(GLuint program, std::vector<ShaderVariable>& out_attributes)
+{
+    if (m_passthrough)
+    {
+        m_passthrough->GetActiveAttributes(program, out_attributes);
+        return;
+    }
+    const std::vector<ShaderVariable>& attributes = m_programVariables[program].m_attributes;
+    out_attributes.insert(out_attributes.end(), attributes.begin(), attributes.end());
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::GetActiveUniforms(GLuint program, std::vector<ShaderVariable>& out_uniforms)
+{
+    if (m_passthrough)
+    {
+        m_passthrough->GetActiveUniforms(program, out_uniforms);
+        return;
+    }
+    const std::vector<ShaderVariable>& uniforms = m_programVariables[program].m_uniforms;
+    out_uniforms.insert(out_uniforms.end(), uniforms.begin(), uniforms.end());
+}
+
+//-----------------------------------------------------------------------------------
+RenderBackend::GLint RecordingRenderBackend::GetUniformLocation(GLuint program, const char* name)
+{
+    if (m_passthrough)
+    {
+        return m_passthrough->GetUniformLocation(program, name);
+    }
+    std::string arrayName = std::string(name) + "[0]";
+    for (const ShaderVariable& uniform : m_programVariables[program].m_uniforms)
+    {
+        if (uniform.name == name || uniform.name == arrayName)
+        {
+            return uniform.location;
+        }
+    }
+    return -1;
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::BindUniformBlock(GLuint program, const char* blockName, GLuint bindPoint)
+{
+    RecordStateChange(CommandType::BIND_BUFFER_BASE, false, bindPoint, program);
+    if (m_passthrough)
+    {
+        m_passthrough->BindUniformBlock(program, blockName, bindPoint);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+std::string RecordingRenderBackend::GetVersionString()
+{
+    return m_passthrough ? m_passthrough->GetVersionString() : "Headless recording backend, no GPU";
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::SetCapability(GLenum capability, bool isEnabled)
+{
+    RecordStateChange(CommandType::SET_CAPABILITY, UpdateTrackedState(TrackedState::CAPABILITY, capability, isEnabled), 0, capability, isEnabled);
+    if (m_passthrough)
+    {
+        m_passthrough->SetCapability(capability, isEnabled);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::SetBlendFunction(GLenum sourceFactor, GLenum destinationFactor)
+{
+    bool isRedundant = UpdateTrackedState(TrackedState::BLEND_FUNCTION, 0, ((uint64_t)sourceFactor << 32) | destinationFactor);
+    RecordStateChange(CommandType::SET_BLEND_FUNCTION, isRedundant, 0, sourceFactor, destinationFactor);
+    if (m_passthrough)
+    {
+        m_passthrough->SetBlendFunction(sourceFactor, destinationFactor);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::SetDepthMask(bool isWriteEnabled)
+{
+    RecordStateChange(CommandType::SET_DEPTH_MASK, UpdateTrackedState(TrackedState::DEPTH_MASK, 0, isWriteEnabled), 0, isWriteEnabled);
+    if (m_passthrough)
+    {
+        m_passthrough->SetDepthMask(isWriteEnabled);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::SetViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    bool isPositionRedundant = UpdateTrackedState(TrackedState::VIEWPORT_POSITION, 0, ((uint64_t)(uint32_t)x << 32) | (uint32_t)y);
+    bool isSizeRedundant = UpdateTrackedState(TrackedState::VIEWPORT_SIZE, 0, ((uint64_t)(uint32_t)width << 32) | (uint32_t)height);
+    RecordStateChange(CommandType::SET_VIEWPORT, isPositionRedundant && isSizeRedundant, 0, (x << 16) | (y & 0xFFFF), width, height);
+    if (m_passthrough)
+    {
+        m_passthrough->SetViewport(x, y, width, height);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::SetPointSize(float size)
+{
+    uint32_t sizeBits;
+    memcpy(&sizeBits, &size, sizeof(sizeBits));
+    RecordStateChange(CommandType::SET_POINT_SIZE, UpdateTrackedState(TrackedState::POINT_SIZE, 0, sizeBits), 0, sizeBits);
+    if (m_passthrough)
+    {
+        m_passthrough->SetPointSize(size);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::UseProgram(GLuint program)
+{
+    RecordStateChange(CommandType::USE_PROGRAM, UpdateTrackedState(TrackedState::PROGRAM, 0, program), 0, program);
+    m_currentProgram = program;
+    if (m_passthrough)
+    {
+        m_passthrough->UseProgram(program);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::BindVertexArray(GLuint vertexArray)
+{
+    RecordStateChange(CommandType::BIND_VERTEX_ARRAY, UpdateTrackedState(TrackedState::VERTEX_ARRAY, 0, vertexArray), 0, vertexArray);
+    if (m_passthrough)
+    {
+        m_passthrough->BindVertexArray(vertexArray);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::BindBuffer(GLenum target, GLuint buffer)
+{
+    RecordStateChange(CommandType::BIND_BUFFER, UpdateTrackedState(TrackedState::BUFFER, target, buffer), 0, target, buffer);
+    if (m_passthrough)
+    {
+        m_passthrough->BindBuffer(target, buffer);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::BindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+    //Also binds the generic target, which is how UniformBuffer picks what BufferData goes to
+    bool isRedundant = UpdateTrackedState(TrackedState::BUFFER_BASE, (target << 8) | (index & 0xFF), buffer);
+    UpdateTrackedState(TrackedState::BUFFER, target, buffer);
+    RecordStateChange(CommandType::BIND_BUFFER_BASE, isRedundant, index, target, buffer);
+    if (m_passthrough)
+    {
+        m_passthrough->BindBufferBase(target, index, buffer);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::BindTexture(GLuint textureUnit, GLuint texture)
+{
+    RecordStateChange(CommandType::BIND_TEXTURE, UpdateTrackedState(TrackedState::TEXTURE, textureUnit, texture), textureUnit, texture);
+    if (m_passthrough)
+    {
+        m_passthrough->BindTexture(textureUnit, texture);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::BindSampler(GLuint textureUnit, GLuint sampler)
+{
+    RecordStateChange(CommandType::BIND_SAMPLER, UpdateTrackedState(TrackedState::SAMPLER, textureUnit, sampler), textureUnit, sampler);
+    if (m_passthrough)
+    {
+        m_passthrough->BindSampler(textureUnit, sampler);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::BindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    bool isRedundant;
+    if (target == FRAMEBUFFER_TARGET)
+    {
+        bool isReadRedundant = UpdateTrackedState(TrackedState::FRAMEBUFFER, READ_FRAMEBUFFER_TARGET, framebuffer);
+        bool isDrawRedundant = UpdateTrackedState(TrackedState::FRAMEBUFFER, DRAW_FRAMEBUFFER_TARGET, framebuffer);
+        isRedundant = isReadRedundant && isDrawRedundant;
+    }
+    else
+    {
+        isRedundant = UpdateTrackedState(TrackedState::FRAMEBUFFER, target, framebuffer);
+    }
+    RecordStateChange(CommandType::BIND_FRAMEBUFFER, isRedundant, 0, target, framebuffer);
+    if (m_passthrough)
+    {
+        m_passthrough->BindFramebuffer(target, framebuffer);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::SetDrawBuffers(GLsizei count, const GLenum* buffers)
+{
+    RecordStateChange(CommandType::SET_DRAW_BUFFERS, false, 0, count);
+    if (m_passthrough)
+    {
+        m_passthrough->SetDrawBuffers(count, buffers);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::SetVertexAttribute(GLuint location, GLint count, GLenum type, bool normalize, GLsizei stride, size_t offset)
+{
+    //Vertex array state belongs to whichever array is bound, so these aren't tracked for redundancy.
+    RecordStateChange(CommandType::SET_VERTEX_ATTRIBUTE, false, location, (count << 8) | normalize, type, (stride << 16) | (offset & 0xFFFF));
+    if (m_passthrough)
+    {
+        m_passthrough->SetVertexAttribute(location, count, type, normalize, stride, offset);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::SetIntegerVertexAttribute(GLuint location, GLint count, GLenum type, GLsizei stride, size_t offset)
+{
+    RecordStateChange(CommandType::SET_VERTEX_ATTRIBUTE, false, location, count << 8, type, (stride << 16) | (offset & 0xFFFF));
+    if (m_passthrough)
+    {
+        m_passthrough->SetIntegerVertexAttribute(location, count, type, stride, offset);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::SetUniform(GLint location, Uniform::DataType type, GLsizei count, const void* data)
+{
+    static const size_t DATA_TYPE_SIZES[(int)Uniform::DataType::NUM_TYPES] = { sizeof(int), 16 * sizeof(float), 2 * sizeof(float), 3 * sizeof(float), 4 * sizeof(float), sizeof(float), sizeof(int) };
+    size_t dataSize = (type < Uniform::DataType::NUM_TYPES ? DATA_TYPE_SIZES[(int)type] : 0) * count;
+
+    //Uniform values live in the program, so they survive switching programs back and forth.
+    std::string& lastValue = m_uniformValues[((uint64_t)m_currentProgram << 32) | (uint32_t)location];
+    bool isRedundant = lastValue.size() == dataSize && memcmp(lastValue.data(), data, dataSize) == 0;
+    if (!isRedundant)
+    {
+        lastValue.assign((const char*)data, dataSize);
+    }
+
+    ++m_statistics.m_numUniformSets;
+    if (isRedundant)
+    {
+        ++m_statistics.m_numRedundantUniformSets;
+    }
+    Record(CommandType::SET_UNIFORM, isRedundant, location, m_currentProgram, (uint32_t)type, count);
+    if (m_passthrough)
+    {
+        m_passthrough->SetUniform(location, type, count, data);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+RenderBackend::GLint RecordingRenderBackend::GetMaxUniformBufferBindings()
+{
+    return m_passthrough ? m_passthrough->GetMaxUniformBufferBindings() : HEADLESS_MAX_UNIFORM_BUFFER_BINDINGS;
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::BufferData(GLenum target, size_t size, const void* data, GLenum usage)
+{
+    ++m_statistics.m_numBufferUploads;
+    m_statistics.m_numBytesUploaded += data ? size : 0;
+    auto boundBuffer = m_trackedState.find(MakeStateKey(TrackedState::BUFFER, target));
+    Record(CommandType::BUFFER_DATA, false, 0, boundBuffer != m_trackedState.end() ? (uint32_t)boundBuffer->second : 0, 0, (uint32_t)size);
+    if (m_passthrough)
+    {
+        m_passthrough->BufferData(target, size, data, usage);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::BufferSubData(GLenum target, size_t offset, size_t size, const void* data)
+{
+    ++m_statistics.m_numBufferUploads;
+    m_statistics.m_numBytesUploaded += size;
+    auto boundBuffer = m_trackedState.find(MakeStateKey(TrackedState::BUFFER, target));
+    Record(CommandType::BUFFER_DATA, false, 0, boundBuffer != m_trackedState.end() ? (uint32_t)boundBuffer->second : 0, (uint32_t)offset, (uint32_t)size);
+    if (m_passthrough)
+    {
+        m_passthrough->BufferSubData(target, offset, size, data);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::SetClearColor(float red, float green, float blue, float alpha)
+{
+    uint32_t packedColor = ((uint32_t)(red * 255.0f) << 24) | ((uint32_t)(green * 255.0f) << 16) | ((uint32_t)(blue * 255.0f) << 8) | (uint32_t)(alpha * 255.0f);
+    UpdateTrackedState(TrackedState::CLEAR_COLOR, 0, packedColor);
+    if (m_passthrough)
+    {
+        m_passthrough->SetClearColor(red, green, blue, alpha);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::SetClearDepth(float depth)
+{
+    uint32_t depthBits;
+    memcpy(&depthBits, &depth, sizeof(depthBits));
+    UpdateTrackedState(TrackedState::CLEAR_DEPTH, 0, depthBits);
+    if (m_passthrough)
+    {
+        m_passthrough->SetClearDepth(depth);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::Clear(GLbitfield mask)
+{
+    auto clearColor = m_trackedState.find(MakeStateKey(TrackedState::CLEAR_COLOR, 0));
+    Record(CommandType::CLEAR, false, 0, mask, clearColor != m_trackedState.end() ? (uint32_t)clearColor->second : 0);
+    if (m_passthrough)
+    {
+        m_passthrough->Clear(mask);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::ClearColorBuffer(GLint drawBuffer, const float* color)
+{
+    Record(CommandType::CLEAR, false, drawBuffer, 0);
+    if (m_passthrough)
+    {
+        m_passthrough->ClearColorBuffer(drawBuffer, color);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::DrawElements(GLenum drawMode, GLsizei numIndices)
+{
+    ++m_statistics.m_numDrawCalls;
+    m_statistics.m_numIndicesDrawn += numIndices;
+    auto vertexArray = m_trackedState.find(MakeStateKey(TrackedState::VERTEX_ARRAY, 0));
+    Record(CommandType::DRAW, false, 0, drawMode, numIndices, vertexArray != m_trackedState.end() ? (uint32_t)vertexArray->second : 0);
+    if (m_passthrough)
+    {
+        m_passthrough->DrawElements(drawMode, numIndices);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::DrawArrays(GLenum drawMode, GLint firstVertex, GLsizei numVertices)
+{
+    ++m_statistics.m_numDrawCalls;
+    m_statistics.m_numIndicesDrawn += numVertices;
+    Record(CommandType::DRAW, false, 0, drawMode, numVertices, firstVertex);
+    if (m_passthrough)
+    {
+        m_passthrough->DrawArrays(drawMode, firstVertex, numVertices);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::BlitFramebuffer(GLint sourceX0, GLint sourceY0, GLint sourceX1, GLint sourceY1, GLint destinationX0, GLint destinationY0, GLint destinationX1, GLint destinationY1, GLbitfield mask, GLenum filter)
+{
+    Record(CommandType::BLIT_FRAMEBUFFER, false, 0, mask, sourceX1 - sourceX0, sourceY1 - sourceY0);
+    if (m_passthrough)
+    {
+        m_passthrough->BlitFramebuffer(sourceX0, sourceY0, sourceX1, sourceY1, destinationX0, destinationY0, destinationX1, destinationY1, mask, filter);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::Finish()
+{
+    if (m_passthrough)
+    {
+        m_passthrough->Finish();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+RenderBackend::GLenum RecordingRenderBackend::GetError()
+{
+    return m_passthrough ? m_passthrough->GetError() : 0;
+}
+
+//-----------------------------------------------------------------------------------
+static Uniform::DataType GetDataTypeFromGLSLName(const std::string& typeName)
+{
+    if (typeName == "sampler2D")
+    {
+        return Uniform::DataType::SAMPLER_2D;
+    }
+    else if (typeName == "mat4")
+    {
+        return Uniform::DataType::MATRIX_4X4;
+    }
+    else if (typeName == "vec4")
+    {
+        return Uniform::DataType::VECTOR4;
+    }
+    else if (typeName == "vec3")
+    {
+        return Uniform::DataType::VECTOR3;
+    }
+    else if (typeName == "vec2")
+    {
+        return Uniform::DataType::VECTOR2;
+    }
+    else if (typeName == "float")
+    {
+        return Uniform::DataType::FLOAT;
+    }
+    else if (typeName == "int")
+    {
+        return Uniform::DataType::INT;
+    }
+    return Uniform::DataType::NUM_TYPES;
+}
+
+//-----------------------------------------------------------------------------------
+void RecordingRenderBackend::ParseShaderVariables(const std::string& source, const char* storageQualifier, std::vector<ShaderVariable>& out_variables)
+{
+    //Strip comments and preprocessor lines, and turn everything that isn't part of a word into spaces.
+    std::string code;
+    code.reserve(source.size());
+    for (size_t i = 0; i < source.size(); ++i)
+    {
+        char character = source[i];
+        if ((character == '/' && i + 1 < source.size() && source[i + 1] == '/') || character == '#')
+        {
+            i = source.find('\n', i);
+            if (i == std::string::npos)
+            {
+                break;
+            }
+            code += ' ';
+        }
+        else if (character == '/' && i + 1 < source.size() && source[i + 1] == '*')
+        {
+            i = source.find("*/", i + 2);
+            if (i == std::string::npos)
+            {
+                break;
+            }
+            ++i;
+            code += ' ';
+        }
+        else if (character == ';' || character == '{' || character == '}')
+        {
+            code += ';';
+        }
+        else if (character == '(' || character == ')' || character == ',' || character == '=' || character == '\t' || character == '\r' || character == '\n')
+        {
+            code += ' ';
+        }
+        else
+        {
+            code += character;
+        }
+    }
+
+    //Then each statement holding the qualifier is "... qualifier [precision] type name[size]".
+    std::vector<std::string>* statements = SplitString(code, ";");
+    for (const std::string& statement : *statements)
+    {
+        std::vector<std::string>* tokens = SplitString(statement, " ");
+        tokens->erase(std::remove(tokens->begin(), tokens->end(), std::string()), tokens->end());
+        for (unsigned int i = 0; i < tokens->size(); ++i)
+        {
+            if (tokens->at(i) != storageQualifier)
+            {
+                continue;
+            }
+            unsigned int typeIndex = i + 1;
+            while (typeIndex < tokens->size() && (tokens->at(typeIndex) == "lowp" || tokens->at(typeIndex) == "mediump" || tokens->at(typeIndex) == "highp"))
+            {
+                ++typeIndex;
+            }
+            if (typeIndex + 1 >= tokens->size())
+            {
+                break; //An interface block, or something else we can't report
+            }
+
+            ShaderVariable variable;
+            variable.type = GetDataTypeFromGLSLName(tokens->at(typeIndex));
+            variable.name = tokens->at(typeIndex + 1);
+            variable.size = 1;
+            variable.location = -1;
+            size_t arrayStart = variable.name.find('[');
+            if (arrayStart != std::string::npos)
+            {
+                variable.size = atoi(variable.name.c_str() + arrayStart + 1);
+                variable.name = variable.name.substr(0, arrayStart) + "[0]"; //Drivers report arrays by their first element
+            }
+            out_variables.push_back(variable);
+            break;
+        }
+        delete tokens;
+    }
+    delete statements;
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(renderrecord)
+{
+    UNUSED(args)
+    static RecordingRenderBackend* s_recorder = nullptr;
+    static unsigned int s_startFrame = 0;
+    static double s_startSeconds = 0.0;
+
+    if (!s_recorder)
+    {
+        s_recorder = new RecordingRenderBackend(RenderBackend::instance);
+        RenderBackend::instance = s_recorder;
+        s_startFrame = InputSystem::instance->GetFrameNumber();
+        s_startSeconds = GetCurrentTimeSeconds();
+        Console::instance->PrintLine("Recording render calls, run renderrecord again to stop.", RGBA::GBWHITE);
+        return;
+    }
+
+    ASSERT_OR_DIE(RenderBackend::instance == s_recorder, "Render backend was replaced while recording");
+    RenderBackend::instance = s_recorder->GetPassthrough();
+    unsigned int numFrames = InputSystem::instance->GetFrameNumber() - s_startFrame;
+    double numSeconds = GetCurrentTimeSeconds() - s_startSeconds;
+    double framesDivisor = numFrames > 0 ? (double)numFrames : 1.0;
+
+    const RecordingRenderBackend::Statistics& statistics = s_recorder->GetStatistics();
+    Console::instance->PrintLine(Stringf("Recorded %u frames over %.2f seconds, %u commands in the stream (%u dropped)", numFrames, numSeconds, s_recorder->GetCommands().size(), (unsigned int)statistics.m_numDroppedCommands), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("Per frame: %.1f draw calls, %.1f indices, %.1f state changes (%.1f redundant), %.1f uniform sets (%.1f redundant), %.1f uploads totalling %.1fKB", 
+        statistics.m_numDrawCalls / framesDivisor, statistics.m_numIndicesDrawn / framesDivisor, statistics.m_numStateChanges / framesDivisor, statistics.m_numRedundantStateChanges / framesDivisor, 
+        statistics.m_numUniformSets / framesDivisor, statistics.m_numRedundantUniformSets / framesDivisor, statistics.m_numBufferUploads / framesDivisor, statistics.m_numBytesUploaded / framesDivisor / 1024.0), RGBA::CORNFLOWER_BLUE);
+    for (int i = 0; i < (int)RecordingRenderBackend::CommandType::NUM_COMMAND_TYPES; ++i)
+    {
+        RecordingRenderBackend::CommandType type = (RecordingRenderBackend::CommandType)i;
+        if (s_recorder->GetNumCommands(type) > 0)
+        {
+            Console::instance->PrintLine(Stringf("    %-20s %10.1f per frame, %5.1f%% redundant", RecordingRenderBackend::GetCommandName(type), s_recorder->GetNumCommands(type) / framesDivisor, 100.0 * s_recorder->GetNumRedundantCommands(type) / s_recorder->GetNumCommands(type)), RGBA::GBWHITE);
+        }
+    }
+    delete s_recorder;
+    s_recorder = nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,191 @@
+#pragma once
+#include "Engine/Renderer/RenderBackend.hpp"
+#include <map>
+
+//-----------------------------------------------------------------------------------
+// Tracks the state every call would leave the driver in, counts draws, uploads and state changes
+// (and how many of those changes set what was already set), and appends each call to a compact
+// command stream.
+// With a passthrough backend every call is still forwarded, so it can be slid under a running game
+// for a few frames. Without one it is completely headless: handles are made up, shader sources are
+// scanned for their declarations instead of compiled, and nothing ever touches a GPU.
+class RecordingRenderBackend : public RenderBackend
+{
+public:
+    //ENUMS//////////////////////////////////////////////////////////////////////////
+    enum class CommandType : uint8_t
+    {
+        CREATE_RESOURCE,
+        DELETE_RESOURCE,
+        SET_CAPABILITY,
+        SET_BLEND_FUNCTION,
+        SET_DEPTH_MASK,
+        SET_VIEWPORT,
+        SET_POINT_SIZE,
+        USE_PROGRAM,
+        BIND_VERTEX_ARRAY,
+        BIND_BUFFER,
+        BIND_BUFFER_BASE,
+        BIND_TEXTURE,
+        BIND_SAMPLER,
+        BIND_FRAMEBUFFER,
+        SET_DRAW_BUFFERS,
+        SET_VERTEX_ATTRIBUTE,
+        SET_UNIFORM,
+        BUFFER_DATA,
+        CLEAR,
+        DRAW,
+        BLIT_FRAMEBUFFER,
+        NUM_COMMAND_TYPES
+    };
+
+    //STRUCTS//////////////////////////////////////////////////////////////////////////
+    struct RecordedCommand
+    {
+        CommandType m_type;
+        bool m_isRedundant;
+        uint16_t m_slot; //Texture unit, buffer target index, uniform location; whatever the command is bound to
+        uint32_t m_arguments[3];
+    };
+
+    struct Statistics
+    {
+        uint64_t m_numDrawCalls;
+        uint64_t m_numIndicesDrawn; //Vertices for array draws
+        uint64_t m_numStateChanges;
+        uint64_t m_numRedundantStateChanges;
+        uint64_t m_numUniformSets;
+        uint64_t m_numRedundantUniformSets;
+        uint64_t m_numBufferUploads;
+        uint64_t m_numBytesUploaded;
+        uint64_t m_numResourcesCreated;
+        uint64_t m_numDroppedCommands; //Counted, but past MAX_RECORDED_COMMANDS so not in the stream
+    };
+
+    //CONSTRUCTORS//////////////////////////////////////////////////////////////////////////
+    RecordingRenderBackend(RenderBackend* passthrough = nullptr); //Not owned
+    virtual ~RecordingRenderBackend();
+
+    //FUNCTIONS//////////////////////////////////////////////////////////////////////////
+    void ResetStatistics(); //Also clears the command stream, but keeps the tracked state
+    inline const Statistics& GetStatistics() const { return m_statistics; };
+    inline const std::vector<RecordedCommand>& GetCommands() const { return m_commands; };
+    inline uint64_t GetNumCommands(CommandType type) const { return m_numCommandsByType[(int)type]; };
+    inline uint64_t GetNumRedundantCommands(CommandType type) const { return m_numRedundantCommandsByType[(int)type]; };
+    inline RenderBackend* GetPassthrough() const { return m_passthrough; };
+    static const char* GetCommandName(CommandType type);
+
+    //RESOURCES//////////////////////////////////////////////////////////////////////////
+    virtual GLuint CreateBuffer() override;
+    virtual void DeleteBuffer(GLuint buffer) override;
+    virtual GLuint CreateVertexArray() override;
+    virtual void DeleteVertexArray(GLuint vertexArray) override;
+    virtual GLuint CreateSampler(GLenum minFilter, GLenum magFilter, GLenum uWrap, GLenum vWrap) override;
+    virtual void DeleteSampler(GLuint sampler) override;
+    virtual GLuint CreateTexture2D(GLsizei width, GLsizei height, GLenum internalFormat, GLenum format, GLenum type, const void* data) override;
+    virtual void UpdateTexture2D(GLuint texture, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* data) override;
+    virtual void DeleteTexture(GLuint texture) override;
+    virtual GLuint CreateFramebuffer() override;
+    virtual void DeleteFramebuffer(GLuint framebuffer) override;
+    virtual void FramebufferTexture(GLenum target, GLenum attachment, GLuint texture) override;
+    virtual GLenum CheckFramebufferStatus(GLenum target) override;
+
+    //SHADERS//////////////////////////////////////////////////////////////////////////
+    virtual GLuint CreateShader(GLenum shaderType) override;
+    virtual bool CompileShader(GLuint shader, const char* source, std::string& out_errorLog) override;
+    virtual void DeleteShader(GLuint shader) override;
+    virtual GLuint CreateProgram() override;
+    virtual bool LinkProgram(GLuint program, GLuint vertexShader, GLuint fragmentShader, std::string& out_errorLog) override;
+    virtual void DeleteProgram(GLuint program) override;
+    virtual void GetActiveAttributes(GLuint program, std::vector<ShaderVariable>& out_attributes) override;
+    virtual void GetActiveUniforms(GLuint program, std::vector<ShaderVariable>& out_uniforms) override;
+    virtual GLint GetUniformLocation(GLuint program, const char* name) override;
+    virtual void BindUniformBlock(GLuint program, const char* blockName, GLuint bindPoint) override;
+    virtual std::string GetVersionString() override;
+
+    //STATE//////////////////////////////////////////////////////////////////////////
+    virtual void SetCapability(GLenum capability, bool isEnabled) override;
+    virtual void SetBlendFunction(GLenum sourceFactor, GLenum destinationFactor) override;
+    virtual void SetDepthMask(bool isWriteEnabled) override;
+    virtual void SetViewport(GLint x, GLint y, GLsizei width, GLsizei height) override;
+    virtual void SetPointSize(float size) override;
+    virtual void UseProgram(GLuint program) override;
+    virtual void BindVertexArray(GLuint vertexArray) override;
+    virtual void BindBuffer(GLenum target, GLuint buffer) override;
+    virtual void BindBufferBase(GLenum target, GLuint index, GLuint buffer) override;
+    virtual void BindTexture(GLuint textureUnit, GLuint texture) override;
+    virtual void BindSampler(GLuint textureUnit, GLuint sampler) override;
+    virtual void BindFramebuffer(GLenum target, GLuint framebuffer) override;
+    virtual void SetDrawBuffers(GLsizei count, const GLenum* buffers) override;
+    virtual void SetVertexAttribute(GLuint location, GLint count, GLenum type, bool normalize, GLsizei stride, size_t offset) override;
+    virtual void SetIntegerVertexAttribute(GLuint location, GLint count, GLenum type, GLsizei stride, size_t offset) override;
+    virtual void SetUniform(GLint location, Uniform::DataType type, GLsizei count, const void* data) override;
+    virtual GLint GetMaxUniformBufferBindings() override;
+
+    //COMMANDS//////////////////////////////////////////////////////////////////////////
+    virtual void BufferData(GLenum target, size_t size, const void* data, GLenum usage) override;
+    virtual void BufferSubData(GLenum target, size_t offset, size_t size, const void* data) override;
+    virtual void SetClearColor(float red, float green, float blue, float alpha) override;
+    virtual void SetClearDepth(float depth) override;
+    virtual void Clear(GLbitfield mask) override;
+    virtual void ClearColorBuffer(GLint drawBuffer, const float* color) override;
+    virtual void DrawElements(GLenum drawMode, GLsizei numIndices) override;
+    virtual void DrawArrays(GLenum drawMode, GLint firstVertex, GLsizei numVertices) override;
+    virtual void BlitFramebuffer(GLint sourceX0, GLint sourceY0, GLint sourceX1, GLint sourceY1, GLint destinationX0, GLint destinationY0, GLint destinationX1, GLint destinationY1, GLbitfield mask, GLenum filter) override;
+    virtual void Finish() override;
+    virtual GLenum GetError() override;
+
+    //CONSTANTS//////////////////////////////////////////////////////////////////////////
+    static const unsigned int MAX_RECORDED_COMMANDS = 1 << 20; //16MB of stream
+
+private:
+    //ENUMS//////////////////////////////////////////////////////////////////////////
+    enum class TrackedState : uint8_t
+    {
+        CAPABILITY,
+        BLEND_FUNCTION,
+        DEPTH_MASK,
+        VIEWPORT_POSITION,
+        VIEWPORT_SIZE,
+        POINT_SIZE,
+        PROGRAM,
+        VERTEX_ARRAY,
+        BUFFER,
+        BUFFER_BASE,
+        TEXTURE,
+        SAMPLER,
+        FRAMEBUFFER,
+        CLEAR_COLOR,
+        CLEAR_DEPTH,
+        NUM_TRACKED_STATES
+    };
+
+    //STRUCTS//////////////////////////////////////////////////////////////////////////
+    struct ProgramVariables
+    {
+        std::vector<ShaderVariable> m_attributes;
+        std::vector<ShaderVariable> m_uniforms;
+    };
+
+    //PRIVATE FUNCTIONS//////////////////////////////////////////////////////////////////////////
+    static uint64_t MakeStateKey(TrackedState state, uint32_t slot);
+    bool UpdateTrackedState(TrackedState state, uint32_t slot, uint64_t value); //True if it was already set to value
+    void ForgetTrackedHandle(TrackedState state, uint32_t handle); //Deleted objects are unbound by the driver
+    void Record(CommandType type, bool isRedundant, uint32_t slot, uint32_t argument0 = 0, uint32_t argument1 = 0, uint32_t argument2 = 0);
+    void RecordStateChange(CommandType type, bool isRedundant, uint32_t slot, uint32_t argument0 = 0, uint32_t argument1 = 0, uint32_t argument2 = 0);
+    GLuint RecordResourceCreation(GLuint handle);
+    static void ParseShaderVariables(const std::string& source, const char* storageQualifier, std::vector<ShaderVariable>& out_variables);
+
+    //MEMBER VARIABLES//////////////////////////////////////////////////////////////////////////
+    RenderBackend* m_passthrough;
+    Statistics m_statistics;
+    uint64_t m_numCommandsByType[(int)CommandType::NUM_COMMAND_TYPES];
+    uint64_t m_numRedundantCommandsByType[(int)CommandType::NUM_COMMAND_TYPES];
+    std::vector<RecordedCommand> m_commands;
+    std::map<uint64_t, uint64_t> m_trackedState; //Missing keys are unknown, so the first set is never redundant
+    std::map<uint64_t, std::string> m_uniformValues; //Keyed by program << 32 | location
+    std::map<GLuint, std::string> m_shaderSources; //Headless only
+    std::map<GLuint, ProgramVariables> m_programVariables; //Headless only
+    GLuint m_currentProgram;
+    GLuint m_nextHandle;
+};
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+#include "Engine/Renderer/ShaderProgram.hpp"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------------
+// Every call the renderer makes into the graphics API goes through RenderBackend::instance.
+// OpenGLRenderBackend passes straight through to the driver; RecordingRenderBackend tracks the
+// state itself and counts what was asked of it, either on its own (no GPU needed) or wrapped
+// around another backend to measure a live frame.
+// Enums and handles are plain OpenGL values, so a backend can treat them as opaque keys.
+class RenderBackend
+{
+public:
+    //TYPEDEFS//////////////////////////////////////////////////////////////////////////
+    typedef unsigned int GLuint;
+    typedef int GLint;
+    typedef int GLsizei;
+    typedef unsigned int GLenum;
+    typedef unsigned int GLbitfield;
+
+    //STRUCTS//////////////////////////////////////////////////////////////////////////
+    struct ShaderVariable
+    {
+        std::string name;
+        Uniform::DataType type;
+        GLint size;
+        GLint location;
+    };
+
+    //CONSTRUCTORS//////////////////////////////////////////////////////////////////////////
+    virtual ~RenderBackend() {};
+
+    //RESOURCES//////////////////////////////////////////////////////////////////////////
+    virtual GLuint CreateBuffer() = 0;
+    virtual void DeleteBuffer(GLuint buffer) = 0;
+    virtual GLuint CreateVertexArray() = 0;
+    virtual void DeleteVertexArray(GLuint vertexArray) = 0;
+    virtual GLuint CreateSampler(GLenum minFilter, GLenum magFilter, GLenum uWrap, GLenum vWrap) = 0;
+    virtual void DeleteSampler(GLuint sampler) = 0;
+    virtual GLuint CreateTexture2D(GLsizei width, GLsizei height, GLenum internalFormat, GLenum format, GLenum type, const void* data) = 0; //Clamped, nearest filtered, left unbound
+    virtual void UpdateTexture2D(GLuint texture, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* data) = 0; //Tightly packed rows, left unbound
+    virtual void DeleteTexture(GLuint texture) = 0;
+    virtual GLuint CreateFramebuffer() = 0;
+    virtual void DeleteFramebuffer(GLuint framebuffer) = 0;
+    virtual void FramebufferTexture(GLenum target, GLenum attachment, GLuint texture) = 0;
+    virtual GLenum CheckFramebufferStatus(GLenum target) = 0;
+
+    //SHADERS//////////////////////////////////////////////////////////////////////////
+    virtual GLuint CreateShader(GLenum shaderType) = 0;
+    virtual bool CompileShader(GLuint shader, const char* source, std::string& out_errorLog) = 0;
+    virtual void DeleteShader(GLuint shader) = 0;
+    virtual GLuint CreateProgram() = 0;
+    virtual bool LinkProgram(GLuint program, GLuint vertexShader, GLuint fragmentShader, std::string& out_errorLog) = 0; //Detaches the shaders again on success
+    virtual void DeleteProgram(GLuint program) = 0;
+    virtual void GetActiveAttributes(GLuint program, std::vector<ShaderVariable>& out_attributes) = 0;
+    virtual void GetActiveUniforms(GLuint program, std::vector<ShaderVariable>& out_uniforms) = 0;
+    virtual GLint GetUniformLocation(GLuint program, const char* name) = 0;
+    virtual void BindUniformBlock(GLuint program, const char* blockName, GLuint bindPoint) = 0;
+    virtual std::string GetVersionString() = 0;
+
+    //STATE//////////////////////////////////////////////////////////////////////////
+    virtual void SetCapability(GLenum capability, bool isEnabled) = 0;
+    virtual void SetBlendFunction(GLenum sourceFactor, GLenum destinationFactor) = 0;
+    virtual void SetDepthMask(bool isWriteEnabled) = 0;
+    virtual void SetViewport(GLint x, GLint y, GLsizei width, GLsizei height) = 0;
+    virtual void SetPointSize(float size) = 0;
+    virtual void UseProgram(GLuint program) = 0;
+    virtual void BindVertexArray(GLuint vertexArray) = 0;
+    virtual void BindBuffer(GLenum target, GLuint buffer) = 0;
+    virtual void BindBufferBase(GLenum target, GLuint index, GLuint buffer) = 0;
+    virtual void BindTexture(GLuint textureUnit, GLuint texture) = 0;
+    virtual void BindSampler(GLuint textureUnit, GLuint sampler) = 0;
+    virtual void BindFramebuffer(GLenum target, GLuint framebuffer) = 0;
+    virtual void SetDrawBuffers(GLsizei count, const GLenum* buffers) = 0;
+    virtual void SetVertexAttribute(GLuint location, GLint count, GLenum type, bool normalize, GLsizei stride, size_t offset) = 0;
+    virtual void SetIntegerVertexAttribute(GLuint location, GLint count, GLenum type, GLsizei stride, size_t offset) = 0;
+    virtual void SetUniform(GLint location, Uniform::DataType type, GLsizei count, const void* data) = 0; //To the program in use
+    virtual GLint GetMaxUniformBufferBindings() = 0;
+
+    //COMMANDS//////////////////////////////////////////////////////////////////////////
+    virtual void BufferData(GLenum target, size_t size, const void* data, GLenum usage) = 0; //To the buffer bound to target
+    virtual void BufferSubData(GLenum target, size_t offset, size_t size, const void* data) = 0;
+    virtual void SetClearColor(float red, float green, float blue, float alpha) = 0;
+    virtual void SetClearDepth(float depth) = 0;
+    virtual void Clear(GLbitfield mask) = 0;
+    virtual void ClearColorBuffer(GLint drawBuffer, const float* color) = 0;
+    virtual void DrawElements(GLenum drawMode, GLsizei numIndices) = 0; //Unsigned int indices from the bound vertex array
+    virtual void DrawArrays(GLenum drawMode, GLint firstVertex, GLsizei numVertices) = 0;
+    virtual void BlitFramebuffer(GLint sourceX0, GLint sourceY0, GLint sourceX1, GLint sourceY1, GLint destinationX0, GLint destinationY0, GLint destinationX1, GLint destinationY1, GLbitfield mask, GLenum filter) = 0;
+    virtual void Finish() = 0;
+    virtual GLenum GetError() = 0;
+
+    //STATIC VARIABLES//////////////////////////////////////////////////////////////////////////
+    static RenderBackend* instance;
+};
\ No newline at end of file
@@ -16,6 +16,7 @@
 #include "Engine/Renderer/Vertex.hpp"
 #include "Engine/Renderer/Face.hpp"
 #include "Engine/Renderer/OpenGLExtensions.hpp"
+#include "Engine/Renderer/OpenGLRenderBackend.hpp"
 #include "Engine/Renderer/ShaderProgram.hpp"
 #include "Engine/Renderer/Material.hpp"
 #include "Engine/Renderer/Framebuffer.hpp"
@@ -35,6 +36,7 @@
 #pragma comment( lib, "Glu32" ) // Link in the Glu32.lib static library
 
 Renderer* Renderer::instance = nullptr;
+RenderBackend* RenderBackend::instance = nullptr;
 
 const unsigned char Renderer::plainWhiteTexel[3] = { 255, 255, 255 };
 
@@ -49,17 +51,18 @@ static GLuint gSampler = NULL;
 static GLuint gDiffuseTex = NULL;
 
 //-----------------------------------------------------------------------------------
-Renderer::Renderer(const Vector2Int& windowSize) 
+Renderer::Renderer(const Vector2Int& windowSize, RenderBackend* backend /*= nullptr*/) 
     : m_fbo(nullptr)
     , m_fboFullScreenEffectQuad(nullptr)
     , m_defaultMaterial(nullptr)
     , m_defaultShader(nullptr)
     , m_windowSize(windowSize)
+    , m_backend(backend ? backend : new OpenGLRenderBackend())
 {
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glEnable(GL_LINE_SMOOTH);
-    HookUpOpenGLPointers();
+    RenderBackend::instance = m_backend;
+    m_backend->SetCapability(GL_BLEND, true);
+    m_backend->SetBlendFunction(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    m_backend->SetCapability(GL_LINE_SMOOTH, true);
 
     m_defaultTexture = Texture::CreateTextureFromData("PlainWhite", const_cast<uchar*>(plainWhiteTexel), 3, Vector2Int::ONE);
     m_defaultFont = BitmapFont::CreateOrGetFont("SquirrelFixedFont");
@@ -89,31 +92,36 @@ Renderer::~Renderer()
     delete m_fboFullScreenEffectQuad; 
     if (m_fboHandle != NULL)
     {
-        glDeleteFramebuffers(1, &m_fboHandle);
+        RenderBackend::instance->DeleteFramebuffer(m_fboHandle);
     }
+    //Registered fonts and textures release their GL handles through the backend, so free them before it goes away.
+    BitmapFont::CleanUpBitmapFontRegistry();
+    Texture::CleanUpTextureRegistry();
+    RenderBackend::instance = nullptr;
+    delete m_backend;
 }
 
 //-----------------------------------------------------------------------------------
 void Renderer::ClearScreen(float red, float green, float blue)
 {
-    glClearColor(red, green, blue, 1.f);
-    glClearDepth(1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    RenderBackend::instance->SetClearColor(red, green, blue, 1.f);
+    RenderBackend::instance->SetClearDepth(1.0f);
+    RenderBackend::instance->Clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
 //-----------------------------------------------------------------------------------
 void Renderer::ClearScreen(const RGBA& color)
 {
-    glClearColor(color.red / 255.0f, color.green / 255.0f, color.blue / 255.0f, 1.f);
-    glClearDepth(1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    RenderBackend::instance->SetClearColor(color.red / 255.0f, color.green / 255.0f, color.blue / 255.0f, 1.f);
+    RenderBackend::instance->SetClearDepth(1.0f);
+    RenderBackend::instance->Clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
 //-----------------------------------------------------------------------------------
 void Renderer::ClearColor(const RGBA& color)
 {
-    glClearColor(color.red / 255.0f, color.green / 255.0f, color.blue / 255.0f, 1.f);
-    glClear(GL_COLOR_BUFFER_BIT);
+    RenderBackend::instance->SetClearColor(color.red / 255.0f, color.green / 255.0f, color.blue / 255.0f, 1.f);
+    RenderBackend::instance->Clear(GL_COLOR_BUFFER_BIT);
 }
 
 //-----------------------------------------------------------------------------------
@@ -186,7 +194,7 @@ void Renderer::SetViewport(GLint x, GLint y, GLsizei width, GLsizei height)
         return;
     }
 
-    glViewport(x, y, width, height);
+    RenderBackend::instance->SetViewport(x, y, width, height);
 
     m_viewportX = x;
     m_viewportY = y;
@@ -214,7 +222,7 @@ void Renderer::TranslateView(const Vector3& translation)
 //-----------------------------------------------------------------------------------
 void Renderer::DrawPoint(float x, float y, const RGBA& color /*= RGBA::WHITE*/, float pointSize /*= 1.0f*/)
 {
-    glPointSize(pointSize);
+    RenderBackend::instance->SetPointSize(pointSize);
     Vertex_PCT vertex;
     vertex.pos = Vector3(x, y, 0.0f);
     vertex.color = color;
@@ -230,7 +238,7 @@ void Renderer::DrawPoint(const Vector2& point, const RGBA& color /*= RGBA::WHITE
 //-----------------------------------------------------------------------------------
 void Renderer::DrawPoint(const Vector3& point, const RGBA& color /*= RGBA::WHITE*/, float pointSize /*= 1.0f*/)
 {
-    glPointSize(pointSize);
+    RenderBackend::instance->SetPointSize(pointSize);
     Vertex_PCT vertex;
     vertex.pos = point;
     vertex.color = color;
@@ -266,7 +274,7 @@ void Renderer::SetPointSize(float size)
     {
         return;
     }
-    glPointSize(size);
+    RenderBackend::instance->SetPointSize(size);
     m_pointSize = size;
 }
 
@@ -336,7 +344,7 @@ void Renderer::EnableAdditiveBlending()
     {
         return;
     }
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+    RenderBackend::instance->SetBlendFunction(GL_SRC_ALPHA, GL_ONE);
     m_blendMode = RenderState::BlendMode::ADDITIVE_BLEND;
 }
 
@@ -347,7 +355,7 @@ void Renderer::EnableAlphaBlending()
     {
         return;
     }
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    RenderBackend::instance->SetBlendFunction(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     m_blendMode = RenderState::BlendMode::ALPHA_BLEND;
 }
 
@@ -358,10 +366,57 @@ void Renderer::EnableInvertedBlending()
     {
         return;
     }
-    glBlendFunc(GL_ONE_MINUS_DST_COLOR, GL_ZERO);
+    RenderBackend::instance->SetBlendFunction(GL_ONE_MINUS_DST_COLOR, GL_ZERO);
     m_blendMode = RenderState::BlendMode::INVERTED_BLEND;
 }
 
+//-----------------------------------------------------------------------------------
+// Benchmarks slide a RecordingRenderBackend in under the renderer. Nothing set while it's in place reaches the real
+// backend, so the caches have to go back to what the real one was last told, or later calls get skipped as redundant.
+RenderBackend* Renderer::BeginBackendOverride(RenderBackend* backend)
+{
+    ASSERT_OR_DIE(!m_isBackendOverridden, "Backend overrides don't nest");
+    m_overriddenStateCache.blendMode = m_blendMode;
+    m_overriddenStateCache.faceCullingEnabled = m_faceCullingEnabled;
+    m_overriddenStateCache.depthTestingEnabled = m_depthTestingEnabled;
+    m_overriddenStateCache.depthWritingEnabled = m_depthWritingEnabled;
+    m_overriddenStateCache.lineWidth = m_lineWidth;
+    m_overriddenStateCache.pointSize = m_pointSize;
+    m_overriddenStateCache.viewportX = m_viewportX;
+    m_overriddenStateCache.viewportY = m_viewportY;
+    m_overriddenStateCache.viewportWidth = m_viewportWidth;
+    m_overriddenStateCache.viewportHeight = m_viewportHeight;
+    m_overriddenStateCache.currentShaderProgramId = m_currentShaderProgramId;
+    m_isBackendOverridden = true;
+
+    RenderBackend* previousBackend = RenderBackend::instance;
+    RenderBackend::instance = backend;
+    m_currentShaderProgramId = NULL; //A fresh backend has no program in use, and its handles could collide with ours
+    return previousBackend;
+}
+
+//-----------------------------------------------------------------------------------
+void Renderer::EndBackendOverride(RenderBackend* previousBackend)
+{
+    ASSERT_OR_DIE(m_isBackendOverridden, "Ended a backend override that was never begun");
+    RenderBackend::instance = previousBackend;
+    m_blendMode = m_overriddenStateCache.blendMode;
+    m_faceCullingEnabled = m_overriddenStateCache.faceCullingEnabled;
+    m_depthTestingEnabled = m_overriddenStateCache.depthTestingEnabled;
+    m_depthWritingEnabled = m_overriddenStateCache.depthWritingEnabled;
+    m_lineWidth = m_overriddenStateCache.lineWidth;
+    m_pointSize = m_overriddenStateCache.pointSize;
+    m_viewportX = m_overriddenStateCache.viewportX;
+    m_viewportY = m_overriddenStateCache.viewportY;
+    m_viewportWidth = m_overriddenStateCache.viewportWidth;
+    m_viewportHeight = m_overriddenStateCache.viewportHeight;
+    m_currentShaderProgramId = m_overriddenStateCache.currentShaderProgramId;
+    m_isBackendOverridden = false;
+
+    //Uniforms set meanwhile only went to the override too.
+    ShaderProgram::InvalidateAllBoundParameters();
+}
+
 //-----------------------------------------------------------------------------------
 void Renderer::EnableDepthTest(bool usingDepthTest)
 {
@@ -369,7 +424,7 @@ void Renderer::EnableDepthTest(bool usingDepthTest)
     {
         return;
     }
-    usingDepthTest ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST);
+    RenderBackend::instance->SetCapability(GL_DEPTH_TEST, usingDepthTest);
     m_depthTestingEnabled = usingDepthTest;
 }
 
@@ -380,7 +435,7 @@ void Renderer::EnableDepthWrite()
     {
         return;
     }
-    glDepthMask(true);
+    RenderBackend::instance->SetDepthMask(true);
     m_depthWritingEnabled = true;
 }
 
@@ -391,7 +446,7 @@ void Renderer::DisableDepthWrite()
     {
         return;
     }
-    glDepthMask(false);
+    RenderBackend::instance->SetDepthMask(false);
     m_depthWritingEnabled = false;
 }
 
@@ -412,8 +467,7 @@ void Renderer::UnbindTexture()
 //-----------------------------------------------------------------------------------
 int Renderer::GenerateBufferID()
 {
-    GLuint vboID = 0;
-    glGenBuffers(1, &vboID);
+    GLuint vboID = RenderBackend::instance->CreateBuffer();
     #if defined(TRACK_MEMORY)
         g_memoryAnalytics.TrackRenderBufferAllocation();
     #endif
@@ -423,8 +477,7 @@ int Renderer::GenerateBufferID()
 //-----------------------------------------------------------------------------------
 void Renderer::DeleteBuffers(int vboID)
 {
-    const GLuint id = ((GLuint)vboID);
-    glDeleteBuffers(1, &id);
+    RenderBackend::instance->DeleteBuffer((GLuint)vboID);
     #if defined(TRACK_MEMORY)
         g_memoryAnalytics.TrackRenderBufferFree();
     #endif
@@ -433,17 +486,17 @@ void Renderer::DeleteBuffers(int vboID)
 //-----------------------------------------------------------------------------------
 void Renderer::BindAndBufferVBOData(int vboID, const Vertex_PCT* vertexes, int numVerts)
 {
-    glBindBuffer(GL_ARRAY_BUFFER, vboID);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex_PCT) * numVerts, vertexes, GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, NULL);
+    RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, vboID);
+    RenderBackend::instance->BufferData(GL_ARRAY_BUFFER, sizeof(Vertex_PCT) * numVerts, vertexes, GL_STATIC_DRAW);
+    RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, NULL);
 }
 
 //-----------------------------------------------------------------------------------
 void Renderer::BindAndBufferVBOData(int vboID, const Vertex_PCUTB* vertexes, int numVerts)
 {
-    glBindBuffer(GL_ARRAY_BUFFER, vboID);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex_PCUTB) * numVerts, vertexes, GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, NULL);
+    RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, vboID);
+    RenderBackend::instance->BufferData(GL_ARRAY_BUFFER, sizeof(Vertex_PCUTB) * numVerts, vertexes, GL_STATIC_DRAW);
+    RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, NULL);
 }
 
 //-----------------------------------------------------------------------------------
@@ -473,7 +526,7 @@ void Renderer::DrawVertexArray(const Vertex_PCT* vertexes, int numVertexes, Draw
     GL_CHECK_ERROR();
     thingToRender->Render();
     GL_CHECK_ERROR();
-    glFinish(); //TODO: this causes an explicit flush to ensure that we've actually sync'd with the gpu before deleting the memory. Remove/refactor this code to not throw away meshes anymore.
+    RenderBackend::instance->Finish(); //TODO: this causes an explicit flush to ensure that we've actually sync'd with the gpu before deleting the memory. Remove/refactor this code to not throw away meshes anymore.
     delete mesh;
     delete thingToRender;
 }
@@ -614,7 +667,7 @@ void Renderer::DrawText2D(const Vector2& position, const std::string& asciiText,
     GL_CHECK_ERROR();
     thingToRender->Render();
     GL_CHECK_ERROR();
-    glFinish(); //TODO: this causes an explicit flush to ensure that we've actually sync'd with the gpu before deleting the memory. Remove/refactor this code to not throw away meshes anymore.
+    RenderBackend::instance->Finish(); //TODO: this causes an explicit flush to ensure that we've actually sync'd with the gpu before deleting the memory. Remove/refactor this code to not throw away meshes anymore.
     delete mesh;
     delete thingToRender;
 }
@@ -648,8 +701,7 @@ unsigned char Renderer::GetDrawMode(DrawMode mode) const
 //-----------------------------------------------------------------------------------
 GLuint Renderer::GenerateVAOHandle()
 {
-    GLuint vaoID;
-    glGenVertexArrays(1, &vaoID);
+    GLuint vaoID = RenderBackend::instance->CreateVertexArray();
     ASSERT_OR_DIE(vaoID != NULL, "VAO was null");
     #if defined(TRACK_MEMORY)
         g_memoryAnalytics.TrackVAOAllocation();
@@ -660,7 +712,7 @@ GLuint Renderer::GenerateVAOHandle()
 //-----------------------------------------------------------------------------------
 void Renderer::DeleteVAOHandle(GLuint vaoID)
 {
-    glDeleteVertexArrays(1, &vaoID);
+    RenderBackend::instance->DeleteVertexArray(vaoID);
     #if defined(TRACK_MEMORY)
         g_memoryAnalytics.TrackVAOFree();
     #endif
@@ -669,8 +721,8 @@ void Renderer::DeleteVAOHandle(GLuint vaoID)
 //-----------------------------------------------------------------------------------
 void Renderer::ClearDepth(float depthValue)
 {
-    glClearDepth(depthValue);
-    glClear(GL_DEPTH_BUFFER_BIT);
+    RenderBackend::instance->SetClearDepth(depthValue);
+    RenderBackend::instance->Clear(GL_DEPTH_BUFFER_BIT);
 }
 
 //-----------------------------------------------------------------------------------
@@ -680,19 +732,18 @@ void Renderer::UseShaderProgram(GLuint shaderProgramID)
     {
         return;
     }
-    glUseProgram(shaderProgramID);
+    RenderBackend::instance->UseProgram(shaderProgramID);
     m_currentShaderProgramId = shaderProgramID;
 }
 
 //-----------------------------------------------------------------------------------
 GLuint Renderer::CreateRenderBuffer(size_t size, void* data /*= nullptr*/)
 {
-    GLuint uboid;
-    glGenBuffers(1, &uboid);
+    GLuint uboid = RenderBackend::instance->CreateBuffer();
     //TODO: This could be more reusable, pass in the usage and target to make new kinds of disgusting buffers <3
-    glBindBuffer(GL_UNIFORM_BUFFER, uboid);
-    glBufferData(GL_UNIFORM_BUFFER, size, data, GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    RenderBackend::instance->BindBuffer(GL_UNIFORM_BUFFER, uboid);
+    RenderBackend::instance->BufferData(GL_UNIFORM_BUFFER, size, data, GL_DYNAMIC_DRAW);
+    RenderBackend::instance->BindBuffer(GL_UNIFORM_BUFFER, 0);
     return uboid;
 }
 
@@ -700,24 +751,23 @@ GLuint Renderer::CreateRenderBuffer(size_t size, void* data /*= nullptr*/)
 void Renderer::BindUniform(unsigned int bindPoint, UniformBuffer& buffer)
 {
     buffer.CopyToGPU();
-    glBindBufferBase(GL_UNIFORM_BLOCK, bindPoint, buffer.m_bufferHandle);
+    RenderBackend::instance->BindBufferBase(GL_UNIFORM_BLOCK, bindPoint, buffer.m_bufferHandle);
 }
 
 //-----------------------------------------------------------------------------------
 void Renderer::UnbindIbo()
 {
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, NULL);
+    RenderBackend::instance->BindBuffer(GL_ELEMENT_ARRAY_BUFFER, NULL);
 }
 
 //-----------------------------------------------------------------------------------
 GLuint Renderer::RenderBufferCreate(void* data, size_t count, size_t elementSize, GLenum usage/* = GL_STATIC_DRAW*/)
 {
-    GLuint buffer;
-    glGenBuffers(1, &buffer);
+    GLuint buffer = RenderBackend::instance->CreateBuffer();
 
-    glBindBuffer(GL_ARRAY_BUFFER, buffer);
-    glBufferData(GL_ARRAY_BUFFER, count * elementSize, data, usage);
-    glBindBuffer(GL_ARRAY_BUFFER, NULL);
+    RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, buffer);
+    RenderBackend::instance->BufferData(GL_ARRAY_BUFFER, count * elementSize, data, usage);
+    RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, NULL);
 
     #if defined(TRACK_MEMORY)
         g_memoryAnalytics.TrackRenderBufferAllocation();
@@ -729,7 +779,7 @@ GLuint Renderer::RenderBufferCreate(void* data, size_t count, size_t elementSize
 //-----------------------------------------------------------------------------------
 void Renderer::RenderBufferDestroy(GLuint buffer)
 {
-    glDeleteBuffers(1, &buffer);
+    RenderBackend::instance->DeleteBuffer(buffer);
 
     #if defined(TRACK_MEMORY)
         g_memoryAnalytics.TrackRenderBufferFree();
@@ -742,28 +792,20 @@ int Renderer::CreateSampler(GLenum min_filter, //fragment counts for more than o
     GLenum uWrap, //If u is < 0 or > 1, how does it behave?
     GLenum vWrap) //Same, but for v
 {
-    GLuint id;
-    glGenSamplers(1, &id);
-
-    glSamplerParameteri(id, GL_TEXTURE_MIN_FILTER, min_filter);
-    glSamplerParameteri(id, GL_TEXTURE_MAG_FILTER, magFilter);
-    glSamplerParameteri(id, GL_TEXTURE_WRAP_S, uWrap); //For some reason, OpenGL refers to UV's as ST's
-    glSamplerParameteri(id, GL_TEXTURE_WRAP_T, vWrap);
-
-    return id;
+    return RenderBackend::instance->CreateSampler(min_filter, magFilter, uWrap, vWrap);
 }
 
 //-----------------------------------------------------------------------------------
 void Renderer::DeleteSampler(GLuint id)
 {
-    glDeleteSamplers(1, &id);
+    RenderBackend::instance->DeleteSampler(id);
 }
 
 //-----------------------------------------------------------------------------------
 void Renderer::GLCheckError(const char* file, size_t line)
 {
 #ifdef CHECK_GL_ERRORS
-    GLenum error = glGetError();
+    GLenum error = RenderBackend::instance->GetError();
     if (error != 0)
     {
         const char* errorText;
@@ -803,7 +845,7 @@ void Renderer::EnableFaceCulling(bool enabled)
     {
         return;
     }
-    enabled ? glEnable(GL_CULL_FACE) : glDisable(GL_CULL_FACE);
+    RenderBackend::instance->SetCapability(GL_CULL_FACE, enabled);
     m_faceCullingEnabled = enabled;
 }
 
@@ -1086,51 +1128,48 @@ void Renderer::SetRenderTargets(size_t colorCount, Texture** inColorTargets, Tex
 
     if (m_fboHandle == NULL)
     {
-        glGenFramebuffers(1, &m_fboHandle);
+        m_fboHandle = RenderBackend::instance->CreateFramebuffer();
         ASSERT_OR_DIE(m_fboHandle != NULL, "Failed to grab fbo handle");
     }
     
     //OpenGL initialization stuff
     //If you bound a framebuffer to your Renderer, be careful you didn't unbind just now...
-    glBindFramebuffer(GL_FRAMEBUFFER, m_fboHandle);
+    RenderBackend::instance->BindFramebuffer(GL_FRAMEBUFFER, m_fboHandle);
     Renderer::instance->SetViewport(0, 0, width, height);
 
     //Bind our color targets to our FBO
     for (uint32_t i = 0; i < colorCount; ++i)
     {
         Texture* tex = inColorTargets[i];
-        glFramebufferTexture(GL_FRAMEBUFFER, //What we're attaching
+        RenderBackend::instance->FramebufferTexture(GL_FRAMEBUFFER, //What we're attaching
             GL_COLOR_ATTACHMENT0 + i, //Where we're attaching
-            tex->m_openglTextureID, //OpenGL id
-            0); //Level - probably mipmap level
+            tex->m_openglTextureID); //OpenGL id
         GL_CHECK_ERROR();
     }
     //Bind all unused color targets to NULL
     for (uint32_t i = colorCount; i < MAX_NUM_RENDER_TARGETS; i++)
     {
-        glFramebufferTexture(GL_FRAMEBUFFER, //What we're attaching
+        RenderBackend::instance->FramebufferTexture(GL_FRAMEBUFFER, //What we're attaching
             GL_COLOR_ATTACHMENT0 + i, //Where we're attaching
-            NULL, //OpenGL id
-            0); //Level - probably mipmap level
+            NULL); //OpenGL id
         GL_CHECK_ERROR();
     }
 
     //Bind depth stencil if you have it.
     if (nullptr != depthStencilTarget)
     {
-        glFramebufferTexture(GL_FRAMEBUFFER,
+        RenderBackend::instance->FramebufferTexture(GL_FRAMEBUFFER,
             GL_DEPTH_STENCIL_ATTACHMENT,
-            depthStencilTarget->m_openglTextureID,
-            0);
+            depthStencilTarget->m_openglTextureID);
         GL_CHECK_ERROR();
     }
 
     //Make sure everything was bound correctly, no errors!
-    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    GLenum status = RenderBackend::instance->CheckFramebufferStatus(GL_FRAMEBUFFER);
     if (status != GL_FRAMEBUFFER_COMPLETE)
     {
-        glBindFramebuffer(GL_FRAMEBUFFER, NULL);
-        glDeleteFramebuffers(1, &m_fboHandle);
+        RenderBackend::instance->BindFramebuffer(GL_FRAMEBUFFER, NULL);
+        RenderBackend::instance->DeleteFramebuffer(m_fboHandle);
         ERROR_RECOVERABLE("Error occured while binding framebuffer");
     }
 }
@@ -1146,14 +1185,14 @@ void Renderer::BindFramebuffer(Framebuffer* fbo)
     m_fbo = fbo;
     if (fbo == nullptr)
     {
-        glBindFramebuffer(GL_FRAMEBUFFER, NULL);
+        RenderBackend::instance->BindFramebuffer(GL_FRAMEBUFFER, NULL);
 
         Renderer::instance->SetViewport(0, 0, m_windowSize.x, m_windowSize.y);
 
     }
     else
     {
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo->m_fboHandle);
+        RenderBackend::instance->BindFramebuffer(GL_FRAMEBUFFER, fbo->m_fboHandle);
         Renderer::instance->SetViewport(0, 0, fbo->m_pixelWidth, fbo->m_pixelHeight);
 
         GLenum renderTargets[32];
@@ -1163,7 +1202,7 @@ void Renderer::BindFramebuffer(Framebuffer* fbo)
             renderTargets[i] = GL_COLOR_ATTACHMENT0 + i;
         }
 
-        glDrawBuffers(fbo->m_colorCount, //How many
+        RenderBackend::instance->SetDrawBuffers(fbo->m_colorCount, //How many
             renderTargets); //What do they render to?
 
     }
@@ -1179,8 +1218,8 @@ void Renderer::FrameBufferCopyToBack(Framebuffer* fbo, uint32_t drawingWidth, ui
     }
 
     GLuint fboHandle = fbo->m_fboHandle;
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, fboHandle);
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, NULL);
+    RenderBackend::instance->BindFramebuffer(GL_READ_FRAMEBUFFER, fboHandle);
+    RenderBackend::instance->BindFramebuffer(GL_DRAW_FRAMEBUFFER, NULL);
 
     uint32_t readWidth = fbo->m_pixelWidth;
     uint32_t readHeight = fbo->m_pixelHeight;
@@ -1188,7 +1227,7 @@ void Renderer::FrameBufferCopyToBack(Framebuffer* fbo, uint32_t drawingWidth, ui
     uint32_t topRightX = bottomLeftX + drawingWidth;
     uint32_t topRightY = bottomLeftY + drawingHeight;
 
-    glBlitFramebuffer(0, 0, //Lower left corner pixel of the read buffer
+    RenderBackend::instance->BlitFramebuffer(0, 0, //Lower left corner pixel of the read buffer
         readWidth, readHeight, //Top right corner pixel
         bottomLeftX, bottomLeftY, //lower left corner pixel
         topRightX, topRightY, //top right pixel of read buffer
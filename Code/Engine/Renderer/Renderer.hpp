@@ -30,6 +30,7 @@ class Material;
 class MeshRenderer;
 class Framebuffer;
 class TextBox;
+class RenderBackend;
 struct Vertex_PCT;
 struct Vertex_PCUTB;
 
@@ -57,9 +58,25 @@ public:
     typedef unsigned int GLenum;
     typedef bool GLboolean;
 
+    //STRUCTS//////////////////////////////////////////////////////////////////////////
+    struct StateCache //Everything the renderer skips redundant calls for
+    {
+        RenderState::BlendMode blendMode;
+        bool faceCullingEnabled;
+        bool depthTestingEnabled;
+        bool depthWritingEnabled;
+        float lineWidth;
+        float pointSize;
+        GLint viewportX;
+        GLint viewportY;
+        GLsizei viewportWidth;
+        GLsizei viewportHeight;
+        GLuint currentShaderProgramId;
+    };
+
 
     //CONSTRUCTORS//////////////////////////////////////////////////////////////////////////
-    Renderer(const Vector2Int& windowSize);
+    Renderer(const Vector2Int& windowSize, RenderBackend* backend = nullptr); //Takes ownership of the backend, OpenGL if null
     ~Renderer();
 
     //FUNCTIONS//////////////////////////////////////////////////////////////////////////
@@ -96,6 +113,8 @@ public:
     void SetViewport(GLint x, GLint y, GLsizei width, GLsizei height);
     void SetPointSize(float size);
     void SetLineWidth(float width);
+    RenderBackend* BeginBackendOverride(RenderBackend* backend); //Returns the backend to hand back to EndBackendOverride
+    void EndBackendOverride(RenderBackend* previousBackend); //Puts the state caches back to what the real backend last saw
 
     //BUFFERS//////////////////////////////////////////////////////////////////////////
     int GenerateBufferID();
@@ -165,6 +184,7 @@ public:
     MatrixStack4x4 m_projStack;
     MatrixStack4x4 m_viewStack;
     RenderState::BlendMode m_blendMode;
+    RenderBackend* m_backend;
     Vector2Int m_windowSize;
     bool m_faceCullingEnabled;
     bool m_depthTestingEnabled;
@@ -177,4 +197,6 @@ public:
     GLsizei m_viewportHeight = 0;
     GLuint m_fboHandle = NULL;
     GLuint m_currentShaderProgramId = NULL;
+    StateCache m_overriddenStateCache;
+    bool m_isBackendOverridden = false;
 };
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Input/InputOutputUtils.hpp"
 #include "Engine/Renderer/OpenGLExtensions.hpp"
+#include "Engine/Renderer/RenderBackend.hpp"
 #include "Engine/Core/BuildConfig.hpp"
 #include "Engine/Core/Memory/MemoryTracking.hpp"
 #include "..\Math\Vector2.hpp"
@@ -15,11 +16,24 @@
 #include "Renderer.hpp"
 #include "../Core/ProfilingUtils.h"
 
+std::map<size_t, unsigned int> ShaderProgram::s_uniformNameIds;
+unsigned int ShaderProgram::s_boundGeneration = 0;
+
+//-----------------------------------------------------------------------------------
+UniformName::UniformName(const char* name)
+    : id(ShaderProgram::GetUniformNameId(name))
+{
+
+}
+
 //-----------------------------------------------------------------------------------
 ShaderProgram::ShaderProgram()
     : m_vertexShaderID(0)
     , m_fragmentShaderID(0)
     , m_shaderProgramID(0)
+    , m_parameterBlockSize(0)
+    , m_lastBoundMaterial(nullptr)
+    , m_boundGeneration(s_boundGeneration)
 {
 
 }
@@ -29,6 +43,9 @@ ShaderProgram::ShaderProgram(const char* vertShaderPath, const char* fragShaderP
     : m_vertexShaderID(LoadShader(vertShaderPath, GL_VERTEX_SHADER))
     , m_fragmentShaderID(LoadShader(fragShaderPath, GL_FRAGMENT_SHADER))
     , m_shaderProgramID(CreateAndLinkProgram(m_vertexShaderID, m_fragmentShaderID))
+    , m_parameterBlockSize(0)
+    , m_lastBoundMaterial(nullptr)
+    , m_boundGeneration(s_boundGeneration)
 {
     FindAllAttributes();
     FindAllUniforms();
@@ -42,9 +59,9 @@ ShaderProgram::ShaderProgram(const char* vertShaderPath, const char* fragShaderP
 //-----------------------------------------------------------------------------------
 ShaderProgram::~ShaderProgram()
 {
-    glDeleteShader(m_vertexShaderID);
-    glDeleteShader(m_fragmentShaderID);
-    glDeleteProgram(m_shaderProgramID);
+    RenderBackend::instance->DeleteShader(m_vertexShaderID);
+    RenderBackend::instance->DeleteShader(m_fragmentShaderID);
+    RenderBackend::instance->DeleteProgram(m_shaderProgramID);
     #if defined(TRACK_MEMORY)
         g_memoryAnalytics.TrackShaderFree();
     #endif
@@ -84,27 +101,13 @@ GLuint ShaderProgram::LoadShader(const char* filename, GLenum shaderType)
 //-----------------------------------------------------------------------------------
 GLuint ShaderProgram::LoadShaderFromString(const char* shaderCode, GLuint shaderType, const char* filename)
 {
-    GLuint shader_id = glCreateShader(shaderType);
+    GLuint shader_id = RenderBackend::instance->CreateShader(shaderType);
     ASSERT_OR_DIE(shader_id != NULL, "Failed to create shader");
 
-    GLint src_length = strlen(shaderCode);
-    glShaderSource(shader_id, 1, &shaderCode, &src_length);
-
-    glCompileShader(shader_id);
-
-    GLint status;
-    glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status);
-    if (GL_FALSE == status)
+    std::string bufferString;
+    if (!RenderBackend::instance->CompileShader(shader_id, shaderCode, bufferString))
     {
-        GLint logLength;
-        glGetShaderiv(shader_id, GL_INFO_LOG_LENGTH, &logLength);
-
-        char *buffer = new char[logLength + 1];
-        glGetShaderInfoLog(shader_id, logLength, &logLength, buffer);
-
-        buffer[logLength] = '\0'; //or NULL
-        glDeleteShader(shader_id);
-        std::string bufferString(buffer);
+        RenderBackend::instance->DeleteShader(shader_id);
 
         //Get the full path
         char filePath[_MAX_PATH];
@@ -128,9 +131,7 @@ GLuint ShaderProgram::LoadShaderFromString(const char* shaderCode, GLuint shader
         delete inParenthesis;
         DebuggerPrintf("%s(%d): %s", filePath, lineNumber, formattedErrorString.c_str());
 
-        const char* glVersion = (const char*)glGetString(GL_VERSION);
-        const char* glslVersion = (const char*)glGetString(GL_SHADING_LANGUAGE_VERSION);
-        ERROR_AND_DIE(Stringf("%s\nIn file: %s\nOn line: %i \n\n %s \nOpenGL version: %s\nGLSL version: %s", formattedErrorString.c_str(), filename, lineNumber, buffer, glVersion, glslVersion));
+        ERROR_AND_DIE(Stringf("%s\nIn file: %s\nOn line: %i \n\n %s \n%s", formattedErrorString.c_str(), filename, lineNumber, bufferString.c_str(), RenderBackend::instance->GetVersionString().c_str()));
     }
 
     //Todo: print errors if failed
@@ -141,28 +142,14 @@ GLuint ShaderProgram::LoadShaderFromString(const char* shaderCode, GLuint shader
 //-----------------------------------------------------------------------------------
 GLuint ShaderProgram::CreateAndLinkProgram(GLuint vertexShader, GLuint fragmentShader)
 {
-    GLuint program_id = glCreateProgram();
+    GLuint program_id = RenderBackend::instance->CreateProgram();
     ASSERT_OR_DIE(program_id != NULL, "Failed to create shader program");
 
-    glAttachShader(program_id, vertexShader);
-    glAttachShader(program_id, fragmentShader);
-
-    glLinkProgram(program_id);
-
-    GLint status;
-    //Get iv gets a 'v'ariable amount of 'i'ntegers
-    glGetProgramiv(program_id, GL_LINK_STATUS, &status);
-    if (status == GL_FALSE)
+    //Detaches the shaders on success, letting OpenGL clean up video memory for them
+    std::string bufferString;
+    if (!RenderBackend::instance->LinkProgram(program_id, vertexShader, fragmentShader, bufferString))
     {
-        GLint logLength;
-        glGetProgramiv(program_id, GL_INFO_LOG_LENGTH, &logLength);
-
-        char *buffer = new char[logLength + 1];
-        glGetProgramInfoLog(program_id, logLength, &logLength, buffer);
-
-        buffer[logLength] = '\0'; //or NULL
-        glDeleteShader(program_id);
-        std::string bufferString(buffer);
+        RenderBackend::instance->DeleteProgram(program_id);
 
         std::size_t firstSemicolon = bufferString.find(":");
         std::size_t secondSemicolon = bufferString.find(":", firstSemicolon + 1, 1);
@@ -173,15 +160,7 @@ GLuint ShaderProgram::CreateAndLinkProgram(GLuint vertexShader, GLuint fragmentS
         delete inParenthesis;
         DebuggerPrintf("(%d): %s", lineNumber, formattedErrorString.c_str());
 
-        const char* glVersion = (const char*)glGetString(GL_VERSION);
-        const char* glslVersion = (const char*)glGetString(GL_SHADING_LANGUAGE_VERSION);
-        ERROR_AND_DIE(Stringf("%s\nOn line: %i \n\n %s \nOpenGL version: %s\nGLSL version: %s", formattedErrorString.c_str(), lineNumber, buffer, glVersion, glslVersion));
-    }
-    else
-    {
-        //Success! Let OpenGL clean up video memory for the shaders
-        glDetachShader(program_id, vertexShader);
-        glDetachShader(program_id, fragmentShader);
+        ERROR_AND_DIE(Stringf("%s\nOn line: %i \n\n %s \n%s", formattedErrorString.c_str(), lineNumber, bufferString.c_str(), RenderBackend::instance->GetVersionString().c_str()));
     }
 
     return program_id;
@@ -201,13 +180,12 @@ void ShaderProgram::ShaderProgramBindProperty(size_t hashedName, GLint count, GL
 
     if (property >= 0)
     {
-        glEnableVertexAttribArray(property);
-        glVertexAttribPointer(property, //Bind point to shader
+        RenderBackend::instance->SetVertexAttribute(property, //Bind point to shader
             count, //Number of data elements passed
             type, //Type of Data
             normalize, //normalize the data for us
             stride, //stride
-            (GLvoid*)offset //From that point in memory, how far do we have to go to get the value?
+            offset //From that point in memory, how far do we have to go to get the value?
             );
     }
 }
@@ -224,12 +202,11 @@ void ShaderProgram::ShaderProgramBindIntegerProperty(size_t hashedName,  GLint c
     //GLint property = glGetAttribLocation(m_shaderProgramID, name);
     if (property >= 0)
     {
-        glEnableVertexAttribArray(property);
-        glVertexAttribIPointer(property, //Bind point to shader
+        RenderBackend::instance->SetIntegerVertexAttribute(property, //Bind point to shader
             count, //Number of data elements passed
             type, //Type of Data
             stride, //stride
-            (GLvoid*)offset //From that point in memory, how far do we have to go to get the value?
+            offset //From that point in memory, how far do we have to go to get the value?
             );
     }
 }
@@ -237,119 +214,183 @@ void ShaderProgram::ShaderProgramBindIntegerProperty(size_t hashedName,  GLint c
 //-----------------------------------------------------------------------------------
 void ShaderProgram::FindAllAttributes()
 {
-    GLint numberOfActiveAttributes;
-    glGetProgramiv(m_shaderProgramID, GL_ACTIVE_ATTRIBUTES, &numberOfActiveAttributes);
-    GLint maxNameLength;
-    glGetProgramiv(m_shaderProgramID, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxNameLength);
-    for (int index = 0; index < numberOfActiveAttributes; index++)
+    std::vector<RenderBackend::ShaderVariable> attributes;
+    RenderBackend::instance->GetActiveAttributes(m_shaderProgramID, attributes);
+    for (const RenderBackend::ShaderVariable& attribute : attributes)
     {
-        GLint size;
-        GLenum type;
-        char* nameBuffer = new char[maxNameLength];
-        glGetActiveAttrib(m_shaderProgramID, index, maxNameLength, NULL, &size, &type, nameBuffer);
-        m_attributes[std::hash<std::string>{}(nameBuffer)] = glGetAttribLocation(m_shaderProgramID, nameBuffer);
-        delete nameBuffer;
+        m_attributes[std::hash<std::string>{}(attribute.name)] = attribute.location;
     }
 }
 
 //-----------------------------------------------------------------------------------
 void ShaderProgram::FindAllUniforms()
 {
-    GLint numberOfActiveUniforms;
-    glGetProgramiv(m_shaderProgramID, GL_ACTIVE_UNIFORMS, &numberOfActiveUniforms);
-    GLint maxNameLength;
-    glGetProgramiv(m_shaderProgramID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
-    for (int index = 0; index < numberOfActiveUniforms; index++)
+    std::vector<RenderBackend::ShaderVariable> uniforms;
+    RenderBackend::instance->GetActiveUniforms(m_shaderProgramID, uniforms);
+    m_uniformLayout.clear();
+    m_uniformSlots.clear();
+    m_slotsByNameId.clear();
+    m_parameterBlockSize = 0;
+    for (const RenderBackend::ShaderVariable& variable : uniforms)
     {
         Uniform uniform;
-        GLint size;
-        GLenum type;
-        char* nameBuffer = new char[maxNameLength];
-        glGetActiveUniform(m_shaderProgramID, index, maxNameLength, NULL, &size, &type, nameBuffer);
-        uniform.name = std::string(nameBuffer);
-        switch (type)
+        uniform.name = variable.name;
+        uniform.type = variable.type;
+        uniform.size = variable.size;
+        uniform.bindPoint = variable.location;
+        uniform.textureIndex = 0;
+        uniform.dataOffset = m_parameterBlockSize;
+        switch (uniform.type)
         {
-        case GL_SAMPLER_2D:
-            uniform.type = Uniform::DataType::SAMPLER_2D;
-            break;
-        case GL_FLOAT_MAT4:
-            uniform.type = Uniform::DataType::MATRIX_4X4;
+        case Uniform::DataType::MATRIX_4X4:
+            uniform.dataSize = 16 * sizeof(float);
             break;
-        case GL_FLOAT_VEC4:
-            uniform.type = Uniform::DataType::VECTOR4;
+        case Uniform::DataType::VECTOR4:
+            uniform.dataSize = 4 * sizeof(float);
             break;
-        case GL_FLOAT_VEC3:
-            uniform.type = Uniform::DataType::VECTOR3;
+        case Uniform::DataType::VECTOR3:
+            uniform.dataSize = 3 * sizeof(float);
             break;
-        case GL_FLOAT_VEC2:
-            uniform.type = Uniform::DataType::VECTOR2;
+        case Uniform::DataType::VECTOR2:
+            uniform.dataSize = 2 * sizeof(float);
             break;
-        case GL_FLOAT:
-            uniform.type = Uniform::DataType::FLOAT;
+        case Uniform::DataType::FLOAT:
+            uniform.dataSize = sizeof(float);
             break;
-        case GL_INT:
-            uniform.type = Uniform::DataType::INT;
+        case Uniform::DataType::SAMPLER_2D:
+        case Uniform::DataType::INT:
+            uniform.dataSize = sizeof(int);
             break;
         default:
-            ERROR_RECOVERABLE(Stringf("0x%x was given as a uniform type, but it wasn't found (add support for it as a uniform data type!)", type));
+            uniform.dataSize = 0;
             break;
         }
-        uniform.size = size;
-        uniform.bindPoint = index;
-        uniform.textureIndex = 0;
-        size_t hashIndex = std::hash<std::string>{}(uniform.name);
-        m_uniforms[hashIndex] = uniform;
-        delete nameBuffer;
+        m_parameterBlockSize += uniform.dataSize;
+
+        //Arrays are reported by their first element, but get set by their plain name.
+        unsigned int slot = m_uniformLayout.size();
+        std::vector<std::string> names(1, uniform.name);
+        size_t arrayStart = uniform.name.find("[0]");
+        if (arrayStart != std::string::npos)
+        {
+            names.push_back(uniform.name.substr(0, arrayStart));
+        }
+        for (const std::string& name : names)
+        {
+            m_uniformSlots[std::hash<std::string>{}(name)] = slot;
+            unsigned int nameId = GetUniformNameId(name);
+            if (nameId >= m_slotsByNameId.size())
+            {
+                m_slotsByNameId.resize(nameId + 1, -1);
+            }
+            m_slotsByNameId[nameId] = (int)slot;
+        }
+        m_uniformLayout.push_back(uniform);
     }
+    ASSERT_OR_DIE(m_uniformLayout.size() <= MAX_UNIFORM_SLOTS, Stringf("Shader program has %u active uniforms, more than the %u slots materials can track", m_uniformLayout.size(), MAX_UNIFORM_SLOTS));
+    m_boundParameters.assign(m_parameterBlockSize, 0);
+    m_boundSlots.reset();
+    m_lastBoundMaterial = nullptr;
 }
 
 //-----------------------------------------------------------------------------------
 void ShaderProgram::BindUniformBuffer(const char* uniformBlockName, GLint bindPoint)
 {
-    GLuint blockIndex = glGetUniformBlockIndex(m_shaderProgramID, uniformBlockName);
-    glUniformBlockBinding(m_shaderProgramID, blockIndex, bindPoint);
+    RenderBackend::instance->BindUniformBlock(m_shaderProgramID, uniformBlockName, bindPoint);
 }
 
 //-----------------------------------------------------------------------------------
 GLint ShaderProgram::GetBindPoint(size_t hashedName)
 {
-    GLint bindPoint = -1;
-    auto iter = m_uniforms.find(hashedName);
-    if (iter != m_uniforms.end())
+    int slot = GetSlot(hashedName);
+    return slot >= 0 ? m_uniformLayout[slot].bindPoint : -1;
+}
+
+//-----------------------------------------------------------------------------------
+int ShaderProgram::GetSlot(size_t hashedName) const
+{
+    auto iter = m_uniformSlots.find(hashedName);
+    return iter != m_uniformSlots.end() ? (int)iter->second : -1;
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int ShaderProgram::GetUniformNameId(const std::string& name)
+{
+    size_t hashedName = std::hash<std::string>{}(name);
+    auto iter = s_uniformNameIds.find(hashedName);
+    if (iter != s_uniformNameIds.end())
     {
-        bindPoint = iter->second.bindPoint;
+        return iter->second;
     }
-    return bindPoint;
+    unsigned int nameId = s_uniformNameIds.size();
+    s_uniformNameIds[hashedName] = nameId;
+    return nameId;
 }
 
 //-----------------------------------------------------------------------------------
-bool ShaderProgram::SetUniform(size_t hashedName, void* value)
+unsigned int ShaderProgram::UploadParameters(const Material* material, const unsigned char* parameterBlock, const SlotMask& slotMask)
 {
-    Uniform* matchingUniform = nullptr;
-    auto iter = m_uniforms.find(hashedName);
-    if (iter != m_uniforms.end())
+    if (m_boundGeneration != s_boundGeneration)
     {
-        matchingUniform = &(iter->second);
+        m_boundSlots.reset();
+        m_lastBoundMaterial = nullptr;
+        m_boundGeneration = s_boundGeneration;
     }
-    else
+
+    //A slot only goes to the driver if it holds something different from what the program already has.
+    unsigned int numUploaded = 0;
+    unsigned int numSlots = m_uniformLayout.size();
+    for (unsigned int slot = 0; slot < numSlots; ++slot)
+    {
+        const Uniform& uniform = m_uniformLayout[slot];
+        if (!slotMask.test(slot) || uniform.dataSize == 0 || uniform.bindPoint < 0)
+        {
+            continue;
+        }
+        const unsigned char* value = parameterBlock + uniform.dataOffset;
+        unsigned char* boundValue = &m_boundParameters[uniform.dataOffset];
+        if (m_boundSlots.test(slot) && memcmp(value, boundValue, uniform.dataSize) == 0)
+        {
+            continue;
+        }
+        if (numUploaded == 0)
+        {
+            Renderer::instance->UseShaderProgram(m_shaderProgramID);
+        }
+        Uniform::DataType type = uniform.type == Uniform::DataType::SAMPLER_2D ? Uniform::DataType::INT : uniform.type;
+        RenderBackend::instance->SetUniform(uniform.bindPoint, type, 1, value);
+        memcpy(boundValue, value, uniform.dataSize);
+        m_boundSlots.set(slot);
+        ++numUploaded;
+    }
+    m_lastBoundMaterial = material;
+    return numUploaded;
+}
+
+//-----------------------------------------------------------------------------------
+bool ShaderProgram::SetUniform(size_t hashedName, void* value)
+{
+    int slot = GetSlot(hashedName);
+    if (slot < 0)
     {
         return false;
     }
+    const Uniform& matchingUniform = m_uniformLayout[slot];
 
-    switch (matchingUniform->type)
+    switch (matchingUniform.type)
     {
     case Uniform::DataType::MATRIX_4X4:
-        return SetMatrix4x4Uniform(matchingUniform->bindPoint, *static_cast<Matrix4x4*>(value));
+        return SetMatrix4x4Uniform(matchingUniform.bindPoint, *static_cast<Matrix4x4*>(value));
     case Uniform::DataType::VECTOR4:
-        return SetVec4Uniform(matchingUniform->bindPoint, *static_cast<Vector4*>(value));
+        return SetVec4Uniform(matchingUniform.bindPoint, *static_cast<Vector4*>(value));
     case Uniform::DataType::VECTOR3:
-        return SetVec3Uniform(matchingUniform->bindPoint, *static_cast<Vector3*>(value));
+        return SetVec3Uniform(matchingUniform.bindPoint, *static_cast<Vector3*>(value));
     case Uniform::DataType::VECTOR2:
-        return SetVec2Uniform(matchingUniform->bindPoint, *static_cast<Vector2*>(value));
+        return SetVec2Uniform(matchingUniform.bindPoint, *static_cast<Vector2*>(value));
     case Uniform::DataType::FLOAT:
-        return SetFloatUniform(matchingUniform->bindPoint, *static_cast<float*>(value));
+        return SetFloatUniform(matchingUniform.bindPoint, *static_cast<float*>(value));
     case Uniform::DataType::INT:
-        return SetIntUniform(matchingUniform->bindPoint, *static_cast<int*>(value));
+        return SetIntUniform(matchingUniform.bindPoint, *static_cast<int*>(value));
     default:
         break;
     }
@@ -357,218 +398,120 @@ bool ShaderProgram::SetUniform(size_t hashedName, void* value)
 }
 
 //-----------------------------------------------------------------------------------
-bool ShaderProgram::SetVec2Uniform(const char* name, const Vector2 &value)
+bool ShaderProgram::SetUniformImmediately(GLint bindPoint, Uniform::DataType type, GLsizei count, const void* value)
 {
     Renderer::instance->UseShaderProgram(m_shaderProgramID);
-    GLint loc = glGetUniformLocation(m_shaderProgramID, name);
-    if (loc >= 0)
+    if (bindPoint < 0)
     {
-        glUniform2fv(loc, 1, (GLfloat*)&value);
-        return true;
+        return false;
     }
-    return false;
+    RenderBackend::instance->SetUniform(bindPoint, type, count, value);
+
+    //Went around the materials, so none of what they last uploaded can be trusted anymore.
+    m_boundSlots.reset();
+    m_lastBoundMaterial = nullptr;
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+bool ShaderProgram::SetVec2Uniform(const char* name, const Vector2 &value)
+{
+    return SetUniformImmediately(GetBindPoint(std::hash<std::string>{}(name)), Uniform::DataType::VECTOR2, 1, &value);
 }
 
 //-----------------------------------------------------------------------------------
 bool ShaderProgram::SetVec2Uniform(GLint bindPoint, const Vector2& value)
 {
-    Renderer::instance->UseShaderProgram(m_shaderProgramID);
-    if (bindPoint >= 0)
-    {
-        glUniform2fv(bindPoint, 1, (GLfloat*)&value);
-        return true;
-    }
-    return false;
+    return SetUniformImmediately(bindPoint, Uniform::DataType::VECTOR2, 1, &value);
 }
 
 //-----------------------------------------------------------------------------------
 bool ShaderProgram::SetVec3Uniform(const char *name, const Vector3& value, unsigned int numElements)
 {
-    Renderer::instance->UseShaderProgram(m_shaderProgramID);
     //"THIS IS A PROBLEM. This looks up the uniform location EVERY TIME, stalling out the pipeline."
-    GLint loc = glGetUniformLocation(m_shaderProgramID, name);
-    if (loc >= 0)
-    {
-        glUniform3fv(loc, numElements, (GLfloat*)&value);
-        return true;
-    }
-    return false;
+    return SetUniformImmediately(RenderBackend::instance->GetUniformLocation(m_shaderProgramID, name), Uniform::DataType::VECTOR3, numElements, &value);
 }
 
 //-----------------------------------------------------------------------------------
 bool ShaderProgram::SetVec3Uniform(const char *name, const Vector3 &value)
 {
-    Renderer::instance->UseShaderProgram(m_shaderProgramID);
-    //"THIS IS A PROBLEM. This looks up the uniform location EVERY TIME, stalling out the pipeline."
-    GLint loc = glGetUniformLocation(m_shaderProgramID, name);
-    if (loc >= 0)
-    {
-        glUniform3fv(loc, 1, (GLfloat*)&value);
-        return true;
-    }
-    return false;
+    return SetUniformImmediately(GetBindPoint(std::hash<std::string>{}(name)), Uniform::DataType::VECTOR3, 1, &value);
 }
 
 //-----------------------------------------------------------------------------------
 bool ShaderProgram::SetVec3Uniform(GLint bindPoint, const Vector3& value)
 {
-    Renderer::instance->UseShaderProgram(m_shaderProgramID);
-    if (bindPoint >= 0)
-    {
-        glUniform3fv(bindPoint, 1, (GLfloat*)&value);
-        return true;
-    }
-    return false;
+    return SetUniformImmediately(bindPoint, Uniform::DataType::VECTOR3, 1, &value);
 }
 
 //-----------------------------------------------------------------------------------
 bool ShaderProgram::SetVec4Uniform(const char *name, const Vector4 &value, unsigned int numElements)
 {
-    Renderer::instance->UseShaderProgram(m_shaderProgramID);
-    GLint loc = glGetUniformLocation(m_shaderProgramID, name);
-    if (loc >= 0)
-    {
-        glUniform4fv(loc, numElements, (GLfloat*)&value);
-        return true;
-    }
-    return false;
+    return SetUniformImmediately(RenderBackend::instance->GetUniformLocation(m_shaderProgramID, name), Uniform::DataType::VECTOR4, numElements, &value);
 }
 
 //-----------------------------------------------------------------------------------
 bool ShaderProgram::SetVec4Uniform(const char *name, const Vector4 &value)
 {
-    Renderer::instance->UseShaderProgram(m_shaderProgramID);
-    GLint loc = glGetUniformLocation(m_shaderProgramID, name);
-    if (loc >= 0)
-    {
-        glUniform4fv(loc, 1, (GLfloat*)&value);
-        return true;
-    }
-    return false;
+    return SetUniformImmediately(GetBindPoint(std::hash<std::string>{}(name)), Uniform::DataType::VECTOR4, 1, &value);
 }
 
 //-----------------------------------------------------------------------------------
 bool ShaderProgram::SetVec4Uniform(GLint bindPoint, const Vector4& value)
 {
-    Renderer::instance->UseShaderProgram(m_shaderProgramID);
-    if (bindPoint >= 0)
-    {
-        glUniform4fv(bindPoint, 1, (GLfloat*)&value);
-        return true;
-    }
-    return false;
+    return SetUniformImmediately(bindPoint, Uniform::DataType::VECTOR4, 1, &value);
 }
 
 //-----------------------------------------------------------------------------------
 bool ShaderProgram::SetMatrix4x4Uniform(const char* name, const Matrix4x4& value)
 {
-    Renderer::instance->UseShaderProgram(m_shaderProgramID);
-    GLint loc = glGetUniformLocation(m_shaderProgramID, name);
-    if (loc >= 0)
-    {
-        glUniformMatrix4fv(loc, 1, GL_FALSE, (GLfloat*)&value); //location, number of elements, do you want gl to transpose matrix?, matrix
-        return true;
-    }
-    return false;
+    return SetUniformImmediately(GetBindPoint(std::hash<std::string>{}(name)), Uniform::DataType::MATRIX_4X4, 1, &value);
 }
 
 //-----------------------------------------------------------------------------------
 bool ShaderProgram::SetMatrix4x4Uniform(const char* name, Matrix4x4& value, unsigned int numberOfElements)
 {
-    Renderer::instance->UseShaderProgram(m_shaderProgramID);
-    GLint loc = glGetUniformLocation(m_shaderProgramID, name);
-    if (loc >= 0)
-    {
-        glUniformMatrix4fv(loc, numberOfElements, GL_FALSE, (GLfloat*)&value); //location, number of elements, do you want gl to transpose matrix?, matrix
-        return true;
-    }
-    return false;
+    return SetUniformImmediately(RenderBackend::instance->GetUniformLocation(m_shaderProgramID, name), Uniform::DataType::MATRIX_4X4, numberOfElements, &value);
 }
 
 //-----------------------------------------------------------------------------------
 bool ShaderProgram::SetMatrix4x4Uniform(GLint bindPoint, const Matrix4x4& value)
 {
-    Renderer::instance->UseShaderProgram(m_shaderProgramID);
-    if (bindPoint >= 0)
-    {
-        glUniformMatrix4fv(bindPoint, 1, GL_FALSE, (GLfloat*)&value); //location, number of elements, do you want gl to transpose matrix?, matrix
-        return true;
-    }
-    return false;
+    return SetUniformImmediately(bindPoint, Uniform::DataType::MATRIX_4X4, 1, &value);
 }
 
 //-----------------------------------------------------------------------------------
 bool ShaderProgram::SetIntUniform(const char* name, int value, unsigned int arrayIndex)
 {
-    Renderer::instance->UseShaderProgram(m_shaderProgramID);
-    GLint loc = glGetUniformLocation(m_shaderProgramID, name);
-    if (loc >= 0)
-    {
-        glUniform1iv(loc, arrayIndex, (GLint*)&value); //location, number of elements, do you want gl to transpose matrix?, matrix
-        return true;
-    }
-    return false;
+    return SetUniformImmediately(RenderBackend::instance->GetUniformLocation(m_shaderProgramID, name), Uniform::DataType::INT, arrayIndex, &value);
 }
 
 //-----------------------------------------------------------------------------------
 bool ShaderProgram::SetIntUniform(const char* name, int value)
 {
-    Renderer::instance->UseShaderProgram(m_shaderProgramID);
-    GLint loc = glGetUniformLocation(m_shaderProgramID, name);
-    if (loc >= 0)
-    {
-        glUniform1iv(loc, 1, (GLint*)&value); //location, number of elements, do you want gl to transpose matrix?, matrix
-        return true;
-    }
-    return false;
+    return SetUniformImmediately(GetBindPoint(std::hash<std::string>{}(name)), Uniform::DataType::INT, 1, &value);
 }
 
 //-----------------------------------------------------------------------------------
 bool ShaderProgram::SetIntUniform(GLint bindPoint, int value)
 {
-    Renderer::instance->UseShaderProgram(m_shaderProgramID);
-    if (bindPoint >= 0)
-    {
-        glUniform1iv(bindPoint, 1, (GLint*)&value); //location, number of elements, do you want gl to transpose matrix?, matrix
-        return true;
-    }
-    return false;
+    return SetUniformImmediately(bindPoint, Uniform::DataType::INT, 1, &value);
 }
 
 //-----------------------------------------------------------------------------------
 bool ShaderProgram::SetFloatUniform(const char* name, float value, unsigned int arrayIndex)
 {
-    Renderer::instance->UseShaderProgram(m_shaderProgramID);
-    GLint loc = glGetUniformLocation(m_shaderProgramID, name);
-    if (loc >= 0)
-    {
-        glUniform1fv(loc, arrayIndex, (GLfloat*)&value); //location, number of elements, do you want gl to transpose matrix?, matrix
-        return true;
-    }
-    return false;
+    return SetUniformImmediately(RenderBackend::instance->GetUniformLocation(m_shaderProgramID, name), Uniform::DataType::FLOAT, arrayIndex, &value);
 }
 
 //-----------------------------------------------------------------------------------
 bool ShaderProgram::SetFloatUniform(const char* name, float value)
 {
-    Renderer::instance->UseShaderProgram(m_shaderProgramID);
-    GLint loc = glGetUniformLocation(m_shaderProgramID, name);
-    if (loc >= 0)
-    {
-        glUniform1fv(loc, 1, (GLfloat*)&value); //location, number of elements, do you want gl to transpose matrix?, matrix
-        return true;
-    }
-    return false;
+    return SetUniformImmediately(GetBindPoint(std::hash<std::string>{}(name)), Uniform::DataType::FLOAT, 1, &value);
 }
 
 //-----------------------------------------------------------------------------------
 bool ShaderProgram::SetFloatUniform(GLint bindPoint, float value)
 {
-    Renderer::instance->UseShaderProgram(m_shaderProgramID);
-    if (bindPoint >= 0)
-    {
-        glUniform1fv(bindPoint, 1, (GLfloat*)&value); //location, number of elements, do you want gl to transpose matrix?, matrix
-        return true;
-    }
-    return false;
-}
+    return SetUniformImmediately(bindPoint, Uniform::DataType::FLOAT, 1, &value);
+}
\ No newline at end of file
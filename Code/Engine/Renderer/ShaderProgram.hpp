@@ -2,11 +2,14 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <bitset>
+#include <stdint.h>
 
 class Vector2;
 class Vector3;
 class Vector4;
 class Matrix4x4;
+class Material;
 
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 struct Uniform
@@ -29,6 +32,17 @@ struct Uniform
     int bindPoint = -1;
     unsigned int size;
     unsigned int textureIndex;
+    unsigned int dataOffset = 0; //Into a material's parameter block
+    unsigned int dataSize = 0; //Of one element, 0 for types a material can't hold
+};
+
+//-----------------------------------------------------------------------------------
+// A uniform name interned once, so setting it every frame is an array index into the program's
+// layout instead of a string hash and a map search. Keep these static.
+struct UniformName
+{
+    explicit UniformName(const char* name);
+    unsigned int id;
 };
 
 //----------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -42,6 +56,10 @@ public:
     typedef unsigned int GLenum;
     typedef bool GLboolean;
 
+    //CONSTANTS//////////////////////////////////////////////////////////////////////////
+    static const unsigned int MAX_UNIFORM_SLOTS = 256; //Arrays take one slot, so no program should come close
+    typedef std::bitset<MAX_UNIFORM_SLOTS> SlotMask;
+
     //CONSTRUCTORS//////////////////////////////////////////////////////////////////////////
     ShaderProgram();
     ShaderProgram(const char* vertShaderPath, const char* fragShaderPath);
@@ -58,6 +76,12 @@ public:
     void FindAllUniforms();
     void BindUniformBuffer(const char* uniformBlockName, GLint bindPoint);
     GLint GetBindPoint(size_t hashedName);
+    inline int GetSlot(const UniformName& name) const { return name.id < m_slotsByNameId.size() ? m_slotsByNameId[name.id] : -1; };
+    int GetSlot(size_t hashedName) const;
+    unsigned int UploadParameters(const Material* material, const unsigned char* parameterBlock, const SlotMask& slotMask); //Returns how many slots actually needed setting
+    inline bool WasLastBoundBy(const Material* material) const { return m_lastBoundMaterial == material && m_boundGeneration == s_boundGeneration; };
+    static unsigned int GetUniformNameId(const std::string& name);
+    static inline void InvalidateAllBoundParameters() { ++s_boundGeneration; }; //For when uniforms were set somewhere that never reached the driver, like a swapped in backend
 
     //SETTING UNIFORMS/////////////////////////////////////////////////////////////////////
     bool SetUniform(size_t hashedName, void* value);
@@ -71,6 +95,7 @@ public:
 
     //DEPRECATED FUNCTIONS, AVOID USING:
     //These functions look up the bind point every time, and will be removed in the future.
+    //The array versions still ask the driver, since "name[i]" is never reflected.
     bool SetVec2Uniform(const char* name, const Vector2& value);
     bool SetVec3Uniform(const char* name, const Vector3& value);
     bool SetVec3Uniform(const char *name, const Vector3& value, unsigned int arrayIndex);
@@ -88,9 +113,22 @@ public:
     GLuint m_vertexShaderID;
     GLuint m_fragmentShaderID;
     GLuint m_shaderProgramID;
-    std::map<size_t, Uniform> m_uniforms;
+    std::vector<Uniform> m_uniformLayout; //Every active uniform, addressed by slot
+    std::map<size_t, unsigned int> m_uniformSlots; //Name hash to slot, for lookups that don't have a UniformName
     std::map<size_t, GLint> m_attributes;
+    unsigned int m_parameterBlockSize; //Bytes a material needs to hold a value for every slot
 
 private:
+    //PRIVATE FUNCTIONS/////////////////////////////////////////////////////////////////////
     ShaderProgram(const ShaderProgram&);
+    bool SetUniformImmediately(GLint bindPoint, Uniform::DataType type, GLsizei count, const void* value);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<int> m_slotsByNameId; //-1 where this program doesn't have the name
+    std::vector<unsigned char> m_boundParameters; //What each slot was last uploaded with
+    SlotMask m_boundSlots; //Which slots m_boundParameters can be trusted for
+    const Material* m_lastBoundMaterial;
+    unsigned int m_boundGeneration; //None of the above counts unless this matches s_boundGeneration
+    static std::map<size_t, unsigned int> s_uniformNameIds;
+    static unsigned int s_boundGeneration;
 };
\ No newline at end of file
@@ -10,6 +10,8 @@
 #include <gl/gl.h>
 #include <gl/GLU.h>
 #include "Engine/Renderer/OpenGLExtensions.hpp"
+#include "Engine/Renderer/RenderBackend.hpp"
+#include "Engine/Renderer/TextureLoader.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 
@@ -24,6 +26,11 @@ STATIC std::map<size_t, Texture*, std::less<size_t>, UntrackedAllocator<std::pai
 //-----------------------------------------------------------------------------------
 STATIC void Texture::CleanUpTextureRegistry()
 {
+    //Anything still loading has a request holding onto it.
+    if (TextureLoader::instance)
+    {
+        TextureLoader::instance->Flush();
+    }
     for (auto texturePair : s_textureRegistry)
     {
         delete texturePair.second;
@@ -38,40 +45,14 @@ Texture::Texture(const std::string& imageFilePath)
     , m_imageData(nullptr)
     , m_initializationMethod(TextureInitializationMethod::FROM_DISK)
     , m_textureFormat(TextureFormat::NUM_FORMATS)
+    , m_numColorComponents(0)
+    , m_isLoading(false)
 {
     int numComponents = 0; // Filled in for us to indicate how many color/alpha components the image had (e.g. 3=RGB, 4=RGBA)
     int numComponentsRequested = 0; // don't care; we support 3 (RGB) or 4 (RGBA)
     m_imageData = stbi_load( imageFilePath.c_str(), &m_texelSize.x, &m_texelSize.y, &numComponents, numComponentsRequested );
     ASSERT_OR_DIE(m_imageData != nullptr, Stringf("The texture at %s failed to load!", imageFilePath.c_str()));
-
-    // Enable texturing
-    //glEnable( GL_TEXTURE_2D );
-    GL_CHECK_ERROR();
-
-    // Tell OpenGL that our pixel data is single-byte aligned
-    glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
-    GL_CHECK_ERROR();
-
-    // Ask OpenGL for an unused texName (ID number) to use for this texture
-    glGenTextures( 1, (GLuint*) &m_openglTextureID );
-    GL_CHECK_ERROR();
-
-    // Tell OpenGL to bind (set) this as the currently active texture
-    glBindTexture( GL_TEXTURE_2D, m_openglTextureID );
-    GL_CHECK_ERROR();
-
-    // Set texture clamp vs. wrap (repeat)
-    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); // one of: GL_CLAMP or GL_REPEAT
-    GL_CHECK_ERROR();
-    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE); // one of: GL_CLAMP or GL_REPEAT
-    GL_CHECK_ERROR();
-
-
-    // Set magnification (texel > pixel) and minification (texel < pixel) filters
-    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST ); // one of: GL_NEAREST, GL_LINEAR
-    GL_CHECK_ERROR();
-    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );  // one of: GL_NEAREST, GL_LINEAR, GL_NEAREST_MIPMAP_NEAREST, GL_NEAREST_MIPMAP_LINEAR, GL_LINEAR_MIPMAP_NEAREST, GL_LINEAR_MIPMAP_LINEAR
-    GL_CHECK_ERROR();
+    m_numColorComponents = numComponents;
 
     GLenum bufferFormat = GL_RGBA; // the format our source pixel data is currently in; any of: GL_RGB, GL_RGBA, GL_LUMINANCE, GL_LUMINANCE_ALPHA, ...
     if (numComponents == 3)
@@ -83,19 +64,7 @@ Texture::Texture(const std::string& imageFilePath)
 
     GLenum internalFormat = bufferFormat; // the format we want the texture to me on the card; allows us to translate into a different texture format as we upload to OpenGL
 
-    glTexImage2D(			// Upload this pixel data to our new OpenGL texture
-        GL_TEXTURE_2D,		// Creating this as a 2d texture
-        0,					// Which mipmap level to use as the "root" (0 = the highest-quality, full-res image), if mipmaps are enabled
-        internalFormat,		// Type of texel format we want OpenGL to use for this texture internally on the video card
-        m_texelSize.x,		// Texel-width of image; for maximum compatibility, use 2^N + 2^B, where N is some integer in the range [3,10], and B is the border thickness [0,1]
-        m_texelSize.y,		// Texel-height of image; for maximum compatibility, use 2^M + 2^B, where M is some integer in the range [3,10], and B is the border thickness [0,1]
-        0,					// Border size, in texels (must be 0 or 1)
-        bufferFormat,		// Pixel format describing the composition of the pixel data in buffer
-        GL_UNSIGNED_BYTE,	// Pixel color components are unsigned bytes (one byte per color/alpha channel)
-        m_imageData );		// Location of the actual pixel data bytes/buffer
-    GL_CHECK_ERROR();
-
-    //glDisable(GL_TEXTURE_2D);
+    m_openglTextureID = RenderBackend::instance->CreateTexture2D(m_texelSize.x, m_texelSize.y, internalFormat, bufferFormat, GL_UNSIGNED_BYTE, m_imageData); //Single-byte aligned, clamped and nearest filtered
     GL_CHECK_ERROR();
 }
 
@@ -106,37 +75,11 @@ Texture::Texture(unsigned char* textureData, int numColorComponents, const Vecto
     , m_imageData(textureData)
     , m_initializationMethod(TextureInitializationMethod::FROM_MEMORY)
     , m_textureFormat(TextureFormat::NUM_FORMATS)
+    , m_numColorComponents(numColorComponents)
+    , m_isLoading(false)
 {
     int numComponents = numColorComponents; // Filled in for us to indicate how many color/alpha components the image had (e.g. 3=RGB, 4=RGBA)
 
-    // Enable texturing
-    //glEnable(GL_TEXTURE_2D);
-    GL_CHECK_ERROR();
-
-    // Tell OpenGL that our pixel data is single-byte aligned
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    GL_CHECK_ERROR();
-
-    // Ask OpenGL for an unused texName (ID number) to use for this texture
-    glGenTextures(1, (GLuint*)&m_openglTextureID);
-    GL_CHECK_ERROR();
-
-    // Tell OpenGL to bind (set) this as the currently active texture
-    glBindTexture(GL_TEXTURE_2D, m_openglTextureID);
-    GL_CHECK_ERROR();
-
-    // Set texture clamp vs. wrap (repeat)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); // one of: GL_CLAMP or GL_REPEAT
-    GL_CHECK_ERROR();
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE); // one of: GL_CLAMP or GL_REPEAT
-    GL_CHECK_ERROR();
-
-    // Set magnification (texel > pixel) and minification (texel < pixel) filters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST); // one of: GL_NEAREST, GL_LINEAR
-    GL_CHECK_ERROR();
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);  // one of: GL_NEAREST, GL_LINEAR, GL_NEAREST_MIPMAP_NEAREST, GL_NEAREST_MIPMAP_LINEAR, GL_LINEAR_MIPMAP_NEAREST, GL_LINEAR_MIPMAP_LINEAR
-    GL_CHECK_ERROR();
-
     GLenum bufferFormat = GL_RGBA; // the format our source pixel data is currently in; any of: GL_RGB, GL_RGBA, GL_LUMINANCE, GL_LUMINANCE_ALPHA, ...
     if (numComponents == 3)
         bufferFormat = GL_RGB;
@@ -145,19 +88,7 @@ Texture::Texture(unsigned char* textureData, int numColorComponents, const Vecto
 
     GLenum internalFormat = bufferFormat; // the format we want the texture to me on the card; allows us to translate into a different texture format as we upload to OpenGL
 
-    glTexImage2D(			// Upload this pixel data to our new OpenGL texture
-        GL_TEXTURE_2D,		// Creating this as a 2d texture
-        0,					// Which mipmap level to use as the "root" (0 = the highest-quality, full-res image), if mipmaps are enabled
-        internalFormat,		// Type of texel format we want OpenGL to use for this texture internally on the video card
-        m_texelSize.x,		// Texel-width of image; for maximum compatibility, use 2^N + 2^B, where N is some integer in the range [3,10], and B is the border thickness [0,1]
-        m_texelSize.y,		// Texel-height of image; for maximum compatibility, use 2^M + 2^B, where M is some integer in the range [3,10], and B is the border thickness [0,1]
-        0,					// Border size, in texels (must be 0 or 1)
-        bufferFormat,		// Pixel format describing the composition of the pixel data in buffer
-        GL_UNSIGNED_BYTE,	// Pixel color components are unsigned bytes (one byte per color/alpha channel)
-        m_imageData);		// Location of the actual pixel data bytes/buffer
-    GL_CHECK_ERROR();
-
-    //glDisable(GL_TEXTURE_2D);
+    m_openglTextureID = RenderBackend::instance->CreateTexture2D(m_texelSize.x, m_texelSize.y, internalFormat, bufferFormat, GL_UNSIGNED_BYTE, m_imageData); //Single-byte aligned, clamped and nearest filtered
     GL_CHECK_ERROR();
 }
 
@@ -165,8 +96,10 @@ Texture::Texture(uint32_t width, uint32_t height, TextureFormat format)
     : m_initializationMethod(TextureInitializationMethod::FROM_MEMORY)
     , m_texelSize(width, height)
     , m_textureFormat(format)
+    , m_imageData(nullptr)
+    , m_numColorComponents(0)
+    , m_isLoading(false)
 {
-    glGenTextures(1, &m_openglTextureID);
     GLenum bufferChannels = GL_RGBA;
     GLenum bufferFormat = GL_UNSIGNED_INT_8_8_8_8;
     GLenum internalFormat = GL_RGBA8;
@@ -192,16 +125,7 @@ Texture::Texture(uint32_t width, uint32_t height, TextureFormat format)
         ERROR_AND_DIE("Unsupported texture enum");
     }
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_openglTextureID);
-    glTexImage2D(GL_TEXTURE_2D,
-        0, //level - mipmaplevel, set to 0,
-        internalFormat, //How texture is stored in memory
-        width, height,
-        0, //border, again set to 0, we want not 0
-        bufferChannels, //channels used by image pass in
-        bufferFormat, //format of data of image passed in
-        NULL);	//no actual data passed in, defaults black/white
+    m_openglTextureID = RenderBackend::instance->CreateTexture2D(width, height, internalFormat, bufferChannels, bufferFormat, NULL); //No actual data passed in, defaults black/white
 
     GL_CHECK_ERROR();
 }
@@ -213,40 +137,14 @@ Texture::Texture(unsigned char* textureData, size_t bufferSize)
     , m_imageData(textureData)
     , m_initializationMethod(TextureInitializationMethod::FROM_MEMORY)
     , m_textureFormat(TextureFormat::NUM_FORMATS)
+    , m_numColorComponents(0)
+    , m_isLoading(false)
 {
     int numComponents = 0; // Filled in for us to indicate how many color/alpha components the image had (e.g. 3=RGB, 4=RGBA)
     int numComponentsRequested = 0; // don't care; we support 3 (RGB) or 4 (RGBA)
     m_imageData = stbi_load_from_memory(textureData, bufferSize, &m_texelSize.x, &m_texelSize.y, &numComponents, numComponentsRequested);
     ASSERT_OR_DIE(m_imageData != nullptr, "The texture failed to load!");
-
-    // Enable texturing
-    //glEnable(GL_TEXTURE_2D);
-    GL_CHECK_ERROR();
-
-    // Tell OpenGL that our pixel data is single-byte aligned
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    GL_CHECK_ERROR();
-
-    // Ask OpenGL for an unused texName (ID number) to use for this texture
-    glGenTextures(1, (GLuint*)&m_openglTextureID);
-    GL_CHECK_ERROR();
-
-    // Tell OpenGL to bind (set) this as the currently active texture
-    glBindTexture(GL_TEXTURE_2D, m_openglTextureID);
-    GL_CHECK_ERROR();
-
-    // Set texture clamp vs. wrap (repeat)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); // one of: GL_CLAMP or GL_REPEAT
-    GL_CHECK_ERROR();
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE); // one of: GL_CLAMP or GL_REPEAT
-    GL_CHECK_ERROR();
-
-    // Set magnification (texel > pixel) and minification (texel < pixel) filters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST); // one of: GL_NEAREST, GL_LINEAR
-    GL_CHECK_ERROR();
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);  // one of: GL_NEAREST, GL_LINEAR, GL_NEAREST_MIPMAP_NEAREST, GL_NEAREST_MIPMAP_LINEAR, GL_LINEAR_MIPMAP_NEAREST, GL_LINEAR_MIPMAP_LINEAR
-    GL_CHECK_ERROR();
+    m_numColorComponents = numComponents;
 
     GLenum bufferFormat = GL_RGBA; // the format our source pixel data is currently in; any of: GL_RGB, GL_RGBA, GL_LUMINANCE, GL_LUMINANCE_ALPHA, ...
     if (numComponents == 3)
@@ -258,19 +156,7 @@ Texture::Texture(unsigned char* textureData, size_t bufferSize)
 
     GLenum internalFormat = bufferFormat; // the format we want the texture to me on the card; allows us to translate into a different texture format as we upload to OpenGL
 
-    glTexImage2D(			// Upload this pixel data to our new OpenGL texture
-        GL_TEXTURE_2D,		// Creating this as a 2d texture
-        0,					// Which mipmap level to use as the "root" (0 = the highest-quality, full-res image), if mipmaps are enabled
-        internalFormat,		// Type of texel format we want OpenGL to use for this texture internally on the video card
-        m_texelSize.x,		// Texel-width of image; for maximum compatibility, use 2^N + 2^B, where N is some integer in the range [3,10], and B is the border thickness [0,1]
-        m_texelSize.y,		// Texel-height of image; for maximum compatibility, use 2^M + 2^B, where M is some integer in the range [3,10], and B is the border thickness [0,1]
-        0,					// Border size, in texels (must be 0 or 1)
-        bufferFormat,		// Pixel format describing the composition of the pixel data in buffer
-        GL_UNSIGNED_BYTE,	// Pixel color components are unsigned bytes (one byte per color/alpha channel)
-        m_imageData);		// Location of the actual pixel data bytes/buffer
-    GL_CHECK_ERROR();
-
-    //glDisable(GL_TEXTURE_2D);
+    m_openglTextureID = RenderBackend::instance->CreateTexture2D(m_texelSize.x, m_texelSize.y, internalFormat, bufferFormat, GL_UNSIGNED_BYTE, m_imageData); //Single-byte aligned, clamped and nearest filtered
     GL_CHECK_ERROR();
 }
 
@@ -283,7 +169,7 @@ unsigned char* Texture::GetImageData()
 //-----------------------------------------------------------------------------------
 Texture::~Texture()
 {
-    glDeleteTextures(1, &m_openglTextureID);
+    RenderBackend::instance->DeleteTexture(m_openglTextureID);
     if (m_imageData)
     {
         switch (m_initializationMethod)
@@ -342,6 +228,24 @@ STATIC Texture* Texture::CreateOrGetTexture(const std::string& imageFilePath)
     }
 }
 
+//-----------------------------------------------------------------------------------
+STATIC Texture* Texture::CreateOrGetTextureAsync(const std::string& imageFilePath)
+{
+    Texture* texture = GetTextureByName(imageFilePath);
+    if (texture != nullptr)
+    {
+        return texture;
+    }
+    if (!TextureLoader::instance)
+    {
+        return CreateOrGetTexture(imageFilePath);
+    }
+    texture = TextureLoader::instance->LoadAsync(imageFilePath);
+    size_t filePathHash = std::hash<std::string>{}(imageFilePath);
+    Texture::s_textureRegistry[filePathHash] = texture;
+    return texture;
+}
+
 //-----------------------------------------------------------------------------------
 void Texture::RegisterTexture(const std::string& textureName, Texture* texture)
 {
@@ -29,6 +29,7 @@ public:
     Texture(uint32_t width, uint32_t height, TextureFormat format);
     ~Texture();
     static Texture* CreateOrGetTexture(const std::string& imageFilePath);
+    static Texture* CreateOrGetTextureAsync(const std::string& imageFilePath); //A placeholder until TextureLoader::instance has it decoded and uploaded; synchronous without one
     static Texture* CreateTextureFromData(const std::string& textureName, unsigned char* textureData, int numComponents, const Vector2Int& texelSize);
     static Texture* CreateUnregisteredTextureFromImageFileData(unsigned char* textureData, size_t bufferLength);
     static void RegisterTexture(const std::string& textureName, Texture* texture); //If you create a texture by rendering to an FBO, save it here so we can delete it safely later.
@@ -37,6 +38,7 @@ public:
     //GETTERS//////////////////////////////////////////////////////////////////////////
     static Texture* GetTextureByName(const std::string& imageFilePath);
     unsigned char* GetImageData();
+    inline bool IsLoading() const { return m_isLoading; };
 
     //MEMBER VARIABLES//////////////////////////////////////////////////////////////////////////
     unsigned int m_openglTextureID;
@@ -44,6 +46,8 @@ public:
     TextureFormat m_textureFormat;
     TextureInitializationMethod m_initializationMethod;
     unsigned char* m_imageData;
+    int m_numColorComponents; //Of m_imageData, 0 if there isn't any
+    bool m_isLoading; //Still the 1x1 placeholder, size and image data aren't real yet
 
 private:
     Texture(const std::string& imageFilePath);
@@ -0,0 +1,536 @@
+#include "Engine/Renderer/TextureAtlas.hpp"
+#include "Engine/Renderer/Texture.hpp"
+#include "Engine/Renderer/RenderBackend.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Time/Time.hpp"
+#include <algorithm>
+#include <string.h>
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <gl/gl.h>
+
+//-----------------------------------------------------------------------------------
+SkylinePacker::SkylinePacker(int width, int height)
+    : m_width(width)
+    , m_height(height)
+    , m_usedArea(0)
+{
+    Clear();
+}
+
+//-----------------------------------------------------------------------------------
+SkylinePacker::~SkylinePacker()
+{
+
+}
+
+//-----------------------------------------------------------------------------------
+void SkylinePacker::Clear()
+{
+    m_skyline.clear();
+    SkylineSegment floor;
+    floor.x = 0;
+    floor.y = 0;
+    floor.width = m_width;
+    m_skyline.push_back(floor);
+    m_usedArea = 0;
+}
+
+//-----------------------------------------------------------------------------------
+int SkylinePacker::GetFitY(unsigned int segmentIndex, const Vector2Int& size) const
+{
+    int x = m_skyline[segmentIndex].x;
+    if (x + size.x > m_width)
+    {
+        return -1;
+    }
+
+    //Rest on the highest segment the rectangle spans.
+    int y = 0;
+    int widthLeft = size.x;
+    for (unsigned int i = segmentIndex; widthLeft > 0; ++i)
+    {
+        y = Max<int>(y, m_skyline[i].y);
+        if (y + size.y > m_height)
+        {
+            return -1;
+        }
+        widthLeft -= m_skyline[i].width;
+    }
+    return y;
+}
+
+//-----------------------------------------------------------------------------------
+bool SkylinePacker::Pack(const Vector2Int& size, Vector2Int& out_position)
+{
+    if (size.x <= 0 || size.y <= 0 || size.x > m_width || size.y > m_height)
+    {
+        return false;
+    }
+
+    //Lowest resulting top wins, ties go to the narrowest segment so wide gaps stay open for wide rectangles.
+    int bestIndex = -1;
+    int bestTop = m_height + 1;
+    int bestSegmentWidth = m_width + 1;
+    unsigned int numSegments = m_skyline.size();
+    for (unsigned int i = 0; i < numSegments; ++i)
+    {
+        int y = GetFitY(i, size);
+        if (y < 0)
+        {
+            continue;
+        }
+        int top = y + size.y;
+        if (top < bestTop || (top == bestTop && m_skyline[i].width < bestSegmentWidth))
+        {
+            bestIndex = (int)i;
+            bestTop = top;
+            bestSegmentWidth = m_skyline[i].width;
+        }
+    }
+    if (bestIndex < 0)
+    {
+        return false;
+    }
+    out_position = Vector2Int(m_skyline[bestIndex].x, bestTop - size.y);
+
+    //The new rectangle's top becomes a segment, and whatever it covers gets trimmed away.
+    SkylineSegment newSegment;
+    newSegment.x = out_position.x;
+    newSegment.y = bestTop;
+    newSegment.width = size.x;
+    m_skyline.insert(m_skyline.begin() + bestIndex, newSegment);
+    for (unsigned int i = bestIndex + 1; i < m_skyline.size();)
+    {
+        const SkylineSegment& previous = m_skyline[i - 1];
+        SkylineSegment& segment = m_skyline[i];
+        int overlap = (previous.x + previous.width) - segment.x;
+        if (overlap <= 0)
+        {
+            break;
+        }
+        segment.x += overlap;
+        segment.width -= overlap;
+        if (segment.width > 0)
+        {
+            break;
+        }
+        m_skyline.erase(m_skyline.begin() + i);
+    }
+    for (unsigned int i = 1; i < m_skyline.size();)
+    {
+        if (m_skyline[i - 1].y == m_skyline[i].y)
+        {
+            m_skyline[i - 1].width += m_skyline[i].width;
+            m_skyline.erase(m_skyline.begin() + i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+    m_usedArea += size.x * size.y;
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+TextureAtlas::TextureAtlas(const std::string& name, int pageSize /*= 2048*/, int padding /*= 2*/, bool extrudeEdges /*= true*/)
+    : m_name(name)
+    , m_numImages(0)
+    , m_numImagePixels(0)
+    , m_pageSize(pageSize)
+    , m_padding(padding)
+    , m_extrudeEdges(extrudeEdges)
+{
+
+}
+
+//-----------------------------------------------------------------------------------
+TextureAtlas::~TextureAtlas()
+{
+    Clear();
+}
+
+//-----------------------------------------------------------------------------------
+void TextureAtlas::Clear()
+{
+    for (AtlasPage* page : m_pages)
+    {
+        delete page->texture;
+        delete[] page->pixels;
+        delete page;
+    }
+    m_pages.clear();
+    m_numImages = 0;
+    m_numImagePixels = 0;
+}
+
+//-----------------------------------------------------------------------------------
+bool TextureAtlas::Insert(AtlasImage& image)
+{
+    AtlasPage* page = nullptr;
+    if (!PackWithoutUpload(image, page))
+    {
+        return false;
+    }
+    UploadDirtyRegion(*page);
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+void TextureAtlas::InsertBatch(std::vector<AtlasImage>& images)
+{
+    //Tallest first keeps the skyline flat, which is most of what makes a skyline pack tight.
+    std::vector<AtlasImage*> sortedImages;
+    sortedImages.reserve(images.size());
+    for (AtlasImage& image : images)
+    {
+        sortedImages.push_back(&image);
+    }
+    std::stable_sort(sortedImages.begin(), sortedImages.end(), [](const AtlasImage* first, const AtlasImage* second)
+    {
+        return first->size.y != second->size.y ? first->size.y > second->size.y : first->size.x > second->size.x;
+    });
+
+    AtlasPage* page = nullptr;
+    for (AtlasImage* image : sortedImages)
+    {
+        PackWithoutUpload(*image, page);
+    }
+    for (AtlasPage* dirtyPage : m_pages)
+    {
+        UploadDirtyRegion(*dirtyPage);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+bool TextureAtlas::InsertTexture(const Texture* texture, Texture*& out_pageTexture, AABB2& out_uvBounds)
+{
+    int numComponents = texture->m_numColorComponents;
+    if (!texture->m_imageData || (numComponents != 1 && numComponents != 3 && numComponents != 4))
+    {
+        return false;
+    }
+    AtlasImage image(texture->m_imageData, numComponents, texture->m_texelSize);
+    if (!Insert(image))
+    {
+        return false;
+    }
+    out_pageTexture = image.texture;
+    out_uvBounds = image.uvBounds;
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+bool TextureAtlas::OwnsTexture(const Texture* texture) const
+{
+    for (const AtlasPage* page : m_pages)
+    {
+        if (page->texture == texture)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//-----------------------------------------------------------------------------------
+AABB2 TextureAtlas::RemapUVs(const AABB2& uvs, const AABB2& atlasUVBounds)
+{
+    //Each corner on its own, so flipped bounds (the fonts keep theirs upside down) stay flipped.
+    Vector2 atlasSize(atlasUVBounds.maxs.x - atlasUVBounds.mins.x, atlasUVBounds.maxs.y - atlasUVBounds.mins.y);
+    Vector2 mins(atlasUVBounds.mins.x + uvs.mins.x * atlasSize.x, atlasUVBounds.mins.y + uvs.mins.y * atlasSize.y);
+    Vector2 maxs(atlasUVBounds.mins.x + uvs.maxs.x * atlasSize.x, atlasUVBounds.mins.y + uvs.maxs.y * atlasSize.y);
+    return AABB2(mins, maxs);
+}
+
+//-----------------------------------------------------------------------------------
+Texture* TextureAtlas::GetPageTexture(unsigned int pageIndex) const
+{
+    return pageIndex < m_pages.size() ? m_pages[pageIndex]->texture : nullptr;
+}
+
+//-----------------------------------------------------------------------------------
+float TextureAtlas::GetPackingEfficiency() const
+{
+    if (m_pages.empty())
+    {
+        return 0.0f;
+    }
+    double pageArea = (double)m_pageSize * (double)m_pageSize * (double)m_pages.size();
+    return (float)((double)m_numImagePixels / pageArea);
+}
+
+//-----------------------------------------------------------------------------------
+bool TextureAtlas::PackWithoutUpload(AtlasImage& image, AtlasPage*& out_page)
+{
+    image.wasPacked = false;
+    Vector2Int paddedSize(image.size.x + m_padding * 2, image.size.y + m_padding * 2);
+    if (image.size.x <= 0 || image.size.y <= 0 || paddedSize.x > m_pageSize || paddedSize.y > m_pageSize)
+    {
+        return false;
+    }
+
+    //Earlier pages still get a look, small images can often fill the gaps they left.
+    Vector2Int position;
+    AtlasPage* page = nullptr;
+    for (AtlasPage* existingPage : m_pages)
+    {
+        if (existingPage->packer.Pack(paddedSize, position))
+        {
+            page = existingPage;
+            break;
+        }
+    }
+    if (!page)
+    {
+        page = CreatePage();
+        bool didPack = page->packer.Pack(paddedSize, position);
+        ASSERT_OR_DIE(didPack, "An image that fits an empty atlas page failed to pack into one.");
+    }
+
+    CopyImageToPage(image, *page, position);
+    Vector2Int imageMins(position.x + m_padding, position.y + m_padding);
+    float pageSize = (float)m_pageSize;
+    image.texture = page->texture;
+    image.uvBounds = AABB2(Vector2((float)imageMins.x / pageSize, (float)imageMins.y / pageSize), Vector2((float)(imageMins.x + image.size.x) / pageSize, (float)(imageMins.y + image.size.y) / pageSize));
+    image.wasPacked = true;
+    ++m_numImages;
+    m_numImagePixels += (int64_t)image.size.x * (int64_t)image.size.y;
+    out_page = page;
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+TextureAtlas::AtlasPage* TextureAtlas::CreatePage()
+{
+    AtlasPage* page = new AtlasPage(m_pageSize);
+    size_t numBytes = (size_t)m_pageSize * (size_t)m_pageSize * 4;
+    page->pixels = new unsigned char[numBytes];
+    memset(page->pixels, 0, numBytes);
+    page->texture = new Texture(m_pageSize, m_pageSize, Texture::TextureFormat::RGBA8);
+    page->texture->m_imageData = page->pixels;
+    page->texture->m_numColorComponents = 4;
+
+    //A fresh texture's contents are undefined, so start it off transparent.
+    page->isDirty = true;
+    page->dirtyMins = Vector2Int(0, 0);
+    page->dirtyMaxs = Vector2Int(m_pageSize, m_pageSize);
+    UploadDirtyRegion(*page);
+    m_pages.push_back(page);
+    return page;
+}
+
+//-----------------------------------------------------------------------------------
+void TextureAtlas::CopyImageToPage(const AtlasImage& image, AtlasPage& page, const Vector2Int& position)
+{
+    const int pageStride = m_pageSize * 4;
+    const int imageX = position.x + m_padding;
+    const int imageY = position.y + m_padding;
+    const int numComponents = image.numColorComponents;
+    for (int row = 0; row < image.size.y; ++row)
+    {
+        const unsigned char* source = image.pixels + (size_t)row * (size_t)image.size.x * (size_t)numComponents;
+        unsigned char* destination = page.pixels + (size_t)(imageY + row) * pageStride + (size_t)imageX * 4;
+        if (numComponents == 4)
+        {
+            memcpy(destination, source, (size_t)image.size.x * 4);
+            continue;
+        }
+        for (int column = 0; column < image.size.x; ++column)
+        {
+            //Same as uploading the image on its own would give: missing channels are zero, missing alpha is opaque.
+            destination[0] = source[0];
+            destination[1] = numComponents >= 3 ? source[1] : 0;
+            destination[2] = numComponents >= 3 ? source[2] : 0;
+            destination[3] = 255;
+            source += numComponents;
+            destination += 4;
+        }
+    }
+
+    if (m_extrudeEdges && m_padding > 0)
+    {
+        //Stretch the edge columns out sideways, then the edge rows (corners included) up and down.
+        for (int row = 0; row < image.size.y; ++row)
+        {
+            unsigned char* rowStart = page.pixels + (size_t)(imageY + row) * pageStride;
+            const unsigned char* leftEdge = rowStart + (size_t)imageX * 4;
+            const unsigned char* rightEdge = rowStart + (size_t)(imageX + image.size.x - 1) * 4;
+            for (int i = 1; i <= m_padding; ++i)
+            {
+                memcpy(rowStart + (size_t)(imageX - i) * 4, leftEdge, 4);
+                memcpy(rowStart + (size_t)(imageX + image.size.x - 1 + i) * 4, rightEdge, 4);
+            }
+        }
+        size_t paddedRowBytes = (size_t)(image.size.x + m_padding * 2) * 4;
+        const unsigned char* topEdge = page.pixels + (size_t)imageY * pageStride + (size_t)position.x * 4;
+        const unsigned char* bottomEdge = page.pixels + (size_t)(imageY + image.size.y - 1) * pageStride + (size_t)position.x * 4;
+        for (int i = 1; i <= m_padding; ++i)
+        {
+            memcpy(page.pixels + (size_t)(imageY - i) * pageStride + (size_t)position.x * 4, topEdge, paddedRowBytes);
+            memcpy(page.pixels + (size_t)(imageY + image.size.y - 1 + i) * pageStride + (size_t)position.x * 4, bottomEdge, paddedRowBytes);
+        }
+    }
+
+    Vector2Int paddedMaxs(position.x + image.size.x + m_padding * 2, position.y + image.size.y + m_padding * 2);
+    if (page.isDirty)
+    {
+        page.dirtyMins = Vector2Int(Min<int>(page.dirtyMins.x, position.x), Min<int>(page.dirtyMins.y, position.y));
+        page.dirtyMaxs = Vector2Int(Max<int>(page.dirtyMaxs.x, paddedMaxs.x), Max<int>(page.dirtyMaxs.y, paddedMaxs.y));
+    }
+    else
+    {
+        page.dirtyMins = position;
+        page.dirtyMaxs = paddedMaxs;
+        page.isDirty = true;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void TextureAtlas::UploadDirtyRegion(AtlasPage& page)
+{
+    if (!page.isDirty)
+    {
+        return;
+    }
+    page.isDirty = false;
+
+    //The backend wants tightly packed rows, so anything narrower than the page goes through the scratch buffer.
+    int width = page.dirtyMaxs.x - page.dirtyMins.x;
+    int height = page.dirtyMaxs.y - page.dirtyMins.y;
+    const unsigned char* data = page.pixels + ((size_t)page.dirtyMins.y * m_pageSize + page.dirtyMins.x) * 4;
+    if (width != m_pageSize)
+    {
+        m_uploadScratch.resize((size_t)width * (size_t)height * 4);
+        for (int row = 0; row < height; ++row)
+        {
+            memcpy(&m_uploadScratch[(size_t)row * width * 4], data + (size_t)row * m_pageSize * 4, (size_t)width * 4);
+        }
+        data = m_uploadScratch.data();
+    }
+    RenderBackend::instance->UpdateTexture2D(page.texture->m_openglTextureID, page.dirtyMins.x, page.dirtyMins.y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data);
+}
+
+//-----------------------------------------------------------------------------------
+//Which texture every sprite, glyph and particle in a frame samples from, in the order they're drawn.
+static void CountTextureBinds(const std::vector<int>& drawOrder, const std::vector<int>& textureForImage, unsigned int& out_inOrderBinds, unsigned int& out_sortedBinds)
+{
+    out_inOrderBinds = 0;
+    int currentTexture = -1;
+    std::vector<bool> isUsed(*std::max_element(textureForImage.begin(), textureForImage.end()) + 1, false);
+    for (int imageIndex : drawOrder)
+    {
+        int texture = textureForImage[imageIndex];
+        if (texture != currentTexture)
+        {
+            ++out_inOrderBinds;
+            currentTexture = texture;
+        }
+        isUsed[texture] = true;
+    }
+    //Sorted by texture, the best a draw list can do is one bind per texture in use.
+    out_sortedBinds = (unsigned int)std::count(isUsed.begin(), isUsed.end(), true);
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(atlasbench)
+{
+    int numSprites = args.HasArgs(1) ? Max<int>(args.GetIntArgument(0), 1) : 400;
+    const int NUM_GLYPH_PAGES = 2;
+    const int NUM_PARTICLE_TEXTURES = 12;
+    const int PAGE_SIZE = 2048;
+    const int PADDING = 2;
+    const int NUM_DRAWS = 5000;
+
+    //A made up content set: mostly small sprites with a few big ones, a couple of font pages and some particle puffs.
+    std::vector<AtlasImage> images;
+    std::vector<unsigned char*> pixelBuffers;
+    for (int i = 0; i < numSprites + NUM_GLYPH_PAGES + NUM_PARTICLE_TEXTURES; ++i)
+    {
+        Vector2Int size;
+        int numComponents = 4;
+        if (i < numSprites)
+        {
+            int sizeClass = MathUtils::GetRandomIntFromZeroTo(20);
+            int maxSide = sizeClass < 14 ? 64 : (sizeClass < 19 ? 160 : 384);
+            int minSide = sizeClass < 14 ? 16 : (sizeClass < 19 ? 64 : 160);
+            size = Vector2Int(minSide + MathUtils::GetRandomIntFromZeroTo(maxSide - minSide), minSide + MathUtils::GetRandomIntFromZeroTo(maxSide - minSide));
+        }
+        else if (i < numSprites + NUM_GLYPH_PAGES)
+        {
+            size = Vector2Int(256, 256);
+            numComponents = 1;
+        }
+        else
+        {
+            int side = MathUtils::GetRandomIntFromZeroTo(2) == 0 ? 32 : 64;
+            size = Vector2Int(side, side);
+        }
+        size_t numBytes = (size_t)size.x * (size_t)size.y * numComponents;
+        unsigned char* pixels = new unsigned char[numBytes];
+        memset(pixels, (i * 37) & 0xFF, numBytes);
+        pixelBuffers.push_back(pixels);
+        images.push_back(AtlasImage(pixels, numComponents, size));
+    }
+    std::vector<AtlasImage> incrementalImages = images;
+
+    TextureAtlas batchAtlas("AtlasBenchBatch", PAGE_SIZE, PADDING);
+    double startSeconds = GetCurrentTimeSeconds();
+    batchAtlas.InsertBatch(images);
+    double batchSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+    TextureAtlas incrementalAtlas("AtlasBenchIncremental", PAGE_SIZE, PADDING);
+    startSeconds = GetCurrentTimeSeconds();
+    for (AtlasImage& image : incrementalImages)
+    {
+        incrementalAtlas.Insert(image);
+    }
+    double incrementalSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+    //A frame's worth of draws in scene order, each picking one of the images.
+    unsigned int numImages = images.size();
+    std::vector<int> drawOrder(NUM_DRAWS);
+    for (int i = 0; i < NUM_DRAWS; ++i)
+    {
+        drawOrder[i] = MathUtils::GetRandomIntFromZeroTo((int)numImages);
+    }
+    std::vector<int> ownTextures(numImages);
+    std::vector<int> batchPages(numImages);
+    unsigned int numLeftOut = 0;
+    for (unsigned int i = 0; i < numImages; ++i)
+    {
+        ownTextures[i] = (int)i;
+        //Anything too big for a page keeps a texture of its own, numbered past the pages.
+        batchPages[i] = (int)batchAtlas.GetNumPages() + (int)i;
+        for (unsigned int page = 0; page < batchAtlas.GetNumPages(); ++page)
+        {
+            if (images[i].wasPacked && images[i].texture == batchAtlas.GetPageTexture(page))
+            {
+                batchPages[i] = (int)page;
+            }
+        }
+        numLeftOut += images[i].wasPacked ? 0 : 1;
+    }
+    unsigned int inOrderBindsBefore, sortedBindsBefore, inOrderBindsAfter, sortedBindsAfter;
+    CountTextureBinds(drawOrder, ownTextures, inOrderBindsBefore, sortedBindsBefore);
+    CountTextureBinds(drawOrder, batchPages, inOrderBindsAfter, sortedBindsAfter);
+
+    for (unsigned char* pixels : pixelBuffers)
+    {
+        delete[] pixels;
+    }
+
+    Console::instance->PrintLine(Stringf("%u images (%i sprites, %i glyph pages, %i particle textures) into %ix%i pages, %i pixel padding:", numImages, numSprites, NUM_GLYPH_PAGES, NUM_PARTICLE_TEXTURES, PAGE_SIZE, PAGE_SIZE, PADDING), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("Batch, tallest first: %u pages, %.1f%% efficiency, %.3fms", batchAtlas.GetNumPages(), batchAtlas.GetPackingEfficiency() * 100.0f, batchSeconds * 1000.0), RGBA::GBWHITE);
+    Console::instance->PrintLine(Stringf("Incremental, as they arrive: %u pages, %.1f%% efficiency, %.3fms", incrementalAtlas.GetNumPages(), incrementalAtlas.GetPackingEfficiency() * 100.0f, incrementalSeconds * 1000.0), RGBA::GBWHITE);
+    Console::instance->PrintLine(Stringf("Texture binds for %i draws, in scene order: %u -> %u, sorted by texture: %u -> %u", NUM_DRAWS, inOrderBindsBefore, inOrderBindsAfter, sortedBindsBefore, sortedBindsAfter), RGBA::GBWHITE);
+    if (numLeftOut > 0)
+    {
+        Console::instance->PrintLine(Stringf("%u images were too big for a page and kept their own texture", numLeftOut), RGBA::GRAY);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,120 @@
+#pragma once
+#include "Engine/Math/Vector2Int.hpp"
+#include "Engine/Renderer/AABB2.hpp"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class Texture;
+
+//-----------------------------------------------------------------------------------
+// Skyline bottom-left rectangle packer. Only the top edge of everything placed so far is kept, as
+// a run of horizontal segments, and each new rectangle goes wherever its top ends up lowest.
+// Nothing is ever freed, which is what an atlas that only grows wants anyway.
+class SkylinePacker
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    SkylinePacker(int width, int height);
+    ~SkylinePacker();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    bool Pack(const Vector2Int& size, Vector2Int& out_position);
+    void Clear();
+    inline int GetUsedArea() const { return m_usedArea; };
+    inline int GetWidth() const { return m_width; };
+    inline int GetHeight() const { return m_height; };
+
+private:
+    //STRUCTS/////////////////////////////////////////////////////////////////////
+    struct SkylineSegment
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    //PRIVATE FUNCTIONS/////////////////////////////////////////////////////////////////////
+    int GetFitY(unsigned int segmentIndex, const Vector2Int& size) const; //-1 if it doesn't fit there
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<SkylineSegment> m_skyline;
+    int m_width;
+    int m_height;
+    int m_usedArea;
+};
+
+//-----------------------------------------------------------------------------------
+struct AtlasImage
+{
+    AtlasImage() : pixels(nullptr), numColorComponents(4), texture(nullptr), wasPacked(false) {};
+    AtlasImage(const unsigned char* pixels, int numColorComponents, const Vector2Int& size) : pixels(pixels), numColorComponents(numColorComponents), size(size), texture(nullptr), wasPacked(false) {};
+
+    const unsigned char* pixels; //Rows top to bottom, the way stbi loads them
+    int numColorComponents; //1, 3 or 4 bytes per pixel; red only images stay red only, like they'd upload
+    Vector2Int size;
+    Texture* texture; //Filled in with the page it landed on
+    AABB2 uvBounds;
+    bool wasPacked;
+};
+
+//-----------------------------------------------------------------------------------
+// Packs images into a few large RGBA8 pages, so sprites, glyph pages and particles that used to
+// have a texture each can share one and batch together. Every image gets a border of padding
+// pixels; with edge extrusion on (the default) the border repeats the image's outermost pixels,
+// so filtering and float error at the edges bleed into more of the same image rather than its
+// neighbour. Pages are created as needed and keep their pixels on the CPU, so images can be
+// added at any time: Insert() uploads just that rectangle, InsertBatch() sorts everything tallest
+// first for a tighter pack and uploads each touched page once at the end.
+class TextureAtlas
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    TextureAtlas(const std::string& name, int pageSize = 2048, int padding = 2, bool extrudeEdges = true);
+    ~TextureAtlas();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    bool Insert(AtlasImage& image);
+    void InsertBatch(std::vector<AtlasImage>& images);
+    bool InsertTexture(const Texture* texture, Texture*& out_pageTexture, AABB2& out_uvBounds); //Needs the texture's CPU side pixels
+    bool OwnsTexture(const Texture* texture) const;
+    void Clear();
+    static AABB2 RemapUVs(const AABB2& uvs, const AABB2& atlasUVBounds); //From [0,1] over the source image into its spot on the page
+
+    //GETTERS/////////////////////////////////////////////////////////////////////
+    inline unsigned int GetNumPages() const { return m_pages.size(); };
+    Texture* GetPageTexture(unsigned int pageIndex) const;
+    inline unsigned int GetNumImages() const { return m_numImages; };
+    float GetPackingEfficiency() const; //Image pixels over the area of every page so far, padding counts as waste
+    inline int GetPageSize() const { return m_pageSize; };
+
+private:
+    //STRUCTS/////////////////////////////////////////////////////////////////////
+    struct AtlasPage
+    {
+        AtlasPage(int pageSize) : texture(nullptr), pixels(nullptr), packer(pageSize, pageSize), isDirty(false) {};
+
+        Texture* texture;
+        unsigned char* pixels;
+        SkylinePacker packer;
+        Vector2Int dirtyMins;
+        Vector2Int dirtyMaxs;
+        bool isDirty;
+    };
+
+    //PRIVATE FUNCTIONS/////////////////////////////////////////////////////////////////////
+    bool PackWithoutUpload(AtlasImage& image, AtlasPage*& out_page);
+    AtlasPage* CreatePage();
+    void CopyImageToPage(const AtlasImage& image, AtlasPage& page, const Vector2Int& position);
+    void UploadDirtyRegion(AtlasPage& page);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<AtlasPage*> m_pages;
+    std::vector<unsigned char> m_uploadScratch;
+    std::string m_name;
+    unsigned int m_numImages;
+    int64_t m_numImagePixels;
+    int m_pageSize;
+    int m_padding;
+    bool m_extrudeEdges;
+};
\ No newline at end of file
@@ -0,0 +1,372 @@
+#include "Engine/Renderer/TextureLoader.hpp"
+#include "Engine/Renderer/Texture.hpp"
+#include "Engine/Renderer/RenderBackend.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Input/InputOutputUtils.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Time/Time.hpp"
+#include "ThirdParty/stb_image.h"
+#include <thread>
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <gl/gl.h>
+
+TextureLoader* TextureLoader::instance = nullptr;
+
+//-----------------------------------------------------------------------------------
+static GLenum GetBufferFormat(int numColorComponents)
+{
+    if (numColorComponents == 3)
+    {
+        return GL_RGB;
+    }
+    else if (numColorComponents == 1)
+    {
+        return GL_RED;
+    }
+    return GL_RGBA;
+}
+
+//-----------------------------------------------------------------------------------
+TextureLoader::TextureLoader(double uploadBudgetSeconds /*= 0.002*/)
+    : m_currentUpload(nullptr)
+    , m_numInFlight(0)
+    , m_numDecodeJobs(0)
+    , m_uploadBudgetSeconds(uploadBudgetSeconds)
+    , m_longestUpdateSeconds(0.0)
+    , m_totalDecodeSeconds(0.0)
+    , m_numDecodedBytes(0)
+    , m_numFinished(0)
+{
+
+}
+
+//-----------------------------------------------------------------------------------
+TextureLoader::~TextureLoader()
+{
+    Flush();
+    std::vector<unsigned char>* fileBuffer = m_fileBufferPool.Dequeue();
+    while (fileBuffer)
+    {
+        delete fileBuffer;
+        fileBuffer = m_fileBufferPool.Dequeue();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+Texture* TextureLoader::LoadAsync(const std::string& imageFilePath)
+{
+    static const unsigned char TRANSPARENT_TEXEL[4] = { 0, 0, 0, 0 };
+    Texture* texture = new Texture(1, 1, Texture::TextureFormat::RGBA8);
+    RenderBackend::instance->UpdateTexture2D(texture->m_openglTextureID, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, TRANSPARENT_TEXEL);
+    texture->m_isLoading = true;
+
+    TextureLoadRequest* request = new TextureLoadRequest();
+    request->texture = texture;
+    request->filePath = imageFilePath;
+    QueueRequest(request);
+    return texture;
+}
+
+//-----------------------------------------------------------------------------------
+void TextureLoader::DecodeAsync(const unsigned char* encodedData, size_t encodedSize)
+{
+    TextureLoadRequest* request = new TextureLoadRequest();
+    request->encodedData = encodedData;
+    request->encodedSize = encodedSize;
+    QueueRequest(request);
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int TextureLoader::Update()
+{
+    double startSeconds = GetCurrentTimeSeconds();
+    double deadlineSeconds = startSeconds + m_uploadBudgetSeconds;
+    unsigned int numFinished = 0;
+    do
+    {
+        if (!m_currentUpload)
+        {
+            m_currentUpload = m_decodedRequests.Dequeue();
+            if (!m_currentUpload)
+            {
+                break;
+            }
+        }
+        bool needsUpload = m_currentUpload->texture && m_currentUpload->didDecode;
+        if (needsUpload && !UploadRows(m_currentUpload, deadlineSeconds))
+        {
+            break;
+        }
+        FinishRequest(m_currentUpload);
+        m_currentUpload = nullptr;
+        ++numFinished;
+    } while (GetCurrentTimeSeconds() < deadlineSeconds);
+
+    //Finished decodes free up job slots for anything that's been waiting.
+    DispatchPendingRequests();
+    m_longestUpdateSeconds = Max<double>(m_longestUpdateSeconds, GetCurrentTimeSeconds() - startSeconds);
+    return numFinished;
+}
+
+//-----------------------------------------------------------------------------------
+void TextureLoader::Flush()
+{
+    double uploadBudgetSeconds = m_uploadBudgetSeconds;
+    m_uploadBudgetSeconds = 1000.0;
+    if (!JobSystem::instance)
+    {
+        //Everything was decoded as it was queued, so only the uploads are left.
+        Update();
+    }
+    else
+    {
+        //Pitch in on the decoding rather than sit waiting for the workers to wake up.
+        std::vector<JobType> types;
+        types.push_back(GENERIC_SLOW);
+        JobConsumer consumer(types);
+        while (m_numInFlight > 0)
+        {
+            Update();
+            if (m_numInFlight > 0 && !consumer.Consume())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+    m_uploadBudgetSeconds = uploadBudgetSeconds;
+}
+
+//-----------------------------------------------------------------------------------
+void TextureLoader::DecodeJob(Job* job)
+{
+    TextureLoadRequest* request = (TextureLoadRequest*)job->data;
+    request->loader->Decode(request);
+}
+
+//-----------------------------------------------------------------------------------
+void TextureLoader::Decode(TextureLoadRequest* request)
+{
+    double startSeconds = GetCurrentTimeSeconds();
+    const unsigned char* encodedData = request->encodedData;
+    size_t encodedSize = request->encodedSize;
+    std::vector<unsigned char>* fileBuffer = nullptr;
+    if (!request->filePath.empty())
+    {
+        fileBuffer = m_fileBufferPool.Dequeue();
+        if (!fileBuffer)
+        {
+            fileBuffer = new std::vector<unsigned char>();
+        }
+        bool didRead = LoadBufferFromBinaryFile(*fileBuffer, request->filePath);
+        encodedData = (didRead && !fileBuffer->empty()) ? fileBuffer->data() : nullptr;
+        encodedSize = fileBuffer->size();
+    }
+
+    if (encodedData)
+    {
+        //Nothing downstream knows what to do with grey + alpha, so stbi widens those to RGBA.
+        int width = 0;
+        int height = 0;
+        int numComponents = 0;
+        int numComponentsRequested = 0;
+        if (stbi_info_from_memory(encodedData, (int)encodedSize, &width, &height, &numComponents) && numComponents == 2)
+        {
+            numComponentsRequested = 4;
+        }
+        request->pixels = stbi_load_from_memory(encodedData, (int)encodedSize, &request->size.x, &request->size.y, &numComponents, numComponentsRequested);
+        request->numColorComponents = numComponentsRequested != 0 ? numComponentsRequested : numComponents;
+        request->didDecode = request->pixels != nullptr;
+    }
+
+    if (fileBuffer)
+    {
+        m_fileBufferPool.Enqueue(fileBuffer);
+    }
+    request->decodeSeconds = GetCurrentTimeSeconds() - startSeconds;
+    --m_numDecodeJobs;
+    m_decodedRequests.Enqueue(request);
+}
+
+//-----------------------------------------------------------------------------------
+void TextureLoader::QueueRequest(TextureLoadRequest* request)
+{
+    request->loader = this;
+    ++m_numInFlight;
+    if (!JobSystem::instance)
+    {
+        //No workers to hand it to, so it decodes now and only the upload is spread out.
+        ++m_numDecodeJobs;
+        Decode(request);
+        return;
+    }
+    m_pendingRequests.push_back(request);
+    DispatchPendingRequests();
+}
+
+//-----------------------------------------------------------------------------------
+void TextureLoader::DispatchPendingRequests()
+{
+    while (!m_pendingRequests.empty() && m_numDecodeJobs < MAX_DECODE_JOBS_IN_FLIGHT)
+    {
+        TextureLoadRequest* request = m_pendingRequests.front();
+        m_pendingRequests.pop_front();
+        ++m_numDecodeJobs;
+        JobSystem::instance->CreateAndDispatchJob(GENERIC_SLOW, &TextureLoader::DecodeJob, request);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+bool TextureLoader::UploadRows(TextureLoadRequest* request, double deadlineSeconds)
+{
+    GLenum bufferFormat = GetBufferFormat(request->numColorComponents);
+    if (request->uploadTextureID == 0)
+    {
+        request->uploadTextureID = RenderBackend::instance->CreateTexture2D(request->size.x, request->size.y, bufferFormat, bufferFormat, GL_UNSIGNED_BYTE, nullptr);
+    }
+
+    //At least one band goes up per frame, so a tiny budget is slow rather than stuck.
+    int rowBytes = request->size.x * request->numColorComponents;
+    int rowsPerBand = Max<int>(1, UPLOAD_BAND_BYTES / rowBytes);
+    do
+    {
+        int numRows = Min<int>(rowsPerBand, request->size.y - request->numRowsUploaded);
+        const unsigned char* bandPixels = request->pixels + (size_t)request->numRowsUploaded * (size_t)rowBytes;
+        RenderBackend::instance->UpdateTexture2D(request->uploadTextureID, 0, request->numRowsUploaded, request->size.x, numRows, bufferFormat, GL_UNSIGNED_BYTE, bandPixels);
+        request->numRowsUploaded += numRows;
+    } while (request->numRowsUploaded < request->size.y && GetCurrentTimeSeconds() < deadlineSeconds);
+    return request->numRowsUploaded == request->size.y;
+}
+
+//-----------------------------------------------------------------------------------
+void TextureLoader::FinishRequest(TextureLoadRequest* request)
+{
+    m_totalDecodeSeconds += request->decodeSeconds;
+    if (request->didDecode)
+    {
+        m_numDecodedBytes += (size_t)request->size.x * (size_t)request->size.y * (size_t)request->numColorComponents;
+    }
+
+    Texture* texture = request->texture;
+    if (!texture)
+    {
+        if (request->pixels)
+        {
+            stbi_image_free(request->pixels);
+        }
+    }
+    else if (request->didDecode)
+    {
+        //Swap the real image in under the same Texture, it owns the pixels from here on like a texture loaded from disk would.
+        RenderBackend::instance->DeleteTexture(texture->m_openglTextureID);
+        texture->m_openglTextureID = request->uploadTextureID;
+        texture->m_texelSize = request->size;
+        texture->m_textureFormat = Texture::TextureFormat::NUM_FORMATS;
+        texture->m_initializationMethod = Texture::TextureInitializationMethod::FROM_DISK;
+        texture->m_imageData = request->pixels;
+        texture->m_numColorComponents = request->numColorComponents;
+        texture->m_isLoading = false;
+    }
+    else
+    {
+        texture->m_isLoading = false;
+        ERROR_RECOVERABLE(Stringf("The texture at %s failed to load, it'll stay a placeholder.", request->filePath.c_str()));
+    }
+    delete request;
+    --m_numInFlight;
+    ++m_numFinished;
+}
+
+//-----------------------------------------------------------------------------------
+//An RLE compressed 32 bit TGA with runs and raw spans mixed about like real art, since there's no PNG encoder in the tree.
+static void BuildBenchmarkImageFile(std::vector<unsigned char>& out_file, int imageSize)
+{
+    out_file.clear();
+    out_file.resize(18, 0);
+    out_file[2] = 10; //Run length encoded true color
+    out_file[12] = (unsigned char)(imageSize & 0xFF);
+    out_file[13] = (unsigned char)(imageSize >> 8);
+    out_file[14] = (unsigned char)(imageSize & 0xFF);
+    out_file[15] = (unsigned char)(imageSize >> 8);
+    out_file[16] = 32;
+    out_file[17] = 0x28; //8 alpha bits, top left origin
+    for (int y = 0; y < imageSize; ++y)
+    {
+        for (int x = 0; x < imageSize;)
+        {
+            int numPixels = 1 + MathUtils::GetRandomIntFromZeroTo(Min<int>(128, imageSize - x));
+            bool isRun = MathUtils::GetRandomIntFromZeroTo(2) == 0;
+            out_file.push_back((unsigned char)((isRun ? 0x80 : 0x00) | (numPixels - 1)));
+            for (int i = 0; i < (isRun ? 1 : numPixels); ++i)
+            {
+                out_file.push_back((unsigned char)MathUtils::GetRandomIntFromZeroTo(256));
+                out_file.push_back((unsigned char)MathUtils::GetRandomIntFromZeroTo(256));
+                out_file.push_back((unsigned char)MathUtils::GetRandomIntFromZeroTo(256));
+                out_file.push_back(255);
+            }
+            x += numPixels;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(texturedecodebench)
+{
+    if (!JobSystem::instance)
+    {
+        Console::instance->PrintLine("texturedecodebench needs the JobSystem running.", RGBA::RED);
+        return;
+    }
+    int numImages = (args.HasArgs(1) || args.HasArgs(2)) ? Max<int>(args.GetIntArgument(0), 1) : 32;
+    int imageSize = args.HasArgs(2) ? Clamp<int>(args.GetIntArgument(1), 1, 0xFFFF) : 512;
+
+    std::vector<std::vector<unsigned char>> files(numImages);
+    size_t numEncodedBytes = 0;
+    for (std::vector<unsigned char>& file : files)
+    {
+        BuildBenchmarkImageFile(file, imageSize);
+        numEncodedBytes += file.size();
+    }
+    double numDecodedMegabytes = ((double)numImages * imageSize * imageSize * 4.0) / (1024.0 * 1024.0);
+
+    //Synchronous, the way CreateOrGetTexture does it: the frame waits out every decode in full.
+    double longestSyncStallSeconds = 0.0;
+    double startSeconds = GetCurrentTimeSeconds();
+    for (const std::vector<unsigned char>& file : files)
+    {
+        double decodeStartSeconds = GetCurrentTimeSeconds();
+        int width, height, numComponents;
+        unsigned char* pixels = stbi_load_from_memory(file.data(), (int)file.size(), &width, &height, &numComponents, 0);
+        longestSyncStallSeconds = Max<double>(longestSyncStallSeconds, GetCurrentTimeSeconds() - decodeStartSeconds);
+        stbi_image_free(pixels);
+    }
+    double syncSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+    //Through the loader: this thread only queues and drains, once a "frame", and the workers decode.
+    TextureLoader loader;
+    startSeconds = GetCurrentTimeSeconds();
+    for (const std::vector<unsigned char>& file : files)
+    {
+        loader.DecodeAsync(file.data(), file.size());
+    }
+    double queueSeconds = GetCurrentTimeSeconds() - startSeconds;
+    unsigned int numFrames = 0;
+    while (!loader.IsIdle())
+    {
+        loader.Update();
+        ++numFrames;
+        std::this_thread::yield();
+    }
+    double asyncSeconds = GetCurrentTimeSeconds() - startSeconds;
+    double longestAsyncStallSeconds = Max<double>(queueSeconds, loader.GetLongestUpdateSeconds());
+
+    Console::instance->PrintLine(Stringf("%i %ix%i RGBA images, %.2fMB encoded, %.2fMB decoded:", numImages, imageSize, imageSize, (double)numEncodedBytes / (1024.0 * 1024.0), numDecodedMegabytes), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("On this thread: %.2fms, %.1f images/s, %.1fMB/s, worst stall %.3fms", syncSeconds * 1000.0, numImages / syncSeconds, numDecodedMegabytes / syncSeconds, longestSyncStallSeconds * 1000.0), RGBA::GBWHITE);
+    Console::instance->PrintLine(Stringf("On the workers: %.2fms, %.1f images/s, %.1fMB/s, worst stall %.3fms over %u polls", asyncSeconds * 1000.0, numImages / asyncSeconds, numDecodedMegabytes / asyncSeconds, longestAsyncStallSeconds * 1000.0, numFrames), RGBA::GBWHITE);
+    Console::instance->PrintLine(Stringf("Summed worker decode time: %.2fms", loader.GetTotalDecodeSeconds() * 1000.0), RGBA::GBWHITE);
+    Console::instance->PrintLine("Idle workers nap for up to 100ms between checks, so short runs are mostly that wake up.", RGBA::GRAY);
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+#include "Engine/Math/Vector2Int.hpp"
+#include "Engine/DataStructures/ThreadSafeQueue.hpp"
+#include <atomic>
+#include <deque>
+#include <string>
+#include <vector>
+
+class Texture;
+class TextureLoader;
+struct Job;
+
+//-----------------------------------------------------------------------------------
+struct TextureLoadRequest
+{
+    TextureLoadRequest() : texture(nullptr), encodedData(nullptr), encodedSize(0), loader(nullptr), pixels(nullptr), numColorComponents(0), decodeSeconds(0.0), uploadTextureID(0), numRowsUploaded(0), didDecode(false) {};
+
+    Texture* texture; //The placeholder the image lands in, nullptr to decode and throw the pixels away
+    std::string filePath; //Read on the worker, empty when decoding from memory
+    const unsigned char* encodedData; //Not owned, has to outlive the decode
+    size_t encodedSize;
+    TextureLoader* loader;
+
+    //Filled in by the worker
+    unsigned char* pixels; //Tightly packed rows from stbi, handed over to the texture once it's uploaded
+    Vector2Int size;
+    int numColorComponents;
+    double decodeSeconds;
+    bool didDecode;
+
+    //Upload progress, owning thread only
+    unsigned int uploadTextureID;
+    int numRowsUploaded;
+};
+
+//-----------------------------------------------------------------------------------
+// Splits texture creation in two so loading images never hitches a frame. Decoding (file read and
+// stbi) happens on JobSystem workers; the decoded pixels queue up for the thread that owns the GL
+// context, which uploads them in row bands from Update(), stopping once the frame's time budget is
+// spent. Until an image is fully up, its Texture shows a transparent 1x1 placeholder and reports
+// IsLoading(); the Texture pointer itself never changes, so callers can hold onto it right away.
+// Decoding without a texture never touches the RenderBackend, which is how the decode queue gets
+// measured headlessly.
+class TextureLoader
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    TextureLoader(double uploadBudgetSeconds = 0.002);
+    ~TextureLoader(); //Flushes first, so nothing is left pointing into a deleted loader
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    Texture* LoadAsync(const std::string& imageFilePath); //Returns the placeholder; use Texture::CreateOrGetTextureAsync to go through the registry
+    void DecodeAsync(const unsigned char* encodedData, size_t encodedSize); //Decode only, nothing gets uploaded
+    unsigned int Update(); //Call once a frame on the GL thread. Returns how many images finished
+    void Flush(); //Blocks until everything queued is decoded and uploaded; do this before cleaning up the texture registry
+    inline bool IsIdle() const { return m_numInFlight == 0; };
+    inline void SetUploadBudgetSeconds(double budgetSeconds) { m_uploadBudgetSeconds = budgetSeconds; };
+
+    //GETTERS/////////////////////////////////////////////////////////////////////
+    inline int GetNumInFlight() const { return m_numInFlight; };
+    inline unsigned int GetNumFinished() const { return m_numFinished; };
+    inline double GetLongestUpdateSeconds() const { return m_longestUpdateSeconds; };
+    inline double GetTotalDecodeSeconds() const { return m_totalDecodeSeconds; };
+    inline size_t GetNumDecodedBytes() const { return m_numDecodedBytes; };
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const int MAX_DECODE_JOBS_IN_FLIGHT = 64; //The JobSystem's job pool is fixed size, so the rest wait their turn here
+    static const int UPLOAD_BAND_BYTES = 256 * 1024;
+
+    //STATIC VARIABLES/////////////////////////////////////////////////////////////////////
+    static TextureLoader* instance;
+
+private:
+    //PRIVATE FUNCTIONS/////////////////////////////////////////////////////////////////////
+    static void DecodeJob(Job* job);
+    void Decode(TextureLoadRequest* request);
+    void QueueRequest(TextureLoadRequest* request);
+    void DispatchPendingRequests();
+    bool UploadRows(TextureLoadRequest* request, double deadlineSeconds); //True once every row is up
+    void FinishRequest(TextureLoadRequest* request);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::deque<TextureLoadRequest*> m_pendingRequests; //Waiting for a job slot
+    ThreadSafeQueue<TextureLoadRequest> m_decodedRequests;
+    ThreadSafeQueue<std::vector<unsigned char>> m_fileBufferPool; //Compressed bytes are only needed for the decode, so the buffers get reused
+    TextureLoadRequest* m_currentUpload;
+    std::atomic<int> m_numInFlight;
+    std::atomic<int> m_numDecodeJobs;
+    double m_uploadBudgetSeconds;
+    double m_longestUpdateSeconds;
+    double m_totalDecodeSeconds;
+    size_t m_numDecodedBytes;
+    unsigned int m_numFinished;
+};
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "Engine/Renderer/UniformBuffer.hpp"
 #include "Renderer.hpp"
 #include "OpenGLExtensions.hpp"
+#include "RenderBackend.hpp"
 
 int UniformBuffer::COPY_BUFFER_INDEX = -1;
 
@@ -13,9 +14,7 @@ UniformBuffer::UniformBuffer(void* data, size_t dataSize)
 
     if (COPY_BUFFER_INDEX == 0)
     {
-        GLint maxBindPoint;
-        glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &maxBindPoint);
-        COPY_BUFFER_INDEX = maxBindPoint - 1;
+        COPY_BUFFER_INDEX = RenderBackend::instance->GetMaxUniformBufferBindings() - 1;
     }
 }
 
@@ -38,8 +37,8 @@ void UniformBuffer::CopyToGPU()
 {
     if (m_isDirty)
     {
-        glBindBufferBase(GL_UNIFORM_BUFFER, COPY_BUFFER_INDEX, m_bufferHandle); //Replace this with glNamedBufferData, because we don't care where we bind this to manipulate.
-        glBufferData(GL_UNIFORM_BUFFER, m_dataSize, m_data, GL_DYNAMIC_DRAW);
+        RenderBackend::instance->BindBufferBase(GL_UNIFORM_BUFFER, COPY_BUFFER_INDEX, m_bufferHandle); //Replace this with glNamedBufferData, because we don't care where we bind this to manipulate.
+        RenderBackend::instance->BufferData(GL_UNIFORM_BUFFER, m_dataSize, m_data, GL_DYNAMIC_DRAW);
         m_isDirty = false;
     }
 }
@@ -6,6 +6,7 @@
 #include <gl/GL.h>
 #include <gl/GLU.h>
 #include "Engine/Renderer/OpenGLExtensions.hpp"
+#include "Engine/Renderer/RenderBackend.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 
 size_t inPositionAttrib = std::hash<std::string>{}("inPosition");
@@ -64,25 +65,25 @@ void Vertex_PCT::Copy(const Vertex_Master& source, byte* destination)
 //-----------------------------------------------------------------------------------
 void Vertex_PCT::BindMeshToVAO(GLuint vao, GLuint vbo, GLuint ibo, ShaderProgram* program)
 {
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    RenderBackend::instance->BindVertexArray(vao);
+    RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, vbo);
     program->ShaderProgramBindProperty(inPositionAttrib, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex_PCT), offsetof(Vertex_PCT, pos));
     program->ShaderProgramBindProperty(inColorAttrib, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex_PCT), offsetof(Vertex_PCT, color));
     program->ShaderProgramBindProperty(inUV0Attrib, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex_PCT), offsetof(Vertex_PCT, texCoords));
-    glBindBuffer(GL_ARRAY_BUFFER, NULL);
+    RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, NULL);
     if (ibo != NULL)
     {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+        RenderBackend::instance->BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
     }
-    glBindVertexArray(NULL);
+    RenderBackend::instance->BindVertexArray(NULL);
 }
 
 //-----------------------------------------------------------------------------------
 void Vertex_PCUTB::BindMeshToVAO(GLuint vao, GLuint vbo, GLuint ibo, ShaderProgram* program)
 {
-    glBindVertexArray(vao);
+    RenderBackend::instance->BindVertexArray(vao);
     GL_CHECK_ERROR();
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, vbo);
     GL_CHECK_ERROR();
     program->ShaderProgramBindProperty(inPositionAttrib, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex_PCUTB), offsetof(Vertex_PCUTB, pos));
     program->ShaderProgramBindProperty(inColorAttrib, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex_PCUTB), offsetof(Vertex_PCUTB, color));
@@ -90,14 +91,14 @@ void Vertex_PCUTB::BindMeshToVAO(GLuint vao, GLuint vbo, GLuint ibo, ShaderProgr
     program->ShaderProgramBindProperty(inTangentAttrib, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex_PCUTB), offsetof(Vertex_PCUTB, tangent));
     program->ShaderProgramBindProperty(inBitangentAttrib, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex_PCUTB), offsetof(Vertex_PCUTB, bitangent));
     GL_CHECK_ERROR();
-    glBindBuffer(GL_ARRAY_BUFFER, NULL);
+    RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, NULL);
     GL_CHECK_ERROR();
     if (ibo != NULL)
     {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+        RenderBackend::instance->BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
         GL_CHECK_ERROR();
     }
-    glBindVertexArray(NULL);
+    RenderBackend::instance->BindVertexArray(NULL);
     GL_CHECK_ERROR();
 }
 
@@ -115,19 +116,19 @@ void Vertex_TextPCT::Copy(const Vertex_Master& source, byte* destination)
 //-----------------------------------------------------------------------------------
 void Vertex_TextPCT::BindMeshToVAO(GLuint vao, GLuint vbo, GLuint ibo, ShaderProgram* program)
 {
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    RenderBackend::instance->BindVertexArray(vao);
+    RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, vbo);
     program->ShaderProgramBindProperty(inPositionAttrib, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex_TextPCT), offsetof(Vertex_TextPCT, pos));
     program->ShaderProgramBindProperty(inColorAttrib, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex_TextPCT), offsetof(Vertex_TextPCT, color));
     program->ShaderProgramBindProperty(inUV0Attrib, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex_TextPCT), offsetof(Vertex_TextPCT, texCoords));
     program->ShaderProgramBindProperty(inNormalizedGlyphPositionAttrib, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex_TextPCT), offsetof(Vertex_TextPCT, normalizedGlyphPosition));
     program->ShaderProgramBindProperty(inNormalizedStringPositionAttrib, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex_TextPCT), offsetof(Vertex_TextPCT, normalizedStringPosition));
-    glBindBuffer(GL_ARRAY_BUFFER, NULL);
+    RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, NULL);
     if (ibo != NULL)
     {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+        RenderBackend::instance->BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
     }
-    glBindVertexArray(NULL);
+    RenderBackend::instance->BindVertexArray(NULL);
 }
 
 //-----------------------------------------------------------------------------------
@@ -145,20 +146,20 @@ void Vertex_SkinnedPCTN::Copy(const Vertex_Master& source, byte* destination)
 //-----------------------------------------------------------------------------------
 void Vertex_SkinnedPCTN::BindMeshToVAO(GLuint vao, GLuint vbo, GLuint ibo, ShaderProgram* program)
 {
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    RenderBackend::instance->BindVertexArray(vao);
+    RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, vbo);
     program->ShaderProgramBindProperty(inPositionAttrib, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex_SkinnedPCTN), offsetof(Vertex_SkinnedPCTN, pos));
     program->ShaderProgramBindProperty(inColorAttrib, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex_SkinnedPCTN), offsetof(Vertex_SkinnedPCTN, color));
     program->ShaderProgramBindProperty(inUV0Attrib, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex_SkinnedPCTN), offsetof(Vertex_SkinnedPCTN, texCoords));
     program->ShaderProgramBindProperty(inNormalAttrib, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex_SkinnedPCTN), offsetof(Vertex_SkinnedPCTN, normal));
     program->ShaderProgramBindIntegerProperty(inBoneIndicesAttrib, 4, GL_INT, sizeof(Vertex_SkinnedPCTN), offsetof(Vertex_SkinnedPCTN, boneIndices));
     program->ShaderProgramBindProperty(inBoneWeightsAttrib, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex_SkinnedPCTN), offsetof(Vertex_SkinnedPCTN, boneWeights));
-    glBindBuffer(GL_ARRAY_BUFFER, NULL);
+    RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, NULL);
     if (ibo != NULL)
     {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+        RenderBackend::instance->BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
     }
-    glBindVertexArray(NULL);
+    RenderBackend::instance->BindVertexArray(NULL);
 }
 
 //-----------------------------------------------------------------------------------
@@ -174,18 +175,18 @@ void Vertex_PCTD::Copy(const Vertex_Master& source, byte* destination)
 //-----------------------------------------------------------------------------------
 void Vertex_PCTD::BindMeshToVAO(GLuint vao, GLuint vbo, GLuint ibo, ShaderProgram* program)
 {
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    RenderBackend::instance->BindVertexArray(vao);
+    RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, vbo);
     program->ShaderProgramBindProperty(inPositionAttrib, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex_PCTD), offsetof(Vertex_PCTD, pos));
     program->ShaderProgramBindProperty(inColorAttrib, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex_PCTD), offsetof(Vertex_PCTD, color));
     program->ShaderProgramBindProperty(inUV0Attrib, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex_PCTD), offsetof(Vertex_PCTD, texCoords));
     program->ShaderProgramBindProperty(inFloatData0Attrib, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex_PCTD), offsetof(Vertex_PCTD, floatData0));
-    glBindBuffer(GL_ARRAY_BUFFER, NULL);
+    RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, NULL);
     if (ibo != NULL)
     {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+        RenderBackend::instance->BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
     }
-    glBindVertexArray(NULL);
+    RenderBackend::instance->BindVertexArray(NULL);
 }
 
 //-----------------------------------------------------------------------------------
@@ -200,15 +201,15 @@ void Vertex_Sprite::Copy(const Vertex_Master& source, byte* destination)
 //-----------------------------------------------------------------------------------
 void Vertex_Sprite::BindMeshToVAO(GLuint vao, GLuint vbo, GLuint ibo, ShaderProgram* program)
 {
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    RenderBackend::instance->BindVertexArray(vao);
+    RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, vbo);
     program->ShaderProgramBindProperty(inPositionAttrib, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex_Sprite), offsetof(Vertex_Sprite, position));
     program->ShaderProgramBindProperty(inColorAttrib, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex_Sprite), offsetof(Vertex_Sprite, color));
     program->ShaderProgramBindProperty(inUV0Attrib, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex_Sprite), offsetof(Vertex_Sprite, uv));
-    glBindBuffer(GL_ARRAY_BUFFER, NULL);
+    RenderBackend::instance->BindBuffer(GL_ARRAY_BUFFER, NULL);
     if (ibo != NULL)
     {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+        RenderBackend::instance->BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
     }
-    glBindVertexArray(NULL);
+    RenderBackend::instance->BindVertexArray(NULL);
 }
\ No newline at end of file
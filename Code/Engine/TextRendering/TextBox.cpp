@@ -163,9 +163,12 @@ void TextBox::ConstructMeshes()
     DeleteTextRenderers();
     float totalStringWidth = 0.f;
     std::vector<float>lineWidths;
+    std::vector<float>fragmentWidths;
+    fragmentWidths.reserve(m_fragments.size());
     float currLineWidth = 0.f;
     for (StringEffectFragment& frag : m_fragments)
     {
+        fragmentWidths.push_back(m_baseFont->CalcTextWidth(frag.m_value, m_scale));
         if (frag.m_value == "\n")
         {
             lineWidths.push_back(currLineWidth);
@@ -173,8 +176,8 @@ void TextBox::ConstructMeshes()
             continue;
         }
 
-        totalStringWidth += m_baseFont->CalcTextWidth(frag.m_value, m_scale);
-        currLineWidth += m_baseFont->CalcTextWidth(frag.m_value, m_scale);
+        totalStringWidth += fragmentWidths.back();
+        currLineWidth += fragmentWidths.back();
     }
     lineWidths.push_back(currLineWidth);
     float totalWidthUpToNow = 0.f;
@@ -182,8 +185,9 @@ void TextBox::ConstructMeshes()
     float alignment = 0.0f; //Left Aligned
     alignment = m_alignment == CENTER_ALIGNED ? 0.5f : 0.0f;
     alignment = m_alignment == RIGHT_ALIGNED ? 1.0f : 0.0f;
-    for (StringEffectFragment& frag : m_fragments)
+    for (size_t fragIndex = 0; fragIndex < m_fragments.size(); ++fragIndex)
     {
+        StringEffectFragment& frag = m_fragments[fragIndex];
         MeshBuilder mb;
         mb.AddStringEffectFragment(frag.m_value, m_baseFont, m_scale, totalStringWidth, totalWidthUpToNow, Vector3::ZERO
                                 , m_upVector, m_rightVector, m_width, m_height, lineNum, lineWidths[lineNum], alignment);
@@ -197,7 +201,7 @@ void TextBox::ConstructMeshes()
         MeshRenderer* meshRenderer = new MeshRenderer(mesh, mat);
         meshRenderer->SetPosition(m_bottomLeft);
         m_textRenderers.push_back(meshRenderer);
-        totalWidthUpToNow += m_baseFont->CalcTextWidth(frag.m_value, m_scale);
+        totalWidthUpToNow += fragmentWidths[fragIndex];
         if (frag.m_value == "\n")
         {
             lineNum++;
@@ -312,10 +316,11 @@ void TextBox::Update(float deltaSeconds)
             InitializeBorder();
         }
     }
+    static const UniformName gTimeUniform("gTime");
     for (MeshRenderer* mr : m_textRenderers)
     {
         mr->SetPosition(m_bottomLeft);
-        mr->m_material->SetFloatUniform("gTime", m_totalTimeSinceReset);
+        mr->m_material->SetFloatUniform(gTimeUniform, m_totalTimeSinceReset);
     }
 }
 
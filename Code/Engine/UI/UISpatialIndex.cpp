@@ -0,0 +1,161 @@
+#include "Engine/UI/UISpatialIndex.hpp"
+#include "Engine/UI/WidgetBase.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <algorithm>
+#include <math.h>
+
+//-----------------------------------------------------------------------------------
+UISpatialIndex::UISpatialIndex()
+{
+
+}
+
+//-----------------------------------------------------------------------------------
+UISpatialIndex::~UISpatialIndex()
+{
+
+}
+
+//-----------------------------------------------------------------------------------
+void UISpatialIndex::Build(const std::vector<WidgetBase*>& rootWidgets)
+{
+    Clear();
+    for (WidgetBase* widget : rootWidgets)
+    {
+        AddWidgetRecursive(widget);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void UISpatialIndex::Clear()
+{
+    m_entries.clear();
+    for (std::vector<uint32_t>& cell : m_cells)
+    {
+        cell.clear();
+    }
+    m_ranks.clear();
+    m_widgetsByName.clear();
+}
+
+//-----------------------------------------------------------------------------------
+bool UISpatialIndex::UpdateWidget(WidgetBase* widget)
+{
+    auto found = m_ranks.find(widget);
+    if (found == m_ranks.end())
+    {
+        return false;
+    }
+    uint32_t rank = found->second;
+    Entry& entry = m_entries[rank];
+    AABB2 worldBounds = widget->GetWorldBounds();
+    int minCellX = GetCellCoordinate(worldBounds.mins.x, GRID_WIDTH);
+    int minCellY = GetCellCoordinate(worldBounds.mins.y, GRID_HEIGHT);
+    int maxCellX = GetCellCoordinate(worldBounds.maxs.x, GRID_WIDTH);
+    int maxCellY = GetCellCoordinate(worldBounds.maxs.y, GRID_HEIGHT);
+    entry.worldBounds = worldBounds;
+
+    //Most relayouts don't move a widget across a cell boundary, so skip the re-binning when they don't.
+    if (minCellX != entry.minCellX || minCellY != entry.minCellY || maxCellX != entry.maxCellX || maxCellY != entry.maxCellY)
+    {
+        RemoveFromCells(rank);
+        InsertIntoCells(rank);
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+WidgetBase* UISpatialIndex::GetWidgetAtPoint(const Vector2& point) const
+{
+    int cellX = GetCellCoordinate(point.x, GRID_WIDTH);
+    int cellY = GetCellCoordinate(point.y, GRID_HEIGHT);
+    const std::vector<uint32_t>& cell = m_cells[cellY * GRID_WIDTH + cellX];
+    for (uint32_t rank : cell)
+    {
+        const Entry& entry = m_entries[rank];
+        if (entry.worldBounds.IsPointOnOrInside(point))
+        {
+            return entry.widget;
+        }
+    }
+    return nullptr;
+}
+
+//-----------------------------------------------------------------------------------
+WidgetBase* UISpatialIndex::FindWidgetByName(const char* widgetName) const
+{
+    auto found = m_widgetsByName.find(widgetName);
+    return found != m_widgetsByName.end() ? found->second : nullptr;
+}
+
+//-----------------------------------------------------------------------------------
+void UISpatialIndex::AddWidgetRecursive(WidgetBase* widget)
+{
+    //Names are claimed parent first, ranks are handed out children first, both the same way the tree recursion searched.
+    m_widgetsByName.emplace(widget->m_name, widget);
+    for (WidgetBase* child : widget->m_children)
+    {
+        AddWidgetRecursive(child);
+    }
+
+    uint32_t rank = m_entries.size();
+    Entry entry;
+    entry.widget = widget;
+    entry.worldBounds = widget->GetWorldBounds();
+    m_entries.push_back(entry);
+    m_ranks[widget] = rank;
+    InsertIntoCells(rank);
+}
+
+//-----------------------------------------------------------------------------------
+void UISpatialIndex::InsertIntoCells(uint32_t rank)
+{
+    Entry& entry = m_entries[rank];
+    entry.minCellX = (int16_t)GetCellCoordinate(entry.worldBounds.mins.x, GRID_WIDTH);
+    entry.minCellY = (int16_t)GetCellCoordinate(entry.worldBounds.mins.y, GRID_HEIGHT);
+    entry.maxCellX = (int16_t)GetCellCoordinate(entry.worldBounds.maxs.x, GRID_WIDTH);
+    entry.maxCellY = (int16_t)GetCellCoordinate(entry.worldBounds.maxs.y, GRID_HEIGHT);
+
+    for (int y = entry.minCellY; y <= entry.maxCellY; ++y)
+    {
+        for (int x = entry.minCellX; x <= entry.maxCellX; ++x)
+        {
+            std::vector<uint32_t>& cell = m_cells[y * GRID_WIDTH + x];
+            //Build hands ranks out in order, so this is almost always an append.
+            if (cell.empty() || cell.back() < rank)
+            {
+                cell.push_back(rank);
+            }
+            else
+            {
+                cell.insert(std::lower_bound(cell.begin(), cell.end(), rank), rank);
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void UISpatialIndex::RemoveFromCells(uint32_t rank)
+{
+    const Entry& entry = m_entries[rank];
+    for (int y = entry.minCellY; y <= entry.maxCellY; ++y)
+    {
+        for (int x = entry.minCellX; x <= entry.maxCellX; ++x)
+        {
+            std::vector<uint32_t>& cell = m_cells[y * GRID_WIDTH + x];
+            auto found = std::lower_bound(cell.begin(), cell.end(), rank);
+            if (found != cell.end() && *found == rank)
+            {
+                cell.erase(found);
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Anything off the virtual screen gets clamped into the edge cells, so it can still be hit out there.
+int UISpatialIndex::GetCellCoordinate(float position, int numCells)
+{
+    int cell = (int)floor(position / (float)CELL_SIZE);
+    return Clamp<int>(cell, 0, numCells - 1);
+}
\ No newline at end of file
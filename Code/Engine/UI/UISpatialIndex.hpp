@@ -0,0 +1,58 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <stdint.h>
+#include "Engine/Renderer/AABB2.hpp"
+
+class WidgetBase;
+
+//-----------------------------------------------------------------------------------
+// A uniform grid over the UI's virtual screen for hit testing, plus a name lookup.
+// Widgets are ranked in the order the tree recursion would have asked them (children before
+// their parent, siblings and roots in order), and each cell keeps its widgets sorted by rank,
+// so the first one a point lands inside is the same one GetWidgetPointIsInside would return.
+class UISpatialIndex
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    UISpatialIndex();
+    ~UISpatialIndex();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void Build(const std::vector<WidgetBase*>& rootWidgets);
+    void Clear();
+    bool UpdateWidget(WidgetBase* widget); //Re-bins a widget whose bounds moved, false if it isn't in the index
+    WidgetBase* GetWidgetAtPoint(const Vector2& point) const;
+    WidgetBase* FindWidgetByName(const char* widgetName) const;
+    inline unsigned int GetNumWidgets() const { return m_entries.size(); };
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const int CELL_SIZE = 32;
+    static const int GRID_WIDTH = (1600 + CELL_SIZE - 1) / CELL_SIZE; //Matches the virtual coordinates UISystem renders with
+    static const int GRID_HEIGHT = (900 + CELL_SIZE - 1) / CELL_SIZE;
+
+private:
+    //STRUCTS/////////////////////////////////////////////////////////////////////
+    struct Entry
+    {
+        WidgetBase* widget;
+        AABB2 worldBounds;
+        int16_t minCellX;
+        int16_t minCellY;
+        int16_t maxCellX;
+        int16_t maxCellY;
+    };
+
+    //PRIVATE FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void AddWidgetRecursive(WidgetBase* widget);
+    void InsertIntoCells(uint32_t rank);
+    void RemoveFromCells(uint32_t rank);
+    static int GetCellCoordinate(float position, int numCells);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<Entry> m_entries; //Indexed by rank
+    std::vector<uint32_t> m_cells[GRID_WIDTH * GRID_HEIGHT]; //Ranks, ascending
+    std::unordered_map<const WidgetBase*, uint32_t> m_ranks;
+    std::unordered_map<std::string, WidgetBase*> m_widgetsByName; //First widget with each name in a depth-first search
+};
\ No newline at end of file
@@ -8,6 +8,10 @@
 #include "Engine/Input/InputSystem.hpp"
 #include "Widgets/WindowWidget.hpp"
 #include "Widgets/CheckboxWidget.hpp"
+#include "Engine/Renderer/BufferedMeshRenderer.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Time/Time.hpp"
+#include "Engine/Math/MathUtils.hpp"
 
 UISystem* UISystem::instance = nullptr;
 
@@ -22,11 +26,19 @@ UISystem::UISystem()
 UISystem::~UISystem()
 {
     DeleteAllUI();
+    delete m_quadRenderer;
+    delete m_textRenderer;
 }
 
 //-----------------------------------------------------------------------------------
 void UISystem::Update(float deltaSeconds)
 {
+    //Hit testing uses last frame's layout, since that's what's on screen. Widgets added since then need one first.
+    if (m_isSpatialIndexDirty)
+    {
+        UpdateLayout();
+    }
+
     WidgetBase* newHighlightedWidget = FindHighlightedWidget();
     if (newHighlightedWidget != m_highlightedWidget)
     {
@@ -65,6 +77,21 @@ void UISystem::Update(float deltaSeconds)
             widget->Update(deltaSeconds);
         }
     }
+
+    //After state and property changes, so what gets rendered this frame is laid out for this frame.
+    UpdateLayout();
+}
+
+//-----------------------------------------------------------------------------------
+void UISystem::UpdateLayout()
+{
+    //Only subtrees something changed in get laid out again.
+    m_relaidWidgets.clear();
+    for (WidgetBase* widget : m_childWidgets)
+    {
+        widget->UpdateLayout(&m_relaidWidgets);
+    }
+    UpdateSpatialIndex();
 }
 
 //-----------------------------------------------------------------------------------
@@ -78,6 +105,20 @@ void UISystem::Render() const
     Renderer::instance->m_defaultMaterial->m_renderState.depthTestingMode = RenderState::DepthTestingMode::OFF;
     Renderer::instance->BeginOrtho(Vector2::ZERO, Vector2(1600, 900)); //Assuming a virtual coordinate system.
     {
+        if (!m_quadRenderer)
+        {
+            m_quadRenderer = new BufferedMeshRenderer();
+            m_textRenderer = new BufferedMeshRenderer();
+        }
+        WidgetRenderBatch batch;
+        batch.quads = m_quadRenderer;
+        batch.text = m_textRenderer;
+        batch.font = GetFont();
+        m_quadRenderer->SetMaterial(Renderer::instance->m_defaultMaterial);
+        m_quadRenderer->SetDiffuseTexture(Renderer::instance->m_defaultTexture);
+        m_textRenderer->SetMaterial(batch.font->GetMaterial());
+
+        //Batches only merge within a top-level widget, so a window's text can't end up on top of the window above it.
         for (WidgetBase* widget : m_childWidgets)
         {
             if (widget->IsHidden())
@@ -86,9 +127,13 @@ void UISystem::Render() const
             }
             else
             {
-                widget->Render();
+                widget->Render(batch);
+                m_quadRenderer->FlushAndRender();
+                m_textRenderer->FlushAndRender();
             }
         }
+
+        m_quadRenderer->SetDiffuseTexture(Renderer::instance->m_defaultTexture); //Leave the shared default material how we found it
     }
     Renderer::instance->EndOrtho();
     Renderer::instance->m_defaultMaterial->m_renderState.depthTestingMode = RenderState::DepthTestingMode::ON;
@@ -98,6 +143,15 @@ void UISystem::Render() const
 void UISystem::LoadAndParseUIXML(const char* xmlRelativeFilePath)
 {
     XMLNode root = XMLUtils::OpenXMLDocument(xmlRelativeFilePath);
+    const char* fontName = root.getAttribute("Font");
+    if (fontName)
+    {
+        m_font = BitmapFont::CreateOrGetFont(fontName);
+        if (!m_font)
+        {
+            ERROR_RECOVERABLE(Stringf("Couldn't find the UI font %s, using the default font instead.", fontName));
+        }
+    }
     std::vector<XMLNode> children = XMLUtils::GetChildren(root);
     for (XMLNode& node : children)
     {
@@ -136,6 +190,8 @@ void UISystem::DeleteWidget(WidgetBase* widgetToDelete)
             delete current;
             m_childWidgets[i] = m_childWidgets[numWidgets - 1];
             m_childWidgets.pop_back();
+            m_spatialIndex.Clear();
+            m_isSpatialIndexDirty = true;
             return;
         }
     }
@@ -151,6 +207,8 @@ void UISystem::DeleteAllUI()
     }
     m_childWidgets.clear();
     m_highlightedWidget = nullptr;
+    m_spatialIndex.Clear();
+    m_isSpatialIndexDirty = true;
 }
 
 //-----------------------------------------------------------------------------------
@@ -211,23 +269,39 @@ Vector2 UISystem::ScreenToUIVirtualCoords(const Vector2& point)
     return Vector2(point.x, adjustedY);
 }
 
+//-----------------------------------------------------------------------------------
+BitmapFont* UISystem::GetFont()
+{
+    return (instance && instance->m_font) ? instance->m_font : Renderer::instance->m_defaultFont;
+}
+
 //-----------------------------------------------------------------------------------
 WidgetBase* UISystem::FindHighlightedWidget()
 {
-    Vector2 cursorVirtualPos = GetCursorVirtualPos();
-    WidgetBase* widgetAtPos = nullptr;
+    return m_spatialIndex.GetWidgetAtPoint(GetCursorVirtualPos());
+}
 
-    for (WidgetBase* widget : m_childWidgets)
+//-----------------------------------------------------------------------------------
+void UISystem::UpdateSpatialIndex()
+{
+    if (!m_isSpatialIndexDirty)
     {
-        WidgetBase* foundWidget = widget->GetWidgetPointIsInside(cursorVirtualPos);
-        if (foundWidget)
+        for (WidgetBase* widget : m_relaidWidgets)
         {
-            widgetAtPos = foundWidget;
-            break;
+            //A widget we've never seen means a child got added somewhere, so everyone's rank could have moved.
+            if (!m_spatialIndex.UpdateWidget(widget))
+            {
+                m_isSpatialIndexDirty = true;
+                break;
+            }
         }
     }
-    
-    return widgetAtPos;
+    if (m_isSpatialIndexDirty)
+    {
+        m_spatialIndex.Build(m_childWidgets);
+        m_isSpatialIndexDirty = false;
+    }
+    m_relaidWidgets.clear();
 }
 
 //-----------------------------------------------------------------------------------
@@ -242,8 +316,17 @@ Vector2 UISystem::GetCursorVirtualPos()
 //-----------------------------------------------------------------------------------
 WidgetBase* UISystem::FindWidgetByName(const char* widgetName)
 {
-    WidgetBase* foundWidget = nullptr;
+    if (m_isSpatialIndexDirty)
+    {
+        UpdateSpatialIndex();
+    }
+    WidgetBase* foundWidget = m_spatialIndex.FindWidgetByName(widgetName);
+    if (foundWidget)
+    {
+        return foundWidget;
+    }
 
+    //Children added since the last Update aren't in the index yet.
     for (WidgetBase* widget : m_childWidgets)
     {
         if (widget->m_name == widgetName)
@@ -267,6 +350,168 @@ void UISystem::AddWidget(WidgetBase* newWidget)
 {
     ASSERT_OR_DIE(newWidget, "Attempted to add a nullptr as a widget.");
     m_childWidgets.push_back(newWidget);
-    newWidget->RecalculateBounds();
+    newWidget->UpdateLayout();
+    m_isSpatialIndexDirty = true;
+}
+
+//-----------------------------------------------------------------------------------
+static void BuildBenchmarkTree(WindowWidget* root, int numWidgets)
+{
+    //Windows of ten buttons and labels each, nested a few deep, so changes have a parent chain to bubble up.
+    std::vector<WidgetBase*> windows;
+    windows.push_back(root);
+    int numCreated = 1;
+    while (numCreated < numWidgets)
+    {
+        WidgetBase* parent = windows[MathUtils::GetRandomIntFromZeroTo((int)windows.size())];
+        WindowWidget* window = new WindowWidget();
+        window->SetProperty<Vector2>("Offset", Vector2(MathUtils::GetRandomFloatFromZeroTo(20.0f), MathUtils::GetRandomFloatFromZeroTo(20.0f)));
+        window->SetProperty<float>("BorderWidth", 2.0f);
+        parent->AddChild(window);
+        windows.push_back(window);
+        ++numCreated;
+
+        for (int i = 0; i < 10 && numCreated < numWidgets; ++i, ++numCreated)
+        {
+            LabelWidget* widget = (i & 1) ? new ButtonWidget() : new LabelWidget();
+            widget->SetProperty("Text", std::string("Widget"));
+            widget->SetProperty<Vector2>("Offset", Vector2(0.0f, (float)i * 20.0f));
+            widget->SetProperty<float>("BorderWidth", 1.0f);
+            window->AddChild(widget);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+static void CollectWidgets(WidgetBase* widget, std::vector<WidgetBase*>& outWidgets)
+{
+    outWidgets.push_back(widget);
+    for (WidgetBase* child : widget->m_children)
+    {
+        CollectWidgets(child, outWidgets);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(uibench)
+{
+    int numWidgets = args.HasArgs(1) ? args.GetIntArgument(0) : 5000;
+    const int NUM_FRAMES = 100;
+    const int NUM_CHANGES_PER_FRAME = 10;
+
+    WindowWidget* root = new WindowWidget();
+    BuildBenchmarkTree(root, numWidgets);
+    std::vector<WidgetBase*> widgets;
+    CollectWidgets(root, widgets);
+
+    double startSeconds = GetCurrentTimeSeconds();
+    root->UpdateLayout();
+    double initialLayoutSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+    //A handful of widgets change state every frame, like the mouse moving across them would.
+    startSeconds = GetCurrentTimeSeconds();
+    for (int frame = 0; frame < NUM_FRAMES; ++frame)
+    {
+        for (int i = 0; i < NUM_CHANGES_PER_FRAME; ++i)
+        {
+            WidgetBase* widget = widgets[MathUtils::GetRandomIntFromZeroTo((int)widgets.size())];
+            widget->IsHighlighted() ? widget->UnsetHighlighted() : widget->SetHighlighted();
+        }
+        root->UpdateLayout();
+    }
+    double dirtyLayoutSeconds = (GetCurrentTimeSeconds() - startSeconds) / (double)NUM_FRAMES;
+
+    //Full relayouts are what every change used to cost.
+    startSeconds = GetCurrentTimeSeconds();
+    for (int frame = 0; frame < NUM_FRAMES; ++frame)
+    {
+        root->InvalidateStyle();
+        root->UpdateLayout();
+    }
+    double fullLayoutSeconds = (GetCurrentTimeSeconds() - startSeconds) / (double)NUM_FRAMES;
+
+    //Building the frame's geometry, with the styles already resolved and with them all looked up again.
+    BufferedMeshRenderer quads;
+    BufferedMeshRenderer text;
+    WidgetRenderBatch batch;
+    batch.quads = &quads;
+    batch.text = &text;
+    batch.font = UISystem::GetFont();
+    quads.SetDiffuseTexture(Renderer::instance->m_defaultTexture);
+
+    startSeconds = GetCurrentTimeSeconds();
+    for (int frame = 0; frame < NUM_FRAMES; ++frame)
+    {
+        root->Render(batch);
+        quads.m_builder.ClearVertsAndIndices();
+        text.m_builder.ClearVertsAndIndices();
+    }
+    double cachedRenderSeconds = (GetCurrentTimeSeconds() - startSeconds) / (double)NUM_FRAMES;
+
+    startSeconds = GetCurrentTimeSeconds();
+    for (int frame = 0; frame < NUM_FRAMES; ++frame)
+    {
+        root->InvalidateStyle();
+        root->Render(batch);
+        quads.m_builder.ClearVertsAndIndices();
+        text.m_builder.ClearVertsAndIndices();
+    }
+    double uncachedRenderSeconds = (GetCurrentTimeSeconds() - startSeconds) / (double)NUM_FRAMES;
+
+    Console::instance->PrintLine(Stringf("UI with %i widgets:", (int)widgets.size()), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("Layout: %.3fms initial, %.3fms per frame with %i changes, %.3fms for a full relayout",
+        initialLayoutSeconds * 1000.0, dirtyLayoutSeconds * 1000.0, NUM_CHANGES_PER_FRAME, fullLayoutSeconds * 1000.0), RGBA::GBWHITE);
+    Console::instance->PrintLine(Stringf("Render: %.3fms per frame with cached styles, %.3fms resolving every property, 1 quad batch + 1 text batch",
+        cachedRenderSeconds * 1000.0, uncachedRenderSeconds * 1000.0), RGBA::GBWHITE);
+    delete root;
 }
 
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(uihittestbench)
+{
+    int numWidgets = args.HasArgs(2) ? args.GetIntArgument(0) : 5000;
+    int numQueries = args.HasArgs(2) ? args.GetIntArgument(1) : 1000000;
+    const int NUM_TREE_QUERIES = 10000; //Walking the whole tree is slow enough that a sample of it will do
+
+    WindowWidget* root = new WindowWidget();
+    BuildBenchmarkTree(root, numWidgets);
+    root->UpdateLayout();
+    std::vector<WidgetBase*> roots;
+    roots.push_back(root);
+
+    UISpatialIndex* index = new UISpatialIndex();
+    double startSeconds = GetCurrentTimeSeconds();
+    index->Build(roots);
+    double buildSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+    std::vector<Vector2> points;
+    points.reserve(numQueries);
+    for (int i = 0; i < numQueries; ++i)
+    {
+        points.push_back(Vector2(MathUtils::GetRandomFloatFromZeroTo(1600.0f), MathUtils::GetRandomFloatFromZeroTo(900.0f)));
+    }
+
+    int numHits = 0;
+    startSeconds = GetCurrentTimeSeconds();
+    for (const Vector2& point : points)
+    {
+        numHits += index->GetWidgetAtPoint(point) ? 1 : 0;
+    }
+    double indexSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+    int numTreeQueries = Min<int>(numQueries, NUM_TREE_QUERIES);
+    int numMismatches = 0;
+    startSeconds = GetCurrentTimeSeconds();
+    for (int i = 0; i < numTreeQueries; ++i)
+    {
+        numMismatches += root->GetWidgetPointIsInside(points[i]) != index->GetWidgetAtPoint(points[i]) ? 1 : 0;
+    }
+    double treeSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+    Console::instance->PrintLine(Stringf("Hit testing %i widgets (index built in %.3fms):", (int)index->GetNumWidgets(), buildSeconds * 1000.0), RGBA::CORNFLOWER_BLUE);
+    Console::instance->PrintLine(Stringf("Grid: %i queries in %.3fms, %.1fns each, %i hits", numQueries, indexSeconds * 1000.0, (indexSeconds * 1000000000.0) / (double)numQueries, numHits), RGBA::GBWHITE);
+    Console::instance->PrintLine(Stringf("Tree: %.1fns each over %i queries, %i disagreed with the grid", (treeSeconds * 1000000000.0) / (double)numTreeQueries, numTreeQueries, numMismatches),
+        numMismatches == 0 ? RGBA::GBWHITE : RGBA::RED);
+    delete index;
+    delete root;
+}
\ No newline at end of file
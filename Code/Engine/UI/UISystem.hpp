@@ -1,8 +1,12 @@
 #pragma once
 #include "Engine/UI/WidgetBase.hpp"
 #include "Engine/Input/XMLUtils.hpp"
+#include "Engine/UI/UISpatialIndex.hpp"
 #include <vector>
 
+class BufferedMeshRenderer;
+class BitmapFont;
+
 class UISystem
 {
 public:
@@ -26,10 +30,13 @@ public:
     void AddWidget(WidgetBase* newWidget);
     bool SetWidgetHidden(const std::string& name, bool setHidden = true);
     static Vector2 ScreenToUIVirtualCoords(const Vector2& cursorPos);
+    static BitmapFont* GetFont(); //The Font named on the root of the UI XML, or the renderer's default
 
 private:
     WidgetBase* FindHighlightedWidget();
     Vector2 GetCursorVirtualPos();
+    void UpdateLayout();
+    void UpdateSpatialIndex();
 
 public:
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
@@ -39,4 +46,10 @@ public:
 
 private:
     bool m_isHidden = false;
+    bool m_isSpatialIndexDirty = true; //Set whenever widgets come or go, anything else just re-bins what got laid out again
+    UISpatialIndex m_spatialIndex;
+    std::vector<WidgetBase*> m_relaidWidgets;
+    BitmapFont* m_font = nullptr;
+    mutable BufferedMeshRenderer* m_quadRenderer = nullptr; //Created on the first Render, once the renderer is sure to be up
+    mutable BufferedMeshRenderer* m_textRenderer = nullptr;
 };
\ No newline at end of file
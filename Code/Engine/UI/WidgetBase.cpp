@@ -4,6 +4,7 @@
 #include "Engine/Fonts/BitmapFont.hpp"
 #include "Engine/Math/Matrix4x4.hpp"
 #include "Engine/Core/Events/EventSystem.hpp"
+#include "Engine/Renderer/BufferedMeshRenderer.hpp"
 #include "UISystem.hpp"
 
 //-----------------------------------------------------------------------------------
@@ -55,66 +56,114 @@ void WidgetBase::UpdateChildren(float deltaSeconds)
 }
 
 //-----------------------------------------------------------------------------------
-void WidgetBase::Render() const
+void WidgetBase::Render(WidgetRenderBatch& batch) const
 {
     if (IsHidden())
     {
         return;
     }
-    float borderWidth = GetProperty<float>("BorderWidth");
-    RGBA bgColor = GetProperty<RGBA>("BackgroundColor");
-    RGBA borderColor = GetProperty<RGBA>("BorderColor");
-    float opacity = GetProperty<float>("Opacity");
-
-    opacity *= GetParentOpacities();
-    bgColor.alpha = (uchar)((((float)bgColor.alpha / 255.0f) * opacity) * 255.0f);
-    borderColor.alpha = (uchar)((((float)borderColor.alpha / 255.0f) * opacity) * 255.0f);
-
-    Texture* texture = Renderer::instance->m_defaultTexture;
-
-    if (m_texture)
-    {
-        texture = m_texture;
-    }
+    const WidgetStyle& style = GetStyle();
 
     if (m_material)
     {
         //TODO: Once we redo how drawing works, add support for materials!
     }
 
-    float targetScale = GetProperty<float>("Scale");
-    m_currentScale = Lerp<float>(Clamp01(m_timeInState * 8.0f), m_currentScale, targetScale);
+    m_currentScale = Lerp<float>(Clamp01(m_timeInState * 8.0f), m_currentScale, style.scale);
 
-    if (borderWidth > 0.0f && borderColor.alpha != 0x00)
+    if (style.borderWidth > 0.0f && style.borderColor.alpha != 0x00)
     {
         AABB2 finalBounds = m_borderedBounds * m_currentScale;
         finalBounds = finalBounds + m_position;
-        Renderer::instance->DrawTexturedAABB(finalBounds, Vector2(0, 1), Vector2(1, 0), Renderer::instance->m_defaultTexture, borderColor);
+        AddQuad(batch, finalBounds, nullptr, style.borderColor);
     }
-    if (bgColor.alpha != 0x00)
+    if (style.backgroundColor.alpha != 0x00)
     {
         AABB2 finalBounds = m_borderlessBounds * m_currentScale;
         finalBounds = finalBounds + m_position;
-        Renderer::instance->DrawTexturedAABB(finalBounds, Vector2(0, 1), Vector2(1, 0), texture, bgColor);
+        AddQuad(batch, finalBounds, m_texture, style.backgroundColor);
     }
 }
 
 //-----------------------------------------------------------------------------------
-void WidgetBase::RenderChildren() const
+void WidgetBase::RenderChildren(WidgetRenderBatch& batch) const
 {
     for (WidgetBase* child : m_children)
     {
-        child->Render();
+        child->Render(batch);
     }
 }
 
+//-----------------------------------------------------------------------------------
+void WidgetBase::AddQuad(WidgetRenderBatch& batch, const AABB2& bounds, Texture* texture, const RGBA& color) const
+{
+    //Only flushes if the texture actually changed, so untextured widgets all land in the same draw.
+    batch.quads->SetDiffuseTexture(texture ? texture : Renderer::instance->m_defaultTexture);
+    batch.quads->m_builder.AddTexturedAABB(bounds, Vector2(0, 1), Vector2(1, 0), color);
+}
+
 //-----------------------------------------------------------------------------------
 void WidgetBase::AddChild(WidgetBase* child)
 {
     m_children.push_back(child);
     child->m_parent = this;
-    child->RecalculateBounds();
+    //Our offset and opacity carry into the child, and its size might change ours.
+    child->InvalidateStyle();
+}
+
+//-----------------------------------------------------------------------------------
+const WidgetStyle& WidgetBase::GetStyle() const
+{
+    if (m_isStyleDirty)
+    {
+        ResolveStyle();
+    }
+    return m_style;
+}
+
+//-----------------------------------------------------------------------------------
+//Children inherit offset and opacity, so a style change carries down the tree. 
+//Any of it can move or resize us, which can resize every parent that wraps us.
+void WidgetBase::InvalidateStyle()
+{
+    m_isStyleDirty = true;
+    InvalidateLayout();
+    for (WidgetBase* child : m_children)
+    {
+        child->InvalidateStyle();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void WidgetBase::InvalidateLayout()
+{
+    //Parents are always dirty when a child is, so we can stop at the first one that already is.
+    WidgetBase* widget = this;
+    while (widget && !widget->m_isLayoutDirty)
+    {
+        widget->m_isLayoutDirty = true;
+        widget = widget->m_parent;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void WidgetBase::UpdateLayout(std::vector<WidgetBase*>* outRelaidWidgets)
+{
+    if (!m_isLayoutDirty)
+    {
+        return;
+    }
+    //Children first, since a window's bounds are built out of theirs.
+    for (WidgetBase* child : m_children)
+    {
+        child->UpdateLayout(outRelaidWidgets);
+    }
     RecalculateBounds();
+    m_isLayoutDirty = false;
+    if (outRelaidWidgets)
+    {
+        outRelaidWidgets->push_back(this);
+    }
 }
 
 //-----------------------------------------------------------------------------------
@@ -154,7 +203,7 @@ void WidgetBase::RecalculateBounds()
 //-----------------------------------------------------------------------------------
 void WidgetBase::ApplyBorderProperty()
 {
-    float borderWidth = GetProperty<float>("BorderWidth");
+    float borderWidth = GetStyle().borderWidth;
     m_bounds.mins += Vector2(-borderWidth);
     m_bounds.maxs += Vector2(borderWidth);
 }
@@ -178,16 +227,18 @@ void WidgetBase::ApplySizeProperty()
 //-----------------------------------------------------------------------------------
 void WidgetBase::ApplyPaddingProperty()
 {
-    m_bounds.mins -= m_propertiesForAllStates.Get<Vector2>("Padding");
-    m_bounds.maxs += m_propertiesForAllStates.Get<Vector2>("Padding");
+    const Vector2& padding = GetStyle().padding;
+    m_bounds.mins -= padding;
+    m_bounds.maxs += padding;
 }
 
 //-----------------------------------------------------------------------------------
 void WidgetBase::ApplyMarginProperty()
 {
     //This modifies the bounds after the border has been set.
-    m_bounds.mins -= m_propertiesForAllStates.Get<Vector2>("Margin");
-    m_bounds.maxs += m_propertiesForAllStates.Get<Vector2>("Margin");
+    const Vector2& margin = GetStyle().margin;
+    m_bounds.mins -= margin;
+    m_bounds.maxs += margin;
 }
 
 //-----------------------------------------------------------------------------------
@@ -355,6 +406,7 @@ void WidgetBase::BuildFromXMLNode(XMLNode& node)
     }
 
     m_propertiesForAllStates.Set<Vector2>("Offset", offset);
+    InvalidateStyle();
 
     std::vector<XMLNode> children = XMLUtils::GetChildren(node);
     for (XMLNode& child : children)
@@ -381,27 +433,13 @@ void WidgetBase::OnClick()
 //-----------------------------------------------------------------------------------
 Vector2 WidgetBase::GetParentOffsets() const
 {
-    Vector2 parentOffsets = Vector2::ZERO;
-    WidgetBase* parent = m_parent;
-    while (parent)
-    {
-        parentOffsets += parent->m_propertiesForAllStates.Get<Vector2>("Offset");
-        parent = parent->m_parent;
-    }
-    return parentOffsets;
+    return m_parent ? m_parent->GetStyle().childOffset : Vector2::ZERO;
 }
 
 //-----------------------------------------------------------------------------------
 float WidgetBase::GetParentOpacities() const
 {
-    float parentOpacities = 1.0f;
-    WidgetBase* parent = m_parent;
-    while (parent)
-    {
-        parentOpacities *= parent->m_propertiesForAllStates.Get<float>("Opacity");
-        parent = parent->m_parent;
-    }
-    return parentOpacities;
+    return m_parent ? m_parent->GetStyle().childOpacity : 1.0f;
 }
 
 //-----------------------------------------------------------------------------------
@@ -421,6 +459,9 @@ void WidgetBase::SetState(WidgetState newState, bool updatePreviousState)
     }
     m_currentState = newState;
     m_timeInState = 0.0f;
+    //Children only inherit the all-states offset and opacity, so this stays local to us.
+    m_isStyleDirty = true;
+    InvalidateLayout();
 }
 
 //-----------------------------------------------------------------------------------
@@ -428,6 +469,54 @@ void WidgetBase::RevertToPreviousState()
 {
     m_currentState = m_previousState;
     m_timeInState = 0.0f;
+    m_isStyleDirty = true;
+    InvalidateLayout();
+}
+
+//-----------------------------------------------------------------------------------
+static RGBA ApplyOpacity(RGBA color, float opacity)
+{
+    color.alpha = (uchar)((((float)color.alpha / 255.0f) * opacity) * 255.0f);
+    return color;
+}
+
+//-----------------------------------------------------------------------------------
+void WidgetBase::ResolveStyle() const
+{
+    Vector2 parentOffsets = GetParentOffsets();
+    float parentOpacities = GetParentOpacities();
+
+    m_style.totalOffset = parentOffsets + GetProperty<Vector2>("Offset");
+    m_style.childOffset = parentOffsets + m_propertiesForAllStates.Get<Vector2>("Offset");
+    m_style.opacity = parentOpacities * GetProperty<float>("Opacity");
+    m_style.childOpacity = parentOpacities * m_propertiesForAllStates.Get<float>("Opacity");
+    m_style.backgroundColor = ApplyOpacity(GetProperty<RGBA>("BackgroundColor"), m_style.opacity);
+    m_style.borderColor = ApplyOpacity(GetProperty<RGBA>("BorderColor"), m_style.opacity);
+    m_style.borderWidth = GetProperty<float>("BorderWidth");
+    m_style.scale = GetProperty<float>("Scale");
+    m_style.padding = m_propertiesForAllStates.Get<Vector2>("Padding");
+    m_style.margin = m_propertiesForAllStates.Get<Vector2>("Margin");
+
+    //Text properties only exist on labels and the widgets built on them.
+    RGBA textColor = RGBA::WHITE;
+    float textOpacity = 1.0f;
+    m_style.text.clear();
+    m_style.textSize = 1.0f;
+    m_style.textOffset = Vector2::ZERO;
+    TryGetProperty<std::string>("Text", m_style.text);
+    TryGetProperty<RGBA>("TextColor", textColor);
+    TryGetProperty<float>("TextOpacity", textOpacity);
+    TryGetProperty<float>("TextSize", m_style.textSize);
+    TryGetProperty<Vector2>("TextOffset", m_style.textOffset);
+    m_style.textColor = ApplyOpacity(textColor, m_style.opacity * textOpacity);
+    const BitmapFont* font = UISystem::GetFont();
+    if (m_style.font != font || m_style.text != m_style.textLayout.text || m_style.textSize != m_style.textLayout.scale)
+    {
+        m_style.font = font;
+        m_style.textLayout.Shape(font, m_style.text, m_style.textSize, 0.0f);
+    }
+
+    m_isStyleDirty = false;
 }
 
 //-----------------------------------------------------------------------------------
@@ -452,6 +541,7 @@ bool WidgetBase::SetWidgetVisibility(const std::string& name, bool setHidden)
 void WidgetBase::SetHidden()
 {
     m_currentState = HIDDEN_WIDGET_STATE;
+    m_isStyleDirty = true;
     for (WidgetBase* child : m_children)
     {
         child->SetHidden();
@@ -462,6 +552,8 @@ void WidgetBase::SetHidden()
 void WidgetBase::SetVisible()
 {
     m_currentState = ACTIVE_WIDGET_STATE;
+    m_isStyleDirty = true;
+    InvalidateLayout();
     for (WidgetBase* child : m_children)
     {
         child->SetVisible();
@@ -3,13 +3,17 @@
 #include "Engine/Input/XMLUtils.hpp"
 #include "Engine/Core/Events/NamedProperties.hpp"
 #include "Engine/Renderer/AABB2.hpp"
+#include "Engine/Renderer/RGBA.hpp"
 #include "../Math/Transform2D.hpp"
 #include "Dimensions.hpp"
+#include "Engine/Fonts/TextLayoutCache.hpp"
 
 class Matrix4x4;
 class Vector2;
 class Texture;
 class Material;
+class BitmapFont;
+class BufferedMeshRenderer;
 
 //-----------------------------------------------------------------------------------
 enum WidgetState
@@ -35,6 +39,39 @@ enum DockPosition
     NUM_DOCKING_POSITIONS
 };
 
+//-----------------------------------------------------------------------------------
+// Every property Render and the layout passes need, looked up once out of the NamedProperties
+// and kept until the widget's state or properties change. Colors already have opacity applied.
+struct WidgetStyle
+{
+    RGBA backgroundColor;
+    RGBA borderColor;
+    RGBA textColor;
+    Vector2 totalOffset; //Our offset for the current state plus every parent's
+    Vector2 childOffset; //What our children add to their own offset
+    Vector2 textOffset;
+    Vector2 padding;
+    Vector2 margin;
+    float opacity; //Includes every parent's
+    float childOpacity;
+    float borderWidth;
+    float scale;
+    float textSize;
+    std::string text;
+    const BitmapFont* font = nullptr; //The UI's, see UISystem::GetFont
+    TextLayout textLayout; //Only reshaped when the text, its size or the font changes
+};
+
+//-----------------------------------------------------------------------------------
+// Where a frame's worth of widgets gets drawn. All the quads go into one mesh that only breaks
+// when a widget brings its own texture, and all of the text goes into a second one on top.
+struct WidgetRenderBatch
+{
+    BufferedMeshRenderer* quads;
+    BufferedMeshRenderer* text;
+    const BitmapFont* font;
+};
+
 //-----------------------------------------------------------------------------------
 class WidgetBase
 {
@@ -55,6 +92,7 @@ public:
         {
             m_propertiesForState[state].Set<T>(propertyName, value);
         }
+        InvalidateStyle();
     }
 
     //-----------------------------------------------------------------------------------
@@ -68,6 +106,7 @@ public:
         {
             m_propertiesForState[state].Set(propertyName, value);
         }
+        InvalidateStyle();
     }
 
     //-----------------------------------------------------------------------------------
@@ -97,8 +136,14 @@ public:
 
     virtual void Update(float deltaSeconds);
     void UpdateChildren(float deltaSeconds);
-    virtual void Render() const;
-    void RenderChildren() const;
+    virtual void Render(WidgetRenderBatch& batch) const;
+    void RenderChildren(WidgetRenderBatch& batch) const;
+    void AddQuad(WidgetRenderBatch& batch, const AABB2& bounds, Texture* texture, const RGBA& color) const;
+    const WidgetStyle& GetStyle() const;
+    void InvalidateStyle();
+    void InvalidateLayout();
+    void UpdateLayout(std::vector<WidgetBase*>* outRelaidWidgets = nullptr);
+    inline bool IsLayoutDirty() const { return m_isLayoutDirty; };
     virtual void AddChild(WidgetBase* child);
     virtual AABB2 GetBounds() { return m_bounds; };
     virtual AABB2 GetSmallestBoundsAroundChildren();
@@ -122,7 +167,7 @@ public:
     inline bool IsHidden() const { return m_currentState == HIDDEN_WIDGET_STATE; };
     void SetHidden();
     void SetVisible();
-    inline Vector2 GetTotalOffset() const { return GetParentOffsets() + GetProperty<Vector2>("Offset"); };
+    inline Vector2 GetTotalOffset() const { return GetStyle().totalOffset; };
     bool IsClickable();
     bool SetWidgetVisibility(const std::string& name, bool setHidden = true);
     Vector2 GetParentOffsets() const;
@@ -133,6 +178,15 @@ public:
 private:
     void SetState(WidgetState newState, bool updatePreviousState = true);
     void RevertToPreviousState();
+    void ResolveStyle() const;
+
+    //-----------------------------------------------------------------------------------
+    template <typename T>
+    bool TryGetProperty(const std::string& propertyName, T& outValue) const
+    {
+        return m_propertiesForState[m_currentState].Get<T>(propertyName, outValue) == PGR_SUCCESS
+            || m_propertiesForAllStates.Get<T>(propertyName, outValue) == PGR_SUCCESS;
+    }
 
 public:
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
@@ -154,5 +208,8 @@ public:
     DockPosition m_dockType = NOT_DOCKED;
     float m_timeInState = 0.0f;
     mutable float m_currentScale = 1.0f;
+    mutable WidgetStyle m_style;
+    mutable bool m_isStyleDirty = true;
+    bool m_isLayoutDirty = true;
     const bool m_isInteractive = true;
 };
\ No newline at end of file
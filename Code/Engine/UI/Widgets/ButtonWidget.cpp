@@ -28,22 +28,15 @@ ButtonWidget::~ButtonWidget()
 //-----------------------------------------------------------------------------------
 void ButtonWidget::Update(float deltaSeconds)
 {
-    static Vector2 lastSize = GetProperty<Vector2>("Size");
-    Vector2 currentSize = GetProperty<Vector2>("Size");
-    if (lastSize != currentSize)
-    {
-        lastSize = currentSize;
-        RecalculateBounds();
-    }
     LabelWidget::Update(deltaSeconds);
     UpdateChildren(deltaSeconds);
 }
 
 //-----------------------------------------------------------------------------------
-void ButtonWidget::Render() const
+void ButtonWidget::Render(WidgetRenderBatch& batch) const
 {
-    LabelWidget::Render();
-    RenderChildren();
+    LabelWidget::Render(batch);
+    RenderChildren(batch);
 }
 
 //-----------------------------------------------------------------------------------
@@ -113,8 +106,6 @@ void ButtonWidget::BuildFromXMLNode(XMLNode& node)
     }
     SetProperty("Scale", hoverScale, HIGHLIGHTED_WIDGET_STATE);
     SetProperty("Scale", pressedScale, PRESSED_WIDGET_STATE);
-
-    RecalculateBounds();
 }
 
 //-----------------------------------------------------------------------------------
@@ -10,7 +10,7 @@ public:
 
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
     virtual void Update(float deltaSeconds);
-    virtual void Render() const;
+    virtual void Render(WidgetRenderBatch& batch) const;
     virtual void BuildFromXMLNode(XMLNode& node) override;
     virtual void RecalculateBounds() override;
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "Engine\UI\Widgets\CheckboxWidget.hpp"
 #include "..\..\Renderer\Renderer.hpp"
 #include "..\..\Fonts\BitmapFont.hpp"
+#include "..\..\Renderer\BufferedMeshRenderer.hpp"
 
 //-----------------------------------------------------------------------------------
 CheckboxWidget::CheckboxWidget()
@@ -27,46 +28,34 @@ void CheckboxWidget::Update(float deltaSeconds)
 }
 
 //-----------------------------------------------------------------------------------
-void CheckboxWidget::Render() const
+void CheckboxWidget::Render(WidgetRenderBatch& batch) const
 {
     if (IsHidden())
     {
         return;
     }
-    float borderWidth = GetProperty<float>("BorderWidth");
-    RGBA bgColor = GetProperty<RGBA>("BackgroundColor");
-    RGBA borderColor = GetProperty<RGBA>("BorderColor");
-    float opacity = GetProperty<float>("Opacity");
-    std::string text = GetProperty<std::string>("Text");
-    float textOpacity = GetProperty<float>("TextOpacity");
-    float fontSize = GetProperty<float>("TextSize");
-    RGBA textColor = GetProperty<RGBA>("TextColor");
-    Vector2 currentBaseline = GetTotalOffset() + GetProperty<Vector2>("TextOffset");
-
-    opacity *= GetParentOpacities();
-    bgColor.alpha = (uchar)((((float)bgColor.alpha / 255.0f) * opacity) * 255.0f);
-    borderColor.alpha = (uchar)((((float)borderColor.alpha / 255.0f) * opacity) * 255.0f);
-    textColor.alpha = (uchar)((((float)textColor.alpha / 255.0f) * (opacity * textOpacity)) * 255.0f);
-
-    if (borderWidth > 0.0f)
+    const WidgetStyle& style = GetStyle();
+    Vector2 currentBaseline = style.totalOffset + style.textOffset;
+
+    if (style.borderWidth > 0.0f)
     {
         AABB2 borderBounds = m_checkboxBounds;
-        borderBounds.mins += Vector2(-borderWidth);
-        borderBounds.maxs += Vector2(borderWidth);
-        Renderer::instance->DrawAABB(borderBounds, borderColor);
+        borderBounds.mins += Vector2(-style.borderWidth);
+        borderBounds.maxs += Vector2(style.borderWidth);
+        AddQuad(batch, borderBounds, nullptr, style.borderColor);
     }
-    if (bgColor.alpha > 0.0f)
+    if (style.backgroundColor.alpha > 0.0f)
     {
-        Renderer::instance->DrawAABB(m_checkboxBounds, bgColor);
+        AddQuad(batch, m_checkboxBounds, nullptr, style.backgroundColor);
     }
 
     if (m_isChecked)
     {
-        Renderer::instance->DrawText2D(m_checkboxBounds.mins, "X", fontSize, textColor, true, BitmapFont::CreateOrGetFont("Runescape"));
+        batch.text->m_builder.AddText2D(m_checkboxBounds.mins, "X", style.textSize, style.textColor, true, batch.font);
     }
 
-    Renderer::instance->DrawText2D(currentBaseline, text, fontSize, textColor, true, BitmapFont::CreateOrGetFont("Runescape"));
-    RenderChildren();
+    batch.text->m_builder.AddTextLayout(currentBaseline, style.textLayout, style.textColor, true);
+    RenderChildren(batch);
 }
 
 //-----------------------------------------------------------------------------------
@@ -91,25 +80,20 @@ void CheckboxWidget::BuildFromXMLNode(XMLNode& node)
             ERROR_RECOVERABLE("Had a value for checkbox's DefaultState, but it wasn't valid.");
         }
     }
-
-    RecalculateBounds();
 }
 
 //-----------------------------------------------------------------------------------
 void CheckboxWidget::RecalculateBounds()
 {
-    std::string text;
-    float fontSize;
-
-    m_propertiesForAllStates.Get<std::string>("Text", text);
-    m_propertiesForAllStates.Get<float>("TextSize", fontSize);
-    AABB2 checkboxSize = BitmapFont::CreateOrGetFont("Runescape")->CalcTextBounds("X", fontSize);
+    const WidgetStyle& style = GetStyle();
+    const BitmapFont* font = style.font;
+    AABB2 checkboxSize = font->CalcTextBounds("X", style.textSize);
     float checkboxWidth = checkboxSize.GetWidth();
     float checkboxHeight = checkboxSize.GetHeight();
-    float borderWidth = GetProperty<float>("BorderWidth");
+    float borderWidth = style.borderWidth;
 
-    m_bounds = BitmapFont::CreateOrGetFont("Runescape")->CalcTextBounds(text, fontSize);
-    m_bounds += GetTotalOffset();
+    m_bounds = font->CalcTextBounds(style.text, style.textSize);
+    m_bounds += style.totalOffset;
 
     m_checkboxBounds = m_bounds;
     m_checkboxBounds.mins.x -= checkboxWidth;
@@ -118,8 +102,8 @@ void CheckboxWidget::RecalculateBounds()
     m_bounds.mins += Vector2(-borderWidth);
     m_bounds.maxs += Vector2(borderWidth);
 
-    m_bounds.mins -= m_propertiesForAllStates.Get<Vector2>("Padding");
-    m_bounds.maxs += m_propertiesForAllStates.Get<Vector2>("Padding");
+    m_bounds.mins -= style.padding;
+    m_bounds.maxs += style.padding;
 }
 
 //-----------------------------------------------------------------------------------
@@ -11,7 +11,7 @@ public:
 
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
     virtual void Update(float deltaSeconds) override;
-    virtual void Render() const override;
+    virtual void Render(WidgetRenderBatch& batch) const override;
     virtual void BuildFromXMLNode(XMLNode& node) override;
     virtual void RecalculateBounds() override;
     virtual void OnClick() override;
@@ -3,6 +3,7 @@
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Fonts/BitmapFont.hpp"
 #include "Engine/Renderer/AABB2.hpp"
+#include "Engine/Renderer/BufferedMeshRenderer.hpp"
 
 //-----------------------------------------------------------------------------------
 LabelWidget::LabelWidget()
@@ -48,22 +49,18 @@ void LabelWidget::BuildFromXMLNode(XMLNode& node)
     float textOpacity = textOpacityAttribute ? std::stof(textOpacityAttribute) : 1.0f;
     Vector2 textOffset = textOffsetAttribute ? Vector2::CreateFromString(textOffsetAttribute) : Vector2::ZERO;
 
-    m_propertiesForAllStates.Set("Text", text);
-    m_propertiesForAllStates.Set<RGBA>("TextColor", textColor);
-    m_propertiesForAllStates.Set<float>("TextSize", textSize);
-    m_propertiesForAllStates.Set<float>("TextOpacity", textOpacity);
+    SetProperty("Text", text);
+    SetProperty<RGBA>("TextColor", textColor);
+    SetProperty<float>("TextSize", textSize);
+    SetProperty<float>("TextOpacity", textOpacity);
     SetProperty<Vector2>("TextOffset", textOffset);
 }
 
 //-----------------------------------------------------------------------------------
 void LabelWidget::RecalculateBounds()
 {
-    std::string text;
-    float fontSize;
-    PropertyGetResult textGet = m_propertiesForAllStates.Get<std::string>("Text", text);
-    PropertyGetResult fontSizeGet = m_propertiesForAllStates.Get<float>("TextSize", fontSize);
-
-    m_bounds = BitmapFont::CreateOrGetFont("Runescape")->CalcTextBounds(text, fontSize);
+    const WidgetStyle& style = GetStyle();
+    m_bounds = style.font->CalcTextBounds(style.text, style.textSize);
     Vector2 minSize = Vector2(m_bounds.GetWidth(), m_bounds.GetHeight());
     Vector2 currentMinSize = m_dimensions.GetMinSize();
     
@@ -84,21 +81,17 @@ void LabelWidget::Update(float deltaSeconds)
 }
 
 //-----------------------------------------------------------------------------------
-void LabelWidget::Render() const
+void LabelWidget::Render(WidgetRenderBatch& batch) const
 {
-    WidgetBase::Render();
-
-    std::string text = GetProperty<std::string>("Text");
-    float textOpacity = GetProperty<float>("TextOpacity");
-    float fontSize = GetProperty<float>("TextSize");
-    float opacity = GetProperty<float>("Opacity");
-    RGBA textColor = GetProperty<RGBA>("TextColor");
-    Vector2 currentBaseline = GetTotalOffset() + GetProperty<Vector2>("TextOffset");
-
-    opacity *= GetParentOpacities();
-    textColor.alpha = (uchar)((((float)textColor.alpha / 255.0f) * (opacity * textOpacity)) * 255.0f);
+    if (IsHidden())
+    {
+        return;
+    }
+    WidgetBase::Render(batch);
 
-    Renderer::instance->DrawText2D(currentBaseline, text, fontSize, textColor, true, BitmapFont::CreateOrGetFont("Runescape"));
-    RenderChildren();
+    const WidgetStyle& style = GetStyle();
+    Vector2 currentBaseline = style.totalOffset + style.textOffset;
+    batch.text->m_builder.AddTextLayout(currentBaseline, style.textLayout, style.textColor, true);
+    RenderChildren(batch);
 }
 
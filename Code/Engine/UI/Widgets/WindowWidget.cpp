@@ -20,17 +20,16 @@ void WindowWidget::Update(float deltaSeconds)
 }
 
 //-----------------------------------------------------------------------------------
-void WindowWidget::Render() const
+void WindowWidget::Render(WidgetRenderBatch& batch) const
 {
-    WidgetBase::Render();
-    RenderChildren();
+    WidgetBase::Render(batch);
+    RenderChildren(batch);
 }
 
 //-----------------------------------------------------------------------------------
 void WindowWidget::BuildFromXMLNode(XMLNode& node)
 {
     WidgetBase::BuildFromXMLNode(node);
-    RecalculateBounds();
 }
 
 //-----------------------------------------------------------------------------------
@@ -10,7 +10,7 @@ public:
 
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
     virtual void Update(float deltaSeconds) override;
-    virtual void Render() const override;
+    virtual void Render(WidgetRenderBatch& batch) const override;
     virtual void BuildFromXMLNode(XMLNode& node) override;
     virtual void RecalculateBounds() override;
 };
\ No newline at end of file